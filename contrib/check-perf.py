@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+
+# Check compile time and the speed of generated code against a baseline.
+#
+# Copyright (C) 2021 Free Software Foundation, Inc.
+#
+# This file is part of GCC.
+#
+# GCC is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GCC is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GCC; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""Check compile time and the speed of generated code against a baseline.
+
+Each source file in the corpus directories is compiled with -ftime-report,
+and the user and system time and the GGC memory from its TOTAL line are
+recorded.  Each source file in the benchmark directories is compiled and
+linked, and the resulting program is run, possibly under a wrapper such
+as qemu-riscv64, and its run time is recorded.  Every measurement is the
+minimum over several trials.
+
+The results are written as JSON.  If a baseline written by an earlier run
+is given, every result that is worse than the baseline by more than the
+threshold is reported and the script exits with status 1, as is every
+source that no longer compiles or runs.  Sources that fail in the
+baseline too, such as target-specific tests, and results that are too
+small to be measured reliably are not compared.
+
+Typical use, from a GCC build directory:
+
+  make check-perf CHECK_PERF_FLAGS='--baseline=perf-baseline.json'
+  make check-perf CHECK_PERF_FLAGS='--bench=$HOME/bench \\
+    --run-wrapper="qemu-riscv64 -L /usr/riscv64-linux-gnu"'
+"""
+
+import argparse
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+import time
+
+SOURCE_SUFFIXES = ('.c', '.cc', '.cpp', '.i', '.ii')
+
+TOTAL_RE = re.compile(r'^\s*TOTAL\s*:\s*([\d.]+)\s+([\d.]+)'
+                      r'(?:\s+[\d.]+)?\s+(\d+)([kMG]?)', re.MULTILINE)
+
+SIZE_SCALE = {'': 1, 'k': 1024, 'M': 1024 * 1024, 'G': 1024 * 1024 * 1024}
+
+
+def sources(dirs):
+    """Yield the source files in DIRS, in a stable order."""
+    for d in dirs:
+        for name in sorted(os.listdir(d)):
+            if name.endswith(SOURCE_SUFFIXES):
+                yield os.path.join(d, name)
+
+
+def compile_time(args, src):
+    """Return the compile time and GGC memory for SRC, or None."""
+    best = None
+    for _ in range(args.trials):
+        cmd = (args.compiler + args.flags
+               + ['-ftime-report', '-S', '-o', os.devnull, src])
+        proc = subprocess.run(cmd, stdout=subprocess.DEVNULL,
+                              stderr=subprocess.PIPE,
+                              universal_newlines=True)
+        if proc.returncode != 0:
+            return None
+        m = TOTAL_RE.search(proc.stderr)
+        if not m:
+            return None
+        result = {'time': float(m.group(1)) + float(m.group(2)),
+                  'ggc': int(m.group(3)) * SIZE_SCALE[m.group(4)]}
+        if best is None or result['time'] < best['time']:
+            best = result
+    return best
+
+
+def run_time(args, src, tmpdir):
+    """Return the run time of the program built from SRC, or None."""
+    exe = os.path.join(tmpdir, 'bench')
+    cmd = args.compiler + args.flags + ['-o', exe, src]
+    if subprocess.run(cmd).returncode != 0:
+        return None
+    best = None
+    for _ in range(args.trials):
+        start = time.perf_counter()
+        proc = subprocess.run(args.run_wrapper + [exe],
+                              stdout=subprocess.DEVNULL)
+        elapsed = time.perf_counter() - start
+        if proc.returncode != 0:
+            return None
+        if best is None or elapsed < best:
+            best = elapsed
+    return {'time': best}
+
+
+def compare(results, baseline, args):
+    """Report the results that regressed from BASELINE.  Return their
+    number."""
+    regressions = 0
+    for kind in ('compile', 'run'):
+        old = baseline.get(kind, {})
+        for src, new in sorted(results[kind].items()):
+            if src not in old or old[src] is None:
+                continue
+            if new is None:
+                print('REGRESSION: %s %s: failed' % (kind, src))
+                regressions += 1
+                continue
+            for key, value in sorted(new.items()):
+                base = old[src].get(key)
+                if base is None:
+                    continue
+                if key == 'time' and base < args.min_time:
+                    continue
+                if value > base * (1 + args.threshold / 100.0):
+                    print('REGRESSION: %s %s %s: %g -> %g (%+.1f%%)'
+                          % (kind, src, key, base, value,
+                             (value - base) * 100.0 / base))
+                    regressions += 1
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--compiler', required=True,
+                        help='the compiler command to test')
+    parser.add_argument('--flags', default='-O2',
+                        help='options to compile with (default: -O2)')
+    parser.add_argument('--corpus', action='append', default=[],
+                        help='a directory of sources to time the '
+                        'compilation of')
+    parser.add_argument('--bench', action='append', default=[],
+                        help='a directory of benchmark programs to run')
+    parser.add_argument('--run-wrapper', default='',
+                        help='a command to run the benchmarks under')
+    parser.add_argument('--trials', type=int, default=3,
+                        help='the number of trials of each measurement')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='the percentage by which a result may exceed '
+                        'the baseline (default: 5)')
+    parser.add_argument('--min-time', type=float, default=0.1,
+                        help='times in seconds below which results are '
+                        'not compared (default: 0.1)')
+    parser.add_argument('--baseline', help='a result file to compare with')
+    parser.add_argument('--output', default='check-perf.json',
+                        help='the result file to write')
+    args = parser.parse_args()
+
+    args.compiler = shlex.split(args.compiler)
+    args.flags = shlex.split(args.flags)
+    args.run_wrapper = shlex.split(args.run_wrapper)
+
+    results = {'compile': {}, 'run': {}}
+    for src in sources(args.corpus):
+        results['compile'][src] = compile_time(args, src)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        for src in sources(args.bench):
+            results['run'][src] = run_time(args, src, tmpdir)
+
+    with open(args.output, 'w') as f:
+        json.dump(results, f, indent=1, sort_keys=True)
+
+    failed = [src for kind in results for src in results[kind]
+              if results[kind][src] is None]
+
+    regressions = 0
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions = compare(results, json.load(f), args)
+
+    print('%d compiled, %d run, %d failed, %d regressions'
+          % (len(results['compile']), len(results['run']), len(failed),
+             regressions))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
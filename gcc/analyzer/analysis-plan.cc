@@ -53,7 +53,8 @@ analysis_plan::analysis_plan (const supergraph &sg, logger *logger)
 : log_user (logger), m_sg (sg),
   m_cgraph_node_postorder (XCNEWVEC (struct cgraph_node *,
 				     symtab->cgraph_count)),
-  m_index_by_uid (symtab->cgraph_max_uid)
+  m_index_by_uid (symtab->cgraph_max_uid),
+  m_num_call_sites_by_uid (symtab->cgraph_max_uid)
 {
   LOG_SCOPE (logger);
   auto_timevar time (TV_ANALYZER_PLAN);
@@ -74,6 +75,19 @@ analysis_plan::analysis_plan (const supergraph &sg, logger *logger)
 		  < symtab->cgraph_max_uid);
       m_index_by_uid[m_cgraph_node_postorder[i]->get_uid ()] = i;
     }
+
+  /* Populate m_num_call_sites_by_uid, so that use_summary_p doesn't
+     have to walk the callers of a function at each call.  */
+  for (int i = 0; i < symtab->cgraph_max_uid; i++)
+    m_num_call_sites_by_uid.quick_push (0);
+  for (int i = 0; i < m_num_cgraph_nodes; i++)
+    {
+      const cgraph_node *node = m_cgraph_node_postorder[i];
+      int num_call_sites = 0;
+      for (cgraph_edge *edge = node->callers; edge; edge = edge->next_caller)
+	++num_call_sites;
+      m_num_call_sites_by_uid[node->get_uid ()] = num_call_sites;
+    }
 }
 
 /* analysis_plan's dtor.  */
@@ -109,14 +123,10 @@ analysis_plan::use_summary_p (const cgraph_edge *edge) const
   if (!flag_analyzer_call_summaries)
     return false;
 
-  /* TODO: don't count callsites each time.  */
-  int num_call_sites = 0;
   const cgraph_node *callee = edge->callee;
-  for (cgraph_edge *edge = callee->callers; edge; edge = edge->next_caller)
-    ++num_call_sites;
 
   /* Don't use a call summary if there's only one call site.  */
-  if (num_call_sites <= 1)
+  if (m_num_call_sites_by_uid[callee->get_uid ()] <= 1)
     return false;
 
   /* Require the callee to be sufficiently complex to be worth
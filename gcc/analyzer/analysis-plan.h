@@ -53,6 +53,10 @@ private:
   /* Index of each node within the postorder ordering,
      accessed via the "m_uid" field.  */
   auto_vec<int> m_index_by_uid;
+
+  /* Number of callgraph edges into each node, accessed via the "m_uid"
+     field.  */
+  auto_vec<int> m_num_call_sites_by_uid;
 };
 
 } // namespace ana
@@ -160,6 +160,49 @@ impl_region_model_context::get_uncertainty ()
   return m_uncertainty;
 }
 
+/* Implementation of region_model_context::get_call_summary_result vfunc.
+   Look at the final states of CALLEE recorded as its call summaries,
+   and return the return value if it is the same constant in all of
+   them.  Any other value could refer to CALLEE's own frame or to
+   the initial values of its params, which mean nothing to the caller.
+
+   This relies on the worklist visiting CALLEE before its callers
+   (see analysis_plan::cmp_function), so that the summaries are
+   complete by the time they are used.  */
+
+const svalue *
+impl_region_model_context::get_call_summary_result (function *callee)
+{
+  if (!m_eg)
+    return NULL;
+
+  per_function_data *data = m_eg->get_per_function_data (callee);
+  if (!data || data->m_summaries.is_empty ())
+    return NULL;
+
+  tree result = DECL_RESULT (callee->decl);
+  if (!result || VOID_TYPE_P (TREE_TYPE (result)))
+    return NULL;
+
+  const svalue *common_sval = NULL;
+  unsigned i;
+  exploded_node *summary;
+  FOR_EACH_VEC_ELT (data->m_summaries, i, summary)
+    {
+      region_model model (*summary->get_state ().m_region_model);
+      const svalue *sval = model.get_rvalue (result, NULL);
+      if (sval->get_kind () != SK_CONSTANT)
+	return NULL;
+      /* Constants are consolidated by the region_model_manager, so
+	 pointer equality suffices.  */
+      if (common_sval && sval != common_sval)
+	return NULL;
+      common_sval = sval;
+    }
+
+  return common_sval;
+}
+
 /* struct setjmp_record.  */
 
 int
@@ -3119,15 +3162,14 @@ exploded_graph::process_node (exploded_node *node)
 	    if (flag_analyzer_call_summaries
 		&& point.get_call_string ().empty_p ())
 	      {
-		/* TODO: create function summary
-		   There can be more than one; each corresponds to a different
-		   final enode in the function.  */
+		/* There can be more than one summary; each corresponds
+		   to a different final enode in the function.  */
 		if (logger)
 		  {
 		    pretty_printer *pp = logger->get_printer ();
 		    logger->start_log_line ();
 		    logger->log_partial
-		      ("would create function summary for %qE; state: ",
+		      ("creating function summary for %qE; state: ",
 		       point.get_fndecl ());
 		    state.dump_to_pp (m_ext_state, true, false, pp);
 		    logger->end_log_line ();
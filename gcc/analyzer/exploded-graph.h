@@ -72,6 +72,8 @@ class impl_region_model_context : public region_model_context
 
   uncertainty_t *get_uncertainty () FINAL OVERRIDE;
 
+  const svalue *get_call_summary_result (function *callee) FINAL OVERRIDE;
+
   exploded_graph *m_eg;
   log_user m_logger;
   exploded_node *m_enode_for_diag;
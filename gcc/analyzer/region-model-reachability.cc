@@ -151,7 +151,7 @@ reachable_regions::add (const region *reg, bool is_mutable)
     }
 
   /* Add values within the cluster.  If any are pointers, add the pointee.  */
-  if (binding_cluster *bind_cluster = m_store->get_cluster (base_reg))
+  if (const binding_cluster *bind_cluster = m_store->get_cluster (base_reg))
     bind_cluster->for_each_value (handle_sval_cb, this);
   else
     handle_sval (m_model->get_store_value (reg));
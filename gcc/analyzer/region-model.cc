@@ -2670,22 +2670,36 @@ region_model::update_for_return_superedge (const return_superedge &return_edge,
 /* Update this region_model with a summary of the effect of calling
    and returning from CG_SEDGE.
 
-   TODO: Currently this is extremely simplistic: we merely set the
-   return value to "unknown".  A proper implementation would e.g. update
-   sm-state, and presumably be reworked to support multiple outcomes.  */
+   The callee is treated like an unknown function as far as memory
+   reachable from the call is concerned.  Its return value is taken
+   from its call summaries when they agree on a constant, and is
+   otherwise "unknown".
+
+   TODO: a fuller implementation would e.g. update sm-state, and
+   presumably be reworked to support multiple outcomes.  */
 
 void
 region_model::update_for_call_summary (const callgraph_superedge &cg_sedge,
 				       region_model_context *ctxt)
 {
-  /* For now, set any return value to "unknown".  */
   const gcall *call_stmt = cg_sedge.get_call_stmt ();
+
+  noop_region_model_context noop_ctxt;
+  if (!ctxt)
+    ctxt = &noop_ctxt;
+
+  handle_unrecognized_call (call_stmt, ctxt);
+
   tree lhs = gimple_call_lhs (call_stmt);
-  if (lhs)
-    mark_region_as_unknown (get_lvalue (lhs, ctxt),
-			    ctxt ? ctxt->get_uncertainty () : NULL);
+  if (!lhs)
+    return;
 
-  // TODO: actually implement some kind of summary here
+  const region *lhs_reg = get_lvalue (lhs, ctxt);
+  if (const svalue *result
+	= ctxt->get_call_summary_result (cg_sedge.get_callee_function ()))
+    set_value (lhs_reg, result, ctxt);
+  else
+    mark_region_as_unknown (lhs_reg, ctxt->get_uncertainty ());
 }
 
 /* Given a true or false edge guarded by conditional statement COND_STMT,
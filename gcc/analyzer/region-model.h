@@ -702,6 +702,11 @@ class region_model_context
   virtual void on_escaped_function (tree fndecl) = 0;
 
   virtual uncertainty_t *get_uncertainty () = 0;
+
+  /* Hook for the region model to ask for the value that CALLEE is known
+     to return whenever it is called, as recorded in its call summaries.
+     Return NULL if there is no such value.  */
+  virtual const svalue *get_call_summary_result (function *callee) = 0;
 };
 
 /* A "do nothing" subclass of region_model_context.  */
@@ -732,6 +737,11 @@ public:
   void on_escaped_function (tree) OVERRIDE {}
 
   uncertainty_t *get_uncertainty () OVERRIDE { return NULL; }
+
+  const svalue *get_call_summary_result (function *) OVERRIDE
+  {
+    return NULL;
+  }
 };
 
 /* A subclass of region_model_context for determining if operations fail
@@ -730,7 +730,8 @@ binding_map::apply_ctor_pair_to_child_region (const region *parent_reg,
 
 binding_cluster::binding_cluster (const binding_cluster &other)
 : m_base_region (other.m_base_region), m_map (other.m_map),
-  m_escaped (other.m_escaped), m_touched (other.m_touched)
+  m_escaped (other.m_escaped), m_touched (other.m_touched),
+  m_refcount (1)
 {
 }
 
@@ -1584,7 +1585,8 @@ store::store (const store &other)
       gcc_assert (reg);
       binding_cluster *c = (*iter).second;
       gcc_assert (c);
-      m_cluster_map.put (reg, new binding_cluster (*c));
+      c->m_refcount++;
+      m_cluster_map.put (reg, c);
     }
 }
 
@@ -1595,7 +1597,7 @@ store::~store ()
   for (cluster_map_t::iterator iter = m_cluster_map.begin ();
        iter != m_cluster_map.end ();
        ++iter)
-    delete (*iter).second;
+    release_cluster ((*iter).second);
 }
 
 /* store's assignment operator.  */
@@ -1603,11 +1605,14 @@ store::~store ()
 store &
 store::operator= (const store &other)
 {
-  /* Delete existing cluster map.  */
+  if (this == &other)
+    return *this;
+
+  /* Release existing cluster map.  */
   for (cluster_map_t::iterator iter = m_cluster_map.begin ();
        iter != m_cluster_map.end ();
        ++iter)
-    delete (*iter).second;
+    release_cluster ((*iter).second);
   m_cluster_map.empty ();
 
   m_called_unknown_fn = other.m_called_unknown_fn;
@@ -1620,11 +1625,39 @@ store::operator= (const store &other)
       gcc_assert (reg);
       binding_cluster *c = (*iter).second;
       gcc_assert (c);
-      m_cluster_map.put (reg, new binding_cluster (*c));
+      c->m_refcount++;
+      m_cluster_map.put (reg, c);
     }
   return *this;
 }
 
+/* Drop a reference to CLUSTER, deleting it if no store shares it
+   any more.  */
+
+void
+store::release_cluster (binding_cluster *cluster)
+{
+  gcc_assert (cluster->m_refcount > 0);
+  if (--cluster->m_refcount == 0)
+    delete cluster;
+}
+
+/* Return the cluster in *SLOT, ready to be changed: if it is shared
+   with other stores, replace it in *SLOT with a copy of its own.  */
+
+binding_cluster *
+store::unshare_cluster (binding_cluster **slot)
+{
+  binding_cluster *cluster = *slot;
+  if (cluster->m_refcount > 1)
+    {
+      cluster->m_refcount--;
+      cluster = new binding_cluster (*cluster);
+      *slot = cluster;
+    }
+  return cluster;
+}
+
 /* store's equality operator.  */
 
 bool
@@ -1646,7 +1679,7 @@ store::operator== (const store &other) const
 	= const_cast <cluster_map_t &> (other.m_cluster_map).get (reg);
       if (other_slot == NULL)
 	return false;
-      if (*c != **other_slot)
+      if (c != *other_slot && *c != **other_slot)
 	return false;
     }
 
@@ -1931,7 +1964,7 @@ store::set_value (store_manager *mgr, const region *lhs_reg,
        iter != m_cluster_map.end (); ++iter)
     {
       const region *iter_base_reg = (*iter).first;
-      binding_cluster *iter_cluster = (*iter).second;
+      binding_cluster *&iter_cluster = (*iter).second;
       if (iter_base_reg != lhs_base_reg
 	  && (lhs_cluster == NULL
 	      || lhs_cluster->symbolic_p ()
@@ -1944,8 +1977,8 @@ store::set_value (store_manager *mgr, const region *lhs_reg,
 	      gcc_unreachable ();
 
 	    case tristate::TS_UNKNOWN:
-	      iter_cluster->mark_region_as_unknown (mgr, iter_base_reg,
-						    uncertainty);
+	      unshare_cluster (&iter_cluster)
+		->mark_region_as_unknown (mgr, iter_base_reg, uncertainty);
 	      break;
 
 	    case tristate::TS_TRUE:
@@ -2044,11 +2077,11 @@ store::clobber_region (store_manager *mgr, const region *reg)
   binding_cluster **slot = m_cluster_map.get (base_reg);
   if (!slot)
     return;
-  binding_cluster *cluster = *slot;
+  binding_cluster *cluster = unshare_cluster (slot);
   cluster->clobber_region (mgr, reg);
   if (cluster->redundant_p ())
     {
-      delete cluster;
+      release_cluster (cluster);
       m_cluster_map.remove (base_reg);
     }
 }
@@ -2062,11 +2095,11 @@ store::purge_region (store_manager *mgr, const region *reg)
   binding_cluster **slot = m_cluster_map.get (base_reg);
   if (!slot)
     return;
-  binding_cluster *cluster = *slot;
+  binding_cluster *cluster = unshare_cluster (slot);
   cluster->purge_region (mgr, reg);
   if (cluster->redundant_p ())
     {
-      delete cluster;
+      release_cluster (cluster);
       m_cluster_map.remove (base_reg);
     }
 }
@@ -2110,20 +2143,9 @@ store::get_cluster (const region *base_reg) const
     return NULL;
 }
 
-/* Get the cluster for BASE_REG, or NULL (non-const version).  */
-
-binding_cluster *
-store::get_cluster (const region *base_reg)
-{
-  gcc_assert (base_reg);
-  gcc_assert (base_reg->get_base_region () == base_reg);
-  if (binding_cluster **slot = m_cluster_map.get (base_reg))
-    return *slot;
-  else
-    return NULL;
-}
-
-/* Get the cluster for BASE_REG, creating it if doesn't already exist.  */
+/* Get the cluster for BASE_REG, creating it if doesn't already exist.
+   The result is not shared with any other store, and so can be
+   changed.  */
 
 binding_cluster *
 store::get_or_create_cluster (const region *base_reg)
@@ -2135,7 +2157,7 @@ store::get_or_create_cluster (const region *base_reg)
   gcc_assert (!base_reg->symbolic_for_unknown_ptr_p ());
 
   if (binding_cluster **slot = m_cluster_map.get (base_reg))
-    return *slot;
+    return unshare_cluster (slot);
 
   binding_cluster *cluster = new binding_cluster (base_reg);
   m_cluster_map.put (base_reg, cluster);
@@ -2154,8 +2176,7 @@ store::purge_cluster (const region *base_reg)
   binding_cluster **slot = m_cluster_map.get (base_reg);
   if (!slot)
     return;
-  binding_cluster *cluster = *slot;
-  delete cluster;
+  release_cluster (*slot);
   m_cluster_map.remove (base_reg);
 }
 
@@ -2225,6 +2246,10 @@ store::mark_as_escaped (const region *base_reg)
   if (base_reg->symbolic_for_unknown_ptr_p ())
     return;
 
+  /* Avoid copying a shared cluster that has already escaped.  */
+  if (escaped_p (base_reg))
+    return;
+
   binding_cluster *cluster = get_or_create_cluster (base_reg);
   cluster->mark_as_escaped ();
 }
@@ -2237,9 +2262,11 @@ store::on_unknown_fncall (const gcall *call, store_manager *mgr)
 {
   m_called_unknown_fn = true;
 
+  /* Only clusters that have escaped are changed.  */
   for (cluster_map_t::iterator iter = m_cluster_map.begin ();
        iter != m_cluster_map.end (); ++iter)
-    (*iter).second->on_unknown_fncall (call, mgr);
+    if ((*iter).second->escaped_p ())
+      unshare_cluster (&(*iter).second)->on_unknown_fncall (call, mgr);
 }
 
 /* Return true if a non-const pointer to BASE_REG (or something within it)
@@ -2296,15 +2323,15 @@ store::remove_overlapping_bindings (store_manager *mgr, const region *reg)
   const region *base_reg = reg->get_base_region ();
   if (binding_cluster **cluster_slot = m_cluster_map.get (base_reg))
     {
-      binding_cluster *cluster = *cluster_slot;
       if (reg == base_reg && !escaped_p (base_reg))
 	{
 	  /* Remove whole cluster.  */
+	  release_cluster (*cluster_slot);
 	  m_cluster_map.remove (base_reg);
-	  delete cluster;
 	  return;
 	}
-      cluster->remove_overlapping_bindings (mgr, reg, NULL);
+      unshare_cluster (cluster_slot)
+	->remove_overlapping_bindings (mgr, reg, NULL);
     }
 }
 
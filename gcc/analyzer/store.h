@@ -461,7 +461,7 @@ public:
 
   binding_cluster (const region *base_region)
   : m_base_region (base_region), m_map (),
-    m_escaped (false), m_touched (false) {}
+    m_escaped (false), m_touched (false), m_refcount (1) {}
   binding_cluster (const binding_cluster &other);
   binding_cluster& operator=(const binding_cluster &other);
 
@@ -579,6 +579,13 @@ private:
      so we can't use initial_svalue, treat them as uninitialized, or
      inherit values from a parent region.  */
   bool m_touched;
+
+  /* The number of stores sharing this cluster.  Copying a store shares
+     its clusters, and a store copies a shared cluster before changing
+     it (see store::unshare_cluster), so that the stores of the many
+     exploded_nodes along a path only duplicate the clusters that
+     differ between them.  */
+  int m_refcount;
 };
 
 /* The mapping from regions to svalues.
@@ -627,7 +634,6 @@ public:
 			       uncertainty_t *uncertainty);
 
   const binding_cluster *get_cluster (const region *base_reg) const;
-  binding_cluster *get_cluster (const region *base_reg);
   binding_cluster *get_or_create_cluster (const region *base_reg);
   void purge_cluster (const region *base_reg);
 
@@ -659,12 +665,30 @@ public:
   tristate eval_alias (const region *base_reg_a,
 		       const region *base_reg_b) const;
 
+  /* Call V.on_binding for each binding, allowing V to change the
+     bound svalue.  A shared cluster is only copied if V changes it.  */
   template <typename BindingVisitor>
   void for_each_binding (BindingVisitor &v)
   {
     for (cluster_map_t::iterator iter = m_cluster_map.begin ();
 	 iter != m_cluster_map.end (); ++iter)
-      (*iter).second->for_each_binding (v);
+      {
+	binding_cluster *&cluster = (*iter).second;
+	if (cluster->m_refcount == 1)
+	  {
+	    cluster->for_each_binding (v);
+	    continue;
+	  }
+	binding_cluster *copy = new binding_cluster (*cluster);
+	copy->for_each_binding (v);
+	if (*copy == *cluster)
+	  delete copy;
+	else
+	  {
+	    release_cluster (cluster);
+	    cluster = copy;
+	  }
+      }
   }
 
   void canonicalize (store_manager *mgr);
@@ -672,6 +696,9 @@ public:
 			  region_model_manager *mgr);
 
 private:
+  static void release_cluster (binding_cluster *cluster);
+  static binding_cluster *unshare_cluster (binding_cluster **slot);
+
   void remove_overlapping_bindings (store_manager *mgr, const region *reg);
   tristate eval_alias_1 (const region *base_reg_a,
 			 const region *base_reg_b) const;
@@ -72,6 +72,13 @@ along with GCC; see the file COPYING3.  If not see
      standalone symbol, or a clone of a function that is inlined into another
      function.
 
+     Version 1 profiles record each position as its line offset from the
+     start of the enclosing function.  Version 2 profiles, which gcov-tool
+     writes when converting plain instruction samples, record absolute
+     line numbers instead, and carry no function entry counts because the
+     hardware did not record branches.  In both versions the low 16 bits
+     of a position hold the discriminator of the sampled instruction.
+
    Phase 2: Early inline + value profile transformation.
      Early inline uses autofdo_source_profile to find if a callsite is:
         * inlined in the profiled binary.
@@ -95,7 +102,7 @@ along with GCC; see the file COPYING3.  If not see
 */
 
 #define DEFAULT_AUTO_PROFILE_FILE "fbdata.afdo"
-#define AUTO_PROFILE_VERSION 1
+#define AUTO_PROFILE_VERSION 2
 
 namespace autofdo
 {
@@ -353,17 +360,23 @@ get_original_name (const char *name)
   return ret;
 }
 
+/* The version of the profile that was read.  */
+static unsigned afdo_profile_version;
+
 /* Return the combined location, which is a 32bit integer in which
    higher 16 bits stores the line offset of LOC to the start lineno
-   of DECL, The lower 16 bits stores the discriminator.  */
+   of DECL, The lower 16 bits stores the discriminator, which the
+   callers add when they know it.  */
 
 static unsigned
 get_combined_location (location_t loc, tree decl)
 {
+  int base = afdo_profile_version >= 2 ? 0 : DECL_SOURCE_LINE (decl);
+
   /* TODO: allow more bits for line and less bits for discriminator.  */
-  if (LOCATION_LINE (loc) - DECL_SOURCE_LINE (decl) >= (1<<16))
+  if (LOCATION_LINE (loc) - base >= (1<<16))
     warning_at (loc, OPT_Woverflow, "offset exceeds 16 bytes");
-  return ((LOCATION_LINE (loc) - DECL_SOURCE_LINE (decl)) << 16);
+  return ((LOCATION_LINE (loc) - base) << 16);
 }
 
 /* Return the function decl of a given lexical BLOCK.  */
@@ -498,7 +511,7 @@ string_table::get_index_by_decl (tree decl) const
 const char *
 string_table::get_name (int index) const
 {
-  gcc_assert (index > 0 && index < (int)vector_.length ());
+  gcc_assert (index >= 0 && index < (int)vector_.length ());
   return vector_[index];
 }
 
@@ -561,27 +574,46 @@ function_instance::get_function_instance_by_decl (unsigned lineno,
 }
 
 /* Store the profile info for LOC in INFO. Return TRUE if profile info
-   is found.  */
+   is found.  If there is no entry for the exact discriminator of LOC,
+   use the hottest entry for the same line, since the discriminators of
+   the profiled binary need not match the ones assigned now.  */
 
 bool
 function_instance::get_count_info (location_t loc, count_info *info) const
 {
   position_count_map::const_iterator iter = pos_counts.find (loc);
   if (iter == pos_counts.end ())
-    return false;
+    {
+      unsigned line = loc & 0xffff0000;
+      position_count_map::const_iterator end
+	= pos_counts.upper_bound (line | 0xffff);
+      for (position_count_map::const_iterator i = pos_counts.lower_bound (line);
+	   i != end; ++i)
+	if (iter == pos_counts.end () || i->second.count > iter->second.count)
+	  iter = i;
+      if (iter == pos_counts.end ())
+	return false;
+    }
   *info = iter->second;
   return true;
 }
 
-/* Mark LOC as annotated.  */
+/* Mark LOC as annotated.  If there is no entry for the exact
+   discriminator of LOC, mark all entries for the same line.  */
 
 void
 function_instance::mark_annotated (location_t loc)
 {
   position_count_map::iterator iter = pos_counts.find (loc);
-  if (iter == pos_counts.end ())
-    return;
-  iter->second.annotated = true;
+  if (iter != pos_counts.end ())
+    {
+      iter->second.annotated = true;
+      return;
+    }
+  unsigned line = loc & 0xffff0000;
+  position_count_map::iterator end = pos_counts.upper_bound (line | 0xffff);
+  for (iter = pos_counts.lower_bound (line); iter != end; ++iter)
+    iter->second.annotated = true;
 }
 
 /* Read the inlined indirect call target profile for STMT and store it in
@@ -654,7 +686,7 @@ function_instance::read_function_instance (function_instance_stack *stack,
 
   for (unsigned i = 0; i < num_pos_counts; i++)
     {
-      unsigned offset = gcov_read_unsigned () & 0xffff0000;
+      unsigned offset = gcov_read_unsigned ();
       unsigned num_targets = gcov_read_unsigned ();
       gcov_type count = gcov_read_counter ();
       s->pos_counts[offset].count = count;
@@ -733,7 +765,10 @@ autofdo_source_profile::get_count_info (gimple *stmt, count_info *info) const
   function_instance *s = get_function_instance_by_inline_stack (stack);
   if (s == NULL)
     return false;
-  return s->get_count_info (stack[0].second, info);
+  unsigned offset = stack[0].second;
+  if (gimple_bb (stmt))
+    offset |= gimple_bb (stmt)->discriminator & 0xffff;
+  return s->get_count_info (offset, info);
 }
 
 /* Mark LOC as annotated.  */
@@ -937,12 +972,13 @@ read_profile (void)
 
   /* Skip the version number.  */
   unsigned version = gcov_read_unsigned ();
-  if (version != AUTO_PROFILE_VERSION)
+  if (version == 0 || version > AUTO_PROFILE_VERSION)
     {
       error ("AutoFDO profile version %u does match %u",
 	     version, AUTO_PROFILE_VERSION);
       return;
     }
+  afdo_profile_version = version;
 
   /* Skip the empty integer.  */
   gcov_read_unsigned ();
@@ -1530,6 +1566,16 @@ afdo_annotate_cfg (const stmt_set &promoted_stmts)
       if (bb->count > max_count)
 	max_count = bb->count;
     }
+  /* Profiles sampled without branch records have no entry counts; take
+     the count of the first block instead.  */
+  if (s->head_count () == 0
+      && ENTRY_BLOCK_PTR_FOR_FN (cfun)->next_bb->count > profile_count::zero ())
+    {
+      ENTRY_BLOCK_PTR_FOR_FN (cfun)->count
+	= ENTRY_BLOCK_PTR_FOR_FN (cfun)->next_bb->count;
+      cgraph_node::get (current_function_decl)->count
+	= ENTRY_BLOCK_PTR_FOR_FN (cfun)->count;
+    }
   if (ENTRY_BLOCK_PTR_FOR_FN (cfun)->count
       > ENTRY_BLOCK_PTR_FOR_FN (cfun)->next_bb->count)
     {
@@ -1341,8 +1341,7 @@ bitmap_and_into (bitmap a, const_bitmap b)
 	  for (ix = 0; ix < BITMAP_ELEMENT_WORDS; ix++)
 	    {
 	      BITMAP_WORD r = a_elt->bits[ix] & b_elt->bits[ix];
-	      if (a_elt->bits[ix] != r)
-		changed = true;
+	      changed |= (a_elt->bits[ix] ^ r) != 0;
 	      a_elt->bits[ix] = r;
 	      ior |= r;
 	    }
@@ -1378,13 +1377,14 @@ bitmap_elt_copy (bitmap dst, bitmap_element *dst_elt, bitmap_element *dst_prev,
   if (!changed && dst_elt && dst_elt->indx == src_elt->indx)
     {
       unsigned ix;
+      BITMAP_WORD diff = 0;
 
       for (ix = 0; ix < BITMAP_ELEMENT_WORDS; ix++)
-	if (src_elt->bits[ix] != dst_elt->bits[ix])
-	  {
-	    dst_elt->bits[ix] = src_elt->bits[ix];
-	    changed = true;
-	  }
+	{
+	  diff |= src_elt->bits[ix] ^ dst_elt->bits[ix];
+	  dst_elt->bits[ix] = src_elt->bits[ix];
+	}
+      changed = diff != 0;
     }
   else
     {
@@ -1445,17 +1445,17 @@ bitmap_and_compl (bitmap dst, const_bitmap a, const_bitmap b)
 
 	  if (!changed && dst_elt && dst_elt->indx == a_elt->indx)
 	    {
+	      BITMAP_WORD diff = 0;
+
 	      for (ix = 0; ix < BITMAP_ELEMENT_WORDS; ix++)
 		{
 		  BITMAP_WORD r = a_elt->bits[ix] & ~b_elt->bits[ix];
 
-		  if (dst_elt->bits[ix] != r)
-		    {
-		      changed = true;
-		      dst_elt->bits[ix] = r;
-		    }
+		  diff |= dst_elt->bits[ix] ^ r;
+		  dst_elt->bits[ix] = r;
 		  ior |= r;
 		}
+	      changed = diff != 0;
 	    }
 	  else
 	    {
@@ -1903,15 +1903,15 @@ bitmap_elt_ior (bitmap dst, bitmap_element *dst_elt, bitmap_element *dst_prev,
 
       if (!changed && dst_elt && dst_elt->indx == a_elt->indx)
 	{
+	  BITMAP_WORD diff = 0;
+
 	  for (ix = 0; ix < BITMAP_ELEMENT_WORDS; ix++)
 	    {
 	      BITMAP_WORD r = a_elt->bits[ix] | b_elt->bits[ix];
-	      if (r != dst_elt->bits[ix])
-		{
-		  dst_elt->bits[ix] = r;
-		  changed = true;
-		}
+	      diff |= r ^ dst_elt->bits[ix];
+	      dst_elt->bits[ix] = r;
 	    }
+	  changed = diff != 0;
 	}
       else
 	{
@@ -2245,9 +2245,11 @@ bitmap_equal_p (const_bitmap a, const_bitmap b)
     {
       if (a_elt->indx != b_elt->indx)
 	return false;
+      BITMAP_WORD diff = 0;
       for (ix = 0; ix < BITMAP_ELEMENT_WORDS; ix++)
-	if (a_elt->bits[ix] != b_elt->bits[ix])
-	  return false;
+	diff |= a_elt->bits[ix] ^ b_elt->bits[ix];
+      if (diff)
+	return false;
     }
   return !a_elt && !b_elt;
 }
@@ -206,6 +206,7 @@ fe_file_change (const line_map_ordinary *new_map)
 
 	  input_location = new_map->start_location;
 	  (*debug_hooks->start_source_file) (line, LINEMAP_FILE (new_map));
+	  time_trace_begin ("Include", LINEMAP_FILE (new_map));
 #ifdef SYSTEM_IMPLICIT_EXTERN_C
 	  if (c_header_level)
 	    ++c_header_level;
@@ -230,6 +231,7 @@ fe_file_change (const line_map_ordinary *new_map)
       input_location = new_map->start_location;
 
       (*debug_hooks->end_source_file) (LINEMAP_LINE (new_map));
+      time_trace_end ();
     }
 
   update_header_times (LINEMAP_FILE (new_map));
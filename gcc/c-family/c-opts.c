@@ -76,6 +76,9 @@ static bool verbose;
 /* Dependency output file.  */
 static const char *deps_file;
 
+/* Module dependency output file.  */
+static const char *fdeps_file;
+
 /* The prefix given by -iprefix, if any.  */
 static const char *iprefix;
 
@@ -449,6 +452,18 @@ c_common_handle_option (size_t scode, const char *arg, HOST_WIDE_INT value,
 	disable_builtin_function (arg);
       break;
 
+    case OPT_fdeps_file_:
+      fdeps_file = arg;
+      break;
+
+    case OPT_fdeps_format_:
+      /* See https://wg21.link/p1689r5.  */
+      if (!strcmp (arg, "p1689r5"))
+	cpp_opts->deps.fdeps_format = FDEPS_FMT_P1689R5;
+      else
+	error ("%<-fdeps-format=%> unknown format %qs", arg);
+      break;
+
     case OPT_fdirectives_only:
       cpp_opts->directives_only = value;
       break;
@@ -522,6 +537,10 @@ c_common_handle_option (size_t scode, const char *arg, HOST_WIDE_INT value,
       cpp_opts->narrow_charset = arg;
       break;
 
+    case OPT_finclude_cache_:
+      cpp_opts->include_cache = arg;
+      break;
+
     case OPT_fwide_exec_charset_:
       cpp_opts->wide_charset = arg;
       break;
@@ -1256,6 +1275,7 @@ void
 c_common_finish (void)
 {
   FILE *deps_stream = NULL;
+  FILE *fdeps_stream = NULL;
 
   /* Note that we write the dependencies even if there are errors. This is
      useful for handling outdated generated headers that now trigger errors
@@ -1278,14 +1298,34 @@ c_common_finish (void)
 	}
     }
 
+  /* Module dependencies default to standard output, so that a scanning
+     run can send the preprocessed output to /dev/null.  */
+  if (cpp_opts->deps.fdeps_format != FDEPS_FMT_NONE)
+    {
+      if (!fdeps_file || (fdeps_file[0] == '-' && fdeps_file[1] == '\0'))
+	fdeps_stream = stdout;
+      else
+	{
+	  fdeps_stream = fopen (fdeps_file, "w");
+	  if (!fdeps_stream)
+	    fatal_error (input_location,
+			 "opening module dependency file %s: %m", fdeps_file);
+	}
+    }
+
   /* For performance, avoid tearing down cpplib's internal structures
      with cpp_destroy ().  */
-  cpp_finish (parse_in, deps_stream);
+  cpp_finish (parse_in, deps_stream, fdeps_stream);
 
   if (deps_stream && deps_stream != out_stream && deps_stream != stdout
       && (ferror (deps_stream) || fclose (deps_stream)))
     fatal_error (input_location, "closing dependency file %s: %m", deps_file);
 
+  if (fdeps_stream && fdeps_stream != stdout
+      && (ferror (fdeps_stream) || fclose (fdeps_stream)))
+    fatal_error (input_location, "closing module dependency file %s: %m",
+		 fdeps_file);
+
   if (out_stream && (ferror (out_stream) || fclose (out_stream)))
     fatal_error (input_location, "when writing output to %s: %m", out_fname);
 }
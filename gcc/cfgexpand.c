@@ -574,10 +574,12 @@ visit_conflict (gimple *, tree op, tree, void *data)
 /* Helper routine for add_scope_conflicts, calculating the active partitions
    at the end of BB, leaving the result in WORK.  We're called to generate
    conflicts when FOR_CONFLICT is true, otherwise we're just tracking
-   liveness.  */
+   liveness.  CLIQUE holds a set of partitions that have all been made
+   to conflict with each other when generating conflicts.  */
 
 static void
-add_scope_conflicts_1 (basic_block bb, bitmap work, bool for_conflict)
+add_scope_conflicts_1 (basic_block bb, bitmap work, bool for_conflict,
+		       bitmap clique)
 {
   edge e;
   edge_iterator ei;
@@ -621,15 +623,23 @@ add_scope_conflicts_1 (basic_block bb, bitmap work, bool for_conflict)
 		 Unlike classical liveness for named objects we can't
 		 rely on seeing a def/use of the names we're interested in.
 		 There might merely be indirect loads/stores.  We'd not add any
-		 conflicts for such partitions.  */
-	      bitmap_iterator bi;
-	      unsigned i;
-	      EXECUTE_IF_SET_IN_BITMAP (work, 0, i, bi)
+		 conflicts for such partitions.
+		 This is quadratic in the number of live partitions, so
+		 skip it when they are all in CLIQUE already, which is
+		 common in long chains of blocks from inlined code.  */
+	      if (bitmap_intersect_compl_p (work, clique))
 		{
-		  class stack_var *a = &stack_vars[i];
-		  if (!a->conflicts)
-		    a->conflicts = BITMAP_ALLOC (&stack_var_bitmap_obstack);
-		  bitmap_ior_into (a->conflicts, work);
+		  bitmap_iterator bi;
+		  unsigned i;
+		  EXECUTE_IF_SET_IN_BITMAP (work, 0, i, bi)
+		    {
+		      class stack_var *a = &stack_vars[i];
+		      if (!a->conflicts)
+			a->conflicts
+			  = BITMAP_ALLOC (&stack_var_bitmap_obstack);
+		      bitmap_ior_into (a->conflicts, work);
+		    }
+		  bitmap_copy (clique, work);
 		}
 	      visit = visit_conflict;
 	    }
@@ -647,6 +657,7 @@ add_scope_conflicts (void)
   basic_block bb;
   bool changed;
   bitmap work = BITMAP_ALLOC (NULL);
+  bitmap clique = BITMAP_ALLOC (NULL);
   int *rpo;
   int n_bbs;
 
@@ -676,17 +687,18 @@ add_scope_conflicts (void)
 	  bitmap active;
 	  bb = BASIC_BLOCK_FOR_FN (cfun, rpo[i]);
 	  active = (bitmap)bb->aux;
-	  add_scope_conflicts_1 (bb, work, false);
+	  add_scope_conflicts_1 (bb, work, false, NULL);
 	  if (bitmap_ior_into (active, work))
 	    changed = true;
 	}
     }
 
   FOR_EACH_BB_FN (bb, cfun)
-    add_scope_conflicts_1 (bb, work, true);
+    add_scope_conflicts_1 (bb, work, true, clique);
 
   free (rpo);
   BITMAP_FREE (work);
+  BITMAP_FREE (clique);
   FOR_ALL_BB_FN (bb, cfun)
     BITMAP_FREE (bb->aux);
 }
@@ -2677,6 +2689,7 @@ expand_gimple_cond (basic_block bb, gcond *stmt)
   update_bb_for_insn (bb);
 
   new_bb = create_basic_block (NEXT_INSN (last), get_last_insn (), bb);
+  new_bb->discriminator = bb->discriminator;
   dest = false_edge->dest;
   redirect_edge_succ (false_edge, new_bb);
   false_edge->flags |= EDGE_FALLTHRU;
@@ -4116,7 +4129,9 @@ expand_gimple_tailcall (basic_block bb, gcall *stmt, bool *can_fallthru)
 
   if (NEXT_INSN (last))
     {
+      unsigned int discriminator = bb->discriminator;
       bb = create_basic_block (NEXT_INSN (last), get_last_insn (), bb);
+      bb->discriminator = discriminator;
 
       last = BB_END (bb);
       if (BARRIER_P (last))
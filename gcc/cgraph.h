@@ -872,7 +872,7 @@ struct GTY((tag ("SYMTAB_FUNCTION"))) cgraph_node : public symtab_node
       inlined_to (NULL), rtl (NULL),
       count (profile_count::uninitialized ()),
       count_materialization_scale (REG_BR_PROB_BASE), profile_id (0),
-      unit_id (0), tp_first_run (0), thunk (false),
+      unit_id (0), tp_first_run (0), layout_order (0), thunk (false),
       used_as_abstract_origin (false),
       lowered (false), process (false), frequency (NODE_FREQUENCY_NORMAL),
       only_called_at_startup (false), only_called_at_exit (false),
@@ -1411,6 +1411,9 @@ struct GTY((tag ("SYMTAB_FUNCTION"))) cgraph_node : public symtab_node
   int unit_id;
   /* Time profiler: first run of function.  */
   int tp_first_run;
+  /* Position of the function in the profile-driven layout computed at
+     link time, counting from 1, or 0 if it has none.  */
+  int layout_order;
 
   /* True when symbol is a thunk.  */
   unsigned thunk : 1;
@@ -1895,7 +1895,8 @@ cgraph_node::expand (void)
 }
 
 /* Node comparator that is responsible for the order that corresponds
-   to time when a function was launched for the first time.  */
+   to time when a function was launched for the first time.  Functions
+   laid out by lto_layout_functions come first, in that layout.  */
 
 int
 tp_first_run_node_cmp (const void *pa, const void *pb)
@@ -1905,6 +1906,15 @@ tp_first_run_node_cmp (const void *pa, const void *pb)
   unsigned int tp_first_run_a = a->tp_first_run;
   unsigned int tp_first_run_b = b->tp_first_run;
 
+  if (a->layout_order != b->layout_order)
+    {
+      if (!b->layout_order)
+	return -1;
+      if (!a->layout_order)
+	return 1;
+      return a->layout_order - b->layout_order;
+    }
+
   if (!opt_for_fn (a->decl, flag_profile_reorder_functions)
       || a->no_reorder)
     tp_first_run_a = 0;
@@ -1930,7 +1940,19 @@ tp_first_run_node_cmp (const void *pa, const void *pb)
    between a function and its callees (later we may choose to use a more
    sophisticated algorithm for function reordering; we will likely want
    to use subsections to make the output functions appear in top-down
-   order).  */
+   order).
+
+   Functions are expanded strictly one after another.  Besides the
+   garbage collector, the RTL pipeline relies on per-compilation global
+   state that is shared between functions: the constant pool and its
+   label numbering, the output section state in varasm.c, and the
+   information gathered by earlier functions for later ones (for example
+   the stack alignment and register usage propagated in this order).
+   Splitting the loop below across workers would require making that
+   state per-function, or renumbering it when merging.  Users who need
+   intra-TU parallelism today can compile with -flto and link with
+   -flto=N, which partitions the unit and compiles the partitions in
+   parallel.  */
 
 static void
 expand_all_functions (void)
@@ -1952,7 +1974,7 @@ expand_all_functions (void)
   for (i = 0; i < order_pos; i++)
     if (order[i]->process)
       {
-	if (order[i]->tp_first_run
+	if ((order[i]->tp_first_run || order[i]->layout_order)
 	    && opt_for_fn (order[i]->decl, flag_profile_reorder_functions))
 	  tp_first_run_order[tp_first_run_order_pos++] = order[i];
 	else
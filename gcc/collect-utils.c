@@ -183,7 +183,7 @@ collect_execute (const char *prog, char **argv, const char *outname,
   if (argv[0] == 0)
     fatal_error (input_location, "cannot find %qs", prog);
 
-  pex = pex_init (0, "collect2", NULL);
+  pex = pex_init (PEX_USE_PIPES, "collect2", NULL);
   if (pex == NULL)
     fatal_error (input_location, "%<pex_init%> failed: %m");
 
@@ -50,6 +50,17 @@ static const riscv_implied_info_t riscv_implied_info[] =
   {"d", "f"},
   {"f", "zicsr"},
   {"d", "zicsr"},
+  {"v", "d"},
+  {"zfh", "zfhmin"},
+  {"zfhmin", "f"},
+  {"zfbfmin", "f"},
+  {"zcmp", "zca"},
+  {"zcmt", "zca"},
+  {"zcmt", "zicsr"},
+  {"zkn", "zbkb"},
+  {"zkn", "zknd"},
+  {"zkn", "zkne"},
+  {"zkn", "zknh"},
   {NULL, NULL}
 };
 
@@ -95,12 +106,42 @@ static const struct riscv_ext_version riscv_ext_version_table[] =
   {"c", ISA_SPEC_CLASS_20190608, 2, 0},
   {"c", ISA_SPEC_CLASS_2P2,      2, 0},
 
+  {"p", ISA_SPEC_CLASS_NONE, 0, 9},
+
+  {"v", ISA_SPEC_CLASS_NONE, 1, 0},
+
   {"zicsr", ISA_SPEC_CLASS_20191213, 2, 0},
   {"zicsr", ISA_SPEC_CLASS_20190608, 2, 0},
 
   {"zifencei", ISA_SPEC_CLASS_20191213, 2, 0},
   {"zifencei", ISA_SPEC_CLASS_20190608, 2, 0},
 
+  {"zicond", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zicboz", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zicbop", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zic64b", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zihintntl", ISA_SPEC_CLASS_NONE, 1, 0},
+
+  {"ztso", ISA_SPEC_CLASS_NONE, 1, 0},
+
+  {"zfh",     ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zfhmin",  ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zfbfmin", ISA_SPEC_CLASS_NONE, 1, 0},
+
+  {"zca",  ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zcmp", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zcmt", ISA_SPEC_CLASS_NONE, 1, 0},
+
+  {"zba", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zbb", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zbs", ISA_SPEC_CLASS_NONE, 1, 0},
+
+  {"zbkb", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zkn",  ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zknd", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zkne", ISA_SPEC_CLASS_NONE, 1, 0},
+  {"zknh", ISA_SPEC_CLASS_NONE, 1, 0},
+
   /* Terminate the list.  */
   {NULL, ISA_SPEC_CLASS_NONE, 0, 0}
 };
@@ -863,6 +904,16 @@ riscv_subset_list::parse (const char *arch, location_t loc)
       subset_list->handle_implied_ext (itr);
     }
 
+  /* Zcmp and Zcmt reuse the encodings of the compressed double-precision
+     loads and stores.  */
+  if ((subset_list->lookup ("zcmp") || subset_list->lookup ("zcmt"))
+      && subset_list->lookup ("c") && subset_list->lookup ("d"))
+    {
+      error_at (loc, "%<-march=%s%>: %<zcmp%> and %<zcmt%> cannot be "
+		"combined with %<c%> and %<d%>", arch);
+      goto fail;
+    }
+
   return subset_list;
 
 fail:
@@ -900,15 +951,69 @@ static const riscv_ext_flag_table_t riscv_ext_flag_table[] =
   {"f", &gcc_options::x_target_flags, MASK_HARD_FLOAT},
   {"d", &gcc_options::x_target_flags, MASK_DOUBLE_FLOAT},
   {"c", &gcc_options::x_target_flags, MASK_RVC},
+  {"p", &gcc_options::x_target_flags, MASK_PACKED_SIMD},
+  {"v", &gcc_options::x_target_flags, MASK_VECTOR},
 
   {"zicsr",    &gcc_options::x_riscv_zi_subext, MASK_ZICSR},
   {"zifencei", &gcc_options::x_riscv_zi_subext, MASK_ZIFENCEI},
+  {"zicond",   &gcc_options::x_riscv_zi_subext, MASK_ZICOND},
+  {"zicboz",   &gcc_options::x_riscv_zi_subext, MASK_ZICBOZ},
+  {"zicbop",   &gcc_options::x_riscv_zi_subext, MASK_ZICBOP},
+  {"zic64b",   &gcc_options::x_riscv_zi_subext, MASK_ZIC64B},
+  {"zihintntl", &gcc_options::x_riscv_zi_subext, MASK_ZIHINTNTL},
+
+  {"ztso",     &gcc_options::x_riscv_za_subext, MASK_ZTSO},
+
+  {"zfh",     &gcc_options::x_riscv_zf_subext, MASK_ZFH},
+  {"zfhmin",  &gcc_options::x_riscv_zf_subext, MASK_ZFHMIN},
+  {"zfbfmin", &gcc_options::x_riscv_zf_subext, MASK_ZFBFMIN},
+
+  {"zca",  &gcc_options::x_riscv_zc_subext, MASK_ZCA},
+  {"zcmp", &gcc_options::x_riscv_zc_subext, MASK_ZCMP},
+  {"zcmt", &gcc_options::x_riscv_zc_subext, MASK_ZCMT},
+
+  {"zba",    &gcc_options::x_riscv_zb_subext, MASK_ZBA},
+  {"zbb",    &gcc_options::x_riscv_zb_subext, MASK_ZBB},
+  {"zbs",    &gcc_options::x_riscv_zb_subext, MASK_ZBS},
+
+  {"zbkb",   &gcc_options::x_riscv_zk_subext, MASK_ZBKB},
+  {"zknd",   &gcc_options::x_riscv_zk_subext, MASK_ZKND},
+  {"zkne",   &gcc_options::x_riscv_zk_subext, MASK_ZKNE},
+  {"zknh",   &gcc_options::x_riscv_zk_subext, MASK_ZKNH},
 
   {NULL, NULL, 0}
 };
 
-/* Parse a RISC-V ISA string into an option mask.  Must clear or set all arch
-   dependent mask bits, in case more than one -march string is passed.  */
+/* Set the arch dependent mask bits in OPTS from SUBSET_LIST.  Must clear or
+   set all of them, in case more than one -march string is passed.  */
+
+static void
+riscv_set_arch_flags (const riscv_subset_list *subset_list,
+		      struct gcc_options *opts)
+{
+  const riscv_ext_flag_table_t *arch_ext_flag_tab;
+  /* Clean up target flags before we set.  */
+  for (arch_ext_flag_tab = &riscv_ext_flag_table[0];
+       arch_ext_flag_tab->ext;
+       ++arch_ext_flag_tab)
+    opts->*arch_ext_flag_tab->var_ref &= ~arch_ext_flag_tab->mask;
+
+  if (subset_list->xlen () == 32)
+    opts->x_target_flags &= ~MASK_64BIT;
+  else if (subset_list->xlen () == 64)
+    opts->x_target_flags |= MASK_64BIT;
+
+
+  for (arch_ext_flag_tab = &riscv_ext_flag_table[0];
+       arch_ext_flag_tab->ext;
+       ++arch_ext_flag_tab)
+    {
+      if (subset_list->lookup (arch_ext_flag_tab->ext))
+	opts->*arch_ext_flag_tab->var_ref |= arch_ext_flag_tab->mask;
+    }
+}
+
+/* Parse a RISC-V ISA string into an option mask.  */
 
 static void
 riscv_parse_arch_string (const char *isa,
@@ -921,33 +1026,64 @@ riscv_parse_arch_string (const char *isa,
     return;
 
   if (opts)
+    riscv_set_arch_flags (subset_list, opts);
+
+  if (current_subset_list)
+    delete current_subset_list;
+
+  current_subset_list = subset_list;
+}
+
+/* Parse ARCH, the argument of an "arch=" target attribute, and set the arch
+   dependent mask bits in OPTS.  ARCH is either a full ISA string or a
+   comma-separated list of "+EXT" extensions to add to the ISA given by
+   -march.  Return the resulting ISA string, or an empty string after
+   reporting an error.  Unlike -march, this does not change the ISA that
+   is recorded in the ELF attributes.  */
+
+std::string
+riscv_parse_target_arch (const char *arch, struct gcc_options *opts,
+			 location_t loc)
+{
+  std::string isa = arch;
+
+  if (arch[0] == '+')
     {
-      const riscv_ext_flag_table_t *arch_ext_flag_tab;
-      /* Clean up target flags before we set.  */
-      for (arch_ext_flag_tab = &riscv_ext_flag_table[0];
-	   arch_ext_flag_tab->ext;
-	   ++arch_ext_flag_tab)
-	opts->*arch_ext_flag_tab->var_ref &= ~arch_ext_flag_tab->mask;
-
-      if (subset_list->xlen () == 32)
-	opts->x_target_flags &= ~MASK_64BIT;
-      else if (subset_list->xlen () == 64)
-	opts->x_target_flags |= MASK_64BIT;
-
-
-      for (arch_ext_flag_tab = &riscv_ext_flag_table[0];
-	   arch_ext_flag_tab->ext;
-	   ++arch_ext_flag_tab)
+      riscv_subset_list *base
+	= riscv_subset_list::parse (riscv_arch_str (false).c_str (), loc);
+      if (!base)
+	return std::string ();
+
+      char *str = ASTRDUP (arch);
+      for (char *ext = strtok (str, ","); ext; ext = strtok (NULL, ","))
 	{
-	  if (subset_list->lookup (arch_ext_flag_tab->ext))
-	    opts->*arch_ext_flag_tab->var_ref |= arch_ext_flag_tab->mask;
+	  if (ext[0] != '+'
+	      || ext[1] == '\0'
+	      || (ext[2] == '\0' && strchr ("eig", ext[1])))
+	    {
+	      error_at (loc, "%<target(\"arch=%s\")%>: %qs is not of the "
+			"form %<+EXTENSION%>", arch, ext);
+	      delete base;
+	      return std::string ();
+	    }
+
+	  if (!base->lookup (ext + 1))
+	    base->add (ext + 1, false);
 	}
+
+      isa = base->to_string (false);
+      delete base;
     }
 
-  if (current_subset_list)
-    delete current_subset_list;
+  riscv_subset_list *subset_list
+    = riscv_subset_list::parse (isa.c_str (), loc);
+  if (!subset_list)
+    return std::string ();
 
-  current_subset_list = subset_list;
+  riscv_set_arch_flags (subset_list, opts);
+  isa = subset_list->to_string (false);
+  delete subset_list;
+  return isa;
 }
 
 /* Return the riscv_cpu_info entry for CPU, NULL if not found.  */
@@ -1058,6 +1194,7 @@ static const struct default_options riscv_option_optimization_table[] =
   {
     { OPT_LEVELS_1_PLUS, OPT_fsection_anchors, NULL, 1 },
     { OPT_LEVELS_2_PLUS, OPT_free, NULL, 1 },
+    { OPT_LEVELS_2_PLUS, OPT_freorder_blocks_and_partition, NULL, 1 },
     { OPT_LEVELS_NONE, 0, NULL, 0 }
   };
 
@@ -40,6 +40,8 @@ along with GCC; see the file COPYING3.  If not see
 /* Macros to create an enumeration identifier for a function prototype.  */
 #define RISCV_FTYPE_NAME0(A) RISCV_##A##_FTYPE
 #define RISCV_FTYPE_NAME1(A, B) RISCV_##A##_FTYPE_##B
+#define RISCV_FTYPE_NAME2(A, B, C) RISCV_##A##_FTYPE_##B##_##C
+#define RISCV_FTYPE_NAME3(A, B, C, D) RISCV_##A##_FTYPE_##B##_##C##_##D
 
 /* Classifies the prototype of a built-in function.  */
 enum riscv_function_type {
@@ -86,6 +88,18 @@ struct riscv_builtin_description {
 };
 
 AVAIL (hard_float, TARGET_HARD_FLOAT)
+AVAIL (zbkb32, TARGET_ZBKB && !TARGET_64BIT)
+AVAIL (zbkb64, TARGET_ZBKB && TARGET_64BIT)
+AVAIL (zknd32, TARGET_ZKND && !TARGET_64BIT)
+AVAIL (zknd64, TARGET_ZKND && TARGET_64BIT)
+AVAIL (zkne32, TARGET_ZKNE && !TARGET_64BIT)
+AVAIL (zkne64, TARGET_ZKNE && TARGET_64BIT)
+AVAIL (zkne_or_zknd64, (TARGET_ZKNE || TARGET_ZKND) && TARGET_64BIT)
+AVAIL (zknh, TARGET_ZKNH)
+AVAIL (zknh32, TARGET_ZKNH && !TARGET_64BIT)
+AVAIL (zknh64, TARGET_ZKNH && TARGET_64BIT)
+AVAIL (vector, TARGET_VECTOR)
+AVAIL (vector64, TARGET_VECTOR && TARGET_64BIT)
 
 /* Construct a riscv_builtin_description from the given arguments.
 
@@ -116,9 +130,30 @@ AVAIL (hard_float, TARGET_HARD_FLOAT)
   RISCV_BUILTIN (INSN, #INSN, RISCV_BUILTIN_DIRECT_NO_TARGET,		\
 		FUNCTION_TYPE, AVAIL)
 
+/* Define __builtin_riscv_<INSN>_<MODE>, which is a RISCV_BUILTIN_DIRECT
+   function mapped to instruction CODE_FOR_riscv_<INSN><MODE>.  */
+#define VREDUC_BUILTIN(INSN, MODE, FUNCTION_TYPE, AVAIL)		\
+  RISCV_BUILTIN (INSN ## MODE, #INSN "_" #MODE, RISCV_BUILTIN_DIRECT,	\
+		 FUNCTION_TYPE, AVAIL)
+
+/* Define the VREDUC_BUILTINs for single-operand reduction INSN.  */
+#define VREDUC_BUILTINS(INSN)						\
+  VREDUC_BUILTIN (INSN, v16qi, RISCV_V16QI_FTYPE_V16QI, vector),	\
+  VREDUC_BUILTIN (INSN, v8hi, RISCV_V8HI_FTYPE_V8HI, vector),		\
+  VREDUC_BUILTIN (INSN, v4si, RISCV_V4SI_FTYPE_V4SI, vector),		\
+  VREDUC_BUILTIN (INSN, v2di, RISCV_V2DI_FTYPE_V2DI, vector64)
+
 /* Argument types.  */
 #define RISCV_ATYPE_VOID void_type_node
 #define RISCV_ATYPE_USI unsigned_intSI_type_node
+#define RISCV_ATYPE_UDI unsigned_intDI_type_node
+#define RISCV_ATYPE_POINTER ptr_type_node
+#define RISCV_ATYPE_CPOINTER const_ptr_type_node
+#define RISCV_ATYPE_SIZE size_type_node
+#define RISCV_ATYPE_V16QI build_vector_type (signed_char_type_node, 16)
+#define RISCV_ATYPE_V8HI build_vector_type (short_integer_type_node, 8)
+#define RISCV_ATYPE_V4SI build_vector_type (integer_type_node, 4)
+#define RISCV_ATYPE_V2DI build_vector_type (long_long_integer_type_node, 2)
 
 /* RISCV_FTYPE_ATYPESN takes N RISCV_FTYPES-like type codes and lists
    their associated RISCV_ATYPEs.  */
@@ -126,10 +161,73 @@ AVAIL (hard_float, TARGET_HARD_FLOAT)
   RISCV_ATYPE_##A
 #define RISCV_FTYPE_ATYPES1(A, B) \
   RISCV_ATYPE_##A, RISCV_ATYPE_##B
+#define RISCV_FTYPE_ATYPES2(A, B, C) \
+  RISCV_ATYPE_##A, RISCV_ATYPE_##B, RISCV_ATYPE_##C
+#define RISCV_FTYPE_ATYPES3(A, B, C, D) \
+  RISCV_ATYPE_##A, RISCV_ATYPE_##B, RISCV_ATYPE_##C, RISCV_ATYPE_##D
 
 static const struct riscv_builtin_description riscv_builtins[] = {
   DIRECT_BUILTIN (frflags, RISCV_USI_FTYPE, hard_float),
-  DIRECT_NO_TARGET_BUILTIN (fsflags, RISCV_VOID_FTYPE_USI, hard_float)
+  DIRECT_NO_TARGET_BUILTIN (fsflags, RISCV_VOID_FTYPE_USI, hard_float),
+
+  /* Zbkb.  The XLEN-sized operations have the same name for RV32 and
+     RV64.  */
+  RISCV_BUILTIN (packsi, "pack", RISCV_BUILTIN_DIRECT,
+		 RISCV_USI_FTYPE_USI_USI, zbkb32),
+  RISCV_BUILTIN (packdi, "pack", RISCV_BUILTIN_DIRECT,
+		 RISCV_UDI_FTYPE_UDI_UDI, zbkb64),
+  RISCV_BUILTIN (packhsi, "packh", RISCV_BUILTIN_DIRECT,
+		 RISCV_USI_FTYPE_USI_USI, zbkb32),
+  RISCV_BUILTIN (packhdi, "packh", RISCV_BUILTIN_DIRECT,
+		 RISCV_UDI_FTYPE_UDI_UDI, zbkb64),
+  RISCV_BUILTIN (brev8si, "brev8", RISCV_BUILTIN_DIRECT,
+		 RISCV_USI_FTYPE_USI, zbkb32),
+  RISCV_BUILTIN (brev8di, "brev8", RISCV_BUILTIN_DIRECT,
+		 RISCV_UDI_FTYPE_UDI, zbkb64),
+  DIRECT_BUILTIN (zip, RISCV_USI_FTYPE_USI, zbkb32),
+  DIRECT_BUILTIN (unzip, RISCV_USI_FTYPE_USI, zbkb32),
+
+  /* Zknd and Zkne.  */
+  DIRECT_BUILTIN (aes32dsi, RISCV_USI_FTYPE_USI_USI_USI, zknd32),
+  DIRECT_BUILTIN (aes32dsmi, RISCV_USI_FTYPE_USI_USI_USI, zknd32),
+  DIRECT_BUILTIN (aes32esi, RISCV_USI_FTYPE_USI_USI_USI, zkne32),
+  DIRECT_BUILTIN (aes32esmi, RISCV_USI_FTYPE_USI_USI_USI, zkne32),
+  DIRECT_BUILTIN (aes64ds, RISCV_UDI_FTYPE_UDI_UDI, zknd64),
+  DIRECT_BUILTIN (aes64dsm, RISCV_UDI_FTYPE_UDI_UDI, zknd64),
+  DIRECT_BUILTIN (aes64im, RISCV_UDI_FTYPE_UDI, zknd64),
+  DIRECT_BUILTIN (aes64es, RISCV_UDI_FTYPE_UDI_UDI, zkne64),
+  DIRECT_BUILTIN (aes64esm, RISCV_UDI_FTYPE_UDI_UDI, zkne64),
+  DIRECT_BUILTIN (aes64ks1i, RISCV_UDI_FTYPE_UDI_USI, zkne_or_zknd64),
+  DIRECT_BUILTIN (aes64ks2, RISCV_UDI_FTYPE_UDI_UDI, zkne_or_zknd64),
+
+  /* Zknh.  */
+  DIRECT_BUILTIN (sha256sig0, RISCV_USI_FTYPE_USI, zknh),
+  DIRECT_BUILTIN (sha256sig1, RISCV_USI_FTYPE_USI, zknh),
+  DIRECT_BUILTIN (sha256sum0, RISCV_USI_FTYPE_USI, zknh),
+  DIRECT_BUILTIN (sha256sum1, RISCV_USI_FTYPE_USI, zknh),
+  DIRECT_BUILTIN (sha512sig0, RISCV_UDI_FTYPE_UDI, zknh64),
+  DIRECT_BUILTIN (sha512sig1, RISCV_UDI_FTYPE_UDI, zknh64),
+  DIRECT_BUILTIN (sha512sum0, RISCV_UDI_FTYPE_UDI, zknh64),
+  DIRECT_BUILTIN (sha512sum1, RISCV_UDI_FTYPE_UDI, zknh64),
+  DIRECT_BUILTIN (sha512sig0h, RISCV_USI_FTYPE_USI_USI, zknh32),
+  DIRECT_BUILTIN (sha512sig0l, RISCV_USI_FTYPE_USI_USI, zknh32),
+  DIRECT_BUILTIN (sha512sig1h, RISCV_USI_FTYPE_USI_USI, zknh32),
+  DIRECT_BUILTIN (sha512sig1l, RISCV_USI_FTYPE_USI_USI, zknh32),
+  DIRECT_BUILTIN (sha512sum0r, RISCV_USI_FTYPE_USI_USI, zknh32),
+  DIRECT_BUILTIN (sha512sum1r, RISCV_USI_FTYPE_USI_USI, zknh32),
+
+  /* Support for the V intrinsics in riscv_vector.h.  The loads and
+     stores take a length in bytes.  */
+  DIRECT_BUILTIN (vle, RISCV_V16QI_FTYPE_CPOINTER_SIZE, vector),
+  DIRECT_NO_TARGET_BUILTIN (vse, RISCV_VOID_FTYPE_POINTER_V16QI_SIZE, vector),
+  VREDUC_BUILTIN (vredsum, v16qi, RISCV_V16QI_FTYPE_V16QI_V16QI, vector),
+  VREDUC_BUILTIN (vredsum, v8hi, RISCV_V8HI_FTYPE_V8HI_V8HI, vector),
+  VREDUC_BUILTIN (vredsum, v4si, RISCV_V4SI_FTYPE_V4SI_V4SI, vector),
+  VREDUC_BUILTIN (vredsum, v2di, RISCV_V2DI_FTYPE_V2DI_V2DI, vector64),
+  VREDUC_BUILTINS (vredmax),
+  VREDUC_BUILTINS (vredmaxu),
+  VREDUC_BUILTINS (vredmin),
+  VREDUC_BUILTINS (vredminu)
 };
 
 /* Index I is the function declaration for riscv_builtins[I], or null if the
@@ -143,6 +241,9 @@ static GTY(()) int riscv_builtin_decl_index[NUM_INSN_CODES];
 #define GET_BUILTIN_DECL(CODE) \
   riscv_builtin_decls[riscv_builtin_decl_index[(CODE)]]
 
+/* The __bf16 type, if Zfbfmin is enabled.  */
+static GTY(()) tree riscv_bf16_type_node;
+
 /* Return the function type associated with function prototype TYPE.  */
 
 static tree
@@ -173,6 +274,17 @@ riscv_build_function_type (enum riscv_function_type type)
 void
 riscv_init_builtins (void)
 {
+  /* __bf16 is a storage type that can only be converted to and from float,
+     which needs the Zfbfmin conversions.  */
+  if (TARGET_ZFBFMIN)
+    {
+      riscv_bf16_type_node = make_node (REAL_TYPE);
+      TYPE_PRECISION (riscv_bf16_type_node) = 16;
+      SET_TYPE_MODE (riscv_bf16_type_node, BFmode);
+      layout_type (riscv_bf16_type_node);
+      lang_hooks.types.register_builtin_type (riscv_bf16_type_node, "__bf16");
+    }
+
   for (size_t i = 0; i < ARRAY_SIZE (riscv_builtins); i++)
     {
       const struct riscv_builtin_description *d = &riscv_builtins[i];
@@ -64,6 +64,13 @@ riscv_cpu_cpp_builtins (cpp_reader *pfile)
       builtin_define ("__riscv_fsqrt");
     }
 
+  if (TARGET_VECTOR)
+    {
+      builtin_define ("__riscv_vector");
+      builtin_define_with_int_value ("__riscv_v_min_vlen",
+				     UNITS_PER_V_REG * 8);
+    }
+
   switch (riscv_abi)
     {
     case ABI_ILP32E:
@@ -0,0 +1,157 @@
+/* Far jumps between hot and cold partitions for RISC-V.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#define IN_TARGET_CODE 1
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "tm.h"
+#include "rtl.h"
+#include "backend.h"
+#include "regs.h"
+#include "target.h"
+#include "memmodel.h"
+#include "emit-rtl.h"
+#include "df.h"
+#include "tree-pass.h"
+#include "tm_p.h"
+
+/* The hot and cold partitions of a function go to different sections,
+   which the linker can place further apart than the 1 MiB that JAL
+   reaches.  bb-reorder makes the crossing jumps indirect when it
+   partitions the function, while it can still use pseudos, but later
+   CFG changes can create new direct ones.  This pass rewrites those to
+   go through a temporary that is dead at the jump.  */
+
+namespace {
+
+/* The temporaries to use, in order of preference.  */
+
+const unsigned int far_jump_regs[] = {
+  T0_REGNUM, T1_REGNUM, GP_REG_FIRST + 7,
+  GP_REG_FIRST + 28, GP_REG_FIRST + 29, GP_REG_FIRST + 30, GP_REG_FIRST + 31,
+  GP_ARG_FIRST + 7, GP_ARG_FIRST + 6, GP_ARG_FIRST + 5, GP_ARG_FIRST + 4,
+  GP_ARG_FIRST + 3, GP_ARG_FIRST + 2, GP_ARG_FIRST + 1, GP_ARG_FIRST
+};
+
+/* Return a call-clobbered register that is dead on exit from BB, or
+   INVALID_REGNUM if there is none.  */
+
+static unsigned int
+far_jump_temporary (basic_block bb)
+{
+  bitmap live = df_get_live_out (bb);
+
+  for (unsigned int i = 0; i < ARRAY_SIZE (far_jump_regs); i++)
+    {
+      unsigned int regno = far_jump_regs[i];
+
+      if (!fixed_regs[regno]
+	  && !global_regs[regno]
+	  && call_used_or_fixed_reg_p (regno)
+	  && riscv_hard_regno_rename_ok (regno, regno)
+	  && !bitmap_bit_p (live, regno))
+	return regno;
+    }
+
+  return INVALID_REGNUM;
+}
+
+const pass_data pass_data_far_jumps =
+{
+  RTL_PASS, /* type */
+  "far_jumps", /* name */
+  OPTGROUP_NONE, /* optinfo_flags */
+  TV_NONE, /* tv_id */
+  0, /* properties_required */
+  0, /* properties_provided */
+  0, /* properties_destroyed */
+  0, /* todo_flags_start */
+  0, /* todo_flags_finish */
+};
+
+class pass_far_jumps : public rtl_opt_pass
+{
+public:
+  pass_far_jumps (gcc::context *ctxt)
+    : rtl_opt_pass (pass_data_far_jumps, ctxt)
+  {}
+
+  /* opt_pass methods: */
+  virtual bool gate (function *)
+    {
+      return crtl->has_bb_partition;
+    }
+  virtual unsigned int execute (function *);
+}; // class pass_far_jumps
+
+unsigned int
+pass_far_jumps::execute (function *fn)
+{
+  basic_block bb;
+
+  df_analyze ();
+
+  FOR_EACH_BB_FN (bb, fn)
+    {
+      rtx_insn *jump = BB_END (bb);
+
+      if (!JUMP_P (jump)
+	  || !CROSSING_JUMP_P (jump)
+	  || !simplejump_p (jump))
+	continue;
+
+      /* With no temporary to spare, leave the jump alone; the linker
+	 reports it if it does turn out to be out of range.  */
+      unsigned int regno = far_jump_temporary (bb);
+      if (regno == INVALID_REGNUM)
+	{
+	  if (dump_file)
+	    fprintf (dump_file, "insn %d: no temporary for far jump\n",
+		     INSN_UID (jump));
+	  continue;
+	}
+
+      rtx label = JUMP_LABEL (jump);
+      rtx reg = gen_rtx_REG (Pmode, regno);
+      rtx pat = (Pmode == DImode
+		 ? gen_far_jumpdi (label, reg)
+		 : gen_far_jumpsi (label, reg));
+      rtx_insn *far = emit_jump_insn_before (pat, jump);
+      JUMP_LABEL (far) = label;
+      LABEL_NUSES (label)++;
+      CROSSING_JUMP_P (far) = 1;
+      delete_insn (jump);
+
+      if (dump_file)
+	fprintf (dump_file, "insn %d: far jump through %s\n",
+		 INSN_UID (far), reg_names[regno]);
+    }
+
+  return 0;
+}
+
+} // anon namespace
+
+rtl_opt_pass *
+make_pass_far_jumps (gcc::context *ctxt)
+{
+  return new pass_far_jumps (ctxt);
+}
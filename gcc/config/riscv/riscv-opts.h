@@ -52,7 +52,8 @@ extern enum riscv_isa_spec_class riscv_isa_spec;
 /* Keep this list in sync with define_attr "tune" in riscv.md.  */
 enum riscv_microarchitecture_type {
   generic,
-  sifive_7
+  sifive_7,
+  generic_ooo
 };
 extern enum riscv_microarchitecture_type riscv_microarchitecture;
 
@@ -67,10 +68,64 @@ enum stack_protector_guard {
   SSP_GLOBAL			/* global canary */
 };
 
+/* How dynamic TLS accesses find their address.  */
+enum riscv_tls_type {
+  TLS_TRADITIONAL,		/* call __tls_get_addr */
+  TLS_DESCRIPTORS		/* call the resolver in the TLS descriptor */
+};
+
 #define MASK_ZICSR    (1 << 0)
 #define MASK_ZIFENCEI (1 << 1)
+#define MASK_ZICOND   (1 << 2)
+#define MASK_ZICBOZ   (1 << 3)
+#define MASK_ZICBOP   (1 << 4)
+#define MASK_ZIC64B   (1 << 5)
+#define MASK_ZIHINTNTL (1 << 6)
 
 #define TARGET_ZICSR    ((riscv_zi_subext & MASK_ZICSR) != 0)
 #define TARGET_ZIFENCEI ((riscv_zi_subext & MASK_ZIFENCEI) != 0)
+#define TARGET_ZICOND   ((riscv_zi_subext & MASK_ZICOND) != 0)
+#define TARGET_ZICBOZ   ((riscv_zi_subext & MASK_ZICBOZ) != 0)
+#define TARGET_ZICBOP   ((riscv_zi_subext & MASK_ZICBOP) != 0)
+#define TARGET_ZIC64B   ((riscv_zi_subext & MASK_ZIC64B) != 0)
+#define TARGET_ZIHINTNTL ((riscv_zi_subext & MASK_ZIHINTNTL) != 0)
+
+#define MASK_ZTSO     (1 << 0)
+
+#define TARGET_ZTSO     ((riscv_za_subext & MASK_ZTSO) != 0)
+
+#define MASK_ZFHMIN   (1 << 0)
+#define MASK_ZFH      (1 << 1)
+#define MASK_ZFBFMIN  (1 << 2)
+
+#define TARGET_ZFHMIN  ((riscv_zf_subext & MASK_ZFHMIN) != 0)
+#define TARGET_ZFH     ((riscv_zf_subext & MASK_ZFH) != 0)
+#define TARGET_ZFBFMIN ((riscv_zf_subext & MASK_ZFBFMIN) != 0)
+
+#define MASK_ZCA      (1 << 0)
+#define MASK_ZCMP     (1 << 1)
+#define MASK_ZCMT     (1 << 2)
+
+#define TARGET_ZCA    ((riscv_zc_subext & MASK_ZCA) != 0)
+#define TARGET_ZCMP   ((riscv_zc_subext & MASK_ZCMP) != 0)
+#define TARGET_ZCMT   ((riscv_zc_subext & MASK_ZCMT) != 0)
+
+#define MASK_ZBA      (1 << 0)
+#define MASK_ZBB      (1 << 1)
+#define MASK_ZBS      (1 << 2)
+
+#define TARGET_ZBA    ((riscv_zb_subext & MASK_ZBA) != 0)
+#define TARGET_ZBB    ((riscv_zb_subext & MASK_ZBB) != 0)
+#define TARGET_ZBS    ((riscv_zb_subext & MASK_ZBS) != 0)
+
+#define MASK_ZBKB     (1 << 0)
+#define MASK_ZKND     (1 << 1)
+#define MASK_ZKNE     (1 << 2)
+#define MASK_ZKNH     (1 << 3)
+
+#define TARGET_ZBKB   ((riscv_zk_subext & MASK_ZBKB) != 0)
+#define TARGET_ZKND   ((riscv_zk_subext & MASK_ZKND) != 0)
+#define TARGET_ZKNE   ((riscv_zk_subext & MASK_ZKNE) != 0)
+#define TARGET_ZKNH   ((riscv_zk_subext & MASK_ZKNH) != 0)
 
 #endif /* ! GCC_RISCV_OPTS_H */
@@ -0,0 +1,595 @@
+/* Machine outliner for RISC-V.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#define IN_TARGET_CODE 1
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "tm.h"
+#include "rtl.h"
+#include "tree.h"
+#include "backend.h"
+#include "regs.h"
+#include "target.h"
+#include "memmodel.h"
+#include "emit-rtl.h"
+#include "df.h"
+#include "cfgrtl.h"
+#include "predict.h"
+#include "attribs.h"
+#include "insn-attr.h"
+#include "tree-pass.h"
+#include "tm_p.h"
+
+/* After register allocation, a function often contains the same
+   instruction sequence several times: the same constant built for
+   several error paths, identical spill and reload sequences, or the
+   argument setup for the same call.  This pass replaces repeated
+   sequences with a JAL to a single copy placed after the end of the
+   function, which returns with JR.  Like the -msave-restore millicode,
+   the link register is T0, so RA need not be saved, and the sequences
+   must leave T0 alone and be followed by code that does not need it.
+
+   Each instruction that can be outlined is given a number that is the
+   same for identical patterns, and the function becomes a string of
+   those numbers, with a unique separator wherever a sequence cannot
+   continue (labels, jumps, calls, and instructions that cannot be
+   moved).  Repeated sequences are then the internal nodes of the
+   suffix tree of that string, which are found as the LCP intervals of
+   its suffix array.
+
+   Since RTL functions are compiled one at a time, this only outlines
+   sequences that repeat within a function; identical functions are
+   already merged by ipa-icf.  The outlined copies have no CFI of their
+   own, which matters only to asynchronous unwinders, since they never
+   contain calls or instructions that can throw.  */
+
+namespace {
+
+/* The shortest and longest sequences to consider.  */
+const int min_outline_length = 2;
+const int max_outline_length = 64;
+
+/* Functions bigger than this many bytes might put an outlined sequence
+   out of JAL range.  */
+const int max_outline_function_size = 512 * 1024;
+
+/* An instruction pattern and its number in the string.  */
+
+struct outline_pattern
+{
+  hashval_t hash;
+  rtx pat;
+  int id;
+};
+
+struct outline_pattern_hasher : free_ptr_hash <outline_pattern>
+{
+  static inline hashval_t hash (const outline_pattern *p) { return p->hash; }
+  static inline bool equal (const outline_pattern *a,
+			    const outline_pattern *b)
+  {
+    return rtx_equal_p (a->pat, b->pat);
+  }
+};
+
+/* A repeated sequence: LENGTH symbols starting at each of the
+   NUM_STARTS positions in STARTS.  */
+
+struct outline_candidate
+{
+  int length;
+  int num_starts;
+  int *starts;
+  int benefit;
+};
+
+class machine_outliner
+{
+public:
+  machine_outliner ();
+  ~machine_outliner ();
+
+  unsigned int execute ();
+
+private:
+  bool outlinable_insn_p (rtx_insn *);
+  bool outlinable_bb_p (basic_block);
+  int insn_size (rtx_insn *);
+  void add_separator ();
+  void add_insn (rtx_insn *, bool);
+  void build_string ();
+  void build_suffix_array ();
+  void add_candidate (int, int, int);
+  void find_candidates ();
+  int select_starts (outline_candidate *, vec<int> *);
+  void outline (outline_candidate *, const vec<int> &);
+
+  /* The string, and the instruction at each position, which is null
+     for separators.  */
+  auto_vec<int> m_str;
+  auto_vec<rtx_insn *> m_insns;
+
+  /* Whether the sequence that ends at each position may be replaced:
+     T0 is dead after it and its block is not hot.  */
+  auto_vec<bool> m_end_ok;
+
+  /* Positions that have already been outlined.  */
+  auto_vec<bool> m_used;
+
+  /* The suffix array and the length of the common prefix of each suffix
+     and its predecessor in it.  */
+  auto_vec<int> m_sa;
+  auto_vec<int> m_lcp;
+
+  hash_table<outline_pattern_hasher> m_patterns;
+  auto_vec<outline_candidate> m_candidates;
+  int m_next_separator;
+  rtx m_t0;
+};
+
+machine_outliner::machine_outliner ()
+  : m_patterns (64), m_next_separator (-1),
+    m_t0 (gen_rtx_REG (Pmode, T0_REGNUM))
+{
+}
+
+machine_outliner::~machine_outliner ()
+{
+  for (unsigned int i = 0; i < m_candidates.length (); i++)
+    XDELETEVEC (m_candidates[i].starts);
+}
+
+/* Return true if INSN can be moved into an outlined sequence.  */
+
+bool
+machine_outliner::outlinable_insn_p (rtx_insn *insn)
+{
+  if (!NONJUMP_INSN_P (insn) || RTX_FRAME_RELATED_P (insn))
+    return false;
+
+  rtx pat = PATTERN (insn);
+  if (GET_CODE (pat) == USE
+      || GET_CODE (pat) == CLOBBER
+      || asm_noperands (pat) >= 0
+      || recog_memoized (insn) < 0
+      || get_attr_type (insn) == TYPE_GHOST)
+    return false;
+
+  /* T0 holds the return address, and the stack pointer must be the
+     same as at the call.  */
+  if (refers_to_regno_p (T0_REGNUM, pat)
+      || reg_set_p (stack_pointer_rtx, insn))
+    return false;
+
+  return (!insn_could_throw_p (insn)
+	  && !find_reg_note (insn, REG_LABEL_OPERAND, NULL_RTX)
+	  && !find_reg_note (insn, REG_ARGS_SIZE, NULL_RTX));
+}
+
+/* Return true if code in BB may be outlined: it is cold, or lukewarm
+   in that it runs at most half as often as the function is entered,
+   which keeps loop bodies and the common paths out.  */
+
+bool
+machine_outliner::outlinable_bb_p (basic_block bb)
+{
+  if (optimize_bb_for_size_p (bb))
+    return true;
+
+  profile_count entry = ENTRY_BLOCK_PTR_FOR_FN (cfun)->count;
+  return bb->count.apply_scale (2, 1) <= entry;
+}
+
+/* Return a lower bound on the size of INSN in bytes.  */
+
+int
+machine_outliner::insn_size (rtx_insn *insn)
+{
+  int length = get_attr_length (insn);
+  return TARGET_RVC ? length / 2 : length;
+}
+
+/* Add a separator to the string.  */
+
+void
+machine_outliner::add_separator ()
+{
+  m_str.safe_push (m_next_separator--);
+  m_insns.safe_push (NULL);
+  m_end_ok.safe_push (false);
+}
+
+/* Add outlinable instruction INSN to the string.  T0_LIVE says whether
+   T0 is live after it.  */
+
+void
+machine_outliner::add_insn (rtx_insn *insn, bool t0_live)
+{
+  outline_pattern key;
+  int do_not_record = 0;
+
+  key.pat = PATTERN (insn);
+  key.hash = hash_rtx (key.pat, VOIDmode, &do_not_record, NULL, false);
+  outline_pattern **slot = m_patterns.find_slot (&key, INSERT);
+  if (!*slot)
+    {
+      *slot = XNEW (outline_pattern);
+      **slot = key;
+      (*slot)->id = m_patterns.elements () - 1;
+    }
+
+  m_str.safe_push ((*slot)->id);
+  m_insns.safe_push (insn);
+  m_end_ok.safe_push (!t0_live && outlinable_bb_p (BLOCK_FOR_INSN (insn)));
+}
+
+/* Turn the function into the string.  */
+
+void
+machine_outliner::build_string ()
+{
+  basic_block bb;
+  auto_bitmap live;
+  auto_sbitmap t0_live_after (get_max_uid ());
+
+  /* Find where T0 is live by simulating each block backwards.  */
+  bitmap_clear (t0_live_after);
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      rtx_insn *insn;
+
+      bitmap_copy (live, df_get_live_out (bb));
+      FOR_BB_INSNS_REVERSE (bb, insn)
+	if (NONDEBUG_INSN_P (insn))
+	  {
+	    if (bitmap_bit_p (live, T0_REGNUM))
+	      bitmap_set_bit (t0_live_after, INSN_UID (insn));
+	    df_simulate_one_insn_backwards (bb, insn, live);
+	  }
+    }
+
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      rtx_insn *insn;
+
+      add_separator ();
+      FOR_BB_INSNS (bb, insn)
+	{
+	  if (NOTE_P (insn) || DEBUG_INSN_P (insn))
+	    continue;
+
+	  if (outlinable_insn_p (insn))
+	    add_insn (insn, bitmap_bit_p (t0_live_after, INSN_UID (insn)));
+	  else
+	    add_separator ();
+	}
+    }
+  add_separator ();
+}
+
+/* The string being sorted by build_suffix_array.  */
+static const int *outline_str;
+
+/* Compare the suffixes that start at the positions that PA and PB point
+   to, looking at no more than max_outline_length symbols.  */
+
+static int
+compare_suffixes (const void *pa, const void *pb)
+{
+  int a = *(const int *) pa;
+  int b = *(const int *) pb;
+
+  for (int i = 0; i < max_outline_length; i++)
+    {
+      int ca = outline_str[a + i];
+      int cb = outline_str[b + i];
+      if (ca != cb)
+	return ca < cb ? -1 : 1;
+      /* Separators are unique, so A and B are the same suffix.  */
+      if (ca < 0)
+	break;
+    }
+  return a < b ? -1 : a > b ? 1 : 0;
+}
+
+/* Build the suffix array of the string and its LCP array.  */
+
+void
+machine_outliner::build_suffix_array ()
+{
+  int n = m_str.length ();
+
+  m_sa.safe_grow (n, true);
+  for (int i = 0; i < n; i++)
+    m_sa[i] = i;
+  outline_str = m_str.address ();
+  m_sa.qsort (compare_suffixes);
+  outline_str = NULL;
+
+  m_lcp.safe_grow_cleared (n, true);
+  for (int i = 1; i < n; i++)
+    {
+      int a = m_sa[i - 1], b = m_sa[i], l = 0;
+      while (l < max_outline_length
+	     && m_str[a + l] >= 0
+	     && m_str[a + l] == m_str[b + l])
+	l++;
+      m_lcp[i] = l;
+    }
+}
+
+/* Sort positions in increasing order.  */
+
+static int
+compare_positions (const void *pa, const void *pb)
+{
+  int a = *(const int *) pa;
+  int b = *(const int *) pb;
+  return a < b ? -1 : a > b ? 1 : 0;
+}
+
+/* Record the sequence of LENGTH symbols that starts at the positions in
+   suffix array entries LB to RB.  */
+
+void
+machine_outliner::add_candidate (int length, int lb, int rb)
+{
+  if (length < min_outline_length)
+    return;
+
+  outline_candidate c;
+  c.length = length;
+  c.num_starts = rb - lb + 1;
+  c.starts = XNEWVEC (int, c.num_starts);
+  for (int i = lb; i <= rb; i++)
+    c.starts[i - lb] = m_sa[i];
+  qsort (c.starts, c.num_starts, sizeof (int), compare_positions);
+  c.benefit = 0;
+  m_candidates.safe_push (c);
+}
+
+/* Find the repeated sequences, which are the LCP intervals of the
+   suffix array.  */
+
+void
+machine_outliner::find_candidates ()
+{
+  /* The open intervals, as pairs of their LCP and left bound.  */
+  auto_vec<std::pair<int, int> > stack;
+  int n = m_sa.length ();
+
+  stack.safe_push (std::make_pair (0, 0));
+  for (int i = 1; i <= n; i++)
+    {
+      int lcp = i < n ? m_lcp[i] : 0;
+      int lb = i - 1;
+      while (lcp < stack.last ().first)
+	{
+	  std::pair<int, int> top = stack.pop ();
+	  add_candidate (top.first, top.second, i - 1);
+	  lb = top.second;
+	}
+      if (lcp > stack.last ().first)
+	stack.safe_push (std::make_pair (lcp, lb));
+    }
+}
+
+/* Choose the occurrences of candidate C to replace, which must not
+   overlap each other or anything already outlined, and store their
+   positions in STARTS.  Return the number of bytes saved, which is
+   negative if outlining C does not pay off.  */
+
+int
+machine_outliner::select_starts (outline_candidate *c, vec<int> *starts)
+{
+  int next = 0;
+
+  starts->truncate (0);
+  for (int i = 0; i < c->num_starts; i++)
+    {
+      int start = c->starts[i];
+      if (start < next || !m_end_ok[start + c->length - 1])
+	continue;
+
+      bool used = false;
+      for (int j = 0; j < c->length && !used; j++)
+	used = m_used[start + j];
+      if (used)
+	continue;
+
+      starts->safe_push (start);
+      next = start + c->length;
+    }
+
+  int count = starts->length ();
+  if (count < 2)
+    return -1;
+
+  int size = 0;
+  for (int j = 0; j < c->length; j++)
+    size += insn_size (m_insns[(*starts)[0] + j]);
+
+  /* Each occurrence becomes a JAL, and the outlined copy ends with a
+     JR, which C.JR can encode.  */
+  return size * (count - 1) - count * 4 - (TARGET_RVC ? 2 : 4);
+}
+
+/* Replace the occurrences of candidate C at STARTS with calls to a
+   single copy.  */
+
+void
+machine_outliner::outline (outline_candidate *c, const vec<int> &starts)
+{
+  rtx_code_label *label = gen_label_rtx ();
+  LABEL_PRESERVE_P (label) = 1;
+
+  /* Put the copy in a block of its own at the end of the function,
+     which has no predecessors since the calls are not jumps.  */
+  rtx_insn *head = emit_label_after (label, get_last_insn ());
+  rtx_insn *last = head;
+  for (int j = 0; j < c->length; j++)
+    {
+      rtx_insn *insn = m_insns[starts[0] + j];
+      last = emit_insn_after_setloc (copy_insn (PATTERN (insn)), last,
+				     INSN_LOCATION (insn));
+    }
+  rtx_jump_insn *ret
+    = emit_jump_insn_after (gen_simple_return_internal (m_t0), last);
+  JUMP_LABEL (ret) = simple_return_rtx;
+  emit_barrier_after (ret);
+
+  basic_block bb = create_basic_block (head, ret,
+				       EXIT_BLOCK_PTR_FOR_FN (cfun)->prev_bb);
+  make_edge (bb, EXIT_BLOCK_PTR_FOR_FN (cfun), 0);
+  bb->count = profile_count::zero ();
+
+  for (unsigned int i = 0; i < starts.length (); i++)
+    {
+      rtx_insn *first = m_insns[starts[i]];
+      rtx pat = (Pmode == DImode
+		 ? gen_outlined_calldi (label)
+		 : gen_outlined_callsi (label));
+      rtx_insn *call = emit_insn_before (pat, first);
+      add_reg_note (call, REG_LABEL_OPERAND, label);
+      LABEL_NUSES (label)++;
+
+      for (int j = 0; j < c->length; j++)
+	{
+	  m_used[starts[i] + j] = true;
+	  delete_insn (m_insns[starts[i] + j]);
+	}
+    }
+
+  if (dump_file)
+    {
+      fprintf (dump_file, "outlined %d insns at", c->length);
+      for (unsigned int i = 0; i < starts.length (); i++)
+	fprintf (dump_file, " %d", INSN_UID (m_insns[starts[i]]));
+      fprintf (dump_file, " into label %d, saving %d bytes\n",
+	       CODE_LABEL_NUMBER (label), c->benefit);
+    }
+}
+
+/* Sort candidates by decreasing benefit.  */
+
+static int
+compare_candidates (const void *pa, const void *pb)
+{
+  const outline_candidate *a = (const outline_candidate *) pa;
+  const outline_candidate *b = (const outline_candidate *) pb;
+
+  if (a->benefit != b->benefit)
+    return a->benefit > b->benefit ? -1 : 1;
+  if (a->length != b->length)
+    return a->length > b->length ? -1 : 1;
+  return a->starts[0] < b->starts[0] ? -1 : 1;
+}
+
+unsigned int
+machine_outliner::execute ()
+{
+  /* JAL must reach the outlined copies, and the last block must not
+     fall through into them.  */
+  int size = 0;
+  for (rtx_insn *insn = get_insns (); insn; insn = NEXT_INSN (insn))
+    if (NONDEBUG_INSN_P (insn))
+      size += get_attr_length (insn);
+  rtx_insn *last = get_last_nonnote_insn ();
+  if (size > max_outline_function_size || !last || !BARRIER_P (last))
+    return 0;
+
+  df_analyze ();
+  build_string ();
+  build_suffix_array ();
+  find_candidates ();
+
+  m_used.safe_grow_cleared (m_str.length (), true);
+
+  auto_vec<int> starts;
+  for (unsigned int i = 0; i < m_candidates.length (); i++)
+    m_candidates[i].benefit = select_starts (&m_candidates[i], &starts);
+  m_candidates.qsort (compare_candidates);
+
+  /* Outlining a candidate can take occurrences from later ones, so
+     recompute their benefit before outlining them.  */
+  for (unsigned int i = 0; i < m_candidates.length (); i++)
+    {
+      outline_candidate *c = &m_candidates[i];
+      if (c->benefit <= 0)
+	break;
+
+      c->benefit = select_starts (c, &starts);
+      if (c->benefit > 0)
+	outline (c, starts);
+    }
+
+  return 0;
+}
+
+const pass_data pass_data_machine_outliner =
+{
+  RTL_PASS, /* type */
+  "machine_outliner", /* name */
+  OPTGROUP_NONE, /* optinfo_flags */
+  TV_NONE, /* tv_id */
+  0, /* properties_required */
+  0, /* properties_provided */
+  0, /* properties_destroyed */
+  0, /* todo_flags_start */
+  TODO_df_finish, /* todo_flags_finish */
+};
+
+class pass_machine_outliner : public rtl_opt_pass
+{
+public:
+  pass_machine_outliner (gcc::context *ctxt)
+    : rtl_opt_pass (pass_data_machine_outliner, ctxt)
+  {}
+
+  /* opt_pass methods: */
+  virtual bool gate (function *fn)
+    {
+      /* Interrupt handlers only save the registers they already use,
+	 and the hot and cold partitions of a function can be too far
+	 apart for JAL.  */
+      return (riscv_mmachine_outline
+	      && optimize > 0
+	      && !crtl->has_bb_partition
+	      && !fixed_regs[T0_REGNUM]
+	      && !global_regs[T0_REGNUM]
+	      && !lookup_attribute ("interrupt",
+				    DECL_ATTRIBUTES (fn->decl))
+	      && !lookup_attribute ("naked", DECL_ATTRIBUTES (fn->decl)));
+    }
+  virtual unsigned int execute (function *)
+    {
+      machine_outliner outliner;
+      return outliner.execute ();
+    }
+}; // class pass_machine_outliner
+
+} // anon namespace
+
+rtl_opt_pass *
+make_pass_machine_outliner (gcc::context *ctxt)
+{
+  return new pass_machine_outliner (ctxt);
+}
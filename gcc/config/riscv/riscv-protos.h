@@ -38,8 +38,11 @@ enum riscv_symbol_type {
 /* Routines implemented in riscv.c.  */
 extern enum riscv_symbol_type riscv_classify_symbolic_expression (rtx);
 extern bool riscv_symbolic_constant_p (rtx, enum riscv_symbol_type *);
+extern bool riscv_plt_call_p (const_rtx);
 extern int riscv_regno_mode_ok_for_base_p (int, machine_mode, bool);
 extern int riscv_address_insns (rtx, machine_mode, bool);
+extern HOST_WIDE_INT riscv_compressed_mem_max_offset (machine_mode);
+extern bool riscv_compressed_mem_address_p (rtx, machine_mode);
 extern int riscv_const_insns (rtx);
 extern int riscv_split_const_insns (rtx);
 extern int riscv_load_store_insns (rtx, rtx_insn *);
@@ -53,7 +56,9 @@ extern rtx riscv_subword (rtx, bool);
 extern bool riscv_split_64bit_move_p (rtx, rtx);
 extern void riscv_split_doubleword_move (rtx, rtx);
 extern const char *riscv_output_move (rtx, rtx);
+extern const char *riscv_output_lazy_fp (rtx, bool);
 extern const char *riscv_output_return ();
+extern const char *riscv_output_casesi (rtx *);
 #ifdef RTX_CODE
 extern void riscv_expand_int_scc (rtx, enum rtx_code, rtx, rtx);
 extern void riscv_expand_float_scc (rtx, enum rtx_code, rtx, rtx);
@@ -61,8 +66,14 @@ extern void riscv_expand_conditional_branch (rtx, enum rtx_code, rtx, rtx);
 extern void riscv_expand_conditional_move (rtx, rtx, rtx, rtx_code, rtx, rtx);
 #endif
 extern rtx riscv_legitimize_call_address (rtx);
+extern rtx_insn *riscv_emit_call_insn (rtx, rtx, bool);
 extern void riscv_set_return_address (rtx, rtx);
 extern bool riscv_expand_block_move (rtx, rtx, rtx);
+extern bool riscv_expand_block_set (rtx, rtx, rtx);
+extern bool riscv_expand_block_compare (rtx, rtx, rtx, rtx);
+extern bool riscv_expand_string_compare (rtx, rtx, rtx, rtx, rtx);
+extern bool riscv_expand_strcmp (rtx, rtx, rtx, rtx);
+extern bool riscv_expand_strlen (rtx, rtx, rtx, rtx);
 extern rtx riscv_return_addr (int, rtx);
 extern HOST_WIDE_INT riscv_initial_elimination_offset (int, int);
 extern void riscv_expand_prologue (void);
@@ -74,6 +85,19 @@ extern bool riscv_expand_block_move (rtx, rtx, rtx);
 extern bool riscv_store_data_bypass_p (rtx_insn *, rtx_insn *);
 extern rtx riscv_gen_gpr_save_insn (struct riscv_frame_info *);
 extern bool riscv_gpr_save_operation_p (rtx);
+extern rtx riscv_gen_gpr_push_insn (struct riscv_frame_info *, HOST_WIDE_INT);
+extern bool riscv_gpr_push_operation_p (rtx);
+extern const char *riscv_output_gpr_push_pop (const char *, rtx, rtx);
+extern bool riscv_vector_mode_p (machine_mode);
+extern bool riscv_const_vec_simm5_p (rtx);
+extern bool riscv_legitimize_vector_move (rtx, rtx);
+extern bool riscv_packed_mode_p (machine_mode);
+extern bool riscv_legitimize_packed_move (rtx, rtx);
+extern void riscv_expand_vector_init (rtx, rtx);
+extern void riscv_subword_address (rtx, rtx *, rtx *, rtx *, rtx *);
+extern rtx riscv_lshift_subword (rtx, rtx);
+extern enum memmodel riscv_union_memmodels (enum memmodel, enum memmodel);
+extern align_flags riscv_loop_align (rtx);
 
 /* Routines implemented in riscv-c.c.  */
 void riscv_cpu_cpp_builtins (cpp_reader *);
@@ -90,11 +114,26 @@ extern void riscv_init_builtins (void);
 
 /* Routines implemented in riscv-common.c.  */
 extern std::string riscv_arch_str (bool version_p = true);
+extern std::string riscv_parse_target_arch (const char *,
+					    struct gcc_options *,
+					    location_t);
 
 extern bool riscv_hard_regno_rename_ok (unsigned, unsigned);
 
 rtl_opt_pass * make_pass_shorten_memrefs (gcc::context *ctxt);
 
+/* Routines implemented in riscv-related-consts.c.  */
+rtl_opt_pass * make_pass_related_consts (gcc::context *ctxt);
+
+/* Routines implemented in riscv-far-jumps.c.  */
+rtl_opt_pass * make_pass_far_jumps (gcc::context *ctxt);
+
+/* Routines implemented in riscv-vsetvl.c.  */
+rtl_opt_pass * make_pass_vsetvl (gcc::context *ctxt);
+
+/* Routines implemented in riscv-outliner.c.  */
+rtl_opt_pass * make_pass_machine_outliner (gcc::context *ctxt);
+
 /* Information about one CPU we know about.  */
 struct riscv_cpu_info {
   /* This CPU's canonical name.  */
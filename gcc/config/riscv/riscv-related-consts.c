@@ -0,0 +1,245 @@
+/* Related constants pass for RISC-V.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#define IN_TARGET_CODE 1
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "tm.h"
+#include "rtl.h"
+#include "backend.h"
+#include "regs.h"
+#include "target.h"
+#include "memmodel.h"
+#include "emit-rtl.h"
+#include "df.h"
+#include "recog.h"
+#include "domwalk.h"
+#include "tree-pass.h"
+#include "tm_p.h"
+
+/* Constants that take more than one instruction to build are often
+   within ADDI range of another constant that is already in a register:
+   consecutive masks, a hash seed and the seed plus a small offset, or
+   the same constant built in both arms of a branch and then again
+   after the join.  CSE only catches identical constants within an
+   extended basic block.  This pass walks the dominator tree, remembers
+   which single-set pseudos hold known integer constants, and rewrites
+   the final instruction of a later constant load to add a 12-bit
+   offset to such a pseudo instead.  The rest of the load sequence is
+   then dead and is deleted.  */
+
+namespace {
+
+/* A pseudo register known to hold VALUE wherever its definition
+   dominates.  */
+
+struct related_const
+{
+  HOST_WIDE_INT value;
+  rtx reg;
+};
+
+/* How many of the most recently seen constants to search for a
+   base.  */
+
+const unsigned int related_const_window = 64;
+
+class related_consts_dom_walker : public dom_walker
+{
+public:
+  related_consts_dom_walker ()
+    : dom_walker (CDI_DOMINATORS), m_changed (false)
+  {}
+
+  virtual edge before_dom_children (basic_block);
+  virtual void after_dom_children (basic_block);
+
+  /* True if any instruction was rewritten.  */
+  bool m_changed;
+
+private:
+  bool derive (rtx_insn *insn, rtx set, HOST_WIDE_INT value);
+
+  /* Constants available in the current block, innermost last.  */
+  auto_vec<related_const> m_avail;
+
+  /* The length of M_AVAIL on entry to each block on the walk.  */
+  auto_vec<unsigned int> m_marks;
+};
+
+/* If INSN sets a word-sized integer register to a known constant,
+   return the SET and store the constant in *VALUE.  */
+
+static rtx
+const_int_set (rtx_insn *insn, HOST_WIDE_INT *value)
+{
+  rtx set = single_set (insn);
+  if (!set
+      || !REG_P (SET_DEST (set))
+      || GET_MODE_CLASS (GET_MODE (SET_DEST (set))) != MODE_INT
+      || GET_MODE_SIZE (GET_MODE (SET_DEST (set))) > UNITS_PER_WORD)
+    return NULL_RTX;
+
+  rtx src = SET_SRC (set);
+  if (!CONST_INT_P (src))
+    {
+      rtx note = find_reg_equal_equiv_note (insn);
+      if (!note || !CONST_INT_P (XEXP (note, 0)))
+	return NULL_RTX;
+      src = XEXP (note, 0);
+    }
+
+  *value = INTVAL (src);
+  return set;
+}
+
+/* Try to rewrite SET, the constant load of VALUE in INSN, as an
+   addition to a register that holds a related constant.  */
+
+bool
+related_consts_dom_walker::derive (rtx_insn *insn, rtx set,
+				   HOST_WIDE_INT value)
+{
+  machine_mode mode = GET_MODE (SET_DEST (set));
+  unsigned int i, stop;
+
+  /* Only constants that take more than one instruction are worth
+     a longer live range for the base.  */
+  if (!splittable_const_int_operand (GEN_INT (value), mode))
+    return false;
+
+  stop = m_avail.length () > related_const_window
+	 ? m_avail.length () - related_const_window : 0;
+  for (i = m_avail.length (); i-- > stop; )
+    {
+      related_const *rc = &m_avail[i];
+      HOST_WIDE_INT offset
+	= (unsigned HOST_WIDE_INT) value - (unsigned HOST_WIDE_INT) rc->value;
+
+      if (GET_MODE (rc->reg) != mode || !SMALL_OPERAND (offset))
+	continue;
+
+      rtx src = offset == 0 ? rc->reg : plus_constant (mode, rc->reg, offset);
+      if (!validate_change (insn, &SET_SRC (set), src, false))
+	continue;
+
+      if (dump_file)
+	fprintf (dump_file, "insn %d: derived " HOST_WIDE_INT_PRINT_HEX
+		 " from r%d + " HOST_WIDE_INT_PRINT_DEC "\n",
+		 INSN_UID (insn), value, REGNO (rc->reg), offset);
+      return true;
+    }
+
+  return false;
+}
+
+edge
+related_consts_dom_walker::before_dom_children (basic_block bb)
+{
+  rtx_insn *insn;
+
+  m_marks.safe_push (m_avail.length ());
+
+  FOR_BB_INSNS (bb, insn)
+    {
+      HOST_WIDE_INT value;
+      rtx set;
+
+      if (!NONDEBUG_INSN_P (insn)
+	  || !(set = const_int_set (insn, &value)))
+	continue;
+
+      if (derive (insn, set, value))
+	m_changed = true;
+
+      /* A pseudo with a single definition holds its value everywhere
+	 that definition dominates.  Small constants are never useful
+	 as a base, since anything within reach of them is small too.  */
+      rtx dest = SET_DEST (set);
+      if (!HARD_REGISTER_P (dest)
+	  && DF_REG_DEF_COUNT (REGNO (dest)) == 1
+	  && !SMALL_OPERAND (value))
+	{
+	  related_const rc = { value, dest };
+	  m_avail.safe_push (rc);
+	}
+    }
+
+  return NULL;
+}
+
+void
+related_consts_dom_walker::after_dom_children (basic_block)
+{
+  m_avail.truncate (m_marks.pop ());
+}
+
+const pass_data pass_data_related_consts =
+{
+  RTL_PASS, /* type */
+  "related_consts", /* name */
+  OPTGROUP_NONE, /* optinfo_flags */
+  TV_NONE, /* tv_id */
+  0, /* properties_required */
+  0, /* properties_provided */
+  0, /* properties_destroyed */
+  0, /* todo_flags_start */
+  0, /* todo_flags_finish */
+};
+
+class pass_related_consts : public rtl_opt_pass
+{
+public:
+  pass_related_consts (gcc::context *ctxt)
+    : rtl_opt_pass (pass_data_related_consts, ctxt)
+  {}
+
+  /* opt_pass methods: */
+  virtual bool gate (function *)
+    {
+      return riscv_mrelated_consts && optimize > 0;
+    }
+  virtual unsigned int execute (function *);
+}; // class pass_related_consts
+
+unsigned int
+pass_related_consts::execute (function *fn)
+{
+  related_consts_dom_walker walker;
+
+  calculate_dominance_info (CDI_DOMINATORS);
+  walker.walk (ENTRY_BLOCK_PTR_FOR_FN (fn));
+  free_dominance_info (CDI_DOMINATORS);
+
+  /* Remove the now unused parts of the original load sequences.  */
+  if (walker.m_changed)
+    delete_trivially_dead_insns (get_insns (), max_reg_num ());
+
+  return 0;
+}
+
+} // anon namespace
+
+rtl_opt_pass *
+make_pass_related_consts (gcc::context *ctxt)
+{
+  return new pass_related_consts (ctxt);
+}
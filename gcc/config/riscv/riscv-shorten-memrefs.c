@@ -32,13 +32,16 @@ along with GCC; see the file COPYING3.  If not see
 #include "df.h"
 #include "predict.h"
 #include "tree-pass.h"
+#include "tm_p.h"
 
 /* Try to make more use of compressed load and store instructions by replacing
    a load/store at address BASE + LARGE_OFFSET with a new load/store at address
    NEW BASE + SMALL OFFSET.  If NEW BASE is stored in a compressed register, the
    load/store can be compressed.  Since creating NEW BASE incurs an overhead,
    the change is only attempted when BASE is referenced by at least four
-   load/stores in the same basic block.  */
+   load/stores in the same basic block.  This applies to every access mode
+   that has a compressed form: words, and doublewords on RV64 or with the
+   D extension.  */
 
 namespace {
 
@@ -75,11 +78,16 @@ private:
 
   regno_map * analyze (basic_block bb);
   void transform (regno_map *m, basic_block bb);
-  bool get_si_mem_base_reg (rtx mem, rtx *addr, bool *extend);
+  bool get_mem_base_reg (rtx mem, rtx *addr, bool *extend);
+  void report_density (function *fn);
 }; // class pass_shorten_memrefs
 
+/* Return true if MEM, possibly sign/zero extended, is a memory access with a
+   compressed form whose address is a register plus an offset.  Store the
+   address in *ADDR and whether MEM was extended in *EXTEND.  */
+
 bool
-pass_shorten_memrefs::get_si_mem_base_reg (rtx mem, rtx *addr, bool *extend)
+pass_shorten_memrefs::get_mem_base_reg (rtx mem, rtx *addr, bool *extend)
 {
   /* Whether it's sign/zero extended.  */
   if (GET_CODE (mem) == ZERO_EXTEND || GET_CODE (mem) == SIGN_EXTEND)
@@ -88,7 +96,7 @@ pass_shorten_memrefs::get_si_mem_base_reg (rtx mem, rtx *addr, bool *extend)
       mem = XEXP (mem, 0);
     }
 
-  if (!MEM_P (mem) || GET_MODE (mem) != SImode)
+  if (!MEM_P (mem) || riscv_compressed_mem_max_offset (GET_MODE (mem)) == 0)
     return false;
   *addr = XEXP (mem, 0);
   return GET_CODE (*addr) == PLUS && REG_P (XEXP (*addr, 0));
@@ -118,7 +126,7 @@ pass_shorten_memrefs::analyze (basic_block bb)
 	  rtx mem = XEXP (pat, i);
 	  rtx addr;
 	  bool extend = false;
-	  if (get_si_mem_base_reg (mem, &addr, &extend))
+	  if (get_mem_base_reg (mem, &addr, &extend))
 	    {
 	      HOST_WIDE_INT regno = REGNO (XEXP (addr, 0));
 	      /* Do not count store zero as these cannot be compressed.  */
@@ -159,7 +167,7 @@ pass_shorten_memrefs::transform (regno_map *m, basic_block bb)
 	  rtx mem = XEXP (pat, i);
 	  rtx addr;
 	  bool extend = false;
-	  if (get_si_mem_base_reg (mem, &addr, &extend))
+	  if (get_mem_base_reg (mem, &addr, &extend))
 	    {
 	      HOST_WIDE_INT regno = REGNO (XEXP (addr, 0));
 	      /* Do not transform store zero as these cannot be compressed.  */
@@ -194,6 +202,44 @@ pass_shorten_memrefs::transform (regno_map *m, basic_block bb)
     }
 }
 
+/* Write to the dump file how many of the loads and stores in FN that have
+   a compressed form now use an address that the compressed form can
+   encode.  Register allocation has not happened yet, so this is an upper
+   bound on the number of compressed loads and stores.  */
+
+void
+pass_shorten_memrefs::report_density (function *fn)
+{
+  basic_block bb;
+  rtx_insn *insn;
+  int total = 0, compressible = 0;
+
+  FOR_EACH_BB_FN (bb, fn)
+    FOR_BB_INSNS (bb, insn)
+      {
+	if (!NONJUMP_INSN_P (insn))
+	  continue;
+	rtx pat = PATTERN (insn);
+	if (GET_CODE (pat) != SET)
+	  continue;
+	for (int i = 0; i < 2; i++)
+	  {
+	    rtx mem = XEXP (pat, i);
+	    if (GET_CODE (mem) == ZERO_EXTEND || GET_CODE (mem) == SIGN_EXTEND)
+	      mem = XEXP (mem, 0);
+	    if (!MEM_P (mem)
+		|| riscv_compressed_mem_max_offset (GET_MODE (mem)) == 0)
+	      continue;
+	    total++;
+	    if (riscv_compressed_mem_address_p (XEXP (mem, 0), GET_MODE (mem)))
+	      compressible++;
+	  }
+      }
+
+  fprintf (dump_file, "\n%s: %d of %d loads/stores have compressible "
+	   "addresses\n", function_name (fn), compressible, total);
+}
+
 unsigned int
 pass_shorten_memrefs::execute (function *fn)
 {
@@ -208,6 +254,9 @@ pass_shorten_memrefs::execute (function *fn)
     transform (m, bb);
   }
 
+  if (dump_file)
+    report_density (fn);
+
   return 0;
 }
 
@@ -0,0 +1,87 @@
+/* VL and VTYPE configuration for the RISC-V V extension.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#define IN_TARGET_CODE 1
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "tm.h"
+#include "rtl.h"
+#include "backend.h"
+#include "target.h"
+#include "context.h"
+#include "pass_manager.h"
+#include "tree-pass.h"
+#include "tm_p.h"
+
+/* Vector instructions do not set VL and VTYPE themselves; their "vsew"
+   attribute says which element width they need, always with VL set to
+   the whole vector.  This pass places the VSETIVLIs that provide those
+   configurations.  Each configuration is a mode of one mode-switching
+   entity (see riscv_mode_needed), so the generic mode-switching code
+   uses lazy code motion over the CFG to place them: a VSETIVLI is
+   omitted when the configuration is already available on every path,
+   and one needed at the top of a loop is hoisted into the preheader when
+   the loop body does not change it.
+
+   The pass runs after register allocation, so that it sees the spill
+   code, and after the last scheduling pass, which has no dependencies
+   between the vector instructions and the VSETIVLIs to respect.  */
+
+namespace {
+
+const pass_data pass_data_vsetvl =
+{
+  RTL_PASS, /* type */
+  "vsetvl", /* name */
+  OPTGROUP_NONE, /* optinfo_flags */
+  TV_MODE_SWITCH, /* tv_id */
+  0, /* properties_required */
+  0, /* properties_provided */
+  0, /* properties_destroyed */
+  0, /* todo_flags_start */
+  TODO_df_finish, /* todo_flags_finish */
+};
+
+class pass_vsetvl : public rtl_opt_pass
+{
+public:
+  pass_vsetvl (gcc::context *ctxt)
+    : rtl_opt_pass (pass_data_vsetvl, ctxt)
+  {}
+
+  /* opt_pass methods: */
+  virtual bool gate (function *)
+    {
+      return TARGET_VECTOR;
+    }
+  virtual unsigned int execute (function *)
+    {
+      return g->get_passes ()->execute_pass_mode_switching ();
+    }
+}; // class pass_vsetvl
+
+} // anon namespace
+
+rtl_opt_pass *
+make_pass_vsetvl (gcc::context *ctxt)
+{
+  return new pass_vsetvl (ctxt);
+}
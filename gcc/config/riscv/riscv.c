@@ -51,11 +51,19 @@ along with GCC; see the file COPYING3.  If not see
 #include "expr.h"
 #include "optabs.h"
 #include "bitmap.h"
+#include "sbitmap.h"
 #include "df.h"
 #include "diagnostic.h"
+#include "opts.h"
 #include "builtins.h"
 #include "predict.h"
 #include "tree-pass.h"
+#include "rtl-iter.h"
+#include "cgraph.h"
+#include "function-abi.h"
+#include "target-globals.h"
+#include "cfgloop.h"
+#include "sched-int.h"
 
 /* True if X is an UNSPEC wrapper around a SYMBOL_REF or LABEL_REF.  */
 #define UNSPEC_ADDRESS_P(X)					\
@@ -146,6 +154,10 @@ struct GTY(())  machine_function {
 
   /* The current frame information, calculated by riscv_compute_frame_info.  */
   struct riscv_frame_info frame;
+
+  /* True if register X is saved and restored by shrink-wrapping rather
+     than by the prologue and epilogue.  */
+  bool reg_is_wrapped_separately[FIRST_PSEUDO_REGISTER];
 };
 
 /* Information about a single argument.  */
@@ -207,12 +219,39 @@ struct riscv_integer_op {
    The worst case is LUI, ADDI, SLLI, ADDI, SLLI, ADDI, SLLI, ADDI.  */
 #define RISCV_MAX_INTEGER_OPS 8
 
+/* Pairs of adjacent instructions that a core may fuse into a single
+   macro-op.  */
+
+enum riscv_fusion_pairs
+{
+  RISCV_FUSE_NOTHING = 0,
+  /* slli rd, rs, 32; srli rd, rd, 32 (zero-extend a word).  */
+  RISCV_FUSE_ZEXTW = (1 << 0),
+  /* slli rd, rs, XLEN - 16; srli rd, rd, XLEN - 16 (zero-extend a
+     halfword).  */
+  RISCV_FUSE_ZEXTH = (1 << 1),
+  /* slli rd, rs, 32; srli rd, rd, N with N < 32 (shifted zero-extend of
+     a word).  */
+  RISCV_FUSE_ZEXTWS = (1 << 2),
+  /* add rd, rs1, rs2; l* rd2, 0(rd).  */
+  RISCV_FUSE_LDINDEXED = (1 << 3),
+  /* lui rd, %hi(sym); addi rd, rd, %lo(sym).  */
+  RISCV_FUSE_LUI_ADDI = (1 << 4),
+  /* auipc rd, %pcrel_hi(sym); addi rd, rd, %pcrel_lo(sym).  */
+  RISCV_FUSE_AUIPC_ADDI = (1 << 5),
+  /* lui rd, %hi(sym); l* rd2, %lo(sym)(rd).  */
+  RISCV_FUSE_LUI_LD = (1 << 6),
+  /* auipc rd, %pcrel_hi(sym); l* rd2, %pcrel_lo(sym)(rd).  */
+  RISCV_FUSE_AUIPC_LD = (1 << 7)
+};
+
 /* Costs of various operations on the different architectures.  */
 
 struct riscv_tune_param
 {
   unsigned short fp_add[2];
   unsigned short fp_mul[2];
+  unsigned short fp_fma[2];
   unsigned short fp_div[2];
   unsigned short int_mul[2];
   unsigned short int_div[2];
@@ -220,6 +259,46 @@ struct riscv_tune_param
   unsigned short branch_cost;
   unsigned short memory_cost;
   bool slow_unaligned_access;
+  unsigned int fusible_ops;
+
+  /* Cache parameters for software prefetching; zero leaves the generic
+     default alone.  Cache sizes are in kilobytes and the line size in
+     bytes.  */
+  unsigned short simultaneous_prefetches;
+  unsigned short l1_cache_size;
+  unsigned short l1_cache_line_size;
+  unsigned short l2_cache_size;
+
+  /* The optimization level from which to enable -fprefetch-loop-arrays
+     when Zicbop is available, or -1 to leave it off.  */
+  short prefetch_opt_level;
+
+  /* The size in bytes of an instruction fetch block.  Functions, loops
+     and jump targets in hot code are aligned to it by default; zero
+     leaves the generic alignment alone.  */
+  unsigned short fetch_block_size;
+
+  /* The number of words of two word-aligned strings that strcmp and
+     strncmp compare inline with Zbb, before calling strcmp for the
+     rest; zero keeps them out of line.  */
+  unsigned short strcmp_inline_words;
+
+  /* The largest factor by which the RTL unroller may unroll a loop, or
+     zero for no limit beyond the generic parameters.  */
+  unsigned short max_unroll_times;
+
+  /* The size in bytes of the loop buffer.  A loop that fits in it is
+     only unrolled as far as it still fits; zero if there is none.  */
+  unsigned short loop_buffer_size;
+
+  /* The number of independent integer and floating-point operations
+     of a reassociated chain that the core can keep in flight.  */
+  unsigned short int_reassoc_width;
+  unsigned short fp_reassoc_width;
+
+  /* The -fsched-pressure algorithm to use by default, as for
+     --param sched-pressure-algorithm, or zero to leave it off.  */
+  unsigned short sched_pressure;
 };
 
 /* Information about one micro-arch we know about.  */
@@ -271,13 +350,22 @@ const enum reg_class riscv_regno_to_class[FIRST_PSEUDO_REGISTER] = {
   FP_REGS,	FP_REGS,	FP_REGS,	FP_REGS,
   FP_REGS,	FP_REGS,	FP_REGS,	FP_REGS,
   FP_REGS,	FP_REGS,	FP_REGS,	FP_REGS,
-  FRAME_REGS,	FRAME_REGS,
+  FRAME_REGS,	FRAME_REGS,	V_REGS,		V_REGS,
+  V_REGS,	V_REGS,		V_REGS,		V_REGS,
+  V_REGS,	V_REGS,		V_REGS,		V_REGS,
+  V_REGS,	V_REGS,		V_REGS,		V_REGS,
+  V_REGS,	V_REGS,		V_REGS,		V_REGS,
+  V_REGS,	V_REGS,		V_REGS,		V_REGS,
+  V_REGS,	V_REGS,		V_REGS,		V_REGS,
+  V_REGS,	V_REGS,		V_REGS,		V_REGS,
+  V_REGS,	V_REGS,
 };
 
 /* Costs to use when optimizing for rocket.  */
 static const struct riscv_tune_param rocket_tune_info = {
   {COSTS_N_INSNS (4), COSTS_N_INSNS (5)},	/* fp_add */
   {COSTS_N_INSNS (4), COSTS_N_INSNS (5)},	/* fp_mul */
+  {COSTS_N_INSNS (4), COSTS_N_INSNS (5)},	/* fp_fma */
   {COSTS_N_INSNS (20), COSTS_N_INSNS (20)},	/* fp_div */
   {COSTS_N_INSNS (4), COSTS_N_INSNS (4)},	/* int_mul */
   {COSTS_N_INSNS (6), COSTS_N_INSNS (6)},	/* int_div */
@@ -285,12 +373,26 @@ static const struct riscv_tune_param rocket_tune_info = {
   3,						/* branch_cost */
   5,						/* memory_cost */
   true,						/* slow_unaligned_access */
+  RISCV_FUSE_NOTHING,				/* fusible_ops */
+  0,						/* simultaneous_prefetches */
+  0,						/* l1_cache_size */
+  0,						/* l1_cache_line_size */
+  0,						/* l2_cache_size */
+  -1,						/* prefetch_opt_level */
+  0,						/* fetch_block_size */
+  2,						/* strcmp_inline_words */
+  2,						/* max_unroll_times */
+  0,						/* loop_buffer_size */
+  1,						/* int_reassoc_width */
+  2,						/* fp_reassoc_width */
+  2,						/* sched_pressure */
 };
 
 /* Costs to use when optimizing for Sifive 7 Series.  */
 static const struct riscv_tune_param sifive_7_tune_info = {
   {COSTS_N_INSNS (4), COSTS_N_INSNS (5)},	/* fp_add */
   {COSTS_N_INSNS (4), COSTS_N_INSNS (5)},	/* fp_mul */
+  {COSTS_N_INSNS (4), COSTS_N_INSNS (5)},	/* fp_fma */
   {COSTS_N_INSNS (20), COSTS_N_INSNS (20)},	/* fp_div */
   {COSTS_N_INSNS (4), COSTS_N_INSNS (4)},	/* int_mul */
   {COSTS_N_INSNS (6), COSTS_N_INSNS (6)},	/* int_div */
@@ -298,12 +400,54 @@ static const struct riscv_tune_param sifive_7_tune_info = {
   4,						/* branch_cost */
   3,						/* memory_cost */
   true,						/* slow_unaligned_access */
+  RISCV_FUSE_NOTHING,				/* fusible_ops */
+  2,						/* simultaneous_prefetches */
+  32,						/* l1_cache_size */
+  64,						/* l1_cache_line_size */
+  2048,						/* l2_cache_size */
+  -1,						/* prefetch_opt_level */
+  8,						/* fetch_block_size */
+  4,						/* strcmp_inline_words */
+  4,						/* max_unroll_times */
+  0,						/* loop_buffer_size */
+  2,						/* int_reassoc_width */
+  4,						/* fp_reassoc_width */
+  2,						/* sched_pressure */
+};
+
+/* Costs to use when optimizing for a generic out-of-order core.  */
+static const struct riscv_tune_param generic_ooo_tune_info = {
+  {COSTS_N_INSNS (4), COSTS_N_INSNS (4)},	/* fp_add */
+  {COSTS_N_INSNS (4), COSTS_N_INSNS (4)},	/* fp_mul */
+  {COSTS_N_INSNS (4), COSTS_N_INSNS (4)},	/* fp_fma */
+  {COSTS_N_INSNS (10), COSTS_N_INSNS (15)},	/* fp_div */
+  {COSTS_N_INSNS (3), COSTS_N_INSNS (3)},	/* int_mul */
+  {COSTS_N_INSNS (12), COSTS_N_INSNS (20)},	/* int_div */
+  4,						/* issue_rate */
+  4,						/* branch_cost */
+  4,						/* memory_cost */
+  false,					/* slow_unaligned_access */
+  RISCV_FUSE_ZEXTW | RISCV_FUSE_ZEXTH
+  | RISCV_FUSE_LUI_ADDI | RISCV_FUSE_AUIPC_ADDI,	/* fusible_ops */
+  4,						/* simultaneous_prefetches */
+  32,						/* l1_cache_size */
+  64,						/* l1_cache_line_size */
+  1024,						/* l2_cache_size */
+  3,						/* prefetch_opt_level */
+  16,						/* fetch_block_size */
+  4,						/* strcmp_inline_words */
+  0,						/* max_unroll_times */
+  0,						/* loop_buffer_size */
+  4,						/* int_reassoc_width */
+  4,						/* fp_reassoc_width */
+  0,						/* sched_pressure */
 };
 
 /* Costs to use when optimizing for size.  */
 static const struct riscv_tune_param optimize_size_tune_info = {
   {COSTS_N_INSNS (1), COSTS_N_INSNS (1)},	/* fp_add */
   {COSTS_N_INSNS (1), COSTS_N_INSNS (1)},	/* fp_mul */
+  {COSTS_N_INSNS (1), COSTS_N_INSNS (1)},	/* fp_fma */
   {COSTS_N_INSNS (1), COSTS_N_INSNS (1)},	/* fp_div */
   {COSTS_N_INSNS (1), COSTS_N_INSNS (1)},	/* int_mul */
   {COSTS_N_INSNS (1), COSTS_N_INSNS (1)},	/* int_div */
@@ -311,6 +455,19 @@ static const struct riscv_tune_param optimize_size_tune_info = {
   1,						/* branch_cost */
   2,						/* memory_cost */
   false,					/* slow_unaligned_access */
+  RISCV_FUSE_NOTHING,				/* fusible_ops */
+  0,						/* simultaneous_prefetches */
+  0,						/* l1_cache_size */
+  0,						/* l1_cache_line_size */
+  0,						/* l2_cache_size */
+  -1,						/* prefetch_opt_level */
+  0,						/* fetch_block_size */
+  0,						/* strcmp_inline_words */
+  0,						/* max_unroll_times */
+  0,						/* loop_buffer_size */
+  1,						/* int_reassoc_width */
+  1,						/* fp_reassoc_width */
+  0,						/* sched_pressure */
 };
 
 static tree riscv_handle_fndecl_attribute (tree *, tree, tree, int, bool *);
@@ -348,6 +505,7 @@ static const struct riscv_tune_info riscv_tune_info_table[] = {
   { "sifive-3-series", generic, &rocket_tune_info },
   { "sifive-5-series", generic, &rocket_tune_info },
   { "sifive-7-series", sifive_7, &sifive_7_tune_info },
+  { "generic-ooo", generic_ooo, &generic_ooo_tune_info },
   { "size", generic, &optimize_size_tune_info },
 };
 
@@ -369,6 +527,209 @@ riscv_parse_tune (const char *tune_string)
   return riscv_tune_info_table;
 }
 
+/* Tuning parameters read from the file given by -mtune-file=.  */
+static struct riscv_tune_param riscv_tune_file_param;
+
+/* One field of riscv_tune_param that may be set from a tuning file.  */
+struct riscv_tune_file_key {
+  /* The key as it appears in the file.  */
+  const char *name;
+
+  /* The field it sets.  */
+  unsigned short *field;
+
+  /* True if the value is a latency in instructions, false if it is stored
+     verbatim.  */
+  bool insns_p;
+};
+
+/* Parse the value VALUE for key NAME at FILENAME:LINENO into *RESULT.
+   Return true on success.  */
+
+static bool
+riscv_parse_tune_file_value (const char *filename, int lineno,
+			     const char *name, const char *value,
+			     unsigned HOST_WIDE_INT *result)
+{
+  char *end;
+
+  errno = 0;
+  *result = strtoul (value, &end, 0);
+  if (end == value || *end != '\0' || errno != 0 || *result > 0xffff)
+    {
+      error ("%s:%d: invalid value %qs for tuning parameter %qs",
+	     filename, lineno, value, name);
+      return false;
+    }
+  return true;
+}
+
+/* Return the start of S without leading or trailing whitespace,
+   modifying S in place.  */
+
+static char *
+riscv_strip_whitespace (char *s)
+{
+  while (ISSPACE (*s))
+    s++;
+
+  char *end = s + strlen (s);
+  while (end > s && ISSPACE (end[-1]))
+    end--;
+  *end = '\0';
+
+  return s;
+}
+
+/* Names of the riscv_fusion_pairs bits, as used by tuning files.  */
+static const struct {
+  const char *name;
+  unsigned int mask;
+} riscv_fusion_names[] = {
+  { "zextw", RISCV_FUSE_ZEXTW },
+  { "zexth", RISCV_FUSE_ZEXTH },
+  { "zextws", RISCV_FUSE_ZEXTWS },
+  { "ldindexed", RISCV_FUSE_LDINDEXED },
+  { "lui_addi", RISCV_FUSE_LUI_ADDI },
+  { "auipc_addi", RISCV_FUSE_AUIPC_ADDI },
+  { "lui_ld", RISCV_FUSE_LUI_LD },
+  { "auipc_ld", RISCV_FUSE_AUIPC_LD },
+};
+
+/* Parse VALUE, a comma-separated list of fusion pair names or "none",
+   at FILENAME:LINENO into *RESULT.  */
+
+static void
+riscv_parse_tune_file_fusion (const char *filename, int lineno,
+			      char *value, unsigned int *result)
+{
+  *result = RISCV_FUSE_NOTHING;
+  for (char *tok = strtok (value, ","); tok; tok = strtok (NULL, ","))
+    {
+      tok = riscv_strip_whitespace (tok);
+      if (strcmp (tok, "none") == 0)
+	continue;
+
+      unsigned i;
+      for (i = 0; i < ARRAY_SIZE (riscv_fusion_names); i++)
+	if (strcmp (riscv_fusion_names[i].name, tok) == 0)
+	  {
+	    *result |= riscv_fusion_names[i].mask;
+	    break;
+	  }
+      if (i == ARRAY_SIZE (riscv_fusion_names))
+	error ("%s:%d: unknown fusion pair %qs", filename, lineno, tok);
+    }
+}
+
+/* Read tuning parameters from FILENAME, starting from BASE, and return
+   the result.  The file consists of "KEY = VALUE" lines; blank lines and
+   text following a '#' are ignored.  Operation latencies are given in
+   instructions, "fusion" takes a comma-separated list of fusion pair
+   names and the other values are used as-is.  */
+
+static const struct riscv_tune_param *
+riscv_read_tune_file (const char *filename,
+		      const struct riscv_tune_param *base)
+{
+  struct riscv_tune_param *param = &riscv_tune_file_param;
+  *param = *base;
+
+  const struct riscv_tune_file_key keys[] = {
+    { "fp_add_sf", &param->fp_add[0], true },
+    { "fp_add_df", &param->fp_add[1], true },
+    { "fp_mul_sf", &param->fp_mul[0], true },
+    { "fp_mul_df", &param->fp_mul[1], true },
+    { "fp_fma_sf", &param->fp_fma[0], true },
+    { "fp_fma_df", &param->fp_fma[1], true },
+    { "fp_div_sf", &param->fp_div[0], true },
+    { "fp_div_df", &param->fp_div[1], true },
+    { "int_mul_si", &param->int_mul[0], true },
+    { "int_mul_di", &param->int_mul[1], true },
+    { "int_div_si", &param->int_div[0], true },
+    { "int_div_di", &param->int_div[1], true },
+    { "issue_rate", &param->issue_rate, false },
+    { "branch_cost", &param->branch_cost, false },
+    { "memory_cost", &param->memory_cost, false },
+    { "simultaneous_prefetches", &param->simultaneous_prefetches, false },
+    { "l1_cache_size", &param->l1_cache_size, false },
+    { "l1_cache_line_size", &param->l1_cache_line_size, false },
+    { "l2_cache_size", &param->l2_cache_size, false },
+    { "fetch_block_size", &param->fetch_block_size, false },
+    { "strcmp_inline_words", &param->strcmp_inline_words, false },
+    { "max_unroll_times", &param->max_unroll_times, false },
+    { "loop_buffer_size", &param->loop_buffer_size, false },
+    { "int_reassoc_width", &param->int_reassoc_width, false },
+    { "fp_reassoc_width", &param->fp_reassoc_width, false },
+    { "sched_pressure", &param->sched_pressure, false },
+  };
+
+  FILE *file = fopen (filename, "r");
+  if (!file)
+    {
+      error ("cannot open tuning file %qs: %m", filename);
+      return base;
+    }
+
+  char buf[256];
+  int lineno = 0;
+  while (fgets (buf, sizeof (buf), file))
+    {
+      lineno++;
+
+      char *comment = strchr (buf, '#');
+      if (comment)
+	*comment = '\0';
+
+      char *line = riscv_strip_whitespace (buf);
+      if (*line == '\0')
+	continue;
+
+      char *eq = strchr (line, '=');
+      if (!eq)
+	{
+	  error ("%s:%d: expected %<KEY = VALUE%>", filename, lineno);
+	  continue;
+	}
+      *eq = '\0';
+      char *name = riscv_strip_whitespace (line);
+      char *value = riscv_strip_whitespace (eq + 1);
+
+      unsigned HOST_WIDE_INT n;
+      if (strcmp (name, "fusion") == 0)
+	{
+	  riscv_parse_tune_file_fusion (filename, lineno, value,
+					&param->fusible_ops);
+	  continue;
+	}
+      if (strcmp (name, "slow_unaligned_access") == 0)
+	{
+	  if (strcmp (value, "true") == 0)
+	    param->slow_unaligned_access = true;
+	  else if (strcmp (value, "false") == 0)
+	    param->slow_unaligned_access = false;
+	  else if (riscv_parse_tune_file_value (filename, lineno, name,
+						value, &n))
+	    param->slow_unaligned_access = n != 0;
+	  continue;
+	}
+
+      unsigned i;
+      for (i = 0; i < ARRAY_SIZE (keys); i++)
+	if (strcmp (keys[i].name, name) == 0)
+	  break;
+
+      if (i == ARRAY_SIZE (keys))
+	error ("%s:%d: unknown tuning parameter %qs", filename, lineno, name);
+      else if (riscv_parse_tune_file_value (filename, lineno, name, value,
+					    &n))
+	*keys[i].field = keys[i].insns_p ? COSTS_N_INSNS (n) : n;
+    }
+
+  fclose (file);
+  return param;
+}
+
 /* Helper function for riscv_build_integer; arguments are as for
    riscv_build_integer.  */
 
@@ -388,6 +749,14 @@ riscv_build_integer_1 (struct riscv_integer_op codes[RISCV_MAX_INTEGER_OPS],
       return 1;
     }
 
+  if (TARGET_ZBS && SINGLE_BIT_MASK_OPERAND (value))
+    {
+      /* Simply BSETI from the zero register.  */
+      codes[0].code = UNKNOWN;
+      codes[0].value = value;
+      return 1;
+    }
+
   /* End with ADDI.  When constructing HImode constants, do not generate any
      intermediate value that is not itself a valid HImode constant.  The
      XORI case below will handle those remaining HImode constants.  */
@@ -452,6 +821,80 @@ riscv_build_integer (struct riscv_integer_op *codes, HOST_WIDE_INT value,
 {
   int cost = riscv_build_integer_1 (codes, value, mode);
 
+  /* Build the low 31 bits, sign-extended, and then set or clear each
+     of the upper bits that differ with BSETI or BCLRI.  This suits
+     sparse masks and constants such as the 64-bit FNV prime.  */
+  if (TARGET_ZBS && TARGET_64BIT && cost > 2 && mode != HImode)
+    {
+      struct riscv_integer_op alt_codes[RISCV_MAX_INTEGER_OPS];
+      unsigned HOST_WIDE_INT upper = value & ~(HOST_WIDE_INT) 0x7fffffff;
+      HOST_WIDE_INT base;
+      enum rtx_code code;
+      int alt_cost, i, bit;
+
+      if (value >= 0)
+	{
+	  base = value & 0x7fffffff;
+	  code = IOR;
+	}
+      else
+	{
+	  base = value | ~(HOST_WIDE_INT) 0x7fffffff;
+	  upper = ~upper & ~(HOST_WIDE_INT) 0x7fffffff;
+	  code = AND;
+	}
+
+      /* With nothing below bit 31, the first bit can come straight
+	 from BSETI.  */
+      if (code == IOR && base == 0)
+	{
+	  base = upper & -upper;
+	  upper ^= base;
+	}
+
+      alt_cost = popcount_hwi (upper)
+		 + riscv_build_integer_1 (alt_codes, base, mode);
+      if (alt_cost < cost)
+	{
+	  i = alt_cost - popcount_hwi (upper);
+	  for (bit = 31; bit < HOST_BITS_PER_WIDE_INT; bit++)
+	    if (upper & (HOST_WIDE_INT_1U << bit))
+	      {
+		alt_codes[i].code = code;
+		alt_codes[i].value = (code == IOR
+				      ? HOST_WIDE_INT_1U << bit
+				      : ~(HOST_WIDE_INT_1U << bit));
+		i++;
+	      }
+	  memcpy (codes, alt_codes, sizeof (alt_codes));
+	  cost = alt_cost;
+	}
+    }
+
+  /* A rotated ADDI immediate, such as a run of up to 11 zeros in an
+     otherwise all-ones value, takes LI and RORI.  */
+  if ((TARGET_ZBB || TARGET_ZBKB) && TARGET_64BIT && cost > 2
+      && mode != HImode)
+    {
+      unsigned HOST_WIDE_INT x = value;
+      int rot;
+
+      for (rot = 1; rot < HOST_BITS_PER_WIDE_INT; rot++)
+	{
+	  HOST_WIDE_INT rotated
+	    = (x << rot) | (x >> (HOST_BITS_PER_WIDE_INT - rot));
+	  if (SMALL_OPERAND (rotated))
+	    {
+	      codes[0].code = UNKNOWN;
+	      codes[0].value = rotated;
+	      codes[1].code = ROTATERT;
+	      codes[1].value = rot;
+	      cost = 2;
+	      break;
+	    }
+	}
+    }
+
   /* Eliminate leading zeros and end with SRLI.  */
   if (value > 0 && cost > 2)
     {
@@ -513,6 +956,18 @@ riscv_integer_cost (HOST_WIDE_INT val)
 	      riscv_split_integer_cost (val));
 }
 
+/* Return true if loading VAL from the constant pool is cheaper than
+   synthesizing it.  */
+
+static bool
+riscv_integer_pool_p (HOST_WIDE_INT val)
+{
+  /* LUI or AUIPC for the address, then the load itself.  */
+  int pool_cost = 2 + tune_param->memory_cost;
+
+  return TARGET_64BIT && riscv_integer_cost (val) > pool_cost;
+}
+
 /* Try to split a 64b integer into 32b parts, then reassemble.  */
 
 static rtx
@@ -567,6 +1022,25 @@ riscv_classify_symbol (const_rtx x)
   return riscv_cmodel == CM_MEDLOW ? SYMBOL_ABSOLUTE : SYMBOL_PCREL;
 }
 
+/* Return true if a call to X, which is accessed through the GOT, may go
+   through the PLT.  With -fno-plt, -mno-plt or the noplt attribute, the
+   caller instead loads the address from the GOT itself and calls it
+   with JALR, which avoids the PLT stub and lazy binding.  */
+
+bool
+riscv_plt_call_p (const_rtx x)
+{
+  if (!TARGET_PLT || !flag_plt)
+    return false;
+
+  if (SYMBOL_REF_P (x)
+      && SYMBOL_REF_DECL (x)
+      && lookup_attribute ("noplt", DECL_ATTRIBUTES (SYMBOL_REF_DECL (x))))
+    return false;
+
+  return true;
+}
+
 /* Classify the base of symbolic expression X.  */
 
 enum riscv_symbol_type
@@ -807,6 +1281,12 @@ static bool
 riscv_classify_address (struct riscv_address_info *info, rtx x,
 			machine_mode mode, bool strict_p)
 {
+  /* Vector loads and stores only accept a base register.  */
+  if (riscv_vector_mode_p (mode)
+      && GET_CODE (x) != REG
+      && GET_CODE (x) != SUBREG)
+    return false;
+
   switch (GET_CODE (x))
     {
     case REG:
@@ -872,21 +1352,52 @@ riscv_compressed_reg_p (int regno)
 	  || IN_RANGE (regno, FP_REG_FIRST + 8, FP_REG_FIRST + 15)));
 }
 
-/* Return true if x is an unsigned 5-bit immediate scaled by 4.  */
+/* Return the largest offset that a compressed load or store of mode MODE
+   can encode, or 0 if accesses of mode MODE have no compressed form.  */
+
+HOST_WIDE_INT
+riscv_compressed_mem_max_offset (machine_mode mode)
+{
+  if (!TARGET_RVC)
+    return 0;
+
+  switch (mode)
+    {
+    case E_SImode:
+      return CSW_MAX_OFFSET;
+    case E_DImode:
+      return TARGET_64BIT ? CSD_MAX_OFFSET : 0;
+    case E_SFmode:
+      /* C.FLW and C.FSW exist only for RV32.  */
+      return !TARGET_64BIT && TARGET_HARD_FLOAT ? CSW_MAX_OFFSET : 0;
+    case E_DFmode:
+      return TARGET_DOUBLE_FLOAT ? CSD_MAX_OFFSET : 0;
+    default:
+      return 0;
+    }
+}
+
+/* Return true if X is an offset that a compressed load or store of
+   mode MODE can encode: an unsigned 5-bit immediate scaled by the access
+   size.  */
 
 static bool
-riscv_compressed_lw_offset_p (rtx x)
+riscv_compressed_mem_offset_p (rtx x, machine_mode mode)
 {
   return (CONST_INT_P (x)
-	  && (INTVAL (x) & 3) == 0
-	  && IN_RANGE (INTVAL (x), 0, CSW_MAX_OFFSET));
+	  && (INTVAL (x) & (GET_MODE_SIZE (mode) - 1)) == 0
+	  && IN_RANGE (INTVAL (x), 0, riscv_compressed_mem_max_offset (mode)));
 }
 
-/* Return true if load/store from/to address x can be compressed.  */
+/* Return true if a load/store of mode MODE from/to address X can be
+   compressed.  */
 
-static bool
-riscv_compressed_lw_address_p (rtx x)
+bool
+riscv_compressed_mem_address_p (rtx x, machine_mode mode)
 {
+  if (riscv_compressed_mem_max_offset (mode) == 0)
+    return false;
+
   struct riscv_address_info addr;
   bool result = riscv_classify_address (&addr, x, GET_MODE (x),
 					reload_completed);
@@ -898,7 +1409,7 @@ riscv_compressed_lw_address_p (rtx x)
       || (reload_completed
 	  && !riscv_compressed_reg_p (REGNO (addr.reg))
 	  && addr.reg != stack_pointer_rtx)
-      || !riscv_compressed_lw_offset_p (addr.offset))
+      || !riscv_compressed_mem_offset_p (addr.offset, mode))
     return false;
 
   return result;
@@ -963,10 +1474,20 @@ riscv_const_insns (rtx x)
       }
 
     case CONST_DOUBLE:
-    case CONST_VECTOR:
       /* We can use x0 to load floating-point zero.  */
       return x == CONST0_RTX (GET_MODE (x)) ? 1 : 0;
 
+    case CONST_VECTOR:
+      /* Vector constants that splat a 5-bit signed immediate can be
+	 loaded with VMV.V.I.  */
+      if (riscv_vector_mode_p (GET_MODE (x)))
+	return riscv_const_vec_simm5_p (x) ? 1 : 0;
+      /* Packed-SIMD constants are loaded like the equivalent integer.  */
+      if (riscv_packed_mode_p (GET_MODE (x)))
+	return riscv_const_insns (simplify_subreg (SImode, x,
+						   GET_MODE (x), 0));
+      return x == CONST0_RTX (GET_MODE (x)) ? 1 : 0;
+
     case CONST:
       /* See if we can refer to X directly.  */
       if (riscv_symbolic_constant_p (x, &symbol_type))
@@ -1173,6 +1694,17 @@ static rtx riscv_got_load_tls_ie (rtx dest, rtx sym)
     return gen_got_load_tls_iesi (dest, sym);
 }
 
+/* Resolve SYM through its TLS descriptor, leaving the tp-relative
+   offset in a0.  SEQNO numbers the label of the access.  */
+
+static rtx riscv_tlsdesc (rtx sym, rtx seqno)
+{
+  if (Pmode == DImode)
+    return gen_tlsdescdi (sym, seqno);
+  else
+    return gen_tlsdescsi (sym, seqno);
+}
+
 /* Add in the thread pointer for a TLS LE access.  */
 
 static rtx riscv_tls_add_tp_le (rtx dest, rtx base, rtx sym)
@@ -1335,9 +1867,25 @@ riscv_legitimize_tls_address (rtx loc)
       /* Rely on section anchors for the optimization that LDM TLS
 	 provides.  The anchor's address is loaded with GD TLS. */
     case TLS_MODEL_GLOBAL_DYNAMIC:
-      tmp = gen_rtx_REG (Pmode, GP_RETURN);
-      dest = gen_reg_rtx (Pmode);
-      emit_libcall_block (riscv_call_tls_get_addr (loc, tmp), dest, tmp, loc);
+      if (TARGET_TLSDESC)
+	{
+	  /* The descriptor call preserves everything but a0 and t0, so
+	     it is not a call as far as the rest of the compiler cares.  */
+	  static unsigned seqno;
+	  tp = gen_rtx_REG (Pmode, THREAD_POINTER_REGNUM);
+	  tmp = gen_rtx_REG (Pmode, GP_ARG_FIRST);
+	  emit_insn (riscv_tlsdesc (loc, GEN_INT (seqno)));
+	  dest = gen_reg_rtx (Pmode);
+	  emit_insn (gen_add3_insn (dest, tmp, tp));
+	  seqno++;
+	}
+      else
+	{
+	  tmp = gen_rtx_REG (Pmode, GP_RETURN);
+	  dest = gen_reg_rtx (Pmode);
+	  emit_libcall_block (riscv_call_tls_get_addr (loc, tmp), dest, tmp,
+			      loc);
+	}
       break;
 
     case TLS_MODEL_INITIAL_EXEC:
@@ -1374,16 +1922,17 @@ riscv_force_address (rtx x, machine_mode mode)
 }
 
 /* Modify base + offset so that offset fits within a compressed load/store insn
-   and the excess is added to base.  */
+   of mode MODE and the excess is added to base.  */
 
 static rtx
-riscv_shorten_lw_offset (rtx base, HOST_WIDE_INT offset)
+riscv_shorten_mem_offset (rtx base, HOST_WIDE_INT offset, machine_mode mode)
 {
   rtx addr, high;
-  /* Leave OFFSET as an unsigned 5-bit offset scaled by 4 and put the excess
-     into HIGH.  */
-  high = GEN_INT (offset & ~CSW_MAX_OFFSET);
-  offset &= CSW_MAX_OFFSET;
+  HOST_WIDE_INT max_offset = riscv_compressed_mem_max_offset (mode);
+  /* Leave OFFSET as an unsigned 5-bit offset scaled by the access size and
+     put the excess into HIGH.  */
+  high = GEN_INT (offset & ~max_offset);
+  offset &= max_offset;
   if (!SMALL_OPERAND (INTVAL (high)))
     high = force_reg (Pmode, high);
   base = force_reg (Pmode, gen_rtx_PLUS (Pmode, high, base));
@@ -1420,10 +1969,10 @@ riscv_legitimize_address (rtx x, rtx oldx ATTRIBUTE_UNUSED,
 	base = copy_to_mode_reg (Pmode, base);
       if (optimize_function_for_size_p (cfun)
 	  && (strcmp (current_pass->name, "shorten_memrefs") == 0)
-	  && mode == SImode)
+	  && riscv_compressed_mem_max_offset (mode) != 0)
 	/* Convert BASE + LARGE_OFFSET into NEW_BASE + SMALL_OFFSET to allow
 	   possible compressed load/store.  */
-	addr = riscv_shorten_lw_offset (base, offset);
+	addr = riscv_shorten_mem_offset (base, offset, mode);
       else
 	addr = riscv_add_offset (NULL, base, offset);
       return riscv_force_address (addr, mode);
@@ -1454,8 +2003,16 @@ riscv_move_integer (rtx temp, rtx dest, HOST_WIDE_INT value,
      values are given special treatment.  */
   num_ops = riscv_build_integer (codes, value, orig_mode);
 
-  if (can_create_pseudo && num_ops > 2 /* not a simple constant */
-      && num_ops >= riscv_split_integer_cost (value))
+  if (can_create_pseudo && num_ops > 2 && riscv_integer_pool_p (value))
+    {
+      /* Load constants that take too long to build from the constant
+	 pool.  When using explicit relocs, constant pool references are
+	 sometimes not legitimate addresses.  */
+      x = force_const_mem (mode, GEN_INT (value));
+      riscv_split_symbol (temp, XEXP (x, 0), mode, &XEXP (x, 0), FALSE);
+    }
+  else if (can_create_pseudo && num_ops > 2 /* not a simple constant */
+	   && num_ops >= riscv_split_integer_cost (value))
     x = riscv_split_integer (value, mode);
   else
     {
@@ -1527,6 +2084,152 @@ riscv_legitimize_const_move (machine_mode mode, rtx dest, rtx src)
   riscv_emit_move (dest, src);
 }
 
+/* Return true if MODE is a vector mode supported by the V extension.  */
+
+bool
+riscv_vector_mode_p (machine_mode mode)
+{
+  if (!TARGET_VECTOR)
+    return false;
+
+  switch (mode)
+    {
+    case E_V16QImode:
+    case E_V8HImode:
+    case E_V4SImode:
+    case E_V2DImode:
+      return true;
+
+    case E_V4SFmode:
+      return TARGET_HARD_FLOAT;
+
+    case E_V2DFmode:
+      return TARGET_DOUBLE_FLOAT;
+
+    default:
+      return false;
+    }
+}
+
+/* Return true if MODE is a packed-SIMD mode supported by the P extension.
+   These modes hold a whole vector in a single GPR, so they are only
+   provided for RV32, where the GPRs match the 32-bit P instructions.  */
+
+bool
+riscv_packed_mode_p (machine_mode mode)
+{
+  if (!TARGET_PACKED_SIMD || TARGET_64BIT)
+    return false;
+
+  return mode == V4QImode || mode == V2HImode;
+}
+
+/* Return true if X is a vector constant whose elements are all the same
+   5-bit signed integer, as accepted by the .vi instruction forms.  */
+
+bool
+riscv_const_vec_simm5_p (rtx x)
+{
+  rtx elt;
+
+  return (GET_CODE (x) == CONST_VECTOR
+	  && const_vec_duplicate_p (x, &elt)
+	  && CONST_INT_P (elt)
+	  && IN_RANGE (INTVAL (elt), -16, 15));
+}
+
+/* If (set DEST SRC) is not a valid vector move instruction, emit an
+   equivalent sequence that is valid and return true.  Vector loads and
+   stores only take a base register, and only splatted 5-bit constants
+   can be moved directly into a vector register.  */
+
+bool
+riscv_legitimize_vector_move (rtx dest, rtx src)
+{
+  machine_mode mode = GET_MODE (dest);
+
+  if (!can_create_pseudo_p ())
+    return false;
+
+  if (CONSTANT_P (src) && !riscv_const_vec_simm5_p (src))
+    src = validize_mem (force_const_mem (mode, src));
+
+  if (MEM_P (src) && !REG_P (XEXP (src, 0)))
+    src = replace_equiv_address (src, force_reg (Pmode, XEXP (src, 0)));
+
+  if (MEM_P (dest))
+    {
+      if (!REG_P (XEXP (dest, 0)))
+	dest = replace_equiv_address (dest,
+				      force_reg (Pmode, XEXP (dest, 0)));
+      if (!REG_P (src))
+	src = force_reg (mode, src);
+    }
+
+  emit_insn (gen_rtx_SET (dest, src));
+  return true;
+}
+
+/* If (set DEST SRC) is not a valid packed-SIMD move instruction, emit an
+   equivalent sequence that is valid and return true.  Constants are
+   loaded as the SImode integer with the same bits.  */
+
+bool
+riscv_legitimize_packed_move (rtx dest, rtx src)
+{
+  machine_mode mode = GET_MODE (dest);
+
+  if (!can_create_pseudo_p ())
+    return false;
+
+  if (GET_CODE (src) == CONST_VECTOR && src != CONST0_RTX (mode))
+    {
+      rtx tmp = gen_reg_rtx (SImode);
+      emit_move_insn (tmp, simplify_gen_subreg (SImode, src, mode, 0));
+      src = gen_lowpart (mode, tmp);
+    }
+
+  if (MEM_P (dest) && !reg_or_0_operand (src, mode))
+    src = force_reg (mode, src);
+
+  emit_insn (gen_rtx_SET (dest, src));
+  return true;
+}
+
+/* Expand a vector initialization of TARGET from the PARALLEL VALS.
+   Splats use VMV.V.X or VFMV.V.F; anything else is assembled in a stack
+   temporary and loaded as a whole.  */
+
+void
+riscv_expand_vector_init (rtx target, rtx vals)
+{
+  machine_mode mode = GET_MODE (target);
+  machine_mode inner_mode = GET_MODE_INNER (mode);
+  int nelts = GET_MODE_NUNITS (mode);
+
+  bool all_same = true;
+  for (int i = 1; i < nelts; i++)
+    if (!rtx_equal_p (XVECEXP (vals, 0, i), XVECEXP (vals, 0, 0)))
+      all_same = false;
+
+  /* Integer elements wider than a GPR can't be splatted directly.  */
+  if (all_same
+      && (FLOAT_MODE_P (inner_mode)
+	  || GET_MODE_SIZE (inner_mode) <= UNITS_PER_WORD))
+    {
+      rtx dup = force_reg (inner_mode, XVECEXP (vals, 0, 0));
+      emit_insn (gen_rtx_SET (target, gen_rtx_VEC_DUPLICATE (mode, dup)));
+      return;
+    }
+
+  rtx mem = assign_stack_temp (mode, GET_MODE_SIZE (mode));
+  for (int i = 0; i < nelts; i++)
+    emit_move_insn (adjust_address_nv (mem, inner_mode,
+				       i * GET_MODE_SIZE (inner_mode)),
+		    XVECEXP (vals, 0, i));
+  riscv_legitimize_vector_move (target, mem);
+}
+
 /* If (set DEST SRC) is not a valid move instruction, emit an equivalent
    sequence that is valid.  */
 
@@ -1684,6 +2387,14 @@ riscv_extend_cost (rtx op, bool unsigned_p)
     /* We can use SEXT.W.  */
     return COSTS_N_INSNS (1);
 
+  if (TARGET_ZBA && unsigned_p && GET_MODE (op) == SImode)
+    /* We can use ZEXT.W.  */
+    return COSTS_N_INSNS (1);
+
+  if (TARGET_ZBB && (!unsigned_p || GET_MODE (op) == HImode))
+    /* We can use SEXT.B, SEXT.H or ZEXT.H.  */
+    return COSTS_N_INSNS (1);
+
   /* We need to use a shift left and a shift right.  */
   return COSTS_N_INSNS (2);
 }
@@ -1735,11 +2446,11 @@ riscv_rtx_costs (rtx x, machine_mode mode, int outer_code, int opno ATTRIBUTE_UN
 	 instructions it needs.  */
       if ((cost = riscv_address_insns (XEXP (x, 0), mode, true)) > 0)
 	{
-	  /* When optimizing for size, make uncompressible 32-bit addresses
-	     more expensive so that compressible 32-bit addresses are
-	     preferred.  */
-	  if (TARGET_RVC && !speed && riscv_mshorten_memrefs && mode == SImode
-	      && !riscv_compressed_lw_address_p (XEXP (x, 0)))
+	  /* When optimizing for size, make uncompressible addresses more
+	     expensive so that compressible addresses are preferred.  */
+	  if (!speed && riscv_mshorten_memrefs
+	      && riscv_compressed_mem_max_offset (mode) != 0
+	      && !riscv_compressed_mem_address_p (XEXP (x, 0), mode))
 	    cost++;
 
 	  *total = COSTS_N_INSNS (cost + tune_param->memory_cost);
@@ -1749,17 +2460,75 @@ riscv_rtx_costs (rtx x, machine_mode mode, int outer_code, int opno ATTRIBUTE_UN
       return false;
 
     case NOT:
+      /* XNOR is a single instruction.  */
+      if ((TARGET_ZBB || TARGET_ZBKB) && GET_CODE (XEXP (x, 0)) == XOR
+	  && GET_MODE_SIZE (mode) <= UNITS_PER_WORD)
+	{
+	  *total = (COSTS_N_INSNS (1)
+		    + set_src_cost (XEXP (XEXP (x, 0), 0), mode, speed)
+		    + set_src_cost (XEXP (XEXP (x, 0), 1), mode, speed));
+	  return true;
+	}
       *total = COSTS_N_INSNS (GET_MODE_SIZE (mode) > UNITS_PER_WORD ? 2 : 1);
       return false;
 
     case AND:
+      /* SLLI.UW zero-extends a shifted word.  */
+      if (TARGET_ZBA && TARGET_64BIT && mode == DImode
+	  && GET_CODE (XEXP (x, 0)) == ASHIFT
+	  && CONST_INT_P (XEXP (XEXP (x, 0), 1))
+	  && CONST_INT_P (XEXP (x, 1))
+	  && ((INTVAL (XEXP (x, 1)) >> INTVAL (XEXP (XEXP (x, 0), 1)))
+	      == 0xffffffff))
+	{
+	  *total = (COSTS_N_INSNS (1)
+		    + set_src_cost (XEXP (XEXP (x, 0), 0), mode, speed));
+	  return true;
+	}
+      /* BCLR and BCLRI.  */
+      if (TARGET_ZBS && GET_MODE_SIZE (mode) <= UNITS_PER_WORD
+	  && ((GET_CODE (XEXP (x, 0)) == ROTATE
+	       && XEXP (XEXP (x, 0), 0) == GEN_INT (-2))
+	      || not_single_bit_mask_operand (XEXP (x, 1), VOIDmode)))
+	{
+	  *total = COSTS_N_INSNS (1);
+	  return true;
+	}
+      /* Fall through.  */
     case IOR:
     case XOR:
+      /* ANDN and ORN are single instructions.  */
+      if ((TARGET_ZBB || TARGET_ZBKB) && GET_CODE (x) != XOR
+	  && GET_CODE (XEXP (x, 0)) == NOT
+	  && GET_MODE_SIZE (mode) <= UNITS_PER_WORD)
+	{
+	  *total = (COSTS_N_INSNS (1)
+		    + set_src_cost (XEXP (XEXP (x, 0), 0), mode, speed)
+		    + set_src_cost (XEXP (x, 1), mode, speed));
+	  return true;
+	}
+      /* BSET, BSETI, BINV and BINVI.  */
+      if (TARGET_ZBS && GET_CODE (x) != AND
+	  && GET_MODE_SIZE (mode) <= UNITS_PER_WORD
+	  && ((GET_CODE (XEXP (x, 0)) == ASHIFT
+	       && XEXP (XEXP (x, 0), 0) == const1_rtx)
+	      || single_bit_mask_operand (XEXP (x, 1), VOIDmode)))
+	{
+	  *total = COSTS_N_INSNS (1);
+	  return true;
+	}
       /* Double-word operations use two single-word operations.  */
       *total = riscv_binary_cost (x, 1, 2);
       return false;
 
     case ZERO_EXTRACT:
+      /* BEXT and BEXTI.  */
+      if (TARGET_ZBS && XEXP (x, 1) == const1_rtx
+	  && GET_MODE_SIZE (mode) <= UNITS_PER_WORD)
+	{
+	  *total = COSTS_N_INSNS (1);
+	  return true;
+	}
       /* This is an SImode shift.  */
       if (outer_code == SET
 	  && CONST_INT_P (XEXP (x, 1))
@@ -1773,6 +2542,14 @@ riscv_rtx_costs (rtx x, machine_mode mode, int outer_code, int opno ATTRIBUTE_UN
       return false;
 
     case ASHIFT:
+      /* BSET with x0 as the source operand.  */
+      if (TARGET_ZBS && XEXP (x, 0) == const1_rtx
+	  && GET_MODE_SIZE (mode) <= UNITS_PER_WORD)
+	{
+	  *total = COSTS_N_INSNS (1);
+	  return true;
+	}
+      /* Fall through.  */
     case ASHIFTRT:
     case LSHIFTRT:
       *total = riscv_binary_cost (x, SINGLE_SHIFT_COST,
@@ -1842,8 +2619,24 @@ riscv_rtx_costs (rtx x, machine_mode mode, int outer_code, int opno ATTRIBUTE_UN
       *total = tune_param->fp_add[mode == DFmode] + COSTS_N_INSNS (4);
       return false;
 
-    case MINUS:
     case PLUS:
+      /* SH1ADD, SH2ADD, SH3ADD and ADD.UW.  */
+      if (TARGET_ZBA && !float_mode_p
+	  && GET_MODE_SIZE (mode) <= UNITS_PER_WORD
+	  && ((GET_CODE (XEXP (x, 0)) == ASHIFT
+	       && CONST_INT_P (XEXP (XEXP (x, 0), 1))
+	       && IN_RANGE (INTVAL (XEXP (XEXP (x, 0), 1)), 1, 3))
+	      || (TARGET_64BIT
+		  && GET_CODE (XEXP (x, 0)) == ZERO_EXTEND
+		  && GET_MODE (XEXP (XEXP (x, 0), 0)) == SImode)))
+	{
+	  *total = (COSTS_N_INSNS (1)
+		    + set_src_cost (XEXP (XEXP (x, 0), 0), mode, speed)
+		    + set_src_cost (XEXP (x, 1), mode, speed));
+	  return true;
+	}
+      /* Fall through.  */
+    case MINUS:
       if (float_mode_p)
 	*total = tune_param->fp_add[mode == DFmode];
       else
@@ -1877,6 +2670,9 @@ riscv_rtx_costs (rtx x, machine_mode mode, int outer_code, int opno ATTRIBUTE_UN
 	*total = COSTS_N_INSNS (speed ? 32 : 6);
       else if (GET_MODE_SIZE (mode) > UNITS_PER_WORD)
 	*total = 3 * tune_param->int_mul[0] + COSTS_N_INSNS (2);
+      else if (riscv_packed_mode_p (mode))
+	/* SMBB16 and SMTT16, then PKBB16 to combine the products.  */
+	*total = 2 * tune_param->int_mul[0] + COSTS_N_INSNS (1);
       else if (!speed)
 	*total = COSTS_N_INSNS (1);
       else
@@ -1916,7 +2712,53 @@ riscv_rtx_costs (rtx x, machine_mode mode, int outer_code, int opno ATTRIBUTE_UN
       *total = riscv_extend_cost (XEXP (x, 0), GET_CODE (x) == ZERO_EXTEND);
       return false;
 
-    case FLOAT:
+    case BSWAP:
+    case ROTATE:
+    case ROTATERT:
+      /* Word-sized and narrower forms are single Zbb or Zbkb
+	 instructions.  */
+      if (TARGET_ZBKB && GET_MODE_SIZE (mode) <= UNITS_PER_WORD)
+	{
+	  *total = COSTS_N_INSNS (1);
+	  return false;
+	}
+      /* Fall through.  */
+    case CLZ:
+    case CTZ:
+    case POPCOUNT:
+      /* Word-sized and narrower forms are single Zbb instructions.  */
+      if (TARGET_ZBB && GET_MODE_SIZE (mode) <= UNITS_PER_WORD)
+	{
+	  *total = COSTS_N_INSNS (1);
+	  return false;
+	}
+      return false;
+
+    case SMIN:
+    case SMAX:
+    case UMIN:
+    case UMAX:
+      if (!float_mode_p && TARGET_ZBB
+	  && GET_MODE_SIZE (mode) <= UNITS_PER_WORD)
+	{
+	  *total = COSTS_N_INSNS (1);
+	  return false;
+	}
+      return false;
+
+    case IF_THEN_ELSE:
+      /* CZERO.EQZ and CZERO.NEZ select between a register and zero.  */
+      if (TARGET_ZICOND
+	  && (GET_CODE (XEXP (x, 0)) == EQ || GET_CODE (XEXP (x, 0)) == NE)
+	  && XEXP (XEXP (x, 0), 1) == const0_rtx
+	  && (XEXP (x, 1) == const0_rtx || XEXP (x, 2) == const0_rtx))
+	{
+	  *total = COSTS_N_INSNS (1);
+	  return false;
+	}
+      return false;
+
+    case FLOAT:
     case UNSIGNED_FLOAT:
     case FIX:
     case FLOAT_EXTEND:
@@ -1925,7 +2767,7 @@ riscv_rtx_costs (rtx x, machine_mode mode, int outer_code, int opno ATTRIBUTE_UN
       return false;
 
     case FMA:
-      *total = (tune_param->fp_mul[mode == DFmode]
+      *total = (tune_param->fp_fma[mode == DFmode]
 		+ set_src_cost (XEXP (x, 0), mode, speed)
 		+ set_src_cost (XEXP (x, 1), mode, speed)
 		+ set_src_cost (XEXP (x, 2), mode, speed));
@@ -1952,10 +2794,11 @@ riscv_address_cost (rtx addr, machine_mode mode,
 		    addr_space_t as ATTRIBUTE_UNUSED,
 		    bool speed ATTRIBUTE_UNUSED)
 {
-  /* When optimizing for size, make uncompressible 32-bit addresses more
-   * expensive so that compressible 32-bit addresses are preferred.  */
-  if (TARGET_RVC && !speed && riscv_mshorten_memrefs && mode == SImode
-      && !riscv_compressed_lw_address_p (addr))
+  /* When optimizing for size, make uncompressible addresses more
+   * expensive so that compressible addresses are preferred.  */
+  if (!speed && riscv_mshorten_memrefs
+      && riscv_compressed_mem_max_offset (mode) != 0
+      && !riscv_compressed_mem_address_p (addr, mode))
     return riscv_address_insns (addr, mode, false) + 1;
   return riscv_address_insns (addr, mode, false);
 }
@@ -2033,12 +2876,13 @@ riscv_output_move (rtx dest, rtx src)
 {
   enum rtx_code dest_code, src_code;
   machine_mode mode;
-  bool dbl_p;
+  bool dbl_p, half_p;
 
   dest_code = GET_CODE (dest);
   src_code = GET_CODE (src);
   mode = GET_MODE (dest);
   dbl_p = (GET_MODE_SIZE (mode) == 8);
+  half_p = (GET_MODE_SIZE (mode) == 2);
 
   if (dbl_p && riscv_split_64bit_move_p (dest, src))
     return "#";
@@ -2046,7 +2890,8 @@ riscv_output_move (rtx dest, rtx src)
   if (dest_code == REG && GP_REG_P (REGNO (dest)))
     {
       if (src_code == REG && FP_REG_P (REGNO (src)))
-	return dbl_p ? "fmv.x.d\t%0,%1" : "fmv.x.w\t%0,%1";
+	return (dbl_p ? "fmv.x.d\t%0,%1"
+		: half_p ? "fmv.x.h\t%0,%1" : "fmv.x.w\t%0,%1");
 
       if (src_code == MEM)
 	switch (GET_MODE_SIZE (mode))
@@ -2058,7 +2903,14 @@ riscv_output_move (rtx dest, rtx src)
 	  }
 
       if (src_code == CONST_INT)
-	return "li\t%0,%1";
+	{
+	  if (TARGET_ZBS
+	      && !SMALL_OPERAND (INTVAL (src))
+	      && !LUI_OPERAND (INTVAL (src))
+	      && SINGLE_BIT_MASK_OPERAND (INTVAL (src)))
+	    return "bseti\t%0,zero,%S1";
+	  return "li\t%0,%1";
+	}
 
       if (src_code == HIGH)
 	return "lui\t%0,%h1";
@@ -2082,6 +2934,8 @@ riscv_output_move (rtx dest, rtx src)
 
 	  if (FP_REG_P (REGNO (dest)))
 	    {
+	      if (half_p)
+		return "fmv.h.x\t%0,%z1";
 	      if (!dbl_p)
 		return "fmv.w.x\t%0,%z1";
 	      if (TARGET_64BIT)
@@ -2102,16 +2956,21 @@ riscv_output_move (rtx dest, rtx src)
     }
   if (src_code == REG && FP_REG_P (REGNO (src)))
     {
+      /* Without Zfh there is no fmv.h, but fmv.s copies a NaN-boxed
+	 half-precision value unchanged.  */
       if (dest_code == REG && FP_REG_P (REGNO (dest)))
-	return dbl_p ? "fmv.d\t%0,%1" : "fmv.s\t%0,%1";
+	return (dbl_p ? "fmv.d\t%0,%1"
+		: half_p && TARGET_ZFH ? "fmv.h\t%0,%1" : "fmv.s\t%0,%1");
 
       if (dest_code == MEM)
-	return dbl_p ? "fsd\t%1,%0" : "fsw\t%1,%0";
+	return (dbl_p ? "fsd\t%1,%0"
+		: half_p ? "fsh\t%1,%0" : "fsw\t%1,%0");
     }
   if (dest_code == REG && FP_REG_P (REGNO (dest)))
     {
       if (src_code == MEM)
-	return dbl_p ? "fld\t%0,%1" : "flw\t%0,%1";
+	return (dbl_p ? "fld\t%0,%1"
+		: half_p ? "flh\t%0,%1" : "flw\t%0,%1");
     }
   gcc_unreachable ();
 }
@@ -2125,6 +2984,47 @@ riscv_output_return ()
   return "ret";
 }
 
+/* Return the assembly code for the casesi dispatch in OPERANDS.  %0 is
+   the address of the jump table, %1 the index into it and %2 its label;
+   %3 and %4 are scratch registers.  The entries are offsets from the
+   .Lrtx label emitted here, and their size is only known once
+   shorten_branches has run.  */
+
+const char *
+riscv_output_casesi (rtx *operands)
+{
+  rtx diff_vec = PATTERN (NEXT_INSN (as_a <rtx_insn *> (operands[2])));
+  static const char *const loads[3] = {
+    "lb\t%3,0(%3)", "lh\t%3,0(%3)", "lw\t%3,0(%3)"
+  };
+  static const char *const shadds[3] = {
+    NULL, "sh1add\t%3,%1,%0", "sh2add\t%3,%1,%0"
+  };
+  static const char *const shifts[3] = {
+    NULL, "slli\t%3,%1,1", "slli\t%3,%1,2"
+  };
+
+  gcc_assert (GET_CODE (diff_vec) == ADDR_DIFF_VEC);
+  int shift = exact_log2 (GET_MODE_SIZE (GET_MODE (diff_vec)));
+  gcc_assert (shift >= 0 && shift <= 2);
+
+  if (shift == 0)
+    output_asm_insn ("add\t%3,%0,%1", operands);
+  else if (TARGET_ZBA)
+    output_asm_insn (shadds[shift], operands);
+  else
+    {
+      output_asm_insn (shifts[shift], operands);
+      output_asm_insn ("add\t%3,%3,%0", operands);
+    }
+  output_asm_insn (loads[shift], operands);
+  targetm.asm_out.internal_label (asm_out_file, "Lrtx",
+				  CODE_LABEL_NUMBER (operands[2]));
+  output_asm_insn ("auipc\t%4,0", operands);
+  output_asm_insn ("add\t%3,%3,%4", operands);
+  return "jr\t%3";
+}
+
 
 /* Return true if CMP1 is a suitable second operand for integer ordering
    test CODE.  See also the *sCC patterns in riscv.md.  */
@@ -2380,7 +3280,11 @@ riscv_emit_float_compare (enum rtx_code *code, rtx *op0, rtx *op1)
     case CODE:								\
       *code = EQ;							\
       *op0 = gen_reg_rtx (word_mode);					\
-      if (GET_MODE (cmp_op0) == SFmode && TARGET_64BIT)			\
+      if (GET_MODE (cmp_op0) == HFmode && TARGET_64BIT)			\
+	emit_insn (gen_f##CMP##_quiethfdi4 (*op0, cmp_op0, cmp_op1));	\
+      else if (GET_MODE (cmp_op0) == HFmode)				\
+	emit_insn (gen_f##CMP##_quiethfsi4 (*op0, cmp_op0, cmp_op1));	\
+      else if (GET_MODE (cmp_op0) == SFmode && TARGET_64BIT)		\
 	emit_insn (gen_f##CMP##_quietsfdi4 (*op0, cmp_op0, cmp_op1));	\
       else if (GET_MODE (cmp_op0) == SFmode)				\
 	emit_insn (gen_f##CMP##_quietsfsi4 (*op0, cmp_op0, cmp_op1));	\
@@ -2476,12 +3380,69 @@ riscv_expand_conditional_branch (rtx label, rtx_code code, rtx op0, rtx op1)
   emit_jump_insn (gen_condjump (condition, label));
 }
 
+/* Like riscv_expand_conditional_move, but use the Zicond instructions
+   to compute the result without a branch.  */
+
+static void
+riscv_expand_zicond_move (rtx dest, rtx cons, rtx alt, rtx_code code,
+			  rtx op0, rtx op1)
+{
+  machine_mode mode = GET_MODE (dest);
+  rtx cond;
+
+  /* Reduce the comparison to a test of a register against zero.  */
+  if (code == EQ || code == NE)
+    {
+      riscv_extend_comparands (code, &op0, &op1);
+      op0 = force_reg (word_mode, op0);
+      cond = force_reg (word_mode, riscv_zero_if_equal (op0, op1));
+    }
+  else
+    {
+      cond = gen_reg_rtx (word_mode);
+      riscv_expand_int_scc (cond, code, op0, op1);
+      code = NE;
+    }
+  rtx test = gen_rtx_fmt_ee (code, VOIDmode, cond, const0_rtx);
+
+  if (alt == const0_rtx)
+    {
+      cons = force_reg (mode, cons);
+      riscv_emit_set (dest, gen_rtx_IF_THEN_ELSE (mode, test, cons, alt));
+    }
+  else if (cons == const0_rtx)
+    {
+      alt = force_reg (mode, alt);
+      riscv_emit_set (dest, gen_rtx_IF_THEN_ELSE (mode, test, cons, alt));
+    }
+  else
+    {
+      /* Zero each of the values when the other one is selected and
+	 combine the results.  */
+      rtx cons_part = gen_reg_rtx (mode);
+      rtx alt_part = gen_reg_rtx (mode);
+      riscv_emit_set (cons_part,
+		      gen_rtx_IF_THEN_ELSE (mode, test, force_reg (mode, cons),
+					    const0_rtx));
+      riscv_emit_set (alt_part,
+		      gen_rtx_IF_THEN_ELSE (mode, test, const0_rtx,
+					    force_reg (mode, alt)));
+      riscv_emit_binary (IOR, dest, cons_part, alt_part);
+    }
+}
+
 /* If (CODE OP0 OP1) holds, move CONS to DEST; else move ALT to DEST.  */
 
 void
 riscv_expand_conditional_move (rtx dest, rtx cons, rtx alt, rtx_code code,
 			       rtx op0, rtx op1)
 {
+  if (TARGET_ZICOND)
+    {
+      riscv_expand_zicond_move (dest, cons, alt, code, op0, op1);
+      return;
+    }
+
   riscv_emit_int_compare (&code, &op0, &op1);
   rtx cond = gen_rtx_fmt_ee (code, GET_MODE (op0), op0, op1);
   emit_insn (gen_rtx_SET (dest, gen_rtx_IF_THEN_ELSE (GET_MODE (dest), cond,
@@ -2506,13 +3467,33 @@ riscv_function_arg_boundary (machine_mode mode, const_tree type)
   return MIN (PREFERRED_STACK_BOUNDARY, MAX (PARM_BOUNDARY, alignment));
 }
 
+/* Return false if MODE is, or is made of, a half-precision floating-point
+   mode whose FPR loads, stores and moves are not available.  Zfhmin
+   provides them for HFmode and Zfbfmin for BFmode.  */
+
+static bool
+riscv_fp_half_mode_ok_p (machine_mode mode)
+{
+  switch (GET_MODE_INNER (mode))
+    {
+    case E_HFmode:
+      return TARGET_ZFHMIN;
+    case E_BFmode:
+      return TARGET_ZFBFMIN;
+    default:
+      return true;
+    }
+}
+
 /* If MODE represents an argument that can be passed or returned in
-   floating-point registers, return the number of registers, else 0.  */
+   floating-point registers, return the number of registers, else 0.
+   Half-precision values are NaN-boxed in a single FPR.  */
 
 static unsigned
 riscv_pass_mode_in_fpr_p (machine_mode mode)
 {
-  if (GET_MODE_UNIT_SIZE (mode) <= UNITS_PER_FP_ARG)
+  if (GET_MODE_UNIT_SIZE (mode) <= UNITS_PER_FP_ARG
+      && riscv_fp_half_mode_ok_p (mode))
     {
       if (GET_MODE_CLASS (mode) == MODE_FLOAT)
 	return 1;
@@ -2789,6 +3770,25 @@ riscv_pass_fpr_pair (machine_mode mode, unsigned regno1,
 				   GEN_INT (offset2))));
 }
 
+/* Pass or return a vector of mode MODE in NREGS consecutive GPRs starting
+   at REGNO.  Vector registers can't hold scalar words, so describe the
+   value as a sequence of word-sized pieces; this keeps the calling
+   convention identical to that of the equivalent integer mode.  */
+
+static rtx
+riscv_pass_vector_in_gprs (machine_mode mode, unsigned regno, unsigned nregs)
+{
+  rtvec vec = rtvec_alloc (nregs);
+
+  for (unsigned i = 0; i < nregs; i++)
+    RTVEC_ELT (vec, i)
+      = gen_rtx_EXPR_LIST (VOIDmode,
+			   gen_rtx_REG (word_mode, regno + i),
+			   GEN_INT (i * UNITS_PER_WORD));
+
+  return gen_rtx_PARALLEL (mode, vec);
+}
+
 /* Fill INFO with information about a single argument, and return an
    RTL pattern to pass or return the argument.  CUM is the cumulative
    state for earlier arguments.  MODE is the mode of this argument and
@@ -2886,6 +3886,10 @@ riscv_get_arg_info (struct riscv_arg_info *info, const CUMULATIVE_ARGS *cum,
   info->num_gprs = MIN (num_words, MAX_ARGS_IN_REGISTERS - info->gpr_offset);
   info->stack_p = (num_words - info->num_gprs) != 0;
 
+  if (riscv_vector_mode_p (mode) && (info->num_gprs || return_p))
+    return riscv_pass_vector_in_gprs (mode, gpr_base + info->gpr_offset,
+				      return_p ? num_words : info->num_gprs);
+
   if (info->num_gprs || return_p)
     return gen_rtx_REG (mode, gpr_base + info->gpr_offset);
 
@@ -3144,18 +4148,94 @@ riscv_legitimize_call_address (rtx addr)
 {
   if (!call_insn_operand (addr, VOIDmode))
     {
-      rtx reg = RISCV_CALL_ADDRESS_TEMP (Pmode);
+      /* Prefer a pseudo, so that a GOT load for a call that avoids the
+	 PLT can be hoisted and shared like any other.  */
+      rtx reg = (can_create_pseudo_p ()
+		 ? gen_reg_rtx (Pmode)
+		 : RISCV_CALL_ADDRESS_TEMP (Pmode));
       riscv_emit_move (reg, addr);
       return reg;
     }
   return addr;
 }
 
+/* Emit call insn PAT, whose target address is ADDR, and return it.
+   With -fipa-ra, callers only assume that a call clobbers what the
+   callee uses, so record the registers that the call sequence itself
+   can clobber: T1 for the AUIPC of a TAIL, and T0-T3 if the linker
+   might send the call through a PLT stub and the lazy binding
+   resolver.  */
+
+rtx_insn *
+riscv_emit_call_insn (rtx pat, rtx addr, bool sibcall_p)
+{
+  rtx_insn *insn = emit_call_insn (pat);
+  rtx *fusage = &CALL_INSN_FUNCTION_USAGE (insn);
+
+  if (sibcall_p && !REG_P (addr))
+    clobber_reg (fusage, gen_rtx_REG (word_mode, T1_REGNUM));
+
+  if (GET_CODE (addr) == SYMBOL_REF && !SYMBOL_REF_LOCAL_P (addr))
+    {
+      clobber_reg (fusage, gen_rtx_REG (word_mode, T0_REGNUM));
+      clobber_reg (fusage, gen_rtx_REG (word_mode, T1_REGNUM));
+      clobber_reg (fusage, gen_rtx_REG (word_mode, GP_REG_FIRST + 7));
+      clobber_reg (fusage, gen_rtx_REG (word_mode, GP_REG_FIRST + 28));
+    }
+
+  return insn;
+}
+
+/* Return true if a block operation on LENGTH bytes is large enough to
+   mark its memory accesses as non-temporal.  */
+
+static bool
+riscv_block_nontemporal_p (rtx length)
+{
+  return (TARGET_ZIHINTNTL
+	  && CONST_INT_P (length)
+	  && UINTVAL (length) >= RISCV_NTL_MIN_BLOCK_BYTES);
+}
+
+/* Emit a move from SRC to DEST, one of which is a memory reference of an
+   integer mode no wider than a word.  If NONTEMPORAL_P, precede the
+   access with a Zihintntl hint.  */
+
+static void
+riscv_emit_block_move_insn (rtx dest, rtx src, bool nontemporal_p)
+{
+  if (!nontemporal_p)
+    riscv_emit_move (dest, src);
+  else if (MEM_P (dest))
+    emit_insn (GEN_FCN (optab_handler (storent_optab, GET_MODE (dest)))
+	       (dest, src));
+  else
+    switch (GET_MODE (dest))
+      {
+      case E_QImode:
+	emit_insn (gen_riscv_ntl_loadqi (dest, src));
+	break;
+      case E_HImode:
+	emit_insn (gen_riscv_ntl_loadhi (dest, src));
+	break;
+      case E_SImode:
+	emit_insn (gen_riscv_ntl_loadsi (dest, src));
+	break;
+      case E_DImode:
+	emit_insn (gen_riscv_ntl_loaddi (dest, src));
+	break;
+      default:
+	gcc_unreachable ();
+      }
+}
+
 /* Emit straight-line code to move LENGTH bytes from SRC to DEST.
+   If NONTEMPORAL_P, mark the loads and stores as non-temporal.
    Assume that the areas do not overlap.  */
 
 static void
-riscv_block_move_straight (rtx dest, rtx src, unsigned HOST_WIDE_INT length)
+riscv_block_move_straight (rtx dest, rtx src, unsigned HOST_WIDE_INT length,
+			   bool nontemporal_p)
 {
   unsigned HOST_WIDE_INT offset, delta;
   unsigned HOST_WIDE_INT bits;
@@ -3166,26 +4246,45 @@ riscv_block_move_straight (rtx dest, rtx src, unsigned HOST_WIDE_INT length)
   bits = MAX (BITS_PER_UNIT,
 	      MIN (BITS_PER_WORD, MIN (MEM_ALIGN (src), MEM_ALIGN (dest))));
 
+  /* Misaligned word accesses are as good as aligned ones if the target
+     handles them quickly.  */
+  if (!riscv_slow_unaligned_access_p)
+    bits = BITS_PER_WORD;
+
   mode = mode_for_size (bits, MODE_INT, 0).require ();
   delta = bits / BITS_PER_UNIT;
 
   /* Allocate a buffer for the temporary registers.  */
-  regs = XALLOCAVEC (rtx, length / delta);
+  regs = XALLOCAVEC (rtx, length / delta + 1);
 
   /* Load as many BITS-sized chunks as possible.  Use a normal load if
      the source has enough alignment, otherwise use left/right pairs.  */
   for (offset = 0, i = 0; offset + delta <= length; offset += delta, i++)
     {
       regs[i] = gen_reg_rtx (mode);
-      riscv_emit_move (regs[i], adjust_address (src, mode, offset));
+      riscv_emit_block_move_insn (regs[i], adjust_address (src, mode, offset),
+				  nontemporal_p);
+    }
+
+  /* With fast misaligned accesses, copy any left-over bytes with one
+     more chunk that overlaps the previous one.  */
+  bool overlap_p = (offset < length && offset >= delta
+		    && !riscv_slow_unaligned_access_p);
+  if (overlap_p)
+    {
+      regs[i] = gen_reg_rtx (mode);
+      riscv_emit_move (regs[i], adjust_address (src, mode, length - delta));
     }
 
   /* Copy the chunks to the destination.  */
   for (offset = 0, i = 0; offset + delta <= length; offset += delta, i++)
-    riscv_emit_move (adjust_address (dest, mode, offset), regs[i]);
+    riscv_emit_block_move_insn (adjust_address (dest, mode, offset), regs[i],
+				nontemporal_p);
 
+  if (overlap_p)
+    riscv_emit_move (adjust_address (dest, mode, length - delta), regs[i]);
   /* Mop up any left-over bytes.  */
-  if (offset < length)
+  else if (offset < length)
     {
       src = adjust_address (src, BLKmode, offset);
       dest = adjust_address (dest, BLKmode, offset);
@@ -3215,12 +4314,14 @@ riscv_adjust_block_mem (rtx mem, unsigned HOST_WIDE_INT length,
 }
 
 /* Move LENGTH bytes from SRC to DEST using a loop that moves BYTES_PER_ITER
-   bytes at a time.  LENGTH must be at least BYTES_PER_ITER.  Assume that
-   the memory regions do not overlap.  */
+   bytes at a time.  LENGTH must be at least BYTES_PER_ITER.  If
+   NONTEMPORAL_P, mark the accesses in the loop as non-temporal.  Assume
+   that the memory regions do not overlap.  */
 
 static void
 riscv_block_move_loop (rtx dest, rtx src, unsigned HOST_WIDE_INT length,
-		       unsigned HOST_WIDE_INT bytes_per_iter)
+		       unsigned HOST_WIDE_INT bytes_per_iter,
+		       bool nontemporal_p)
 {
   rtx label, src_reg, dest_reg, final_src, test;
   unsigned HOST_WIDE_INT leftover;
@@ -3242,7 +4343,7 @@ riscv_block_move_loop (rtx dest, rtx src, unsigned HOST_WIDE_INT length,
   emit_label (label);
 
   /* Emit the loop body.  */
-  riscv_block_move_straight (dest, src, bytes_per_iter);
+  riscv_block_move_straight (dest, src, bytes_per_iter, nontemporal_p);
 
   /* Move on to the next block.  */
   riscv_emit_move (src_reg, plus_constant (Pmode, src_reg, bytes_per_iter));
@@ -3257,12 +4358,57 @@ riscv_block_move_loop (rtx dest, rtx src, unsigned HOST_WIDE_INT length,
 
   /* Mop up any left-over bytes.  */
   if (leftover)
-    riscv_block_move_straight (dest, src, leftover);
+    riscv_block_move_straight (dest, src, leftover, false);
   else
     emit_insn(gen_nop ());
 }
 
-/* Expand a cpymemsi instruction, which copies LENGTH bytes from
+/* Emit a strip-mined RVV loop that moves LENGTH bytes from SRC to DEST.
+   LENGTH need not be constant.  If LENGTH is known to be no more than
+   the bytes in one vector register, a single step is enough.  Use
+   non-temporal accesses if LENGTH is large enough.  Assume that the
+   areas do not overlap.  */
+
+static void
+riscv_block_move_vector (rtx dest, rtx src, rtx length)
+{
+  rtx src_reg, dest_reg, label = NULL_RTX;
+  bool single_p = (CONST_INT_P (length)
+		   && UINTVAL (length) <= UNITS_PER_V_REG);
+
+  riscv_adjust_block_mem (src, 1, &src_reg, &src);
+  riscv_adjust_block_mem (dest, 1, &dest_reg, &dest);
+  rtx len = copy_to_mode_reg (Pmode, convert_to_mode (Pmode, length, true));
+
+  if (!single_p)
+    {
+      label = gen_label_rtx ();
+      emit_label (label);
+    }
+
+  rtx vl = gen_reg_rtx (Pmode);
+  if (riscv_block_nontemporal_p (length))
+    {
+      if (Pmode == DImode)
+	emit_insn (gen_riscv_vcpymem_ntl_stepdi (vl, dest, src, len));
+      else
+	emit_insn (gen_riscv_vcpymem_ntl_stepsi (vl, dest, src, len));
+    }
+  else if (Pmode == DImode)
+    emit_insn (gen_riscv_vcpymem_stepdi (vl, dest, src, len));
+  else
+    emit_insn (gen_riscv_vcpymem_stepsi (vl, dest, src, len));
+
+  if (!single_p)
+    {
+      riscv_emit_binary (PLUS, src_reg, src_reg, vl);
+      riscv_emit_binary (PLUS, dest_reg, dest_reg, vl);
+      riscv_emit_binary (MINUS, len, len, vl);
+      riscv_expand_conditional_branch (label, NE, len, const0_rtx);
+    }
+}
+
+/* Expand a cpymem instruction, which copies LENGTH bytes from
    memory reference SRC to memory reference DEST.  */
 
 bool
@@ -3274,6 +4420,8 @@ riscv_expand_block_move (rtx dest, rtx src, rtx length)
       unsigned HOST_WIDE_INT factor, align;
 
       align = MIN (MIN (MEM_ALIGN (src), MEM_ALIGN (dest)), BITS_PER_WORD);
+      if (!riscv_slow_unaligned_access_p)
+	align = BITS_PER_WORD;
       factor = BITS_PER_WORD / align;
 
       if (optimize_function_for_size_p (cfun)
@@ -3282,7 +4430,12 @@ riscv_expand_block_move (rtx dest, rtx src, rtx length)
 
       if (hwi_length <= (RISCV_MAX_MOVE_BYTES_STRAIGHT / factor))
 	{
-	  riscv_block_move_straight (dest, src, INTVAL (length));
+	  riscv_block_move_straight (dest, src, INTVAL (length), false);
+	  return true;
+	}
+      else if (TARGET_VECTOR && optimize)
+	{
+	  riscv_block_move_vector (dest, src, length);
 	  return true;
 	}
       else if (optimize && align >= BITS_PER_WORD)
@@ -3302,146 +4455,793 @@ riscv_expand_block_move (rtx dest, rtx src, rtx length)
 		iter_words = i;
 	    }
 
-	  riscv_block_move_loop (dest, src, bytes, iter_words * UNITS_PER_WORD);
+	  riscv_block_move_loop (dest, src, bytes, iter_words * UNITS_PER_WORD,
+				 riscv_block_nontemporal_p (length));
 	  return true;
 	}
     }
+  else if (TARGET_VECTOR && optimize_function_for_speed_p (cfun))
+    {
+      riscv_block_move_vector (dest, src, length);
+      return true;
+    }
   return false;
 }
 
-/* Print symbolic operand OP, which is part of a HIGH or LO_SUM
-   in context CONTEXT.  HI_RELOC indicates a high-part reloc.  */
+/* Return a word_mode register that holds the QImode value VALUE
+   replicated into every byte.  */
 
-static void
-riscv_print_operand_reloc (FILE *file, rtx op, bool hi_reloc)
+static rtx
+riscv_replicate_byte (rtx value)
 {
-  const char *reloc;
+  if (CONST_INT_P (value))
+    {
+      unsigned HOST_WIDE_INT byte = UINTVAL (value) & 0xff;
+      unsigned HOST_WIDE_INT word = 0;
+      for (unsigned i = 0; i < UNITS_PER_WORD; i++)
+	word |= byte << (i * BITS_PER_UNIT);
+      return force_reg (word_mode, gen_int_mode (word, word_mode));
+    }
 
-  switch (riscv_classify_symbolic_expression (op))
+  rtx word = gen_reg_rtx (word_mode);
+  riscv_emit_move (word, gen_rtx_ZERO_EXTEND (word_mode,
+					      gen_lowpart (QImode, value)));
+  for (unsigned bits = BITS_PER_UNIT; bits < BITS_PER_WORD; bits *= 2)
     {
-      case SYMBOL_ABSOLUTE:
-	reloc = hi_reloc ? "%hi" : "%lo";
-	break;
+      rtx shifted = riscv_force_binary (word_mode, ASHIFT, word,
+					GEN_INT (bits));
+      riscv_emit_binary (IOR, word, word, shifted);
+    }
+  return word;
+}
 
-      case SYMBOL_PCREL:
-	reloc = hi_reloc ? "%pcrel_hi" : "%pcrel_lo";
-	break;
+/* Emit a strip-mined RVV loop that sets LENGTH bytes of DEST to VALUE.
+   LENGTH need not be constant.  Use non-temporal stores if LENGTH is
+   large enough.  */
 
-      case SYMBOL_TLS_LE:
-	reloc = hi_reloc ? "%tprel_hi" : "%tprel_lo";
-	break;
+static void
+riscv_block_set_vector (rtx dest, rtx length, rtx value)
+{
+  rtx dest_reg, label = NULL_RTX;
+  bool single_p = (CONST_INT_P (length)
+		   && UINTVAL (length) <= UNITS_PER_V_REG);
 
-      default:
-	output_operand_lossage ("invalid use of '%%%c'", hi_reloc ? 'h' : 'R');
-	return;
+  riscv_adjust_block_mem (dest, 1, &dest_reg, &dest);
+  rtx len = copy_to_mode_reg (Pmode, convert_to_mode (Pmode, length, true));
+  if (value != const0_rtx)
+    value = force_reg (Pmode, convert_to_mode (Pmode, value, true));
+
+  if (!single_p)
+    {
+      label = gen_label_rtx ();
+      emit_label (label);
     }
 
-  fprintf (file, "%s(", reloc);
-  output_addr_const (file, riscv_strip_unspec_address (op));
-  fputc (')', file);
+  rtx vl = gen_reg_rtx (Pmode);
+  if (riscv_block_nontemporal_p (length))
+    {
+      if (Pmode == DImode)
+	emit_insn (gen_riscv_vsetmem_ntl_stepdi (vl, dest, len, value));
+      else
+	emit_insn (gen_riscv_vsetmem_ntl_stepsi (vl, dest, len, value));
+    }
+  else if (Pmode == DImode)
+    emit_insn (gen_riscv_vsetmem_stepdi (vl, dest, len, value));
+  else
+    emit_insn (gen_riscv_vsetmem_stepsi (vl, dest, len, value));
+
+  if (!single_p)
+    {
+      riscv_emit_binary (PLUS, dest_reg, dest_reg, vl);
+      riscv_emit_binary (MINUS, len, len, vl);
+      riscv_expand_conditional_branch (label, NE, len, const0_rtx);
+    }
+}
+
+/* Zero the cache block at the address in register ADDR.  */
+
+static rtx
+riscv_cbo_zero (rtx addr)
+{
+  if (Pmode == DImode)
+    return gen_riscv_cbo_zerodi (addr);
+  else
+    return gen_riscv_cbo_zerosi (addr);
 }
 
-/* Return true if the .AQ suffix should be added to an AMO to implement the
-   acquire portion of memory model MODEL.  */
+/* Try to clear LENGTH bytes of DEST with cbo.zero, one cache block at a
+   time, and return true on success.  This needs the block size to be
+   known, so requires Zic64b as well as Zicboz, and needs DEST to be
+   block-aligned.  Any bytes past the last whole block are cleared
+   normally.  */
 
 static bool
-riscv_memmodel_needs_amo_acquire (enum memmodel model)
+riscv_block_clear_cbo (rtx dest, rtx length)
 {
-  switch (model)
-    {
-      case MEMMODEL_ACQ_REL:
-      case MEMMODEL_SEQ_CST:
-      case MEMMODEL_SYNC_SEQ_CST:
-      case MEMMODEL_ACQUIRE:
-      case MEMMODEL_CONSUME:
-      case MEMMODEL_SYNC_ACQUIRE:
-	return true;
+  if (!TARGET_ZICBOZ
+      || !TARGET_ZIC64B
+      || !CONST_INT_P (length)
+      || MEM_ALIGN (dest) < RISCV_CBO_BLOCK_SIZE * BITS_PER_UNIT)
+    return false;
 
-      case MEMMODEL_RELEASE:
-      case MEMMODEL_SYNC_RELEASE:
-      case MEMMODEL_RELAXED:
-	return false;
+  unsigned HOST_WIDE_INT hwi_length = UINTVAL (length);
+  unsigned HOST_WIDE_INT blocks = hwi_length / RISCV_CBO_BLOCK_SIZE;
+  unsigned HOST_WIDE_INT leftover = hwi_length % RISCV_CBO_BLOCK_SIZE;
+  if (blocks == 0)
+    return false;
 
-      default:
-	gcc_unreachable ();
+  rtx addr = copy_addr_to_reg (XEXP (dest, 0));
+  if (blocks <= 4)
+    for (unsigned HOST_WIDE_INT i = 0; i < blocks; i++)
+      {
+	if (i != 0)
+	  riscv_emit_move (addr, plus_constant (Pmode, addr,
+						RISCV_CBO_BLOCK_SIZE));
+	emit_insn (riscv_cbo_zero (addr));
+      }
+  else
+    {
+      rtx final_addr
+	= expand_simple_binop (Pmode, PLUS, addr,
+			       GEN_INT (blocks * RISCV_CBO_BLOCK_SIZE),
+			       0, 0, OPTAB_WIDEN);
+      rtx label = gen_label_rtx ();
+      emit_label (label);
+      emit_insn (riscv_cbo_zero (addr));
+      riscv_emit_move (addr, plus_constant (Pmode, addr,
+					    RISCV_CBO_BLOCK_SIZE));
+      riscv_expand_conditional_branch (label, NE, addr, final_addr);
     }
+
+  if (leftover)
+    clear_storage (adjust_address (dest, BLKmode,
+				   blocks * RISCV_CBO_BLOCK_SIZE),
+		   GEN_INT (leftover), BLOCK_OP_NORMAL);
+  return true;
 }
 
-/* Return true if a FENCE should be emitted to before a memory access to
-   implement the release portion of memory model MODEL.  */
+/* Expand a setmem instruction, which sets LENGTH bytes of memory
+   reference DEST to the QImode value VALUE.  */
 
-static bool
-riscv_memmodel_needs_release_fence (enum memmodel model)
+bool
+riscv_expand_block_set (rtx dest, rtx length, rtx value)
 {
-  switch (model)
-    {
-      case MEMMODEL_ACQ_REL:
-      case MEMMODEL_SEQ_CST:
-      case MEMMODEL_SYNC_SEQ_CST:
-      case MEMMODEL_RELEASE:
-      case MEMMODEL_SYNC_RELEASE:
-	return true;
+  if (!optimize_function_for_speed_p (cfun))
+    return false;
 
-      case MEMMODEL_ACQUIRE:
-      case MEMMODEL_CONSUME:
-      case MEMMODEL_SYNC_ACQUIRE:
-      case MEMMODEL_RELAXED:
-	return false;
+  if (value == const0_rtx && riscv_block_clear_cbo (dest, length))
+    return true;
 
-      default:
-	gcc_unreachable ();
+  if (TARGET_VECTOR)
+    {
+      riscv_block_set_vector (dest, length, value);
+      return true;
     }
-}
 
-/* Implement TARGET_PRINT_OPERAND.  The RISCV-specific operand codes are:
+  /* Otherwise only handle the cases that store_by_pieces does badly:
+     word stores to a misaligned destination.  */
+  if (!CONST_INT_P (length)
+      || riscv_slow_unaligned_access_p
+      || MEM_ALIGN (dest) >= BITS_PER_WORD
+      || UINTVAL (length) < UNITS_PER_WORD
+      || UINTVAL (length) > RISCV_MAX_MOVE_BYTES_STRAIGHT)
+    return false;
 
-   'h'	Print the high-part relocation associated with OP, after stripping
-	  any outermost HIGH.
-   'R'	Print the low-part relocation associated with OP.
-   'C'	Print the integer branch condition for comparison OP.
-   'A'	Print the atomic operation suffix for memory model OP.
-   'F'	Print a FENCE if the memory model requires a release.
-   'z'	Print x0 if OP is zero, otherwise print OP normally.
-   'i'	Print i if the operand is not a register.  */
+  unsigned HOST_WIDE_INT hwi_length = UINTVAL (length);
+  unsigned HOST_WIDE_INT offset;
+  rtx word = riscv_replicate_byte (value);
+
+  for (offset = 0; offset + UNITS_PER_WORD <= hwi_length;
+       offset += UNITS_PER_WORD)
+    riscv_emit_move (adjust_address (dest, word_mode, offset), word);
+
+  /* Finish with a store that overlaps the previous one.  */
+  if (offset < hwi_length)
+    riscv_emit_move (adjust_address (dest, word_mode,
+				     hwi_length - UNITS_PER_WORD), word);
+  return true;
+}
+
+/* Load the MODE chunk at OFFSET of SRC1 and SRC2 into the word_mode
+   registers A and B, zero-extending if necessary, and branch to LABEL
+   if they differ.  */
 
 static void
-riscv_print_operand (FILE *file, rtx op, int letter)
+riscv_block_compare_chunk (rtx a, rtx b, rtx src1, rtx src2,
+			   machine_mode mode, HOST_WIDE_INT offset, rtx label)
 {
-  machine_mode mode = GET_MODE (op);
-  enum rtx_code code = GET_CODE (op);
+  rtx mem1 = adjust_address (src1, mode, offset);
+  rtx mem2 = adjust_address (src2, mode, offset);
 
-  switch (letter)
+  if (mode == word_mode)
     {
-    case 'h':
-      if (code == HIGH)
-	op = XEXP (op, 0);
-      riscv_print_operand_reloc (file, op, true);
-      break;
+      riscv_emit_move (a, mem1);
+      riscv_emit_move (b, mem2);
+    }
+  else
+    {
+      riscv_emit_move (a, gen_rtx_ZERO_EXTEND (word_mode, mem1));
+      riscv_emit_move (b, gen_rtx_ZERO_EXTEND (word_mode, mem2));
+    }
+  riscv_expand_conditional_branch (label, NE, a, b);
+}
 
-    case 'R':
-      riscv_print_operand_reloc (file, op, false);
-      break;
+/* Expand a cmpmem instruction, which compares LENGTH bytes of memory
+   references SRC1 and SRC2 as memcmp would and stores the SImode result
+   in RESULT.  */
 
-    case 'C':
-      /* The RTL names match the instruction names. */
-      fputs (GET_RTX_NAME (code), file);
-      break;
+bool
+riscv_expand_block_compare (rtx result, rtx src1, rtx src2, rtx length)
+{
+  if (!CONST_INT_P (length) || !optimize_function_for_speed_p (cfun))
+    return false;
 
-    case 'A':
-      if (riscv_memmodel_needs_amo_acquire ((enum memmodel) INTVAL (op)))
-	fputs (".aq", file);
-      break;
+  unsigned HOST_WIDE_INT hwi_length = UINTVAL (length);
+  unsigned HOST_WIDE_INT align
+    = MIN (MIN (MEM_ALIGN (src1), MEM_ALIGN (src2)), BITS_PER_WORD);
+  if (!riscv_slow_unaligned_access_p)
+    align = BITS_PER_WORD;
+
+  /* Comparing whole words only gives the memcmp ordering if the words
+     can be brought into big-endian order; otherwise fall back to
+     comparing bytes, which is only worthwhile for short blocks.  */
+  bool words_p = (align >= BITS_PER_WORD
+		  && (TARGET_BIG_ENDIAN || TARGET_ZBB || TARGET_ZBKB)
+		  && hwi_length >= UNITS_PER_WORD);
+  if (hwi_length == 0
+      || hwi_length > (words_p ? RISCV_MAX_MOVE_BYTES_STRAIGHT
+				: UNITS_PER_WORD))
+    return false;
 
-    case 'F':
-      if (riscv_memmodel_needs_release_fence ((enum memmodel) INTVAL (op)))
-	fputs ("fence iorw,ow; ", file);
-      break;
+  rtx a = gen_reg_rtx (word_mode);
+  rtx b = gen_reg_rtx (word_mode);
+  rtx diff_label = gen_label_rtx ();
+  rtx done_label = gen_label_rtx ();
+  unsigned HOST_WIDE_INT offset = 0;
 
-    case 'i':
+  if (words_p)
+    {
+      for (; offset + UNITS_PER_WORD <= hwi_length; offset += UNITS_PER_WORD)
+	riscv_block_compare_chunk (a, b, src1, src2, word_mode, offset,
+				   diff_label);
+
+      /* The bytes before OFFSET are known to be equal, so if misaligned
+	 accesses are fast, the left-over bytes can be compared with a
+	 chunk that overlaps them.  Otherwise use progressively narrower
+	 chunks, which are zero-extended in the same way on both sides.  */
+      if (offset < hwi_length && !riscv_slow_unaligned_access_p)
+	riscv_block_compare_chunk (a, b, src1, src2, word_mode,
+				   hwi_length - UNITS_PER_WORD, diff_label);
+      else
+	for (unsigned size = UNITS_PER_WORD / 2; size > 0; size /= 2)
+	  if (offset + size <= hwi_length)
+	    {
+	      machine_mode mode = int_mode_for_size (size * BITS_PER_UNIT,
+						     0).require ();
+	      riscv_block_compare_chunk (a, b, src1, src2, mode, offset,
+					 diff_label);
+	      offset += size;
+	    }
+    }
+  else
+    for (; offset < hwi_length; offset++)
+      riscv_block_compare_chunk (a, b, src1, src2, QImode, offset,
+				 diff_label);
+
+  emit_move_insn (result, const0_rtx);
+  emit_jump_insn (gen_jump (done_label));
+  emit_barrier ();
+
+  emit_label (diff_label);
+  rtx diff = gen_reg_rtx (word_mode);
+  if (words_p)
+    {
+      /* Compare the differing words as unsigned big-endian numbers,
+	 producing -1 or 1.  */
+      if (!TARGET_BIG_ENDIAN)
+	{
+	  expand_unop (word_mode, bswap_optab, a, a, 1);
+	  expand_unop (word_mode, bswap_optab, b, b, 1);
+	}
+      rtx gt = riscv_force_binary (word_mode, LTU, b, a);
+      rtx lt = riscv_force_binary (word_mode, LTU, a, b);
+      riscv_emit_binary (MINUS, diff, gt, lt);
+    }
+  else
+    riscv_emit_binary (MINUS, diff, a, b);
+  emit_move_insn (result, gen_lowpart (SImode, diff));
+
+  emit_label (done_label);
+  return true;
+}
+
+/* Set word_mode register DEST to orc.b of SRC, in which each byte is
+   0xff if the byte of SRC is nonzero and zero otherwise.  */
+
+static void
+riscv_emit_orc_b (rtx dest, rtx src)
+{
+  if (TARGET_64BIT)
+    emit_insn (gen_orcbdi2 (dest, src));
+  else
+    emit_insn (gen_orcbsi2 (dest, src));
+}
+
+/* Whether strings can be scanned a word at a time with orc.b.  The
+   index of the first zero byte of a word is found with ctz, which needs
+   the first byte in memory to be the least significant one.  */
+
+static bool
+riscv_string_words_p (void)
+{
+  return (TARGET_ZBB
+	  && !BYTES_BIG_ENDIAN
+	  && optimize_function_for_speed_p (cfun));
+}
+
+/* Compare the strings in word-aligned memory references SRC1 and SRC2 as
+   strcmp would, NWORDS words at a time, and store the SImode result in
+   RESULT.  If LENGTH is nonzero, compare at most its first LENGTH bytes,
+   which must fit in NWORDS words, as strncmp would.  Otherwise call
+   strcmp for the rest of the strings if the first NWORDS words are the
+   same and have no NUL.
+
+   The words of SRC1 and SRC2 are loaded whole even when they go past
+   the end of the strings, which cannot fault because an aligned word
+   never crosses a page boundary.  */
+
+static void
+riscv_expand_string_compare_words (rtx result, rtx src1, rtx src2,
+				   unsigned HOST_WIDE_INT nwords,
+				   unsigned HOST_WIDE_INT length)
+{
+  rtx a = gen_reg_rtx (word_mode);
+  rtx b = gen_reg_rtx (word_mode);
+  rtx orc = gen_reg_rtx (word_mode);
+  rtx found_label = gen_label_rtx ();
+  rtx done_label = gen_label_rtx ();
+
+  for (unsigned HOST_WIDE_INT i = 0; i < nwords; i++)
+    {
+      HOST_WIDE_INT offset = i * UNITS_PER_WORD;
+      riscv_emit_move (a, adjust_address (src1, word_mode, offset));
+      riscv_emit_move (b, adjust_address (src2, word_mode, offset));
+      riscv_emit_orc_b (orc, a);
+
+      /* Ignore the bytes past LENGTH: make them equal and nonzero.  */
+      if (length && offset + UNITS_PER_WORD > length)
+	{
+	  unsigned HOST_WIDE_INT bits = (length - offset) * BITS_PER_UNIT;
+	  rtx keep = gen_int_mode ((HOST_WIDE_INT_1U << bits) - 1, word_mode);
+	  riscv_emit_binary (AND, a, a, force_reg (word_mode, keep));
+	  riscv_emit_binary (AND, b, b, force_reg (word_mode, keep));
+	  riscv_emit_binary (IOR, orc, orc,
+			     force_reg (word_mode,
+					gen_int_mode (~UINTVAL (keep),
+						      word_mode)));
+	}
+
+      riscv_expand_conditional_branch (found_label, NE, orc, constm1_rtx);
+      riscv_expand_conditional_branch (found_label, NE, a, b);
+    }
+
+  if (length)
+    emit_move_insn (result, const0_rtx);
+  else
+    {
+      HOST_WIDE_INT offset = nwords * UNITS_PER_WORD;
+      rtx addr1 = force_reg (Pmode, plus_constant (Pmode, XEXP (src1, 0),
+						   offset));
+      rtx addr2 = force_reg (Pmode, plus_constant (Pmode, XEXP (src2, 0),
+						   offset));
+      rtx tail = emit_library_call_value (init_one_libfunc ("strcmp"),
+					  NULL_RTX, LCT_NORMAL, SImode,
+					  addr1, Pmode, addr2, Pmode);
+      emit_move_insn (result, tail);
+    }
+  emit_jump_insn (gen_jump (done_label));
+  emit_barrier ();
+
+  /* The strings differ or end in the last words loaded.  The lowest
+     byte that either differs or is the NUL of SRC1 decides the result,
+     which is the difference between the two bytes there.  */
+  emit_label (found_label);
+  rtx syndrome = riscv_force_binary (word_mode, XOR, a, b);
+  rtx not_orc = expand_unop (word_mode, one_cmpl_optab, orc, NULL_RTX, 1);
+  riscv_emit_binary (IOR, syndrome, syndrome, not_orc);
+  rtx shift = expand_unop (word_mode, ctz_optab, syndrome, NULL_RTX, 1);
+  shift = expand_simple_binop (word_mode, AND, shift,
+			       GEN_INT (-BITS_PER_UNIT), NULL_RTX, 1,
+			       OPTAB_DIRECT);
+  shift = gen_lowpart (QImode, shift);
+  a = expand_simple_binop (word_mode, LSHIFTRT, a, shift, NULL_RTX, 1,
+			   OPTAB_DIRECT);
+  b = expand_simple_binop (word_mode, LSHIFTRT, b, shift, NULL_RTX, 1,
+			   OPTAB_DIRECT);
+  riscv_emit_binary (AND, a, a, GEN_INT (0xff));
+  riscv_emit_binary (AND, b, b, GEN_INT (0xff));
+  rtx diff = riscv_force_binary (word_mode, MINUS, a, b);
+  emit_move_insn (result, gen_lowpart (SImode, diff));
+
+  emit_label (done_label);
+}
+
+/* Expand a cmpstrn instruction, which compares the strings in memory
+   references SRC1 and SRC2, reading at most LENGTH bytes, as strncmp
+   would and stores the SImode result in RESULT.  ALIGN is the known
+   alignment of both strings in bytes.  */
+
+bool
+riscv_expand_string_compare (rtx result, rtx src1, rtx src2, rtx length,
+			     rtx align)
+{
+  if (!CONST_INT_P (length)
+      || UINTVAL (length) == 0
+      || !optimize_function_for_speed_p (cfun))
+    return false;
+
+  unsigned HOST_WIDE_INT hwi_length = UINTVAL (length);
+  unsigned HOST_WIDE_INT nwords
+    = (hwi_length + UNITS_PER_WORD - 1) / UNITS_PER_WORD;
+  if (riscv_string_words_p ()
+      && UINTVAL (align) >= UNITS_PER_WORD
+      && nwords <= tune_param->strcmp_inline_words)
+    {
+      riscv_expand_string_compare_words (result, src1, src2, nwords,
+					 hwi_length);
+      return true;
+    }
+
+  if (hwi_length > UNITS_PER_WORD)
+    return false;
+
+  rtx a = gen_reg_rtx (word_mode);
+  rtx b = gen_reg_rtx (word_mode);
+  rtx diff_label = gen_label_rtx ();
+
+  emit_move_insn (a, const0_rtx);
+  emit_move_insn (b, const0_rtx);
+  for (unsigned HOST_WIDE_INT offset = 0; offset < hwi_length; offset++)
+    {
+      riscv_block_compare_chunk (a, b, src1, src2, QImode, offset,
+				 diff_label);
+      /* The bytes are equal; stop at the terminating NUL.  */
+      if (offset + 1 < hwi_length)
+	riscv_expand_conditional_branch (diff_label, EQ, a, const0_rtx);
+    }
+
+  emit_label (diff_label);
+  rtx diff = riscv_force_binary (word_mode, MINUS, a, b);
+  emit_move_insn (result, gen_lowpart (SImode, diff));
+  return true;
+}
+
+/* Expand a cmpstr instruction, which compares the strings in memory
+   references SRC1 and SRC2 as strcmp would and stores the SImode result
+   in RESULT.  ALIGN is the known alignment of both strings in bytes.  */
+
+bool
+riscv_expand_strcmp (rtx result, rtx src1, rtx src2, rtx align)
+{
+  if (!riscv_string_words_p ()
+      || UINTVAL (align) < UNITS_PER_WORD
+      || tune_param->strcmp_inline_words == 0)
+    return false;
+
+  riscv_expand_string_compare_words (result, src1, src2,
+				     tune_param->strcmp_inline_words, 0);
+  return true;
+}
+
+/* Expand a strlen instruction, which stores in RESULT the length of the
+   string in memory reference SRC, or the offset of the first byte equal
+   to SEARCH_CHAR.  ALIGN is the known alignment of SRC in bytes.
+
+   The string is scanned a word at a time, starting at the aligned word
+   that holds its first byte.  Aligned words never cross a page
+   boundary, so this cannot fault.  */
+
+bool
+riscv_expand_strlen (rtx result, rtx src, rtx search_char, rtx align)
+{
+  if (!riscv_string_words_p () || search_char != const0_rtx)
+    return false;
+
+  rtx addr = force_reg (Pmode, XEXP (src, 0));
+  rtx word_addr = gen_reg_rtx (Pmode);
+  rtx word = gen_reg_rtx (word_mode);
+  rtx orc = gen_reg_rtx (word_mode);
+  rtx loop_label = gen_label_rtx ();
+  rtx found_label = gen_label_rtx ();
+  rtx mem = change_address (src, word_mode, word_addr);
+  set_mem_align (mem, BITS_PER_WORD);
+
+  if (UINTVAL (align) >= UNITS_PER_WORD)
+    riscv_emit_move (word_addr, addr);
+  else
+    riscv_emit_binary (AND, word_addr, addr, GEN_INT (-UNITS_PER_WORD));
+  riscv_emit_move (word, mem);
+  riscv_emit_orc_b (orc, word);
+
+  /* Make the bytes before the start of the string count as nonzero.  */
+  if (UINTVAL (align) < UNITS_PER_WORD)
+    {
+      rtx shift = riscv_force_binary (Pmode, AND, addr,
+				      GEN_INT (UNITS_PER_WORD - 1));
+      riscv_emit_binary (ASHIFT, shift, shift, GEN_INT (3));
+      rtx before = expand_simple_binop (word_mode, ASHIFT, const1_rtx,
+					gen_lowpart (QImode, shift),
+					NULL_RTX, 1, OPTAB_DIRECT);
+      before = expand_simple_binop (word_mode, PLUS, before, constm1_rtx,
+				    NULL_RTX, 1, OPTAB_DIRECT);
+      riscv_emit_binary (IOR, orc, orc, before);
+    }
+  riscv_expand_conditional_branch (found_label, NE, orc, constm1_rtx);
+
+  emit_label (loop_label);
+  riscv_emit_binary (PLUS, word_addr, word_addr, GEN_INT (UNITS_PER_WORD));
+  riscv_emit_move (word, copy_rtx (mem));
+  riscv_emit_orc_b (orc, word);
+  riscv_expand_conditional_branch (loop_label, EQ, orc, constm1_rtx);
+
+  /* ORC has a zero byte for each NUL of the word; the first of them
+     ends the string.  */
+  emit_label (found_label);
+  rtx nul = expand_unop (word_mode, one_cmpl_optab, orc, NULL_RTX, 1);
+  rtx index = expand_unop (word_mode, ctz_optab, nul, NULL_RTX, 1);
+  index = expand_simple_binop (word_mode, LSHIFTRT, index, GEN_INT (3),
+			       NULL_RTX, 1, OPTAB_DIRECT);
+  rtx len = riscv_force_binary (Pmode, MINUS, word_addr, addr);
+  riscv_emit_binary (PLUS, len, len, index);
+  riscv_emit_move (result, len);
+  return true;
+}
+
+/* Print symbolic operand OP, which is part of a HIGH or LO_SUM
+   in context CONTEXT.  HI_RELOC indicates a high-part reloc.  */
+
+static void
+riscv_print_operand_reloc (FILE *file, rtx op, bool hi_reloc)
+{
+  const char *reloc;
+
+  switch (riscv_classify_symbolic_expression (op))
+    {
+      case SYMBOL_ABSOLUTE:
+	reloc = hi_reloc ? "%hi" : "%lo";
+	break;
+
+      case SYMBOL_PCREL:
+	reloc = hi_reloc ? "%pcrel_hi" : "%pcrel_lo";
+	break;
+
+      case SYMBOL_TLS_LE:
+	reloc = hi_reloc ? "%tprel_hi" : "%tprel_lo";
+	break;
+
+      default:
+	output_operand_lossage ("invalid use of '%%%c'", hi_reloc ? 'h' : 'R');
+	return;
+    }
+
+  fprintf (file, "%s(", reloc);
+  output_addr_const (file, riscv_strip_unspec_address (op));
+  fputc (')', file);
+}
+
+/* Return true if the .AQ suffix should be added to an AMO or LR to
+   implement the acquire portion of memory model MODEL.  */
+
+static bool
+riscv_memmodel_needs_amo_acquire (enum memmodel model)
+{
+  switch (memmodel_base (model))
+    {
+      case MEMMODEL_ACQ_REL:
+      case MEMMODEL_SEQ_CST:
+      case MEMMODEL_ACQUIRE:
+      case MEMMODEL_CONSUME:
+	return true;
+
+      case MEMMODEL_RELEASE:
+      case MEMMODEL_RELAXED:
+	return false;
+
+      default:
+	gcc_unreachable ();
+    }
+}
+
+/* Return true if the .RL suffix should be added to an AMO or SC to
+   implement the release portion of memory model MODEL.  */
+
+static bool
+riscv_memmodel_needs_amo_release (enum memmodel model)
+{
+  switch (memmodel_base (model))
+    {
+      case MEMMODEL_ACQ_REL:
+      case MEMMODEL_SEQ_CST:
+      case MEMMODEL_RELEASE:
+	return true;
+
+      case MEMMODEL_ACQUIRE:
+      case MEMMODEL_CONSUME:
+      case MEMMODEL_RELAXED:
+	return false;
+
+      default:
+	gcc_unreachable ();
+    }
+}
+
+/* Return the memory model that an LR/SC loop must honour to implement
+   a compare-and-swap with success model MOD_S and failure model MOD_F.
+   The failure path only performs the LR, so an acquiring failure model
+   adds an acquire to a releasing success model.  */
+
+enum memmodel
+riscv_union_memmodels (enum memmodel mod_s, enum memmodel mod_f)
+{
+  mod_s = memmodel_base (mod_s);
+  mod_f = memmodel_base (mod_f);
+
+  if (is_mm_seq_cst (mod_s) || is_mm_seq_cst (mod_f))
+    return MEMMODEL_SEQ_CST;
+  if (!riscv_memmodel_needs_amo_acquire (mod_f))
+    return mod_s;
+  if (is_mm_release (mod_s))
+    return MEMMODEL_ACQ_REL;
+  if (is_mm_relaxed (mod_s))
+    return MEMMODEL_ACQUIRE;
+  return mod_s;
+}
+
+/* MEM is a QImode or HImode memory reference.  Set *ALIGNED_MEM to the
+   naturally-aligned SImode word that contains it, *SHIFT to the bit offset
+   of MEM within that word, and *MASK and *NOT_MASK to the bits that MEM
+   does and does not cover.  All outputs other than *ALIGNED_MEM are new
+   SImode pseudos.  */
+
+void
+riscv_subword_address (rtx mem, rtx *aligned_mem, rtx *shift, rtx *mask,
+		       rtx *not_mask)
+{
+  machine_mode mode = GET_MODE (mem);
+  rtx addr = force_reg (Pmode, XEXP (mem, 0));
+
+  rtx aligned_addr = gen_reg_rtx (Pmode);
+  emit_move_insn (aligned_addr, gen_rtx_AND (Pmode, addr, GEN_INT (-4)));
+
+  *aligned_mem = change_address (mem, SImode, aligned_addr);
+  set_mem_alias_set (*aligned_mem, 0);
+
+  rtx offset = gen_reg_rtx (SImode);
+  emit_move_insn (offset, gen_rtx_AND (SImode, gen_lowpart (SImode, addr),
+				       GEN_INT (3)));
+  if (TARGET_BIG_ENDIAN)
+    emit_move_insn (offset,
+		    gen_rtx_XOR (SImode, offset,
+				 GEN_INT (4 - GET_MODE_SIZE (mode))));
+
+  *shift = gen_reg_rtx (SImode);
+  emit_move_insn (*shift, gen_rtx_ASHIFT (SImode, offset, GEN_INT (3)));
+
+  *mask = gen_reg_rtx (SImode);
+  emit_move_insn (*mask, gen_int_mode (GET_MODE_MASK (mode), SImode));
+  emit_move_insn (*mask, gen_rtx_ASHIFT (SImode, *mask,
+					 gen_lowpart (QImode, *shift)));
+
+  *not_mask = gen_reg_rtx (SImode);
+  emit_move_insn (*not_mask, gen_rtx_NOT (SImode, *mask));
+}
+
+/* Return a new SImode pseudo holding the QImode or HImode value VALUE
+   shifted left by SHIFT bits, as computed by riscv_subword_address.
+   Bits above the subword are unspecified.  */
+
+rtx
+riscv_lshift_subword (rtx value, rtx shift)
+{
+  rtx value_reg = gen_reg_rtx (SImode);
+  emit_move_insn (value_reg, gen_lowpart (SImode, value));
+
+  rtx shifted_value = gen_reg_rtx (SImode);
+  emit_move_insn (shifted_value,
+		  gen_rtx_ASHIFT (SImode, value_reg,
+				  gen_lowpart (QImode, shift)));
+  return shifted_value;
+}
+
+/* Implement TARGET_PRINT_OPERAND.  The RISCV-specific operand codes are:
+
+   'h'	Print the high-part relocation associated with OP, after stripping
+	  any outermost HIGH.
+   'R'	Print the low-part relocation associated with OP.
+   'C'	Print the integer branch condition for comparison OP.
+   'A'	Print the AMO ordering suffix for memory model OP.
+   'I'	Print the LR ordering suffix for memory model OP.
+   'J'	Print the SC ordering suffix for memory model OP.
+   'z'	Print x0 if OP is zero, otherwise print OP normally.
+   'i'	Print i if the operand is not a register.
+   'S'	Print the index of the single set bit in OP.
+   'T'	Print the index of the single clear bit in OP.
+   'v'	Print the element of the duplicated vector constant OP.  */
+
+static void
+riscv_print_operand (FILE *file, rtx op, int letter)
+{
+  machine_mode mode = GET_MODE (op);
+  enum rtx_code code = GET_CODE (op);
+
+  switch (letter)
+    {
+    case 'h':
+      if (code == HIGH)
+	op = XEXP (op, 0);
+      riscv_print_operand_reloc (file, op, true);
+      break;
+
+    case 'R':
+      riscv_print_operand_reloc (file, op, false);
+      break;
+
+    case 'C':
+      /* The RTL names match the instruction names. */
+      fputs (GET_RTX_NAME (code), file);
+      break;
+
+    case 'A':
+      /* Ztso makes every AMO sequentially consistent already.  */
+      if (TARGET_ZTSO)
+	break;
+      if (riscv_memmodel_needs_amo_acquire ((enum memmodel) INTVAL (op)))
+	fputs (".aq", file);
+      if (riscv_memmodel_needs_amo_release ((enum memmodel) INTVAL (op)))
+	fputs (riscv_memmodel_needs_amo_acquire ((enum memmodel) INTVAL (op))
+	       ? "rl" : ".rl", file);
+      break;
+
+    case 'I':
+      if (TARGET_ZTSO)
+	break;
+      if (is_mm_seq_cst (memmodel_base (INTVAL (op))))
+	fputs (".aqrl", file);
+      else if (riscv_memmodel_needs_amo_acquire ((enum memmodel) INTVAL (op)))
+	fputs (".aq", file);
+      break;
+
+    case 'J':
+      if (TARGET_ZTSO)
+	break;
+      if (riscv_memmodel_needs_amo_release ((enum memmodel) INTVAL (op)))
+	fputs (".rl", file);
+      break;
+
+    case 'i':
       if (code != REG)
         fputs ("i", file);
       break;
 
+    case 'S':
+      fprintf (file, "%d", ctz_hwi (INTVAL (op)));
+      break;
+
+    case 'T':
+      fprintf (file, "%d", ctz_hwi (~INTVAL (op)));
+      break;
+
+    case 'v':
+      {
+	rtx elt;
+
+	if (!const_vec_duplicate_p (op, &elt) || !CONST_INT_P (elt))
+	  output_operand_lossage ("invalid vector constant");
+	else
+	  fprintf (file, HOST_WIDE_INT_PRINT_DEC, INTVAL (elt));
+	break;
+      }
+
     default:
       switch (code)
 	{
@@ -3629,10 +5429,92 @@ riscv_frame_set (rtx mem, rtx reg)
   return set;
 }
 
-/* Return true if the current function must save register REGNO.  */
+/* Return true if the current function is an interrupt handler that
+   saves and restores FPRs only when the interrupted code has the FPU
+   enabled.  */
 
 static bool
-riscv_save_reg_p (unsigned int regno)
+riscv_lazy_fp_p (void)
+{
+  return (riscv_minterrupt_lazy_fp
+	  && cfun->machine->interrupt_handler_p
+	  && cfun->machine->frame.fmask != 0);
+}
+
+/* Return the assembly for the lazy_fp_save and lazy_fp_restore patterns,
+   which save or restore the FPRs in the frame only if the FS field of
+   the status CSR is not Off.  When it is Off, the interrupted code has
+   no live FPR state, and FPR accesses would trap.  SP_OFFSET is as for
+   riscv_for_each_saved_reg.  */
+
+const char *
+riscv_output_lazy_fp (rtx sp_offset, bool restore)
+{
+  machine_mode mode = TARGET_DOUBLE_FLOAT ? DFmode : SFmode;
+  HOST_WIDE_INT offset
+    = cfun->machine->frame.fp_sp_offset - INTVAL (sp_offset);
+  const char *insn, *csr;
+  char buffer[64];
+
+  switch (cfun->machine->interrupt_mode)
+    {
+    case USER_MODE:
+      csr = "ustatus";
+      break;
+    case SUPERVISOR_MODE:
+      csr = "sstatus";
+      break;
+    default:
+      csr = "mstatus";
+      break;
+    }
+
+  if (restore)
+    insn = TARGET_DOUBLE_FLOAT ? "fld" : "flw";
+  else
+    insn = TARGET_DOUBLE_FLOAT ? "fsd" : "fsw";
+
+  snprintf (buffer, sizeof (buffer), "csrr\tt0,%s", csr);
+  output_asm_insn (buffer, NULL);
+  output_asm_insn ("srli\tt0,t0,13", NULL);
+  output_asm_insn ("andi\tt0,t0,3", NULL);
+  output_asm_insn ("beqz\tt0,1f", NULL);
+
+  for (unsigned int regno = FP_REG_FIRST; regno <= FP_REG_LAST; regno++)
+    if (BITSET_P (cfun->machine->frame.fmask, regno - FP_REG_FIRST))
+      {
+	snprintf (buffer, sizeof (buffer),
+		  "%s\t%s," HOST_WIDE_INT_PRINT_DEC "(sp)",
+		  insn, reg_names[regno], offset);
+	output_asm_insn (buffer, NULL);
+	offset -= GET_MODE_SIZE (mode);
+      }
+
+  return "1:";
+}
+
+/* Return the set of registers that the calls in the current function
+   might clobber.  With -fipa-ra, a call to a function that has already
+   been compiled only clobbers the registers that function uses.  */
+
+static HARD_REG_SET
+riscv_call_clobbers (void)
+{
+  HARD_REG_SET clobbers = fixed_reg_set;
+
+  for (rtx_insn *insn = get_insns (); insn; insn = NEXT_INSN (insn))
+    if (CALL_P (insn))
+      clobbers |= insn_callee_abi (insn).full_and_partial_reg_clobbers ();
+
+  return clobbers;
+}
+
+/* Return true if the current function must save register REGNO.
+   CALL_CLOBBERS is the set of registers that the function's calls
+   might clobber, as computed by riscv_call_clobbers.  */
+
+static bool
+riscv_save_reg_p (unsigned int regno, const_hard_reg_set call_clobbers)
 {
   bool call_saved = !global_regs[regno] && !call_used_or_fixed_reg_p (regno);
   bool might_clobber = crtl->saves_all_registers
@@ -3663,26 +5545,63 @@ riscv_save_reg_p (unsigned int regno)
 	return false;
 
       /* We must save every register used in this function.  If this is not a
-	 leaf function, then we must save all temporary registers.  */
+	 leaf function, then we must also save the temporary registers that
+	 its callees might clobber.  */
       if (df_regs_ever_live_p (regno)
-	  || (!crtl->is_leaf && call_used_or_fixed_reg_p (regno)))
+	  || (!crtl->is_leaf && TEST_HARD_REG_BIT (call_clobbers, regno)))
 	return true;
     }
 
   return false;
 }
 
-/* Determine whether to call GPR save/restore routines.  */
+/* Return true if -msave-restore applies to the current function.
+   The save/restore routines trade speed for size, so a function that the
+   profile or a "hot" attribute marks as hot saves its registers inline.  */
+
+static bool
+riscv_save_restore_p (void)
+{
+  if (!TARGET_SAVE_RESTORE)
+    return false;
+
+  cgraph_node *node = cgraph_node::get (current_function_decl);
+  return !node || node->frequency != NODE_FREQUENCY_HOT;
+}
+
+/* Return true if the GPRs can be saved with the Zcmp cm.push instruction
+   and restored with cm.popret.  These save and restore the same registers
+   as the -msave-restore routines, without the calls, so they are used
+   whenever they are available.  */
+
+static bool
+riscv_zcmp_p (void)
+{
+  return TARGET_ZCMP && !TARGET_RVE;
+}
+
+/* Determine whether to call GPR save/restore routines, or to use the
+   Zcmp push and pop instructions in their place.  */
 static bool
 riscv_use_save_libcall (const struct riscv_frame_info *frame)
 {
-  if (!TARGET_SAVE_RESTORE || crtl->calls_eh_return || frame_pointer_needed
+  if (!(riscv_zcmp_p () || riscv_save_restore_p ())
+      || crtl->calls_eh_return || frame_pointer_needed
       || cfun->machine->interrupt_handler_p)
     return false;
 
   return frame->save_libcall_adjustment != 0;
 }
 
+/* Return true if FRAME's GPRs are saved with cm.push and restored with
+   cm.popret.  */
+
+static bool
+riscv_use_push_pop_p (const struct riscv_frame_info *frame)
+{
+  return riscv_zcmp_p () && riscv_use_save_libcall (frame);
+}
+
 /* Determine which GPR save/restore routine to call.  */
 
 static unsigned
@@ -3745,6 +5664,7 @@ riscv_compute_frame_info (void)
   HOST_WIDE_INT offset;
   bool interrupt_save_prologue_temp = false;
   unsigned int regno, i, num_x_saved = 0, num_f_saved = 0;
+  HARD_REG_SET call_clobbers;
 
   frame = &cfun->machine->frame;
 
@@ -3759,11 +5679,16 @@ riscv_compute_frame_info (void)
 
   memset (frame, 0, sizeof (*frame));
 
+  if (cfun->machine->interrupt_handler_p && !crtl->is_leaf)
+    call_clobbers = riscv_call_clobbers ();
+  else
+    CLEAR_HARD_REG_SET (call_clobbers);
+
   if (!cfun->machine->naked_p)
     {
       /* Find out which GPRs we need to save.  */
       for (regno = GP_REG_FIRST; regno <= GP_REG_LAST; regno++)
-	if (riscv_save_reg_p (regno)
+	if (riscv_save_reg_p (regno, call_clobbers)
 	    || (interrupt_save_prologue_temp
 		&& (regno == RISCV_PROLOGUE_TEMP_REGNUM)))
 	  frame->mask |= 1 << (regno - GP_REG_FIRST), num_x_saved++;
@@ -3778,8 +5703,34 @@ riscv_compute_frame_info (void)
 	 the same space as its companion in riscv_for_each_saved_reg.  */
       if (TARGET_HARD_FLOAT)
 	for (regno = FP_REG_FIRST; regno <= FP_REG_LAST; regno++)
-	  if (riscv_save_reg_p (regno))
+	  if (riscv_save_reg_p (regno, call_clobbers))
 	    frame->fmask |= 1 << (regno - FP_REG_FIRST), num_f_saved++;
+
+      /* The lazy FPR save and restore read the status CSR into the
+	 prologue temporary.  */
+      if (riscv_lazy_fp_p ()
+	  && !BITSET_P (frame->mask, RISCV_PROLOGUE_TEMP_REGNUM))
+	frame->mask |= 1 << RISCV_PROLOGUE_TEMP_REGNUM, num_x_saved++;
+
+      /* cm.push saves ra and every s-register up to the highest one we
+	 need, and has no form that stops at s10.  Save the same set here
+	 so that the slots match those riscv_for_each_saved_reg uses.  */
+      if (frame->mask != 0
+	  && riscv_zcmp_p ()
+	  && !crtl->calls_eh_return
+	  && !frame_pointer_needed
+	  && !cfun->machine->interrupt_handler_p)
+	{
+	  unsigned count = riscv_save_libcall_count (frame->mask);
+	  if (count == 11)
+	    count = 12;
+
+	  frame->mask |= 1 << RETURN_ADDR_REGNUM;
+	  for (regno = GP_REG_FIRST; regno <= GP_REG_LAST; regno++)
+	    if (IN_RANGE (CALLEE_SAVED_REG_NUMBER (regno), 0, count - 1))
+	      frame->mask |= 1 << (regno - GP_REG_FIRST);
+	  num_x_saved = popcount_hwi (frame->mask);
+	}
     }
 
   /* At the bottom of the frame are any outgoing stack arguments. */
@@ -3921,35 +5872,55 @@ riscv_for_each_saved_reg (HOST_WIDE_INT sp_offset, riscv_save_restore_fn fn,
 {
   HOST_WIDE_INT offset;
 
-  /* Save the link register and s-registers. */
+  /* The lazy FPR restore needs the prologue temporary, so it must come
+     before the GPRs are restored.  */
+  if (epilogue && riscv_lazy_fp_p ())
+    emit_insn (gen_lazy_fp_restore (GEN_INT (sp_offset)));
+
+  /* Save the link register and s-registers.  cm.push stores them in
+     the opposite order, with the highest register number at the top.  */
+  bool push_order_p = riscv_use_push_pop_p (&cfun->machine->frame);
   offset = cfun->machine->frame.gp_sp_offset - sp_offset;
-  for (unsigned int regno = GP_REG_FIRST; regno <= GP_REG_LAST; regno++)
-    if (BITSET_P (cfun->machine->frame.mask, regno - GP_REG_FIRST))
-      {
-	bool handle_reg = TRUE;
-
-	/* If this is a normal return in a function that calls the eh_return
-	   builtin, then do not restore the eh return data registers as that
-	   would clobber the return value.  But we do still need to save them
-	   in the prologue, and restore them for an exception return, so we
-	   need special handling here.  */
-	if (epilogue && !maybe_eh_return && crtl->calls_eh_return)
-	  {
-	    unsigned int i, regnum;
+  for (unsigned int n = GP_REG_FIRST; n <= GP_REG_LAST; n++)
+    {
+      unsigned int regno = push_order_p ? GP_REG_LAST + GP_REG_FIRST - n : n;
+      if (!BITSET_P (cfun->machine->frame.mask, regno - GP_REG_FIRST))
+	continue;
+
+      bool handle_reg = TRUE;
+
+      /* If this is a normal return in a function that calls the eh_return
+	 builtin, then do not restore the eh return data registers as that
+	 would clobber the return value.  But we do still need to save them
+	 in the prologue, and restore them for an exception return, so we
+	 need special handling here.  */
+      if (epilogue && !maybe_eh_return && crtl->calls_eh_return)
+	{
+	  unsigned int i, regnum;
 
-	    for (i = 0; (regnum = EH_RETURN_DATA_REGNO (i)) != INVALID_REGNUM;
-		 i++)
-	      if (regno == regnum)
-		{
-		  handle_reg = FALSE;
-		  break;
-		}
-	  }
+	  for (i = 0; (regnum = EH_RETURN_DATA_REGNO (i)) != INVALID_REGNUM;
+	       i++)
+	    if (regno == regnum)
+	      {
+		handle_reg = FALSE;
+		break;
+	      }
+	}
 
-	if (handle_reg)
-	  riscv_save_restore_reg (word_mode, regno, offset, fn);
-	offset -= UNITS_PER_WORD;
-      }
+      if (cfun->machine->reg_is_wrapped_separately[regno])
+	handle_reg = FALSE;
+
+      if (handle_reg)
+	riscv_save_restore_reg (word_mode, regno, offset, fn);
+      offset -= UNITS_PER_WORD;
+    }
+
+  if (riscv_lazy_fp_p ())
+    {
+      if (!epilogue)
+	emit_insn (gen_lazy_fp_save (GEN_INT (sp_offset)));
+      return;
+    }
 
   /* This loop must iterate over the same space as its companion in
      riscv_compute_frame_info.  */
@@ -3959,7 +5930,8 @@ riscv_for_each_saved_reg (HOST_WIDE_INT sp_offset, riscv_save_restore_fn fn,
       {
 	machine_mode mode = TARGET_DOUBLE_FLOAT ? DFmode : SFmode;
 
-	riscv_save_restore_reg (mode, regno, offset, fn);
+	if (!cfun->machine->reg_is_wrapped_separately[regno])
+	  riscv_save_restore_reg (mode, regno, offset, fn);
 	offset -= GET_MODE_SIZE (mode);
       }
 }
@@ -4036,19 +6008,27 @@ riscv_first_stack_step (struct riscv_frame_info *frame)
   return max_first_step;
 }
 
+/* Return the CFI notes for a GPR save routine call or cm.push that
+   decrements the stack pointer by SAVED_SIZE.  */
+
 static rtx
-riscv_adjust_libcall_cfi_prologue ()
+riscv_adjust_libcall_cfi_prologue (HOST_WIDE_INT saved_size)
 {
   rtx dwarf = NULL_RTX;
   rtx adjust_sp_rtx, reg, mem, insn;
-  int saved_size = cfun->machine->frame.save_libcall_adjustment;
-  int offset;
+  HOST_WIDE_INT offset;
+  unsigned count = riscv_save_libcall_count (cfun->machine->frame.mask);
 
   for (int regno = GP_REG_FIRST; regno <= GP_REG_LAST; regno++)
     if (BITSET_P (cfun->machine->frame.mask, regno - GP_REG_FIRST))
       {
-	/* The save order is ra, s0, s1, s2 to s11.  */
-	if (regno == RETURN_ADDR_REGNUM)
+	/* The save order is ra, s0, s1, s2 to s11, except that cm.push
+	   saves the last s-register first and ra last.  */
+	if (riscv_zcmp_p ())
+	  offset = (saved_size
+		    - ((int) count - CALLEE_SAVED_REG_NUMBER (regno))
+		      * UNITS_PER_WORD);
+	else if (regno == RETURN_ADDR_REGNUM)
 	  offset = saved_size - UNITS_PER_WORD;
 	else if (regno == S0_REGNUM)
 	  offset = saved_size - UNITS_PER_WORD * 2;
@@ -4099,14 +6079,26 @@ riscv_expand_prologue (void)
   if (cfun->machine->naked_p)
     return;
 
-  /* When optimizing for size, call a subroutine to save the registers.  */
+  /* When optimizing for size, call a subroutine to save the registers.
+     Zcmp does the same with cm.push, which can also allocate a small
+     remainder of the frame.  */
   if (riscv_use_save_libcall (frame))
     {
-      rtx dwarf = NULL_RTX;
-      dwarf = riscv_adjust_libcall_cfi_prologue ();
+      HOST_WIDE_INT saved_size = frame->save_libcall_adjustment;
 
-      size -= frame->save_libcall_adjustment;
-      insn = emit_insn (riscv_gen_gpr_save_insn (frame));
+      size -= saved_size;
+      if (riscv_zcmp_p ())
+	{
+	  if (size <= ZCMP_MAX_EXTRA_ADJUSTMENT)
+	    {
+	      saved_size += size;
+	      size = 0;
+	    }
+	  insn = emit_insn (riscv_gen_gpr_push_insn (frame, saved_size));
+	}
+      else
+	insn = emit_insn (riscv_gen_gpr_save_insn (frame));
+      rtx dwarf = riscv_adjust_libcall_cfi_prologue (saved_size);
       frame->mask = 0; /* Temporarily fib that we need not save GPRs.  */
 
       RTX_FRAME_RELATED_P (insn) = 1;
@@ -4118,11 +6110,14 @@ riscv_expand_prologue (void)
     {
       HOST_WIDE_INT step1 = MIN (size, riscv_first_stack_step (frame));
 
-      insn = gen_add3_insn (stack_pointer_rtx,
-			    stack_pointer_rtx,
-			    GEN_INT (-step1));
-      RTX_FRAME_RELATED_P (emit_insn (insn)) = 1;
-      size -= step1;
+      if (step1 > 0)
+	{
+	  insn = gen_add3_insn (stack_pointer_rtx,
+				stack_pointer_rtx,
+				GEN_INT (-step1));
+	  RTX_FRAME_RELATED_P (emit_insn (insn)) = 1;
+	  size -= step1;
+	}
       riscv_for_each_saved_reg (size, riscv_save_reg, false, false);
     }
 
@@ -4162,12 +6157,14 @@ riscv_expand_prologue (void)
     }
 }
 
+/* Return the CFI notes for a GPR restore routine call or cm.popret that
+   increments the stack pointer by SAVED_SIZE.  */
+
 static rtx
-riscv_adjust_libcall_cfi_epilogue ()
+riscv_adjust_libcall_cfi_epilogue (HOST_WIDE_INT saved_size)
 {
   rtx dwarf = NULL_RTX;
   rtx adjust_sp_rtx, reg;
-  int saved_size = cfun->machine->frame.save_libcall_adjustment;
 
   /* Debug info for adjust sp.  */
   adjust_sp_rtx = gen_add3_insn (stack_pointer_rtx,
@@ -4305,11 +6302,20 @@ riscv_expand_epilogue (int style)
   riscv_for_each_saved_reg (frame->total_size - step2, riscv_restore_reg,
 			    true, style == EXCEPTION_RETURN);
 
+  HOST_WIDE_INT restore_size = 0;
   if (use_restore_libcall)
     {
       frame->mask = mask; /* Undo the above fib.  */
       gcc_assert (step2 >= frame->save_libcall_adjustment);
-      step2 -= frame->save_libcall_adjustment;
+      restore_size = frame->save_libcall_adjustment;
+      step2 -= restore_size;
+
+      /* cm.popret can also deallocate a small remainder of the frame.  */
+      if (riscv_zcmp_p () && step2 <= ZCMP_MAX_EXTRA_ADJUSTMENT)
+	{
+	  restore_size += step2;
+	  step2 = 0;
+	}
     }
 
   if (need_barrier_p)
@@ -4330,9 +6336,20 @@ riscv_expand_epilogue (int style)
       REG_NOTES (insn) = dwarf;
     }
 
+  if (use_restore_libcall && riscv_zcmp_p ())
+    {
+      rtx dwarf = riscv_adjust_libcall_cfi_epilogue (restore_size);
+      insn = emit_jump_insn (gen_gpr_pop_return
+			       (GEN_INT (riscv_save_libcall_count (mask)),
+				GEN_INT (restore_size), ra));
+      RTX_FRAME_RELATED_P (insn) = 1;
+      REG_NOTES (insn) = dwarf;
+      return;
+    }
+
   if (use_restore_libcall)
     {
-      rtx dwarf = riscv_adjust_libcall_cfi_epilogue ();
+      rtx dwarf = riscv_adjust_libcall_cfi_epilogue (restore_size);
       insn = emit_insn (gen_gpr_restore (GEN_INT (riscv_save_libcall_count (mask))));
       RTX_FRAME_RELATED_P (insn) = 1;
       REG_NOTES (insn) = dwarf;
@@ -4381,18 +6398,168 @@ riscv_epilogue_uses (unsigned int regno)
 	return true;
     }
 
-  return false;
+  return false;
+}
+
+/* Return nonzero if this function is known to have a null epilogue.
+   This allows the optimizer to omit jumps to jumps if no stack
+   was created.  */
+
+bool
+riscv_can_use_return_insn (void)
+{
+  return (reload_completed && cfun->machine->frame.total_size == 0
+	  && ! cfun->machine->interrupt_handler_p);
+}
+
+/* Implement TARGET_SHRINK_WRAP_GET_SEPARATE_COMPONENTS.  Each callee-saved
+   register is a separate component, identified by its register number.  */
+
+static sbitmap
+riscv_get_separate_components (void)
+{
+  struct riscv_frame_info *frame = &cfun->machine->frame;
+  sbitmap components = sbitmap_alloc (FIRST_PSEUDO_REGISTER);
+  bitmap_clear (components);
+
+  /* The save/restore routines handle all GPRs at once, interrupt handlers
+     must save everything up front, and the save slots are addressed from
+     the stack pointer, which alloca and eh_return move.  */
+  if (riscv_use_save_libcall (frame)
+      || cfun->machine->interrupt_handler_p
+      || cfun->calls_alloca
+      || crtl->calls_eh_return)
+    return components;
+
+  /* Only registers whose save slot is directly addressable from the final
+     stack pointer can be handled: no temporary is available for larger
+     offsets.  */
+  HOST_WIDE_INT offset = frame->gp_sp_offset;
+  for (unsigned int regno = GP_REG_FIRST; regno <= GP_REG_LAST; regno++)
+    if (BITSET_P (frame->mask, regno - GP_REG_FIRST))
+      {
+	if (SMALL_OPERAND (offset))
+	  bitmap_set_bit (components, regno);
+	offset -= UNITS_PER_WORD;
+      }
+
+  offset = frame->fp_sp_offset;
+  for (unsigned int regno = FP_REG_FIRST; regno <= FP_REG_LAST; regno++)
+    if (BITSET_P (frame->fmask, regno - FP_REG_FIRST))
+      {
+	machine_mode mode = TARGET_DOUBLE_FLOAT ? DFmode : SFmode;
+
+	if (SMALL_OPERAND (offset))
+	  bitmap_set_bit (components, regno);
+	offset -= GET_MODE_SIZE (mode);
+      }
+
+  /* The prologue sets up the frame pointer from its saved value, and the
+     return address is needed by every return path.  */
+  if (frame_pointer_needed)
+    bitmap_clear_bit (components, HARD_FRAME_POINTER_REGNUM);
+  bitmap_clear_bit (components, RETURN_ADDR_REGNUM);
+
+  return components;
+}
+
+/* Implement TARGET_SHRINK_WRAP_COMPONENTS_FOR_BB.  */
+
+static sbitmap
+riscv_components_for_bb (basic_block bb)
+{
+  bitmap in = DF_LIVE_IN (bb);
+  bitmap gen = &DF_LIVE_BB_INFO (bb)->gen;
+  bitmap kill = &DF_LIVE_BB_INFO (bb)->kill;
+
+  sbitmap components = sbitmap_alloc (FIRST_PSEUDO_REGISTER);
+  bitmap_clear (components);
+
+  /* A call to a function with a different ABI may clobber registers that
+     are callee-saved for this function.  */
+  function_abi_aggregator callee_abis;
+  rtx_insn *insn;
+  FOR_BB_INSNS (bb, insn)
+    if (CALL_P (insn))
+      callee_abis.note_callee_abi (insn_callee_abi (insn));
+  HARD_REG_SET extra_caller_saves = callee_abis.caller_save_regs (*crtl->abi);
+
+  /* A register is used in BB if it is live on entry, set or clobbered.  */
+  for (unsigned int regno = 0; regno < FIRST_PSEUDO_REGISTER; regno++)
+    if ((GP_REG_P (regno) || FP_REG_P (regno))
+	&& !fixed_regs[regno]
+	&& !crtl->abi->clobbers_full_reg_p (regno)
+	&& (TEST_HARD_REG_BIT (extra_caller_saves, regno)
+	    || bitmap_bit_p (in, regno)
+	    || bitmap_bit_p (gen, regno)
+	    || bitmap_bit_p (kill, regno)))
+      bitmap_set_bit (components, regno);
+
+  return components;
+}
+
+/* Implement TARGET_SHRINK_WRAP_DISQUALIFY_COMPONENTS.  */
+
+static void
+riscv_disqualify_components (sbitmap, edge, sbitmap, bool)
+{
+  /* Every component can be saved or restored on any edge.  */
+}
+
+/* Save the registers in COMPONENTS if PROLOGUE_P, otherwise restore
+   them.  */
+
+static void
+riscv_process_components (sbitmap components, bool prologue_p)
+{
+  struct riscv_frame_info *frame = &cfun->machine->frame;
+  riscv_save_restore_fn fn = prologue_p ? riscv_save_reg : riscv_restore_reg;
+
+  HOST_WIDE_INT offset = frame->gp_sp_offset;
+  for (unsigned int regno = GP_REG_FIRST; regno <= GP_REG_LAST; regno++)
+    if (BITSET_P (frame->mask, regno - GP_REG_FIRST))
+      {
+	if (bitmap_bit_p (components, regno))
+	  riscv_save_restore_reg (word_mode, regno, offset, fn);
+	offset -= UNITS_PER_WORD;
+      }
+
+  offset = frame->fp_sp_offset;
+  for (unsigned int regno = FP_REG_FIRST; regno <= FP_REG_LAST; regno++)
+    if (BITSET_P (frame->fmask, regno - FP_REG_FIRST))
+      {
+	machine_mode mode = TARGET_DOUBLE_FLOAT ? DFmode : SFmode;
+
+	if (bitmap_bit_p (components, regno))
+	  riscv_save_restore_reg (mode, regno, offset, fn);
+	offset -= GET_MODE_SIZE (mode);
+      }
+}
+
+/* Implement TARGET_SHRINK_WRAP_EMIT_PROLOGUE_COMPONENTS.  */
+
+static void
+riscv_emit_prologue_components (sbitmap components)
+{
+  riscv_process_components (components, true);
 }
 
-/* Return nonzero if this function is known to have a null epilogue.
-   This allows the optimizer to omit jumps to jumps if no stack
-   was created.  */
+/* Implement TARGET_SHRINK_WRAP_EMIT_EPILOGUE_COMPONENTS.  */
 
-bool
-riscv_can_use_return_insn (void)
+static void
+riscv_emit_epilogue_components (sbitmap components)
 {
-  return (reload_completed && cfun->machine->frame.total_size == 0
-	  && ! cfun->machine->interrupt_handler_p);
+  riscv_process_components (components, false);
+}
+
+/* Implement TARGET_SHRINK_WRAP_SET_HANDLED_COMPONENTS.  */
+
+static void
+riscv_set_handled_components (sbitmap components)
+{
+  for (unsigned int regno = 0; regno < FIRST_PSEUDO_REGISTER; regno++)
+    if (bitmap_bit_p (components, regno))
+      cfun->machine->reg_is_wrapped_separately[regno] = true;
 }
 
 /* Given that there exists at least one variable that is set (produced)
@@ -4491,8 +6658,14 @@ static bool
 riscv_secondary_memory_needed (machine_mode mode, reg_class_t class1,
 			       reg_class_t class2)
 {
-  return (GET_MODE_SIZE (mode) > UNITS_PER_WORD
-	  && (class1 == FP_REGS) != (class2 == FP_REGS));
+  /* There are no direct moves between vector registers and the other
+     register files for whole vectors.  */
+  if ((class1 == V_REGS) != (class2 == V_REGS))
+    return true;
+
+  bool fp1 = class1 == FP_REGS || class1 == RVC_FP_REGS;
+  bool fp2 = class2 == FP_REGS || class2 == RVC_FP_REGS;
+  return GET_MODE_SIZE (mode) > UNITS_PER_WORD && fp1 != fp2;
 }
 
 /* Implement TARGET_REGISTER_MOVE_COST.  */
@@ -4512,6 +6685,9 @@ riscv_hard_regno_nregs (unsigned int regno, machine_mode mode)
   if (FP_REG_P (regno))
     return (GET_MODE_SIZE (mode) + UNITS_PER_FP_REG - 1) / UNITS_PER_FP_REG;
 
+  if (V_REG_P (regno))
+    return (GET_MODE_SIZE (mode) + UNITS_PER_V_REG - 1) / UNITS_PER_V_REG;
+
   /* All other registers are word-sized.  */
   return (GET_MODE_SIZE (mode) + UNITS_PER_WORD - 1) / UNITS_PER_WORD;
 }
@@ -4523,6 +6699,12 @@ riscv_hard_regno_mode_ok (unsigned int regno, machine_mode mode)
 {
   unsigned int nregs = riscv_hard_regno_nregs (regno, mode);
 
+  /* Vector modes live only in vector registers.  */
+  if (V_REG_P (regno))
+    return riscv_vector_mode_p (mode) && nregs == 1;
+  else if (riscv_vector_mode_p (mode))
+    return false;
+
   if (GP_REG_P (regno))
     {
       if (!GP_REG_P (regno + nregs - 1))
@@ -4537,6 +6719,9 @@ riscv_hard_regno_mode_ok (unsigned int regno, machine_mode mode)
 	  && GET_MODE_CLASS (mode) != MODE_COMPLEX_FLOAT)
 	return false;
 
+      if (!riscv_fp_half_mode_ok_p (mode))
+	return false;
+
       /* Only use callee-saved registers if a potential callee is guaranteed
 	 to spill the requisite width.  */
       if (GET_MODE_UNIT_SIZE (mode) > UNITS_PER_FP_REG
@@ -4559,11 +6744,16 @@ riscv_hard_regno_mode_ok (unsigned int regno, machine_mode mode)
 /* Implement TARGET_MODES_TIEABLE_P.
 
    Don't allow floating-point modes to be tied, since type punning of
-   single-precision and double-precision is implementation defined.  */
+   single-precision and double-precision is implementation defined.
+   Vector modes can only be tied to other vector modes, since they
+   live in a separate register file.  */
 
 static bool
 riscv_modes_tieable_p (machine_mode mode1, machine_mode mode2)
 {
+  if (riscv_vector_mode_p (mode1) != riscv_vector_mode_p (mode2))
+    return false;
+
   return (mode1 == mode2
 	  || !(GET_MODE_CLASS (mode1) == MODE_FLOAT
 	       && GET_MODE_CLASS (mode2) == MODE_FLOAT));
@@ -4574,10 +6764,13 @@ riscv_modes_tieable_p (machine_mode mode1, machine_mode mode2)
 static unsigned char
 riscv_class_max_nregs (reg_class_t rclass, machine_mode mode)
 {
-  if (reg_class_subset_p (FP_REGS, rclass))
+  if (reg_classes_intersect_p (FP_REGS, rclass))
     return riscv_hard_regno_nregs (FP_REG_FIRST, mode);
 
-  if (reg_class_subset_p (GR_REGS, rclass))
+  if (reg_class_subset_p (V_REGS, rclass))
+    return riscv_hard_regno_nregs (V_REG_FIRST, mode);
+
+  if (reg_classes_intersect_p (GR_REGS, rclass))
     return riscv_hard_regno_nregs (GP_REG_FIRST, mode);
 
   return 0;
@@ -4600,6 +6793,207 @@ riscv_issue_rate (void)
   return tune_param->issue_rate;
 }
 
+/* Implement TARGET_SCHED_REASSOCIATION_WIDTH.  */
+
+static int
+riscv_sched_reassociation_width (unsigned int, machine_mode mode)
+{
+  if (FLOAT_MODE_P (mode))
+    return tune_param->fp_reassoc_width;
+  if (INTEGRAL_MODE_P (mode))
+    return tune_param->int_reassoc_width;
+  return 1;
+}
+
+/* Implement TARGET_LOOP_UNROLL_ADJUST.  Unrolling pays for the larger
+   loop body by letting more of it issue in parallel and by saving loop
+   branches; on a narrow in-order core only the latter is left, while
+   the larger body still costs instruction cache.  */
+
+static unsigned
+riscv_loop_unroll_adjust (unsigned nunroll, class loop *loop)
+{
+  if (tune_param->max_unroll_times)
+    nunroll = MIN (nunroll, tune_param->max_unroll_times);
+
+  /* Estimate the size of the loop, taking an instruction to be 3 bytes
+     on average when about half of them can be compressed.  */
+  if (tune_param->loop_buffer_size)
+    {
+      unsigned loop_bytes = MAX (loop->ninsns, 1) * (TARGET_RVC ? 3 : 4);
+      if (loop_bytes <= tune_param->loop_buffer_size)
+	nunroll = MIN (nunroll, tune_param->loop_buffer_size / loop_bytes);
+    }
+
+  return nunroll;
+}
+
+/* Implement LOOP_ALIGN.  A loop that fits in the loop buffer is only
+   fetched from memory on its first iteration, so aligning it would just
+   cost padding.  */
+
+align_flags
+riscv_loop_align (rtx label)
+{
+  if (!tune_param->loop_buffer_size || global_options_set.x_str_align_loops)
+    return align_loops;
+
+  basic_block bb = BLOCK_FOR_INSN (label);
+  if (!bb || !bb->loop_father || bb->loop_father->header != bb)
+    return align_loops;
+
+  /* Estimate the size as in riscv_loop_unroll_adjust.  */
+  unsigned loop_bytes = (MAX (num_loop_insns (bb->loop_father), 1)
+			 * (TARGET_RVC ? 3 : 4));
+  if (loop_bytes <= tune_param->loop_buffer_size)
+    return align_flags ();
+
+  return align_loops;
+}
+
+/* Return true if the current tuning fuses the pairs in OP.  */
+
+static bool
+riscv_fusion_enabled_p (enum riscv_fusion_pairs op)
+{
+  return tune_param->fusible_ops & op;
+}
+
+/* Implement TARGET_SCHED_MACRO_FUSION_P.  */
+
+static bool
+riscv_macro_fusion_p (void)
+{
+  return tune_param->fusible_ops != RISCV_FUSE_NOTHING;
+}
+
+/* Return true if SET loads a register from memory, possibly with a
+   zero or sign extension.  If so, store the address in *ADDR_PTR.  */
+
+static bool
+riscv_fusion_load_p (rtx set, rtx *addr_ptr)
+{
+  rtx src = SET_SRC (set);
+
+  if (!REG_P (SET_DEST (set)))
+    return false;
+
+  if (GET_CODE (src) == ZERO_EXTEND || GET_CODE (src) == SIGN_EXTEND)
+    src = XEXP (src, 0);
+  if (!MEM_P (src))
+    return false;
+
+  *addr_ptr = XEXP (src, 0);
+  return true;
+}
+
+/* Implement TARGET_SCHED_MACRO_FUSION_PAIR_P.  Return true if PREV and
+   CURR should be kept together during scheduling.  */
+
+static bool
+riscv_macro_fusion_pair_p (rtx_insn *prev, rtx_insn *curr)
+{
+  rtx prev_set = single_set (prev);
+  rtx curr_set = single_set (curr);
+  rtx addr;
+
+  if (!prev_set || !curr_set || any_condjump_p (curr))
+    return false;
+
+  rtx prev_dest = SET_DEST (prev_set);
+  rtx prev_src = SET_SRC (prev_set);
+  rtx curr_dest = SET_DEST (curr_set);
+  rtx curr_src = SET_SRC (curr_set);
+
+  if (!REG_P (prev_dest))
+    return false;
+
+  /* slli rd, rs, N; srli rd, rd, M.  */
+  if (GET_CODE (prev_src) == ASHIFT
+      && GET_CODE (curr_src) == LSHIFTRT
+      && REG_P (curr_dest)
+      && REGNO (curr_dest) == REGNO (prev_dest)
+      && REG_P (XEXP (curr_src, 0))
+      && REGNO (XEXP (curr_src, 0)) == REGNO (prev_dest)
+      && CONST_INT_P (XEXP (prev_src, 1))
+      && CONST_INT_P (XEXP (curr_src, 1)))
+    {
+      HOST_WIDE_INT left = INTVAL (XEXP (prev_src, 1));
+      HOST_WIDE_INT right = INTVAL (XEXP (curr_src, 1));
+      HOST_WIDE_INT bits = GET_MODE_BITSIZE (GET_MODE (curr_dest));
+
+      if (left == 32 && bits == 64)
+	{
+	  if (right == 32 && riscv_fusion_enabled_p (RISCV_FUSE_ZEXTW))
+	    return true;
+	  if (right < 32 && riscv_fusion_enabled_p (RISCV_FUSE_ZEXTWS))
+	    return true;
+	}
+      if (left == bits - 16 && right == bits - 16
+	  && riscv_fusion_enabled_p (RISCV_FUSE_ZEXTH))
+	return true;
+    }
+
+  /* add rd, rs1, rs2; l* rd2, 0(rd).  */
+  if (GET_CODE (prev_src) == PLUS
+      && REG_P (XEXP (prev_src, 0))
+      && REG_P (XEXP (prev_src, 1))
+      && riscv_fusion_enabled_p (RISCV_FUSE_LDINDEXED)
+      && riscv_fusion_load_p (curr_set, &addr)
+      && REG_P (addr)
+      && REGNO (addr) == REGNO (prev_dest))
+    return true;
+
+  /* lui rd, %hi(sym) or lui rd, imm.  */
+  if (GET_CODE (prev_src) == HIGH
+      || (CONST_INT_P (prev_src) && LUI_OPERAND (INTVAL (prev_src))))
+    {
+      /* addi rd, rd, %lo(sym) or addi rd, rd, imm.  */
+      if (riscv_fusion_enabled_p (RISCV_FUSE_LUI_ADDI)
+	  && REG_P (curr_dest)
+	  && REGNO (curr_dest) == REGNO (prev_dest)
+	  && (GET_CODE (curr_src) == LO_SUM
+	      || (GET_CODE (curr_src) == PLUS
+		  && CONST_INT_P (XEXP (curr_src, 1))
+		  && SMALL_OPERAND (INTVAL (XEXP (curr_src, 1)))))
+	  && REG_P (XEXP (curr_src, 0))
+	  && REGNO (XEXP (curr_src, 0)) == REGNO (prev_dest))
+	return true;
+
+      /* l* rd2, %lo(sym)(rd).  */
+      if (riscv_fusion_enabled_p (RISCV_FUSE_LUI_LD)
+	  && GET_CODE (prev_src) == HIGH
+	  && riscv_fusion_load_p (curr_set, &addr)
+	  && GET_CODE (addr) == LO_SUM
+	  && REG_P (XEXP (addr, 0))
+	  && REGNO (XEXP (addr, 0)) == REGNO (prev_dest))
+	return true;
+    }
+
+  /* auipc rd, %pcrel_hi(sym).  */
+  if (GET_CODE (prev_src) == UNSPEC && XINT (prev_src, 1) == UNSPEC_AUIPC)
+    {
+      /* addi rd, rd, %pcrel_lo(sym).  */
+      if (riscv_fusion_enabled_p (RISCV_FUSE_AUIPC_ADDI)
+	  && REG_P (curr_dest)
+	  && REGNO (curr_dest) == REGNO (prev_dest)
+	  && GET_CODE (curr_src) == LO_SUM
+	  && REG_P (XEXP (curr_src, 0))
+	  && REGNO (XEXP (curr_src, 0)) == REGNO (prev_dest))
+	return true;
+
+      /* l* rd2, %pcrel_lo(sym)(rd).  */
+      if (riscv_fusion_enabled_p (RISCV_FUSE_AUIPC_LD)
+	  && riscv_fusion_load_p (curr_set, &addr)
+	  && GET_CODE (addr) == LO_SUM
+	  && REG_P (XEXP (addr, 0))
+	  && REGNO (XEXP (addr, 0)) == REGNO (prev_dest))
+	return true;
+    }
+
+  return false;
+}
+
 /* Auxiliary function to emit RISC-V ELF attribute. */
 static void
 riscv_emit_attribute ()
@@ -4720,50 +7114,159 @@ riscv_init_machine_status (void)
   return ggc_cleared_alloc<machine_function> ();
 }
 
-/* Implement TARGET_OPTION_OVERRIDE.  */
+/* Set up the state that depends on the ISA and tuning options in OPTS,
+   either those of the command line or those of a function with a target
+   attribute.  OPTS_SET is as for OPTS.  */
 
 static void
-riscv_option_override (void)
+riscv_override_options_internal (struct gcc_options *opts,
+				 struct gcc_options *opts_set)
 {
   const struct riscv_tune_info *cpu;
 
-#ifdef SUBTARGET_OVERRIDE_OPTIONS
-  SUBTARGET_OVERRIDE_OPTIONS;
-#endif
-
-  flag_pcc_struct_return = 0;
-
-  if (flag_pic)
-    g_switch_value = 0;
-
   /* The presence of the M extension implies that division instructions
      are present, so include them unless explicitly disabled.  */
-  if (TARGET_MUL && (target_flags_explicit & MASK_DIV) == 0)
-    target_flags |= MASK_DIV;
-  else if (!TARGET_MUL && TARGET_DIV)
+  if ((opts->x_target_flags & MASK_MUL)
+      && (opts_set->x_target_flags & MASK_DIV) == 0)
+    opts->x_target_flags |= MASK_DIV;
+  else if (!(opts->x_target_flags & MASK_MUL)
+	   && (opts->x_target_flags & MASK_DIV))
     error ("%<-mdiv%> requires %<-march%> to subsume the %<M%> extension");
 
   /* Likewise floating-point division and square root.  */
-  if (TARGET_HARD_FLOAT && (target_flags_explicit & MASK_FDIV) == 0)
-    target_flags |= MASK_FDIV;
+  if ((opts->x_target_flags & MASK_HARD_FLOAT)
+      && (opts_set->x_target_flags & MASK_FDIV) == 0)
+    opts->x_target_flags |= MASK_FDIV;
 
   /* Handle -mtune, use -mcpu if -mtune is not given, and use default -mtune
      if -mtune and -mcpu both not not given.  */
-  cpu = riscv_parse_tune (riscv_tune_string ? riscv_tune_string :
-			  (riscv_cpu_string ? riscv_cpu_string :
-			   RISCV_TUNE_STRING_DEFAULT));
+  cpu = riscv_parse_tune (opts->x_riscv_tune_string
+			  ? opts->x_riscv_tune_string
+			  : (opts->x_riscv_cpu_string
+			     ? opts->x_riscv_cpu_string
+			     : RISCV_TUNE_STRING_DEFAULT));
   riscv_microarchitecture = cpu->microarchitecture;
-  tune_param = optimize_size ? &optimize_size_tune_info : cpu->tune_param;
+
+  /* -mtune-file overrides the parameters of the selected processor.  */
+  const struct riscv_tune_param *cpu_tune_param = cpu->tune_param;
+  if (opts->x_riscv_tune_file_string)
+    cpu_tune_param = riscv_read_tune_file (opts->x_riscv_tune_file_string,
+					   cpu_tune_param);
+  tune_param = (opts->x_optimize_size
+		? &optimize_size_tune_info : cpu_tune_param);
 
   /* Use -mtune's setting for slow_unaligned_access, even when optimizing
      for size.  For architectures that trap and emulate unaligned accesses,
      the performance cost is too great, even for -Os.  Similarly, if
      -m[no-]strict-align is left unspecified, heed -mtune's advice.  */
-  riscv_slow_unaligned_access_p = (cpu->tune_param->slow_unaligned_access
-				   || TARGET_STRICT_ALIGN);
-  if ((target_flags_explicit & MASK_STRICT_ALIGN) == 0
-      && cpu->tune_param->slow_unaligned_access)
-    target_flags |= MASK_STRICT_ALIGN;
+  riscv_slow_unaligned_access_p = (cpu_tune_param->slow_unaligned_access
+				   || (opts->x_target_flags
+				       & MASK_STRICT_ALIGN) != 0);
+  if ((opts_set->x_target_flags & MASK_STRICT_ALIGN) == 0
+      && cpu_tune_param->slow_unaligned_access)
+    opts->x_target_flags |= MASK_STRICT_ALIGN;
+
+  /* Describe the caches to the loop prefetching pass.  */
+  if (cpu_tune_param->simultaneous_prefetches)
+    SET_OPTION_IF_UNSET (opts, opts_set, param_simultaneous_prefetches,
+			 cpu_tune_param->simultaneous_prefetches);
+  if (cpu_tune_param->l1_cache_size)
+    SET_OPTION_IF_UNSET (opts, opts_set, param_l1_cache_size,
+			 cpu_tune_param->l1_cache_size);
+  if (cpu_tune_param->l1_cache_line_size)
+    SET_OPTION_IF_UNSET (opts, opts_set, param_l1_cache_line_size,
+			 cpu_tune_param->l1_cache_line_size);
+  if (cpu_tune_param->l2_cache_size)
+    SET_OPTION_IF_UNSET (opts, opts_set, param_l2_cache_size,
+			 cpu_tune_param->l2_cache_size);
+
+  /* Keep multiply-adds out of accumulation chains when a fused
+     multiply-add takes longer than the addition it would replace on
+     the chain.  The limit is a size in bits, so a slow DFmode FMA
+     also keeps SFmode ones out of the chains.  */
+  if (!opts->x_optimize_size)
+    {
+      unsigned int bits = 0;
+      if (cpu_tune_param->fp_fma[1] > cpu_tune_param->fp_add[1])
+	bits = 64;
+      else if (cpu_tune_param->fp_fma[0] > cpu_tune_param->fp_add[0])
+	bits = 32;
+      if (bits)
+	SET_OPTION_IF_UNSET (opts, opts_set, param_avoid_fma_max_bits, bits);
+    }
+
+  /* Keep the first scheduling pass from increasing register pressure
+     beyond what fits on cores that ask for it, and always with the
+     sixteen registers of RV32E, where the spills cost more than the
+     latencies that the scheduling hides.  */
+  unsigned int pressure = cpu_tune_param->sched_pressure;
+  if (opts->x_target_flags & MASK_RVE)
+    pressure = SCHED_PRESSURE_MODEL;
+  if (pressure && !opts_set->x_flag_sched_pressure)
+    {
+      opts->x_flag_sched_pressure = 1;
+      SET_OPTION_IF_UNSET (opts, opts_set, param_sched_pressure_algorithm,
+			   pressure);
+    }
+
+  /* Enable loop prefetching for the cores that benefit from it.  */
+  if (opts->x_flag_prefetch_loop_arrays < 0
+      && (opts->x_riscv_zi_subext & MASK_ZICBOP)
+      && !opts->x_optimize_size
+      && cpu_tune_param->prefetch_opt_level >= 0
+      && opts->x_optimize >= cpu_tune_param->prefetch_opt_level)
+    opts->x_flag_prefetch_loop_arrays = 1;
+
+  /* Align hot code to the fetch block.  Blocks that are optimized for
+     size, including the whole cold partition, are never aligned, so
+     this costs no space there.  Jump targets are only aligned when
+     that needs at most half a block of padding.  The assembler cannot
+     honor such a limit when relaxing, since it emits the worst-case
+     padding for the linker to trim with R_RISCV_ALIGN, so leave jump
+     targets alone then.  */
+  if (!opts->x_optimize_size && cpu_tune_param->fetch_block_size)
+    {
+      unsigned int size = cpu_tune_param->fetch_block_size;
+
+      if (opts->x_flag_align_functions && !opts->x_str_align_functions)
+	opts->x_str_align_functions = xasprintf ("%u", size);
+      if (opts->x_flag_align_loops && !opts->x_str_align_loops)
+	opts->x_str_align_loops = xasprintf ("%u", size);
+      if (opts->x_flag_align_jumps && !opts->x_str_align_jumps
+	  && !opts->x_riscv_mrelax)
+	opts->x_str_align_jumps = xasprintf ("%u:%u", size, size / 2 + 1);
+    }
+}
+
+/* Implement TARGET_OPTION_OVERRIDE.  */
+
+static void
+riscv_option_override (void)
+{
+#ifdef SUBTARGET_OVERRIDE_OPTIONS
+  SUBTARGET_OVERRIDE_OPTIONS;
+#endif
+
+  flag_pcc_struct_return = 0;
+
+  if (flag_pic)
+    g_switch_value = 0;
+
+  /* Small data is only cheaper to access once the linker relaxes
+     accesses to it into GP-relative ones.  Without relaxation, leave
+     small objects in the normal sections, where section anchors can
+     share one materialized base between them.  */
+  if (!riscv_mrelax && !global_options_set.x_g_switch_value)
+    g_switch_value = 0;
+
+  /* Register renaming moves the hottest chains into the registers that
+     RVC instructions can encode, so run it by default when generating
+     compressed code.  */
+  if (TARGET_RVC && optimize >= 2
+      && !global_options_set.x_flag_rename_registers)
+    flag_rename_registers = 1;
+
+  riscv_override_options_internal (&global_options, &global_options_set);
 
   /* If the user hasn't specified a branch cost, use the processor's
      default.  */
@@ -4866,6 +7369,124 @@ riscv_option_override (void)
       riscv_stack_protector_guard_offset = offs;
     }
 
+  /* Save the initial options in case the user does function specific
+     options.  */
+  target_option_default_node = target_option_current_node
+    = build_target_option_node (&global_options, &global_options_set);
+}
+
+/* Implement TARGET_OPTION_RESTORE.  */
+
+static void
+riscv_option_restore (struct gcc_options *opts,
+		      struct gcc_options *opts_set,
+		      struct cl_target_option *)
+{
+  riscv_override_options_internal (opts, opts_set);
+}
+
+/* Process one directive of a target attribute, from STR, into OPTS.
+   Return false after reporting an error if it is invalid.  */
+
+static bool
+riscv_process_one_target_attr (char *str, struct gcc_options *opts,
+			       location_t loc)
+{
+  if (strncmp (str, "arch=", 5) == 0)
+    {
+      int old_flags = opts->x_target_flags;
+      std::string isa = riscv_parse_target_arch (str + 5, opts, loc);
+      if (isa.empty ())
+	return false;
+
+      /* The ABI of the function may not change.  */
+      if ((opts->x_target_flags ^ old_flags) & MASK_64BIT)
+	{
+	  error_at (loc, "%<target(\"%s\")%> cannot change the XLEN", str);
+	  return false;
+	}
+
+      if (UNITS_PER_FP_ARG > ((opts->x_target_flags & MASK_DOUBLE_FLOAT) ? 8
+			      : (opts->x_target_flags & MASK_HARD_FLOAT) ? 4
+			      : 0))
+	{
+	  error_at (loc, "%<target(\"%s\")%> does not subsume the "
+		    "floating-point extension that the ABI requires", str);
+	  return false;
+	}
+
+      opts->x_riscv_arch_string = ggc_strdup (isa.c_str ());
+      return true;
+    }
+
+  if (strncmp (str, "tune=", 5) == 0)
+    {
+      opts->x_riscv_tune_string = ggc_strdup (str + 5);
+      return true;
+    }
+
+  error_at (loc, "attribute %<target(\"%s\")%> is unknown", str);
+  return false;
+}
+
+/* Process the target attribute arguments ARGS into OPTS.  Directives are
+   separated by semicolons.  Return false after reporting an error if any
+   of them is invalid.  */
+
+static bool
+riscv_process_target_attr (tree args, struct gcc_options *opts,
+			   location_t loc)
+{
+  if (TREE_CODE (args) == TREE_LIST)
+    {
+      for (; args; args = TREE_CHAIN (args))
+	if (TREE_VALUE (args)
+	    && !riscv_process_target_attr (TREE_VALUE (args), opts, loc))
+	  return false;
+      return true;
+    }
+
+  if (TREE_CODE (args) != STRING_CST)
+    {
+      error_at (loc, "attribute %<target%> argument not a string");
+      return false;
+    }
+
+  char *str = ASTRDUP (TREE_STRING_POINTER (args));
+  char *save;
+  for (char *token = strtok_r (str, ";", &save); token;
+       token = strtok_r (NULL, ";", &save))
+    if (!riscv_process_one_target_attr (token, opts, loc))
+      return false;
+
+  return true;
+}
+
+/* Implement TARGET_OPTION_VALID_ATTRIBUTE_P.  The attribute takes
+   "arch=" and "tune=" directives and is relative to the options of
+   the translation unit.  */
+
+static bool
+riscv_option_valid_attribute_p (tree fndecl, tree, tree args, int)
+{
+  struct cl_target_option cur_target;
+  location_t loc = DECL_SOURCE_LOCATION (fndecl);
+  bool ret;
+
+  cl_target_option_save (&cur_target, &global_options, &global_options_set);
+  cl_target_option_restore (&global_options, &global_options_set,
+			    TREE_TARGET_OPTION (target_option_default_node));
+
+  ret = riscv_process_target_attr (args, &global_options, loc);
+  if (ret)
+    {
+      riscv_override_options_internal (&global_options, &global_options_set);
+      DECL_FUNCTION_SPECIFIC_TARGET (fndecl)
+	= build_target_option_node (&global_options, &global_options_set);
+    }
+
+  cl_target_option_restore (&global_options, &global_options_set, &cur_target);
+  return ret;
 }
 
 /* Implement TARGET_CONDITIONAL_REGISTER_USAGE.  */
@@ -4898,6 +7519,12 @@ riscv_conditional_register_usage (void)
       for (int regno = FP_REG_FIRST; regno <= FP_REG_LAST; regno++)
 	call_used_regs[regno] = 1;
     }
+
+  if (!TARGET_VECTOR)
+    {
+      for (int regno = V_REG_FIRST; regno <= V_REG_LAST; regno++)
+	fixed_regs[regno] = call_used_regs[regno] = 1;
+    }
 }
 
 /* Return a register priority for hard reg REGNO.  */
@@ -4913,6 +7540,57 @@ riscv_register_priority (int regno)
   return 0;
 }
 
+/* Implement TARGET_PREFERRED_RENAME_CLASS.  Register renaming moves the
+   most frequently used chains into the registers that RVC instructions
+   can encode.  */
+
+static reg_class_t
+riscv_preferred_rename_class (reg_class_t rclass)
+{
+  if (!TARGET_RVC)
+    return NO_REGS;
+
+  if (rclass == GR_REGS)
+    return RVC_GR_REGS;
+
+  if (rclass == FP_REGS)
+    return RVC_FP_REGS;
+
+  return NO_REGS;
+}
+
+/* Write to the dump file how many of the general and floating-point
+   register references in the current function name a register that
+   RVC instructions can encode.  */
+
+static void
+riscv_dump_compressed_regs (void)
+{
+  unsigned int total = 0, compressed = 0;
+  rtx_insn *insn;
+
+  for (insn = get_insns (); insn; insn = NEXT_INSN (insn))
+    {
+      if (!NONDEBUG_INSN_P (insn))
+	continue;
+
+      subrtx_iterator::array_type array;
+      FOR_EACH_SUBRTX (iter, array, PATTERN (insn), NONCONST)
+	if (REG_P (*iter)
+	    && (GP_REG_P (REGNO (*iter)) || FP_REG_P (REGNO (*iter)))
+	    && REGNO (*iter) != GP_REG_FIRST)
+	  {
+	    total++;
+	    if (riscv_compressed_reg_p (REGNO (*iter)))
+	      compressed++;
+	  }
+    }
+
+  fprintf (dump_file, ";; RVC-encodable register references: %u of %u"
+	   " (%u%%)\n", compressed, total,
+	   total ? compressed * 100 / total : 0);
+}
+
 /* Implement TARGET_TRAMPOLINE_INIT.  */
 
 static void
@@ -5056,8 +7734,10 @@ static bool
 riscv_function_ok_for_sibcall (tree decl ATTRIBUTE_UNUSED,
 			       tree exp ATTRIBUTE_UNUSED)
 {
-  /* Don't use sibcalls when use save-restore routine.  */
-  if (TARGET_SAVE_RESTORE)
+  /* Don't use sibcalls when use save-restore routine.  The Zcmp push and
+     pop instructions replace the routines, and sibcall epilogues restore
+     the registers they save like any others.  */
+  if (riscv_save_restore_p () && !riscv_zcmp_p ())
     return false;
 
   /* Don't use sibcall for naked functions.  */
@@ -5102,11 +7782,48 @@ riscv_get_interrupt_type (tree decl)
     return MACHINE_MODE;
 }
 
+/* The last function whose target options riscv_set_current_function
+   switched to.  */
+static GTY(()) tree riscv_previous_fndecl;
+
+/* Switch the target options to those of FNDECL, or to the defaults
+   if FNDECL is null.  */
+
+static void
+riscv_activate_target_options (tree fndecl)
+{
+  tree old_tree = (riscv_previous_fndecl
+		   ? DECL_FUNCTION_SPECIFIC_TARGET (riscv_previous_fndecl)
+		   : NULL_TREE);
+  tree new_tree = fndecl ? DECL_FUNCTION_SPECIFIC_TARGET (fndecl) : NULL_TREE;
+
+  if (!old_tree)
+    old_tree = target_option_default_node;
+  if (!new_tree)
+    new_tree = target_option_default_node;
+
+  riscv_previous_fndecl = fndecl;
+  if (old_tree == new_tree)
+    return;
+
+  cl_target_option_restore (&global_options, &global_options_set,
+			    TREE_TARGET_OPTION (new_tree));
+
+  if (TREE_TARGET_GLOBALS (new_tree))
+    restore_target_globals (TREE_TARGET_GLOBALS (new_tree));
+  else if (new_tree == target_option_default_node)
+    restore_target_globals (&default_target_globals);
+  else
+    TREE_TARGET_GLOBALS (new_tree) = save_target_globals_default_opts ();
+}
+
 /* Implement `TARGET_SET_CURRENT_FUNCTION'.  */
 /* Sanity cheching for above function attributes.  */
 static void
 riscv_set_current_function (tree decl)
 {
+  riscv_activate_target_options (decl);
+
   if (decl == NULL_TREE
       || current_function_decl == NULL_TREE
       || current_function_decl == error_mark_node
@@ -5130,16 +7847,54 @@ riscv_set_current_function (tree decl)
       if (TREE_CODE (ret) != VOID_TYPE)
 	error ("%qs function cannot return a value", "interrupt");
 
-      if (args && TREE_CODE (TREE_VALUE (args)) != VOID_TYPE)
-	error ("%qs function cannot have arguments", "interrupt");
+      if (args && TREE_CODE (TREE_VALUE (args)) != VOID_TYPE)
+	error ("%qs function cannot have arguments", "interrupt");
+
+      cfun->machine->interrupt_mode = riscv_get_interrupt_type (decl);
+
+      gcc_assert (cfun->machine->interrupt_mode != UNKNOWN_MODE);
+    }
+
+  /* Don't print the above diagnostics more than once.  */
+  cfun->machine->attributes_checked_p = 1;
+}
+
+/* Return the ISA string of FNDECL if a target attribute makes it differ
+   from that of the translation unit, otherwise null.  */
+
+static const char *
+riscv_function_arch_string (tree fndecl)
+{
+  tree target = DECL_FUNCTION_SPECIFIC_TARGET (fndecl);
+  if (!target || target == target_option_default_node)
+    return NULL;
+
+  const char *arch = TREE_TARGET_OPTION (target)->x_riscv_arch_string;
+  const char *default_arch
+    = TREE_TARGET_OPTION (target_option_default_node)->x_riscv_arch_string;
+  if (!arch || (default_arch && strcmp (arch, default_arch) == 0))
+    return NULL;
+
+  return arch;
+}
+
+/* Implement TARGET_ASM_FUNCTION_PROLOGUE.  Let the assembler accept the
+   instructions of the extensions that a target attribute enables.  */
 
-      cfun->machine->interrupt_mode = riscv_get_interrupt_type (decl);
+static void
+riscv_output_function_prologue (FILE *file)
+{
+  if (const char *arch = riscv_function_arch_string (current_function_decl))
+    fprintf (file, "\t.option push\n\t.option arch, %s\n", arch);
+}
 
-      gcc_assert (cfun->machine->interrupt_mode != UNKNOWN_MODE);
-    }
+/* Implement TARGET_ASM_FUNCTION_EPILOGUE.  */
 
-  /* Don't print the above diagnostics more than once.  */
-  cfun->machine->attributes_checked_p = 1;
+static void
+riscv_output_function_epilogue (FILE *file)
+{
+  if (riscv_function_arch_string (current_function_decl))
+    fprintf (file, "\t.option pop\n");
 }
 
 /* Implement TARGET_MERGE_DECL_ATTRIBUTES. */
@@ -5185,9 +7940,20 @@ riscv_slow_unaligned_access (machine_mode, unsigned int)
 /* Implement TARGET_CAN_CHANGE_MODE_CLASS.  */
 
 static bool
-riscv_can_change_mode_class (machine_mode, machine_mode, reg_class_t rclass)
+riscv_can_change_mode_class (machine_mode from, machine_mode to,
+			     reg_class_t rclass)
 {
-  return !reg_classes_intersect_p (FP_REGS, rclass);
+  if (reg_classes_intersect_p (FP_REGS, rclass))
+    return false;
+
+  /* Vector registers hold their elements in memory order, so they can
+     be reinterpreted as any other vector mode of the same size.  */
+  if (reg_classes_intersect_p (V_REGS, rclass))
+    return (riscv_vector_mode_p (from)
+	    && riscv_vector_mode_p (to)
+	    && known_eq (GET_MODE_SIZE (from), GET_MODE_SIZE (to)));
+
+  return true;
 }
 
 
@@ -5202,6 +7968,294 @@ riscv_constant_alignment (const_tree exp, HOST_WIDE_INT align)
   return align;
 }
 
+/* Implement TARGET_VECTOR_MODE_SUPPORTED_P.  */
+
+static bool
+riscv_vector_mode_supported_p (machine_mode mode)
+{
+  return riscv_vector_mode_p (mode) || riscv_packed_mode_p (mode);
+}
+
+/* Implement TARGET_VECTORIZE_BUILTIN_VECTORIZATION_COST.  */
+
+static int
+riscv_builtin_vectorization_cost (enum vect_cost_for_stmt type_of_cost,
+				  tree vectype, int misalign)
+{
+  switch (type_of_cost)
+    {
+    case unaligned_load:
+    case unaligned_store:
+      /* Vector loads and stores only require element alignment, so don't
+	 make the vectorizer peel loops for alignment.  */
+      return 1;
+
+    default:
+      return default_builtin_vectorization_cost (type_of_cost, vectype,
+						 misalign);
+    }
+}
+
+/* Implement TARGET_VECTORIZE_PREFERRED_SIMD_MODE.  */
+
+static machine_mode
+riscv_preferred_simd_mode (scalar_mode mode)
+{
+  machine_mode vmode;
+
+  if (TARGET_VECTOR
+      && mode_for_vector (mode, UNITS_PER_V_REG / GET_MODE_SIZE (mode))
+	   .exists (&vmode)
+      && riscv_vector_mode_p (vmode))
+    return vmode;
+
+  /* Otherwise use the packed-SIMD modes that fill a GPR.  */
+  if (TARGET_PACKED_SIMD
+      && mode_for_vector (mode, UNITS_PER_WORD / GET_MODE_SIZE (mode))
+	   .exists (&vmode)
+      && riscv_packed_mode_p (vmode))
+    return vmode;
+
+  return word_mode;
+}
+
+/* Implement TARGET_VECTORIZE_VEC_PERM_CONST for the packed-SIMD modes.
+   Any V2HI permutation is a single PK instruction, which takes the upper
+   result element from its first operand and the lower one from its
+   second.  V4QI only supports swapping the bytes of each halfword
+   (SWAP8), swapping the halfwords (SWAP16) and reversing the bytes
+   (both).  */
+
+static bool
+riscv_vectorize_vec_perm_const (machine_mode vmode, rtx target, rtx op0,
+				rtx op1, const vec_perm_indices &sel)
+{
+  if (!riscv_packed_mode_p (vmode))
+    return false;
+
+  if (vmode == V2HImode)
+    {
+      static rtx (*const gen_pk[2][2]) (rtx, rtx, rtx) = {
+	{ gen_riscv_pkbb16, gen_riscv_pkbt16 },
+	{ gen_riscv_pktb16, gen_riscv_pktt16 }
+      };
+      unsigned int hi = sel[1].to_constant ();
+      unsigned int lo = sel[0].to_constant ();
+
+      if (target)
+	emit_insn (gen_pk[hi & 1][lo & 1] (target, hi < 2 ? op0 : op1,
+					   lo < 2 ? op0 : op1));
+      return true;
+    }
+
+  /* The V4QI permutations only use one input.  */
+  unsigned int base = sel[0].to_constant () & ~3U;
+  unsigned int perm = 0;
+  for (unsigned int i = 0; i < 4; i++)
+    {
+      unsigned int elt = sel[i].to_constant ();
+      if ((elt & ~3U) != base)
+	return false;
+      perm |= (elt & 3) << (i * 2);
+    }
+
+  /* PERM now holds the 2-bit source index of each byte, starting with
+     byte 0.  */
+  bool swap8 = false, swap16 = false;
+  switch (perm)
+    {
+    case 0xb1: /* { 1, 0, 3, 2 } */
+      swap8 = true;
+      break;
+    case 0x4e: /* { 2, 3, 0, 1 } */
+      swap16 = true;
+      break;
+    case 0x1b: /* { 3, 2, 1, 0 } */
+      swap8 = swap16 = true;
+      break;
+    default:
+      return false;
+    }
+
+  if (target)
+    {
+      rtx src = base == 0 ? op0 : op1;
+      if (swap8)
+	{
+	  rtx tmp = swap16 ? gen_reg_rtx (vmode) : target;
+	  emit_insn (gen_riscv_swap8 (tmp, src));
+	  src = tmp;
+	}
+      if (swap16)
+	emit_insn (gen_riscv_swap16 (target, src));
+    }
+  return true;
+}
+
+/* Return true if a SIMD clone can take or return values of TYPE in
+   vectors of SIMDLEN elements.  */
+
+static bool
+riscv_simd_clone_type_p (tree type, unsigned HOST_WIDE_INT simdlen)
+{
+  machine_mode vmode;
+
+  return ((INTEGRAL_TYPE_P (type)
+	   || POINTER_TYPE_P (type)
+	   || SCALAR_FLOAT_TYPE_P (type))
+	  && mode_for_vector (SCALAR_TYPE_MODE (type), simdlen).exists (&vmode)
+	  && riscv_vector_mode_p (vmode));
+}
+
+/* Implement TARGET_SIMD_CLONE_COMPUTE_VECSIZE_AND_SIMDLEN.  The clones
+   work on one vector register's worth of elements, which they take and
+   return like any other vector of that size, and are mangled with 'r'.  */
+
+static int
+riscv_simd_clone_compute_vecsize_and_simdlen (struct cgraph_node *node,
+					      struct cgraph_simd_clone *clonei,
+					      tree base_type,
+					      int num ATTRIBUTE_UNUSED)
+{
+  unsigned int vec_bits = UNITS_PER_V_REG * BITS_PER_UNIT;
+  unsigned HOST_WIDE_INT simdlen;
+
+  if (!TARGET_VECTOR)
+    return 0;
+
+  simdlen = vec_bits / GET_MODE_BITSIZE (SCALAR_TYPE_MODE (base_type));
+  if (maybe_ne (clonei->simdlen, 0U) && maybe_ne (clonei->simdlen, simdlen))
+    {
+      warning_at (DECL_SOURCE_LOCATION (node->decl), 0,
+		  "GCC does not currently support this simdlen for type %qT",
+		  base_type);
+      return 0;
+    }
+
+  tree ret_type = TREE_TYPE (TREE_TYPE (node->decl));
+  if (TREE_CODE (ret_type) != VOID_TYPE
+      && !riscv_simd_clone_type_p (ret_type, simdlen))
+    {
+      warning_at (DECL_SOURCE_LOCATION (node->decl), 0,
+		  "unsupported return type %qT for %<simd%> functions",
+		  ret_type);
+      return 0;
+    }
+
+  tree t;
+  int i;
+  tree type_arg_types = TYPE_ARG_TYPES (TREE_TYPE (node->decl));
+  bool decl_arg_p = (node->definition || type_arg_types == NULL_TREE);
+
+  for (t = (decl_arg_p ? DECL_ARGUMENTS (node->decl) : type_arg_types), i = 0;
+       t && t != void_list_node; t = TREE_CHAIN (t), i++)
+    {
+      tree arg_type = decl_arg_p ? TREE_TYPE (t) : TREE_VALUE (t);
+
+      if (clonei->args[i].arg_type != SIMD_CLONE_ARG_TYPE_UNIFORM
+	  && !riscv_simd_clone_type_p (arg_type, simdlen))
+	{
+	  warning_at (DECL_SOURCE_LOCATION (node->decl), 0,
+		      "unsupported argument type %qT for %<simd%> functions",
+		      arg_type);
+	  return 0;
+	}
+    }
+
+  clonei->vecsize_mangle = 'r';
+  clonei->mask_mode = VOIDmode;
+  clonei->simdlen = simdlen;
+  clonei->vecsize_int = vec_bits;
+  clonei->vecsize_float = vec_bits;
+  return 1;
+}
+
+/* Implement TARGET_SIMD_CLONE_USABLE.  */
+
+static int
+riscv_simd_clone_usable (struct cgraph_node *node)
+{
+  gcc_assert (node->simdclone->vecsize_mangle == 'r');
+  return TARGET_VECTOR ? 0 : -1;
+}
+
+/* Return true if INSN leaves VL and VTYPE unknown.  The only vector
+   instructions that do so are those that set VL themselves.  */
+
+static bool
+riscv_vsetvl_clobber_p (rtx_insn *insn)
+{
+  if (CALL_P (insn)
+      || GET_CODE (PATTERN (insn)) == ASM_INPUT
+      || asm_noperands (PATTERN (insn)) >= 0)
+    return true;
+
+  return (recog_memoized (insn) >= 0
+	  && get_attr_type (insn) == TYPE_VECTOR
+	  && get_attr_vsew (insn) == 0);
+}
+
+/* Implement TARGET_MODE_NEEDED.  */
+
+static int
+riscv_mode_needed (int, rtx_insn *insn)
+{
+  if (!NONDEBUG_INSN_P (insn))
+    return RISCV_VSETVL_ANY;
+
+  if (riscv_vsetvl_clobber_p (insn))
+    return RISCV_VSETVL_UNKNOWN;
+
+  if (recog_memoized (insn) < 0)
+    return RISCV_VSETVL_ANY;
+
+  switch (get_attr_vsew (insn))
+    {
+    case 8:
+      return RISCV_VSETVL_E8;
+    case 16:
+      return RISCV_VSETVL_E16;
+    case 32:
+      return RISCV_VSETVL_E32;
+    case 64:
+      return RISCV_VSETVL_E64;
+    default:
+      return RISCV_VSETVL_ANY;
+    }
+}
+
+/* Implement TARGET_MODE_EMIT.  */
+
+static void
+riscv_mode_emit (int, int mode, int, HARD_REG_SET)
+{
+  switch (mode)
+    {
+    case RISCV_VSETVL_E8:
+      emit_insn (gen_riscv_vsetivliv16qi ());
+      break;
+    case RISCV_VSETVL_E16:
+      emit_insn (gen_riscv_vsetivliv8hi ());
+      break;
+    case RISCV_VSETVL_E32:
+      emit_insn (gen_riscv_vsetivliv4si ());
+      break;
+    case RISCV_VSETVL_E64:
+      emit_insn (gen_riscv_vsetivliv2di ());
+      break;
+    default:
+      break;
+    }
+}
+
+/* Implement TARGET_MODE_PRIORITY.  */
+
+static int
+riscv_mode_priority (int, int n)
+{
+  return n;
+}
+
 /* Implement TARGET_PROMOTE_FUNCTION_MODE.  */
 
 /* This function is equivalent to default_promote_function_mode_always_promote
@@ -5234,8 +8288,11 @@ static void
 riscv_reorg (void)
 {
   /* Do nothing unless we have -msave-restore */
-  if (TARGET_SAVE_RESTORE)
+  if (riscv_save_restore_p ())
     riscv_remove_unneeded_save_restore_calls ();
+
+  if (dump_file && TARGET_RVC)
+    riscv_dump_compressed_regs ();
 }
 
 /* Return nonzero if register FROM_REGNO can be renamed to register
@@ -5303,6 +8360,82 @@ riscv_gen_gpr_save_insn (struct riscv_frame_info *frame)
   return gen_rtx_PARALLEL (VOIDmode, vec);
 }
 
+/* Return a gpr_push pattern for FRAME, which saves the GPRs with cm.push
+   and decrements the stack pointer by ADJUSTMENT.  */
+
+rtx
+riscv_gen_gpr_push_insn (struct riscv_frame_info *frame,
+			 HOST_WIDE_INT adjustment)
+{
+  unsigned count = riscv_save_libcall_count (frame->mask);
+  /* 1 for unspec and 1 for ra.  */
+  unsigned veclen = 1 + 1 + count;
+  rtvec vec = rtvec_alloc (veclen);
+
+  RTVEC_ELT (vec, 0) =
+    gen_rtx_UNSPEC_VOLATILE (VOIDmode,
+      gen_rtvec (2, GEN_INT (count), GEN_INT (-adjustment)),
+      UNSPECV_GPR_PUSH);
+
+  /* USE the saved registers, which are the same as for gpr_save.  */
+  for (unsigned i = 1; i < veclen; ++i)
+    RTVEC_ELT (vec, i) = gen_rtx_USE (Pmode,
+				      gen_rtx_REG (Pmode,
+						   gpr_save_reg_order[i + 2]));
+
+  return gen_rtx_PARALLEL (VOIDmode, vec);
+}
+
+/* Return true if OP is a valid gpr_push pattern.  */
+
+bool
+riscv_gpr_push_operation_p (rtx op)
+{
+  unsigned len = XVECLEN (op, 0);
+
+  if (len < 2 || len + 2 > ARRAY_SIZE (gpr_save_reg_order))
+    return false;
+
+  rtx elt = XVECEXP (op, 0, 0);
+  if (GET_CODE (elt) != UNSPEC_VOLATILE
+      || XINT (elt, 1) != UNSPECV_GPR_PUSH)
+    return false;
+
+  for (unsigned i = 1; i < len; i++)
+    {
+      elt = XVECEXP (op, 0, i);
+      if (GET_CODE (elt) != USE
+	  || !REG_P (XEXP (elt, 0))
+	  || REGNO (XEXP (elt, 0)) != gpr_save_reg_order[i + 2])
+	return false;
+    }
+  return true;
+}
+
+/* Return the assembly for a Zcmp instruction INSN that saves or restores
+   ra and the first COUNT s-registers and adjusts the stack pointer by
+   ADJUSTMENT.  */
+
+const char *
+riscv_output_gpr_push_pop (const char *insn, rtx count, rtx adjustment)
+{
+  static char buffer[64];
+  HOST_WIDE_INT n = INTVAL (count);
+
+  if (n == 0)
+    snprintf (buffer, sizeof (buffer), "%s\t{ra}, " HOST_WIDE_INT_PRINT_DEC,
+	      insn, INTVAL (adjustment));
+  else if (n == 1)
+    snprintf (buffer, sizeof (buffer),
+	      "%s\t{ra, s0}, " HOST_WIDE_INT_PRINT_DEC,
+	      insn, INTVAL (adjustment));
+  else
+    snprintf (buffer, sizeof (buffer),
+	      "%s\t{ra, s0-s" HOST_WIDE_INT_PRINT_DEC "}, "
+	      HOST_WIDE_INT_PRINT_DEC, insn, n - 1, INTVAL (adjustment));
+  return buffer;
+}
+
 /* Return true if it's valid gpr_save pattern.  */
 
 bool
@@ -5351,6 +8484,128 @@ riscv_asan_shadow_offset (void)
   return TARGET_64BIT ? (HOST_WIDE_INT_1 << 29) : 0;
 }
 
+/* Implement TARGET_SCALAR_MODE_SUPPORTED_P.  _Float16 needs at least the
+   Zfhmin conversions; its arithmetic is done in SFmode without Zfh.  */
+
+static bool
+riscv_scalar_mode_supported_p (scalar_mode mode)
+{
+  if (mode == HFmode)
+    return TARGET_ZFHMIN;
+
+  return default_scalar_mode_supported_p (mode);
+}
+
+/* Implement TARGET_LIBGCC_FLOATING_MODE_SUPPORTED_P.  This makes
+   _Float16 available; libgcc has no HFmode routines, but every HFmode
+   operation we expand is done in hardware or through SFmode.  */
+
+static bool
+riscv_libgcc_floating_mode_supported_p (scalar_float_mode mode)
+{
+  if (mode == HFmode)
+    return TARGET_ZFHMIN;
+
+  return default_libgcc_floating_mode_supported_p (mode);
+}
+
+/* Implement TARGET_C_EXCESS_PRECISION.  With Zfh, _Float16 expressions
+   are evaluated in their own range and precision; otherwise they are
+   evaluated in float, as only conversions are available.  */
+
+static enum flt_eval_method
+riscv_excess_precision (enum excess_precision_type type)
+{
+  switch (type)
+    {
+    case EXCESS_PRECISION_TYPE_FAST:
+    case EXCESS_PRECISION_TYPE_STANDARD:
+      return (TARGET_ZFH
+	      ? FLT_EVAL_METHOD_PROMOTE_TO_FLOAT16
+	      : FLT_EVAL_METHOD_PROMOTE_TO_FLOAT);
+    case EXCESS_PRECISION_TYPE_IMPLICIT:
+      return FLT_EVAL_METHOD_PROMOTE_TO_FLOAT16;
+    default:
+      gcc_unreachable ();
+    }
+  return FLT_EVAL_METHOD_UNPREDICTABLE;
+}
+
+/* Implement TARGET_MANGLE_TYPE.  */
+
+static const char *
+riscv_mangle_type (const_tree type)
+{
+  /* Half-precision brain floating point.  */
+  if (TREE_CODE (type) == REAL_TYPE && TYPE_MODE (type) == BFmode)
+    return "u6__bf16";
+
+  /* Use the default mangling.  */
+  return NULL;
+}
+
+/* Implement TARGET_INVALID_CONVERSION.  __bf16 is a storage type: Zfbfmin
+   only converts it to and from float.  */
+
+static const char *
+riscv_invalid_conversion (const_tree fromtype, const_tree totype)
+{
+  machine_mode from_mode = element_mode (fromtype);
+  machine_mode to_mode = element_mode (totype);
+
+  if (from_mode != to_mode && !VOID_TYPE_P (totype))
+    {
+      if (from_mode == BFmode && to_mode != SFmode)
+	return N_("invalid conversion from type %<__bf16%> to a type "
+		  "other than %<float%>");
+      if (to_mode == BFmode && from_mode != SFmode)
+	return N_("invalid conversion to type %<__bf16%> from a type "
+		  "other than %<float%>");
+    }
+
+  /* Conversion allowed.  */
+  return NULL;
+}
+
+/* Implement TARGET_INVALID_UNARY_OP.  */
+
+static const char *
+riscv_invalid_unary_op (int op, const_tree type)
+{
+  /* Reject all single-operand operations on __bf16 except for &.  */
+  if (element_mode (type) == BFmode && op != ADDR_EXPR)
+    return N_("operation not permitted on type %<__bf16%>");
+
+  /* Operation allowed.  */
+  return NULL;
+}
+
+/* Implement TARGET_INVALID_BINARY_OP.  */
+
+static const char *
+riscv_invalid_binary_op (int op ATTRIBUTE_UNUSED, const_tree type1,
+			 const_tree type2)
+{
+  /* Reject all 2-operand operations on __bf16.  */
+  if (element_mode (type1) == BFmode || element_mode (type2) == BFmode)
+    return N_("operation not permitted on type %<__bf16%>");
+
+  /* Operation allowed.  */
+  return NULL;
+}
+
+/* Implement TARGET_MEMTAG_CAN_TAG_ADDRESSES.  With the pointer masking
+   extensions the top bits of an address can be ignored by loads and
+   stores, which allows using -fsanitize=hwaddress.  The runtime asks the
+   kernel to mask at least the 8 bits the tag occupies; we only have
+   libsanitizer support for RV64.  */
+
+static bool
+riscv_can_tag_addresses (void)
+{
+  return TARGET_64BIT;
+}
+
 /* Initialize the GCC target structure.  */
 #undef TARGET_ASM_ALIGNED_HI_OP
 #define TARGET_ASM_ALIGNED_HI_OP "\t.half\t"
@@ -5362,12 +8617,56 @@ riscv_asan_shadow_offset (void)
 #undef TARGET_OPTION_OVERRIDE
 #define TARGET_OPTION_OVERRIDE riscv_option_override
 
+#undef TARGET_OPTION_RESTORE
+#define TARGET_OPTION_RESTORE riscv_option_restore
+
+#undef TARGET_OPTION_VALID_ATTRIBUTE_P
+#define TARGET_OPTION_VALID_ATTRIBUTE_P riscv_option_valid_attribute_p
+
+#undef TARGET_ASM_FUNCTION_PROLOGUE
+#define TARGET_ASM_FUNCTION_PROLOGUE riscv_output_function_prologue
+
+#undef TARGET_ASM_FUNCTION_EPILOGUE
+#define TARGET_ASM_FUNCTION_EPILOGUE riscv_output_function_epilogue
+
 #undef TARGET_LEGITIMIZE_ADDRESS
 #define TARGET_LEGITIMIZE_ADDRESS riscv_legitimize_address
 
 #undef TARGET_SCHED_ISSUE_RATE
 #define TARGET_SCHED_ISSUE_RATE riscv_issue_rate
 
+#undef TARGET_SCHED_REASSOCIATION_WIDTH
+#define TARGET_SCHED_REASSOCIATION_WIDTH riscv_sched_reassociation_width
+
+#undef TARGET_LOOP_UNROLL_ADJUST
+#define TARGET_LOOP_UNROLL_ADJUST riscv_loop_unroll_adjust
+
+#undef TARGET_SCHED_MACRO_FUSION_P
+#define TARGET_SCHED_MACRO_FUSION_P riscv_macro_fusion_p
+
+#undef TARGET_SCHED_MACRO_FUSION_PAIR_P
+#define TARGET_SCHED_MACRO_FUSION_PAIR_P riscv_macro_fusion_pair_p
+
+#undef TARGET_SHRINK_WRAP_GET_SEPARATE_COMPONENTS
+#define TARGET_SHRINK_WRAP_GET_SEPARATE_COMPONENTS riscv_get_separate_components
+
+#undef TARGET_SHRINK_WRAP_COMPONENTS_FOR_BB
+#define TARGET_SHRINK_WRAP_COMPONENTS_FOR_BB riscv_components_for_bb
+
+#undef TARGET_SHRINK_WRAP_DISQUALIFY_COMPONENTS
+#define TARGET_SHRINK_WRAP_DISQUALIFY_COMPONENTS riscv_disqualify_components
+
+#undef TARGET_SHRINK_WRAP_EMIT_PROLOGUE_COMPONENTS
+#define TARGET_SHRINK_WRAP_EMIT_PROLOGUE_COMPONENTS \
+  riscv_emit_prologue_components
+
+#undef TARGET_SHRINK_WRAP_EMIT_EPILOGUE_COMPONENTS
+#define TARGET_SHRINK_WRAP_EMIT_EPILOGUE_COMPONENTS \
+  riscv_emit_epilogue_components
+
+#undef TARGET_SHRINK_WRAP_SET_HANDLED_COMPONENTS
+#define TARGET_SHRINK_WRAP_SET_HANDLED_COMPONENTS riscv_set_handled_components
+
 #undef TARGET_FUNCTION_OK_FOR_SIBCALL
 #define TARGET_FUNCTION_OK_FOR_SIBCALL riscv_function_ok_for_sibcall
 
@@ -5397,6 +8696,9 @@ riscv_asan_shadow_offset (void)
 #undef TARGET_RETURN_IN_MEMORY
 #define TARGET_RETURN_IN_MEMORY riscv_return_in_memory
 
+#undef TARGET_CALL_FUSAGE_CONTAINS_NON_CALLEE_CLOBBERS
+#define TARGET_CALL_FUSAGE_CONTAINS_NON_CALLEE_CLOBBERS true
+
 #undef TARGET_ASM_OUTPUT_MI_THUNK
 #define TARGET_ASM_OUTPUT_MI_THUNK riscv_output_mi_thunk
 #undef TARGET_ASM_CAN_OUTPUT_MI_THUNK
@@ -5480,6 +8782,9 @@ riscv_asan_shadow_offset (void)
 #undef TARGET_REGISTER_PRIORITY
 #define TARGET_REGISTER_PRIORITY riscv_register_priority
 
+#undef TARGET_PREFERRED_RENAME_CLASS
+#define TARGET_PREFERRED_RENAME_CLASS riscv_preferred_rename_class
+
 #undef TARGET_CANNOT_COPY_INSN_P
 #define TARGET_CANNOT_COPY_INSN_P riscv_cannot_copy_insn_p
 
@@ -5515,6 +8820,35 @@ riscv_asan_shadow_offset (void)
 #undef TARGET_CONSTANT_ALIGNMENT
 #define TARGET_CONSTANT_ALIGNMENT riscv_constant_alignment
 
+#undef TARGET_VECTOR_MODE_SUPPORTED_P
+#define TARGET_VECTOR_MODE_SUPPORTED_P riscv_vector_mode_supported_p
+
+#undef TARGET_VECTORIZE_BUILTIN_VECTORIZATION_COST
+#define TARGET_VECTORIZE_BUILTIN_VECTORIZATION_COST \
+  riscv_builtin_vectorization_cost
+
+#undef TARGET_VECTORIZE_PREFERRED_SIMD_MODE
+#define TARGET_VECTORIZE_PREFERRED_SIMD_MODE riscv_preferred_simd_mode
+
+#undef TARGET_VECTORIZE_VEC_PERM_CONST
+#define TARGET_VECTORIZE_VEC_PERM_CONST riscv_vectorize_vec_perm_const
+
+#undef TARGET_SIMD_CLONE_COMPUTE_VECSIZE_AND_SIMDLEN
+#define TARGET_SIMD_CLONE_COMPUTE_VECSIZE_AND_SIMDLEN \
+  riscv_simd_clone_compute_vecsize_and_simdlen
+
+#undef TARGET_SIMD_CLONE_USABLE
+#define TARGET_SIMD_CLONE_USABLE riscv_simd_clone_usable
+
+#undef TARGET_MODE_NEEDED
+#define TARGET_MODE_NEEDED riscv_mode_needed
+
+#undef TARGET_MODE_EMIT
+#define TARGET_MODE_EMIT riscv_mode_emit
+
+#undef TARGET_MODE_PRIORITY
+#define TARGET_MODE_PRIORITY riscv_mode_priority
+
 #undef TARGET_MERGE_DECL_ATTRIBUTES
 #define TARGET_MERGE_DECL_ATTRIBUTES riscv_merge_decl_attributes
 
@@ -5537,6 +8871,31 @@ riscv_asan_shadow_offset (void)
 #undef TARGET_ASAN_SHADOW_OFFSET
 #define TARGET_ASAN_SHADOW_OFFSET riscv_asan_shadow_offset
 
+#undef TARGET_SCALAR_MODE_SUPPORTED_P
+#define TARGET_SCALAR_MODE_SUPPORTED_P riscv_scalar_mode_supported_p
+
+#undef TARGET_LIBGCC_FLOATING_MODE_SUPPORTED_P
+#define TARGET_LIBGCC_FLOATING_MODE_SUPPORTED_P \
+  riscv_libgcc_floating_mode_supported_p
+
+#undef TARGET_C_EXCESS_PRECISION
+#define TARGET_C_EXCESS_PRECISION riscv_excess_precision
+
+#undef TARGET_MANGLE_TYPE
+#define TARGET_MANGLE_TYPE riscv_mangle_type
+
+#undef TARGET_INVALID_CONVERSION
+#define TARGET_INVALID_CONVERSION riscv_invalid_conversion
+
+#undef TARGET_INVALID_UNARY_OP
+#define TARGET_INVALID_UNARY_OP riscv_invalid_unary_op
+
+#undef TARGET_INVALID_BINARY_OP
+#define TARGET_INVALID_BINARY_OP riscv_invalid_binary_op
+
+#undef TARGET_MEMTAG_CAN_TAG_ADDRESSES
+#define TARGET_MEMTAG_CAN_TAG_ADDRESSES riscv_can_tag_addresses
+
 #ifdef TARGET_BIG_ENDIAN_DEFAULT
 #undef  TARGET_DEFAULT_TARGET_FLAGS
 #define TARGET_DEFAULT_TARGET_FLAGS (MASK_BIG_ENDIAN)
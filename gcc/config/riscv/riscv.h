@@ -122,8 +122,16 @@ ASM_MISA_SPEC
 #define DWARF_FRAME_REGNUM(REGNO) \
   (GP_REG_P (REGNO) || FP_REG_P (REGNO) ? REGNO : INVALID_REGNUM)
 
+/* The mapping from gcc register number to DWARF 2 register number.
+   The psABI numbers the vector registers from 96.  */
+#define DBX_REGISTER_NUMBER(REGNO) \
+  (V_REG_P (REGNO) ? (REGNO) - V_REG_FIRST + 96 : (REGNO))
+
 /* The DWARF 2 CFA column which tracks the return address.  */
 #define DWARF_FRAME_RETURN_COLUMN RETURN_ADDR_REGNUM
+
+/* Linker relaxation can shrink code between any two labels.  */
+#define DWARF2_CODE_LABEL_DELTAS_NEED_RELOCS riscv_mrelax
 #define INCOMING_RETURN_ADDR_RTX gen_rtx_REG (VOIDmode, RETURN_ADDR_REGNUM)
 
 /* Describe how we implement __builtin_eh_return.  */
@@ -149,6 +157,10 @@ ASM_MISA_SPEC
 /* The `Q' extension is not yet supported.  */
 #define UNITS_PER_FP_REG (TARGET_DOUBLE_FLOAT ? 8 : 4)
 
+/* The part of a vector register used by the vectorizer, i.e. the minimum
+   VLEN of 128 bits at LMUL=1.  */
+#define UNITS_PER_V_REG 16
+
 /* The largest type that can be passed in floating-point registers.  */
 #define UNITS_PER_FP_ARG						\
   ((riscv_abi == ABI_ILP32 || riscv_abi == ABI_ILP32E			\
@@ -282,9 +294,10 @@ ASM_MISA_SPEC
    - 32 floating point registers
    - 2 fake registers:
 	- ARG_POINTER_REGNUM
-	- FRAME_POINTER_REGNUM */
+	- FRAME_POINTER_REGNUM
+   - 32 vector registers */
 
-#define FIRST_PSEUDO_REGISTER 66
+#define FIRST_PSEUDO_REGISTER 98
 
 /* x0, sp, gp, and tp are fixed.  */
 
@@ -296,11 +309,14 @@ ASM_MISA_SPEC
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,			\
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,			\
   /* Others.  */							\
-  1, 1									\
+  1, 1,									\
+  /* Vector registers.  */						\
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,			\
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,			\
 }
 
-/* a0-a7, t0-t6, fa0-fa7, and ft0-ft11 are volatile across calls.
-   The call RTLs themselves clobber ra.  */
+/* a0-a7, t0-t6, fa0-fa7, ft0-ft11 and all vector registers are volatile
+   across calls.  The call RTLs themselves clobber ra.  */
 
 #define CALL_USED_REGISTERS						\
 { /* General registers.  */						\
@@ -310,7 +326,10 @@ ASM_MISA_SPEC
   1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1,			\
   1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1,			\
   /* Others.  */							\
-  1, 1									\
+  1, 1,									\
+  /* Vector registers.  */						\
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,			\
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,			\
 }
 
 /* Select a register mode required for caller save of hard regno REGNO.
@@ -330,6 +349,10 @@ ASM_MISA_SPEC
 #define FP_REG_LAST  63
 #define FP_REG_NUM   (FP_REG_LAST - FP_REG_FIRST + 1)
 
+#define V_REG_FIRST 66
+#define V_REG_LAST  97
+#define V_REG_NUM   (V_REG_LAST - V_REG_FIRST + 1)
+
 /* The DWARF 2 CFA column which tracks the return address from a
    signal handler context.  This means that to maintain backwards
    compatibility, no hard register can be assigned this column if it
@@ -340,6 +363,8 @@ ASM_MISA_SPEC
   ((unsigned int) ((int) (REGNO) - GP_REG_FIRST) < GP_REG_NUM)
 #define FP_REG_P(REGNO)  \
   ((unsigned int) ((int) (REGNO) - FP_REG_FIRST) < FP_REG_NUM)
+#define V_REG_P(REGNO)  \
+  ((unsigned int) ((int) (REGNO) - V_REG_FIRST) < V_REG_NUM)
 
 /* True when REGNO is in SIBCALL_REGS set.  */
 #define SIBCALL_REG_P(REGNO)	\
@@ -419,10 +444,13 @@ enum reg_class
 {
   NO_REGS,			/* no registers in set */
   SIBCALL_REGS,			/* registers used by indirect sibcalls */
+  RVC_GR_REGS,			/* integer registers usable by RVC */
   JALR_REGS,			/* registers used by indirect calls */
   GR_REGS,			/* integer registers */
+  RVC_FP_REGS,			/* floating-point registers usable by RVC */
   FP_REGS,			/* floating-point registers */
   FRAME_REGS,			/* arg pointer and frame pointer */
+  V_REGS,			/* vector registers */
   ALL_REGS,			/* all registers */
   LIM_REG_CLASSES		/* max value + 1 */
 };
@@ -439,10 +467,13 @@ enum reg_class
 {									\
   "NO_REGS",								\
   "SIBCALL_REGS",							\
+  "RVC_GR_REGS",							\
   "JALR_REGS",								\
   "GR_REGS",								\
+  "RVC_FP_REGS",							\
   "FP_REGS",								\
   "FRAME_REGS",								\
+  "V_REGS",								\
   "ALL_REGS"								\
 }
 
@@ -459,13 +490,16 @@ enum reg_class
 
 #define REG_CLASS_CONTENTS						\
 {									\
-  { 0x00000000, 0x00000000, 0x00000000 },	/* NO_REGS */		\
-  { 0xf003fcc0, 0x00000000, 0x00000000 },	/* SIBCALL_REGS */	\
-  { 0xffffffc0, 0x00000000, 0x00000000 },	/* JALR_REGS */		\
-  { 0xffffffff, 0x00000000, 0x00000000 },	/* GR_REGS */		\
-  { 0x00000000, 0xffffffff, 0x00000000 },	/* FP_REGS */		\
-  { 0x00000000, 0x00000000, 0x00000003 },	/* FRAME_REGS */	\
-  { 0xffffffff, 0xffffffff, 0x00000003 }	/* ALL_REGS */		\
+  { 0x00000000, 0x00000000, 0x00000000, 0x00000000 },	/* NO_REGS */	\
+  { 0xf003fcc0, 0x00000000, 0x00000000, 0x00000000 },	/* SIBCALL_REGS */\
+  { 0x0000ff00, 0x00000000, 0x00000000, 0x00000000 },	/* RVC_GR_REGS */\
+  { 0xffffffc0, 0x00000000, 0x00000000, 0x00000000 },	/* JALR_REGS */	\
+  { 0xffffffff, 0x00000000, 0x00000000, 0x00000000 },	/* GR_REGS */	\
+  { 0x00000000, 0x0000ff00, 0x00000000, 0x00000000 },	/* RVC_FP_REGS */\
+  { 0x00000000, 0xffffffff, 0x00000000, 0x00000000 },	/* FP_REGS */	\
+  { 0x00000000, 0x00000000, 0x00000003, 0x00000000 },	/* FRAME_REGS */\
+  { 0x00000000, 0x00000000, 0xfffffffc, 0x00000003 },	/* V_REGS */	\
+  { 0xffffffff, 0xffffffff, 0xffffffff, 0x00000003 }	/* ALL_REGS */	\
 }
 
 /* A C expression whose value is a register class containing hard
@@ -507,7 +541,11 @@ enum reg_class
   40, 41, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,			\
   /* None of the remaining classes have defined call-saved		\
      registers.  */							\
-  64, 65								\
+  64, 65,								\
+  /* Vector registers, with v0 last since it holds the mask operand	\
+     of masked instructions.  */					\
+  67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82,	\
+  83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 66	\
 }
 
 /* True if VALUE is a signed 12-bit number.  */
@@ -521,6 +559,11 @@ enum reg_class
   (((VALUE) | ((1UL<<31) - IMM_REACH)) == ((1UL<<31) - IMM_REACH)	\
    || ((VALUE) | ((1UL<<31) - IMM_REACH)) + IMM_REACH == 0)
 
+/* True if VALUE has a single bit set, so that Zbs can load it using BSETI.  */
+
+#define SINGLE_BIT_MASK_OPERAND(VALUE) \
+  (pow2p_hwi ((unsigned HOST_WIDE_INT) (VALUE)))
+
 /* Stack layout; function entry, exit and calling.  */
 
 #define STACK_GROWS_DOWNWARD 1
@@ -678,7 +721,18 @@ typedef struct {
 
 #define JUMP_TABLES_IN_TEXT_SECTION 0
 #define CASE_VECTOR_MODE SImode
-#define CASE_VECTOR_PC_RELATIVE (riscv_cmodel != CM_MEDLOW)
+#define CASE_VECTOR_PC_RELATIVE 1
+
+/* Jump table entries are offsets from a label in the casesi dispatch
+   sequence, 12 bytes before its end, and are narrowed to bytes or
+   halfwords when all the case labels are close enough, leaving some
+   slack for that and for alignment.  The text sections of a partitioned
+   function can end up arbitrarily far apart.  */
+#define CASE_VECTOR_SHORTEN_MODE(MIN, MAX, BODY)			\
+  (crtl->has_bb_partition ? SImode					\
+   : (MIN) >= -0x70 && (MAX) <= 0x70 ? QImode				\
+   : (MIN) >= -0x7f00 && (MAX) <= 0x7f00 ? HImode			\
+   : SImode)
 
 /* The load-address macro is used for PC-relative addressing of symbols
    that bind locally.  Don't use it for symbols that should be addressed
@@ -710,6 +764,12 @@ typedef struct {
    in the md file instead.  */
 #define SHIFT_COUNT_TRUNCATED 0
 
+/* The Zbb CLZ and CTZ instructions return the operand width for zero.  */
+#define CLZ_DEFINED_VALUE_AT_ZERO(MODE, VALUE) \
+  ((VALUE) = GET_MODE_UNIT_BITSIZE (MODE), 2)
+#define CTZ_DEFINED_VALUE_AT_ZERO(MODE, VALUE) \
+  ((VALUE) = GET_MODE_UNIT_BITSIZE (MODE), 2)
+
 /* Specify the machine mode that pointers have.
    After generation of rtl, the compiler makes no further distinction
    between pointers and any other objects of this machine mode.  */
@@ -738,6 +798,10 @@ typedef struct {
 
 #define TARGET_SFB_ALU (riscv_microarchitecture == sifive_7)
 
+/* True if dynamic TLS accesses go through TLS descriptors rather than
+   calls to __tls_get_addr.  */
+#define TARGET_TLSDESC (riscv_tls_dialect == TLS_DESCRIPTORS)
+
 #define LOGICAL_OP_NON_SHORT_CIRCUIT 0
 
 /* Control the assembler format that we output.  */
@@ -765,7 +829,11 @@ typedef struct {
   "fs0", "fs1", "fa0", "fa1", "fa2", "fa3", "fa4", "fa5",	\
   "fa6", "fa7", "fs2", "fs3", "fs4", "fs5", "fs6", "fs7",	\
   "fs8", "fs9", "fs10","fs11","ft8", "ft9", "ft10","ft11",	\
-  "arg", "frame", }
+  "arg", "frame",						\
+  "v0",  "v1",  "v2",  "v3",  "v4",  "v5",  "v6",  "v7",	\
+  "v8",  "v9",  "v10", "v11", "v12", "v13", "v14", "v15",	\
+  "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23",	\
+  "v24", "v25", "v26", "v27", "v28", "v29", "v30", "v31", }
 
 #define ADDITIONAL_REGISTER_NAMES					\
 {									\
@@ -852,10 +920,13 @@ typedef struct {
 #define ASM_OUTPUT_ADDR_VEC_ELT(STREAM, VALUE)				\
   fprintf (STREAM, "\t.word\t%sL%d\n", LOCAL_LABEL_PREFIX, VALUE)
 
-/* This is how to output an element of a PIC case-vector. */
+/* This is how to output an element of a PC-relative case-vector.  The
+   offsets are from the label that riscv_output_casesi emits.  */
 
 #define ASM_OUTPUT_ADDR_DIFF_ELT(STREAM, BODY, VALUE, REL)		\
-  fprintf (STREAM, "\t.word\t%sL%d-%sL%d\n",				\
+  fprintf (STREAM, "\t%s\t%sL%d-%sLrtx%d\n",				\
+	   (GET_MODE (BODY) == QImode ? ".byte"				\
+	    : GET_MODE (BODY) == HImode ? ".half" : ".word"),		\
 	   LOCAL_LABEL_PREFIX, VALUE, LOCAL_LABEL_PREFIX, REL)
 
 /* This is how to output an assembler line
@@ -865,6 +936,9 @@ typedef struct {
 #define ASM_OUTPUT_ALIGN(STREAM,LOG)					\
   fprintf (STREAM, "\t.align\t%d\n", (LOG))
 
+/* How to align the loop headed by LABEL.  */
+#define LOOP_ALIGN(LABEL) riscv_loop_align (LABEL)
+
 /* Define the strings to put out for each section in the object file.  */
 #define TEXT_SECTION_ASM_OP	"\t.text"	/* instructions */
 #define DATA_SECTION_ASM_OP	"\t.data"	/* large data */
@@ -905,15 +979,25 @@ while (0)
 #undef PTRDIFF_TYPE
 #define PTRDIFF_TYPE (POINTER_SIZE == 64 ? "long int" : "int")
 
-/* The maximum number of bytes copied by one iteration of a cpymemsi loop.  */
+/* The maximum number of bytes copied by one iteration of a cpymem loop.  */
 
 #define RISCV_MAX_MOVE_BYTES_PER_LOOP_ITER (UNITS_PER_WORD * 4)
 
 /* The maximum number of bytes that can be copied by a straight-line
-   cpymemsi implementation.  */
+   cpymem implementation.  */
 
 #define RISCV_MAX_MOVE_BYTES_STRAIGHT (RISCV_MAX_MOVE_BYTES_PER_LOOP_ITER * 3)
 
+/* The size of the cache blocks that Zic64b guarantees, and so of the
+   blocks that cbo.zero clears.  */
+
+#define RISCV_CBO_BLOCK_SIZE 64
+
+/* The size from which block copies and sets use Zihintntl hints, so that
+   they do not displace the rest of the working set from the caches.  */
+
+#define RISCV_NTL_MIN_BLOCK_BYTES (256 * 1024)
+
 /* If a memory-to-memory move would take MOVE_RATIO or more simple
    move-instruction pairs, we will do a cpymem or libcall instead.
    Do not use move_by_pieces at all when strict alignment is not
@@ -983,6 +1067,35 @@ extern unsigned riscv_stack_boundary;
    offset (an unsigned 5-bit value scaled by 4).  */
 #define CSW_MAX_OFFSET (((4LL << C_S_BITS) - 1) & ~3)
 
+/* Likewise for a doubleword compressed load/store (an unsigned 5-bit value
+   scaled by 8).  */
+#define CSD_MAX_OFFSET (((8LL << C_S_BITS) - 1) & ~7)
+
+/* The largest stack adjustment that cm.push and cm.pop can make beyond
+   the size of their register save area (a 2-bit value scaled by 16).  */
+#define ZCMP_MAX_EXTRA_ADJUSTMENT 48
+
+/* The VL and VTYPE configurations that the vsetvl pass places, as modes
+   of a single mode-switching entity.  RISCV_VSETVL_UNKNOWN is "needed"
+   by instructions that leave VL and VTYPE unknown, such as calls, and
+   never requires a VSETVLI of its own.  */
+enum riscv_vsetvl_mode
+{
+  RISCV_VSETVL_E8,
+  RISCV_VSETVL_E16,
+  RISCV_VSETVL_E32,
+  RISCV_VSETVL_E64,
+  RISCV_VSETVL_UNKNOWN,
+  RISCV_VSETVL_ANY
+};
+
+/* The vsetvl pass runs the generic mode-switching code after register
+   allocation and scheduling; the earlier mode-switching pass has nothing
+   to do.  */
+#define OPTIMIZE_MODE_SWITCHING(ENTITY) (TARGET_VECTOR && reload_completed)
+
+#define NUM_MODES_FOR_MODE_SWITCHING { RISCV_VSETVL_ANY }
+
 /* Called from RISCV_REORG, this is defined in riscv-sr.c.  */
 
 extern void riscv_remove_unneeded_save_restore_calls (void);
@@ -0,0 +1,331 @@
+/* RISC-V V extension intrinsics.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of GCC.
+
+   GCC is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 3, or (at your
+   option) any later version.
+
+   GCC is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+   or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+   License for more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This header provides the LMUL=1 subset of the RISC-V vector intrinsics
+   for the vsetvl, unit-stride load and store, integer and floating-point
+   arithmetic and reduction operations.
+
+   GCC works with 128-bit vectors, the minimum VLEN of the application
+   profiles, so the vector types are fixed-size GNU vector types rather
+   than sizeless ones, and VLMAX is 128 divided by the element width.
+   All operations are tail- and mask-agnostic.  Only the loads, stores
+   and reductions depend on VL; the other operations compute every
+   element.  */
+
+#ifndef _RISCV_VECTOR_H
+#define _RISCV_VECTOR_H
+
+#ifndef __riscv_vector
+#error "riscv_vector.h requires the V extension"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int8_t vint8m1_t __attribute__ ((__vector_size__ (16)));
+typedef int16_t vint16m1_t __attribute__ ((__vector_size__ (16)));
+typedef int32_t vint32m1_t __attribute__ ((__vector_size__ (16)));
+typedef int64_t vint64m1_t __attribute__ ((__vector_size__ (16)));
+typedef uint8_t vuint8m1_t __attribute__ ((__vector_size__ (16)));
+typedef uint16_t vuint16m1_t __attribute__ ((__vector_size__ (16)));
+typedef uint32_t vuint32m1_t __attribute__ ((__vector_size__ (16)));
+typedef uint64_t vuint64m1_t __attribute__ ((__vector_size__ (16)));
+typedef float vfloat32m1_t __attribute__ ((__vector_size__ (16)));
+typedef double vfloat64m1_t __attribute__ ((__vector_size__ (16)));
+
+/* The argument types of the built-in functions.  */
+typedef signed char __rvv_v16qi __attribute__ ((__vector_size__ (16)));
+typedef short __rvv_v8hi __attribute__ ((__vector_size__ (16)));
+typedef int __rvv_v4si __attribute__ ((__vector_size__ (16)));
+typedef long long __rvv_v2di __attribute__ ((__vector_size__ (16)));
+
+#define __RVV_FN(RET) \
+  __extension__ extern __inline RET \
+  __attribute__ ((__always_inline__, __gnu_inline__, __artificial__))
+
+/* VL and VLMAX.  */
+
+#define __RVV_VSETVL(SEW, VLMAX)					\
+  __RVV_FN (size_t) __riscv_vsetvl_e##SEW##m1 (size_t __avl)		\
+  { return __avl < (VLMAX) ? __avl : (VLMAX); }			\
+  __RVV_FN (size_t) __riscv_vsetvlmax_e##SEW##m1 (void)		\
+  { return (VLMAX); }
+
+__RVV_VSETVL (8, 16)
+__RVV_VSETVL (16, 8)
+__RVV_VSETVL (32, 4)
+__RVV_VSETVL (64, 2)
+
+/* Return a mask whose first VL elements are all ones and whose other
+   elements are zero.  */
+
+__RVV_FN (vint8m1_t) __riscv_v_tail_mask_e8 (size_t __vl)
+{
+  return ((vint8m1_t) { 0, 1, 2, 3, 4, 5, 6, 7,
+			8, 9, 10, 11, 12, 13, 14, 15 } < (int8_t) __vl);
+}
+
+__RVV_FN (vint16m1_t) __riscv_v_tail_mask_e16 (size_t __vl)
+{
+  return ((vint16m1_t) { 0, 1, 2, 3, 4, 5, 6, 7 } < (int16_t) __vl);
+}
+
+__RVV_FN (vint32m1_t) __riscv_v_tail_mask_e32 (size_t __vl)
+{
+  return ((vint32m1_t) { 0, 1, 2, 3 } < (int32_t) __vl);
+}
+
+__RVV_FN (vint64m1_t) __riscv_v_tail_mask_e64 (size_t __vl)
+{
+  return ((vint64m1_t) { 0, 1 } < (int64_t) __vl);
+}
+
+/* Operations common to all element types.  T is the vector type, E its
+   element type, and SFX and ESFX the type suffixes of the intrinsics for
+   the vector and element types.  */
+
+#define __RVV_COMMON(SEW, T, E, SFX, ESFX, LD, MV)			\
+  __RVV_FN (T) __riscv_vle##SEW##_v_##SFX (const E *__base, size_t __vl) \
+  { return (T) __builtin_riscv_vle (__base, __vl * sizeof (E)); }	\
+  __RVV_FN (void) __riscv_vse##SEW##_v_##SFX (E *__base, T __value,	\
+					       size_t __vl)		\
+  {									\
+    __builtin_riscv_vse (__base, (__rvv_v16qi) __value,		\
+			 __vl * sizeof (E));				\
+  }									\
+  __RVV_FN (T) __riscv_##MV##_v_##LD##_##SFX (E __x, size_t __vl)	\
+  { (void) __vl; return (T) {} + __x; }				\
+  __RVV_FN (E) __riscv_##MV##_##LD##_s_##SFX##_##ESFX (T __v)		\
+  { return __v[0]; }							\
+  __RVV_FN (T) __riscv_##MV##_s_##LD##_##SFX (E __x, size_t __vl)	\
+  { T __r = {}; (void) __vl; __r[0] = __x; return __r; }
+
+/* Integer arithmetic.  UT is the unsigned vector type of the same width
+   as T, in which the operations that wrap are done.  */
+
+#define __RVV_WRAP_OP(NAME, OP, T, UT, E, SFX)				\
+  __RVV_FN (T) __riscv_##NAME##_vv_##SFX (T __a, T __b, size_t __vl)	\
+  { (void) __vl; return (T) ((UT) __a OP (UT) __b); }			\
+  __RVV_FN (T) __riscv_##NAME##_vx_##SFX (T __a, E __b, size_t __vl)	\
+  { (void) __vl; return (T) ((UT) __a OP (UT) ((T) {} + __b)); }
+
+#define __RVV_DIV_OP(NAME, OP, T, E, SFX)				\
+  __RVV_FN (T) __riscv_##NAME##_vv_##SFX (T __a, T __b, size_t __vl)	\
+  { (void) __vl; return __a OP __b; }					\
+  __RVV_FN (T) __riscv_##NAME##_vx_##SFX (T __a, E __b, size_t __vl)	\
+  { (void) __vl; return __a OP __b; }
+
+#define __RVV_MINMAX_OP(NAME, CMP, T, UT, E, SFX)			\
+  __RVV_FN (T) __riscv_##NAME##_vv_##SFX (T __a, T __b, size_t __vl)	\
+  {									\
+    UT __m = (UT) (__a CMP __b);					\
+    (void) __vl;							\
+    return (T) (((UT) __a & __m) | ((UT) __b & ~__m));			\
+  }									\
+  __RVV_FN (T) __riscv_##NAME##_vx_##SFX (T __a, E __b, size_t __vl)	\
+  { return __riscv_##NAME##_vv_##SFX (__a, (T) {} + __b, __vl); }
+
+/* RVV shifts only use the low log2(SEW) bits of the shift amount.  The
+   shift is done in type CT, which is unsigned except for vsra.  */
+
+#define __RVV_SHIFT_OP(NAME, OP, T, CT, UT, SEW, SFX)			\
+  __RVV_FN (T) __riscv_##NAME##_vv_##SFX (T __a, UT __s, size_t __vl)	\
+  { (void) __vl; return (T) ((CT) __a OP (CT) (__s & ((SEW) - 1))); }	\
+  __RVV_FN (T) __riscv_##NAME##_vx_##SFX (T __a, size_t __s, size_t __vl) \
+  { (void) __vl; return (T) ((CT) __a OP (int) (__s & ((SEW) - 1))); }
+
+#define __RVV_MACC_OP(NAME, OP, T, UT, E, SFX)				\
+  __RVV_FN (T) __riscv_##NAME##_vv_##SFX (T __d, T __a, T __b,		\
+					   size_t __vl)			\
+  { (void) __vl; return (T) ((UT) __d OP (UT) __a * (UT) __b); }	\
+  __RVV_FN (T) __riscv_##NAME##_vx_##SFX (T __d, E __a, T __b,		\
+					   size_t __vl)			\
+  { (void) __vl; return (T) ((UT) __d OP (UT) ((T) {} + __a) * (UT) __b); }
+
+/* Reductions into element 0 of the result.  Elements from VL onwards are
+   replaced by an element that does not change the result.  MODE is the
+   mode of the built-in functions.  */
+
+#define __RVV_REDSUM(T, SEW, SFX, MODE)					\
+  __RVV_FN (T) __riscv_vredsum_vs_##SFX##_##SFX (T __v, T __s,	\
+						  size_t __vl)		\
+  {									\
+    T __m = (T) __riscv_v_tail_mask_e##SEW (__vl);			\
+    return (T) __builtin_riscv_vredsum_##MODE ((__rvv_##MODE) (__v & __m), \
+					       (__rvv_##MODE) __s);	\
+  }
+
+#define __RVV_REDUC(NAME, MINMAX, T, UT, SEW, SFX, MODE)		\
+  __RVV_FN (T) __riscv_##NAME##_vs_##SFX##_##SFX (T __v, T __s,	\
+						 size_t __vl)		\
+  {									\
+    UT __m = (UT) __riscv_v_tail_mask_e##SEW (__vl);			\
+    UT __s0 = (UT) ((T) {} + __s[0]);					\
+    T __w = (T) (((UT) __v & __m) | (__s0 & ~__m));			\
+    __w = __riscv_##MINMAX##_vx_##SFX (__w, __s[0], __vl);		\
+    return (T) __builtin_riscv_##NAME##_##MODE ((__rvv_##MODE) __w);	\
+  }
+
+#define __RVV_INT(SEW, S, U, SFX, USFX)					\
+  __RVV_COMMON (SEW, v##S##m1_t, S##_t, SFX, i##SEW, x, vmv)		\
+  __RVV_COMMON (SEW, v##U##m1_t, U##_t, USFX, u##SEW, x, vmv)		\
+  __RVV_FN (v##U##m1_t)							\
+  __riscv_vreinterpret_v_##SFX##_##USFX (v##S##m1_t __v)		\
+  { return (v##U##m1_t) __v; }						\
+  __RVV_FN (v##S##m1_t)							\
+  __riscv_vreinterpret_v_##USFX##_##SFX (v##U##m1_t __v)		\
+  { return (v##S##m1_t) __v; }						\
+  __RVV_WRAP_OP (vadd, +, v##S##m1_t, v##U##m1_t, S##_t, SFX)		\
+  __RVV_WRAP_OP (vadd, +, v##U##m1_t, v##U##m1_t, U##_t, USFX)		\
+  __RVV_WRAP_OP (vsub, -, v##S##m1_t, v##U##m1_t, S##_t, SFX)		\
+  __RVV_WRAP_OP (vsub, -, v##U##m1_t, v##U##m1_t, U##_t, USFX)		\
+  __RVV_WRAP_OP (vmul, *, v##S##m1_t, v##U##m1_t, S##_t, SFX)		\
+  __RVV_WRAP_OP (vmul, *, v##U##m1_t, v##U##m1_t, U##_t, USFX)		\
+  __RVV_WRAP_OP (vand, &, v##S##m1_t, v##U##m1_t, S##_t, SFX)		\
+  __RVV_WRAP_OP (vand, &, v##U##m1_t, v##U##m1_t, U##_t, USFX)		\
+  __RVV_WRAP_OP (vor, |, v##S##m1_t, v##U##m1_t, S##_t, SFX)		\
+  __RVV_WRAP_OP (vor, |, v##U##m1_t, v##U##m1_t, U##_t, USFX)		\
+  __RVV_WRAP_OP (vxor, ^, v##S##m1_t, v##U##m1_t, S##_t, SFX)		\
+  __RVV_WRAP_OP (vxor, ^, v##U##m1_t, v##U##m1_t, U##_t, USFX)		\
+  __RVV_FN (v##S##m1_t)							\
+  __riscv_vrsub_vx_##SFX (v##S##m1_t __a, S##_t __b, size_t __vl)	\
+  { return __riscv_vsub_vv_##SFX ((v##S##m1_t) {} + __b, __a, __vl); }	\
+  __RVV_FN (v##U##m1_t)							\
+  __riscv_vrsub_vx_##USFX (v##U##m1_t __a, U##_t __b, size_t __vl)	\
+  { return __riscv_vsub_vv_##USFX ((v##U##m1_t) {} + __b, __a, __vl); }	\
+  __RVV_DIV_OP (vdiv, /, v##S##m1_t, S##_t, SFX)			\
+  __RVV_DIV_OP (vdivu, /, v##U##m1_t, U##_t, USFX)			\
+  __RVV_DIV_OP (vrem, %, v##S##m1_t, S##_t, SFX)			\
+  __RVV_DIV_OP (vremu, %, v##U##m1_t, U##_t, USFX)			\
+  __RVV_MINMAX_OP (vmin, <, v##S##m1_t, v##U##m1_t, S##_t, SFX)	\
+  __RVV_MINMAX_OP (vminu, <, v##U##m1_t, v##U##m1_t, U##_t, USFX)	\
+  __RVV_MINMAX_OP (vmax, >, v##S##m1_t, v##U##m1_t, S##_t, SFX)	\
+  __RVV_MINMAX_OP (vmaxu, >, v##U##m1_t, v##U##m1_t, U##_t, USFX)	\
+  __RVV_SHIFT_OP (vsll, <<, v##S##m1_t, v##U##m1_t, v##U##m1_t, SEW, SFX) \
+  __RVV_SHIFT_OP (vsll, <<, v##U##m1_t, v##U##m1_t, v##U##m1_t, SEW, USFX) \
+  __RVV_SHIFT_OP (vsra, >>, v##S##m1_t, v##S##m1_t, v##U##m1_t, SEW, SFX) \
+  __RVV_SHIFT_OP (vsrl, >>, v##U##m1_t, v##U##m1_t, v##U##m1_t, SEW, USFX) \
+  __RVV_MACC_OP (vmacc, +, v##S##m1_t, v##U##m1_t, S##_t, SFX)		\
+  __RVV_MACC_OP (vmacc, +, v##U##m1_t, v##U##m1_t, U##_t, USFX)		\
+  __RVV_MACC_OP (vnmsac, -, v##S##m1_t, v##U##m1_t, S##_t, SFX)		\
+  __RVV_MACC_OP (vnmsac, -, v##U##m1_t, v##U##m1_t, U##_t, USFX)
+
+#define __RVV_INT_REDUC(SEW, S, U, SFX, USFX, MODE)			\
+  __RVV_REDSUM (v##S##m1_t, SEW, SFX, MODE)				\
+  __RVV_REDSUM (v##U##m1_t, SEW, USFX, MODE)				\
+  __RVV_REDUC (vredmax, vmax, v##S##m1_t, v##U##m1_t, SEW, SFX, MODE)	\
+  __RVV_REDUC (vredmin, vmin, v##S##m1_t, v##U##m1_t, SEW, SFX, MODE)	\
+  __RVV_REDUC (vredmaxu, vmaxu, v##U##m1_t, v##U##m1_t, SEW, USFX, MODE) \
+  __RVV_REDUC (vredminu, vminu, v##U##m1_t, v##U##m1_t, SEW, USFX, MODE)
+
+__RVV_INT (8, int8, uint8, i8m1, u8m1)
+__RVV_INT (16, int16, uint16, i16m1, u16m1)
+__RVV_INT (32, int32, uint32, i32m1, u32m1)
+__RVV_INT (64, int64, uint64, i64m1, u64m1)
+
+__RVV_INT_REDUC (8, int8, uint8, i8m1, u8m1, v16qi)
+__RVV_INT_REDUC (16, int16, uint16, i16m1, u16m1, v8hi)
+__RVV_INT_REDUC (32, int32, uint32, i32m1, u32m1, v4si)
+#if __riscv_xlen == 64
+__RVV_INT_REDUC (64, int64, uint64, i64m1, u64m1, v2di)
+#endif
+
+/* Floating-point arithmetic.  vfmacc and vfnmsac are fused when
+   floating-point contraction is enabled, as it is by default.  */
+
+#define __RVV_FLOAT_OP(NAME, OP, T, E, SFX)				\
+  __RVV_FN (T) __riscv_##NAME##_vv_##SFX (T __a, T __b, size_t __vl)	\
+  { (void) __vl; return __a OP __b; }					\
+  __RVV_FN (T) __riscv_##NAME##_vf_##SFX (T __a, E __b, size_t __vl)	\
+  { (void) __vl; return __a OP __b; }
+
+#define __RVV_FLOAT_ROP(NAME, OP, T, E, SFX)				\
+  __RVV_FN (T) __riscv_##NAME##_vf_##SFX (T __a, E __b, size_t __vl)	\
+  { (void) __vl; return __b OP __a; }
+
+#define __RVV_FLOAT_MACC_OP(NAME, OP, T, E, SFX)			\
+  __RVV_FN (T) __riscv_##NAME##_vv_##SFX (T __d, T __a, T __b,		\
+					   size_t __vl)			\
+  { (void) __vl; return __d OP __a * __b; }				\
+  __RVV_FN (T) __riscv_##NAME##_vf_##SFX (T __d, E __a, T __b,		\
+					   size_t __vl)			\
+  { (void) __vl; return __d OP __a * __b; }
+
+/* The ordered sum adds the elements in order; the unordered one is
+   allowed to do the same.  */
+
+#define __RVV_FLOAT_REDSUM(NAME, T, E, SFX)				\
+  __RVV_FN (T) __riscv_##NAME##_vs_##SFX##_##SFX (T __v, T __s,	\
+						 size_t __vl)		\
+  {									\
+    E __sum = __s[0];							\
+    for (size_t __i = 0; __i < __vl; __i++)				\
+      __sum += __v[__i];						\
+    __s[0] = __sum;							\
+    return __s;								\
+  }
+
+#define __RVV_FLOAT(SEW, T, E, SFX)					\
+  __RVV_COMMON (SEW, T, E, SFX, f##SEW, f, vfmv)			\
+  __RVV_FLOAT_OP (vfadd, +, T, E, SFX)					\
+  __RVV_FLOAT_OP (vfsub, -, T, E, SFX)					\
+  __RVV_FLOAT_OP (vfmul, *, T, E, SFX)					\
+  __RVV_FLOAT_OP (vfdiv, /, T, E, SFX)					\
+  __RVV_FLOAT_ROP (vfrsub, -, T, E, SFX)				\
+  __RVV_FLOAT_ROP (vfrdiv, /, T, E, SFX)				\
+  __RVV_FLOAT_MACC_OP (vfmacc, +, T, E, SFX)				\
+  __RVV_FLOAT_MACC_OP (vfnmsac, -, T, E, SFX)				\
+  __RVV_FLOAT_REDSUM (vfredosum, T, E, SFX)				\
+  __RVV_FLOAT_REDSUM (vfredusum, T, E, SFX)
+
+__RVV_FLOAT (32, vfloat32m1_t, float, f32m1)
+__RVV_FLOAT (64, vfloat64m1_t, double, f64m1)
+
+#undef __RVV_FN
+#undef __RVV_VSETVL
+#undef __RVV_COMMON
+#undef __RVV_WRAP_OP
+#undef __RVV_DIV_OP
+#undef __RVV_MINMAX_OP
+#undef __RVV_SHIFT_OP
+#undef __RVV_MACC_OP
+#undef __RVV_REDSUM
+#undef __RVV_REDUC
+#undef __RVV_INT
+#undef __RVV_INT_REDUC
+#undef __RVV_FLOAT_OP
+#undef __RVV_FLOAT_ROP
+#undef __RVV_FLOAT_MACC_OP
+#undef __RVV_FLOAT_REDSUM
+#undef __RVV_FLOAT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VECTOR_H */
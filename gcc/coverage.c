@@ -128,6 +128,7 @@ static const char *const ctr_names[GCOV_COUNTERS] = {
 #undef DEF_GCOV_COUNTER
 
 /* Forward declarations.  */
+static bool open_counts_file (void);
 static void read_counts_file (void);
 static tree build_var (tree, tree, int);
 static void build_fn_info_type (tree, unsigned, tree);
@@ -180,6 +181,71 @@ counts_entry::remove (counts_entry *entry)
 /* Hash table of count data.  */
 static hash_table<counts_entry> *counts_hash;
 
+/* Open the counts file for reading.  If -fprofile-use names a profile
+   database rather than a directory, look the data file up in its index
+   and leave the database positioned at the start of its contents.  */
+
+static bool
+open_counts_file (void)
+{
+  struct stat st;
+
+  if (!profile_data_prefix
+      || stat (profile_data_prefix, &st) != 0
+      || !S_ISREG (st.st_mode))
+    return gcov_open (da_file_name, 1);
+
+  if (!gcov_open (profile_data_prefix, 1))
+    return false;
+
+  if (!gcov_magic (gcov_read_unsigned (), GCOV_DB_MAGIC))
+    {
+      warning (0, "%qs is not a gcov profile database", profile_data_prefix);
+      gcov_close ();
+      return false;
+    }
+  if (gcov_read_unsigned () != GCOV_VERSION)
+    {
+      warning (0, "%qs is a profile database of a different compiler "
+	       "version", profile_data_prefix);
+      gcov_close ();
+      return false;
+    }
+
+  /* The index is keyed by the name relative to the profile directory.  */
+  const char *key = da_file_name + strlen (profile_data_prefix);
+  while (IS_DIR_SEPARATOR (*key))
+    key++;
+
+  gcov_unsigned_t count = gcov_read_unsigned ();
+  gcov_position_t index = gcov_position ();
+  gcov_unsigned_t lo = 0, hi = count;
+  while (lo < hi && !gcov_is_error ())
+    {
+      gcov_unsigned_t mid = lo + (hi - lo) / 2;
+
+      gcov_sync (index, mid);
+      gcov_sync (gcov_read_unsigned (), 0);
+      gcov_position_t data = gcov_read_unsigned ();
+      gcov_read_unsigned ();
+      const char *name = gcov_read_string ();
+      int cmp = strcmp (key, name ? name : "");
+
+      if (cmp == 0)
+	{
+	  gcov_sync (data, 0);
+	  return true;
+	}
+      if (cmp < 0)
+	hi = mid;
+      else
+	lo = mid + 1;
+    }
+
+  gcov_close ();
+  return false;
+}
+
 /* Read in the counts file, if available.  */
 
 static void
@@ -191,7 +257,7 @@ read_counts_file (void)
   unsigned lineno_checksum = 0;
   unsigned cfg_checksum = 0;
 
-  if (!gcov_open (da_file_name, 1))
+  if (!open_counts_file ())
     return;
 
   if (!gcov_magic (gcov_read_unsigned (), GCOV_DATA_MAGIC))
@@ -438,6 +504,29 @@ coverage_counter_alloc (unsigned counter, unsigned num)
   return 1;
 }
 
+/* Return the number of counters of type COUNTER allocated so far for
+   the current function.  */
+
+unsigned
+coverage_counter_count (unsigned counter)
+{
+  return fn_n_ctrs[counter];
+}
+
+/* Return how many copies of the counters of type COUNTER each function
+   has.  With -fprofile-update=sharded each thread updates the edge
+   counters in one of several copies, which libgcov folds together
+   when it dumps them.  */
+
+unsigned
+coverage_counter_shards (unsigned counter)
+{
+  if (counter == GCOV_COUNTER_ARCS
+      && flag_profile_update == PROFILE_UPDATE_SHARDED)
+    return 1u << floor_log2 (param_profile_update_shards);
+  return 1;
+}
+
 /* Generate a tree to access COUNTER NO.  */
 
 tree
@@ -712,7 +801,8 @@ coverage_end_function (unsigned lineno_checksum, unsigned cfg_checksum)
 	    item->ctr_vars[i] = var;
 	  if (var)
 	    {
-	      tree array_type = build_index_type (size_int (fn_n_ctrs[i] - 1));
+	      unsigned n = fn_n_ctrs[i] * coverage_counter_shards (i);
+	      tree array_type = build_index_type (size_int (n - 1));
 	      array_type = build_array_type (get_gcov_type (), array_type);
 	      TREE_TYPE (var) = array_type;
 	      DECL_SIZE (var) = TYPE_SIZE (array_type);
@@ -768,6 +858,11 @@ build_var (tree fn_decl, tree type, int counter)
   DECL_NONALIASED (var) = 1;
   SET_DECL_ALIGN (var, TYPE_ALIGN (type));
 
+  /* libgcov maps this section onto the profile file in continuous
+     mode; it must match the section it looks for.  */
+  if (flag_profile_continuous && counter == GCOV_COUNTER_ARCS)
+    set_decl_section_name (var, "__gcov_cnts");
+
   return var;
 }
 
@@ -877,8 +972,8 @@ build_fn_info (const struct coverage_data *data, tree type, tree key)
 
 	if (var)
 	  count
-	    = tree_to_shwi (TYPE_MAX_VALUE (TYPE_DOMAIN (TREE_TYPE (var))))
-	    + 1;
+	    = (tree_to_shwi (TYPE_MAX_VALUE (TYPE_DOMAIN (TREE_TYPE (var))))
+	       + 1) / coverage_counter_shards (ix);
 
 	CONSTRUCTOR_APPEND_ELT (ctr, TYPE_FIELDS (ctr_type),
 				build_int_cstu (get_gcov_unsigned_t (),
@@ -950,6 +1045,12 @@ build_info_type (tree type, tree fn_info_ptr_type)
 		      get_gcov_unsigned_t ());
   DECL_CHAIN (field) = fields;
   fields = field;
+
+  /* n_shards */
+  field = build_decl (BUILTINS_LOCATION, FIELD_DECL, NULL_TREE,
+		      get_gcov_unsigned_t ());
+  DECL_CHAIN (field) = fields;
+  fields = field;
   
   /* function_info pointer pointer */
   fn_info_ptr_type = build_pointer_type
@@ -1036,6 +1137,13 @@ build_info (tree info_type, tree fn_ary)
   CONSTRUCTOR_APPEND_ELT (v1, info_fields, n_funcs);
   info_fields = DECL_CHAIN (info_fields);
 
+  /* n_shards */
+  CONSTRUCTOR_APPEND_ELT (v1, info_fields,
+			  build_int_cstu (TREE_TYPE (info_fields),
+					  coverage_counter_shards
+					    (GCOV_COUNTER_ARCS)));
+  info_fields = DECL_CHAIN (info_fields);
+
   /* functions */
   CONSTRUCTOR_APPEND_ELT (v1, info_fields,
 			  build1 (ADDR_EXPR, TREE_TYPE (info_fields), fn_ary));
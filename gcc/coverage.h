@@ -44,6 +44,10 @@ extern unsigned coverage_compute_lineno_checksum (void);
 
 /* Allocate some counters. Repeatable per function.  */
 extern int coverage_counter_alloc (unsigned /*counter*/, unsigned/*num*/);
+/* Number of counters allocated for the current function.  */
+extern unsigned coverage_counter_count (unsigned /*counter*/);
+/* Number of copies of each counter.  */
+extern unsigned coverage_counter_shards (unsigned /*counter*/);
 /* Use a counter from the most recent allocation.  */
 extern tree tree_coverage_counter_ref (unsigned /*counter*/, unsigned/*num*/);
 /* Use a counter address from the most recent allocation.  */
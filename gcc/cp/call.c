@@ -3344,6 +3344,36 @@ add_builtin_candidates (struct z_candidate **candidates, enum tree_code code,
 }
 
 
+/* Return true if no specialization of TMPL can be called with NARGS
+   arguments, because its function parameter list, which has no pack
+   expansions, has too few parameters or too many without default
+   arguments.  Checking that costs far less than deduction, which
+   would fail anyway.  */
+
+static bool
+template_arity_mismatch_p (tree tmpl, unsigned int nargs)
+{
+  tree parms = FUNCTION_FIRST_USER_PARMTYPE (tmpl);
+  unsigned int required = 0, total = 0;
+  bool defaulted = false;
+
+  for (; parms && parms != void_list_node; parms = TREE_CHAIN (parms))
+    {
+      if (PACK_EXPANSION_P (TREE_VALUE (parms)))
+	return false;
+      if (TREE_PURPOSE (parms))
+	defaulted = true;
+      if (!defaulted)
+	++required;
+      ++total;
+    }
+
+  if (nargs < required)
+    return true;
+  /* Without a terminating void_list_node, TMPL takes an ellipsis.  */
+  return parms == void_list_node && nargs > total;
+}
+
 /* If TMPL can be successfully instantiated as indicated by
    EXPLICIT_TARGS and ARGLIST, adds the instantiation to CANDIDATES.
 
@@ -3450,6 +3480,19 @@ add_template_candidate_real (struct z_candidate **candidates, tree tmpl,
     }
   gcc_assert (ia == nargs_without_in_chrg);
 
+  /* Don't substitute explicit arguments or deduce for a call that has
+     the wrong number of arguments.  Should the candidate need to be
+     explained, unification is repeated and reports the mismatch.  */
+  if (strict == DEDUCE_CALL && !return_type
+      && template_arity_mismatch_p (tmpl, nargs_without_in_chrg))
+    {
+      reason = template_unification_rejection (tmpl, explicit_targs,
+					       targs, args_without_in_chrg,
+					       nargs_without_in_chrg,
+					       return_type, strict, flags);
+      goto fail;
+    }
+
   errs = errorcount+sorrycount;
   if (!obj)
     convs = alloc_conversions (nargs);
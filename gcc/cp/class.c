@@ -1017,7 +1017,14 @@ add_method (tree type, tree method, bool via_using)
 
   gcc_assert (!DECL_EXTERN_C_P (method));
 
-  tree *slot = find_member_slot (type, DECL_NAME (method));
+  /* lookup_member caches lookups in complete classes, other than of
+     the special member functions that are declared lazily.  */
+  tree name = DECL_NAME (method);
+  if (COMPLETE_TYPE_P (type)
+      && !IDENTIFIER_CDTOR_P (name) && name != assign_op_identifier)
+    clear_member_lookup_cache ();
+
+  tree *slot = find_member_slot (type, name);
   tree current_fns = slot ? *slot : NULL_TREE;
 
   /* See below.  */
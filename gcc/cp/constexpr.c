@@ -1013,6 +1013,9 @@ struct GTY((for_user)) constexpr_call {
   hashval_t hash;
   /* Whether __builtin_is_constant_evaluated() should evaluate to true.  */
   bool manifestly_const_eval;
+  /* The number of operations the evaluation took, saturated.  Zero for
+     calls read from a module.  */
+  unsigned ops;
 };
 
 struct constexpr_call_hasher : ggc_ptr_hash<constexpr_call>
@@ -1194,6 +1197,74 @@ maybe_initialize_constexpr_call_table (void)
     constexpr_call_table = hash_table<constexpr_call_hasher>::create_ggc (101);
 }
 
+/* Compute the hash of CALL from its function, bindings and
+   manifestly_const_eval flag.  */
+
+static hashval_t
+constexpr_call_hash (const constexpr_call *call)
+{
+  hashval_t hash = constexpr_fundef_hasher::hash (call->fundef);
+  hash = iterative_hash_template_arg (call->bindings, hash);
+  return iterative_hash_object (call->manifestly_const_eval, hash);
+}
+
+/* Calls that took fewer operations than this to evaluate are not worth
+   streaming to a module.  */
+
+static const unsigned constexpr_call_stream_ops = 1000;
+
+/* Walk the constexpr call table, calling FN with the function, bindings,
+   result and manifestly_const_eval flag of each successfully evaluated
+   call that was expensive enough to be worth remembering beyond this
+   translation unit.  */
+
+void
+walk_constexpr_calls (void (*fn) (tree, tree, tree, bool, void *),
+		      void *data)
+{
+  if (constexpr_call_table == NULL)
+    return;
+
+  hash_table<constexpr_call_hasher>::iterator end
+    (constexpr_call_table->end ());
+  for (hash_table<constexpr_call_hasher>::iterator iter
+	 (constexpr_call_table->begin ()); iter != end; ++iter)
+    {
+      constexpr_call *call = *iter;
+      if (call->ops >= constexpr_call_stream_ops
+	  && call->result && call->result != error_mark_node
+	  && call->result != void_node)
+	fn (call->fundef->decl, call->bindings, call->result,
+	    call->manifestly_const_eval, data);
+    }
+}
+
+/* Enter the call of FUN with BINDINGS, with the value RESULT, into the
+   constexpr call table, as if we had evaluated it.  Used for calls
+   evaluated in the translation unit of an imported module.  */
+
+void
+record_constexpr_call (tree fun, tree bindings, tree result,
+		       bool manifestly_const_eval)
+{
+  constexpr_fundef *fundef = retrieve_constexpr_fundef (fun);
+  if (fundef == NULL || fundef->body == NULL
+      || fundef->result == error_mark_node)
+    return;
+
+  constexpr_call call
+    = { fundef, bindings, result, 0, manifestly_const_eval, 0 };
+  call.hash = constexpr_call_hash (&call);
+
+  maybe_initialize_constexpr_call_table ();
+  constexpr_call **slot = constexpr_call_table->find_slot (&call, INSERT);
+  if (*slot == NULL)
+    {
+      *slot = ggc_alloc<constexpr_call> ();
+      **slot = call;
+    }
+}
+
 /* During constexpr CALL_EXPR evaluation, to avoid issues with sharing when
    a function happens to get called recursively, we unshare the callee
    function's body and evaluate this unshared copy instead of evaluating the
@@ -2298,7 +2369,7 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
   location_t loc = cp_expr_loc_or_input_loc (t);
   tree fun = get_function_named_in_call (t);
   constexpr_call new_call
-    = { NULL, NULL, NULL, 0, ctx->manifestly_const_eval };
+    = { NULL, NULL, NULL, 0, ctx->manifestly_const_eval, 0 };
   int depth_ok;
 
   if (fun == NULL_TREE)
@@ -2646,11 +2717,7 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
   constexpr_call *entry = NULL;
   if (depth_ok && !non_constant_args && ctx->strict)
     {
-      new_call.hash = constexpr_fundef_hasher::hash (new_call.fundef);
-      new_call.hash
-	= iterative_hash_template_arg (new_call.bindings, new_call.hash);
-      new_call.hash
-	= iterative_hash_object (ctx->manifestly_const_eval, new_call.hash);
+      new_call.hash = constexpr_call_hash (&new_call);
 
       /* If we have seen this call before, we are done.  */
       maybe_initialize_constexpr_call_table ();
@@ -2753,6 +2820,7 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
 	  ctx_with_save_exprs.call = &new_call;
 	  unsigned save_heap_alloc_count = ctx->global->heap_vars.length ();
 	  unsigned save_heap_dealloc_count = ctx->global->heap_dealloc_count;
+	  HOST_WIDE_INT save_ops_count = ctx->global->constexpr_ops_count;
 
 	  /* If this is a constexpr destructor, the object's const and volatile
 	     semantics are no longer in effect; see [class.dtor]p5.  */
@@ -2820,6 +2888,13 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
 	  /* Make the unshared function copy we used available for re-use.  */
 	  save_fundef_copy (fun, copy);
 
+	  if (entry)
+	    {
+	      HOST_WIDE_INT ops
+		= ctx->global->constexpr_ops_count - save_ops_count;
+	      entry->ops = ops < 0 ? 0 : MIN (ops, (HOST_WIDE_INT) UINT_MAX);
+	    }
+
 	  /* If the call allocated some heap object that hasn't been
 	     deallocated during the call, or if it deallocated some heap
 	     object it has not allocated, the call isn't really stateless
@@ -3255,6 +3330,17 @@ cxx_eval_binary_expression (const constexpr_ctx *ctx, tree t,
 					   overflow_p);
     }
 
+  /* Arithmetic on two integer constants is the common case; go straight
+     to const_binop rather than through the general folder.  */
+  if (r == NULL_TREE
+      && TREE_CODE (lhs) == INTEGER_CST
+      && TREE_CODE (rhs) == INTEGER_CST)
+    {
+      r = const_binop (code, type, lhs, rhs);
+      if (r && TREE_TYPE (r) != type)
+	r = fold_convert_loc (loc, type, r);
+    }
+
   if (r == NULL_TREE)
     r = fold_binary_loc (loc, code, type, lhs, rhs);
 
@@ -6054,7 +6140,10 @@ cxx_eval_constant_expression (const constexpr_ctx *ctx, tree t,
       return t;
     }
 
-  location_t loc = cp_expr_loc_or_input_loc (t);
+  /* Remember any location wrapper, but don't compute its location until
+     we know T isn't a constant; constants are by far the most common leaf
+     and never need it.  */
+  tree orig_t = t;
 
   STRIP_ANY_LOCATION_WRAPPER (t);
 
@@ -6081,6 +6170,8 @@ cxx_eval_constant_expression (const constexpr_ctx *ctx, tree t,
       return t;
     }
 
+  location_t loc = cp_expr_loc_or_input_loc (orig_t);
+
   /* Avoid excessively long constexpr evaluations.  */
   if (++ctx->global->constexpr_ops_count >= constexpr_ops_limit)
     {
@@ -6717,6 +6808,22 @@ cxx_eval_constant_expression (const constexpr_ctx *ctx, tree t,
 	if (VOID_TYPE_P (type))
 	  return void_node;
 
+	/* Integral conversions of an integer constant are common and need
+	   none of the checks below.  As below, an out-of-range value doesn't
+	   set TREE_OVERFLOW.  */
+	if (TREE_CODE (op) == INTEGER_CST
+	    && tcode != VIEW_CONVERT_EXPR
+	    && INTEGRAL_TYPE_P (type)
+	    && INTEGRAL_TYPE_P (TREE_TYPE (op)))
+	  {
+	    if (TREE_TYPE (op) == type)
+	      r = op;
+	    else
+	      r = force_fit_type (type, wi::to_widest (op), 0,
+				  TREE_OVERFLOW (op));
+	    break;
+	  }
+
 	if (TREE_CODE (t) == CONVERT_EXPR
 	    && ARITHMETIC_TYPE_P (type)
 	    && INDIRECT_TYPE_P (TREE_TYPE (op))
@@ -7143,6 +7250,17 @@ cxx_eval_outermost_constant_expr (tree t, bool allow_non_constant,
 {
   auto_timevar time (TV_CONSTEXPR);
 
+  char *trace_detail = NULL;
+  if (time_trace_active)
+    {
+      expanded_location xloc = expand_location (cp_expr_loc_or_input_loc (t));
+      if (xloc.file)
+	trace_detail = xasprintf ("%s:%d:%d", xloc.file, xloc.line,
+				  xloc.column);
+    }
+  auto_time_trace trace ("ConstantEvaluation", trace_detail);
+  free (trace_detail);
+
   bool non_constant_p = false;
   bool overflow_p = false;
 
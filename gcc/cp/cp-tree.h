@@ -5519,6 +5519,7 @@ struct GTY((for_user)) spec_entry
   tree tmpl;  /* The general template this is a specialization of.  */
   tree args;  /* The args for this (maybe-partial) specialization.  */
   tree spec;  /* The specialization itself.  */
+  hashval_t hash;  /* The hash of TMPL and ARGS, see spec_hasher.  */
 };
 
 /* in class.c */
@@ -7288,6 +7289,7 @@ extern tree lookup_member			(tree, tree, int, bool,
 						 tsubst_flags_t,
 						 access_failure_info *afi = NULL);
 extern tree lookup_member_fuzzy		(tree, tree, bool);
+extern void clear_member_lookup_cache		(void);
 extern tree locate_field_accessor		(tree, tree, bool);
 extern int look_for_overrides			(tree, tree);
 extern void get_pure_virtuals			(tree);
@@ -8183,6 +8185,10 @@ extern bool literal_type_p                      (tree);
 extern void maybe_save_constexpr_fundef		(tree);
 extern void register_constexpr_fundef		(const constexpr_fundef &);
 extern constexpr_fundef *retrieve_constexpr_fundef	(tree);
+extern void walk_constexpr_calls			(void (*)(tree, tree, tree,
+							  bool, void *),
+						 void *);
+extern void record_constexpr_call		(tree, tree, tree, bool);
 extern bool is_valid_constexpr_fn		(tree, bool);
 extern bool check_constexpr_ctor_body           (tree, tree, bool);
 extern tree constexpr_fn_retval		(tree);
@@ -1398,6 +1398,10 @@ public:
   /* Find section by index.  */
   const section *find (unsigned snum, unsigned type = SHT_PROGBITS);
 
+public:
+  /* Hint that the sections from SNUM onwards will be read soon.  */
+  void prefetch (unsigned snum);
+
 public:
   /* Release the string table, when we're done with it.  */
   void release ()
@@ -1690,6 +1694,29 @@ elf_in::find (unsigned snum, unsigned type)
   return sec;
 }
 
+/* Ask the system to start paging in the sections from SNUM to the end
+   of the file, which also holds the string and section tables.  We
+   madvised MADV_RANDOM, so otherwise they would be faulted in a page at
+   a time as we read them.  Sections are laid out in order, so this
+   covers all the later ones.  */
+
+void
+elf_in::prefetch (unsigned snum ATTRIBUTE_UNUSED)
+{
+#if MAPPED_READING && defined (MADV_WILLNEED) \
+  && HAVE_SYSCONF && defined (_SC_PAGE_SIZE)
+  const section *sec = get_section (snum);
+  if (!hdr.buffer || !sec || sec->offset >= hdr.pos)
+    return;
+
+  /* The mapping is page aligned, but the section need not be.  */
+  unsigned page_size = sysconf (_SC_PAGE_SIZE);
+  unsigned start = sec->offset & ~(page_size - 1);
+  /* A failure here is harmless, we'll just read more slowly.  */
+  madvise (hdr.buffer + start, hdr.pos - start, MADV_WILLNEED);
+#endif
+}
+
 /* Find a section NAME and TYPE.  Return section number, or zero on
    failure.  */
 
@@ -3577,6 +3604,11 @@ class GTY((chain_next ("%h.parent"), for_user)) module_state {
   unsigned write_inits (elf_out *to, depset::hash &, unsigned *crc_ptr);
   bool read_inits (unsigned count);
 
+ private:
+  unsigned write_constexpr_calls (elf_out *to, depset::hash &,
+				  unsigned *crc_ptr);
+  bool read_constexpr_calls (unsigned count);
+
  private:
   unsigned write_pendings (elf_out *to, vec<depset *> depsets,
 			   depset::hash &, unsigned *crc_ptr);
@@ -14347,6 +14379,7 @@ enum module_state_counts
   MSC_bindings,
   MSC_macros,
   MSC_inits,
+  MSC_cexpr_calls,
   MSC_HWM
 };
 
@@ -17199,6 +17232,201 @@ module_state::read_inits (unsigned count)
   return true;
 }
 
+/* Return true if T, part of a memoized constexpr call, only refers to
+   entities that are in TABLE, so that we can stream it.  We're
+   conservative and only accept the constants that the evaluation of a
+   constexpr function usually produces.  */
+
+static bool
+constexpr_call_streamable_p (depset::hash &table, tree t)
+{
+  if (!t)
+    return true;
+
+  if (TYPE_P (t))
+    {
+      if (tree name = TYPE_NAME (t))
+	if (TREE_CODE (name) == TYPE_DECL
+	    && (DECL_ORIGINAL_TYPE (name)
+		|| TREE_CODE (t) == RECORD_TYPE
+		|| TREE_CODE (t) == UNION_TYPE
+		|| TREE_CODE (t) == ENUMERAL_TYPE))
+	  /* Streamed by name.  */
+	  return table.find_dependency (name) != NULL;
+
+      if (TYPE_MAIN_VARIANT (t) != t)
+	return constexpr_call_streamable_p (table, TYPE_MAIN_VARIANT (t));
+
+      switch (TREE_CODE (t))
+	{
+	case VOID_TYPE:
+	case BOOLEAN_TYPE:
+	case INTEGER_TYPE:
+	case REAL_TYPE:
+	case NULLPTR_TYPE:
+	  return true;
+
+	case POINTER_TYPE:
+	case REFERENCE_TYPE:
+	case COMPLEX_TYPE:
+	case VECTOR_TYPE:
+	  return constexpr_call_streamable_p (table, TREE_TYPE (t));
+
+	case ARRAY_TYPE:
+	  return (constexpr_call_streamable_p (table, TREE_TYPE (t))
+		  && constexpr_call_streamable_p (table, TYPE_DOMAIN (t)));
+
+	default:
+	  return false;
+	}
+    }
+
+  switch (TREE_CODE (t))
+    {
+    case TREE_VEC:
+      for (int ix = TREE_VEC_LENGTH (t); ix--;)
+	if (!constexpr_call_streamable_p (table, TREE_VEC_ELT (t, ix)))
+	  return false;
+      return true;
+
+    case INTEGER_CST:
+    case REAL_CST:
+    case STRING_CST:
+    case COMPLEX_CST:
+    case VECTOR_CST:
+      return constexpr_call_streamable_p (table, TREE_TYPE (t));
+
+    case CONSTRUCTOR:
+      {
+	if (!constexpr_call_streamable_p (table, TREE_TYPE (t)))
+	  return false;
+	unsigned HOST_WIDE_INT ix;
+	tree index, value;
+	FOR_EACH_CONSTRUCTOR_ELT (CONSTRUCTOR_ELTS (t), ix, index, value)
+	  if (!constexpr_call_streamable_p (table, index)
+	      || !constexpr_call_streamable_p (table, value))
+	    return false;
+	return true;
+      }
+
+    case RANGE_EXPR:
+    case NOP_EXPR:
+    case ADDR_EXPR:
+    case POINTER_PLUS_EXPR:
+      if (!constexpr_call_streamable_p (table, TREE_TYPE (t)))
+	return false;
+      for (int ix = TREE_OPERAND_LENGTH (t); ix--;)
+	if (!constexpr_call_streamable_p (table, TREE_OPERAND (t, ix)))
+	  return false;
+      return true;
+
+    case FIELD_DECL:
+      return constexpr_call_streamable_p (table, DECL_CONTEXT (t));
+
+    case VAR_DECL:
+    case FUNCTION_DECL:
+      return table.find_dependency (t) != NULL;
+
+    default:
+      return false;
+    }
+}
+
+struct constexpr_call_data
+{
+  depset::hash *table;
+  auto_vec<tree> calls;
+};
+
+/* The constexpr call walker callback for write_constexpr_calls.  */
+
+static void
+constexpr_call_add (tree fn, tree bindings, tree result,
+		    bool manifestly_const_eval, void *data_)
+{
+  constexpr_call_data *data = static_cast <constexpr_call_data *> (data_);
+
+  if (!data->table->find_dependency (fn)
+      || !constexpr_call_streamable_p (*data->table, bindings)
+      || !constexpr_call_streamable_p (*data->table, result))
+    return;
+
+  data->calls.safe_push (fn);
+  data->calls.safe_push (bindings);
+  data->calls.safe_push (result);
+  data->calls.safe_push (manifestly_const_eval
+			 ? boolean_true_node : boolean_false_node);
+}
+
+/* Stream the results of expensive constexpr calls to functions we're
+   writing, so that importers need not evaluate them again.  */
+
+unsigned
+module_state::write_constexpr_calls (elf_out *to, depset::hash &table,
+				     unsigned *crc_ptr)
+{
+  constexpr_call_data data;
+  data.table = &table;
+  walk_constexpr_calls (constexpr_call_add, &data);
+  if (data.calls.is_empty ())
+    return 0;
+
+  dump () && dump ("Writing constexpr calls");
+  dump.indent ();
+
+  unsigned count = 0;
+  trees_out sec (to, this, table, ~0u);
+  sec.begin ();
+
+  for (unsigned ix = 0; ix != data.calls.length (); ix += 4, count++)
+    {
+      tree fn = data.calls[ix];
+
+      dump ("Constexpr call:%u to %N", count, fn);
+      sec.tree_node (fn);
+      sec.tree_node (data.calls[ix + 1]);
+      sec.tree_node (data.calls[ix + 2]);
+      sec.u (data.calls[ix + 3] == boolean_true_node);
+    }
+
+  sec.end (to, to->name (MOD_SNAME_PFX ".cxc"), crc_ptr);
+  dump.outdent ();
+
+  return count;
+}
+
+bool
+module_state::read_constexpr_calls (unsigned count)
+{
+  trees_in sec (this);
+  if (!sec.begin (loc, from (), from ()->find (MOD_SNAME_PFX ".cxc")))
+    return false;
+  dump () && dump ("Reading %u constexpr calls", count);
+  dump.indent ();
+
+  lazy_snum = ~0u;
+  for (unsigned ix = 0; ix != count; ix++)
+    {
+      /* Referencing the function loads its definition.  */
+      tree fn = sec.tree_node ();
+      tree bindings = sec.tree_node ();
+      tree result = sec.tree_node ();
+      bool manifestly_const_eval = sec.u ();
+
+      if (sec.get_overrun ())
+	break;
+      dump ("Constexpr call:%u to %N", ix, fn);
+      if (fn && TREE_CODE (fn) == FUNCTION_DECL && result)
+	record_constexpr_call (fn, bindings, result, manifestly_const_eval);
+    }
+  lazy_snum = 0;
+  post_load_processing ();
+  dump.outdent ();
+  if (!sec.end (from ()))
+    return false;
+  return true;
+}
+
 void
 module_state::write_counts (elf_out *to, unsigned counts[MSC_HWM],
 			    unsigned *crc_ptr)
@@ -17220,6 +17448,7 @@ module_state::write_counts (elf_out *to, unsigned counts[MSC_HWM],
       dump ("Namespaces %u", counts[MSC_namespaces]);
       dump ("Macros %u", counts[MSC_macros]);
       dump ("Initializers %u", counts[MSC_inits]);
+      dump ("Constexpr calls %u", counts[MSC_cexpr_calls]);
     }
 
   cfg.end (to, to->name (MOD_SNAME_PFX ".cnt"), crc_ptr);
@@ -17246,6 +17475,7 @@ module_state::read_counts (unsigned counts[MSC_HWM])
       dump ("Namespaces %u", counts[MSC_namespaces]);
       dump ("Macros %u", counts[MSC_macros]);
       dump ("Initializers %u", counts[MSC_inits]);
+      dump ("Constexpr calls %u", counts[MSC_cexpr_calls]);
     }
 
   return cfg.end (from ());
@@ -17522,6 +17752,7 @@ ool_cmp (const void *a_, const void *b_)
      MOD_SNAME_PFX.def      : macro definitions
      MOD_SNAME_PFX.mac      : macro index
      MOD_SNAME_PFX.ini      : inits
+     MOD_SNAME_PFX.cxc      : memoized constexpr calls
      MOD_SNAME_PFX.cnt      : counts
      MOD_SNAME_PFX.cfg      : config data
 */
@@ -17775,6 +18006,8 @@ module_state::write (elf_out *to, cpp_reader *reader)
       counts[MSC_inits] = write_inits (to, table, &crc);
     }
 
+  counts[MSC_cexpr_calls] = write_constexpr_calls (to, table, &crc);
+
   unsigned clusters = counts[MSC_sec_hwm] - counts[MSC_sec_lwm];
   dump () && dump ("Wrote %u clusters, average %u bytes/cluster",
 		   clusters, (bytes + clusters / 2) / (clusters + !clusters));
@@ -17818,6 +18051,18 @@ module_state::read_initial (cpp_reader *reader)
   if (ok && !read_config (config))
     ok = false;
 
+  /* Everything read_language will read eagerly follows the clusters,
+     starting with the entity table.  Let the system load it while we
+     deal with our imports and the rest of the TU's imports.  */
+  if (ok)
+    {
+      unsigned snum = 1;
+      if (flag_module_lazy)
+	if (!(snum = from ()->find (MOD_SNAME_PFX ".ent")))
+	  snum = from ()->find (MOD_SNAME_PFX ".bnd");
+      from ()->prefetch (snum);
+    }
+
   bool have_locs = ok && read_prepare_maps (&config);
 
   /* Ordinary maps before the imports.  */
@@ -18030,6 +18275,10 @@ module_state::read_language (bool outermost)
   if (ok && counts[MSC_inits] && !read_inits (counts[MSC_inits]))
     ok = false;
 
+  if (ok && counts[MSC_cexpr_calls]
+      && !read_constexpr_calls (counts[MSC_cexpr_calls]))
+    ok = false;
+
   function_depth--;
   
   announce (flag_module_lazy ? "lazy" : "imported");
@@ -19477,7 +19726,8 @@ preprocessed_module (cpp_reader *reader)
 		  && (module->is_interface () || module->is_partition ()))
 		deps_add_module_target (deps, module->get_flatname (),
 					maybe_add_cmi_prefix (module->filename),
-					module->is_header());
+					module->is_header (),
+					module->is_interface ());
 	      else
 		deps_add_module_dep (deps, module->get_flatname ());
 	    }
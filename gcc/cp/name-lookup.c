@@ -2363,6 +2363,10 @@ insert_late_enum_def_bindings (tree klass, tree enumtype)
       member_vec->qsort (member_name_cmp);
       member_vec_dedup (member_vec);
     }
+
+  /* KLASS was complete, so lookups in it and its derived classes may
+     have missed the enumerators.  */
+  clear_member_lookup_cache ();
 }
 
 /* The binding oracle; see cp-tree.h.  */
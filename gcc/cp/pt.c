@@ -107,6 +107,7 @@ static bool excessive_deduction_depth;
 struct spec_hasher : ggc_ptr_hash<spec_entry>
 {
   static hashval_t hash (spec_entry *);
+  static hashval_t hash (tree tmpl, tree args);
   static bool equal (spec_entry *, spec_entry *);
 };
 
@@ -1105,12 +1106,14 @@ maybe_process_partial_specialization (tree type)
 		  elt.tmpl = most_general_template (tmpl);
 		  elt.args = CLASSTYPE_TI_ARGS (inst);
 		  elt.spec = inst;
+		  elt.hash = spec_hasher::hash (elt.tmpl, elt.args);
 
 		  type_specializations->remove_elt (&elt);
 
 		  elt.tmpl = tmpl;
 		  CLASSTYPE_TI_ARGS (inst)
 		    = elt.args = INNERMOST_TEMPLATE_ARGS (elt.args);
+		  elt.hash = spec_hasher::hash (elt.tmpl, elt.args);
 
 		  spec_entry **slot
 		    = type_specializations->find_slot (&elt, INSERT);
@@ -1300,7 +1303,8 @@ retrieve_specialization (tree tmpl, tree args, hashval_t hash)
 	specializations = decl_specializations;
 
       if (hash == 0)
-	hash = spec_hasher::hash (&elt);
+	hash = spec_hasher::hash (tmpl, args);
+      elt.hash = hash;
       found = specializations->find_with_hash (&elt, hash);
       if (found)
 	return found->spec;
@@ -1581,7 +1585,8 @@ register_specialization (tree spec, tree tmpl, tree args, bool is_friend,
       elt.spec = spec;
 
       if (hash == 0)
-	hash = spec_hasher::hash (&elt);
+	hash = spec_hasher::hash (tmpl, args);
+      elt.hash = hash;
 
       slot = decl_specializations->find_slot_with_hash (&elt, hash, INSERT);
       if (*slot)
@@ -1723,7 +1728,8 @@ spec_hasher::equal (spec_entry *e1, spec_entry *e2)
   ++comparing_specializations;
   ++comparing_dependent_aliases;
   ++processing_template_decl;
-  equal = (e1->tmpl == e2->tmpl
+  equal = (e1->hash == e2->hash
+	   && e1->tmpl == e2->tmpl
 	   && comp_template_args (e1->args, e2->args));
   if (equal && flag_concepts
       /* tmpl could be a FIELD_DECL for a capture pack.  */
@@ -1753,13 +1759,24 @@ hash_tmpl_and_args (tree tmpl, tree args)
   return iterative_hash_template_arg (args, val);
 }
 
-/* Returns a hash for a spec_entry node based on the TMPL and ARGS members,
-   ignoring SPEC.  */
+/* Returns the hash of a spec_entry node, which is cached in it.  The
+   tables are keyed on arguments that can be deep, so rehashing them
+   whenever a table expands would be costly.  */
 
 hashval_t
 spec_hasher::hash (spec_entry *e)
 {
-  return hash_tmpl_and_args (e->tmpl, e->args);
+  gcc_checking_assert (e->hash == hash (e->tmpl, e->args));
+  return e->hash;
+}
+
+/* Returns the hash for a spec_entry with TMPL and ARGS, to be stored in
+   its HASH member.  */
+
+hashval_t
+spec_hasher::hash (tree tmpl, tree args)
+{
+  return hash_tmpl_and_args (tmpl, args);
 }
 
 /* Recursively calculate a hash value for a template argument ARG, for use
@@ -1981,6 +1998,7 @@ reregister_specialization (tree spec, tree tinfo, tree new_spec)
   elt.tmpl = most_general_template (TI_TEMPLATE (tinfo));
   elt.args = TI_ARGS (tinfo);
   elt.spec = NULL_TREE;
+  elt.hash = spec_hasher::hash (elt.tmpl, elt.args);
 
   entry = decl_specializations->find (&elt);
   if (entry != NULL)
@@ -9885,7 +9903,7 @@ lookup_template_class_1 (tree d1, tree arglist, tree in_decl, tree context,
       elt.tmpl = gen_tmpl;
       elt.args = arglist;
       elt.spec = NULL_TREE;
-      hash = spec_hasher::hash (&elt);
+      elt.hash = hash = spec_hasher::hash (gen_tmpl, arglist);
       entry = type_specializations->find_with_hash (&elt, hash);
 
       if (entry)
@@ -10186,7 +10204,7 @@ lookup_template_class_1 (tree d1, tree arglist, tree in_decl, tree context,
 		 use it for hash table lookup.  */
 	      elt.tmpl = found;
 	      elt.args = arglist = INNERMOST_TEMPLATE_ARGS (arglist);
-	      hash = spec_hasher::hash (&elt);
+	      elt.hash = hash = spec_hasher::hash (found, arglist);
 	    }
 	}
 
@@ -11276,6 +11294,7 @@ tsubst_friend_function (tree decl, tree args)
 		      elt.tmpl = old_decl;
 		      elt.args = DECL_TI_ARGS (spec);
 		      elt.spec = NULL_TREE;
+		      elt.hash = spec_hasher::hash (elt.tmpl, elt.args);
 
 		      decl_specializations->remove_elt (&elt);
 
@@ -12284,6 +12303,9 @@ instantiate_class_template (tree type)
 {
   tree ret;
   timevar_push (TV_TEMPLATE_INST);
+  auto_time_trace tt ("InstantiateClass",
+		      time_trace_active
+		      ? type_as_string (type, TFF_PLAIN_IDENTIFIER) : NULL);
   ret = instantiate_class_template_1 (type);
   timevar_pop (TV_TEMPLATE_INST);
   return ret;
@@ -25797,6 +25819,10 @@ instantiate_body (tree pattern, tree args, tree d, bool nested_p)
 {
   tree td = NULL_TREE;
   tree code_pattern = pattern;
+  auto_time_trace tt (TREE_CODE (d) == FUNCTION_DECL
+		      ? "InstantiateFunction" : "InstantiateVariable",
+		      time_trace_active
+		      ? decl_as_string (d, TFF_PLAIN_IDENTIFIER) : NULL);
 
   if (!nested_p)
     {
@@ -30030,7 +30056,7 @@ match_mergeable_specialization (bool decl_p, spec_entry *elt)
 {
   hash_table<spec_hasher> *specializations
     = decl_p ? decl_specializations : type_specializations;
-  hashval_t hash = spec_hasher::hash (elt);
+  hashval_t hash = elt->hash = spec_hasher::hash (elt->tmpl, elt->args);
   auto *slot = specializations->find_slot_with_hash (elt, hash, NO_INSERT);
 
   if (slot)
@@ -30078,7 +30104,7 @@ void
 add_mergeable_specialization (bool decl_p, bool alias_p, spec_entry *elt,
 			      tree decl, unsigned flags)
 {
-  hashval_t hash = spec_hasher::hash (elt);
+  hashval_t hash = elt->hash = spec_hasher::hash (elt->tmpl, elt->args);
   if (decl_p)
     {
       auto *slot = decl_specializations->find_slot_with_hash (elt, hash, INSERT);
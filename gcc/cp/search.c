@@ -1071,6 +1071,66 @@ lookup_field_r (tree binfo, void *data)
   return NULL_TREE;
 }
 
+/* The result of the base walk in lookup_member for a complete class,
+   which does not change once the class is complete.  Class templates
+   with many members and deep hierarchies of instantiations look up
+   the same names in the same classes over and over.  */
+
+struct GTY((for_user)) member_lookup_entry {
+  tree type;
+  tree name;
+  tree rval;
+  tree rval_binfo;
+  tree ambiguous;
+  const char * GTY((skip)) errstr;
+  bool want_type;
+};
+
+struct member_lookup_hasher : ggc_ptr_hash<member_lookup_entry>
+{
+  static hashval_t hash (member_lookup_entry *e)
+  {
+    return iterative_hash_hashval_t (IDENTIFIER_HASH_VALUE (e->name),
+				     TYPE_UID (e->type) * 2 + e->want_type);
+  }
+  static bool equal (member_lookup_entry *a, member_lookup_entry *b)
+  {
+    return (a->type == b->type && a->name == b->name
+	    && a->want_type == b->want_type);
+  }
+};
+
+static GTY((deletable)) hash_table<member_lookup_hasher> *member_lookup_cache;
+
+/* Whether the lookup of NAME in TYPE, starting at BINFO, may use
+   member_lookup_cache.  The implicitly declared special member
+   functions are added to complete classes when they are first looked
+   up, so those names are not cached.  Anything else added to a
+   complete class, such as the conversion function of a lambda or the
+   enumerators of an enumeration defined outside the class, clears the
+   cache.  */
+
+static bool
+member_lookup_cacheable_p (tree type, tree binfo, tree name)
+{
+  return (binfo == TYPE_BINFO (type)
+	  && COMPLETE_TYPE_P (type)
+	  && !dependent_type_p (type)
+	  && !modules_p ()
+	  && !IDENTIFIER_CDTOR_P (name)
+	  && name != assign_op_identifier);
+}
+
+/* Forget the results of earlier member lookups, after a complete class
+   has been given a new member.  */
+
+void
+clear_member_lookup_cache (void)
+{
+  if (member_lookup_cache)
+    member_lookup_cache->empty ();
+}
+
 /* Return a "baselink" with BASELINK_BINFO, BASELINK_ACCESS_BINFO,
    BASELINK_FUNCTIONS, and BASELINK_OPTYPE set to BINFO, ACCESS_BINFO,
    FUNCTIONS, and OPTYPE respectively.  */
@@ -1163,7 +1223,46 @@ lookup_member (tree xbasetype, tree name, int protect, bool want_type,
   lfi.type = type;
   lfi.name = name;
   lfi.want_type = want_type;
-  dfs_walk_all (basetype_path, &lookup_field_r, NULL, &lfi);
+
+  bool cacheable = member_lookup_cacheable_p (type, basetype_path, name);
+  member_lookup_entry key, *hit = NULL;
+  if (cacheable)
+    {
+      key.type = type;
+      key.name = name;
+      key.want_type = want_type;
+      if (!member_lookup_cache)
+	member_lookup_cache
+	  = hash_table<member_lookup_hasher>::create_ggc (127);
+      hit = member_lookup_cache->find (&key);
+    }
+
+  if (hit)
+    {
+      lfi.rval = hit->rval;
+      lfi.rval_binfo = hit->rval_binfo;
+      lfi.ambiguous = hit->ambiguous;
+      lfi.errstr = hit->errstr;
+    }
+  else
+    {
+      dfs_walk_all (basetype_path, &lookup_field_r, NULL, &lfi);
+      /* The walk can complete other classes, so only look for a slot
+	 once it is done.  */
+      if (cacheable)
+	{
+	  member_lookup_entry *e = ggc_alloc<member_lookup_entry> ();
+	  e->type = type;
+	  e->name = name;
+	  e->want_type = want_type;
+	  e->rval = lfi.rval;
+	  e->rval_binfo = lfi.rval_binfo;
+	  e->ambiguous = lfi.ambiguous;
+	  e->errstr = lfi.errstr;
+	  *member_lookup_cache->find_slot (e, INSERT) = e;
+	}
+    }
+
   rval = lfi.rval;
   rval_binfo = lfi.rval_binfo;
   if (rval_binfo)
@@ -1178,7 +1277,7 @@ lookup_member (tree xbasetype, tree name, int protect, bool want_type,
   if (protect == 2)
     {
       if (lfi.ambiguous)
-	return lfi.ambiguous;
+	return cacheable ? copy_list (lfi.ambiguous) : lfi.ambiguous;
       else
 	protect = 0;
     }
@@ -2722,3 +2821,5 @@ any_dependent_bases_p (tree type)
 
   return false;
 }
+
+#include "gt-cp-search.h"
@@ -464,6 +464,15 @@ see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
 #define DWARF2_ADDR_SIZE ((POINTER_SIZE + BITS_PER_UNIT - 1) / BITS_PER_UNIT)
 #endif
 
+/* Nonzero if the distance between two code labels may only be known
+   at link time, for instance because the linker relaxes code.  The
+   assembler then emits such differences as relocations, which are lost
+   from the .dwo files of -gsplit-dwarf, so dwarf2out.c must use address
+   table entries for them instead.  */
+#ifndef DWARF2_CODE_LABEL_DELTAS_NEED_RELOCS
+#define DWARF2_CODE_LABEL_DELTAS_NEED_RELOCS 0
+#endif
+
 /* The size in bytes of a DWARF field indicating an offset or length
    relative to a debug info section, specified to be 4 bytes in the
    DWARF-2 specification.  The SGI/MIPS ABI defines it to be the same
@@ -1107,15 +1107,64 @@ df_worklist_dataflow (struct dataflow *dataflow,
 
   /* Initialize the mapping of block index to postorder.  */
   for (i = 0; i < n_blocks; i++)
+    bbindex_to_postorder[blocks_in_postorder[i]] = i;
+
+  if (dataflow->changed_blocks)
     {
-      bbindex_to_postorder[blocks_in_postorder[i]] = i;
-      /* Add all blocks to the worklist.  */
-      bitmap_set_bit (pending, i);
+      /* Only the solution of the changed blocks and of the blocks that
+	 can see them in the direction of the problem can differ from
+	 the previous one; the solution of the others is still valid
+	 and is just used as a boundary condition.  */
+      auto_bitmap affected (&df_bitmap_obstack);
+      auto_vec<basic_block> stack;
+      edge e;
+      edge_iterator ei;
+
+      EXECUTE_IF_AND_IN_BITMAP (dataflow->changed_blocks, blocks_to_consider,
+				0, index, bi)
+	if (bitmap_set_bit (affected, index))
+	  stack.safe_push (BASIC_BLOCK_FOR_FN (cfun, index));
+      while (!stack.is_empty ())
+	{
+	  basic_block bb = stack.pop ();
+	  if (dir == DF_FORWARD)
+	    {
+	      FOR_EACH_EDGE (e, ei, bb->succs)
+		if (bitmap_bit_p (considered, e->dest->index)
+		    && bitmap_set_bit (affected, e->dest->index))
+		  stack.safe_push (e->dest);
+	    }
+	  else
+	    {
+	      FOR_EACH_EDGE (e, ei, bb->preds)
+		if (bitmap_bit_p (considered, e->src->index)
+		    && bitmap_set_bit (affected, e->src->index))
+		  stack.safe_push (e->src);
+	    }
+	}
+
+      if (dump_file)
+	fprintf (dump_file, "df_worklist_dataflow: %u of %d blocks"
+		 " affected by %u changed blocks\n",
+		 bitmap_count_bits (affected), n_blocks,
+		 bitmap_count_bits (dataflow->changed_blocks));
+
+      EXECUTE_IF_SET_IN_BITMAP (affected, 0, index, bi)
+	bitmap_set_bit (pending, bbindex_to_postorder[index]);
+
+      if (dataflow->problem->init_fun)
+	dataflow->problem->init_fun (affected);
     }
+  else
+    {
+      /* Add all blocks to the worklist.  */
+      for (i = 0; i < n_blocks; i++)
+	bitmap_set_bit (pending, i);
 
-  /* Initialize the problem. */
-  if (dataflow->problem->init_fun)
-    dataflow->problem->init_fun (blocks_to_consider);
+      /* Initialize the problem. */
+      if (dataflow->problem->init_fun)
+	dataflow->problem->init_fun (blocks_to_consider);
+    }
 
   /* Solve it.  */
   df_worklist_dataflow_doublequeue (dataflow, pending, considered,
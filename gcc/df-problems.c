@@ -727,6 +727,23 @@ struct df_lr_problem_data
   bitmap_head *out;
   /* An obstack for the bitmaps we need for this problem.  */
   bitmap_obstack lr_bitmaps;
+
+  /* True if the current solution was computed for all the blocks, so
+     that the next one can be computed incrementally from it.  */
+  bool solution_valid_p;
+
+  /* The CFG as it was when the current solution was computed: for each
+     block index, the block itself (NULL if it was not solved) and,
+     from CFG_START[INDEX] to CFG_START[INDEX + 1], the destinations of
+     its outgoing edges and whether they were EH edges.  */
+  vec<basic_block> cfg_blocks;
+  vec<unsigned int> cfg_start;
+  vec<basic_block> cfg_succs;
+  vec<bool> cfg_succs_eh;
+
+  /* The value of df->hardware_regs_used when the current solution was
+     computed.  */
+  bitmap_head hardware_regs_used;
 };
 
 /* Free basic block info.  */
@@ -767,6 +784,13 @@ df_lr_alloc (bitmap all_blocks ATTRIBUTE_UNUSED)
       problem_data->out = NULL;
       problem_data->in = NULL;
       bitmap_obstack_initialize (&problem_data->lr_bitmaps);
+      problem_data->solution_valid_p = false;
+      problem_data->cfg_blocks = vNULL;
+      problem_data->cfg_start = vNULL;
+      problem_data->cfg_succs = vNULL;
+      problem_data->cfg_succs_eh = vNULL;
+      bitmap_initialize (&problem_data->hardware_regs_used,
+			 &problem_data->lr_bitmaps);
     }
 
   EXECUTE_IF_SET_IN_BITMAP (df_lr->out_of_date_transfer_functions, 0, bb_index, bi)
@@ -799,7 +823,11 @@ df_lr_reset (bitmap all_blocks)
 {
   unsigned int bb_index;
   bitmap_iterator bi;
+  struct df_lr_problem_data *problem_data
+    = (struct df_lr_problem_data *) df_lr->problem_data;
 
+  if (problem_data)
+    problem_data->solution_valid_p = false;
   EXECUTE_IF_SET_IN_BITMAP (all_blocks, 0, bb_index, bi)
     {
       class df_lr_bb_info *bb_info = df_lr_get_bb_info (bb_index);
@@ -924,13 +952,96 @@ df_lr_bb_local_compute (unsigned int bb_index)
 }
 
 
+/* Record the outgoing edges of the blocks in ALL_BLOCKS, whose
+   solution is about to be computed.  */
+
+static void
+df_lr_record_cfg (bitmap all_blocks)
+{
+  struct df_lr_problem_data *problem_data
+    = (struct df_lr_problem_data *) df_lr->problem_data;
+  unsigned int n = last_basic_block_for_fn (cfun);
+  unsigned int bb_index;
+  edge e;
+  edge_iterator ei;
+
+  problem_data->cfg_blocks.truncate (0);
+  problem_data->cfg_blocks.safe_grow_cleared (n, true);
+  problem_data->cfg_start.truncate (0);
+  problem_data->cfg_start.reserve_exact (n + 1);
+  problem_data->cfg_succs.truncate (0);
+  problem_data->cfg_succs_eh.truncate (0);
+
+  for (bb_index = 0; bb_index < n; bb_index++)
+    {
+      problem_data->cfg_start.quick_push (problem_data->cfg_succs.length ());
+      if (!bitmap_bit_p (all_blocks, bb_index))
+	continue;
+
+      basic_block bb = BASIC_BLOCK_FOR_FN (cfun, bb_index);
+      problem_data->cfg_blocks[bb_index] = bb;
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	{
+	  problem_data->cfg_succs.safe_push (e->dest);
+	  problem_data->cfg_succs_eh.safe_push ((e->flags & EDGE_EH) != 0);
+	}
+    }
+  problem_data->cfg_start.quick_push (problem_data->cfg_succs.length ());
+}
+
+
+/* Set in CHANGED the blocks in ALL_BLOCKS that were not solved last
+   time or whose outgoing edges have changed since.  */
+
+static void
+df_lr_find_changed_cfg (bitmap all_blocks, bitmap changed)
+{
+  struct df_lr_problem_data *problem_data
+    = (struct df_lr_problem_data *) df_lr->problem_data;
+  unsigned int bb_index;
+  bitmap_iterator bi;
+  edge e;
+  edge_iterator ei;
+
+  EXECUTE_IF_SET_IN_BITMAP (all_blocks, 0, bb_index, bi)
+    {
+      basic_block bb = BASIC_BLOCK_FOR_FN (cfun, bb_index);
+      if (bb_index >= problem_data->cfg_blocks.length ()
+	  || problem_data->cfg_blocks[bb_index] != bb)
+	{
+	  bitmap_set_bit (changed, bb_index);
+	  continue;
+	}
+
+      unsigned int start = problem_data->cfg_start[bb_index];
+      if (problem_data->cfg_start[bb_index + 1] - start
+	  != EDGE_COUNT (bb->succs))
+	{
+	  bitmap_set_bit (changed, bb_index);
+	  continue;
+	}
+
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	if (problem_data->cfg_succs[start + ei.index] != e->dest
+	    || (problem_data->cfg_succs_eh[start + ei.index]
+		!= ((e->flags & EDGE_EH) != 0)))
+	  {
+	    bitmap_set_bit (changed, bb_index);
+	    break;
+	  }
+    }
+}
+
+
 /* Compute local live register info for each basic block within BLOCKS.  */
 
 static void
-df_lr_local_compute (bitmap all_blocks ATTRIBUTE_UNUSED)
+df_lr_local_compute (bitmap all_blocks)
 {
   unsigned int bb_index, i;
   bitmap_iterator bi;
+  struct df_lr_problem_data *problem_data
+    = (struct df_lr_problem_data *) df_lr->problem_data;
 
   bitmap_clear (&df->hardware_regs_used);
 
@@ -978,6 +1089,27 @@ df_lr_local_compute (bitmap all_blocks ATTRIBUTE_UNUSED)
 	df_lr_bb_local_compute (bb_index);
     }
 
+  /* The solution only needs to be recomputed for the blocks that can
+     reach one whose transfer function or edges have changed, as long
+     as the previous solution is complete and the registers that are
+     live everywhere are the same.  */
+  if (problem_data->solution_valid_p
+      && !df->analyze_subset
+      && bitmap_equal_p (&df->hardware_regs_used,
+			 &problem_data->hardware_regs_used))
+    {
+      if (!df_lr->changed_blocks)
+	df_lr->changed_blocks = BITMAP_ALLOC (&df_bitmap_obstack);
+      bitmap_copy (df_lr->changed_blocks,
+		   df_lr->out_of_date_transfer_functions);
+      df_lr_find_changed_cfg (all_blocks, df_lr->changed_blocks);
+    }
+  else
+    BITMAP_FREE (df_lr->changed_blocks);
+
+  df_lr_record_cfg (all_blocks);
+  bitmap_copy (&problem_data->hardware_regs_used, &df->hardware_regs_used);
+
   bitmap_clear (df_lr->out_of_date_transfer_functions);
 }
 
@@ -1059,7 +1191,11 @@ df_lr_transfer_function (int bb_index)
 static void
 df_lr_finalize (bitmap all_blocks)
 {
+  struct df_lr_problem_data *problem_data
+    = (struct df_lr_problem_data *) df_lr->problem_data;
+
   df_lr->solutions_dirty = false;
+  problem_data->solution_valid_p = !df->analyze_subset;
   if (df->changeable_flags & DF_LR_RUN_DCE)
     {
       run_fast_df_dce ();
@@ -1102,11 +1238,16 @@ df_lr_free (void)
       free (df_lr->block_info);
       df_lr->block_info = NULL;
       bitmap_obstack_release (&problem_data->lr_bitmaps);
+      problem_data->cfg_blocks.release ();
+      problem_data->cfg_start.release ();
+      problem_data->cfg_succs.release ();
+      problem_data->cfg_succs_eh.release ();
       free (df_lr->problem_data);
       df_lr->problem_data = NULL;
     }
 
   BITMAP_FREE (df_lr->out_of_date_transfer_functions);
+  BITMAP_FREE (df_lr->changed_blocks);
   free (df_lr);
 }
 
@@ -1174,10 +1315,12 @@ df_lr_verify_solution_start (void)
   if (df_lr->solutions_dirty)
     return;
 
-  /* Set it true so that the solution is recomputed.  */
+  /* Set it true so that the solution is recomputed, from scratch
+     rather than incrementally.  */
   df_lr->solutions_dirty = true;
 
   problem_data = (struct df_lr_problem_data *)df_lr->problem_data;
+  problem_data->solution_valid_p = false;
   problem_data->in = XNEWVEC (bitmap_head, last_basic_block_for_fn (cfun));
   problem_data->out = XNEWVEC (bitmap_head, last_basic_block_for_fn (cfun));
 
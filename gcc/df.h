@@ -307,6 +307,14 @@ struct dataflow
      defined for any other problem.  */
   bitmap out_of_date_transfer_functions;
 
+  /* If non-NULL, the blocks whose transfer functions or outgoing edges
+     have changed since the solution was last computed, as set up by
+     the local_compute_fun of a problem that supports incremental
+     solving (currently only lr).  df_worklist_dataflow then only
+     recomputes the solution of the blocks that can be affected by
+     them.  */
+  bitmap changed_blocks;
+
   /* Other problem specific data that is not on a per basic block
      basis.  The structure is generally defined privately for the
      problem.  The exception being the scanning problem where it is
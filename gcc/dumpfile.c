@@ -88,8 +88,8 @@ set_alt_dump_file (FILE *new_alt_dump_file)
 }
 
 #define DUMP_FILE_INFO(suffix, swtch, dkind, num) \
-  {suffix, swtch, NULL, NULL, NULL, NULL, NULL, dkind, TDF_NONE, TDF_NONE, \
-   OPTGROUP_NONE, 0, 0, num, false, false}
+  {suffix, swtch, NULL, NULL, NULL, NULL, NULL, NULL, dkind, TDF_NONE, \
+   TDF_NONE, OPTGROUP_NONE, 0, 0, num, false, false}
 
 /* Table of tree dump switches. This must be consistent with the
    TREE_DUMP_INDEX enumeration in dumpfile.h.  */
@@ -205,6 +205,7 @@ gcc::dump_manager::~dump_manager ()
 	}
       /* These, if non-NULL, are always dynamically allocated.  */
       XDELETEVEC (const_cast <char *> (dfi->pfilename));
+      XDELETEVEC (const_cast <char *> (dfi->pfunctions));
       XDELETEVEC (const_cast <char *> (dfi->alt_filename));
     }
   XDELETEVEC (m_extra_dump_files);
@@ -360,6 +361,11 @@ get_dump_file_name (struct dump_file_info *dfi, int part) const
     return concat (dump_base_name, dump_id, dfi->suffix, NULL);
 }
 
+/* Size of the buffer of a dump file.  Dumps are printed in many small
+   pieces, so a larger buffer than the stdio default cuts down the number
+   of writes.  */
+#define DUMP_FILE_BUFFER_SIZE (64 * 1024)
+
 /* Open a dump file called FILENAME.  Some filenames are special and
    refer to the standard streams.  TRUNC indicates whether this is the
    first open (so the file should be truncated, rather than appended).
@@ -379,9 +385,43 @@ dump_open (const char *filename, bool trunc)
 
   if (!stream)
     error ("could not open dump file %qs: %m", filename);
+  else
+    setvbuf (stream, NULL, _IOFBF, DUMP_FILE_BUFFER_SIZE);
   return stream;
 }
 
+/* Return true if the pass-specific stream of DFI is restricted to some
+   functions and the current function is not one of them.  A function
+   matches by its name or by its assembler name, so a name also selects
+   the clones of the function.  */
+
+static bool
+dump_function_filtered_p (const struct dump_file_info *dfi)
+{
+  if (!dfi->pfunctions || !current_function_decl)
+    return false;
+
+  tree decl = current_function_decl;
+  const char *name
+    = DECL_NAME (decl) ? IDENTIFIER_POINTER (DECL_NAME (decl)) : NULL;
+  const char *asmname
+    = (DECL_ASSEMBLER_NAME_SET_P (decl)
+       ? IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME_RAW (decl)) : NULL);
+  const char *p = dfi->pfunctions;
+  while (*p)
+    {
+      const char *end = strchr (p, ',');
+      size_t len = end ? (size_t) (end - p) : strlen (p);
+      if ((name && strlen (name) == len && !memcmp (name, p, len))
+	  || (asmname && strlen (asmname) == len && !memcmp (asmname, p, len)))
+	return false;
+      p += len;
+      if (*p == ',')
+	p++;
+    }
+  return true;
+}
+
 /* For a given DFI, open an alternate dump filename (which could also
    be a standard stream such as stdout/stderr). If the alternate dump
    file cannot be opened, return NULL.  */
@@ -1474,7 +1514,7 @@ dump_start (int phase, dump_flags_t *flag_ptr)
     return 0;
 
   dfi = get_dump_file_info (phase);
-  name = get_dump_file_name (phase);
+  name = dump_function_filtered_p (dfi) ? NULL : get_dump_file_name (phase);
   if (name)
     {
       stream = dump_open (name, dfi->pstate < 0);
@@ -1553,10 +1593,12 @@ dump_begin (int phase, dump_flags_t *flag_ptr, int part)
   if (phase == TDI_none || !dump_phase_enabled_p (phase))
     return NULL;
 
+  struct dump_file_info *dfi = get_dump_file_info (phase);
+  if (dump_function_filtered_p (dfi))
+    return NULL;
   char *name = get_dump_file_name (phase, part);
   if (!name)
     return NULL;
-  struct dump_file_info *dfi = get_dump_file_info (phase);
 
   /* We do not support re-opening of dump files with parts.  This would require
      tracking pstate per part of the dump file.  */
@@ -1679,12 +1721,13 @@ dump_end (int phase ATTRIBUTE_UNUSED, FILE *stream)
     fclose (stream);
 }
 
-/* Enable all tree dumps with FLAGS on FILENAME.  Return number of
-   enabled tree dumps.  */
+/* Enable all tree dumps with FLAGS on FILENAME, restricted to FUNCTIONS
+   if non-NULL.  Return number of enabled tree dumps.  */
 
 int
 gcc::dump_manager::
-dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename)
+dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename,
+		 const char *functions)
 {
   int n = 0;
   size_t i;
@@ -1707,6 +1750,11 @@ dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename)
             }
           if (old_filename && filename != old_filename)
             free (CONST_CAST (char *, old_filename));
+          if (functions && functions != dump_files[i].pfunctions)
+            {
+              free (CONST_CAST (char *, dump_files[i].pfunctions));
+              dump_files[i].pfunctions = xstrdup (functions);
+            }
         }
     }
 
@@ -1728,6 +1776,11 @@ dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename)
             }
           if (old_filename && filename != old_filename)
             free (CONST_CAST (char *, old_filename));
+          if (functions && functions != m_extra_dump_files[i].pfunctions)
+            {
+              free (CONST_CAST (char *, m_extra_dump_files[i].pfunctions));
+              m_extra_dump_files[i].pfunctions = xstrdup (functions);
+            }
         }
     }
 
@@ -1874,7 +1927,16 @@ dump_switch_p_1 (const char *arg, struct dump_file_info *dfi, bool doglob)
 
   const char *filename;
   flags = parse_dump_option (option_value, &filename);
-  if (filename)
+  /* "=func:NAME,..." restricts the dump to the functions NAME, ...
+     instead of naming the dump file.  */
+  const char *functions
+    = filename ? skip_leading_substring (filename, "func:") : NULL;
+  if (functions)
+    {
+      free (CONST_CAST (char *, dfi->pfunctions));
+      dfi->pfunctions = xstrdup (functions);
+    }
+  else if (filename)
     {
       if (dfi->pfilename)
   free (CONST_CAST (char *, dfi->pfilename));
@@ -1887,7 +1949,8 @@ dump_switch_p_1 (const char *arg, struct dump_file_info *dfi, bool doglob)
   /* Process -fdump-tree-all and -fdump-rtl-all, by enabling all the
      known dumps.  */
   if (dfi->suffix == NULL)
-    dump_enable_all (dfi->dkind, dfi->pflags, dfi->pfilename);
+    dump_enable_all (dfi->dkind, dfi->pflags, dfi->pfilename,
+		     dfi->pfunctions);
 
   return 1;
 }
@@ -293,6 +293,9 @@ struct dump_file_info
   const char *glob;
   /* Filename for the pass-specific stream.  */
   const char *pfilename;
+  /* Comma-separated names of the functions to which the pass-specific
+     stream is restricted, or NULL for all functions.  */
+  const char *pfunctions;
   /* Filename for the -fopt-info stream.  */
   const char *alt_filename;
   /* Pass-specific dump stream.  */
@@ -730,7 +733,8 @@ private:
   dump_switch_p_1 (const char *arg, struct dump_file_info *dfi, bool doglob);
 
   int
-  dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename);
+  dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename,
+		   const char *functions = NULL);
 
   int
   opt_info_enable_passes (optgroup_flags_t optgroup_flags, dump_flags_t flags,
@@ -4592,6 +4592,27 @@ add_AT_data8 (dw_die_ref die, enum dwarf_attribute attr_kind,
   add_dwarf_attr (die, &attr);
 }
 
+/* Return true if the .dwo sections of -gsplit-dwarf may contain
+   differences between code labels.  That is not the case if the
+   differences need relocations, which are not applied to .dwo
+   sections; address table indexes must be used instead.  */
+
+static inline bool
+dwo_code_label_deltas_p (void)
+{
+  return !DWARF2_CODE_LABEL_DELTAS_NEED_RELOCS;
+}
+
+/* Return true if range and location lists should use uleb128
+   differences between code labels.  */
+
+static inline bool
+use_code_label_leb128_deltas_p (void)
+{
+  return (HAVE_AS_LEB128
+	  && (!dwarf_split_debug_info || dwo_code_label_deltas_p ()));
+}
+
 /* Add DW_AT_low_pc and DW_AT_high_pc to a DIE.  When using
    dwarf_split_debug_info, address attributes in dies destined for the
    final executable have force_direct set to avoid using indexed
@@ -4616,7 +4637,9 @@ add_AT_low_high_pc (dw_die_ref die, const char *lbl_low, const char *lbl_high,
   add_dwarf_attr (die, &attr);
 
   attr.dw_attr = DW_AT_high_pc;
-  if (dwarf_version < 4)
+  if (dwarf_version < 4
+      || (dwarf_split_debug_info && !force_direct
+	  && !dwo_code_label_deltas_p ()))
     attr.dw_attr_val.val_class = dw_val_class_lbl_id;
   else
     attr.dw_attr_val.val_class = dw_val_class_high_pc;
@@ -9115,6 +9138,138 @@ static vec<unsigned int> abbrev_usage_count;
 /* Vector of all DIEs added with die_abbrev >= abbrev_opt_start.  */
 static vec<dw_die_ref> sorted_abbrev_dies;
 
+/* Return true if DIE can use the abbreviation of ABBREV, i.e. if they
+   have the same tag, both have or lack children, and have the same
+   attributes with the same forms.  */
+
+static bool
+same_abbrev_p (dw_die_ref abbrev, dw_die_ref die)
+{
+  dw_attr_node *die_a, *abbrev_a;
+  unsigned ix;
+
+  if (abbrev->die_tag != die->die_tag)
+    return false;
+  if ((abbrev->die_child != NULL) != (die->die_child != NULL))
+    return false;
+
+  if (vec_safe_length (abbrev->die_attr) != vec_safe_length (die->die_attr))
+    return false;
+
+  FOR_EACH_VEC_SAFE_ELT (die->die_attr, ix, die_a)
+    {
+      abbrev_a = &(*abbrev->die_attr)[ix];
+      if ((abbrev_a->dw_attr != die_a->dw_attr)
+	  || (value_format (abbrev_a) != value_format (die_a)))
+	return false;
+    }
+
+  return true;
+}
+
+/* Hash DIE's tag, children flag, attributes and forms, consistently with
+   same_abbrev_p.  */
+
+static hashval_t
+abbrev_die_hash (dw_die_ref die)
+{
+  inchash::hash hstate;
+  dw_attr_node *a;
+  unsigned ix;
+
+  hstate.add_int (die->die_tag);
+  hstate.add_flag (die->die_child != NULL);
+  FOR_EACH_VEC_SAFE_ELT (die->die_attr, ix, a)
+    {
+      hstate.add_int (a->dw_attr);
+      hstate.add_int (value_format (a));
+    }
+  return hstate.end ();
+}
+
+/* Hashtable helpers for finding an abbreviation that a DIE can use.
+   The entries are indices into abbrev_die_table.  */
+
+struct abbrev_id_hasher : int_hash <unsigned int, 0, UINT_MAX>
+{
+  typedef dw_die_ref compare_type;
+
+  static inline hashval_t hash (unsigned int);
+  static inline bool equal (unsigned int, dw_die_ref);
+};
+
+inline hashval_t
+abbrev_id_hasher::hash (unsigned int abbrev_id)
+{
+  return abbrev_die_hash ((*abbrev_die_table)[abbrev_id]);
+}
+
+inline bool
+abbrev_id_hasher::equal (unsigned int abbrev_id, dw_die_ref die)
+{
+  return same_abbrev_p ((*abbrev_die_table)[abbrev_id], die);
+}
+
+/* The ids in abbrev_die_table, hashed by abbrev_die_hash, so that
+   build_abbrev_table doesn't have to compare every DIE against every
+   abbreviation.  The forms of the DIEs in abbrev_die_table can change
+   after they were entered, e.g. by optimize_implicit_const, so the table
+   is rebuilt from scratch whenever abbrev_hash_table_stale is set; a
+   stale entry can still only match a DIE it is equal to now.  */
+
+static hash_table<abbrev_id_hasher> *abbrev_hash_table;
+static bool abbrev_hash_table_stale;
+
+/* Return the id of an existing abbreviation that DIE can use, or 0 if
+   there is none.  */
+
+static unsigned int
+lookup_abbrev_id (dw_die_ref die)
+{
+  if (abbrev_hash_table == NULL)
+    {
+      abbrev_hash_table = new hash_table<abbrev_id_hasher> (256);
+      abbrev_hash_table_stale = true;
+    }
+
+  if (abbrev_hash_table_stale)
+    {
+      abbrev_hash_table->empty ();
+      for (unsigned int i = 1; i < vec_safe_length (abbrev_die_table); i++)
+	{
+	  unsigned int *slot
+	    = abbrev_hash_table->find_slot_with_hash
+		((*abbrev_die_table)[i],
+		 abbrev_die_hash ((*abbrev_die_table)[i]), INSERT);
+	  /* Keep the first of any abbreviations that have become equal.  */
+	  if (*slot == 0)
+	    *slot = i;
+	}
+      abbrev_hash_table_stale = false;
+    }
+
+  unsigned int *slot
+    = abbrev_hash_table->find_slot_with_hash (die, abbrev_die_hash (die),
+					      NO_INSERT);
+  return slot ? *slot : 0;
+}
+
+/* Record that DIE is the abbreviation with id ABBREV_ID, which has just
+   been added to abbrev_die_table.  */
+
+static void
+add_abbrev_id (dw_die_ref die, unsigned int abbrev_id)
+{
+  if (abbrev_hash_table_stale)
+    return;
+
+  unsigned int *slot
+    = abbrev_hash_table->find_slot_with_hash (die, abbrev_die_hash (die),
+					      INSERT);
+  gcc_checking_assert (*slot == 0);
+  *slot = abbrev_id;
+}
+
 /* The format of each DIE (and its attribute value pairs) is encoded in an
    abbreviation table.  This routine builds the abbreviation table and assigns
    a unique abbreviation id for each abbreviation entry.  The children of each
@@ -9123,11 +9278,10 @@ static vec<dw_die_ref> sorted_abbrev_dies;
 static void
 build_abbrev_table (dw_die_ref die, external_ref_hash_type *extern_map)
 {
-  unsigned int abbrev_id = 0;
+  unsigned int abbrev_id;
   dw_die_ref c;
   dw_attr_node *a;
   unsigned ix;
-  dw_die_ref abbrev;
 
   /* Scan the DIE references, and replace any that refer to
      DIEs from other CUs (i.e. those which are not marked) with
@@ -9151,39 +9305,12 @@ build_abbrev_table (dw_die_ref die, external_ref_hash_type *extern_map)
 	  set_AT_ref_external (a, 1);
       }
 
-  FOR_EACH_VEC_SAFE_ELT (abbrev_die_table, abbrev_id, abbrev)
-    {
-      dw_attr_node *die_a, *abbrev_a;
-      unsigned ix;
-      bool ok = true;
-
-      if (abbrev_id == 0)
-	continue;
-      if (abbrev->die_tag != die->die_tag)
-	continue;
-      if ((abbrev->die_child != NULL) != (die->die_child != NULL))
-	continue;
-
-      if (vec_safe_length (abbrev->die_attr) != vec_safe_length (die->die_attr))
-	continue;
-
-      FOR_EACH_VEC_SAFE_ELT (die->die_attr, ix, die_a)
-	{
-	  abbrev_a = &(*abbrev->die_attr)[ix];
-	  if ((abbrev_a->dw_attr != die_a->dw_attr)
-	      || (value_format (abbrev_a) != value_format (die_a)))
-	    {
-	      ok = false;
-	      break;
-	    }
-	}
-      if (ok)
-	break;
-    }
-
-  if (abbrev_id >= vec_safe_length (abbrev_die_table))
+  abbrev_id = lookup_abbrev_id (die);
+  if (abbrev_id == 0)
     {
+      abbrev_id = vec_safe_length (abbrev_die_table);
       vec_safe_push (abbrev_die_table, die);
+      add_abbrev_id (die, abbrev_id);
       if (abbrev_opt_start)
 	abbrev_usage_count.safe_push (0);
     }
@@ -9360,6 +9487,9 @@ optimize_abbrev_table (void)
       gcc_assert (abbrev_id == vec_safe_length (abbrev_die_table) - 1);
       if (dwarf_version >= 5 && first_id != ~0U)
 	optimize_implicit_const (first_id, i, implicit_consts);
+
+      /* The ids, and with implicit consts the forms, have changed.  */
+      abbrev_hash_table_stale = true;
     }
 
   abbrev_opt_start = 0;
@@ -10338,7 +10468,7 @@ output_loc_list (dw_loc_list_ref list_head)
 
       if (dwarf_version >= 5)
 	{
-	  if (dwarf_split_debug_info && HAVE_AS_LEB128)
+	  if (dwarf_split_debug_info && use_code_label_leb128_deltas_p ())
 	    {
 	      dwarf2out_maybe_output_loclist_view_pair (curr);
 	      /* For -gsplit-dwarf, emit DW_LLE_startx_length, which has
@@ -10356,9 +10486,9 @@ output_loc_list (dw_loc_list_ref list_head)
 	  else if (dwarf_split_debug_info)
 	    {
 	      dwarf2out_maybe_output_loclist_view_pair (curr);
-	      /* For -gsplit-dwarf without usable .uleb128 support, emit
-		 DW_LLE_startx_endx, which has two uleb128 indexes into
-		 .debug_addr.  */
+	      /* For -gsplit-dwarf without usable .uleb128 support or
+		 label differences, emit DW_LLE_startx_endx, which has two
+		 uleb128 indexes into .debug_addr.  */
 	      dw2_asm_output_data (1, DW_LLE_startx_endx,
 				   "DW_LLE_startx_endx (%s)",
 				   list_head->ll_symbol);
@@ -10465,6 +10595,20 @@ output_loc_list (dw_loc_list_ref list_head)
 				   list_head->ll_symbol);
 	    }
 	}
+      else if (dwarf_split_debug_info && !dwo_code_label_deltas_p ())
+	{
+	  /* For -gsplit-dwarf -gdwarf-{2,3,4} without usable label
+	     differences emit two indexes into .debug_addr.  */
+	  dw2_asm_output_data (1, DW_LLE_GNU_start_end_entry,
+			       "Location list start/end entry (%s)",
+			       list_head->ll_symbol);
+	  dw2_asm_output_data_uleb128 (curr->begin_entry->index,
+				       "Location list range start index (%s)",
+				       curr->begin);
+	  dw2_asm_output_data_uleb128 (curr->end_entry->index,
+				       "Location list range end index (%s)",
+				       curr->end);
+	}
       else if (dwarf_split_debug_info)
 	{
 	  /* For -gsplit-dwarf -gdwarf-{2,3,4} emit index into .debug_addr
@@ -11955,16 +12099,20 @@ index_rnglists (void)
   unsigned i;
   dw_ranges *r;
   bool base = false;
+  bool leb128 = use_code_label_leb128_deltas_p ();
 
   FOR_EACH_VEC_SAFE_ELT (ranges_table, i, r)
     {
       if (r->label && r->idx != DW_RANGES_IDX_SKELETON)
 	r->idx = rnglist_idx++;
 
-      if (!have_multiple_function_sections)
+      /* Ranges in the text section are offset pairs against
+	 text_section_label unless label differences cannot be used.  */
+      if (!have_multiple_function_sections
+	  && (leb128 || !dwarf_split_debug_info))
 	continue;
       int block_num = r->num;
-      if (HAVE_AS_LEB128 && (r->label || r->maybe_new_sec))
+      if (leb128 && (r->label || r->maybe_new_sec))
 	base = false;
       if (block_num > 0)
 	{
@@ -11974,7 +12122,7 @@ index_rnglists (void)
 	  ASM_GENERATE_INTERNAL_LABEL (blabel, BLOCK_BEGIN_LABEL, block_num);
 	  ASM_GENERATE_INTERNAL_LABEL (elabel, BLOCK_END_LABEL, block_num);
 
-	  if (HAVE_AS_LEB128)
+	  if (leb128)
 	    {
 	      if (!base && use_distinct_base_address_for_range (i + 1))
 		{
@@ -12010,7 +12158,7 @@ index_rnglists (void)
 
 	  r->begin_entry
 	    = add_addr_table_entry (xstrdup (blabel), ate_kind_label);
-	  if (!HAVE_AS_LEB128)
+	  if (!leb128)
 	    r->end_entry
 	      = add_addr_table_entry (xstrdup (elabel), ate_kind_label);
 	}
@@ -12027,6 +12175,7 @@ output_rnglists (unsigned generation, bool dwo)
   char l1[MAX_ARTIFICIAL_LABEL_BYTES];
   char l2[MAX_ARTIFICIAL_LABEL_BYTES];
   char basebuf[MAX_ARTIFICIAL_LABEL_BYTES];
+  bool leb128 = use_code_label_leb128_deltas_p ();
 
   if (dwo)
     switch_to_section (debug_ranges_dwo_section);
@@ -12094,7 +12243,7 @@ output_rnglists (unsigned generation, bool dwo)
 	    skipping = false;
 	  continue;
 	}
-      if (HAVE_AS_LEB128 && (r->label || r->maybe_new_sec))
+      if (leb128 && (r->label || r->maybe_new_sec))
 	base = NULL;
       if (block_num > 0)
 	{
@@ -12104,7 +12253,7 @@ output_rnglists (unsigned generation, bool dwo)
 	  ASM_GENERATE_INTERNAL_LABEL (blabel, BLOCK_BEGIN_LABEL, block_num);
 	  ASM_GENERATE_INTERNAL_LABEL (elabel, BLOCK_END_LABEL, block_num);
 
-	  if (HAVE_AS_LEB128)
+	  if (leb128)
 	    {
 	      /* If all code is in the text section, then the compilation
 		 unit base address defaults to DW_AT_low_pc, which is the
@@ -12198,7 +12347,7 @@ output_rnglists (unsigned generation, bool dwo)
 
 	  if (!have_multiple_function_sections)
 	    gcc_unreachable ();
-	  if (HAVE_AS_LEB128)
+	  if (leb128)
 	    {
 	      if (dwarf_split_debug_info)
 		{
@@ -31485,7 +31634,8 @@ index_location_lists (dw_die_ref die)
 
             curr->begin_entry
 	      = add_addr_table_entry (xstrdup (curr->begin), ate_kind_label);
-	    if (dwarf_version >= 5 && !HAVE_AS_LEB128)
+	    if ((dwarf_version >= 5 && !HAVE_AS_LEB128)
+		|| !dwo_code_label_deltas_p ())
 	      curr->end_entry
 		= add_addr_table_entry (xstrdup (curr->end), ate_kind_label);
           }
@@ -31684,6 +31834,9 @@ dwarf2out_finish (const char *filename)
 		adjust_name_comp_dir (node->die);
 	    }
 	}
+
+      /* The early abbreviations' attributes and forms have changed.  */
+      abbrev_hash_table_stale = true;
     }
 
 #if ENABLE_ASSERT_CHECKING
@@ -32663,6 +32816,8 @@ dwarf2out_c_finalize (void)
   tail_call_site_count = -1;
   cached_dw_loc_list_table = NULL;
   abbrev_die_table = NULL;
+  delete abbrev_hash_table;
+  abbrev_hash_table = NULL;
   delete dwarf_proc_stack_usage_map;
   dwarf_proc_stack_usage_map = NULL;
   line_info_label_num = 0;
@@ -11596,6 +11596,338 @@ copyable_array_p (gfc_expr * expr)
   return false;
 }
 
+
+/* Callback for gfc_traverse_expr: true for calls of anything but an
+   intrinsic function, which might have side effects.  */
+
+static bool
+non_intrinsic_call_p (gfc_expr *expr, gfc_symbol *sym ATTRIBUTE_UNUSED,
+		      int *f ATTRIBUTE_UNUSED)
+{
+  return (expr->expr_type == EXPR_PPC
+	  || expr->expr_type == EXPR_COMPCALL
+	  || (expr->expr_type == EXPR_FUNCTION
+	      && (expr->value.function.isym == NULL
+		  || expr->value.function.esym != NULL)));
+}
+
+
+/* Check whether the memory EXPR refers to can be computed at run time
+   for an overlap check, i.e. whether it is a full array or an array
+   section without vector subscripts of a simple enough type.  */
+
+static bool
+overlap_checkable_array_p (gfc_expr *expr)
+{
+  gfc_ref *ref;
+  int n;
+
+  if (expr->expr_type != EXPR_VARIABLE
+      || expr->rank < 1
+      || !expr->ref
+      || expr->symtree->n.sym->assoc
+      || gfc_is_coindexed (expr))
+    return false;
+
+  switch (expr->ts.type)
+    {
+    case BT_INTEGER:
+    case BT_REAL:
+    case BT_COMPLEX:
+    case BT_LOGICAL:
+      break;
+
+    default:
+      return false;
+    }
+
+  for (ref = expr->ref; ref->next; ref = ref->next)
+    ;
+
+  if (ref->type != REF_ARRAY
+      || (ref->u.ar.type != AR_FULL && ref->u.ar.type != AR_SECTION))
+    return false;
+
+  for (n = 0; n < ref->u.ar.dimen; n++)
+    if (ref->u.ar.dimen_type[n] == DIMEN_VECTOR)
+      return false;
+
+  return true;
+}
+
+
+/* Return true if the array operand EXPR of the rhs of an assignment to
+   EXPR1 needs to be checked for overlap with EXPR1 at run time, i.e.
+   unless it is a reference to the same array that gfc_dep_resolver finds
+   to be identical or disjoint.  */
+
+static bool
+overlap_check_needed_p (gfc_expr *expr1, gfc_expr *expr)
+{
+  return (expr->symtree->n.sym != expr1->symtree->n.sym
+	  || gfc_dep_resolver (expr1->ref, expr->ref, NULL) != 0);
+}
+
+
+/* Count the array operands of EXPR, the rhs of an assignment to EXPR1,
+   that need to be checked for overlap with EXPR1.  Return -1 if EXPR is
+   not an elemental expression of array variables that can be checked.  */
+
+static int
+count_overlap_checks (gfc_expr *expr1, gfc_expr *expr)
+{
+  gfc_actual_arglist *arg;
+  int n, m;
+
+  if (expr->rank == 0)
+    return 0;
+
+  switch (expr->expr_type)
+    {
+    case EXPR_VARIABLE:
+      if (!overlap_checkable_array_p (expr))
+	return -1;
+      return overlap_check_needed_p (expr1, expr) ? 1 : 0;
+
+    case EXPR_OP:
+      n = count_overlap_checks (expr1, expr->value.op.op1);
+      if (n < 0 || !expr->value.op.op2)
+	return n;
+      m = count_overlap_checks (expr1, expr->value.op.op2);
+      return m < 0 ? -1 : n + m;
+
+    case EXPR_FUNCTION:
+      if (!expr->value.function.isym->elemental)
+	return -1;
+      n = 0;
+      for (arg = expr->value.function.actual; arg; arg = arg->next)
+	if (arg->expr)
+	  {
+	    m = count_overlap_checks (expr1, arg->expr);
+	    if (m < 0)
+	      return -1;
+	    n += m;
+	  }
+      return n;
+
+    default:
+      return -1;
+    }
+}
+
+
+/* Return true if the scalarizer would evaluate the rhs of the array
+   assignment EXPR1 = EXPR2 into a temporary.  */
+
+static bool
+assignment_needs_temporary_p (gfc_expr *expr1, gfc_expr *expr2)
+{
+  gfc_loopinfo loop;
+  gfc_ss *lss;
+  gfc_ss *rss;
+  bool needs_temp;
+  int n;
+
+  lss = gfc_walk_expr (expr1);
+  rss = gfc_walk_expr (expr2);
+
+  gfc_init_loopinfo (&loop);
+  gfc_add_ss_to_loop (&loop, lss);
+  gfc_add_ss_to_loop (&loop, rss);
+  for (n = 0; n < GFC_MAX_DIMENSIONS; n++)
+    loop.reverse[n] = GFC_ENABLE_REVERSE;
+  gfc_conv_resolve_dependencies (&loop, lss, rss);
+  needs_temp = loop.temp_ss != NULL;
+  gfc_cleanup_loop (&loop);
+
+  return needs_temp;
+}
+
+
+/* Evaluate in BLOCK the lowest address LO of the array reference EXPR
+   and the address HI just past its highest element.  */
+
+static void
+conv_array_ref_extent (stmtblock_t *block, gfc_expr *expr, tree *lo,
+		       tree *hi)
+{
+  gfc_se se;
+  tree desc;
+  tree data;
+  tree elem_size;
+  tree span;
+  tree low;
+  tree high;
+  tree dim;
+  tree tmp;
+  int n;
+
+  gfc_init_se (&se, NULL);
+  gfc_conv_expr_descriptor (&se, expr);
+  gfc_add_block_to_block (block, &se.pre);
+  desc = se.expr;
+
+  elem_size = fold_convert (gfc_array_index_type,
+			    size_in_bytes (gfc_typenode_for_spec (&expr->ts)));
+  /* The elements of a pointer array may be further apart than their
+     size, e.g. for  p => x(:)%re.  */
+  if (gfc_expr_attr (expr).pointer)
+    span = gfc_conv_descriptor_span_get (desc);
+  else
+    span = elem_size;
+
+  low = gfc_index_zero_node;
+  high = gfc_index_zero_node;
+  for (n = 0; n < expr->rank; n++)
+    {
+      dim = gfc_rank_cst[n];
+      tmp = fold_build2_loc (input_location, MINUS_EXPR,
+			     gfc_array_index_type,
+			     gfc_conv_descriptor_ubound_get (desc, dim),
+			     gfc_conv_descriptor_lbound_get (desc, dim));
+      tmp = fold_build2_loc (input_location, MULT_EXPR, gfc_array_index_type,
+			     tmp, gfc_conv_descriptor_stride_get (desc, dim));
+      tmp = gfc_evaluate_now (tmp, block);
+      low = fold_build2_loc (input_location, PLUS_EXPR, gfc_array_index_type,
+			     low, fold_build2_loc (input_location, MIN_EXPR,
+						   gfc_array_index_type, tmp,
+						   gfc_index_zero_node));
+      high = fold_build2_loc (input_location, PLUS_EXPR, gfc_array_index_type,
+			      high, fold_build2_loc (input_location, MAX_EXPR,
+						     gfc_array_index_type, tmp,
+						     gfc_index_zero_node));
+    }
+
+  low = fold_build2_loc (input_location, MULT_EXPR, gfc_array_index_type,
+			 low, span);
+  high = fold_build2_loc (input_location, MULT_EXPR, gfc_array_index_type,
+			  high, span);
+  high = fold_build2_loc (input_location, PLUS_EXPR, gfc_array_index_type,
+			  high, elem_size);
+
+  data = fold_convert (pvoid_type_node, gfc_conv_descriptor_data_get (desc));
+  data = gfc_evaluate_now (data, block);
+  *lo = gfc_evaluate_now (fold_build_pointer_plus_loc (input_location,
+						       data, low), block);
+  *hi = gfc_evaluate_now (fold_build_pointer_plus_loc (input_location,
+						       data, high), block);
+  gfc_add_block_to_block (block, &se.post);
+}
+
+
+/* Build in BLOCK the condition that none of the array operands of EXPR
+   counted by count_overlap_checks overlaps the memory from LO1 to HI1
+   that the assignment to EXPR1 writes.  Return NULL_TREE if there are
+   no such operands.  */
+
+static tree
+conv_no_overlap_cond (stmtblock_t *block, gfc_expr *expr1, gfc_expr *expr,
+		      tree lo1, tree hi1)
+{
+  gfc_actual_arglist *arg;
+  tree cond = NULL_TREE;
+  tree lo;
+  tree hi;
+  tree tmp;
+
+  if (expr->rank == 0)
+    return NULL_TREE;
+
+  switch (expr->expr_type)
+    {
+    case EXPR_VARIABLE:
+      if (!overlap_check_needed_p (expr1, expr))
+	return NULL_TREE;
+      conv_array_ref_extent (block, expr, &lo, &hi);
+      cond = fold_build2_loc (input_location, LE_EXPR, logical_type_node,
+			      hi, lo1);
+      tmp = fold_build2_loc (input_location, LE_EXPR, logical_type_node,
+			     hi1, lo);
+      return fold_build2_loc (input_location, TRUTH_OR_EXPR,
+			      logical_type_node, cond, tmp);
+
+    case EXPR_OP:
+      cond = conv_no_overlap_cond (block, expr1, expr->value.op.op1, lo1, hi1);
+      if (expr->value.op.op2)
+	{
+	  tmp = conv_no_overlap_cond (block, expr1, expr->value.op.op2,
+				      lo1, hi1);
+	  if (cond == NULL_TREE)
+	    cond = tmp;
+	  else if (tmp != NULL_TREE)
+	    cond = fold_build2_loc (input_location, TRUTH_AND_EXPR,
+				    logical_type_node, cond, tmp);
+	}
+      return cond;
+
+    case EXPR_FUNCTION:
+      for (arg = expr->value.function.actual; arg; arg = arg->next)
+	{
+	  if (!arg->expr)
+	    continue;
+	  tmp = conv_no_overlap_cond (block, expr1, arg->expr, lo1, hi1);
+	  if (cond == NULL_TREE)
+	    cond = tmp;
+	  else if (tmp != NULL_TREE)
+	    cond = fold_build2_loc (input_location, TRUTH_AND_EXPR,
+				    logical_type_node, cond, tmp);
+	}
+      return cond;
+
+    default:
+      gcc_unreachable ();
+    }
+}
+
+
+/* The scalarizer evaluates the rhs of an array assignment into a
+   temporary whenever it cannot prove at compile time that the lhs does
+   not overlap with the arrays the rhs reads, e.g. when they are pointers
+   or sections with unknown bounds of the same array.  If the memory that
+   the assignment EXPR1 = EXPR2 writes and reads can be computed, check
+   at run time whether it overlaps and only use the temporary if it does.
+   Return NULL_TREE if the assignment is not suitable.  */
+
+static tree
+trans_overlap_checked_assignment (gfc_expr *expr1, gfc_expr *expr2,
+				  bool init_flag, bool dealloc)
+{
+  stmtblock_t block;
+  tree lo;
+  tree hi;
+  tree cond;
+  tree fast;
+  tree slow;
+
+  /* Both versions of the assignment are generated, so don't do this
+     when optimizing for size.  */
+  if (!optimize || optimize_size
+      || flag_coarray == GFC_FCOARRAY_LIB
+      || (ompws_flags & OMPWS_WORKSHARE_FLAG)
+      || expr2->rank == 0
+      || !overlap_checkable_array_p (expr1)
+      || (flag_realloc_lhs && gfc_is_reallocatable_lhs (expr1))
+      || gfc_traverse_expr (expr1, NULL, non_intrinsic_call_p, 0)
+      || gfc_traverse_expr (expr2, NULL, non_intrinsic_call_p, 0)
+      || count_overlap_checks (expr1, expr2) <= 0
+      || !assignment_needs_temporary_p (expr1, expr2))
+    return NULL_TREE;
+
+  gfc_start_block (&block);
+  conv_array_ref_extent (&block, expr1, &lo, &hi);
+  cond = conv_no_overlap_cond (&block, expr1, expr2, lo, hi);
+  gcc_assert (cond != NULL_TREE);
+
+  fast = gfc_trans_assignment_1 (expr1, expr2, init_flag, dealloc,
+				 false, false);
+  slow = gfc_trans_assignment_1 (expr1, expr2, init_flag, dealloc,
+				 false, true);
+  cond = gfc_likely (cond, PRED_FORTRAN_NO_OVERLAP);
+  gfc_add_expr_to_block (&block, build3_v (COND_EXPR, cond, fast, slow));
+
+  return gfc_finish_block (&block);
+}
+
 /* Translate an assignment.  */
 
 tree
@@ -11645,6 +11977,15 @@ gfc_trans_assignment (gfc_expr * expr1, gfc_expr * expr2, bool init_flag,
   if (UNLIMITED_POLY (expr1) && expr1->rank)
     use_vptr_copy = true;
 
+  /* Avoid the temporary for possibly overlapping operands at run time.  */
+  if (may_alias && !use_vptr_copy)
+    {
+      tmp = trans_overlap_checked_assignment (expr1, expr2, init_flag,
+					      dealloc);
+      if (tmp)
+	return tmp;
+    }
+
   /* Fallback to the scalarizer to generate explicit loops.  */
   return gfc_trans_assignment_1 (expr1, expr2, init_flag, dealloc,
 				 use_vptr_copy, may_alias);
@@ -3077,6 +3077,56 @@ find_a_file (const struct path_prefix *pprefix, const char *name, int mode,
 				file_at_path, &info);
 }
 
+/* The programs that execute has already looked for in exec_prefixes,
+   so that compiling many input files searches for cc1, as and the
+   rest only once rather than once per file.  */
+
+struct found_program
+{
+  char *name;
+  char *path;			/* NULL if not found.  */
+  struct found_program *next;
+};
+
+static struct found_program *found_programs;
+
+/* Forget the results of find_a_program, for when exec_prefixes
+   changes.  */
+
+static void
+forget_found_programs (void)
+{
+  while (found_programs)
+    {
+      struct found_program *next = found_programs->next;
+      free (found_programs->name);
+      free (found_programs->path);
+      XDELETE (found_programs);
+      found_programs = next;
+    }
+}
+
+/* Equivalent to find_a_file (&exec_prefixes, NAME, X_OK, false), but
+   remember the result for later calls.  */
+
+static char *
+find_a_program (const char *name)
+{
+  struct found_program *p;
+
+  for (p = found_programs; p; p = p->next)
+    if (strcmp (p->name, name) == 0)
+      return p->path ? xstrdup (p->path) : NULL;
+
+  char *path = find_a_file (&exec_prefixes, name, X_OK, false);
+  p = XNEW (struct found_program);
+  p->name = xstrdup (name);
+  p->path = path ? xstrdup (path) : NULL;
+  p->next = found_programs;
+  found_programs = p;
+  return path;
+}
+
 /* Ranking of prefixes in the sort list. -B prefixes are put before
    all others.  */
 
@@ -3108,6 +3158,9 @@ add_prefix (struct path_prefix *pprefix, const char *prefix,
   struct prefix_list *pl, **prev;
   int len;
 
+  if (pprefix == &exec_prefixes)
+    forget_found_programs ();
+
   for (prev = &pprefix->plist;
        (*prev) != NULL && (*prev)->priority <= priority;
        prev = &(*prev)->next)
@@ -3232,8 +3285,7 @@ execute (void)
 
   if (wrapper_string)
     {
-      string = find_a_file (&exec_prefixes,
-			    argbuf[0], X_OK, false);
+      string = find_a_program (argbuf[0]);
       if (string)
 	argbuf[0] = string;
       insert_wrapper (wrapper_string);
@@ -3258,7 +3310,7 @@ execute (void)
 
   if (!wrapper_string)
     {
-      string = find_a_file (&exec_prefixes, commands[0].prog, X_OK, false);
+      string = find_a_program (commands[0].prog);
       if (string)
 	commands[0].argv[0] = string;
     }
@@ -3273,8 +3325,7 @@ execute (void)
 	commands[n_commands].prog = argbuf[i + 1];
 	commands[n_commands].argv
 	  = &(argbuf.address ())[i + 1];
-	string = find_a_file (&exec_prefixes, commands[n_commands].prog,
-			      X_OK, false);
+	string = find_a_program (commands[n_commands].prog);
 	if (string)
 	  commands[n_commands].argv[0] = string;
 	n_commands++;
@@ -11008,6 +11059,7 @@ driver::finalize ()
   preprocessor_options.truncate (0);
 
   path_prefix_reset (&exec_prefixes);
+  forget_found_programs ();
   path_prefix_reset (&startfile_prefixes);
   path_prefix_reset (&include_prefixes);
 
@@ -158,6 +158,17 @@ see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
    zero.  Note that the data file might contain information from
    several runs concatenated, or the data might be merged.
 
+   A profile database, written by gcov-tool pack, holds many data files
+   in one file that -fprofile-use can read directly.
+	database: int32:magic int32:version int32:count int32:entry*
+		  entry* data*
+	entry: int32:position int32:length string:name
+
+   The ENTRY words give the positions of the entries, sorted by name,
+   so a data file can be found by binary search.  NAME is the path of
+   the data file relative to the profile directory, POSITION and
+   LENGTH locate its contents, in words.
+
    This file is included by both the compiler, gcov tools and the
    runtime support library libgcov. IN_LIBGCOV and IN_GCOV are used to
    distinguish which case is which.  If IN_LIBGCOV is nonzero,
@@ -220,10 +231,12 @@ typedef uint64_t gcov_type_unsigned;
 /* File suffixes.  */
 #define GCOV_DATA_SUFFIX ".gcda"
 #define GCOV_NOTE_SUFFIX ".gcno"
+#define GCOV_DB_SUFFIX ".gcdb"
 
 /* File magic. Must not be palindromes.  */
 #define GCOV_DATA_MAGIC ((gcov_unsigned_t)0x67636461) /* "gcda" */
 #define GCOV_NOTE_MAGIC ((gcov_unsigned_t)0x67636e6f) /* "gcno" */
+#define GCOV_DB_MAGIC ((gcov_unsigned_t)0x67636462) /* "gcdb" */
 
 /* gcov-iov.h is automatically generated by the makefile from
    version.c, it looks like
@@ -259,6 +272,7 @@ typedef uint64_t gcov_type_unsigned;
 #define GCOV_TAG_SUMMARY_LENGTH (2)
 #define GCOV_TAG_AFDO_FILE_NAMES ((gcov_unsigned_t)0xaa000000)
 #define GCOV_TAG_AFDO_FUNCTION ((gcov_unsigned_t)0xac000000)
+#define GCOV_TAG_AFDO_MODULE_GROUPING ((gcov_unsigned_t)0xae000000)
 #define GCOV_TAG_AFDO_WORKING_SET ((gcov_unsigned_t)0xaf000000)
 
 
@@ -24,6 +24,9 @@ see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
 <http://www.gnu.org/licenses/>.  */
 
 #include "config.h"
+#define INCLUDE_MAP
+#define INCLUDE_STRING
+#define INCLUDE_VECTOR
 #include "system.h"
 #include "coretypes.h"
 #include "tm.h"
@@ -48,6 +51,7 @@ extern struct gcov_info* gcov_read_profile_dir (const char*, int);
 extern void gcov_do_dump (struct gcov_info *, int);
 extern const char *gcov_get_filename (struct gcov_info *list);
 extern void gcov_set_verbose (void);
+extern void gcov_set_partition (unsigned, unsigned);
 
 /* Set to verbose output mode.  */
 static bool verbose;
@@ -88,15 +92,12 @@ unlink_profile_dir (const char *path ATTRIBUTE_UNUSED)
 #endif
 }
 
-/* Output GCOV_INFO lists PROFILE to directory OUT. Note that
-   we will remove all the gcda files in OUT.  */
+/* Create directory OUT if it doesn't exist yet, and remove all the
+   gcda files in it otherwise.  */
 
 static void
-gcov_output_files (const char *out, struct gcov_info *profile)
+prepare_output_dir (const char *out)
 {
-  char *pwd;
-  int ret;
-
   /* Try to make directory if it doesn't already exist.  */
   if (access (out, F_OK) == -1)
     {
@@ -104,6 +105,16 @@ gcov_output_files (const char *out, struct gcov_info *profile)
         fatal_error (input_location, "Cannot make directory %s", out);
     } else
       unlink_profile_dir (out);
+}
+
+/* Output GCOV_INFO lists PROFILE to directory OUT, which
+   prepare_output_dir has emptied.  */
+
+static void
+write_output_files (const char *out, struct gcov_info *profile)
+{
+  char *pwd;
+  int ret;
 
   /* Output new profile.  */
   pwd = getcwd (NULL, 0);
@@ -132,39 +143,117 @@ gcov_output_files (const char *out, struct gcov_info *profile)
   free (pwd);
 }
 
-/* Merging profile D1 and D2 with weight as W1 and W2, respectively.
-   The result profile is written to directory OUT.
-   Return 0 on success.  */
+/* Output GCOV_INFO lists PROFILE to directory OUT. Note that
+   we will remove all the gcda files in OUT.  */
+
+static void
+gcov_output_files (const char *out, struct gcov_info *profile)
+{
+  prepare_output_dir (out);
+  write_output_files (out, profile);
+}
+
+/* Merge the profiles in the N_DIRS directories DIRS, weighting the first
+   two with W1 and W2, respectively.  The result profile is written to
+   directory OUT.  PARTIAL is true in a job that only reads its share of
+   the gcda files; such a job may find none in a directory, and leaves
+   cleaning OUT to its parent.  Return 0 on success.  */
 
 static int
-profile_merge (const char *d1, const char *d2, const char *out, int w1, int w2)
+profile_merge (char **dirs, int n_dirs, const char *out, int w1, int w2,
+	       bool partial)
 {
-  struct gcov_info *d1_profile;
-  struct gcov_info *d2_profile;
+  struct gcov_info *merged = NULL;
+  int merged_weight = 1;
   int ret;
 
-  d1_profile = gcov_read_profile_dir (d1, 0);
-  if (!d1_profile)
-    return 1;
-
-  if (d2)
+  for (int i = 0; i < n_dirs; i++)
     {
-      d2_profile = gcov_read_profile_dir (d2, 0);
-      if (!d2_profile)
-        return 1;
-
-      /* The actual merge: we overwrite to d1_profile.  */
-      ret = gcov_profile_merge (d1_profile, d2_profile, w1, w2);
-
+      struct gcov_info *profile = gcov_read_profile_dir (dirs[i], 0);
+      int weight = i == 0 ? w1 : i == 1 ? w2 : 1;
+
+      if (!profile)
+	{
+	  if (partial)
+	    continue;
+	  return 1;
+	}
+
+      if (!merged)
+	{
+	  merged = profile;
+	  merged_weight = weight;
+	  continue;
+	}
+
+      /* The actual merge: we overwrite to merged.  */
+      ret = gcov_profile_merge (merged, profile, merged_weight, weight);
       if (ret)
-        return ret;
+	return ret;
+      merged_weight = 1;
     }
 
-  gcov_output_files (out, d1_profile);
+  if (!merged)
+    return 0;
+
+  /* Only one directory had files for this job.  */
+  if (merged_weight > 1)
+    gcov_profile_scale (merged, 0.0, merged_weight, 1);
+
+  if (partial)
+    write_output_files (out, merged);
+  else
+    gcov_output_files (out, merged);
 
   return 0;
 }
 
+/* Merge as profile_merge does, but with JOBS processes that each handle
+   the gcda files whose names hash to their job number.  */
+
+static int
+profile_merge_parallel (char **dirs, int n_dirs, const char *out,
+			int w1, int w2, int jobs)
+{
+#ifdef HAVE_WORKING_FORK
+  int status, ret = 0;
+
+  for (int i = 0; i < n_dirs; i++)
+    if (access (dirs[i], R_OK) != 0)
+      {
+	fnotice (stderr, "cannot access directory %s\n", dirs[i]);
+	return 1;
+      }
+
+  prepare_output_dir (out);
+  fflush (stdout);
+  fflush (stderr);
+
+  for (int j = 0; j < jobs; j++)
+    {
+      pid_t pid = fork ();
+
+      if (pid == -1)
+	fatal_error (input_location, "cannot fork merge job: %m");
+      if (pid == 0)
+	{
+	  gcov_set_partition (j, jobs);
+	  exit (profile_merge (dirs, n_dirs, out, w1, w2, true)
+		? FATAL_EXIT_CODE : SUCCESS_EXIT_CODE);
+	}
+    }
+
+  while (wait (&status) > 0)
+    if (!WIFEXITED (status) || WEXITSTATUS (status) != SUCCESS_EXIT_CODE)
+      ret = 1;
+
+  return ret;
+#else
+  (void) jobs;
+  return profile_merge (dirs, n_dirs, out, w1, w2, false);
+#endif
+}
+
 /* Usage message for profile merge.  */
 
 static void
@@ -172,7 +261,8 @@ print_merge_usage_message (int error_p)
 {
   FILE *file = error_p ? stderr : stdout;
 
-  fnotice (file, "  merge [options] <dir1> <dir2>         Merge coverage file contents\n");
+  fnotice (file, "  merge [options] <dir1> <dir2> [<dir>...] Merge coverage file contents\n");
+  fnotice (file, "    -j, --jobs <n>                      Merge with n parallel jobs\n");
   fnotice (file, "    -o, --output <dir>                  Output directory\n");
   fnotice (file, "    -v, --verbose                       Verbose mode\n");
   fnotice (file, "    -w, --weight <w1,w2>                Set weights (float point values)\n");
@@ -181,6 +271,7 @@ print_merge_usage_message (int error_p)
 static const struct option merge_options[] =
 {
   { "verbose",                no_argument,       NULL, 'v' },
+  { "jobs",                   required_argument, NULL, 'j' },
   { "output",                 required_argument, NULL, 'o' },
   { "weight",                 required_argument, NULL, 'w' },
   { 0, 0, 0, 0 }
@@ -204,9 +295,10 @@ do_merge (int argc, char **argv)
   int opt;
   const char *output_dir = 0;
   int w1 = 1, w2 = 1;
+  int jobs = 1;
 
   optind = 0;
-  while ((opt = getopt_long (argc, argv, "vo:w:", merge_options, NULL)) != -1)
+  while ((opt = getopt_long (argc, argv, "vj:o:w:", merge_options, NULL)) != -1)
     {
       switch (opt)
         {
@@ -214,6 +306,11 @@ do_merge (int argc, char **argv)
           verbose = true;
           gcov_set_verbose ();
           break;
+        case 'j':
+          jobs = atoi (optarg);
+          if (jobs < 1)
+	    fatal_error (input_location, "number of jobs must be positive");
+          break;
         case 'o':
           output_dir = optarg;
           break;
@@ -230,10 +327,18 @@ do_merge (int argc, char **argv)
   if (output_dir == NULL)
     output_dir = "merged_profile";
 
-  if (argc - optind != 2)
+  if (argc - optind < 2)
     merge_usage ();
 
-  return profile_merge (argv[optind], argv[optind+1], output_dir, w1, w2);
+  if (argc - optind > 2 && (w1 != 1 || w2 != 1))
+    fatal_error (input_location,
+		 "weights are only supported when merging two directories");
+
+  if (jobs > 1)
+    return profile_merge_parallel (argv + optind, argc - optind, output_dir,
+				   w1, w2, jobs);
+  return profile_merge (argv + optind, argc - optind, output_dir, w1, w2,
+			false);
 }
 
 /* If N_VAL is no-zero, normalize the profile by setting the largest counter
@@ -498,6 +603,703 @@ do_overlap (int argc, char **argv)
 }
 
 
+/* A gcda file to be stored in a profile database.  */
+
+struct db_entry
+{
+  char *name;
+  gcov_unsigned_t *data;
+  gcov_unsigned_t length;
+};
+
+static struct db_entry *db_entries;
+static unsigned db_count, db_alloc;
+
+#if HAVE_FTW_H
+
+/* Add file NAME to the profile database if it has a gcda suffix.  */
+
+static int
+pack_gcda_file (const char *name,
+		const struct stat *status,
+		int type,
+		struct FTW *ftwbuf ATTRIBUTE_UNUSED)
+{
+  int len = strlen (name);
+  int len1 = strlen (GCOV_DATA_SUFFIX);
+  struct db_entry *entry;
+  FILE *file;
+
+  if (type != FTW_F
+      || len <= len1
+      || strcmp (name + len - len1, GCOV_DATA_SUFFIX))
+    return 0;
+
+  if (status->st_size % 4)
+    {
+      fnotice (stderr, "%s is not a gcov data file, skipping\n", name);
+      return 0;
+    }
+
+  if (verbose)
+    fnotice (stderr, "packing file: %s\n", name);
+
+  if (db_count == db_alloc)
+    {
+      db_alloc = db_alloc ? db_alloc * 2 : 64;
+      db_entries = XRESIZEVEC (struct db_entry, db_entries, db_alloc);
+    }
+  entry = &db_entries[db_count];
+
+  /* Names are relative to the profile directory.  */
+  if (name[0] == '.' && IS_DIR_SEPARATOR (name[1]))
+    name += 2;
+  entry->name = xstrdup (name);
+  entry->length = status->st_size / 4;
+  entry->data = XNEWVEC (gcov_unsigned_t, entry->length);
+
+  file = fopen (entry->name, "rb");
+  if (!file
+      || fread (entry->data, 4, entry->length, file) != entry->length)
+    fatal_error (input_location, "cannot read %s", entry->name);
+  fclose (file);
+
+  db_count++;
+  return 0;
+}
+#endif
+
+/* Order database entries by name.  */
+
+static int
+compare_db_entries (const void *x, const void *y)
+{
+  return strcmp (((const struct db_entry *) x)->name,
+		 ((const struct db_entry *) y)->name);
+}
+
+/* Write the words of string STR to FILE in the gcov format.  */
+
+static void
+write_db_string (FILE *file, const char *str)
+{
+  gcov_unsigned_t len = strlen (str);
+  gcov_unsigned_t words = (len + 4) >> 2;
+  static const char zeros[4] = { 0, 0, 0, 0 };
+
+  fwrite (&words, 4, 1, file);
+  fwrite (str, 1, len, file);
+  fwrite (zeros, 1, words * 4 - len, file);
+}
+
+/* Pack the gcda files in directory DIR into profile database OUT.
+   Return 0 on success.  */
+
+static int
+profile_pack (const char *dir, const char *out)
+{
+  gcov_unsigned_t header[3] = { GCOV_DB_MAGIC, GCOV_VERSION, 0 };
+  gcov_unsigned_t pos;
+  FILE *file;
+  char *pwd;
+  unsigned i;
+
+  file = fopen (out, "wb");
+  if (!file)
+    fatal_error (input_location, "cannot open %s", out);
+
+  pwd = getcwd (NULL, 0);
+  if (pwd == NULL)
+    fatal_error (input_location, "Cannot get current directory name");
+  if (chdir (dir))
+    {
+      fnotice (stderr, "%s is not a directory\n", dir);
+      return 1;
+    }
+#if HAVE_FTW_H
+  nftw (".", pack_gcda_file, 64, FTW_PHYS);
+#endif
+  if (chdir (pwd))
+    fatal_error (input_location, "Cannot change directory to %s", pwd);
+  free (pwd);
+
+  qsort (db_entries, db_count, sizeof (struct db_entry), compare_db_entries);
+
+  /* The header, then the positions of the entries.  */
+  header[2] = db_count;
+  fwrite (header, 4, 3, file);
+  pos = 3 + db_count;
+  for (i = 0; i < db_count; i++)
+    {
+      fwrite (&pos, 4, 1, file);
+      pos += 3 + ((strlen (db_entries[i].name) + 4) >> 2);
+    }
+
+  /* The entries, then the contents of the gcda files.  */
+  for (i = 0; i < db_count; i++)
+    {
+      fwrite (&pos, 4, 1, file);
+      fwrite (&db_entries[i].length, 4, 1, file);
+      write_db_string (file, db_entries[i].name);
+      pos += db_entries[i].length;
+    }
+  for (i = 0; i < db_count; i++)
+    fwrite (db_entries[i].data, 4, db_entries[i].length, file);
+
+  if (fclose (file))
+    fatal_error (input_location, "error writing %s", out);
+
+  return 0;
+}
+
+/* Usage message for profile pack.  */
+
+static void
+print_pack_usage_message (int error_p)
+{
+  FILE *file = error_p ? stderr : stdout;
+
+  fnotice (file, "  pack [options] <dir>                  Pack a profile directory into one file for -fprofile-use\n");
+  fnotice (file, "    -o, --output <file>                 Output profile database\n");
+  fnotice (file, "    -v, --verbose                       Verbose mode\n");
+}
+
+static const struct option pack_options[] =
+{
+  { "verbose",                no_argument,       NULL, 'v' },
+  { "output",                 required_argument, NULL, 'o' },
+  { 0, 0, 0, 0 }
+};
+
+/* Print pack usage and exit.  */
+
+static void ATTRIBUTE_NORETURN
+pack_usage (void)
+{
+  fnotice (stderr, "Pack subcommand usage:");
+  print_pack_usage_message (true);
+  exit (FATAL_EXIT_CODE);
+}
+
+/* Driver for profile pack sub-command.  */
+
+static int
+do_pack (int argc, char **argv)
+{
+  int opt;
+  const char *output_file = "profile" GCOV_DB_SUFFIX;
+
+  optind = 0;
+  while ((opt = getopt_long (argc, argv, "vo:", pack_options, NULL)) != -1)
+    {
+      switch (opt)
+        {
+        case 'v':
+          verbose = true;
+          break;
+        case 'o':
+          output_file = optarg;
+          break;
+        default:
+          pack_usage ();
+        }
+    }
+
+  if (argc - optind != 1)
+    pack_usage ();
+
+  return profile_pack (argv[optind], output_file);
+}
+
+/* Conversion of instruction samples to an AutoFDO profile.
+
+   The input has one sample per line, as printed by
+   "perf script -F ip,sym,symoff": the sampled instruction is given
+   as SYMBOL+0xOFFSET, or as a bare hexadecimal address when the
+   symbol is unknown, which is only meaningful for binaries that are
+   not position independent.  Samples are symbolized with addr2line,
+   which gives the inline stack, line and discriminator of each
+   instruction, and the count of a source position is the largest
+   count of its instructions.  Plain instruction sampling records no
+   branches, so the profile has no function entry counts; and since
+   addr2line cannot tell where an inlined function starts, lines are
+   absolute rather than relative to the start of the function.  This
+   is version 2 of the AutoFDO format.  */
+
+#define AFDO_VERSION 2
+
+/* A function, or a copy of one inlined into another.  */
+
+struct afdo_instance
+{
+  afdo_instance (unsigned name) : name (name) {}
+  ~afdo_instance ();
+
+  /* Index of the function name in the string table.  */
+  unsigned name;
+
+  /* Sample count of each position, with the line in the upper 16 bits
+     and the discriminator in the lower 16 bits.  */
+  std::map<gcov_unsigned_t, gcov_type> counts;
+
+  /* Instances inlined at each call position, keyed by the position and
+     the name of the callee.  */
+  std::map<std::pair<gcov_unsigned_t, unsigned>, afdo_instance *> callsites;
+};
+
+afdo_instance::~afdo_instance ()
+{
+  std::map<std::pair<gcov_unsigned_t, unsigned>, afdo_instance *>::iterator it;
+
+  for (it = callsites.begin (); it != callsites.end (); ++it)
+    delete it->second;
+}
+
+/* One frame of the inline stack of a sampled instruction.  */
+
+struct afdo_frame
+{
+  std::string function;
+  unsigned line;
+  unsigned discriminator;
+};
+
+/* The string table of the profile, and the index of each string.  */
+static std::vector<std::string> afdo_names;
+static std::map<std::string, unsigned> afdo_name_index;
+
+/* The outermost function instances, keyed by name.  */
+static std::map<unsigned, afdo_instance *> afdo_functions;
+
+/* Return the index of NAME in the string table, adding it if needed.  */
+
+static unsigned
+afdo_string_index (const std::string &name)
+{
+  std::map<std::string, unsigned>::iterator it = afdo_name_index.find (name);
+
+  if (it != afdo_name_index.end ())
+    return it->second;
+  afdo_names.push_back (name);
+  return afdo_name_index[name] = afdo_names.size () - 1;
+}
+
+/* Read a line from FILE into LINE.  Return false at end of file.  */
+
+static bool
+afdo_read_line (FILE *file, std::string *line)
+{
+  int c;
+
+  line->clear ();
+  while ((c = getc (file)) != EOF && c != '\n')
+    line->push_back (c);
+  return c != EOF || !line->empty ();
+}
+
+/* Run PROG with arguments ARGV, sending its standard output to OUT.  */
+
+static void
+afdo_run (const char *prog, const char **argv, const char *out)
+{
+  const char *errmsg;
+  int status, err;
+
+  errmsg = pex_one (PEX_LAST | PEX_SEARCH, prog,
+		    CONST_CAST2 (char * const *, const char **, argv),
+		    progname, out, NULL, &status, &err);
+  if (errmsg)
+    fatal_error (input_location, "cannot run %s: %s", prog, errmsg);
+  if (!WIFEXITED (status) || WEXITSTATUS (status))
+    fatal_error (input_location, "%s failed", prog);
+}
+
+/* Read the addresses of the function symbols of BINARY into SYMBOLS,
+   using NM.  */
+
+static void
+afdo_read_symbols (const char *nm, const char *binary,
+		   std::map<std::string, uint64_t> *symbols)
+{
+  const char *argv[] = { nm, "--defined-only", binary, NULL };
+  char *out = make_temp_file (".nm");
+  unsigned long long addr;
+  std::string line;
+  char type;
+  int n;
+  FILE *file;
+
+  afdo_run (nm, argv, out);
+  file = fopen (out, "r");
+  if (!file)
+    fatal_error (input_location, "cannot open %s", out);
+  while (afdo_read_line (file, &line))
+    if (sscanf (line.c_str (), "%llx %c %n", &addr, &type, &n) == 2
+	&& strchr ("tTwW", type))
+      (*symbols)[line.substr (n)] = addr;
+  fclose (file);
+  unlink (out);
+  free (out);
+}
+
+/* Count the samples in file NAME by instruction address into SAMPLES.
+   SYMBOLS gives the address of each function symbol.  */
+
+static void
+afdo_read_samples (const char *name,
+		   const std::map<std::string, uint64_t> &symbols,
+		   std::map<uint64_t, gcov_type> *samples)
+{
+  FILE *file = fopen (name, "r");
+  std::string line;
+
+  if (!file)
+    fatal_error (input_location, "cannot open %s", name);
+  while (afdo_read_line (file, &line))
+    {
+      const char *p = line.c_str ();
+      const char *first = NULL;
+      bool found = false;
+      uint64_t addr = 0;
+
+      while (*p)
+	{
+	  const char *start;
+
+	  while (ISSPACE (*p))
+	    p++;
+	  if (!*p)
+	    break;
+	  start = p;
+	  while (*p && !ISSPACE (*p))
+	    p++;
+	  if (!first)
+	    first = start;
+
+	  /* SYMBOL+0xOFFSET.  */
+	  std::string token (start, p - start);
+	  size_t plus = token.rfind ("+0x");
+	  if (plus == std::string::npos || plus == 0)
+	    continue;
+	  std::map<std::string, uint64_t>::const_iterator it
+	    = symbols.find (token.substr (0, plus));
+	  if (it == symbols.end ())
+	    continue;
+	  addr = it->second + strtoull (token.c_str () + plus + 3, NULL, 16);
+	  found = true;
+	  break;
+	}
+
+      if (!found && first)
+	{
+	  char *end;
+	  addr = strtoull (first, &end, 16);
+	  found = end != first && (!*end || ISSPACE (*end));
+	}
+      if (found)
+	(*samples)[addr]++;
+    }
+  fclose (file);
+}
+
+/* Add COUNT samples of an instruction whose inline stack, innermost
+   first, is FRAMES.  */
+
+static void
+afdo_add_sample (const std::vector<afdo_frame> &frames, gcov_type count)
+{
+  afdo_instance *s;
+  unsigned i, name;
+
+  if (frames.empty ())
+    return;
+  for (i = 0; i < frames.size (); i++)
+    if (frames[i].function == "??"
+	|| frames[i].line == 0
+	|| frames[i].line >= (1 << 16))
+      return;
+
+  name = afdo_string_index (frames.back ().function);
+  afdo_instance *&top = afdo_functions[name];
+  if (!top)
+    top = new afdo_instance (name);
+  s = top;
+  for (i = frames.size () - 1; i > 0; i--)
+    {
+      unsigned callee = afdo_string_index (frames[i - 1].function);
+      afdo_instance *&inlined
+	= s->callsites[std::make_pair (frames[i].line << 16, callee)];
+      if (!inlined)
+	inlined = new afdo_instance (callee);
+      s = inlined;
+    }
+
+  gcov_type &total = s->counts[(frames[0].line << 16)
+			       | (frames[0].discriminator & 0xffff)];
+  total = MAX (total, count);
+}
+
+/* Symbolize the addresses in SAMPLES with ADDR2LINE and BINARY, and add
+   them to the function instances.  */
+
+static void
+afdo_symbolize (const char *addr2line, const char *binary,
+		const std::map<uint64_t, gcov_type> &samples)
+{
+  char *in = make_temp_file (".addr");
+  char *out = make_temp_file (".line");
+  std::map<uint64_t, gcov_type>::const_iterator it;
+  std::vector<afdo_frame> frames;
+  std::string arg = std::string ("@") + in;
+  const char *argv[] = { addr2line, "-a", "-f", "-i", "-e", binary,
+			 arg.c_str (), NULL };
+  std::string line, loc;
+  gcov_type count = 0;
+  FILE *file;
+
+  file = fopen (in, "w");
+  if (!file)
+    fatal_error (input_location, "cannot open %s", in);
+  for (it = samples.begin (); it != samples.end (); ++it)
+    fprintf (file, "0x%llx\n", (unsigned long long) it->first);
+  if (fclose (file))
+    fatal_error (input_location, "error writing %s", in);
+
+  afdo_run (addr2line, argv, out);
+
+  /* Each address is followed by its inline stack, innermost first, as
+     pairs of lines: the function name, then FILE:LINE with an optional
+     " (discriminator N)".  */
+  file = fopen (out, "r");
+  if (!file)
+    fatal_error (input_location, "cannot open %s", out);
+  while (afdo_read_line (file, &line))
+    {
+      unsigned long long addr;
+      int n;
+
+      if (sscanf (line.c_str (), "0x%llx%n", &addr, &n) == 1
+	  && (size_t) n == line.size ())
+	{
+	  afdo_add_sample (frames, count);
+	  frames.clear ();
+	  it = samples.find (addr);
+	  count = it == samples.end () ? 0 : it->second;
+	  continue;
+	}
+      if (!afdo_read_line (file, &loc))
+	break;
+
+      afdo_frame frame;
+      size_t disc = loc.find (" (discriminator ");
+      size_t colon = loc.rfind (':', disc);
+      frame.function = line;
+      frame.line = colon == std::string::npos ? 0
+		   : atoi (loc.c_str () + colon + 1);
+      frame.discriminator = disc == std::string::npos ? 0
+			    : atoi (loc.c_str () + disc + 16);
+      frames.push_back (frame);
+    }
+  afdo_add_sample (frames, count);
+  fclose (file);
+
+  unlink (in);
+  unlink (out);
+  free (in);
+  free (out);
+}
+
+/* Append STR to WORDS in the gcov string format.  */
+
+static void
+afdo_put_string (std::vector<gcov_unsigned_t> *words, const std::string &str)
+{
+  gcov_unsigned_t length = (str.size () + 4) >> 2;
+  size_t base = words->size ();
+
+  words->push_back (length);
+  words->resize (base + 1 + length, 0);
+  memcpy (&(*words)[base + 1], str.c_str (), str.size ());
+}
+
+/* Append counter VALUE to WORDS.  */
+
+static void
+afdo_put_counter (std::vector<gcov_unsigned_t> *words, gcov_type value)
+{
+  words->push_back ((gcov_unsigned_t) value);
+  words->push_back ((gcov_unsigned_t) (value >> 32));
+}
+
+/* Append function instance S and the instances inlined into it to
+   WORDS, in the layout read by read_function_instance.  */
+
+static void
+afdo_put_instance (std::vector<gcov_unsigned_t> *words,
+		   const afdo_instance *s)
+{
+  std::map<gcov_unsigned_t, gcov_type>::const_iterator pos;
+  std::map<std::pair<gcov_unsigned_t, unsigned>,
+	   afdo_instance *>::const_iterator call;
+
+  words->push_back (s->name);
+  words->push_back (s->counts.size ());
+  words->push_back (s->callsites.size ());
+  for (pos = s->counts.begin (); pos != s->counts.end (); ++pos)
+    {
+      words->push_back (pos->first);
+      /* No indirect call targets.  */
+      words->push_back (0);
+      afdo_put_counter (words, pos->second);
+    }
+  for (call = s->callsites.begin (); call != s->callsites.end (); ++call)
+    {
+      words->push_back (call->first.first);
+      afdo_put_instance (words, call->second);
+    }
+}
+
+/* Convert the samples in SAMPLES_FILE, taken from BINARY, into the
+   AutoFDO profile OUT.  Return 0 on success.  */
+
+static int
+profile_afdo (const char *samples_file, const char *binary, const char *out,
+	      const char *addr2line, const char *nm)
+{
+  std::map<std::string, uint64_t> symbols;
+  std::map<uint64_t, gcov_type> samples;
+  std::map<unsigned, afdo_instance *>::iterator it;
+  std::vector<gcov_unsigned_t> words;
+  size_t length;
+  unsigned i;
+  FILE *file;
+
+  afdo_read_symbols (nm, binary, &symbols);
+  afdo_read_samples (samples_file, symbols, &samples);
+  if (verbose)
+    fnotice (stderr, "%lu distinct instructions sampled\n",
+	     (unsigned long) samples.size ());
+  afdo_symbolize (addr2line, binary, samples);
+
+  words.push_back (GCOV_DATA_MAGIC);
+  words.push_back (AFDO_VERSION);
+  words.push_back (0);
+
+  words.push_back (GCOV_TAG_AFDO_FILE_NAMES);
+  length = words.size ();
+  words.push_back (0);
+  words.push_back (afdo_names.size ());
+  for (i = 0; i < afdo_names.size (); i++)
+    afdo_put_string (&words, afdo_names[i]);
+  words[length] = words.size () - length - 1;
+
+  /* The outermost instances have no entry counts.  */
+  words.push_back (GCOV_TAG_AFDO_FUNCTION);
+  length = words.size ();
+  words.push_back (0);
+  words.push_back (afdo_functions.size ());
+  for (it = afdo_functions.begin (); it != afdo_functions.end (); ++it)
+    {
+      afdo_put_counter (&words, 0);
+      afdo_put_instance (&words, it->second);
+    }
+  words[length] = words.size () - length - 1;
+
+  /* No module groups.  */
+  words.push_back (GCOV_TAG_AFDO_MODULE_GROUPING);
+  words.push_back (1);
+  words.push_back (0);
+
+  file = fopen (out, "wb");
+  if (!file)
+    fatal_error (input_location, "cannot open %s", out);
+  fwrite (&words[0], 4, words.size (), file);
+  if (fclose (file))
+    fatal_error (input_location, "error writing %s", out);
+
+  for (it = afdo_functions.begin (); it != afdo_functions.end (); ++it)
+    delete it->second;
+  return 0;
+}
+
+/* Usage message for profile afdo.  */
+
+static void
+print_afdo_usage_message (int error_p)
+{
+  FILE *file = error_p ? stderr : stdout;
+
+  fnotice (file, "  afdo [options] <samples>              Convert perf samples to an AutoFDO profile for -fauto-profile\n");
+  fnotice (file, "    -b, --binary <file>                 Profiled binary, with debug information\n");
+  fnotice (file, "    -o, --output <file>                 Output AutoFDO profile\n");
+  fnotice (file, "    -a, --addr2line <program>           addr2line program for the binary\n");
+  fnotice (file, "    -n, --nm <program>                  nm program for the binary\n");
+  fnotice (file, "    -v, --verbose                       Verbose mode\n");
+}
+
+static const struct option afdo_options[] =
+{
+  { "verbose",                no_argument,       NULL, 'v' },
+  { "binary",                 required_argument, NULL, 'b' },
+  { "output",                 required_argument, NULL, 'o' },
+  { "addr2line",              required_argument, NULL, 'a' },
+  { "nm",                     required_argument, NULL, 'n' },
+  { 0, 0, 0, 0 }
+};
+
+/* Print afdo usage and exit.  */
+
+static void ATTRIBUTE_NORETURN
+afdo_usage (void)
+{
+  fnotice (stderr, "Afdo subcommand usage:");
+  print_afdo_usage_message (true);
+  exit (FATAL_EXIT_CODE);
+}
+
+/* Driver for profile afdo sub-command.  */
+
+static int
+do_afdo (int argc, char **argv)
+{
+  int opt;
+  const char *binary = NULL;
+  const char *output_file = "fbdata.afdo";
+  const char *addr2line = "addr2line";
+  const char *nm = "nm";
+
+  optind = 0;
+  while ((opt = getopt_long (argc, argv, "vb:o:a:n:", afdo_options, NULL))
+	 != -1)
+    {
+      switch (opt)
+        {
+        case 'v':
+          verbose = true;
+          break;
+        case 'b':
+          binary = optarg;
+          break;
+        case 'o':
+          output_file = optarg;
+          break;
+        case 'a':
+          addr2line = optarg;
+          break;
+        case 'n':
+          nm = optarg;
+          break;
+        default:
+          afdo_usage ();
+        }
+    }
+
+  if (argc - optind != 1 || !binary)
+    afdo_usage ();
+
+  return profile_afdo (argv[optind], binary, output_file, addr2line, nm);
+}
+
 /* Print a usage message and exit.  If ERROR_P is nonzero, this is an error,
    otherwise the output of --help.  */
 
@@ -514,6 +1316,8 @@ print_usage (int error_p)
   print_merge_usage_message (error_p);
   print_rewrite_usage_message (error_p);
   print_overlap_usage_message (error_p);
+  print_pack_usage_message (error_p);
+  print_afdo_usage_message (error_p);
   fnotice (file, "\nFor bug reporting instructions, please see:\n%s.\n",
            bug_report_url);
   exit (status);
@@ -605,6 +1409,10 @@ main (int argc, char **argv)
     return do_rewrite (argc - optind, argv + optind);
   else if (!strcmp (sub_command, "overlap"))
     return do_overlap (argc - optind, argv + optind);
+  else if (!strcmp (sub_command, "pack"))
+    return do_pack (argc - optind, argv + optind);
+  else if (!strcmp (sub_command, "afdo"))
+    return do_afdo (argc - optind, argv + optind);
 
   print_usage (true);
 }
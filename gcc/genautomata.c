@@ -239,6 +239,7 @@ static arc_t next_out_arc              (arc_t);
 #define NDFA_OPTION "-ndfa"
 #define COLLAPSE_OPTION "-collapse-ndfa"
 #define NO_COMB_OPTION "-no-comb-vect"
+#define COMPACT_COMB_OPTION "-compact-comb-vect"
 #define PROGRESS_OPTION "-progress"
 
 /* The following flags are set up by function `initiate_automaton_gen'.  */
@@ -257,6 +258,11 @@ static int no_minimization_flag;
 /* Do not try to generate a comb vector (`-no-comb-vect').  */
 static int no_comb_flag;
 
+/* Output the comb and check vectors of a transition table as one
+   vector of pairs, so that a transition touches a single cache line
+   instead of two (`-compact-comb-vect').  */
+static int compact_comb_flag;
+
 /* Value of this variable is number of automata being generated.  The
    actual number of automata may be less this value if there is not
    sufficient number of units.  This value is defined by argument of
@@ -1534,6 +1540,8 @@ gen_automata_option (md_rtx_info *info)
     collapse_flag = 1;
   else if (strcmp (option, NO_COMB_OPTION + 1) == 0)
     no_comb_flag = 1;
+  else if (strcmp (option, COMPACT_COMB_OPTION + 1) == 0)
+    compact_comb_flag = 1;
   else if (strcmp (option, PROGRESS_OPTION + 1) == 0)
     progress_flag = 1;
   else
@@ -6944,6 +6952,36 @@ output_vect (vla_hwint_t vect)
       }
 }
 
+/* The function outputs all initialization values of vectors VECT1 and
+   VECT2, which have the same length, as a vector of pairs.  */
+static void
+output_vect_pairs (vla_hwint_t vect1, vla_hwint_t vect2)
+{
+  int els_on_line;
+  size_t vect_length = vect1.length ();
+  size_t i;
+
+  gcc_assert (vect2.length () == vect_length);
+  els_on_line = 1;
+  if (vect_length == 0)
+    fputs ("{0, 0} /* This is dummy el because the vect is empty */",
+	   output_file);
+  else
+    for (i = 0; i < vect_length; i++)
+      {
+	fprintf (output_file, "{%5ld, %5ld}", (long) vect1[i],
+		 (long) vect2[i]);
+	if (els_on_line == 5)
+	  {
+	    els_on_line = 0;
+	    fputs (",\n", output_file);
+	  }
+	else if (i < vect_length-1)
+	  fputs (", ", output_file);
+	els_on_line++;
+      }
+}
+
 /* The following is name of the structure which represents DFA(s) for
    PHR.  */
 #define CHIP_NAME "DFA_chip"
@@ -7283,6 +7321,31 @@ output_state_ainsn_table (state_ainsn_table_t tab, const char *table_name,
       output_vect (tab->full_vect);
       fprintf (output_file, "};\n\n");
     }
+  else if (compact_comb_flag)
+    {
+      fprintf (output_file,
+	       "/* Comb vector for %s with the check vector interleaved.  */\n",
+	       table_name);
+      fprintf (output_file, "static const ");
+      output_range_type (output_file,
+			 MIN (tab->min_comb_vect_el_value, 0),
+			 MAX (tab->max_comb_vect_el_value,
+			      tab->automaton->achieved_states_num));
+      fprintf (output_file, " ");
+      (*output_comb_vect_name_func) (output_file, tab->automaton);
+      fprintf (output_file, "[][2] = {\n");
+      output_vect_pairs (tab->comb_vect, tab->check_vect);
+      fprintf (output_file, "};\n\n");
+      fprintf (output_file, "/* Base vector for %s.  */\n", table_name);
+      fprintf (output_file, "static const ");
+      output_range_type (output_file, tab->min_base_vect_el_value,
+                         tab->max_base_vect_el_value);
+      fprintf (output_file, " ");
+      (*output_base_vect_name_func) (output_file, tab->automaton);
+      fprintf (output_file, "[] = {\n");
+      output_vect (tab->base_vect);
+      fprintf (output_file, "};\n\n");
+    }
   else
     {
       fprintf (output_file, "/* Comb vector for %s.  */\n", table_name);
@@ -8033,9 +8096,18 @@ output_automata_list_transition_code (automata_list_el_t automata_list)
 	output_translate_vect_name (output_file, el->automaton);
 	fprintf (output_file, " [%s];\n", INTERNAL_INSN_CODE_NAME);
 	fprintf (output_file, "        if (");
-	output_trans_check_vect_name (output_file, el->automaton);
-	fprintf (output_file, " [%s] != %s->",
-		 TEMPORARY_VARIABLE_NAME, CHIP_PARAMETER_NAME);
+	if (compact_comb_flag)
+	  {
+	    output_trans_comb_vect_name (output_file, el->automaton);
+	    fprintf (output_file, " [%s][1] != %s->",
+		     TEMPORARY_VARIABLE_NAME, CHIP_PARAMETER_NAME);
+	  }
+	else
+	  {
+	    output_trans_check_vect_name (output_file, el->automaton);
+	    fprintf (output_file, " [%s] != %s->",
+		     TEMPORARY_VARIABLE_NAME, CHIP_PARAMETER_NAME);
+	  }
 	output_chip_member_name (output_file, el->automaton);
 	fprintf (output_file, ")\n");
 	fprintf (output_file, "          return %s (%s, %s);\n",
@@ -8052,7 +8124,8 @@ output_automata_list_transition_code (automata_list_el_t automata_list)
 	  }
 	fprintf (output_file, " = ");
 	output_trans_comb_vect_name (output_file, el->automaton);
-	fprintf (output_file, " [%s];\n", TEMPORARY_VARIABLE_NAME);
+	fprintf (output_file, (compact_comb_flag ? " [%s][0];\n" : " [%s];\n"),
+		 TEMPORARY_VARIABLE_NAME);
       }
     else
       {
@@ -9259,6 +9332,10 @@ parse_automata_opt (const char *str)
     ndfa_flag = 1;
   else if (strcmp (str, COLLAPSE_OPTION) == 0)
     collapse_flag = 1;
+  else if (strcmp (str, NO_COMB_OPTION) == 0)
+    no_comb_flag = 1;
+  else if (strcmp (str, COMPACT_COMB_OPTION) == 0)
+    compact_comb_flag = 1;
   else if (strcmp (str, PROGRESS_OPTION) == 0)
     progress_flag = 1;
   else if (strcmp (str, "-split") == 0)
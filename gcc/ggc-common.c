@@ -308,6 +308,10 @@ struct traversal_state
   size_t count;
   struct ptr_data **ptrs;
   size_t ptrs_i;
+  void *preferred_base;
+  /* The offsets from the start of the PCH area of the pointers in the
+     objects written out, so that they can be relocated on restore.  */
+  vec<size_t> reloc_offs;
 };
 
 /* Callbacks for htab_traverse.  */
@@ -345,13 +349,23 @@ compare_ptr_data (const void *p1_p, const void *p2_p)
 	  - ((size_t)p1->new_addr < (size_t)p2->new_addr));
 }
 
+/* Callback for qsort.  */
+
+static int
+compare_size_t (const void *p1_p, const void *p2_p)
+{
+  size_t p1 = *(const size_t *)p1_p;
+  size_t p2 = *(const size_t *)p2_p;
+  return (p1 > p2) - (p1 < p2);
+}
+
 /* Callbacks for note_ptr_fn.  */
 
 static void
 relocate_ptrs (void *ptr_p, void *state_p)
 {
   void **ptr = (void **)ptr_p;
-  struct traversal_state *state ATTRIBUTE_UNUSED
+  struct traversal_state *state
     = (struct traversal_state *)state_p;
   struct ptr_data *result;
 
@@ -362,6 +376,16 @@ relocate_ptrs (void *ptr_p, void *state_p)
     saving_htab->find_with_hash (*ptr, POINTER_HASH (*ptr));
   gcc_assert (result);
   *ptr = result->new_addr;
+
+  /* Record where the pointer ends up in the PCH area, unless it is a
+     temporary copy made by a reorder function to compare the new
+     addresses.  */
+  struct ptr_data *obj = state->ptrs[state->ptrs_i];
+  size_t off = (char *) ptr_p - (char *) obj->obj;
+  if ((char *) ptr_p >= (char *) obj->obj
+      && off + sizeof (void *) <= obj->size)
+    state->reloc_offs.safe_push ((char *) obj->new_addr + off
+				 - (char *) state->preferred_base);
 }
 
 /* Write out, after relocation, the pointers in TAB.  */
@@ -396,6 +420,84 @@ write_pch_globals (const struct ggc_root_tab * const *tab,
 	}
 }
 
+/* Write out the offsets of the pointers in the PCH area recorded by
+   relocate_ptrs, as the uleb128 encoded differences between consecutive
+   offsets preceded by the size of the encoding.  */
+
+static void
+write_pch_relocs (struct traversal_state *state)
+{
+  vec<unsigned char> buf = vNULL;
+  size_t prev = 0;
+
+  state->reloc_offs.qsort (compare_size_t);
+  for (unsigned i = 0; i < state->reloc_offs.length (); i++)
+    {
+      size_t delta = state->reloc_offs[i] - prev;
+      prev = state->reloc_offs[i];
+      do
+	{
+	  unsigned char byte = delta & 0x7f;
+	  delta >>= 7;
+	  if (delta)
+	    byte |= 0x80;
+	  buf.safe_push (byte);
+	}
+      while (delta);
+    }
+
+  size_t len = buf.length ();
+  if (fwrite (&len, sizeof (len), 1, state->f) != 1
+      || (len && fwrite (buf.address (), len, 1, state->f) != 1))
+    fatal_error (input_location, "cannot write PCH file: %m");
+  buf.release ();
+  state->reloc_offs.release ();
+}
+
+/* Read the offsets written by write_pch_relocs from F and add BIAS to
+   the pointers they designate in the PCH area starting at BASE.  */
+
+static void
+read_pch_relocs (FILE *f, char *base, uintptr_t bias)
+{
+  size_t len;
+  if (fread (&len, sizeof (len), 1, f) != 1)
+    fatal_error (input_location, "cannot read PCH file: %m");
+
+  if (bias == 0)
+    {
+      if (fseek (f, len, SEEK_CUR) != 0)
+	fatal_error (input_location, "cannot read PCH file: %m");
+      return;
+    }
+
+  unsigned char buf[4096];
+  size_t off = 0, delta = 0;
+  unsigned shift = 0;
+  while (len)
+    {
+      size_t n = MIN (len, sizeof (buf));
+      if (fread (buf, n, 1, f) != 1)
+	fatal_error (input_location, "cannot read PCH file: %m");
+      len -= n;
+      for (size_t i = 0; i < n; i++)
+	{
+	  delta |= (size_t) (buf[i] & 0x7f) << shift;
+	  shift += 7;
+	  if (buf[i] & 0x80)
+	    continue;
+	  off += delta;
+	  delta = 0;
+	  shift = 0;
+
+	  uintptr_t p;
+	  memcpy (&p, base + off, sizeof (p));
+	  p += bias;
+	  memcpy (base + off, &p, sizeof (p));
+	}
+    }
+}
+
 /* Hold the information we need to mmap the file back in.  */
 
 struct mmap_info
@@ -448,6 +550,8 @@ gt_pch_save (FILE *f)
 
   state.ptrs = XNEWVEC (struct ptr_data *, state.count);
   state.ptrs_i = 0;
+  state.preferred_base = mmi.preferred_base;
+  state.reloc_offs = vNULL;
 
   saving_htab->traverse <traversal_state *, ggc_call_alloc> (&state);
   timevar_pop (TV_PCH_PTR_REALLOC);
@@ -492,6 +596,7 @@ gt_pch_save (FILE *f)
   /* Actually write out the objects.  */
   for (i = 0; i < state.count; i++)
     {
+      state.ptrs_i = i;
       if (this_object_size < state.ptrs[i]->size)
 	{
 	  this_object_size = state.ptrs[i]->size;
@@ -573,6 +678,7 @@ gt_pch_save (FILE *f)
 #endif
 
   ggc_pch_finish (state.d, state.f);
+  write_pch_relocs (&state);
   gt_pch_fixup_stringpool ();
 
   XDELETE (state.ptrs);
@@ -616,9 +722,14 @@ gt_pch_restore (FILE *f)
   if (fread (&mmi, sizeof (mmi), 1, f) != 1)
     fatal_error (input_location, "cannot read PCH file: %m");
 
+  void *orig_base = mmi.preferred_base;
   result = host_hooks.gt_pch_use_address (mmi.preferred_base, mmi.size,
 					  fileno (f), mmi.offset);
-  if (result < 0)
+  /* The data can be relocated to wherever the memory was allocated,
+     unless it was laid out for a null base, where null pointers could not
+     be told from pointers to the start of the area.  */
+  if (result < 0
+      || (mmi.preferred_base != orig_base && orig_base == NULL))
     fatal_error (input_location, "had to relocate PCH");
   if (result == 0)
     {
@@ -631,6 +742,27 @@ gt_pch_restore (FILE *f)
 
   ggc_pch_read (f, mmi.preferred_base);
 
+  uintptr_t bias = (uintptr_t) mmi.preferred_base - (uintptr_t) orig_base;
+  read_pch_relocs (f, (char *) mmi.preferred_base, bias);
+  if (bias)
+    {
+      /* Relocate the global pointers into the PCH area, too.  */
+      for (rt = gt_ggc_rtab; *rt; rt++)
+	for (rti = *rt; rti->base != NULL; rti++)
+	  for (i = 0; i < rti->nelt; i++)
+	    {
+	      char *addr = (char *)rti->base + rti->stride * i;
+	      uintptr_t p;
+	      memcpy (&p, addr, sizeof (p));
+	      if (p >= (uintptr_t) orig_base
+		  && p < (uintptr_t) orig_base + mmi.size)
+		{
+		  p += bias;
+		  memcpy (addr, &p, sizeof (p));
+		}
+	    }
+    }
+
   gt_pch_restore_stringpool ();
 }
 
@@ -652,7 +784,7 @@ default_gt_pch_get_address (size_t size ATTRIBUTE_UNUSED,
    of the PCH file would be required.  */
 
 int
-default_gt_pch_use_address (void *base, size_t size, int fd ATTRIBUTE_UNUSED,
+default_gt_pch_use_address (void *&base, size_t size, int fd ATTRIBUTE_UNUSED,
 			    size_t offset ATTRIBUTE_UNUSED)
 {
   void *addr = xmalloc (size);
@@ -691,14 +823,15 @@ mmap_gt_pch_get_address (size_t size, int fd)
 
 /* Default version of HOST_HOOKS_GT_PCH_USE_ADDRESS when mmap is present.
    Map SIZE bytes of FD+OFFSET at BASE.  Return 1 if we succeeded at
-   mapping the data at BASE, -1 if we couldn't.
+   mapping the data, setting BASE to where it was mapped, -1 if we
+   couldn't.
 
    This version assumes that the kernel honors the START operand of mmap
    even without MAP_FIXED if START through START+SIZE are not currently
-   mapped with something.  */
+   mapped with something; if it does not, the data is relocated.  */
 
 int
-mmap_gt_pch_use_address (void *base, size_t size, int fd, size_t offset)
+mmap_gt_pch_use_address (void *&base, size_t size, int fd, size_t offset)
 {
   void *addr;
 
@@ -710,8 +843,11 @@ mmap_gt_pch_use_address (void *base, size_t size, int fd, size_t offset)
 
   addr = mmap ((caddr_t) base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
 	       fd, offset);
+  if (addr == (void *) MAP_FAILED)
+    return -1;
 
-  return addr == base ? 1 : -1;
+  base = addr;
+  return 1;
 }
 #endif /* HAVE_MMAP_FILE */
 
@@ -1008,19 +1144,35 @@ ggc_prune_overhead_list (void)
       }
 }
 
-/* Print memory used by heap if this info is available.  */
-
-void
-report_heap_memory_use ()
-{
 #if defined(HAVE_MALLINFO) || defined(HAVE_MALLINFO2)
 #ifdef HAVE_MALLINFO2
   #define MALLINFO_FN mallinfo2
 #else
   #define MALLINFO_FN mallinfo
 #endif
+#endif
+
+/* Return the memory used by heap, or 0 if this info is not
+   available.  */
+
+size_t
+heap_memory_use ()
+{
+#ifdef MALLINFO_FN
+  return MALLINFO_FN ().arena;
+#else
+  return 0;
+#endif
+}
+
+/* Print memory used by heap if this info is available.  */
+
+void
+report_heap_memory_use ()
+{
+#ifdef MALLINFO_FN
   if (!quiet_flag)
     fprintf (stderr, " {heap " PRsa (0) "}",
-	     SIZE_AMOUNT (MALLINFO_FN ().arena));
+	     SIZE_AMOUNT (heap_memory_use ()));
 #endif
 }
@@ -395,6 +395,11 @@ static struct ggc_globals
   /* Bytes currently allocated at the end of the last collection.  */
   size_t allocated_last_gc;
 
+  /* Factor by which ggc-min-expand is scaled.  It doubles after each
+     collection that reclaims little, since most of the heap then consists
+     of long-lived objects that are marked again for nothing.  */
+  unsigned expand_scale;
+
   /* Total amount of memory mapped.  */
   size_t bytes_mapped;
 
@@ -495,6 +500,17 @@ static struct ggc_globals
 
 static bool in_gc = false;
 
+#ifdef ENABLE_GC_CHECKING
+/* The collector keeps all of its state in G without any locking, so only
+   the thread that initialized it may allocate, free or collect.  Catch
+   helper threads that reach the collector before they can corrupt the
+   free lists or race with marking.  */
+static thread_local bool ggc_owner_thread_p;
+#define ggc_check_owner_thread() gcc_assert (ggc_owner_thread_p)
+#else
+#define ggc_check_owner_thread() ((void) 0)
+#endif
+
 /* The size in bytes required to maintain a bitmap for the objects
    on a page-entry.  */
 #define BITMAP_SIZE(Num_objects) \
@@ -627,8 +643,22 @@ lookup_page_table_entry (const void *p)
 #else
   page_table table = G.lookup;
   uintptr_t high_bits = (uintptr_t) p & ~ (uintptr_t) 0xffffffff;
-  while (table->high_bits != high_bits)
-    table = table->next;
+  if (table->high_bits != high_bits)
+    {
+      page_table prev;
+      do
+	{
+	  prev = table;
+	  table = table->next;
+	}
+      while (table->high_bits != high_bits);
+
+      /* Objects looked up one after the other, as when marking, tend
+	 to be in the same region, so move its table to the front.  */
+      prev->next = table->next;
+      table->next = G.lookup;
+      G.lookup = table;
+    }
   base = &table->table[0];
 #endif
 
@@ -1280,6 +1310,7 @@ ggc_internal_alloc (size_t size, void (*f)(void *), size_t s, size_t n
   struct page_entry *entry;
   void *result;
 
+  ggc_check_owner_thread ();
   ggc_round_alloc_size_1 (size, &order, &object_size);
 
   /* If there are non-full pages for this size allocation, they are at
@@ -1606,6 +1637,8 @@ ggc_free (void *p)
   if (in_gc)
     return;
 
+  ggc_check_owner_thread ();
+
   page_entry *pe = lookup_page_table_entry (p);
   size_t order = pe->order;
   size_t size = OBJECT_SIZE (order);
@@ -1725,6 +1758,12 @@ init_ggc (void)
   static bool init_p = false;
   unsigned order;
 
+#ifdef ENABLE_GC_CHECKING
+  /* Each compilation claims the collector for the thread running it;
+     libgccjit may run successive compilations on different threads.  */
+  ggc_owner_thread_p = true;
+#endif
+
   if (init_p)
     return;
   init_p = true;
@@ -2180,6 +2219,8 @@ validate_free_objects (void)
 void
 ggc_collect (void)
 {
+  ggc_check_owner_thread ();
+
   /* Avoid frequent unnecessary work by skipping collection if the
      total allocations haven't expanded much since the last
      collection.  */
@@ -2189,7 +2230,8 @@ ggc_collect (void)
   /* It is also good time to get memory block pool into limits.  */
   memory_block_pool::trim ();
 
-  float min_expand = allocated_last_gc * param_ggc_min_expand / 100;
+  float min_expand = (allocated_last_gc * param_ggc_min_expand / 100
+		      * MAX (G.expand_scale, 1));
   if (G.allocated < allocated_last_gc + min_expand && !ggc_force_collect)
     return;
 
@@ -2230,6 +2272,15 @@ ggc_collect (void)
   in_gc = false;
   G.allocated_last_gc = G.allocated;
 
+  /* Collect less often while collections keep finding little garbage,
+     and go back to the normal rate as soon as one pays off.  */
+  if (allocated - G.allocated
+      < (double) allocated * param_ggc_min_reclaim / 100)
+    G.expand_scale = MIN (MAX (G.expand_scale, 1) * 2,
+			  (unsigned) MAX (param_ggc_max_expand_scale, 1));
+  else
+    G.expand_scale = 1;
+
   invoke_plugin_callbacks (PLUGIN_GGC_END, NULL);
 
   timevar_pop (TV_GC);
@@ -288,6 +288,9 @@ extern void stringpool_statistics (void);
 /* Heuristics.  */
 extern void init_ggc_heuristics (void);
 
+/* Return current heap memory use, or 0 if it is not known.  */
+extern size_t heap_memory_use (void);
+
 /* Report current heap memory use to stderr.  */
 extern void report_heap_memory_use (void);
 
@@ -15555,9 +15555,11 @@ gimplify_function_tree (tree fndecl)
   DECL_SAVED_TREE (fndecl) = NULL_TREE;
   cfun->curr_properties |= PROP_gimple_any;
 
-  pop_cfun ();
-
+  /* Dump while FNDECL is the current function, so that dumps restricted
+     to some functions apply to it.  */
   dump_function (TDI_gimple, fndecl);
+
+  pop_cfun ();
 }
 
 /* Return a dummy expression of type TYPE in order to keep going after an
@@ -41,14 +41,12 @@ along with GCC; see the file COPYING3.  If not see
 
 
 /* get_schedule_for_node_st - Improve schedule for the schedule node.
-   Only Simple loop tiling is considered.  */
+   Only Simple loop tiling is considered, with the tile size that USER
+   points to.  */
 
 static __isl_give isl_schedule_node *
 get_schedule_for_node_st (__isl_take isl_schedule_node *node, void *user)
 {
-  if (user)
-    return node;
-
   if (isl_schedule_node_get_type (node) != isl_schedule_node_band
       || isl_schedule_node_n_children (node) != 1)
     return node;
@@ -63,7 +61,7 @@ get_schedule_for_node_st (__isl_take isl_schedule_node *node, void *user)
   if (type != isl_schedule_node_leaf)
     return node;
 
-  long tile_size = param_loop_block_tile_size;
+  long tile_size = *static_cast<long *> (user);
   if (dims <= 1
       || tile_size == 0
       || !isl_schedule_node_band_get_permutable (node))
@@ -92,6 +90,54 @@ get_schedule_for_node_st (__isl_take isl_schedule_node *node, void *user)
   return node;
 }
 
+/* Return the size of the tiles for the loops of SCOP.  Unless it is given
+   by --param loop-block-tile-size, use the largest size for which a square
+   tile of each array that SCOP accesses fits in the L1 data cache.  */
+
+static long
+scop_tile_size (scop_p scop)
+{
+  if (global_options_set.x_param_loop_block_tile_size)
+    return param_loop_block_tile_size;
+
+  auto_vec<tree> bases;
+  unsigned HOST_WIDE_INT footprint = 0;
+  dr_info *dri;
+  int i;
+  FOR_EACH_VEC_ELT (scop->drs, i, dri)
+    {
+      tree base = DR_BASE_OBJECT (dri->dr);
+      tree size = TYPE_SIZE_UNIT (TREE_TYPE (DR_REF (dri->dr)));
+      if (!tree_fits_uhwi_p (size))
+	return param_loop_block_tile_size;
+
+      unsigned j;
+      tree b;
+      FOR_EACH_VEC_ELT (bases, j, b)
+	if (operand_equal_p (b, base, 0))
+	  break;
+      if (j < bases.length ())
+	continue;
+      bases.safe_push (base);
+      footprint += tree_to_uhwi (size);
+    }
+
+  if (footprint == 0)
+    return param_loop_block_tile_size;
+
+  unsigned HOST_WIDE_INT cache = param_l1_cache_size * 1024;
+  long tile_size = 8;
+  while (tile_size < 256
+	 && (tile_size + 1) * (tile_size + 1) * footprint <= cache)
+    tile_size++;
+
+  if (dump_file && dump_flags)
+    fprintf (dump_file, "tile size %ld for %u arrays of "
+	     HOST_WIDE_INT_PRINT_UNSIGNED " bytes per element\n",
+	     tile_size, bases.length (), footprint);
+  return tile_size;
+}
+
 static isl_union_set *
 scop_get_domains (scop_p scop)
 {
@@ -149,9 +195,11 @@ optimize_isl (scop_p scop)
   isl_options_set_ast_build_atomic_upper_bound (scop->isl_context, 1);
 
   scop->transformed_schedule = isl_schedule_constraints_compute_schedule (sc);
+  long tile_size = scop_tile_size (scop);
   scop->transformed_schedule =
     isl_schedule_map_schedule_node_bottom_up (scop->transformed_schedule,
-					      get_schedule_for_node_st, NULL);
+					      get_schedule_for_node_st,
+					      &tile_size);
 
   isl_options_set_on_error (scop->isl_context, old_err);
   isl_ctx_reset_operations (scop->isl_context);
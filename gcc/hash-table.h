@@ -971,7 +971,7 @@ hash_table<Descriptor, Lazy, Allocator>
   m_searches++;
   value_type *first_deleted_slot = NULL;
   hashval_t index = hash_table_mod1 (hash, m_size_prime_index);
-  hashval_t hash2 = hash_table_mod2 (hash, m_size_prime_index);
+  hashval_t hash2;
   value_type *entry = &m_entries[index];
   size_t size = m_size;
   if (is_empty (*entry))
@@ -981,6 +981,9 @@ hash_table<Descriptor, Lazy, Allocator>
   else if (Descriptor::equal (*entry, comparable))
     return &m_entries[index];
 
+  /* Most searches end at the first slot; only compute the probe step
+     once it is needed.  */
+  hash2 = hash_table_mod2 (hash, m_size_prime_index);
   for (;;)
     {
       m_collisions++;
@@ -31,9 +31,11 @@ struct host_hooks
 
   /* ADDR is an address returned by gt_pch_get_address.  Attempt to allocate
      SIZE bytes at the same address and load it with the data from FD at
-     OFFSET.  Return -1 if we couldn't allocate memory at ADDR, return 0
-     if the memory is allocated but the data not loaded, return 1 if done.  */
-  int (*gt_pch_use_address) (void *addr, size_t size, int fd, size_t offset);
+     OFFSET.  Return -1 if we couldn't allocate memory, return 0 if the
+     memory is allocated but the data not loaded, return 1 if done.  If the
+     memory could only be allocated at a different address, the hook may
+     set ADDR to it; the PCH data is then relocated by the caller.  */
+  int (*gt_pch_use_address) (void *&addr, size_t size, int fd, size_t offset);
 
   /*  Return the alignment required for allocating virtual memory. Usually
       this is the same as pagesize.  */
@@ -92,28 +92,15 @@ public:
      means we've read no line so far.  */
   size_t line_num;
 
-  /* This is the total number of lines of the current file.  At the
-     moment, we try to get this information from the line map
-     subsystem.  Note that this is just a hint.  When using the C++
-     front-end, this hint is correct because the input file is then
-     completely tokenized before parsing starts; so the line map knows
-     the number of lines before compilation really starts.  For e.g,
-     the C front-end, it can happen that we start emitting diagnostics
-     before the line map has seen the end of the file.  */
-  size_t total_lines;
-
   /* Could this file be missing a trailing newline on its final line?
      Initially true (to cope with empty files), set to true/false
      as each line is read.  */
   bool missing_trailing_newline;
 
-  /* This is a record of the beginning and end of the lines we've seen
-     while reading the file.  This is useful to avoid walking the data
-     from the beginning when we are asked to read a line that is
-     before LINE_START_IDX above.  Note that the maximum size of this
-     record is fcache_line_record_size, so that the memory consumption
-     doesn't explode.  We thus scale total_lines down to
-     fcache_line_record_size.  */
+  /* This is a record of the beginning and end of every line we've
+     seen while reading the file, indexed by line number minus one, so
+     that a line before LINE_START_IDX above can be found without
+     walking the data again.  Its length is always LINE_NUM.  */
   vec<line_info, va_heap> line_record;
 
   fcache ();
@@ -134,9 +121,8 @@ class line_maps *line_table;
 class line_maps *saved_line_table;
 
 static fcache *fcache_tab;
-static const size_t fcache_tab_size = 16;
+static const size_t fcache_tab_size = 64;
 static const size_t fcache_buffer_size = 4 * 1024;
-static const size_t fcache_line_record_size = 100;
 
 /* Expand the source location LOC into a human readable location.  If
    LOC resolves to a builtin location, the file name of the readable
@@ -250,25 +236,6 @@ diagnostic_file_cache_fini (void)
     }
 }
 
-/* Return the total lines number that have been read so far by the
-   line map (in the preprocessor) so far.  For languages like C++ that
-   entirely preprocess the input file before starting to parse, this
-   equals the actual number of lines of the file.  */
-
-static size_t
-total_lines_num (const char *file_path)
-{
-  size_t r = 0;
-  location_t l = 0;
-  if (linemap_get_file_highest_location (line_table, file_path, &l))
-    {
-      gcc_assert (l >= RESERVED_LOCATION_COUNT);
-      expanded_location xloc = expand_location (l);
-      r = xloc.line;
-    }
-  return r;
-}
-
 /* Lookup the cache used for the content of a given file accessed by
    caret diagnostic.  Return the found cached file, or NULL if no
    cached file was found.  */
@@ -286,7 +253,8 @@ lookup_file_in_cache_tab (const char *file_path)
   for (unsigned i = 0; i < fcache_tab_size; ++i)
     {
       fcache *c = &fcache_tab[i];
-      if (c->file_path && !strcmp (c->file_path, file_path))
+      if (c->file_path
+	  && (c->file_path == file_path || !strcmp (c->file_path, file_path)))
 	{
 	  ++c->use_count;
 	  r = c;
@@ -322,7 +290,6 @@ diagnostics_file_cache_forcibly_evict_file (const char *file_path)
   r->line_num = 0;
   r->line_record.truncate (0);
   r->use_count = 0;
-  r->total_lines = 0;
   r->missing_trailing_newline = true;
 }
 
@@ -391,7 +358,6 @@ add_file_to_cache_tab (const char *file_path)
   /* Ensure that this cache entry doesn't get evicted next time
      add_file_to_cache_tab is called.  */
   r->use_count = ++highest_use_count;
-  r->total_lines = total_lines_num (file_path);
   r->missing_trailing_newline = true;
 
   return r;
@@ -417,7 +383,7 @@ lookup_or_add_file_to_cache_tab (const char *file_path)
 fcache::fcache ()
 : use_count (0), file_path (NULL), fp (NULL), data (0),
   size (0), nb_read (0), line_start_idx (0), line_num (0),
-  total_lines (0), missing_trailing_newline (true)
+  missing_trailing_newline (true)
 {
   line_record.create (0);
 }
@@ -585,37 +551,11 @@ get_next_line (fcache *c, char **line, ssize_t *line_len)
 
   ++c->line_num;
 
-  /* Before we update our line record, make sure the hint about the
-     total number of lines of the file is correct.  If it's not, then
-     we give up recording line boundaries from now on.  */
-  bool update_line_record = true;
-  if (c->line_num > c->total_lines)
-    update_line_record = false;
-
-    /* Now update our line record so that re-reading lines from the
-     before c->line_start_idx is faster.  */
-  if (update_line_record
-      && c->line_record.length () < fcache_line_record_size)
-    {
-      /* If the file lines fits in the line record, we just record all
-	 its lines ...*/
-      if (c->total_lines <= fcache_line_record_size
-	  && c->line_num > c->line_record.length ())
-	c->line_record.safe_push (fcache::line_info (c->line_num,
-						 c->line_start_idx,
-						 line_end - c->data));
-      else if (c->total_lines > fcache_line_record_size)
-	{
-	  /* ... otherwise, we just scale total_lines down to
-	     (fcache_line_record_size lines.  */
-	  size_t n = (c->line_num * fcache_line_record_size) / c->total_lines;
-	  if (c->line_record.length () == 0
-	      || n >= c->line_record.length ())
-	    c->line_record.safe_push (fcache::line_info (c->line_num,
-						     c->line_start_idx,
-						     line_end - c->data));
-	}
-    }
+  /* Now update our line record so that re-reading this line later
+     doesn't need to walk the data again.  */
+  c->line_record.safe_push (fcache::line_info (c->line_num,
+					       c->line_start_idx,
+					       line_end - c->data));
 
   /* Update c->line_start_idx so that it points to the next line to be
      read.  */
@@ -664,69 +604,13 @@ read_line_num (fcache *c, size_t line_num,
 
   if (line_num <= c->line_num)
     {
-      /* We've been asked to read lines that are before c->line_num.
-	 So lets use our line record (if it's not empty) to try to
-	 avoid re-reading the file from the beginning again.  */
-
-      if (c->line_record.is_empty ())
-	{
-	  c->line_start_idx = 0;
-	  c->line_num = 0;
-	}
-      else
-	{
-	  fcache::line_info *i = NULL;
-	  if (c->total_lines <= fcache_line_record_size)
-	    {
-	      /* In languages where the input file is not totally
-		 preprocessed up front, the c->total_lines hint
-		 can be smaller than the number of lines of the
-		 file.  In that case, only the first
-		 c->total_lines have been recorded.
-
-		 Otherwise, the first c->total_lines we've read have
-		 their start/end recorded here.  */
-	      i = (line_num <= c->total_lines)
-		? &c->line_record[line_num - 1]
-		: &c->line_record[c->total_lines - 1];
-	      gcc_assert (i->line_num <= line_num);
-	    }
-	  else
-	    {
-	      /*  So the file had more lines than our line record
-		  size.  Thus the number of lines we've recorded has
-		  been scaled down to fcache_line_reacord_size.  Let's
-		  pick the start/end of the recorded line that is
-		  closest to line_num.  */
-	      size_t n = (line_num <= c->total_lines)
-		? line_num * fcache_line_record_size / c->total_lines
-		: c ->line_record.length () - 1;
-	      if (n < c->line_record.length ())
-		{
-		  i = &c->line_record[n];
-		  gcc_assert (i->line_num <= line_num);
-		}
-	    }
-
-	  if (i && i->line_num == line_num)
-	    {
-	      /* We have the start/end of the line.  */
-	      *line = c->data + i->start_pos;
-	      *line_len = i->end_pos - i->start_pos;
-	      return true;
-	    }
-
-	  if (i)
-	    {
-	      c->line_start_idx = i->start_pos;
-	      c->line_num = i->line_num - 1;
-	    }
-	  else
-	    {
-	      c->line_start_idx = 0;
-	      c->line_num = 0;
-	    }
-	}
+      /* We've been asked to read a line that we've already seen, so
+	 our line record has its start/end.  */
+      fcache::line_info *i = &c->line_record[line_num - 1];
+      gcc_assert (i->line_num == line_num);
+      *line = c->data + i->start_pos;
+      *line_len = i->end_pos - i->start_pos;
+      return true;
     }
 
   /*  Let's walk from line c->line_num up to line_num - 1, without
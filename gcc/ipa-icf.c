@@ -308,6 +308,59 @@ sem_function::get_hash (void)
   return m_hash;
 }
 
+/* Hash of the properties that equals_wpa, if IN_WPA, or equals require
+   to be identical.  Types are represented by their modes, which
+   types_compatible_p requires to match.  */
+
+hashval_t
+sem_function::get_equals_key (bool in_wpa)
+{
+  inchash::hash hstate;
+
+  if (!in_wpa)
+    {
+      hstate.add_int (bb_sorted.length ());
+      hstate.add_int (edge_count);
+      hstate.add_int (cfg_checksum);
+      return hstate.end ();
+    }
+
+  cgraph_node *cnode = get_node ();
+  hstate.add_flag (cnode->thunk);
+  hstate.add_flag (cnode->former_thunk_p ());
+  hstate.add_flag (DECL_NO_INSTRUMENT_FUNCTION_ENTRY_EXIT (decl));
+  hstate.add_flag (DECL_NO_LIMIT_STACK (decl));
+  hstate.add_flag (DECL_CXX_CONSTRUCTOR_P (decl));
+  hstate.add_flag (DECL_CXX_DESTRUCTOR_P (decl));
+  hstate.commit_flag ();
+  hstate.add_int (flags_from_decl_or_type (decl));
+
+  tree result = TREE_TYPE (TREE_TYPE (decl));
+  hstate.add_int (TREE_CODE (result));
+  hstate.add_int (TYPE_MODE (result));
+  hstate.add_flag (TYPE_RESTRICT (result));
+  hstate.commit_flag ();
+
+  for (tree list = TYPE_ARG_TYPES (TREE_TYPE (decl)); list;
+       list = TREE_CHAIN (list))
+    hstate.add_int (TREE_VALUE (list) ? (int) TYPE_MODE (TREE_VALUE (list))
+		    : -1);
+
+  hash_reference_uses (hstate);
+
+  unsigned ncallees = 0;
+  for (cgraph_edge *e = cnode->callees; e; e = e->next_callee)
+    ncallees++;
+  hstate.add_int (ncallees);
+
+  unsigned nindirect = 0;
+  for (cgraph_edge *e = cnode->indirect_calls; e; e = e->next_callee)
+    nindirect++;
+  hstate.add_int (nindirect);
+
+  return hstate.end ();
+}
+
 /* Compare properties of symbols N1 and N2 that does not affect semantics of
    symbol itself but affects semantics of its references from USED_BY (which
    may be NULL if it is unknown).  If comparison is false, symbols
@@ -434,6 +487,20 @@ sem_item::hash_referenced_symbol_properties (symtab_node *ref,
 }
 
 
+/* Hash the number and the kinds of references of the item.  Both
+   equals_wpa functions compare them one by one.  */
+
+void
+sem_item::hash_reference_uses (inchash::hash &hstate)
+{
+  ipa_ref *ref = NULL;
+
+  hstate.add_int (node->num_references ());
+  for (unsigned i = 0; node->iterate_reference (i, ref); i++)
+    hstate.add_int (ref->use);
+}
+
+
 /* For a given symbol table nodes N1 and N2, we check that FUNCTION_DECLs
    point to a same function. Comparison can be skipped if IGNORED_NODES
    contains these nodes.  ADDRESS indicate if address is taken.  */
@@ -1941,6 +2008,27 @@ sem_variable::get_hash (void)
   return m_hash;
 }
 
+/* Hash of the properties that equals_wpa, if IN_WPA, requires to be
+   identical.  */
+
+hashval_t
+sem_variable::get_equals_key (bool in_wpa)
+{
+  inchash::hash hstate;
+
+  if (!in_wpa)
+    return 0;
+
+  hstate.add_flag (DECL_VIRTUAL_P (decl));
+  hstate.add_flag (DECL_IN_TEXT_SECTION (decl));
+  hstate.commit_flag ();
+  if (DECL_SIZE (decl) && TREE_CODE (DECL_SIZE (decl)) == INTEGER_CST)
+    inchash::add_expr (DECL_SIZE (decl), hstate);
+  hash_reference_uses (hstate);
+
+  return hstate.end ();
+}
+
 /* Merges instance with an ALIAS_ITEM, where alias, thunk or redirection can
    be applied.  */
 
@@ -2719,17 +2807,26 @@ sem_item_optimizer::subdivide_classes_by_equality (bool in_wpa)
 	      auto_vec <sem_item *> new_vector;
 
 	      sem_item *first = c->members[0];
+	      hashval_t first_key = first->get_equals_key (in_wpa);
 	      new_vector.safe_push (first);
 
 	      unsigned class_split_first = (*it)->classes.length ();
 
+	      /* The keys of the first members of the classes split off, so
+		 that an item is only compared with those that it can be
+		 equal to.  Large classes of similar symbols, e.g. template
+		 instances, may otherwise be compared with each other.  */
+	      auto_vec <hashval_t> split_keys;
+
 	      for (unsigned j = 1; j < c->members.length (); j++)
 		{
 		  sem_item *item = c->members[j];
+		  hashval_t key = item->get_equals_key (in_wpa);
 
 		  bool equals
-		    = in_wpa ? first->equals_wpa (item, m_symtab_node_map)
-			     : first->equals (item, m_symtab_node_map);
+		    = key == first_key
+		      && (in_wpa ? first->equals_wpa (item, m_symtab_node_map)
+				 : first->equals (item, m_symtab_node_map));
 
 		  if (equals)
 		    new_vector.safe_push (item);
@@ -2740,6 +2837,9 @@ sem_item_optimizer::subdivide_classes_by_equality (bool in_wpa)
 		      for (unsigned k = class_split_first;
 			   k < (*it)->classes.length (); k++)
 			{
+			  if (split_keys[k - class_split_first] != key)
+			    continue;
+
 			  sem_item *x = (*it)->classes[k]->members[0];
 			  bool equals
 			    = in_wpa ? x->equals_wpa (item, m_symtab_node_map)
@@ -2762,6 +2862,7 @@ sem_item_optimizer::subdivide_classes_by_equality (bool in_wpa)
 			  add_item_to_class (c, item);
 
 			  (*it)->classes.safe_push (c);
+			  split_keys.safe_push (key);
 			}
 		    }
 		}
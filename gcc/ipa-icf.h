@@ -207,6 +207,10 @@ public:
   /* References independent hash function.  */
   virtual hashval_t get_hash (void) = 0;
 
+  /* Hash of the properties that equals_wpa, if IN_WPA, or equals require
+     to be identical.  Items with different keys are never equal.  */
+  virtual hashval_t get_equals_key (bool in_wpa) = 0;
+
   /* Set new hash value of the item.  */
   void set_hash (hashval_t hash);
 
@@ -282,6 +286,9 @@ protected:
 					  inchash::hash &hstate,
 					  bool address);
 
+  /* Hash the number and the kinds of references of the item.  */
+  void hash_reference_uses (inchash::hash &hstate);
+
   /* For a given symbol table nodes N1 and N2, we check that FUNCTION_DECLs
      point to a same function. Comparison can be skipped if IGNORED_NODES
      contains these nodes.  ADDRESS indicate if address is taken.  */
@@ -321,6 +328,7 @@ public:
   virtual bool equals_wpa (sem_item *item,
 			   hash_map <symtab_node *, sem_item *> &ignored_nodes);
   virtual hashval_t get_hash (void);
+  virtual hashval_t get_equals_key (bool in_wpa);
   virtual bool equals (sem_item *item,
 		       hash_map <symtab_node *, sem_item *> &ignored_nodes);
   virtual bool merge (sem_item *alias_item);
@@ -429,6 +437,7 @@ public:
   virtual void init (ipa_icf_gimple::func_checker *);
 
   virtual hashval_t get_hash (void);
+  virtual hashval_t get_equals_key (bool in_wpa);
   virtual bool merge (sem_item *alias_item);
   virtual void dump_to_file (FILE *file);
   virtual bool equals (sem_item *item,
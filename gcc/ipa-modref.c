@@ -85,6 +85,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "ssa-iterators.h"
 #include "stringpool.h"
 #include "tree-ssanames.h"
+#include "tree-eh.h"
 
 namespace {
 
@@ -311,6 +312,8 @@ modref_summary::useful_p (int ecf_flags, bool check_flags)
     return true;
   if (ecf_flags & ECF_PURE)
     return false;
+  if (kills.length ())
+    return true;
   return stores && !stores->every_base;
 }
 
@@ -567,6 +570,12 @@ modref_summary::dump (FILE *out)
 	    dump_eaf_flags (out, arg_flags[i]);
 	  }
     }
+  if (kills.length ())
+    {
+      fprintf (out, "  kills:\n");
+      for (unsigned int i = 0; i < kills.length (); i++)
+	dump_access (&kills[i], out);
+    }
 }
 
 /* Dump summary.  */
@@ -1176,6 +1185,66 @@ analyze_load (gimple *, tree, tree op, void *data)
   return false;
 }
 
+/* Record the store to LHS in the kills of SUMMARY if it writes a known
+   range of memory pointed to by a parameter.  */
+
+static void
+record_kill (modref_summary *summary, tree lhs)
+{
+  if (!record_access_p (lhs))
+    return;
+
+  ao_ref r;
+  ao_ref_init (&r, lhs);
+  modref_access_node a = get_access (&r);
+  if (a.parm_index < 0
+      || !a.parm_offset_known
+      || !known_size_p (a.size)
+      || !known_eq (a.size, a.max_size)
+      || summary->kills.length () >= (unsigned) param_modref_max_accesses)
+    return;
+  if (dump_file)
+    fprintf (dump_file, "   - Recording kill parm=%i\n", a.parm_index);
+  summary->kills.safe_push (a);
+}
+
+/* Collect the kills of SUMMARY: stores to memory pointed to by parameters
+   in the straight-line code starting at the function entry, up to the
+   first statement that may return, throw or call anything.  Such stores
+   happen whenever the function is called, so the caller may treat them
+   like its own stores when looking for dead stores.  */
+
+static void
+analyze_kills (modref_summary *summary)
+{
+  basic_block bb = single_succ (ENTRY_BLOCK_PTR_FOR_FN (cfun));
+  auto_bitmap visited;
+
+  while (bb != EXIT_BLOCK_PTR_FOR_FN (cfun)
+	 && bitmap_set_bit (visited, bb->index))
+    {
+      gimple_stmt_iterator si;
+      for (si = gsi_after_labels (bb); !gsi_end_p (si); gsi_next (&si))
+	{
+	  gimple *stmt = gsi_stmt (si);
+
+	  if (is_gimple_debug (stmt) || gimple_clobber_p (stmt))
+	    continue;
+	  if (is_gimple_call (stmt)
+	      || gimple_code (stmt) == GIMPLE_ASM
+	      || gimple_code (stmt) == GIMPLE_RETURN
+	      || gimple_has_volatile_ops (stmt)
+	      || stmt_could_throw_p (cfun, stmt))
+	    return;
+	  if (gimple_vdef (stmt) && is_gimple_assign (stmt))
+	    record_kill (summary, gimple_assign_lhs (stmt));
+	}
+      if (!single_succ_p (bb))
+	return;
+      bb = single_succ (bb);
+    }
+}
+
 /* Helper for analyze_stmt.  */
 
 static bool
@@ -2015,6 +2084,8 @@ analyze_function (function *f, bool ipa)
     }
 
   analyze_parms (summary, summary_lto, ipa);
+  if (summary)
+    analyze_kills (summary);
 
   int ecf_flags = flags_from_decl_or_type (current_function_decl);
   auto_vec <gimple *, 32> recursive_calls;
@@ -2178,6 +2249,8 @@ modref_summaries::duplicate (cgraph_node *, cgraph_node *dst,
   dst_data->writes_errno = src_data->writes_errno;
   if (src_data->arg_flags.length ())
     dst_data->arg_flags = src_data->arg_flags.copy ();
+  if (src_data->kills.length ())
+    dst_data->kills = src_data->kills.copy ();
 }
 
 /* Called when new clone is inserted to callgraph late.  */
@@ -2738,6 +2811,25 @@ remap_arg_flags (auto_vec <unsigned char> &arg_flags, clone_info *info)
     }
 }
 
+/* Remap parameter indexes of KILLS by MAP and drop the kills of
+   parameters that no longer exist.  */
+
+static void
+remap_kills (vec <modref_access_node> &kills, vec <int> &map)
+{
+  for (unsigned int i = 0; i < kills.length ();)
+    {
+      int idx = kills[i].parm_index;
+      if (idx < (int)map.length () && map[idx] >= 0)
+	{
+	  kills[i].parm_index = map[idx];
+	  i++;
+	}
+      else
+	kills.unordered_remove (i);
+    }
+}
+
 /* If signature changed, update the summary.  */
 
 static void
@@ -2790,6 +2882,8 @@ update_signature (struct cgraph_node *node)
       r->stores->remap_params (&map);
       if (r->arg_flags.length ())
 	remap_arg_flags (r->arg_flags, info);
+      if (r->kills.length ())
+	remap_kills (r->kills, map);
     }
   if (r_lto)
     {
@@ -30,6 +30,9 @@ struct GTY(()) modref_summary
   modref_records *loads;
   modref_records *stores;
   auto_vec<unsigned char> GTY((skip)) arg_flags;
+  /* Stores to memory pointed to by parameters that the function always
+     performs before it can return, throw or call anything.  */
+  auto_vec<modref_access_node> GTY((skip)) kills;
   bool writes_errno;
 
   modref_summary ();
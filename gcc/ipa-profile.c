@@ -885,7 +885,14 @@ ipa_profile (void)
 				   item.target_probability
 				     / (float) REG_BR_PROB_BASE);
 			}
-		      if (item.target_probability < REG_BR_PROB_BASE / 2)
+		      /* Each target that receives a good share of the calls
+			 gets a test of its own, in order of decreasing
+			 probability; whether the cascade pays off in the end
+			 depends on inlining, which removes the speculations
+			 that do not.  */
+		      if (item.target_probability
+			  < (REG_BR_PROB_BASE
+			     * param_ipa_profile_min_target_probability / 100))
 			{
 			  nuseless++;
 			  if (dump_file)
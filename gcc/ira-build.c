@@ -3442,6 +3442,23 @@ ira_build (void)
   setup_min_max_allocno_live_range_point ();
   sort_conflict_id_map ();
   setup_min_max_conflict_allocno_ids ();
+  /* The allocnos of the inner regions and their caps can make the
+     conflict table too big for a function that could still be colored
+     as a single region.  Try that before giving up on conflicts
+     altogether.  */
+  if (ira_conflicts_p && loops_p && ira_conflict_table_too_big_p ())
+    {
+      if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
+	fprintf (ira_dump_file,
+		 "+++Conflict table will be too big(>%dMB) -- "
+		 "removing all regions but the root\n",
+		 param_ira_max_conflict_table_size);
+      remove_unnecessary_regions (true);
+      loops_p = false;
+      setup_min_max_allocno_live_range_point ();
+      sort_conflict_id_map ();
+      setup_min_max_conflict_allocno_ids ();
+    }
   ira_build_conflicts ();
   update_conflict_hard_reg_costs ();
   if (! ira_conflicts_p)
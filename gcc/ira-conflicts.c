@@ -84,6 +84,34 @@ record_object_conflict (ira_object_t obj1, ira_object_t obj2)
 		      OBJECT_MAX (obj2));
 }
 
+/* Return true if the allocno conflict table for the current allocnos,
+   with the conflict ids and ranges set up by
+   setup_min_max_conflict_allocno_ids, would be bigger than
+   param_ira_max_conflict_table_size.  */
+bool
+ira_conflict_table_too_big_p (void)
+{
+  ira_allocno_t allocno;
+  ira_allocno_iterator ai;
+  ira_object_t obj;
+  ira_allocno_object_iterator aoi;
+  uint64_t allocated_words_num = 0;
+
+  FOR_EACH_ALLOCNO (allocno, ai)
+    FOR_EACH_ALLOCNO_OBJECT (allocno, obj, aoi)
+      {
+	if (OBJECT_MAX (obj) < OBJECT_MIN (obj))
+	  continue;
+	allocated_words_num
+	  += ((OBJECT_MAX (obj) - OBJECT_MIN (obj) + IRA_INT_BITS)
+	      / IRA_INT_BITS);
+	if (allocated_words_num * sizeof (IRA_INT_TYPE)
+	    > (uint64_t) param_ira_max_conflict_table_size * 1024 * 1024)
+	  return true;
+      }
+  return false;
+}
+
 /* Build allocno conflict table by processing allocno live ranges.
    Return true if the table was built.  The table is not built if it
    is too big.  */
@@ -101,27 +129,15 @@ build_conflict_bit_table (void)
   ira_object_t obj;
   ira_allocno_object_iterator aoi;
 
-  allocated_words_num = 0;
-  FOR_EACH_ALLOCNO (allocno, ai)
-    FOR_EACH_ALLOCNO_OBJECT (allocno, obj, aoi)
-      {
-	if (OBJECT_MAX (obj) < OBJECT_MIN (obj))
-	  continue;
-	conflict_bit_vec_words_num
-	  = ((OBJECT_MAX (obj) - OBJECT_MIN (obj) + IRA_INT_BITS)
-	     / IRA_INT_BITS);
-	allocated_words_num += conflict_bit_vec_words_num;
-	if ((uint64_t) allocated_words_num * sizeof (IRA_INT_TYPE)
-	    > (uint64_t) param_ira_max_conflict_table_size * 1024 * 1024)
-	  {
-	    if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
-	      fprintf
-		(ira_dump_file,
-		 "+++Conflict table will be too big(>%dMB) -- don't use it\n",
-		 param_ira_max_conflict_table_size);
-	    return false;
-	  }
-      }
+  if (ira_conflict_table_too_big_p ())
+    {
+      if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
+	fprintf
+	  (ira_dump_file,
+	   "+++Conflict table will be too big(>%dMB) -- don't use it\n",
+	   param_ira_max_conflict_table_size);
+      return false;
+    }
 
   conflicts = (IRA_INT_TYPE **) ira_allocate (sizeof (IRA_INT_TYPE *)
 					      * ira_objects_num);
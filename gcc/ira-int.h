@@ -1055,6 +1055,7 @@ extern void ira_implicitly_set_insn_hard_regs (HARD_REG_SET *,
 
 /* ira-conflicts.c */
 extern void ira_debug_conflicts (bool);
+extern bool ira_conflict_table_too_big_p (void);
 extern void ira_build_conflicts (void);
 
 /* ira-color.c */
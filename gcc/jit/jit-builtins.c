@@ -24,6 +24,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "jit-playback.h"
 #include "stringpool.h"
 
+#include <pthread.h>
+
 #include "jit-builtins.h"
 
 namespace gcc {
@@ -61,38 +63,84 @@ static const struct builtin_data builtin_data[] =
 #include "builtins.def"
 };
 
-/* Helper function for find_builtin_by_name.  */
+/* An entry in builtin_names: one of the names by which a builtin can
+   be looked up, and its id.  */
 
-static bool
-matches_builtin (const char *in_name,
-		 const struct builtin_data& bd)
+struct builtin_name
 {
-  const bool debug = 0;
+  const char *name;
+  enum built_in_function id;
+};
 
-  /* Ignore entries with a NULL name.  */
-  if (!bd.name)
-    return false;
+/* All of the names within builtin_data, sorted by name, with both the
+   "__builtin_"-prefixed and the unprefixed forms of the BOTH_P entries.
+   This is built once per process, the first time a builtin is looked up,
+   and is read-only thereafter, so that contexts in different threads can
+   share it without any locking.  */
 
-  if (debug)
-    fprintf (stderr, "seen builtin: %s\n", bd.name);
+static struct builtin_name *builtin_names;
+static size_t num_builtin_names;
+static pthread_once_t builtin_names_once = PTHREAD_ONCE_INIT;
 
-  if (strcmp (bd.name, in_name) == 0)
-    return true;
+/* qsort callback for sorting builtin_names.  Ties are broken by id, so
+   that a name that appears more than once resolves to the earliest entry
+   in builtins.def, as the linear search this replaced did.  */
 
-  if (bd.both_p)
+static int
+compare_builtin_names (const void *p1, const void *p2)
+{
+  const builtin_name *n1 = (const builtin_name *)p1;
+  const builtin_name *n2 = (const builtin_name *)p2;
+  int cmp = strcmp (n1->name, n2->name);
+  if (cmp)
+    return cmp;
+  return (int)n1->id - (int)n2->id;
+}
+
+/* pthread_once callback for building builtin_names.  */
+
+static void
+init_builtin_names ()
+{
+  const size_t num_builtins = sizeof (builtin_data) / sizeof (builtin_data[0]);
+  builtin_names = XNEWVEC (builtin_name, 2 * num_builtins);
+
+  /* We start at index 1 to skip the initial entry (BUILT_IN_NONE), which
+     has a NULL name.  */
+  size_t n = 0;
+  for (unsigned int i = 1; i < num_builtins; i++)
     {
-      /* Then the macros in builtins.def gave a "__builtin_"
-	 prefix to bd.name, but we should also recognize the form
-	 without the prefix.  */
-      gcc_assert (strncmp (bd.name, prefix, prefix_len) == 0);
-      if (debug)
-	fprintf (stderr, "testing without prefix as: %s\n",
-		 bd.name + prefix_len);
-      if (strcmp (bd.name + prefix_len, in_name) == 0)
-	return true;
+      const struct builtin_data& bd = builtin_data[i];
+
+      /* Ignore entries with a NULL name.  */
+      if (!bd.name)
+	continue;
+
+      builtin_names[n].name = bd.name;
+      builtin_names[n].id = static_cast<enum built_in_function> (i);
+      n++;
+
+      if (bd.both_p)
+	{
+	  /* Then the macros in builtins.def gave a "__builtin_"
+	     prefix to bd.name, but we should also recognize the form
+	     without the prefix.  */
+	  gcc_assert (strncmp (bd.name, prefix, prefix_len) == 0);
+	  builtin_names[n].name = bd.name + prefix_len;
+	  builtin_names[n].id = static_cast<enum built_in_function> (i);
+	  n++;
+	}
     }
 
-  return false;
+  qsort (builtin_names, n, sizeof (builtin_name), compare_builtin_names);
+
+  /* Drop all but the first of any duplicated names.  */
+  size_t unique = 0;
+  for (size_t i = 0; i < n; i++)
+    if (unique == 0
+	|| strcmp (builtin_names[unique - 1].name, builtin_names[i].name))
+      builtin_names[unique++] = builtin_names[i];
+  num_builtin_names = unique;
 }
 
 /* Locate the built-in function that matches name IN_NAME,
@@ -103,23 +151,23 @@ static bool
 find_builtin_by_name (const char *in_name,
 		      enum built_in_function *out_id)
 {
-  /* Locate builtin.  This currently works by performing repeated
-     strcmp against every possible candidate, which is likely to
-     inefficient.
+  pthread_once (&builtin_names_once, init_builtin_names);
 
-     We start at index 1 to skip the initial entry (BUILT_IN_NONE), which
-     has a NULL name.  */
-  for (unsigned int i = 1;
-       i < sizeof (builtin_data) / sizeof (builtin_data[0]);
-       i++)
+  size_t lo = 0, hi = num_builtin_names;
+  while (lo < hi)
     {
-      const struct builtin_data& bd = builtin_data[i];
-      if (matches_builtin (in_name, bd))
+      size_t mid = lo + (hi - lo) / 2;
+      int cmp = strcmp (in_name, builtin_names[mid].name);
+      if (cmp == 0)
 	{
 	  /* Found a match.  */
-	  *out_id = static_cast<enum built_in_function> (i);
+	  *out_id = builtin_names[mid].id;
 	  return true;
 	}
+      if (cmp < 0)
+	hi = mid;
+      else
+	lo = mid + 1;
     }
 
   /* Not found.  */
@@ -98,10 +98,12 @@ namespace gcc {
 namespace jit {
 
 class result;
+class tiered_result; // declared within jit-result.h
 class dump;
 class logger;
 class builtins_manager; // declared within jit-builtins.h
 class tempdir;
+class loaded_object; // declared within jit-loader.h
 
 namespace recording {
 
@@ -198,6 +200,8 @@ enum inner_bool_option
 {
   INNER_BOOL_OPTION_ALLOW_UNREACHABLE_BLOCKS,
   INNER_BOOL_OPTION_USE_EXTERNAL_DRIVER,
+  INNER_BOOL_OPTION_USE_INPROCESS_LOADER,
+  INNER_BOOL_OPTION_COMPILE_IN_SUBPROCESS,
 
   NUM_INNER_BOOL_OPTIONS
 };
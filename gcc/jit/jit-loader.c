@@ -0,0 +1,480 @@
+/* Loading relocatable objects into the libgccjit.so process.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+
+#include "jit-common.h"
+#include "jit-logging.h"
+#include "jit-loader.h"
+
+#if JIT_HAVE_INPROCESS_LOADER
+#include <elf.h>
+#include <sys/mman.h>
+
+/* Provided by libgcc; used to make the unwinder aware of the loaded
+   code, as dlopen would.  */
+extern "C" void __register_frame (void *) __attribute__ ((weak));
+extern "C" void __deregister_frame (void *) __attribute__ ((weak));
+#endif
+
+namespace gcc {
+namespace jit {
+
+/* Constructor for gcc::jit::loaded_object.  */
+
+loaded_object::loaded_object (logger *logger) :
+  log_user (logger),
+  m_base (NULL),
+  m_size (0),
+  m_eh_frame (NULL),
+  m_strtab (NULL),
+  m_symbols ()
+{
+}
+
+/* gcc::jit::loaded_object's destructor.  Unmap the object; any code
+   pointers obtained from it become invalid.  */
+
+loaded_object::~loaded_object ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+#if JIT_HAVE_INPROCESS_LOADER
+  if (m_eh_frame && __deregister_frame)
+    __deregister_frame (m_eh_frame);
+  if (m_base)
+    munmap (m_base, m_size);
+#endif
+  free (m_strtab);
+}
+
+/* Read the relocatable object at PATH and load it into memory.
+   Return NULL if that could not be done, logging why.  */
+
+loaded_object *
+loaded_object::load (logger *logger, const char *path)
+{
+  JIT_LOG_SCOPE (logger);
+
+  if (!JIT_HAVE_INPROCESS_LOADER)
+    {
+      if (logger)
+	logger->log ("in-process loading is not supported on this host");
+      return NULL;
+    }
+
+  FILE *f = fopen (path, "rb");
+  if (!f)
+    {
+      if (logger)
+	logger->log ("unable to open %s: %s", path, xstrerror (errno));
+      return NULL;
+    }
+
+  struct stat st;
+  char *image = NULL;
+  size_t size = 0;
+  if (fstat (fileno (f), &st) == 0)
+    {
+      size = st.st_size;
+      image = XNEWVEC (char, size);
+      if (fread (image, 1, size, f) != size)
+	{
+	  XDELETEVEC (image);
+	  image = NULL;
+	}
+    }
+  fclose (f);
+  if (!image)
+    {
+      if (logger)
+	logger->log ("unable to read %s", path);
+      return NULL;
+    }
+
+  loaded_object *obj = new loaded_object (logger);
+  bool ok = obj->load_image (image, size);
+  XDELETEVEC (image);
+  if (!ok)
+    {
+      delete obj;
+      return NULL;
+    }
+  return obj;
+}
+
+/* Return the address of the global symbol NAME, or NULL.  */
+
+void *
+loaded_object::lookup (const char *name) const
+{
+  JIT_LOG_SCOPE (get_logger ());
+  void **slot = const_cast <hash_map<nofree_string_hash, void *> &>
+    (m_symbols).get (name);
+  return slot ? *slot : NULL;
+}
+
+#if JIT_HAVE_INPROCESS_LOADER
+
+/* Size of an entry in the table of jumps to undefined functions.  */
+#define STUB_SIZE 8
+
+/* Lay out IMAGE, a relocatable object of SIZE bytes, in a fresh
+   mapping, resolve its symbols and apply its relocations.  Return false
+   if the object uses anything we cannot handle.  */
+
+bool
+loaded_object::load_image (const char *image, size_t size)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *) image;
+  if (size < sizeof (*ehdr)
+      || memcmp (ehdr->e_ident, ELFMAG, SELFMAG) != 0
+      || ehdr->e_ident[EI_CLASS] != ELFCLASS64
+      || ehdr->e_ident[EI_DATA] != ELFDATA2LSB
+      || ehdr->e_type != ET_REL
+      || ehdr->e_machine != EM_X86_64
+      || ehdr->e_shentsize != sizeof (Elf64_Shdr)
+      || ehdr->e_shoff + ehdr->e_shnum * sizeof (Elf64_Shdr) > size
+      || ehdr->e_shstrndx >= ehdr->e_shnum)
+    {
+      log ("not an x86_64 ELF relocatable object");
+      return false;
+    }
+
+  const Elf64_Shdr *shdrs = (const Elf64_Shdr *) (image + ehdr->e_shoff);
+  unsigned shnum = ehdr->e_shnum;
+  const char *shstrtab = image + shdrs[ehdr->e_shstrndx].sh_offset;
+  for (unsigned i = 0; i < shnum; i++)
+    if (shdrs[i].sh_type != SHT_NOBITS
+	&& shdrs[i].sh_offset + shdrs[i].sh_size > size)
+      {
+	log ("section %u extends past the end of the file", i);
+	return false;
+      }
+
+  const Elf64_Shdr *symtab = NULL;
+  for (unsigned i = 0; i < shnum; i++)
+    if (shdrs[i].sh_type == SHT_SYMTAB)
+      symtab = &shdrs[i];
+  if (!symtab || symtab->sh_link >= shnum)
+    {
+      log ("no symbol table");
+      return false;
+    }
+  const Elf64_Sym *syms = (const Elf64_Sym *) (image + symtab->sh_offset);
+  unsigned nsyms = symtab->sh_size / sizeof (Elf64_Sym);
+  const Elf64_Shdr *strtab_hdr = &shdrs[symtab->sh_link];
+  const char *strtab = image + strtab_hdr->sh_offset;
+
+  /* Lay out the allocated sections: the ones that are not writable
+     first, followed by a table of jumps to undefined functions, then
+     (on a new page) the writable ones followed by the GOT.  */
+  auto_vec<size_t> offsets (shnum);
+  offsets.quick_grow_cleared (shnum);
+  size_t pagesize = getpagesize ();
+  size_t text_size = 0, data_size = 0;
+  unsigned eh_frame_shndx = 0;
+  for (unsigned pass = 0; pass < 2; pass++)
+    for (unsigned i = 0; i < shnum; i++)
+      {
+	const Elf64_Shdr *sh = &shdrs[i];
+	const char *name = shstrtab + sh->sh_name;
+	if (!(sh->sh_flags & SHF_ALLOC) || sh->sh_size == 0
+	    || ((sh->sh_flags & SHF_WRITE) != 0) != (pass == 1))
+	  continue;
+	if ((sh->sh_flags & SHF_TLS)
+	    || (sh->sh_type != SHT_PROGBITS && sh->sh_type != SHT_NOBITS
+		&& sh->sh_type != SHT_X86_64_UNWIND)
+	    || strncmp (name, ".init", 5) == 0
+	    || strncmp (name, ".fini", 5) == 0
+	    || strncmp (name, ".ctors", 6) == 0
+	    || strncmp (name, ".dtors", 6) == 0)
+	  {
+	    log ("unsupported section %s", name);
+	    return false;
+	  }
+	size_t &cur = pass == 0 ? text_size : data_size;
+	size_t align = MAX (sh->sh_addralign, (Elf64_Xword) 1);
+	cur = (cur + align - 1) & -align;
+	offsets[i] = cur;
+	cur += sh->sh_size;
+	if (strcmp (name, ".eh_frame") == 0)
+	  {
+	    /* Leave room for the zero terminator the unwinder expects.  */
+	    eh_frame_shndx = i;
+	    cur += 4;
+	  }
+      }
+  text_size = (text_size + STUB_SIZE - 1) & -STUB_SIZE;
+  size_t stubs_offset = text_size;
+  text_size += nsyms * STUB_SIZE;
+  text_size = (text_size + pagesize - 1) & -pagesize;
+  data_size = (data_size + 7) & -8;
+  size_t got_offset = text_size + data_size;
+  data_size += nsyms * sizeof (Elf64_Addr);
+  data_size = (data_size + pagesize - 1) & -pagesize;
+
+  /* Every PC-relative reference within the object must fit in 32
+     bits.  */
+  m_size = text_size + data_size;
+  if (m_size >= ((size_t) 1 << 31))
+    {
+      log ("object too large");
+      return false;
+    }
+  void *map = mmap (NULL, m_size, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED)
+    {
+      log ("mmap failed: %s", xstrerror (errno));
+      return false;
+    }
+  m_base = (char *) map;
+
+  auto_vec<char *> sec_addr (shnum);
+  sec_addr.quick_grow_cleared (shnum);
+  for (unsigned i = 0; i < shnum; i++)
+    {
+      const Elf64_Shdr *sh = &shdrs[i];
+      if (!(sh->sh_flags & SHF_ALLOC) || sh->sh_size == 0)
+	continue;
+      sec_addr[i] = m_base + offsets[i]
+		    + ((sh->sh_flags & SHF_WRITE) ? text_size : 0);
+      if (sh->sh_type != SHT_NOBITS)
+	memcpy (sec_addr[i], image + sh->sh_offset, sh->sh_size);
+    }
+
+  Elf64_Addr *got = (Elf64_Addr *) (m_base + got_offset);
+  Elf64_Addr got_addr = (Elf64_Addr) got;
+
+  /* Resolve the symbols.  */
+  m_strtab = (char *) xmemdup (strtab, strtab_hdr->sh_size,
+			       strtab_hdr->sh_size + 1);
+  auto_vec<Elf64_Addr> sym_addr (nsyms);
+  sym_addr.quick_grow_cleared (nsyms);
+  for (unsigned i = 1; i < nsyms; i++)
+    {
+      const Elf64_Sym *sym = &syms[i];
+      const char *name = m_strtab + sym->st_name;
+      int bind = ELF64_ST_BIND (sym->st_info);
+      int type = ELF64_ST_TYPE (sym->st_info);
+
+      if (type == STT_TLS || type == STT_GNU_IFUNC
+	  || sym->st_shndx == SHN_COMMON)
+	{
+	  log ("unsupported symbol %s", name);
+	  return false;
+	}
+      if (sym->st_shndx == SHN_UNDEF)
+	{
+	  if (!*name)
+	    continue;
+	  if (strcmp (name, "_GLOBAL_OFFSET_TABLE_") == 0)
+	    {
+	      sym_addr[i] = got_addr;
+	      continue;
+	    }
+	  dlerror ();
+	  void *addr = dlsym (RTLD_DEFAULT, name);
+	  if (!addr && bind != STB_WEAK)
+	    {
+	      log ("undefined symbol %s", name);
+	      return false;
+	    }
+	  sym_addr[i] = (Elf64_Addr) addr;
+	}
+      else if (sym->st_shndx == SHN_ABS)
+	sym_addr[i] = sym->st_value;
+      else if (sym->st_shndx < shnum && sec_addr[sym->st_shndx])
+	sym_addr[i] = (Elf64_Addr) sec_addr[sym->st_shndx] + sym->st_value;
+      else
+	continue;
+
+      if ((bind == STB_GLOBAL || bind == STB_WEAK)
+	  && sym->st_shndx != SHN_UNDEF
+	  && ELF64_ST_VISIBILITY (sym->st_other) == STV_DEFAULT)
+	m_symbols.put (name, (void *) sym_addr[i]);
+    }
+
+  /* Apply the relocations to the allocated sections.  GOT entries and
+     jumps are created lazily, one per symbol.  */
+  auto_vec<unsigned char> have_got (nsyms), have_stub (nsyms);
+  have_got.quick_grow_cleared (nsyms);
+  have_stub.quick_grow_cleared (nsyms);
+  for (unsigned i = 0; i < shnum; i++)
+    {
+      const Elf64_Shdr *sh = &shdrs[i];
+      if (sh->sh_type == SHT_REL)
+	{
+	  log ("unsupported SHT_REL section");
+	  return false;
+	}
+      if (sh->sh_type != SHT_RELA
+	  || sh->sh_info >= shnum
+	  || !sec_addr[sh->sh_info])
+	continue;
+
+      const Elf64_Rela *relas = (const Elf64_Rela *) (image + sh->sh_offset);
+      size_t nrelas = sh->sh_size / sizeof (Elf64_Rela);
+      char *target = sec_addr[sh->sh_info];
+      for (size_t j = 0; j < nrelas; j++)
+	{
+	  const Elf64_Rela *rela = &relas[j];
+	  unsigned symndx = ELF64_R_SYM (rela->r_info);
+	  unsigned type = ELF64_R_TYPE (rela->r_info);
+	  if (symndx >= nsyms
+	      || rela->r_offset >= shdrs[sh->sh_info].sh_size)
+	    {
+	      log ("bad relocation");
+	      return false;
+	    }
+	  char *where = target + rela->r_offset;
+	  Elf64_Addr p = (Elf64_Addr) where;
+	  Elf64_Addr s = sym_addr[symndx];
+	  Elf64_Sxword a = rela->r_addend;
+	  Elf64_Sxword val;
+
+	  switch (type)
+	    {
+	    case R_X86_64_NONE:
+	      continue;
+
+	    case R_X86_64_64:
+	      val = s + a;
+	      memcpy (where, &val, 8);
+	      continue;
+
+	    case R_X86_64_PC64:
+	      val = s + a - p;
+	      memcpy (where, &val, 8);
+	      continue;
+
+	    case R_X86_64_GOTOFF64:
+	      val = s + a - got_addr;
+	      memcpy (where, &val, 8);
+	      continue;
+
+	    case R_X86_64_GOTPC32:
+	      val = got_addr + a - p;
+	      break;
+
+	    case R_X86_64_32:
+	    case R_X86_64_32S:
+	      val = s + a;
+	      if (type == R_X86_64_32 ? val != (Elf64_Sxword) (uint32_t) val
+				      : val != (Elf64_Sxword) (int32_t) val)
+		{
+		  log ("absolute relocation out of range");
+		  return false;
+		}
+	      {
+		uint32_t v = val;
+		memcpy (where, &v, 4);
+	      }
+	      continue;
+
+	    case R_X86_64_PLT32:
+	    case R_X86_64_PC32:
+	      val = s + a - p;
+	      if (val != (Elf64_Sxword) (int32_t) val
+		  && syms[symndx].st_shndx == SHN_UNDEF
+		  && ELF64_ST_TYPE (syms[symndx].st_info) != STT_OBJECT)
+		{
+		  /* A call to a function too far away from the mapping;
+		     go through a "jmp *GOT(sym)(%rip)".  */
+		  unsigned char *stub
+		    = (unsigned char *) m_base + stubs_offset
+		      + symndx * STUB_SIZE;
+		  if (!have_stub[symndx])
+		    {
+		      int32_t disp = ((Elf64_Addr) &got[symndx]
+				      - ((Elf64_Addr) stub + 6));
+		      got[symndx] = s;
+		      have_got[symndx] = 1;
+		      stub[0] = 0xff;
+		      stub[1] = 0x25;
+		      memcpy (stub + 2, &disp, 4);
+		      have_stub[symndx] = 1;
+		    }
+		  val = (Elf64_Addr) stub + a - p;
+		}
+	      break;
+
+	    case R_X86_64_GOTPCREL:
+	    case R_X86_64_GOTPCRELX:
+	    case R_X86_64_REX_GOTPCRELX:
+	      if (!have_got[symndx])
+		{
+		  got[symndx] = s;
+		  have_got[symndx] = 1;
+		}
+	      val = (Elf64_Addr) &got[symndx] + a - p;
+	      break;
+
+	    default:
+	      log ("unsupported relocation type %u", type);
+	      return false;
+	    }
+
+	  /* The 32-bit PC-relative cases.  */
+	  if (val != (Elf64_Sxword) (int32_t) val)
+	    {
+	      log ("PC-relative relocation out of range");
+	      return false;
+	    }
+	  int32_t v = val;
+	  memcpy (where, &v, 4);
+	}
+    }
+
+  if (eh_frame_shndx && __register_frame)
+    {
+      m_eh_frame = sec_addr[eh_frame_shndx];
+      memset ((char *) m_eh_frame + shdrs[eh_frame_shndx].sh_size, 0, 4);
+      __register_frame (m_eh_frame);
+    }
+
+  if (mprotect (m_base, text_size, PROT_READ | PROT_EXEC) != 0)
+    {
+      log ("mprotect failed: %s", xstrerror (errno));
+      return false;
+    }
+
+  log ("loaded object at %p (%lu bytes, %lu symbols)",
+       (void *) m_base, (unsigned long) m_size,
+       (unsigned long) m_symbols.elements ());
+  return true;
+}
+
+#else
+
+bool
+loaded_object::load_image (const char *, size_t)
+{
+  return false;
+}
+
+#endif /* JIT_HAVE_INPROCESS_LOADER */
+
+} // namespace gcc::jit
+
+} // namespace gcc
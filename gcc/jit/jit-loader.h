@@ -0,0 +1,79 @@
+/* Loading relocatable objects into the libgccjit.so process.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef JIT_LOADER_H
+#define JIT_LOADER_H
+
+#include "jit-logging.h"
+
+/* Hosts on which loaded_object::load can do its job; elsewhere it
+   always fails and the caller falls back to building a DSO.  */
+#if defined (__ELF__) && defined (__x86_64__) && defined (HAVE_SYS_MMAN_H)
+#define JIT_HAVE_INPROCESS_LOADER 1
+#else
+#define JIT_HAVE_INPROCESS_LOADER 0
+#endif
+
+namespace gcc {
+
+namespace jit {
+
+/* A relocatable object file (the "fake.o" built from "fake.s"), mapped
+   into memory and relocated by libgccjit itself, rather than linked
+   into a DSO by the driver and loaded with dlopen.
+
+   Undefined symbols are resolved against the process with dlsym.
+   Only the subset of ELF that the compiler emits for a libgccjit
+   context is supported; load returns NULL for anything else (e.g.
+   constructors or thread-local data), so that the caller can fall back
+   to the DSO route.  */
+
+class loaded_object : public log_user
+{
+ public:
+  static loaded_object *load (logger *logger, const char *path);
+
+  ~loaded_object ();
+
+  void *lookup (const char *name) const;
+
+ private:
+  loaded_object (logger *logger);
+
+  bool load_image (const char *image, size_t size);
+
+  /* The mapping holding all the allocated sections; the executable
+     and read-only sections come first, then the writable ones.  */
+  char *m_base;
+  size_t m_size;
+
+  /* The registered .eh_frame section, if any.  */
+  void *m_eh_frame;
+
+  /* The names of the defined global symbols, pointing into a copy of
+     the string table, and their addresses.  */
+  char *m_strtab;
+  hash_map<nofree_string_hash, void *> m_symbols;
+};
+
+} // namespace gcc::jit
+
+} // namespace gcc
+
+#endif /* JIT_LOADER_H */
@@ -47,6 +47,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "jit-result.h"
 #include "jit-builtins.h"
 #include "jit-tempdir.h"
+#include "jit-loader.h"
 
 #ifdef _WIN32
 #include "jit-w32.h"
@@ -105,6 +106,7 @@ playback::context::context (recording::context *ctxt)
   : log_user (ctxt->get_logger ()),
     m_recording_ctxt (ctxt),
     m_tempdir (NULL),
+    m_optimization_level (-1),
     m_const_char_ptr (NULL)
 {
   JIT_LOG_SCOPE (get_logger ());
@@ -2095,6 +2097,17 @@ compile ()
   /* Acquire the JIT mutex and set "this" as the active playback ctxt.  */
   acquire_mutex ();
 
+#ifndef _WIN32
+  /* Dumps are extracted into buffers in this process, so they can only
+     be honored when compiling in-process.  */
+  if (get_inner_bool_option (INNER_BOOL_OPTION_COMPILE_IN_SUBPROCESS)
+      && requested_dumps.is_empty ())
+    {
+      compile_in_subprocess (ctxt_progname);
+      return;
+    }
+#endif
+
   auto_string_vec fake_args;
   make_fake_args (&fake_args, ctxt_progname, &requested_dumps);
   if (errors_occurred ())
@@ -2163,18 +2176,75 @@ playback::compile_to_memory::compile_to_memory (recording::context *ctxt) :
     to memory.
 
     Convert the .s file to a .so DSO, and load it in memory (via dlopen),
-    wrapping the result up as a jit::result and returning it.  */
+    wrapping the result up as a jit::result and returning it.
+
+    If the in-process loader was requested, first try to assemble the .s
+    file to a .o file and load that ourselves, which avoids linking and
+    dlopen; fall back to the DSO route if the object can't be loaded.  */
 
 void
 playback::compile_to_memory::postprocess (const char *ctxt_progname)
 {
   JIT_LOG_SCOPE (get_logger ());
+  if (get_inner_bool_option (INNER_BOOL_OPTION_USE_INPROCESS_LOADER))
+    {
+      m_result = load_built_object (ctxt_progname);
+      if (m_result || errors_occurred ())
+	return;
+      log ("unable to load object in-process; building a DSO instead");
+    }
   convert_to_dso (ctxt_progname);
   if (errors_occurred ())
     return;
   m_result = dlopen_built_dso ();
 }
 
+/* Implementation of the playback::context::postprocess_in_child vfunc
+   for compiling to memory.  Build the .o file if the in-process loader
+   was requested and can load it, and the .so DSO otherwise; return 'o'
+   or 's' respectively.  */
+
+char
+playback::compile_to_memory::postprocess_in_child (const char *ctxt_progname)
+{
+  JIT_LOG_SCOPE (get_logger ());
+  if (get_inner_bool_option (INNER_BOOL_OPTION_USE_INPROCESS_LOADER))
+    {
+      result *trial = load_built_object (ctxt_progname);
+      if (trial)
+	{
+	  delete trial;
+	  return 'o';
+	}
+      if (errors_occurred ())
+	return 0;
+    }
+  convert_to_dso (ctxt_progname);
+  return 's';
+}
+
+/* Implementation of the playback::context::postprocess_in_parent vfunc
+   for compiling to memory.  Load what postprocess_in_child built.  */
+
+void
+playback::compile_to_memory::postprocess_in_parent (char kind)
+{
+  JIT_LOG_SCOPE (get_logger ());
+  if (kind == 'o')
+    {
+      char *path_o_file = concat (get_tempdir ()->get_path (), "/fake.o",
+				  NULL);
+      get_tempdir ()->add_temp_file (path_o_file);
+      loaded_object *obj = loaded_object::load (get_logger (), path_o_file);
+      if (obj)
+	m_result = new result (get_logger (), obj);
+      else
+	add_error (NULL, "unable to load %s", path_o_file);
+    }
+  else
+    m_result = dlopen_built_dso ();
+}
+
 /* Implementation of class gcc::jit::playback::compile_to_file,
    a subclass of gcc::jit::playback::context.  */
 
@@ -2279,6 +2349,19 @@ playback::compile_to_file::postprocess (const char *ctxt_progname)
 
 }
 
+/* Implementation of the playback::context::postprocess_in_child vfunc
+   for compiling to a file.  Do all of the work, and unlink any
+   tempfiles, since the parent doesn't know about them.  */
+
+char
+playback::compile_to_file::postprocess_in_child (const char *ctxt_progname)
+{
+  JIT_LOG_SCOPE (get_logger ());
+  postprocess (ctxt_progname);
+  get_tempdir ()->remove_temp_files ();
+  return 'f';
+}
+
 /* Copy SRC_PATH to DST_PATH, preserving permission bits (in particular,
    the "executable" bits).
 
@@ -2418,6 +2501,137 @@ playback::context::acquire_mutex ()
   active_playback_ctxt = this;
 }
 
+#ifndef _WIN32
+
+/* Write LEN bytes from BUF to FD, giving up on errors.  */
+
+static void
+write_all (int fd, const char *buf, size_t len)
+{
+  while (len)
+    {
+      ssize_t n = write (fd, buf, len);
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	return;
+      buf += n;
+      len -= n;
+    }
+}
+
+/* Part of playback::context::compile (), called with jit_mutex held.
+
+   Fork, and run the compiler and the postprocess_in_child vfunc in the
+   child, which has its own copy of GCC's global state; the mutex only
+   needs to be held across the fork, so that the child doesn't see
+   another compilation's half-updated state.  Then wait for the child
+   and run the postprocess_in_parent vfunc.  This allows any number of
+   threads to compile concurrently.
+
+   The child reports back through a pipe: the character returned by
+   postprocess_in_child, or 0 followed by the first error message.  */
+
+void
+playback::context::
+compile_in_subprocess (const char *ctxt_progname)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  int fds[2];
+  if (pipe (fds) != 0)
+    {
+      release_mutex ();
+      add_error (NULL, "unable to create pipe: %s", xstrerror (errno));
+      return;
+    }
+
+  pid_t pid = fork ();
+  if (pid == 0)
+    {
+      close (fds[0]);
+
+      auto_vec <recording::requested_dump> no_dumps;
+      auto_string_vec fake_args;
+      make_fake_args (&fake_args, ctxt_progname, &no_dumps);
+      if (!errors_occurred ())
+	{
+	  toplev toplev (get_timer (), /* external_timer */
+			 false); /* init_signals */
+	  toplev.main (fake_args.length (),
+		       const_cast <char **> (fake_args.address ()));
+	  toplev.finalize ();
+	}
+
+      char kind = 0;
+      if (!errors_occurred ())
+	{
+	  if (get_bool_option (GCC_JIT_BOOL_OPTION_DUMP_GENERATED_CODE))
+	    dump_generated_code ();
+	  kind = postprocess_in_child (ctxt_progname);
+	}
+
+      const char *errmsg = m_recording_ctxt->get_first_error ();
+      if (errmsg)
+	kind = 0;
+      write_all (fds[1], &kind, 1);
+      if (errmsg)
+	write_all (fds[1], errmsg, strlen (errmsg));
+      fflush (stdout);
+      fflush (stderr);
+      _exit (errmsg ? 1 : 0);
+    }
+
+  int fork_errno = errno;
+  release_mutex ();
+  close (fds[1]);
+  if (pid < 0)
+    {
+      close (fds[0]);
+      add_error (NULL, "unable to fork: %s", xstrerror (fork_errno));
+      return;
+    }
+
+  auto_vec <char> reply;
+  char buf[256];
+  for (;;)
+    {
+      ssize_t n = read (fds[0], buf, sizeof (buf));
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	break;
+      for (ssize_t i = 0; i < n; i++)
+	reply.safe_push (buf[i]);
+    }
+  close (fds[0]);
+
+  int status;
+  while (waitpid (pid, &status, 0) < 0)
+    if (errno != EINTR)
+      {
+	status = -1;
+	break;
+      }
+
+  if (status != 0 || reply.is_empty () || reply[0] == 0)
+    {
+      /* The child has already printed its errors to stderr.  */
+      reply.safe_push ('\0');
+      if (reply.length () > 2)
+	add_error (NULL, "compilation subprocess failed: %s",
+		   reply.address () + 1);
+      else
+	add_error (NULL, "compilation subprocess failed (status %i)",
+		   status);
+      return;
+    }
+
+  postprocess_in_parent (reply[0]);
+}
+
+#endif /* #ifndef _WIN32 */
+
 /* Release jit_mutex and clear the active playback ctxt.  */
 
 void
@@ -2462,12 +2676,16 @@ make_fake_args (vec <char *> *argvec,
   ADD_ARG ("-fPIC");
 
   /* Handle int options: */
-  switch (get_int_option (GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL))
+  int optimization_level = m_optimization_level;
+  if (optimization_level < 0)
+    optimization_level
+      = get_int_option (GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL);
+  switch (optimization_level)
     {
     default:
       add_error (NULL,
 		 "unrecognized optimization level: %i",
-		 get_int_option (GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL));
+		 optimization_level);
       return;
 
     case 0:
@@ -2930,6 +3148,38 @@ dlopen_built_dso ()
   return result_obj;
 }
 
+/* Assemble the .s file to a .o file and load it into this process
+   with loaded_object, without linking it.  Wrap it up within a
+   jit::result *, and return that.  Return NULL if the object could not
+   be loaded; errors are only reported on this context if assembling
+   failed.  */
+
+result *
+playback::context::
+load_built_object (const char *ctxt_progname)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  char *path_o_file = concat (m_tempdir->get_path (), "/fake.o", NULL);
+  m_tempdir->add_temp_file (path_o_file);
+
+  invoke_driver (ctxt_progname,
+		 m_tempdir->get_path_s_file (),
+		 path_o_file,
+		 TV_ASSEMBLE,
+		 false, /* bool shared, */
+		 false);/* bool run_linker */
+  if (errors_occurred ())
+    return NULL;
+
+  auto_timevar load_timevar (get_timer (), TV_LOAD);
+  loaded_object *obj = loaded_object::load (get_logger (), path_o_file);
+  if (!obj)
+    return NULL;
+
+  return new result (get_logger (), obj);
+}
+
 /* Top-level hook for playing back a recording context.
 
    This plays back m_recording_ctxt, and, if no errors
@@ -196,6 +196,14 @@ public:
     return m_recording_ctxt->get_int_option (opt);
   }
 
+  /* Compile at LEVEL rather than at the recording context's
+     GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL.  */
+  void
+  set_optimization_level (int level)
+  {
+    m_optimization_level = level;
+  }
+
   int
   get_bool_option (enum gcc_jit_bool_option opt) const
   {
@@ -292,6 +300,10 @@ private:
   void acquire_mutex ();
   void release_mutex ();
 
+#ifndef _WIN32
+  void compile_in_subprocess (const char *ctxt_progname);
+#endif
+
   void
   make_fake_args (vec <char *> *argvec,
 		  const char *ctxt_progname,
@@ -306,6 +318,13 @@ private:
 
   virtual void postprocess (const char *ctxt_progname) = 0;
 
+  /* The split of postprocess used by compile_in_subprocess: the part
+     that needs GCC's global state runs in the child and returns a
+     character describing what it built, which is then passed to the
+     part run in the parent.  */
+  virtual char postprocess_in_child (const char *ctxt_progname) = 0;
+  virtual void postprocess_in_parent (char kind) = 0;
+
 protected:
   tempdir *get_tempdir () { return m_tempdir; }
 
@@ -326,6 +345,9 @@ protected:
   result *
   dlopen_built_dso ();
 
+  result *
+  load_built_object (const char *ctxt_progname);
+
  private:
   void
   invoke_embedded_driver (const vec <char *> *argvec);
@@ -339,6 +361,10 @@ private:
 
   tempdir *m_tempdir;
 
+  /* The optimization level to compile at, or -1 to use the recording
+     context's option.  */
+  int m_optimization_level;
+
   auto_vec<function *> m_functions;
   auto_vec<tree> m_globals;
   tree m_const_char_ptr;
@@ -354,6 +380,8 @@ class compile_to_memory : public context
  public:
   compile_to_memory (recording::context *ctxt);
   void postprocess (const char *ctxt_progname) FINAL OVERRIDE;
+  char postprocess_in_child (const char *ctxt_progname) FINAL OVERRIDE;
+  void postprocess_in_parent (char kind) FINAL OVERRIDE;
 
   result *get_result_obj () const { return m_result; }
 
@@ -368,6 +396,8 @@ class compile_to_file : public context
 		   enum gcc_jit_output_kind output_kind,
 		   const char *output_path);
   void postprocess (const char *ctxt_progname) FINAL OVERRIDE;
+  char postprocess_in_child (const char *ctxt_progname) FINAL OVERRIDE;
+  void postprocess_in_parent (char) FINAL OVERRIDE {}
 
  private:
   void
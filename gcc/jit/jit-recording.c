@@ -30,6 +30,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "jit-builtins.h"
 #include "jit-recording.h"
 #include "jit-playback.h"
+#include "jit-result.h"
 
 namespace gcc {
 namespace jit {
@@ -1373,13 +1374,14 @@ recording::context::enable_dump (const char *dumpname,
 }
 
 /* Validate this context, and if it passes, compile it to memory
-   (within a mutex).
+   (within a mutex), at OPTIMIZATION_LEVEL if that is non-negative,
+   or else at GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL.
 
    Implements the post-error-checking part of
    gcc_jit_context_compile.  */
 
 result *
-recording::context::compile ()
+recording::context::compile (int optimization_level)
 {
   JIT_LOG_SCOPE (get_logger ());
 
@@ -1392,6 +1394,8 @@ recording::context::compile ()
 
   /* Set up a compile_to_memory playback context.  */
   ::gcc::jit::playback::compile_to_memory replayer (this);
+  if (optimization_level >= 0)
+    replayer.set_optimization_level (optimization_level);
 
   /* Use it.  */
   replayer.compile ();
@@ -1401,6 +1405,32 @@ recording::context::compile ()
   return replayer.get_result_obj ();
 }
 
+/* Compile this context to memory at -O0, and then, if
+   GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL is non-zero, recompile it at
+   that level on a background thread.
+
+   Implements the post-error-checking part of
+   gcc_jit_context_compile_tiered.  */
+
+tiered_result *
+recording::context::compile_tiered ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  result *baseline = compile (0);
+  if (!baseline)
+    return NULL;
+
+  tiered_result *tiered = new tiered_result (this, baseline);
+
+  int optimization_level
+    = get_int_option (GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL);
+  if (optimization_level > 0)
+    tiered->start_optimized_compile (optimization_level);
+
+  return tiered;
+}
+
 /* Validate this context, and if it passes, compile it to a file
    (within a mutex).
 
@@ -1609,7 +1639,9 @@ static const char * const
 static const char * const
  inner_bool_option_reproducer_strings[NUM_INNER_BOOL_OPTIONS] = {
   "gcc_jit_context_set_bool_allow_unreachable_blocks",
-  "gcc_jit_context_set_bool_use_external_driver"
+  "gcc_jit_context_set_bool_use_external_driver",
+  "gcc_jit_context_set_bool_use_inprocess_loader",
+  "gcc_jit_context_set_bool_compile_in_subprocess"
 };
 
 /* Write the current value of all options to the log file (if any).  */
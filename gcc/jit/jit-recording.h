@@ -261,7 +261,10 @@ public:
   }
 
   result *
-  compile ();
+  compile (int optimization_level = -1);
+
+  tiered_result *
+  compile_tiered ();
 
   void
   compile_to_file (enum gcc_jit_output_kind output_kind,
@@ -22,10 +22,14 @@ along with GCC; see the file COPYING3.  If not see
 #include "system.h"
 #include "coretypes.h"
 
+#include <pthread.h>
+
 #include "jit-common.h"
 #include "jit-logging.h"
 #include "jit-result.h"
 #include "jit-tempdir.h"
+#include "jit-loader.h"
+#include "jit-recording.h"
 
 #ifdef _WIN32
 #include "jit-w32.h"
@@ -40,7 +44,21 @@ result::
 result(logger *logger, handle dso_handle, tempdir *tempdir_) :
   log_user (logger),
   m_dso_handle (dso_handle),
-  m_tempdir (tempdir_)
+  m_tempdir (tempdir_),
+  m_object (NULL)
+{
+  JIT_LOG_SCOPE (get_logger ());
+}
+
+/* Constructor for a gcc::jit::result wrapping an object loaded by
+   loaded_object::load, taking ownership of it.  */
+
+result::
+result(logger *logger, loaded_object *object) :
+  log_user (logger),
+  m_dso_handle (NULL),
+  m_tempdir (NULL),
+  m_object (object)
 {
   JIT_LOG_SCOPE (get_logger ());
 }
@@ -53,10 +71,13 @@ result::~result()
 {
   JIT_LOG_SCOPE (get_logger ());
 
+  if (m_object)
+    delete m_object;
+  else
 #ifdef _WIN32
-  FreeLibrary(m_dso_handle);
+    FreeLibrary(m_dso_handle);
 #else
-  dlclose (m_dso_handle);
+    dlclose (m_dso_handle);
 #endif
   /* Responsibility for cleaning up the tempdir (including "fake.so" within
      the filesystem) might have been handed to us by the playback::context,
@@ -80,6 +101,9 @@ get_code (const char *funcname)
 
   void *code;
 
+  if (m_object)
+    return m_object->lookup (funcname);
+
 #ifdef _WIN32
   /* Clear any existing error.  */
   SetLastError(0);
@@ -117,6 +141,9 @@ get_global (const char *name)
 
   void *global;
 
+  if (m_object)
+    return m_object->lookup (name);
+
 #ifdef _WIN32
   /* Clear any existing error.  */
   SetLastError(0);
@@ -140,6 +167,176 @@ get_global (const char *name)
   return global;
 }
 
+// class tiered_result
+
+/* Constructor for gcc::jit::tiered_result, taking ownership of
+   BASELINE, which was compiled from CTXT.  */
+
+tiered_result::
+tiered_result (recording::context *ctxt, result *baseline) :
+  log_user (ctxt->get_logger ()),
+  m_ctxt (ctxt),
+  m_optimization_level (0),
+  m_baseline (baseline),
+  m_optimized (NULL),
+  m_thread_started (false),
+  m_done (true),
+  m_slots ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+  pthread_mutex_init (&m_mutex, NULL);
+  pthread_cond_init (&m_done_cond, NULL);
+}
+
+/* gcc::jit::tiered_result's destructor.
+
+   Called implicitly by gcc_jit_tiered_result_release, which waits
+   for any background compile to finish.  */
+
+tiered_result::~tiered_result ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  if (m_thread_started)
+    pthread_join (m_thread, NULL);
+
+  for (hash_map<nofree_string_hash, void **>::iterator it = m_slots.begin ();
+       it != m_slots.end ();
+       ++it)
+    {
+      free (const_cast <char *> ((*it).first));
+      free ((*it).second);
+    }
+
+  delete m_optimized;
+  delete m_baseline;
+
+  pthread_cond_destroy (&m_done_cond);
+  pthread_mutex_destroy (&m_mutex);
+}
+
+/* Start recompiling the context at OPTIMIZATION_LEVEL on a background
+   thread.  If the thread can't be created, the baseline code is used
+   for the lifetime of this object.  */
+
+void
+tiered_result::start_optimized_compile (int optimization_level)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  m_optimization_level = optimization_level;
+  m_done = false;
+  if (pthread_create (&m_thread, NULL, optimized_compile_thread, this))
+    {
+      log ("unable to create thread for optimized compile");
+      m_done = true;
+      return;
+    }
+  m_thread_started = true;
+}
+
+/* The body of the background thread started by
+   start_optimized_compile.  */
+
+void *
+tiered_result::optimized_compile_thread (void *arg)
+{
+  tiered_result *tiered = (tiered_result *)arg;
+  result *optimized = tiered->m_ctxt->compile (tiered->m_optimization_level);
+  tiered->install_optimized_result (optimized);
+  return NULL;
+}
+
+/* Called on the background thread with the result of the optimized
+   compile, or NULL if it failed: switch all of the slots handed out so
+   far over to the optimized code, and wake up any waiters.  */
+
+void
+tiered_result::install_optimized_result (result *optimized)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  pthread_mutex_lock (&m_mutex);
+
+  m_optimized = optimized;
+  if (optimized)
+    for (hash_map<nofree_string_hash, void **>::iterator it = m_slots.begin ();
+	 it != m_slots.end ();
+	 ++it)
+      {
+	void *code = optimized->get_code ((*it).first);
+	if (code)
+	  __atomic_store_n ((*it).second, code, __ATOMIC_RELEASE);
+      }
+  else
+    log ("optimized compile failed; keeping baseline code");
+
+  m_done = true;
+  pthread_cond_broadcast (&m_done_cond);
+
+  pthread_mutex_unlock (&m_mutex);
+}
+
+/* Get the slot for the function FUNCNAME, creating it if this is the
+   first request for it, or return NULL if there is no such function.
+
+   Implements the post-error-checking part of
+   gcc_jit_tiered_result_get_code_slot.  */
+
+void **
+tiered_result::get_code_slot (const char *funcname)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  pthread_mutex_lock (&m_mutex);
+
+  void ***existing = m_slots.get (funcname);
+  if (existing)
+    {
+      void **slot = *existing;
+      pthread_mutex_unlock (&m_mutex);
+      return slot;
+    }
+
+  void *code = NULL;
+  if (m_optimized)
+    code = m_optimized->get_code (funcname);
+  if (!code)
+    code = m_baseline->get_code (funcname);
+  if (!code)
+    {
+      pthread_mutex_unlock (&m_mutex);
+      return NULL;
+    }
+
+  void **slot = XNEW (void *);
+  *slot = code;
+  m_slots.put (xstrdup (funcname), slot);
+
+  pthread_mutex_unlock (&m_mutex);
+  return slot;
+}
+
+/* Block until the background compile has finished, returning true if
+   the slots now point at optimized code.
+
+   Implements the post-error-checking part of
+   gcc_jit_tiered_result_wait.  */
+
+bool
+tiered_result::wait ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  pthread_mutex_lock (&m_mutex);
+  while (!m_done)
+    pthread_cond_wait (&m_done_cond, &m_mutex);
+  bool optimized = m_optimized != NULL;
+  pthread_mutex_unlock (&m_mutex);
+
+  return optimized;
+}
+
 } // namespace gcc::jit
 
 } // namespace gcc
@@ -40,6 +40,7 @@ public:
 #endif
 
   result(logger *logger, handle dso_handle, tempdir *tempdir_);
+  result(logger *logger, loaded_object *object);
 
   virtual ~result();
 
@@ -52,6 +53,66 @@ public:
 private:
   handle m_dso_handle;
   tempdir *m_tempdir;
+
+  /* The object loaded by libgccjit itself rather than with dlopen,
+     in which case m_dso_handle is NULL.  */
+  loaded_object *m_object;
+};
+
+/* The result of gcc_jit_context_compile_tiered: a quickly-built
+   baseline result, later superseded by an optimized recompile of the
+   same recording context, built on a background thread.
+
+   Clients call through "slots" rather than through the pointers
+   returned by result::get_code; each slot initially points at the
+   baseline code and is atomically updated to point at the optimized
+   code once that has been built.  Both results stay loaded until the
+   tiered_result is released, since other threads may still be running
+   the baseline code after the switch.  */
+
+class tiered_result : public log_user
+{
+public:
+  tiered_result (recording::context *ctxt, result *baseline);
+  ~tiered_result ();
+
+  void
+  start_optimized_compile (int optimization_level);
+
+  void **
+  get_code_slot (const char *funcname);
+
+  bool
+  wait ();
+
+private:
+  static void *
+  optimized_compile_thread (void *arg);
+
+  void
+  install_optimized_result (result *optimized);
+
+private:
+  recording::context *m_ctxt;
+  int m_optimization_level;
+
+  result *m_baseline;
+  result *m_optimized;
+
+  bool m_thread_started;
+  pthread_t m_thread;
+
+  /* Guards all of the following.  */
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_done_cond;
+
+  /* Whether the background compile has finished (or was never
+     started).  */
+  bool m_done;
+
+  /* The slots handed out by get_code_slot, keyed by copies of the
+     function names.  */
+  hash_map<nofree_string_hash, void **> m_slots;
 };
 
 } // namespace gcc::jit
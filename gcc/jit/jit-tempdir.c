@@ -119,6 +119,28 @@ gcc::jit::tempdir::create ()
   return true;
 }
 
+/* Unlink the tempfiles added with add_temp_file so far (unless
+   keep_intermediates was set), and forget about them.  */
+
+void
+gcc::jit::tempdir::remove_temp_files ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  int i;
+  char *tempfile;
+  FOR_EACH_VEC_ELT (m_tempfiles, i, tempfile)
+    {
+      if (!m_keep_intermediates)
+	{
+	  log ("unlinking tempfile: %s", tempfile);
+	  unlink (tempfile);
+	}
+      free (tempfile);
+    }
+  m_tempfiles.truncate (0);
+}
+
 /* The destructor for the jit::tempdir object, which
    cleans up the filesystem directory and its contents
    (unless keep_intermediates was set).  */
@@ -144,13 +166,7 @@ gcc::jit::tempdir::~tempdir ()
 	}
 
       /* Clean up any other tempfiles.  */
-      int i;
-      char *tempfile;
-      FOR_EACH_VEC_ELT (m_tempfiles, i, tempfile)
-	{
-	  log ("unlinking tempfile: %s", tempfile);
-	  unlink (tempfile);
-	}
+      remove_temp_files ();
 
       /* The tempdir should now be empty; remove it.  */
       if (m_path_tempdir)
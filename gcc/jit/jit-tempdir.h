@@ -62,6 +62,8 @@ class tempdir : public log_user
      Take ownership of the buffer PATH; it will be freed.  */
   void add_temp_file (char *path) { m_tempfiles.safe_push (path); }
 
+  void remove_temp_files ();
+
  private:
   /* Was GCC_JIT_BOOL_OPTION_KEEP_INTERMEDIATES set?  If so, keep the
      on-disk tempdir around after this wrapper object goes away.  */
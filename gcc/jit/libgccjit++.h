@@ -104,6 +104,7 @@ namespace gccjit
     void release ();
 
     gcc_jit_result *compile ();
+    gcc_jit_tiered_result *compile_tiered ();
 
     void compile_to_file (enum gcc_jit_output_kind output_kind,
 			  const char *output_path);
@@ -128,6 +129,8 @@ namespace gccjit
 
     void set_bool_allow_unreachable_blocks (int bool_value);
     void set_bool_use_external_driver (int bool_value);
+    void set_bool_use_inprocess_loader (int bool_value);
+    void set_bool_compile_in_subprocess (int bool_value);
 
     void add_command_line_option (const char *optname);
     void add_driver_option (const char *optname);
@@ -659,6 +662,16 @@ context::compile ()
   return result;
 }
 
+inline gcc_jit_tiered_result *
+context::compile_tiered ()
+{
+  gcc_jit_tiered_result *result
+    = gcc_jit_context_compile_tiered (m_inner_ctxt);
+  if (!result)
+    throw error ();
+  return result;
+}
+
 inline void
 context::compile_to_file (enum gcc_jit_output_kind output_kind,
 			  const char *output_path)
@@ -732,6 +745,20 @@ context::set_bool_use_external_driver (int bool_value)
 						bool_value);
 }
 
+inline void
+context::set_bool_use_inprocess_loader (int bool_value)
+{
+  gcc_jit_context_set_bool_use_inprocess_loader (m_inner_ctxt,
+						 bool_value);
+}
+
+inline void
+context::set_bool_compile_in_subprocess (int bool_value)
+{
+  gcc_jit_context_set_bool_compile_in_subprocess (m_inner_ctxt,
+						  bool_value);
+}
+
 inline void
 context::add_command_line_option (const char *optname)
 {
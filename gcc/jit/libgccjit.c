@@ -44,6 +44,10 @@ struct gcc_jit_result : public gcc::jit::result
 {
 };
 
+struct gcc_jit_tiered_result : public gcc::jit::tiered_result
+{
+};
+
 struct gcc_jit_object : public gcc::jit::recording::memento
 {
 };
@@ -2752,6 +2756,40 @@ gcc_jit_context_set_bool_use_external_driver (gcc_jit_context *ctxt,
     bool_value);
 }
 
+/* Public entrypoint.  See description in libgccjit.h.
+
+   After error-checking, the real work is done by the
+   gcc::jit::recording::context::set_inner_bool_option method in
+   jit-recording.c.  */
+
+extern void
+gcc_jit_context_set_bool_use_inprocess_loader (gcc_jit_context *ctxt,
+					       int bool_value)
+{
+  RETURN_IF_FAIL (ctxt, NULL, NULL, "NULL context");
+  JIT_LOG_FUNC (ctxt->get_logger ());
+  ctxt->set_inner_bool_option (
+    gcc::jit::INNER_BOOL_OPTION_USE_INPROCESS_LOADER,
+    bool_value);
+}
+
+/* Public entrypoint.  See description in libgccjit.h.
+
+   After error-checking, the real work is done by the
+   gcc::jit::recording::context::set_inner_bool_option method in
+   jit-recording.c.  */
+
+extern void
+gcc_jit_context_set_bool_compile_in_subprocess (gcc_jit_context *ctxt,
+						int bool_value)
+{
+  RETURN_IF_FAIL (ctxt, NULL, NULL, "NULL context");
+  JIT_LOG_FUNC (ctxt->get_logger ());
+  ctxt->set_inner_bool_option (
+    gcc::jit::INNER_BOOL_OPTION_COMPILE_IN_SUBPROCESS,
+    bool_value);
+}
+
 /* Public entrypoint.  See description in libgccjit.h.
 
    After error-checking, the real work is done by the
@@ -2997,6 +3035,78 @@ gcc_jit_result_release (gcc_jit_result *result)
   delete result;
 }
 
+/* Public entrypoint.  See description in libgccjit.h.
+
+   After error-checking, the real work is done by the
+   gcc::jit::recording::context::compile_tiered method in
+   jit-recording.c.  */
+
+gcc_jit_tiered_result *
+gcc_jit_context_compile_tiered (gcc_jit_context *ctxt)
+{
+  RETURN_NULL_IF_FAIL (ctxt, NULL, NULL, "NULL context");
+
+  JIT_LOG_FUNC (ctxt->get_logger ());
+
+  ctxt->log ("tiered compile of ctxt: %p", (void *)ctxt);
+
+  gcc_jit_tiered_result *result
+    = (gcc_jit_tiered_result *)ctxt->compile_tiered ();
+
+  ctxt->log ("%s: returning (gcc_jit_tiered_result *)%p",
+	     __func__, (void *)result);
+
+  return result;
+}
+
+/* Public entrypoint.  See description in libgccjit.h.
+
+   After error-checking, the real work is done by the
+   gcc::jit::tiered_result::get_code_slot method in jit-result.c.  */
+
+void **
+gcc_jit_tiered_result_get_code_slot (gcc_jit_tiered_result *result,
+				     const char *funcname)
+{
+  RETURN_NULL_IF_FAIL (result, NULL, NULL, "NULL result");
+  JIT_LOG_FUNC (result->get_logger ());
+  RETURN_NULL_IF_FAIL (funcname, NULL, NULL, "NULL funcname");
+
+  result->log ("locating slot for fnname: %s", funcname);
+  void **slot = result->get_code_slot (funcname);
+  result->log ("%s: returning (void **)%p", __func__, (void *)slot);
+
+  return slot;
+}
+
+/* Public entrypoint.  See description in libgccjit.h.
+
+   After error-checking, the real work is done by the
+   gcc::jit::tiered_result::wait method in jit-result.c.  */
+
+int
+gcc_jit_tiered_result_wait (gcc_jit_tiered_result *result)
+{
+  RETURN_VAL_IF_FAIL (result, 0, NULL, NULL, "NULL result");
+  JIT_LOG_FUNC (result->get_logger ());
+
+  return result->wait ();
+}
+
+/* Public entrypoint.  See description in libgccjit.h.
+
+   The real work is done by the gcc::jit::tiered_result destructor in
+   jit-result.c.  */
+
+void
+gcc_jit_tiered_result_release (gcc_jit_tiered_result *result)
+{
+  RETURN_IF_FAIL (result, NULL, NULL, "NULL result");
+  JIT_LOG_FUNC (result->get_logger ());
+  result->log ("deleting tiered result: %p", (void *)result);
+  delete result;
+}
+
 /**********************************************************************
  Timing support.
  **********************************************************************/
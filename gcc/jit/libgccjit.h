@@ -52,6 +52,10 @@ typedef struct gcc_jit_context gcc_jit_context;
 /* A gcc_jit_result encapsulates the result of an in-memory compilation.  */
 typedef struct gcc_jit_result gcc_jit_result;
 
+/* A gcc_jit_tiered_result encapsulates the result of a tiered in-memory
+   compilation (see gcc_jit_context_compile_tiered).  */
+typedef struct gcc_jit_tiered_result gcc_jit_tiered_result;
+
 /* An object created within a context.  Such objects are automatically
    cleaned up when the context is released.
 
@@ -309,6 +313,56 @@ gcc_jit_context_set_bool_use_external_driver (gcc_jit_context *ctxt,
    tested for with #ifdef.  */
 #define LIBGCCJIT_HAVE_gcc_jit_context_set_bool_use_external_driver
 
+/* Implementation detail:
+   by default, gcc_jit_context_compile assembles and links the generated
+   code into a shared library in a temporary directory, and loads it
+   with dlopen.
+
+   This option can be used to instead only assemble the generated code,
+   and to map and relocate the resulting object within the current
+   process, avoiding the linker and dlopen.  If the object can't be
+   loaded that way (e.g. on an unsupported host), the shared library
+   route is used.  It has no effect on gcc_jit_context_compile_to_file.
+
+   This entrypoint was added in LIBGCCJIT_ABI_16; you can test for
+   its presence using
+     #ifdef LIBGCCJIT_HAVE_gcc_jit_context_set_bool_use_inprocess_loader
+*/
+
+extern void
+gcc_jit_context_set_bool_use_inprocess_loader (gcc_jit_context *ctxt,
+					       int bool_value);
+
+/* Pre-canned feature macro to indicate the presence of
+   gcc_jit_context_set_bool_use_inprocess_loader.  This can be
+   tested for with #ifdef.  */
+#define LIBGCCJIT_HAVE_gcc_jit_context_set_bool_use_inprocess_loader
+
+/* Implementation detail:
+   the compiler uses global state, so by default only one thread at a
+   time can be compiling a context; the others wait for it.
+
+   This option can be used to instead run the compiler in a forked
+   subprocess, with its own copy of that state; the lock is then only
+   held while forking, so many threads can compile at once.  The
+   generated code is passed back through the tempdir.  The option is
+   ignored if dumps were requested with gcc_jit_context_enable_dump,
+   and on hosts without fork.
+
+   This entrypoint was added in LIBGCCJIT_ABI_17; you can test for
+   its presence using
+     #ifdef LIBGCCJIT_HAVE_gcc_jit_context_set_bool_compile_in_subprocess
+*/
+
+extern void
+gcc_jit_context_set_bool_compile_in_subprocess (gcc_jit_context *ctxt,
+						int bool_value);
+
+/* Pre-canned feature macro to indicate the presence of
+   gcc_jit_context_set_bool_compile_in_subprocess.  This can be
+   tested for with #ifdef.  */
+#define LIBGCCJIT_HAVE_gcc_jit_context_set_bool_compile_in_subprocess
+
 /* Add an arbitrary gcc command-line option to the context.
    The context takes a copy of the string, so the
    (const char *) optname is not needed anymore after the call
@@ -456,6 +510,58 @@ gcc_jit_result_get_global (gcc_jit_result *result,
 extern void
 gcc_jit_result_release (gcc_jit_result *result);
 
+/* Tiered compilation.
+
+   gcc_jit_context_compile_tiered compiles the context to memory at -O0,
+   which is quick, and returns as soon as that code is ready.  If
+   GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL is non-zero, it then recompiles
+   the same context at that level on a background thread.
+
+   Functions are located through "slots": a slot holds a pointer to the
+   function's code, initially the -O0 code, which is atomically replaced
+   by a pointer to the optimized code once that has been built.  Call
+   through the slot's current value each time (e.g. with
+   __atomic_load_n (slot, __ATOMIC_ACQUIRE)) to pick up the optimized
+   code.  Each tier has its own copy of any exported globals, so code
+   that needs state shared between tiers should use imported globals.
+
+   The context must not be modified or released until
+   gcc_jit_tiered_result_wait has returned; errors from the background
+   compile are reported on the context as usual.
+
+   Returns NULL if the -O0 compile fails.
+
+   These entrypoints were added in LIBGCCJIT_ABI_18; you can test for
+   their presence using
+     #ifdef LIBGCCJIT_HAVE_gcc_jit_context_compile_tiered
+*/
+extern gcc_jit_tiered_result *
+gcc_jit_context_compile_tiered (gcc_jit_context *ctxt);
+
+/* Get the slot for the given function, or NULL if there is no such
+   function.  The slot remains valid until the tiered result is
+   released.  */
+extern void **
+gcc_jit_tiered_result_get_code_slot (gcc_jit_tiered_result *result,
+				     const char *funcname);
+
+/* Block until the background compile has finished.  Returns 1 if the
+   slots now point at optimized code, or 0 if there was no background
+   compile or it failed, in which case they stay at the -O0 code.  */
+extern int
+gcc_jit_tiered_result_wait (gcc_jit_tiered_result *result);
+
+/* Wait for any background compile, then unload the code of both tiers.
+   After calling this, it's no longer valid to use the result or its
+   slots.  */
+extern void
+gcc_jit_tiered_result_release (gcc_jit_tiered_result *result);
+
+/* Pre-canned feature macro to indicate the presence of
+   gcc_jit_context_compile_tiered and the gcc_jit_tiered_result
+   entrypoints.  This can be tested for with #ifdef.  */
+#define LIBGCCJIT_HAVE_gcc_jit_context_compile_tiered
+
 
 /**********************************************************************
  Functions for creating "contextual" objects.
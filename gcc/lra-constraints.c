@@ -4925,6 +4925,33 @@ init_insn_rhs_dead_pseudo_p (int regno)
   return false;
 }
 
+/* Return true if the pseudos dying in the right hand sides of the init
+   insns of REGNO are not live at the start of the blocks of those insns.
+   The pseudos are then set earlier in the same blocks, typically by the
+   first insns of a multi-insn constant load such as a HIGH/LO_SUM pair,
+   and removing the init insns does not make the live-in sets wrong;
+   the sets of the pseudos become dead and are removed with them.  */
+static bool
+init_insn_rhs_dead_pseudos_local_p (int regno)
+{
+  for (rtx_insn_list *insns = ira_reg_equiv[regno].init_insns;
+       insns != NULL_RTX; insns = insns->next ())
+    {
+      rtx_insn *insn = insns->insn ();
+      bitmap live_in = df_get_live_in (BLOCK_FOR_INSN (insn));
+      subrtx_iterator::array_type array;
+      FOR_EACH_SUBRTX (iter, array, SET_SRC (single_set (insn)), NONCONST)
+	{
+	  const_rtx x = *iter;
+	  if (REG_P (x)
+	      && find_regno_note (insn, REG_DEAD, REGNO (x)) != NULL_RTX
+	      && (HARD_REGISTER_P (x) || bitmap_bit_p (live_in, REGNO (x))))
+	    return false;
+	}
+    }
+  return true;
+}
+
 /* Return TRUE if REGNO has a reverse equivalence.  The equivalence is
    reverse only if we have one init insn with given REGNO as a
    source.  */
@@ -5044,7 +5071,12 @@ lra_constraints (bool first_p)
 		   constant, the right hand side of the init insn can
 		   be a pseudo.  */
 		|| (! reverse_equiv_p (i)
-		    && (init_insn_rhs_dead_pseudo_p (i)
+		    && ((init_insn_rhs_dead_pseudo_p (i)
+			 /* A constant can be rematerialized from scratch
+			    when the pseudos it was built from are local
+			    to the init insns.  */
+			 && (! CONSTANT_P (x)
+			     || ! init_insn_rhs_dead_pseudos_local_p (i)))
 			/* If we reloaded the pseudo in an equivalence
 			   init insn, we cannot remove the equiv init
 			   insns and the init insns might write into
@@ -85,7 +85,9 @@ lto_normalized_zlib_level (void)
 {
   int level = flag_lto_compression_level;
 
-  if (level != Z_DEFAULT_COMPRESSION)
+  if (level == Z_DEFAULT_COMPRESSION && flag_lto_compression_fast)
+    level = Z_BEST_SPEED;
+  else if (level != Z_DEFAULT_COMPRESSION)
     {
       if (level < Z_NO_COMPRESSION)
 	level = Z_NO_COMPRESSION;
@@ -106,6 +108,14 @@ lto_destroy_compression_stream (struct lto_compression_stream *stream)
 }
 
 #ifdef HAVE_ZSTD_H
+/* zstd level used for -flto-compression-fast.  Negative levels trade
+   compression ratio for speed.  */
+#if ZSTD_VERSION_NUMBER >= 10304
+static const int LTO_ZSTD_FAST_LEVEL = -3;
+#else
+static const int LTO_ZSTD_FAST_LEVEL = 1;
+#endif
+
 /* Return a zstd compression level that zstd will not reject.  Normalizes
    the compression level from the command line flag, clamping non-default
    values to the appropriate end of their valid range.  */
@@ -116,13 +126,105 @@ lto_normalized_zstd_level (void)
   int level = flag_lto_compression_level;
 
   if (level < 0)
-    level = 0;
+    level = flag_lto_compression_fast ? LTO_ZSTD_FAST_LEVEL : 0;
   else if (level > ZSTD_maxCLevel ())
     level = ZSTD_maxCLevel ();
 
   return level;
 }
 
+/* Contexts reused for all sections, so that each one does not pay for
+   setting up zstd's tables again.  */
+static ZSTD_CCtx *lto_zstd_cctx;
+static ZSTD_DCtx *lto_zstd_dctx;
+
+/* Digested forms of the -flto-compression-dictionary file.  */
+static ZSTD_CDict *lto_zstd_cdict;
+static ZSTD_DDict *lto_zstd_ddict;
+
+/* Read the -flto-compression-dictionary file into a newly allocated
+   buffer.  Store its size in *SIZE and return the buffer, or return NULL
+   if no dictionary was requested.  */
+
+static char *
+lto_read_zstd_dictionary (size_t *size)
+{
+  FILE *f;
+  char *buf = NULL;
+  size_t alloc = 0, len;
+
+  if (!flag_lto_compression_dictionary)
+    return NULL;
+
+  f = fopen (flag_lto_compression_dictionary, "rb");
+  if (!f)
+    fatal_error (input_location, "cannot open LTO compression dictionary "
+		 "%s: %m", flag_lto_compression_dictionary);
+  *size = 0;
+  do
+    {
+      alloc += 65536;
+      buf = XRESIZEVEC (char, buf, alloc);
+      len = fread (buf + *size, 1, alloc - *size, f);
+      *size += len;
+    }
+  while (len > 0 && *size == alloc);
+  if (ferror (f))
+    fatal_error (input_location, "cannot read LTO compression dictionary "
+		 "%s: %m", flag_lto_compression_dictionary);
+  fclose (f);
+  return buf;
+}
+
+/* Create the zstd compression context, and the compression dictionary
+   if one was given.  */
+
+static void
+lto_init_zstd_compression (void)
+{
+  size_t size;
+  char *dict;
+
+  if (lto_zstd_cctx)
+    return;
+  lto_zstd_cctx = ZSTD_createCCtx ();
+  if (!lto_zstd_cctx)
+    internal_error ("cannot create zstd compression context");
+  if ((dict = lto_read_zstd_dictionary (&size)))
+    {
+      lto_zstd_cdict = ZSTD_createCDict (dict, size,
+					 lto_normalized_zstd_level ());
+      if (!lto_zstd_cdict)
+	fatal_error (input_location, "invalid LTO compression dictionary %s",
+		     flag_lto_compression_dictionary);
+      free (dict);
+    }
+}
+
+/* Create the zstd decompression context, and the decompression
+   dictionary if one was given.  */
+
+static void
+lto_init_zstd_uncompression (void)
+{
+  size_t size;
+  char *dict;
+
+  if (lto_zstd_dctx)
+    return;
+  lto_zstd_dctx = ZSTD_createDCtx ();
+  if (!lto_zstd_dctx)
+    internal_error ("cannot create zstd decompression context");
+  if ((dict = lto_read_zstd_dictionary (&size)))
+    {
+      lto_zstd_ddict = ZSTD_createDDict (dict, size);
+      if (!lto_zstd_ddict)
+	fatal_error (input_location, "invalid LTO compression dictionary %s",
+		     flag_lto_compression_dictionary);
+      free (dict);
+    }
+}
+
 /* Compress STREAM using ZSTD algorithm.  */
 
 static void
@@ -132,11 +234,16 @@ lto_compression_zstd (struct lto_compression_stream *stream)
   size_t size = stream->bytes;
 
   timevar_push (TV_IPA_LTO_COMPRESS);
+  lto_init_zstd_compression ();
   size_t const outbuf_length = ZSTD_compressBound (size);
   char *outbuf = (char *) xmalloc (outbuf_length);
 
-  size_t const csize = ZSTD_compress (outbuf, outbuf_length, cursor, size,
-				      lto_normalized_zstd_level ());
+  size_t const csize
+    = (lto_zstd_cdict
+       ? ZSTD_compress_usingCDict (lto_zstd_cctx, outbuf, outbuf_length,
+				   cursor, size, lto_zstd_cdict)
+       : ZSTD_compressCCtx (lto_zstd_cctx, outbuf, outbuf_length, cursor,
+			    size, lto_normalized_zstd_level ()));
 
   if (ZSTD_isError (csize))
     internal_error ("compressed stream: %s", ZSTD_getErrorName (csize));
@@ -158,18 +265,32 @@ lto_uncompression_zstd (struct lto_compression_stream *stream)
   size_t size = stream->bytes;
 
   timevar_push (TV_IPA_LTO_DECOMPRESS);
+  lto_init_zstd_uncompression ();
   unsigned long long const rsize = ZSTD_getFrameContentSize (cursor, size);
   if (rsize == ZSTD_CONTENTSIZE_ERROR)
     internal_error ("original not compressed with zstd");
   else if (rsize == ZSTD_CONTENTSIZE_UNKNOWN)
     internal_error ("original size unknown");
 
+  if (ZSTD_getDictID_fromFrame (cursor, size) != 0 && !lto_zstd_ddict)
+    fatal_error (input_location, "LTO IL was compressed with a dictionary; "
+		 "use %<-flto-compression-dictionary=%> to read it");
+
   char *outbuf = (char *) xmalloc (rsize);
-  size_t const dsize = ZSTD_decompress (outbuf, rsize, cursor, size);
+  size_t const dsize
+    = (lto_zstd_ddict
+       ? ZSTD_decompress_usingDDict (lto_zstd_dctx, outbuf, rsize, cursor,
+				     size, lto_zstd_ddict)
+       : ZSTD_decompressDCtx (lto_zstd_dctx, outbuf, rsize, cursor, size));
 
   if (ZSTD_isError (dsize))
     internal_error ("decompressed stream: %s", ZSTD_getErrorName (dsize));
 
+  /* Drop the copy of the compressed input before the callback makes its
+     own copy of the output.  */
+  free (stream->buffer);
+  stream->buffer = NULL;
+
   lto_stats.num_uncompressed_il_bytes += dsize;
   stream->callback (outbuf, dsize, stream->opaque);
 
@@ -170,6 +170,17 @@ lto_get_section_data (struct lto_file_decl_data *file_data,
 
       *len = buffer.length - header_length;
       data = buffer.data + header_length;
+
+      /* Nothing refers to the compressed data any more; release it now
+	 rather than when the section is freed, so that it does not stay
+	 mapped for as long as the uncompressed copy is in use.  */
+      if (free_section_f)
+	{
+	  header = (struct lto_data_header *) buffer.data;
+	  (free_section_f) (file_data, section_type, name, header->data,
+			    header->len);
+	  header->data = NULL;
+	}
     }
 
   return data;
@@ -223,8 +234,11 @@ lto_free_section_data (struct lto_file_decl_data *file_data,
     }
 
   /* The underlying data address has been extracted from the mapping header.
-     Free that, then free the allocated uncompression buffer.  */
-  (free_section_f) (file_data, section_type, name, header->data, header->len);
+     Free that unless lto_get_section_data already did, then free the
+     allocated uncompression buffer.  */
+  if (header->data)
+    (free_section_f) (file_data, section_type, name, header->data,
+		      header->len);
   free (CONST_CAST (char *, real_data));
 }
 
@@ -48,6 +48,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "simple-object.h"
 #include "lto-section-names.h"
 #include "collect-utils.h"
+#include "md5.h"
 
 /* Environment variable, used for passing the names of offload targets from GCC
    driver to lto-wrapper.  */
@@ -78,6 +79,8 @@ static char **output_names;
 static char **offload_names;
 static char *offload_objects_file_name;
 static char *makefile;
+/* Directory in which LTRANS objects are cached, from -flto-incremental=.  */
+static const char *ltrans_cache_dir;
 static unsigned int num_deb_objs;
 static const char **early_debug_object_names;
 static bool xassembler_options_error = false;
@@ -105,7 +108,8 @@ tool_cleanup (bool)
 	maybe_unlink (early_debug_object_names[i]);
   for (i = 0; i < nr; ++i)
     {
-      maybe_unlink (input_names[i]);
+      if (input_names[i])
+	maybe_unlink (input_names[i]);
       if (output_names[i])
 	maybe_unlink (output_names[i]);
     }
@@ -776,6 +780,7 @@ append_linker_options (obstack *argv_obstack, struct cl_decoded_option *opts,
 	case OPT_o:
 	case OPT_flto_:
 	case OPT_flto:
+	case OPT_flto_incremental_:
 	  /* We've handled these LTO options, do not pass them on.  */
 	  continue;
 
@@ -1023,6 +1028,108 @@ copy_file (const char *dest, const char *src)
   fclose (s);
 }
 
+/* Copy the rest of stream S to stream D.  Return false on error.  */
+
+static bool
+copy_stream (FILE *d, FILE *s)
+{
+  char buffer[4096];
+  size_t len;
+
+  while ((len = fread (buffer, 1, sizeof (buffer), s)) > 0)
+    if (fwrite (buffer, 1, len, d) != len)
+      return false;
+  return !ferror (s);
+}
+
+/* Return the name of the file in the LTRANS cache for the unit INPUT_NAME
+   compiled by the first ARGC arguments of ARGV, or NULL if no cache is in
+   use.  The name is the MD5 digest of the unit's bytecode and of the
+   command line, which together determine the LTRANS output.  */
+
+static char *
+ltrans_cache_entry (const char *input_name, const char **argv, int argc)
+{
+  struct md5_ctx ctx;
+  unsigned char digest[16];
+  char hex[2 * sizeof (digest) + 1];
+  char buffer[4096];
+  size_t len;
+  FILE *f;
+
+  if (!ltrans_cache_dir)
+    return NULL;
+
+  f = fopen (input_name, "rb");
+  if (!f)
+    return NULL;
+
+  md5_init_ctx (&ctx);
+  for (int i = 0; i < argc; i++)
+    md5_process_bytes (argv[i], strlen (argv[i]) + 1, &ctx);
+  while ((len = fread (buffer, 1, sizeof (buffer), f)) > 0)
+    md5_process_bytes (buffer, len, &ctx);
+  fclose (f);
+  md5_finish_ctx (&ctx, digest);
+
+  for (unsigned i = 0; i < sizeof (digest); i++)
+    sprintf (hex + 2 * i, "%02x", digest[i]);
+  return concat (ltrans_cache_dir, "/", hex, ".ltrans.o", NULL);
+}
+
+/* Copy the cached LTRANS object ENTRY to OUTPUT_NAME.  Return true if
+   ENTRY was in the cache.  */
+
+static bool
+ltrans_cache_fetch (const char *entry, const char *output_name)
+{
+  FILE *s, *d;
+
+  if (!entry || !(s = fopen (entry, "rb")))
+    return false;
+
+  d = fopen (output_name, "wb");
+  if (!d)
+    fatal_error (input_location, "cannot open %s: %m", output_name);
+  if (!copy_stream (d, s) || fclose (d))
+    fatal_error (input_location, "writing %s: %m", output_name);
+  fclose (s);
+
+  if (verbose)
+    fprintf (stderr, "[Reusing cached LTRANS %s]\n", entry);
+  return true;
+}
+
+/* Store the LTRANS object OUTPUT_NAME in the cache as ENTRY.  Failing to
+   do so is not an error; the unit is just compiled again next time.  */
+
+static void
+ltrans_cache_store (const char *entry, const char *output_name)
+{
+  char suffix[32];
+  char *temp;
+  FILE *s, *d;
+  bool ok;
+
+  if (!entry || !(s = fopen (output_name, "rb")))
+    return;
+
+  /* Write under a private name and rename it into place, so that
+     concurrent links never see a partial object.  */
+  snprintf (suffix, sizeof (suffix), ".%ld", (long) getpid ());
+  temp = concat (entry, suffix, NULL);
+  d = fopen (temp, "wb");
+  if (d)
+    {
+      ok = copy_stream (d, s);
+      ok &= fclose (d) == 0;
+      if (!ok || rename (temp, entry) != 0)
+	unlink (temp);
+    }
+  fclose (s);
+  free (temp);
+}
+
 /* Find the crtoffloadtable.o file in LIBRARY_PATH, make copy and pass name of
    the copy to the linker.  */
 
@@ -1355,6 +1462,166 @@ make_exists (void)
   return errmsg == NULL && exit_status == 0 && err == 0;
 }
 
+/* Read one entry of a list of LTRANS units from STREAM, which is called
+   NAME in diagnostics.  Each entry is a number on one line followed by a
+   file name on the next.  Store them in *NUM and *INPUT_NAME and return
+   true, or return false at the end of the list.  */
+
+static bool
+read_ltrans_entry (FILE *stream, const char *name, int *num,
+		   char **input_name)
+{
+  const unsigned piece = 32;
+  char *buf, *filename;
+  size_t len;
+
+  if (fscanf (stream, "%i\n", num) != 1)
+    {
+      if (!feof (stream))
+	fatal_error (input_location, "corrupted ltrans output file %s", name);
+      return false;
+    }
+
+  filename = (char *)xmalloc (piece);
+  buf = filename;
+  for (;;)
+    {
+      if (!fgets (buf, piece, stream))
+	{
+	  free (filename);
+	  return false;
+	}
+      len = strlen (filename);
+      if (filename[len - 1] == '\n')
+	break;
+      filename = (char *)xrealloc (filename, len + piece);
+      buf = filename + len;
+    }
+  filename[len - 1] = '\0';
+  *input_name = filename;
+  return true;
+}
+
+/* An LTRANS compilation started by run_streamed_ltrans.  */
+
+struct ltrans_job
+{
+  struct pex_obj *pex;
+  char *input_name;
+  char *output_name;
+  char *cache_entry;
+};
+
+/* Wait for the LTRANS compilation JOB, run by PROG, to finish, store its
+   output in the cache and remove its input file.  */
+
+static void
+wait_for_ltrans_job (const char *prog, struct ltrans_job *job)
+{
+  do_wait (prog, job->pex);
+  ltrans_cache_store (job->cache_entry, job->output_name);
+  free (job->cache_entry);
+  maybe_unlink (job->input_name);
+  job->pex = NULL;
+}
+
+/* Run the WPA command in NEW_ARGV, which must include -fltrans-stream, and
+   start an LTRANS compilation for each unit as soon as WPA reports that
+   it has been written, rather than once the whole partitioning is done.
+   At most PARALLEL compilations run at once.  ARGV_PTR points to the part
+   of NEW_ARGV that is replaced by the per-unit LTRANS arguments.  Units
+   found in the LTRANS cache are not compiled at all.  Record
+   the units in INPUT_NAMES and OUTPUT_NAMES, indexed by partition, so that
+   the link order does not depend on which job finished first.  */
+
+static void
+run_streamed_ltrans (const char **new_argv, const char **argv_ptr,
+		     long parallel)
+{
+  struct ltrans_job *jobs = XCNEWVEC (struct ltrans_job, parallel);
+  struct pex_obj *wpa;
+  unsigned next_job = 0, i;
+  int part;
+  char *input_name;
+  FILE *stream;
+
+  wpa = collect_execute (new_argv[0], CONST_CAST (char **, new_argv), NULL,
+			 NULL, PEX_SEARCH, true, "ltrans_args");
+  stream = pex_read_output (wpa, 0);
+  if (!stream)
+    fatal_error (input_location, "cannot read WPA output: %m");
+
+  while (read_ltrans_entry (stream, "from WPA", &part, &input_name))
+    {
+      if (part < 0
+	  || ((unsigned) part < nr && input_names[part] != NULL))
+	fatal_error (input_location, "corrupted ltrans output from WPA");
+      if ((unsigned) part >= nr)
+	{
+	  input_names = XRESIZEVEC (char *, input_names, part + 1);
+	  output_names = XRESIZEVEC (char *, output_names, part + 1);
+	  for (i = nr; i <= (unsigned) part; i++)
+	    input_names[i] = output_names[i] = NULL;
+	  nr = part + 1;
+	}
+
+      /* Replace the .o suffix with a .ltrans.o suffix.  */
+      size_t len = strlen (input_name) - 2;
+      char *output_name = XNEWVEC (char, len + sizeof (".ltrans.o"));
+      memcpy (output_name, input_name, len);
+      memcpy (output_name + len, ".ltrans.o", sizeof (".ltrans.o"));
+      input_names[part] = input_name;
+      output_names[part] = output_name;
+
+      int dumpbase_len = (strlen (dumppfx) + sizeof (DUMPBASE_SUFFIX));
+      char *dumpbase = (char *) xmalloc (dumpbase_len + 1);
+      snprintf (dumpbase, dumpbase_len, "%sltrans%u.ltrans", dumppfx,
+		(unsigned) part);
+      argv_ptr[0] = dumpbase;
+      argv_ptr[1] = "-fltrans";
+      argv_ptr[2] = "-o";
+      argv_ptr[3] = output_name;
+      argv_ptr[4] = input_name;
+      argv_ptr[5] = NULL;
+
+      char *cache_entry = ltrans_cache_entry (input_name, new_argv,
+					      argv_ptr - new_argv);
+      if (ltrans_cache_fetch (cache_entry, output_name))
+	{
+	  free (cache_entry);
+	  maybe_unlink (input_name);
+	  continue;
+	}
+
+      /* Keep at most PARALLEL jobs running, retiring the oldest first.  */
+      if (jobs[next_job].pex)
+	wait_for_ltrans_job (new_argv[0], &jobs[next_job]);
+
+      /* The WPA response file has been read by now, so the LTRANS
+	 command lines can be passed directly.  */
+      jobs[next_job].pex
+	= collect_execute (new_argv[0], CONST_CAST (char **, new_argv), NULL,
+			   NULL, PEX_LAST | PEX_SEARCH, false, NULL);
+      jobs[next_job].input_name = input_name;
+      jobs[next_job].output_name = output_name;
+      jobs[next_job].cache_entry = cache_entry;
+      next_job = (next_job + 1) % parallel;
+    }
+
+  do_wait (new_argv[0], wpa);
+  for (i = 0; i < parallel; i++)
+    {
+      unsigned j = (next_job + i) % parallel;
+      if (jobs[j].pex)
+	wait_for_ltrans_job (new_argv[0], &jobs[j]);
+    }
+  free (jobs);
+
+  for (i = 0; i < nr; i++)
+    if (!input_names[i])
+      fatal_error (input_location, "WPA did not report LTRANS unit %u", i);
+}
+
 /* Execute gcc. ARGC is the number of arguments. ARGV contains the arguments. */
 
 static void
@@ -1370,6 +1637,7 @@ run_gcc (unsigned argc, char *argv[])
   int parallel = 0;
   int jobserver = 0;
   int auto_parallel = 0;
+  bool stream_ltrans = false;
   bool no_partition = false;
   struct cl_decoded_option *fdecoded_options = NULL;
   struct cl_decoded_option *offload_fdecoded_options = NULL;
@@ -1540,6 +1808,10 @@ run_gcc (unsigned argc, char *argv[])
 	  lto_mode = LTO_MODE_WHOPR;
 	  break;
 
+	case OPT_flto_incremental_:
+	  ltrans_cache_dir = option->arg;
+	  break;
+
 	case OPT_flinker_output_:
 	  linker_output_rel = !strcmp (option->arg, "rel");
 	  break;
@@ -1595,8 +1867,13 @@ run_gcc (unsigned argc, char *argv[])
 	}
     }
 
+  /* Without a jobserver to cooperate with, run the LTRANS compilations
+     directly as WPA writes the units; make is only needed otherwise.  */
+  if (parallel && !jobserver && lto_mode == LTO_MODE_WHOPR)
+    stream_ltrans = true;
+
   /* We need make working for a parallel execution.  */
-  if (parallel && !make_exists ())
+  else if (parallel && !make_exists ())
     parallel = 0;
 
   if (!dumppfx)
@@ -1796,6 +2073,9 @@ cont1:
 	}
       else
         obstack_ptr_grow (&argv_obstack, "-fwpa");
+
+      if (stream_ltrans)
+	obstack_ptr_grow (&argv_obstack, "-fltrans-stream");
     }
 
   /* Append input arguments.  */
@@ -1808,8 +2088,12 @@ cont1:
 
   new_argv = XOBFINISH (&argv_obstack, const char **);
   argv_ptr = &new_argv[new_head_argc];
-  fork_execute (new_argv[0], CONST_CAST (char **, new_argv), true,
-		"ltrans_args");
+  if (stream_ltrans)
+    run_streamed_ltrans (new_argv, argv_ptr,
+			 auto_parallel ? nthreads_var : parallel);
+  else
+    fork_execute (new_argv[0], CONST_CAST (char **, new_argv), true,
+		  "ltrans_args");
 
   /* Copy the early generated debug info from the objects to temporary
      files and append those to the partial link commandline.  */
@@ -1845,6 +2129,31 @@ cont1:
       free (early_debug_object_names);
       early_debug_object_names = NULL;
     }
+  else if (stream_ltrans)
+    {
+      /* The LTRANS units have all been compiled already.  */
+      maybe_unlink (ltrans_output_file);
+      ltrans_output_file = NULL;
+      for (i = 0; i < nr; ++i)
+	{
+	  fputs (output_names[i], stdout);
+	  putc ('\n', stdout);
+	  free (input_names[i]);
+	}
+      if (!skip_debug)
+	{
+	  for (i = 0; i < ltoobj_argc; ++i)
+	    if (early_debug_object_names[i] != NULL)
+	      printf ("%s\n", early_debug_object_names[i]);
+	}
+      nr = 0;
+      free (output_names);
+      output_names = NULL;
+      free (early_debug_object_names);
+      early_debug_object_names = NULL;
+      free (input_names);
+      free (list_option_full);
+    }
   else
     {
       FILE *stream = fopen (ltrans_output_file, "r");
@@ -1858,33 +2167,11 @@ cont1:
       /* Parse the list of LTRANS inputs from the WPA stage.  */
       obstack_init (&env_obstack);
       nr = 0;
-      for (;;)
+      char *input_name;
+      while (read_ltrans_entry (stream, ltrans_output_file, &priority,
+				&input_name))
 	{
-	  const unsigned piece = 32;
 	  char *output_name = NULL;
-	  char *buf, *input_name = (char *)xmalloc (piece);
-	  size_t len;
-
-	  buf = input_name;
-          if (fscanf (stream, "%i\n", &priority) != 1)
-	    {
-	      if (!feof (stream))
-	        fatal_error (input_location,
-		             "corrupted ltrans output file %s",
-			     ltrans_output_file);
-	      break;
-	    }
-cont:
-	  if (!fgets (buf, piece, stream))
-	    break;
-	  len = strlen (input_name);
-	  if (input_name[len - 1] != '\n')
-	    {
-	      input_name = (char *)xrealloc (input_name, len + piece);
-	      buf = input_name + len;
-	      goto cont;
-	    }
-	  input_name[len - 1] = '\0';
 
 	  if (input_name[0] == '*')
 	    output_name = &input_name[1];
@@ -1912,6 +2199,7 @@ cont:
 
       /* Execute the LTRANS stage for each input file (or prepare a
 	 makefile to invoke this in parallel).  */
+      char **cache_entries = XCNEWVEC (char *, nr);
       for (i = 0; i < nr; ++i)
 	{
 	  char *output_name;
@@ -1937,7 +2225,19 @@ cont:
 	  argv_ptr[3] = output_name;
 	  argv_ptr[4] = input_name;
 	  argv_ptr[5] = NULL;
-	  if (parallel)
+
+	  /* Reuse the object from an earlier link if the unit and the
+	     command line are unchanged.  */
+	  cache_entries[i] = ltrans_cache_entry (input_name, new_argv,
+						 new_head_argc);
+	  if (ltrans_cache_fetch (cache_entries[i], output_name))
+	    {
+	      free (cache_entries[i]);
+	      cache_entries[i] = NULL;
+	      if (!parallel)
+		maybe_unlink (input_name);
+	    }
+	  else if (parallel)
 	    {
 	      fprintf (mstream, "%s:\n\t@%s ", output_name, new_argv[0]);
 	      for (j = 1; new_argv[j] != NULL; ++j)
@@ -1959,6 +2259,7 @@ cont:
 			  "ltrans%u.ltrans_args", i);
 	      fork_execute (new_argv[0], CONST_CAST (char **, new_argv),
 			    true, save_temps ? argsuffix : NULL);
+	      ltrans_cache_store (cache_entries[i], output_name);
 	      maybe_unlink (input_name);
 	    }
 
@@ -2015,14 +2316,19 @@ cont:
 	  maybe_unlink (makefile);
 	  makefile = NULL;
 	  for (i = 0; i < nr; ++i)
-	    maybe_unlink (input_names[i]);
+	    {
+	      ltrans_cache_store (cache_entries[i], output_names[i]);
+	      maybe_unlink (input_names[i]);
+	    }
 	}
       for (i = 0; i < nr; ++i)
 	{
 	  fputs (output_names[i], stdout);
 	  putc ('\n', stdout);
 	  free (input_names[i]);
+	  free (cache_entries[i]);
 	}
+      free (cache_entries);
       if (!skip_debug)
 	{
 	  for (i = 0; i < ltoobj_argc; ++i)
@@ -2347,6 +2347,11 @@ lto_file_read (lto_file *file, FILE *resolution_file, int *count)
 static size_t page_mask;
 #endif
 
+#if LTO_MMAP_IO && defined (HAVE_MADVISE) && HAVE_DECL_MADVISE \
+    && defined (MADV_WILLNEED)
+#define LTO_PREFETCH_IO 1
+#endif
+
 /* Get the section data of length LEN from FILENAME starting at
    OFFSET.  The data segment must be freed by the caller when the
    caller is finished.  Returns NULL if all was not well.  */
@@ -2406,6 +2411,12 @@ lto_read_section_data (struct lto_file_decl_data *file_data,
       return NULL;
     }
 
+#if LTO_PREFETCH_IO
+  /* Sections are read in full, so fault them in with one large read
+     rather than page by page.  */
+  madvise (result, computed_len, MADV_WILLNEED);
+#endif
+
   return result + diff;
 #else
   result = (char *) xmalloc (len);
@@ -2430,6 +2441,73 @@ lto_read_section_data (struct lto_file_decl_data *file_data,
 }
 
 
+/* Ask the operating system to start reading the object file FILENAME,
+   which may name an archive member as FILE@OFFSET, in the background.
+   This lets the I/O for the next input file overlap with merging the
+   decls of the current one.  */
+
+static void
+lto_prefetch_file (const char *filename)
+{
+#if LTO_PREFETCH_IO
+  static char *last_prefetched;
+  const char *offset_p;
+  long loffset = 0;
+  int consumed;
+  char *fname;
+  struct stat st;
+  int fd;
+
+  offset_p = strrchr (filename, '@');
+  if (offset_p != NULL
+      && offset_p != filename
+      && sscanf (offset_p, "@%li%n", &loffset, &consumed) >= 1
+      && strlen (offset_p) == (unsigned int) consumed)
+    fname = xstrndup (filename, offset_p - filename);
+  else
+    {
+      fname = xstrdup (filename);
+      loffset = 0;
+    }
+
+  /* Members of one archive are usually listed together; the first
+     request covers the rest of the archive.  */
+  if (last_prefetched && filename_cmp (fname, last_prefetched) == 0)
+    {
+      free (fname);
+      return;
+    }
+  free (last_prefetched);
+  last_prefetched = fname;
+
+  fd = open (fname, O_RDONLY|O_BINARY);
+  if (fd == -1)
+    return;
+
+  if (!page_mask)
+    {
+      size_t page_size = sysconf (_SC_PAGE_SIZE);
+      page_mask = ~(page_size - 1);
+    }
+
+  if (fstat (fd, &st) == 0 && loffset >= 0 && loffset < st.st_size)
+    {
+      intptr_t computed_offset = loffset & page_mask;
+      size_t len = st.st_size - computed_offset;
+      void *map = mmap (NULL, len, PROT_READ, MAP_PRIVATE, fd,
+			computed_offset);
+      if (map != MAP_FAILED)
+	{
+	  madvise (map, len, MADV_WILLNEED);
+	  munmap (map, len);
+	}
+    }
+  close (fd);
+#else
+  (void) filename;
+#endif
+}
+
 /* Get the section data from FILE_DATA of SECTION_TYPE with NAME.
    NAME will be NULL unless the section type is for a function
    body.  */
@@ -2781,6 +2859,9 @@ read_cgraph_and_symbols (unsigned nfiles, const char **fnames)
       if (!current_lto_file)
 	break;
 
+      if (i + 1 < nfiles)
+	lto_prefetch_file (fnames[i + 1]);
+
       file_data = lto_file_read (current_lto_file, resolution, &count);
       if (!file_data)
 	{
@@ -429,12 +429,210 @@ account_reference_p (symtab_node *n1, symtab_node *n2)
 }
 
 
+/* A cluster of functions laid out next to each other by
+   lto_layout_functions.  */
+
+struct layout_cluster
+{
+  vec<cgraph_node *> nodes;
+  int64_t size;
+  gcov_type count;
+};
+
+/* Return the number of profiled calls per unit of size of cluster C.  */
+
+static double
+layout_cluster_density (const layout_cluster *c)
+{
+  return (double) c->count / MAX (c->size, 1);
+}
+
+/* Helper function for qsort; sort clusters by decreasing density and
+   otherwise keep the order of their first functions.  */
+
+static int
+layout_cluster_cmp (const void *pa, const void *pb)
+{
+  const layout_cluster *a = *static_cast<const layout_cluster * const *> (pa);
+  const layout_cluster *b = *static_cast<const layout_cluster * const *> (pb);
+  double da = layout_cluster_density (a), db = layout_cluster_density (b);
+
+  if (da != db)
+    return da > db ? -1 : 1;
+  return a->nodes[0]->order - b->nodes[0]->order;
+}
+
+/* Helper function for qsort; sort functions by decreasing profile count
+   and otherwise by order.  */
+
+static int
+layout_node_cmp (const void *pa, const void *pb)
+{
+  const cgraph_node *a = *static_cast<const cgraph_node * const *> (pa);
+  const cgraph_node *b = *static_cast<const cgraph_node * const *> (pb);
+  gcov_type ca = a->count.ipa ().to_gcov_type ();
+  gcov_type cb = b->count.ipa ().to_gcov_type ();
+
+  if (ca != cb)
+    return ca > cb ? -1 : 1;
+  return a->order - b->order;
+}
+
+/* Add the profiled calls to NODE, which is either the function whose
+   callers are being collected or one of its aliases, to the counts per
+   calling function in DATA.  */
+
+static bool
+layout_collect_callers (cgraph_node *node, void *data)
+{
+  hash_map<cgraph_node *, gcov_type> *callers
+    = static_cast<hash_map<cgraph_node *, gcov_type> *> (data);
+
+  for (cgraph_edge *e = node->callers; e; e = e->next_caller)
+    {
+      profile_count count = e->count.ipa ();
+      if (!e->inline_failed || !count.nonzero_p ())
+	continue;
+      cgraph_node *caller = e->caller->inlined_to
+			    ? e->caller->inlined_to : e->caller;
+      callers->get_or_insert (caller) += count.to_gcov_type ();
+    }
+  return false;
+}
+
+/* Compute the order in which the profiled functions are output, using
+   the C3 heuristic of Ottoni and Maher: taking the functions from the
+   hottest down, append the cluster of each to the cluster of its most
+   frequent caller unless that would make it larger than
+   param_lto_max_layout_cluster_size, and then order the clusters by
+   decreasing density of calls.  The result goes into the layout_order
+   of the functions, which both the partitioning and the expansion of
+   each partition follow, so that callers and their callees end up next
+   to each other in the final output.  */
+
+void
+lto_layout_functions (void)
+{
+  auto_vec<cgraph_node *> funcs;
+  auto_vec<layout_cluster *> clusters;
+  hash_map<cgraph_node *, layout_cluster *> cluster_of;
+  cgraph_node *node;
+  unsigned i;
+
+  FOR_EACH_DEFINED_FUNCTION (node)
+    if (node->get_partitioning_class () == SYMBOL_PARTITION
+	&& !node->alias
+	&& !node->inlined_to
+	&& !node->no_reorder
+	&& opt_for_fn (node->decl, flag_profile_reorder_functions)
+	&& node->count.ipa ().nonzero_p ())
+      {
+	layout_cluster *c = XNEW (layout_cluster);
+	c->nodes = vNULL;
+	c->nodes.safe_push (node);
+	c->size = MAX (ipa_size_summaries->get (node)->size, 1);
+	c->count = node->count.ipa ().to_gcov_type ();
+	cluster_of.put (node, c);
+	funcs.safe_push (node);
+      }
+
+  if (funcs.is_empty ())
+    return;
+
+  funcs.qsort (layout_node_cmp);
+  FOR_EACH_VEC_ELT (funcs, i, node)
+    {
+      hash_map<cgraph_node *, gcov_type> callers;
+      node->call_for_symbol_and_aliases (layout_collect_callers, &callers,
+					 true);
+
+      cgraph_node *best = NULL;
+      gcov_type best_count = 0;
+      for (hash_map<cgraph_node *, gcov_type>::iterator it = callers.begin ();
+	   it != callers.end (); ++it)
+	if ((*it).second > best_count
+	    || ((*it).second == best_count && best
+		&& (*it).first->order < best->order))
+	  {
+	    best = (*it).first;
+	    best_count = (*it).second;
+	  }
+      if (!best)
+	continue;
+
+      layout_cluster **pred = cluster_of.get (best);
+      layout_cluster *c = *cluster_of.get (node);
+      if (!pred
+	  || *pred == c
+	  || (*pred)->size + c->size > param_lto_max_layout_cluster_size)
+	continue;
+
+      layout_cluster *p = *pred;
+      for (unsigned j = 0; j < c->nodes.length (); j++)
+	{
+	  p->nodes.safe_push (c->nodes[j]);
+	  cluster_of.put (c->nodes[j], p);
+	}
+      p->size += c->size;
+      p->count += c->count;
+      c->nodes.release ();
+      XDELETE (c);
+    }
+
+  /* Every function is in the cluster that the map gives for it, and
+     the first function of a cluster is the only one to start it.  */
+  FOR_EACH_VEC_ELT (funcs, i, node)
+    {
+      layout_cluster *c = *cluster_of.get (node);
+      if (c->nodes[0] == node)
+	clusters.safe_push (c);
+    }
+  clusters.qsort (layout_cluster_cmp);
+
+  int layout_order = 0;
+  layout_cluster *c;
+  FOR_EACH_VEC_ELT (clusters, i, c)
+    {
+      if (dump_file)
+	fprintf (dump_file, "Layout cluster %u: size %" PRId64
+		 ", count %" PRId64 "\n", i, c->size, (int64_t) c->count);
+      for (unsigned j = 0; j < c->nodes.length (); j++)
+	{
+	  c->nodes[j]->layout_order = ++layout_order;
+	  if (dump_file)
+	    fprintf (dump_file, "  %s\n", c->nodes[j]->dump_name ());
+	}
+      c->nodes.release ();
+      XDELETE (c);
+    }
+}
+
+/* Return the weight of call EDGE in the boundary cost computed by
+   lto_balanced_map.  This is the frequency of EDGE relative to the entry
+   of its caller plus, when the program was profiled, its IPA count scaled
+   so that the hottest call, of count MAX_COUNT, adds CGRAPH_FREQ_MAX.
+   Splitting the hot part of the call graph then costs far more than
+   splitting cold calls that happen to be frequent within their caller.  */
+
+static int
+partition_edge_cost (cgraph_edge *edge, gcov_type max_count)
+{
+  int cost = MAX (edge->frequency (), 1);
+  profile_count count = edge->count.ipa ();
+
+  if (max_count > 0 && count.nonzero_p ())
+    cost += (sreal (MIN (count.to_gcov_type (), max_count))
+	     * CGRAPH_FREQ_MAX / sreal (max_count)).to_int ();
+  return cost;
+}
+
 /* Group cgraph nodes into equally-sized partitions.
 
    The partitioning algorithm is simple: nodes are taken in predefined order.
    The order corresponds to the order we want functions to have in the final
-   output.  In the future this will be given by function reordering pass, but
-   at the moment we use the topological order, which is a good approximation.
+   output: the one computed by lto_layout_functions for the functions that
+   have a profile, followed by the others in the topological order, which
+   is a good approximation.
 
    The goal is to partition this linear order into intervals (partitions) so
    that all the partitions have approximately the same size and the number of
@@ -465,7 +663,9 @@ account_reference_p (symtab_node *n1, symtab_node *n2)
    edges going to other partitions) and continue adding functions until after
    the current partition has grown to twice the expected partition size.  Then
    the process is undone to the point where the minimal ratio of boundary size
-   and in-partition calls was reached.  */
+   and in-partition calls was reached.  Calls are weighted by
+   partition_edge_cost, so with profile feedback the boundary avoids the
+   hot calls.  */
 
 void
 lto_balanced_map (int n_lto_partitions, int max_partition_size)
@@ -487,6 +687,7 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
   int npartitions;
   int current_order = -1;
   int noreorder_pos = 0;
+  gcov_type max_count = 0;
 
   FOR_EACH_VARIABLE (vnode)
     gcc_assert (!vnode->aux);
@@ -494,6 +695,9 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
   FOR_EACH_DEFINED_FUNCTION (node)
     if (node->get_partitioning_class () == SYMBOL_PARTITION)
       {
+	for (cgraph_edge *e = node->callees; e; e = e->next_callee)
+	  if (e->inline_failed && e->count.ipa ().nonzero_p ())
+	    max_count = MAX (max_count, e->count.ipa ().to_gcov_type ());
 	if (node->no_reorder)
 	  noreorder.safe_push (node);
 	else
@@ -602,11 +806,9 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 		if (edge->inline_failed
 		    && account_reference_p (node, edge->callee))
 		  {
-		    int edge_cost = edge->frequency ();
+		    int edge_cost = partition_edge_cost (edge, max_count);
 		    int index;
 
-		    if (!edge_cost)
-		      edge_cost = 1;
 		    gcc_assert (edge_cost > 0);
 		    index = lto_symtab_encoder_lookup (partition->encoder,
 						       edge->callee);
@@ -620,12 +822,10 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 		if (edge->inline_failed
 		    && account_reference_p (edge->caller, node))
 		{
-		  int edge_cost = edge->frequency ();
+		  int edge_cost = partition_edge_cost (edge, max_count);
 		  int index;
 
 		  gcc_assert (edge->caller->definition);
-		  if (!edge_cost)
-		    edge_cost = 1;
 		  gcc_assert (edge_cost > 0);
 		  index = lto_symtab_encoder_lookup (partition->encoder,
 						     edge->caller);
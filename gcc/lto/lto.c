@@ -217,6 +217,14 @@ stream_out_partitions_1 (char *temp_filename, int blen, int min, int max)
        sprintf (temp_filename + blen, "%u.o", p);
        stream_out (temp_filename, ltrans_partitions[p]->encoder, p);
        ltrans_partitions[p]->encoder = NULL;
+       /* Let lto-wrapper start compiling the unit right away.  Each
+	  entry is written in one go so that entries from parallel
+	  streaming processes do not interleave.  */
+       if (flag_ltrans_stream)
+	 {
+	   printf ("%u\n%s\n", p, temp_filename);
+	   fflush (stdout);
+	 }
      }
 }
 
@@ -489,6 +497,7 @@ do_whole_program_analysis (void)
 
   symtab_node::checking_verify_symtab_nodes ();
   bitmap_obstack_release (NULL);
+  lto_layout_functions ();
   if (flag_lto_partition == LTO_PARTITION_1TO1)
     lto_1_to_1_map ();
   else if (flag_lto_partition == LTO_PARTITION_MAX)
@@ -1109,6 +1109,16 @@ finish_options (struct gcc_options *opts, struct gcc_options *opts_set,
   if (opts->x_flag_reorder_blocks_and_partition)
     SET_OPTION_IF_UNSET (opts, opts_set, flag_reorder_functions, 1);
 
+  /* Continuous-mode profiling maps only the edge counters into the
+     profile file; value profiles still need the merge at exit.  */
+  if (opts->x_flag_profile_continuous)
+    {
+      if (opts_set->x_flag_profile_values && opts->x_flag_profile_values)
+	error_at (loc, "%<-fprofile-continuous%> is not supported with "
+		  "%<-fprofile-values%>");
+      opts->x_flag_profile_values = 0;
+    }
+
   /* The -gsplit-dwarf option requires -ggnu-pubnames.  */
   if (opts->x_dwarf_split_debug_info)
     opts->x_debug_generate_pub_sections = 2;
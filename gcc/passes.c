@@ -1990,6 +1990,111 @@ pass_manager::dump_profile_report () const
   dump_end (TDI_profile_report, dump_file);
 }
 
+/* Memory use of one pass, for -fmem-report-passes.  */
+
+struct pass_mem_record
+{
+  /* The number of times the pass ran.  */
+  unsigned runs;
+
+  /* The GGC memory allocated by the pass.  */
+  size_t ggc;
+
+  /* The largest growth of the heap during one run of the pass.  */
+  size_t heap;
+
+  /* The growth of the peak RSS of the process while the pass ran.  */
+  size_t peak_rss;
+};
+
+static struct pass_mem_record *pass_mem_record;
+
+/* Memory use at the start of a pass, for -fmem-report-passes.  */
+
+struct pass_mem_sample
+{
+  size_t ggc;
+  size_t heap;
+  size_t peak_rss;
+};
+
+/* Return the peak RSS of the process, or 0 if it is not known.  */
+
+static size_t
+peak_rss (void)
+{
+#ifdef HAVE_GETRUSAGE
+  struct rusage ru;
+  if (getrusage (RUSAGE_SELF, &ru) == 0)
+    /* In kilobytes on the hosts that support it.  */
+    return (size_t) ru.ru_maxrss * 1024;
+#endif
+  return 0;
+}
+
+/* Record the memory use at the start of a pass in SAMPLE.  */
+
+static void
+pass_mem_begin (pass_mem_sample *sample)
+{
+  sample->ggc = timevar_ggc_mem_total;
+  sample->heap = heap_memory_use ();
+  sample->peak_rss = peak_rss ();
+}
+
+/* Account the memory used by PASS since SAMPLE.  */
+
+static void
+pass_mem_end (opt_pass *pass, const pass_mem_sample *sample)
+{
+  pass_manager *passes = g->get_passes ();
+  int index = pass->static_pass_number;
+  if (index == -1)
+    return;
+  if (!pass_mem_record)
+    pass_mem_record = XCNEWVEC (struct pass_mem_record,
+				passes->passes_by_id_size);
+  gcc_assert (index < passes->passes_by_id_size && index >= 0);
+
+  struct pass_mem_record *r = &pass_mem_record[index];
+  size_t heap = heap_memory_use ();
+  size_t rss = peak_rss ();
+  r->runs++;
+  r->ggc += timevar_ggc_mem_total - sample->ggc;
+  if (heap > sample->heap)
+    r->heap = MAX (r->heap, heap - sample->heap);
+  if (rss > sample->peak_rss)
+    r->peak_rss += rss - sample->peak_rss;
+}
+
+/* Output the memory use of each pass.  */
+
+void
+dump_pass_mem_report (void)
+{
+  g->get_passes ()->dump_mem_report ();
+}
+
+void
+pass_manager::dump_mem_report () const
+{
+  if (!pass_mem_record)
+    return;
+
+  fprintf (stderr, "\nMemory use by pass:\n\n");
+  fprintf (stderr, "%-32s%8s%12s%12s%12s\n", "Pass name", "runs", "GGC",
+	   "heap peak", "RSS peak");
+  for (int i = 1; i < passes_by_id_size; i++)
+    {
+      const struct pass_mem_record *r = &pass_mem_record[i];
+      if (!r->runs)
+	continue;
+      fprintf (stderr, "%-32s%8u" PRsa (11) PRsa (11) PRsa (11) "\n",
+	       passes_by_id[i]->name, r->runs, SIZE_AMOUNT (r->ggc),
+	       SIZE_AMOUNT (r->heap), SIZE_AMOUNT (r->peak_rss));
+    }
+}
+
 /* Perform all TODO actions that ought to be done on each function.  */
 
 static void
@@ -2549,10 +2654,17 @@ execute_one_pass (opt_pass *pass)
 
   pass_init_dump_file (pass);
 
+  pass_mem_sample mem_sample;
+  if (mem_report_passes)
+    pass_mem_begin (&mem_sample);
+
   /* If a timevar is present, start it.  */
   if (pass->tv_id != TV_NONE)
     timevar_push (pass->tv_id);
 
+  if (time_trace_active)
+    time_trace_begin (pass->name, cfun ? function_name (cfun) : NULL);
+
   if (profile_report && cfun && (cfun->curr_properties & PROP_cfg))
     check_profile_consistency (pass->static_pass_number, true);
 
@@ -2571,6 +2683,10 @@ execute_one_pass (opt_pass *pass)
       /* Stop timevar.  */
       if (pass->tv_id != TV_NONE)
 	timevar_pop (pass->tv_id);
+      time_trace_end ();
+
+      if (mem_report_passes)
+	pass_mem_end (pass, &mem_sample);
 
       pass_fini_dump_file (pass);
 
@@ -2610,6 +2726,7 @@ execute_one_pass (opt_pass *pass)
   /* Stop timevar.  */
   if (pass->tv_id != TV_NONE)
     timevar_pop (pass->tv_id);
+  time_trace_end ();
 
   if (pass->type == IPA_PASS
       && ((ipa_opt_pass_d *)pass)->function_transform)
@@ -2625,6 +2742,9 @@ execute_one_pass (opt_pass *pass)
   if (!current_function_decl)
     symtab->process_new_functions ();
 
+  if (mem_report_passes)
+    pass_mem_end (pass, &mem_sample);
+
   pass_fini_dump_file (pass);
 
   if (pass->type != SIMPLE_IPA_PASS && pass->type != IPA_PASS)
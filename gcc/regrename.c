@@ -23,6 +23,7 @@
 #include "backend.h"
 #include "target.h"
 #include "rtl.h"
+#include "predict.h"
 #include "df.h"
 #include "memmodel.h"
 #include "tm_p.h"
@@ -459,6 +460,26 @@ regrename_find_superclass (du_head_p head, int *pn_uses,
   return super_class;
 }
 
+/* A chain together with the execution frequency of its uses.  */
+struct weighted_chain
+{
+  du_head_p head;
+  int freq;
+};
+
+/* qsort comparison function that orders weighted chains by decreasing
+   frequency, and chains with equal frequency by id.  */
+static int
+compare_weighted_chains (const void *p1, const void *p2)
+{
+  const weighted_chain *c1 = (const weighted_chain *) p1;
+  const weighted_chain *c2 = (const weighted_chain *) p2;
+
+  if (c1->freq != c2->freq)
+    return c1->freq > c2->freq ? -1 : 1;
+  return c1->head->id < c2->head->id ? -1 : c1->head->id > c2->head->id;
+}
+
 /* Perform register renaming on the current function.  */
 static void
 rename_chains (void)
@@ -467,6 +488,22 @@ rename_chains (void)
   du_head_p this_head;
   int i;
 
+  /* Normally chains are renamed in the order they were found.  When the
+     target prefers to rename into a subset of the registers, typically
+     because they have shorter encodings, offer that subset to the most
+     frequently executed chains first.  */
+  auto_vec<weighted_chain> order (id_to_chain.length ());
+  FOR_EACH_VEC_ELT (id_to_chain, i, this_head)
+    {
+      weighted_chain c = { this_head, 0 };
+      for (du_chain *tmp = this_head->first; tmp; tmp = tmp->next_use)
+	if (!DEBUG_INSN_P (tmp->insn))
+	  c.freq += REG_FREQ_FROM_BB (BLOCK_FOR_INSN (tmp->insn));
+      order.quick_push (c);
+    }
+  if (targetm.preferred_rename_class (GENERAL_REGS) != NO_REGS)
+    order.qsort (compare_weighted_chains);
+
   memset (tick, 0, sizeof tick);
 
   CLEAR_HARD_REG_SET (unavailable);
@@ -478,11 +515,12 @@ rename_chains (void)
 	add_to_hard_reg_set (&unavailable, Pmode, HARD_FRAME_POINTER_REGNUM);
     }
 
-  FOR_EACH_VEC_ELT (id_to_chain, i, this_head)
+  for (i = 0; i < (int) order.length (); i++)
     {
       int best_new_reg;
       int n_uses;
       HARD_REG_SET this_unavailable;
+      this_head = order[i].head;
       int reg = this_head->regno;
 
       if (this_head->cannot_rename)
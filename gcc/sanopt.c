@@ -914,6 +914,187 @@ sanopt_optimize (function *fun, bool *contains_asan_mark)
   return ctx.asan_num_accesses;
 }
 
+/* Maximum number of earlier ASAN_CHECK calls in a basic block that
+   are considered as merge candidates for a later one.  */
+
+#define MAX_ASAN_CHECK_MERGE_CANDIDATES 16
+
+/* An ASAN_CHECK call that a later one might be merged into, with
+   the base and constant byte offset of its checked address.  */
+
+struct asan_check_candidate
+{
+  gimple *stmt;
+  tree base;
+  HOST_WIDE_INT offset;
+};
+
+/* Decompose PTR, the address checked by an ASAN_CHECK call, into a
+   base and a constant byte offset stored to *OFFSET.  Return the base,
+   or NULL_TREE if there is none.  */
+
+static tree
+asan_check_base_and_offset (tree ptr, HOST_WIDE_INT *offset)
+{
+  *offset = 0;
+  if (TREE_CODE (ptr) == SSA_NAME)
+    {
+      gimple *g = SSA_NAME_DEF_STMT (ptr);
+      if (!is_gimple_assign (g))
+	return ptr;
+      if (gimple_assign_rhs_code (g) == POINTER_PLUS_EXPR
+	  && TREE_CODE (gimple_assign_rhs1 (g)) == SSA_NAME
+	  && tree_fits_shwi_p (gimple_assign_rhs2 (g)))
+	{
+	  *offset = tree_to_shwi (gimple_assign_rhs2 (g));
+	  return gimple_assign_rhs1 (g);
+	}
+      if (gimple_assign_rhs_code (g) != ADDR_EXPR)
+	return ptr;
+      ptr = gimple_assign_rhs1 (g);
+    }
+  if (TREE_CODE (ptr) != ADDR_EXPR)
+    return NULL_TREE;
+
+  poly_int64 bytepos;
+  tree base = get_addr_base_and_unit_offset (TREE_OPERAND (ptr, 0),
+					     &bytepos);
+  if (base == NULL_TREE || !bytepos.is_constant (offset))
+    return NULL_TREE;
+  if (TREE_CODE (base) == MEM_REF)
+    {
+      if (TREE_CODE (TREE_OPERAND (base, 0)) != SSA_NAME)
+	return NULL_TREE;
+      HOST_WIDE_INT mem_off;
+      if (!mem_ref_offset (base).to_shwi (&bytepos)
+	  || !bytepos.is_constant (&mem_off))
+	return NULL_TREE;
+      *offset += mem_off;
+      return TREE_OPERAND (base, 0);
+    }
+  if (!DECL_P (base))
+    return NULL_TREE;
+  return base;
+}
+
+/* Try to merge the ASAN_CHECK call STMT into one of the earlier calls
+   in its basic block recorded in CANDIDATES.  STMT can be merged into
+   an earlier check of the same kind whose range it extends at the end,
+   when the combined range can still be verified with a single shadow
+   memory load.  Return true if STMT has been merged and can be
+   removed; otherwise record STMT in CANDIDATES.  */
+
+static bool
+maybe_merge_asan_check (vec<asan_check_candidate> &candidates,
+			gimple *stmt)
+{
+  HOST_WIDE_INT flags = tree_to_shwi (gimple_call_arg (stmt, 0));
+  tree len = gimple_call_arg (stmt, 2);
+  if ((flags & ASAN_CHECK_SCALAR_ACCESS) == 0
+      || !tree_fits_shwi_p (len))
+    return false;
+
+  HOST_WIDE_INT offset;
+  tree base = asan_check_base_and_offset (gimple_call_arg (stmt, 1),
+					  &offset);
+  if (base == NULL_TREE)
+    return false;
+
+  HOST_WIDE_INT size = tree_to_shwi (len);
+  unsigned start = (candidates.length () > MAX_ASAN_CHECK_MERGE_CANDIDATES
+		    ? candidates.length () - MAX_ASAN_CHECK_MERGE_CANDIDATES
+		    : 0);
+  for (unsigned i = candidates.length (); i-- > start; )
+    {
+      asan_check_candidate &c = candidates[i];
+      if (tree_to_shwi (gimple_call_arg (c.stmt, 0)) != flags
+	  || !operand_equal_p (c.base, base, 0))
+	continue;
+
+      /* The earlier check has to start at or before STMT's range, as
+	 the address checked by STMT need not be available at the
+	 earlier check, and the two ranges have to be contiguous.  */
+      HOST_WIDE_INT c_size = tree_to_shwi (gimple_call_arg (c.stmt, 2));
+      if (offset < c.offset || offset > c.offset + c_size)
+	continue;
+
+      HOST_WIDE_INT new_size = MAX (c_size, offset + size - c.offset);
+      HOST_WIDE_INT align = tree_to_shwi (gimple_call_arg (c.stmt, 3));
+      if (new_size != c_size
+	  && (new_size > 16 || exact_log2 (new_size) < 0 || align < new_size))
+	continue;
+
+      if (new_size != c_size)
+	{
+	  if (dump_file && (dump_flags & TDF_DETAILS))
+	    {
+	      fprintf (dump_file, "Widening to " HOST_WIDE_INT_PRINT_DEC
+		       " bytes: ", new_size);
+	      print_gimple_stmt (dump_file, c.stmt, 0, dump_flags);
+	    }
+	  gimple_call_set_arg (c.stmt, 2,
+			       build_int_cst (TREE_TYPE (len), new_size));
+	  update_stmt (c.stmt);
+	}
+      return true;
+    }
+
+  asan_check_candidate c = { stmt, base, offset };
+  candidates.safe_push (c);
+  return false;
+}
+
+/* Merge ASAN_CHECK calls in function FUN that check contiguous parts
+   of the same object into a single wider check, so that e.g. loads of
+   two adjacent int fields of a suitably aligned structure need a single
+   shadow memory load.  A check is only merged into an earlier one in
+   the same basic block with no call or asm statement in between, so
+   that whenever the widened check is executed, the accesses whose
+   checks have been merged into it are executed as well.  Return the
+   number of checks that have been removed.  */
+
+static int
+sanopt_merge_asan_checks (function *fun)
+{
+  int removed = 0;
+  auto_vec<asan_check_candidate> candidates;
+  basic_block bb;
+
+  FOR_EACH_BB_FN (bb, fun)
+    {
+      candidates.truncate (0);
+      for (gimple_stmt_iterator gsi = gsi_start_bb (bb); !gsi_end_p (gsi);)
+	{
+	  gimple *stmt = gsi_stmt (gsi);
+	  if (is_a <gasm *> (stmt)
+	      || (is_gimple_call (stmt)
+		  && !gimple_call_internal_p (stmt, IFN_ASAN_CHECK)))
+	    {
+	      candidates.truncate (0);
+	      gsi_next (&gsi);
+	      continue;
+	    }
+	  if (!is_gimple_call (stmt)
+	      || !maybe_merge_asan_check (candidates, stmt))
+	    {
+	      gsi_next (&gsi);
+	      continue;
+	    }
+
+	  if (dump_file && (dump_flags & TDF_DETAILS))
+	    {
+	      fprintf (dump_file, "Merging: ");
+	      print_gimple_stmt (dump_file, stmt, 0, dump_flags);
+	    }
+	  unlink_stmt_vdef (stmt);
+	  gsi_remove (&gsi, true);
+	  removed++;
+	}
+    }
+
+  return removed;
+}
+
 /* Perform optimization of sanitize functions.  */
 
 namespace {
@@ -1278,7 +1459,11 @@ pass_sanopt::execute (function *fun)
       && (flag_sanitize
 	  & (SANITIZE_NULL | SANITIZE_ALIGNMENT | SANITIZE_HWADDRESS
 	     | SANITIZE_ADDRESS | SANITIZE_VPTR | SANITIZE_POINTER_OVERFLOW)))
-    asan_num_accesses = sanopt_optimize (fun, &contains_asan_mark);
+    {
+      asan_num_accesses = sanopt_optimize (fun, &contains_asan_mark);
+      if (flag_sanitize & SANITIZE_ADDRESS)
+	asan_num_accesses -= sanopt_merge_asan_checks (fun);
+    }
   else if (flag_sanitize & (SANITIZE_ADDRESS | SANITIZE_HWADDRESS))
     {
       gimple_stmt_iterator gsi;
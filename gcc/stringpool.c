@@ -50,8 +50,9 @@ init_stringpool (void)
   if (ident_hash)
     ht_destroy (ident_hash);
 
-  /* Create with 16K (2^14) entries.  */
-  ident_hash = ht_create (14);
+  /* Create with 32K (2^15) entries, enough for the identifiers
+     entered at startup, such as the builtins, without expanding.  */
+  ident_hash = ht_create (15);
   ident_hash->alloc_node = alloc_node;
   ident_hash->alloc_subobject = stringpool_ggc_alloc;
 }
@@ -0,0 +1,30 @@
+/* { dg-options "-fdump-tree-sanopt" } */
+/* { dg-do compile } */
+/* { dg-skip-if "" { *-*-* } { "*" } { "-O0" } } */
+
+struct __attribute__ ((aligned (8))) S
+{
+  __INT32_TYPE__ a;
+  __INT32_TYPE__ b;
+};
+
+int
+foo (struct S *p)
+{
+  /* The checks of the two adjacent fields are merged into a single
+     check of 8 bytes, as p->a is known to be 8-byte aligned.  */
+  return p->a + p->b;
+}
+
+void
+bar (struct S *p)
+{
+  /* Likewise for stores.  */
+  p->a = 1;
+  p->b = 2;
+}
+
+/* { dg-final { scan-tree-dump-times "__builtin___asan_report_load8" 1 "sanopt" } } */
+/* { dg-final { scan-tree-dump-times "__builtin___asan_report_store8" 1 "sanopt" } } */
+/* { dg-final { scan-tree-dump-not "__builtin___asan_report_load4" "sanopt" } } */
+/* { dg-final { scan-tree-dump-not "__builtin___asan_report_store4" "sanopt" } } */
@@ -0,0 +1,37 @@
+/* { dg-additional-options "-fanalyzer-call-summaries" } */
+
+#include "analyzer-decls.h"
+
+extern void sink (int);
+
+int global;
+
+/* Big enough to be summarized rather than followed into at each call.  */
+
+int returns_42 (int a, int b)
+{
+  if (a)
+    sink (1);
+  if (b)
+    sink (2);
+  if (a > b)
+    sink (3);
+  if (a < b)
+    sink (4);
+  return 42;
+}
+
+void test (int x, int y)
+{
+  int r1, r2;
+
+  global = 1;
+  r1 = returns_42 (x, y);
+  r2 = returns_42 (y, x);
+  __analyzer_eval (r1 == 42); /* { dg-warning "TRUE" } */
+  __analyzer_eval (r2 == 42); /* { dg-warning "TRUE" } */
+
+  /* The summary doesn't say what happens to memory reachable from
+     the call.  */
+  __analyzer_eval (global == 1); /* { dg-warning "UNKNOWN" } */
+}
@@ -0,0 +1,19 @@
+/* Test that -finclude-cache does not change the outcome of header
+   lookups.  */
+
+/* { dg-do preprocess }
+   { dg-options "-finclude-cache=include-cache-1.cache" } */
+
+#include "mi1c.h"
+
+#if !__has_include ("mi1c.h")
+#error mi1c.h not found
+#endif
+
+#if __has_include ("include-cache-1-nonexistent.h")
+#error include-cache-1-nonexistent.h found
+#endif
+
+#if __has_include ("./mi1c.h") != __has_include ("mi1c.h")
+#error inconsistent lookup of ./mi1c.h
+#endif
@@ -0,0 +1,29 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fdump-tree-all=func:foo,baz -fdump-rtl-expand-details=func:bar" } */
+
+int res;
+
+__attribute__((noipa)) void
+foo (int x)
+{
+  res += x;
+}
+
+__attribute__((noipa)) void
+bar (int x)
+{
+  res -= x;
+}
+
+__attribute__((noipa)) void
+baz (int x)
+{
+  res *= x;
+}
+
+/* { dg-final { scan-tree-dump "foo \\(int x\\)" "gimple" } } */
+/* { dg-final { scan-tree-dump-not "bar \\(int x\\)" "gimple" } } */
+/* { dg-final { scan-tree-dump ";; Function baz" "optimized" } } */
+/* { dg-final { scan-tree-dump-not ";; Function bar" "optimized" } } */
+/* { dg-final { scan-rtl-dump ";; Function bar" "expand" } } */
+/* { dg-final { scan-rtl-dump-not ";; Function foo" "expand" } } */
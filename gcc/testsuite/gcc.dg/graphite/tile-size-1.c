@@ -0,0 +1,20 @@
+/* { dg-options "-O2 -floop-nest-optimize -fdump-tree-graphite-all --param l1-cache-size=4" } */
+
+/* The tile size is chosen so that a tile of each of the three arrays
+   fits in the 4 KiB L1 cache.  */
+
+#define N 256
+double A[N][N], B[N][N], C[N][N];
+
+void
+mm (void)
+{
+  int i, j, k;
+
+  for (i = 0; i < N; i++)
+    for (j = 0; j < N; j++)
+      for (k = 0; k < N; k++)
+	C[i][j] += A[i][k] * B[k][j];
+}
+
+/* { dg-final { scan-tree-dump "tile size 13 for 3 arrays" "graphite" } } */
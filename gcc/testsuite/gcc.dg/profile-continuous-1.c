@@ -0,0 +1,11 @@
+/* { dg-do compile } */
+/* { dg-require-named-sections "" } */
+/* { dg-options "-O2 -fprofile-arcs -fprofile-continuous" } */
+
+int
+foo (int x)
+{
+  return x > 0 ? x * 3 : -x;
+}
+
+/* { dg-final { scan-assembler "__gcov_cnts" } } */
@@ -0,0 +1,9 @@
+/* { dg-do compile } */
+/* { dg-options "-fprofile-generate -fprofile-values -fprofile-continuous" } */
+/* { dg-error "'-fprofile-continuous' is not supported with '-fprofile-values'" "" { target *-*-* } 0 } */
+
+int
+main (void)
+{
+  return 0;
+}
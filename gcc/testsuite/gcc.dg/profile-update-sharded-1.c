@@ -0,0 +1,12 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fprofile-arcs -fprofile-update=sharded" } */
+
+int
+foo (int x, int y)
+{
+  if (x > y)
+    return x - y;
+  return y * 3;
+}
+
+/* { dg-final { scan-assembler "__gcov_shard_anchor" } } */
@@ -0,0 +1,14 @@
+/* Test that -ftime-trace writes the spans of the front end and of the
+   passes run on each function.  */
+/* { dg-do compile } */
+/* { dg-options "-O -ftime-trace -ftime-trace-granularity=0" } */
+
+int
+foo (int x)
+{
+  return x + 1;
+}
+
+/* { dg-final { scan-file time-trace-1.json "\{\"traceEvents\":\\\[" } } */
+/* { dg-final { scan-file time-trace-1.json "\"name\":\"Frontend\",\"ph\":\"X\"" } } */
+/* { dg-final { scan-file time-trace-1.json "\"name\":\"optimized\",\[^\n\]*\"detail\":\"foo\"" } } */
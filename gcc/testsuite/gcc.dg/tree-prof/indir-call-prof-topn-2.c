@@ -0,0 +1,49 @@
+/* { dg-require-profiling "-fprofile-generate" } */
+/* { dg-options "-O2 -fdump-ipa-profile_estimate" } */
+
+#ifdef FOR_AUTOFDO_TESTING
+#define MAXITER 300000000
+#else
+#define MAXITER 3000000
+#endif
+
+#include <stdio.h>
+
+typedef int (*fptr) (int);
+int
+one (int a)
+{
+  return 1;
+}
+
+int
+two (int a)
+{
+  return 2;
+}
+
+int
+zero (int a)
+{
+  return 0;
+}
+
+fptr table[] = {&zero, &one, &two};
+
+/* Each of the three targets gets a third of the calls.  */
+
+int
+main()
+{
+  int i, x;
+  fptr p = &one;
+
+  for (i = 0; i < MAXITER; i++)
+    {
+      x = (*p) (3);
+      p = table[(x + 2) % 3];
+    }
+  printf ("done:%d\n", x);
+}
+
+/* { dg-final-use-not-autofdo { scan-ipa-dump "3 \\(300.00%\\) speculations produced." "profile_estimate" } } */
@@ -0,0 +1,20 @@
+/* { dg-options "-O2 -fvpt-call-args -fdump-ipa-profile-optimized" } */
+int a[4096];
+volatile int step = 4;
+
+__attribute__ ((noinline)) void
+scale (int *p, int n, int stride)
+{
+  for (int i = 0; i < n; i += stride)
+    p[i] *= 3;
+}
+
+int
+main ()
+{
+  for (int i = 0; i < 1000; i++)
+    scale (a, 4096, step);
+  return 0;
+}
+/* autofdo does not do value profiling so far */
+/* { dg-final-use-not-autofdo { scan-ipa-dump "Transformation done: single value 4 for argument 2 of call to scale" "profile"} } */
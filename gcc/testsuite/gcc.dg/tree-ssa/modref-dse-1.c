@@ -0,0 +1,32 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fdump-tree-dse1-details" } */
+struct point
+{
+  int x, y;
+};
+
+__attribute__ ((noinline))
+void
+init (struct point *p)
+{
+  p->x = 0;
+  p->y = 0;
+}
+
+void
+test (struct point *p)
+{
+  p->x = 1;
+  p->y = 2;
+  init (p);
+}
+
+void
+test2 (struct point *p, int *q)
+{
+  p->y = 3;
+  *q = 4;
+  init (p);
+}
+/* The stores to P are dead, the store to Q may not be.  */
+/* { dg-final { scan-tree-dump-times "Deleted dead store" 3 "dse1" } } */
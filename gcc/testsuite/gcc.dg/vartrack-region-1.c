@@ -0,0 +1,22 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -g --param=max-vartrack-region-visits=1 -fdump-rtl-vartrack" } */
+
+extern int next (int, int);
+
+int
+run (int state, int n)
+{
+  int acc = 0;
+  while (n-- > 0)
+    switch (state)
+      {
+      case 0: acc += n; state = next (state, acc); break;
+      case 1: acc ^= n; state = next (state, acc); break;
+      case 2: acc -= n; state = next (state, acc); break;
+      case 3: acc *= n; state = next (state, acc); break;
+      default: return acc;
+      }
+  return acc + state;
+}
+
+/* { dg-final { scan-rtl-dump "Abandoning dataflow of blocks" "vartrack" } } */
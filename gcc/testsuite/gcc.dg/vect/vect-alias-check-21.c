@@ -0,0 +1,23 @@
+/* { dg-do compile } */
+/* { dg-require-effective-target vect_int } */
+
+/* The fifteen alias checks exceed --param vect-max-version-for-alias-checks
+   but are invariant in the outer loop, so versioning can move them out
+   of it.  */
+
+#define N 1024
+
+void
+f (int *a, int *b, int *c, int *d, int *e, int *f, int *g, int reps)
+{
+  for (int k = 0; k < reps; ++k)
+    for (int j = 0; j < N; ++j)
+      {
+	a[j] = d[j] + e[j];
+	b[j] = f[j] + g[j];
+	c[j] = d[j] + g[j];
+      }
+}
+
+/* { dg-final { scan-tree-dump "alias checks are invariant in the outer loop" "vect" } } */
+/* { dg-final { scan-tree-dump "vectorized 1 loops" "vect" } } */
@@ -0,0 +1,14 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d -mtune=generic-ooo" } */
+
+/* Hot code is aligned to the 16-byte fetch block of the tuning
+   target.  */
+
+void
+foo (int *p, int n)
+{
+  for (int i = 0; i < n; i++)
+    p[i] = p[i] * 3 + 1;
+}
+
+/* { dg-final { scan-assembler "\\.p2align\\s+4" } } */
@@ -0,0 +1,19 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d -mtune=generic-ooo -mrelax" } */
+
+/* When relaxing, the assembler ignores the padding limit of an
+   alignment, so jump targets are not aligned at all.  */
+
+int
+foo (int *p, int n)
+{
+  int s = 0;
+  for (int i = 0; i < n; i++)
+    if (p[i] > 0)
+      s += p[i];
+    else
+      s -= p[i] * 3;
+  return s;
+}
+
+/* { dg-final { scan-assembler-not "\\.p2align\\s+\[0-9\]+,,\[0-9\]" } } */
@@ -0,0 +1,13 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64" } */
+
+void acq (void) { __atomic_thread_fence (__ATOMIC_ACQUIRE); }
+void rel (void) { __atomic_thread_fence (__ATOMIC_RELEASE); }
+void acq_rel (void) { __atomic_thread_fence (__ATOMIC_ACQ_REL); }
+void seq_cst (void) { __atomic_thread_fence (__ATOMIC_SEQ_CST); }
+
+/* { dg-final { scan-assembler-times "fence\tr,rw" 1 } } */
+/* { dg-final { scan-assembler-times "fence\trw,w" 1 } } */
+/* { dg-final { scan-assembler-times "fence\\.tso" 1 } } */
+/* { dg-final { scan-assembler-times "fence\trw,rw" 1 } } */
+/* { dg-final { scan-assembler-not "iorw" } } */
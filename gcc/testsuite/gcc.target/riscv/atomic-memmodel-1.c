@@ -0,0 +1,41 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64" } */
+
+int
+load_acquire (int *p)
+{
+  return __atomic_load_n (p, __ATOMIC_ACQUIRE);
+}
+
+void
+store_release (int *p, int v)
+{
+  __atomic_store_n (p, v, __ATOMIC_RELEASE);
+}
+
+int
+add_relaxed (int *p, int v)
+{
+  return __atomic_fetch_add (p, v, __ATOMIC_RELAXED);
+}
+
+int
+add_release (int *p, int v)
+{
+  return __atomic_fetch_add (p, v, __ATOMIC_RELEASE);
+}
+
+int
+add_seq_cst (int *p, int v)
+{
+  return __atomic_fetch_add (p, v, __ATOMIC_SEQ_CST);
+}
+
+/* Loads and stores use the minimal fences and AMOs carry their
+   ordering in the .aq and .rl bits rather than in a FENCE.  */
+/* { dg-final { scan-assembler-times "fence\tr,rw" 1 } } */
+/* { dg-final { scan-assembler-times "fence\trw,w" 1 } } */
+/* { dg-final { scan-assembler-times "amoadd\\.w\t" 1 } } */
+/* { dg-final { scan-assembler-times "amoadd\\.w\\.rl\t" 1 } } */
+/* { dg-final { scan-assembler-times "amoadd\\.w\\.aqrl\t" 1 } } */
+/* { dg-final { scan-assembler-not "iorw" } } */
@@ -0,0 +1,29 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gcv -mabi=lp64d" } */
+
+/* Variable-length copies and stores are strip-mined with RVV.  */
+
+void
+copy (char *d, const char *s, __SIZE_TYPE__ n)
+{
+  __builtin_memcpy (d, s, n);
+}
+
+void
+set (char *d, int c, __SIZE_TYPE__ n)
+{
+  __builtin_memset (d, c, n);
+}
+
+void
+copy_const (char *d, const char *s)
+{
+  __builtin_memcpy (d, s, 200);
+}
+
+/* { dg-final { scan-assembler-times "vsetvli\t\[a-z0-9\]+,\[a-z0-9\]+,e8,m1,ta,ma" 3 } } */
+/* { dg-final { scan-assembler-times "vle8.v" 2 } } */
+/* { dg-final { scan-assembler-times "vse8.v" 3 } } */
+/* { dg-final { scan-assembler "vmv.v.x" } } */
+/* { dg-final { scan-assembler-not "memcpy" } } */
+/* { dg-final { scan-assembler-not "memset" } } */
@@ -0,0 +1,28 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zbb -mabi=lp64" } */
+
+/* Short constant-length memcmp and strncmp are expanded inline.  */
+
+long long a[4], b[4];
+
+int
+cmp_words (void)
+{
+  return __builtin_memcmp (a, b, 20);
+}
+
+int
+cmp_bytes (const char *p, const char *q)
+{
+  return __builtin_memcmp (p, q, 3);
+}
+
+int
+cmp_str (const char *p, const char *q)
+{
+  return __builtin_strncmp (p, q, 4);
+}
+
+/* { dg-final { scan-assembler-times "rev8\t" 2 } } */
+/* { dg-final { scan-assembler-not "memcmp" } } */
+/* { dg-final { scan-assembler-not "strncmp" } } */
@@ -0,0 +1,15 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64 -mtune=size -mno-strict-align" } */
+
+/* With fast misaligned accesses, copy the tail of a block with a word
+   access that overlaps the previous one.  */
+
+void
+copy (char *d, const char *s)
+{
+  __builtin_memcpy (d, s, 15);
+}
+
+/* { dg-final { scan-assembler-times "ld\t" 2 } } */
+/* { dg-final { scan-assembler-times "sd\t" 2 } } */
+/* { dg-final { scan-assembler-not "lbu\t" } } */
@@ -0,0 +1,20 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zicboz_zic64b -mabi=lp64" } */
+
+struct page { char data[4096]; } __attribute__ ((aligned (64)));
+
+void
+clear_small (struct page *p)
+{
+  __builtin_memset (p, 0, 128);
+}
+
+void
+clear_page (struct page *p)
+{
+  __builtin_memset (p, 0, sizeof (*p));
+}
+
+/* The small clear is straight-line, the page clear a loop.  */
+/* { dg-final { scan-assembler-times "cbo\\.zero\t0\\(" 3 } } */
+/* { dg-final { scan-assembler-not "memset" } } */
@@ -0,0 +1,14 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fmodulo-sched -fdump-rtl-loop2_doloop" } */
+
+/* With -fmodulo-sched, counted loops get a decrement-and-branch doloop
+   pattern for the modulo scheduler to work on.  */
+
+void
+scale (int *restrict a, const int *restrict b, int n)
+{
+  for (int i = 0; i < n; i++)
+    a[i] = b[i] * 3 + 1;
+}
+
+/* { dg-final { scan-rtl-dump "Doloop: Inserting doloop pattern" "loop2_doloop" } } */
@@ -0,0 +1,18 @@
+/* { dg-do compile } */
+/* { dg-options "-march=rv64gc -mabi=lp64d -O2 -mtune=rocket -mtune-file=$srcdir/gcc.target/riscv/fma-chain-1.tune" } */
+
+/* With a slow multiply-add the accumulation should only wait for the
+   additions.  */
+
+double
+dot (double *a, double *b, int n)
+{
+  double s = 0;
+  for (int i = 0; i < n; i++)
+    s += a[i] * b[i];
+  return s;
+}
+
+/* { dg-final { scan-assembler-not "fmadd.d\t" } } */
+/* { dg-final { scan-assembler "fmul.d\t" } } */
+/* { dg-final { scan-assembler "fadd.d\t" } } */
@@ -0,0 +1,14 @@
+/* { dg-do compile } */
+/* { dg-options "-march=rv64gc -mabi=lp64d -O2 -mcmodel=medlow -mtune=sifive-7-series -mtune-file=$srcdir/gcc.target/riscv/fusion-1.tune" } */
+
+/* Each lui should stay next to the load that uses it.  */
+
+extern int a, b, c, d;
+
+int
+foo (void)
+{
+  return a + b + c + d;
+}
+
+/* { dg-final { scan-assembler-times "lui\t(\[a-z0-9\]+),%hi\\((\[a-d\])\\)\n\tlw\t\[a-z0-9\]+,%lo\\(\\2\\)\\(\\1\\)" 4 } } */
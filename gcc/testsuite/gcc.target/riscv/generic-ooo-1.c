@@ -0,0 +1,15 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d -mtune=generic-ooo" } */
+
+/* Out-of-order cores handle misaligned accesses in hardware, so the
+   block copy should use word accesses.  */
+
+void
+copy (char *d, const char *s)
+{
+  __builtin_memcpy (d, s, 15);
+}
+
+/* { dg-final { scan-assembler-times "ld\t" 2 } } */
+/* { dg-final { scan-assembler-times "sd\t" 2 } } */
+/* { dg-final { scan-assembler-not "lbu\t" } } */
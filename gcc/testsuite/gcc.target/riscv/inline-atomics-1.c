@@ -0,0 +1,32 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64" } */
+
+/* QImode and HImode atomics should be expanded inline as LR/SC loops on
+   the containing word rather than calling the libgcc routines.  */
+
+char c;
+short s;
+
+char fetch_add_c (char v) { return __atomic_fetch_add (&c, v, __ATOMIC_SEQ_CST); }
+short fetch_add_s (short v) { return __atomic_fetch_add (&s, v, __ATOMIC_RELAXED); }
+char fetch_sub_c (char v) { return __atomic_fetch_sub (&c, v, __ATOMIC_ACQUIRE); }
+short fetch_and_s (short v) { return __atomic_fetch_and (&s, v, __ATOMIC_RELEASE); }
+char fetch_or_c (char v) { return __atomic_fetch_or (&c, v, __ATOMIC_ACQ_REL); }
+short fetch_xor_s (short v) { return __atomic_fetch_xor (&s, v, __ATOMIC_SEQ_CST); }
+char fetch_nand_c (char v) { return __atomic_fetch_nand (&c, v, __ATOMIC_SEQ_CST); }
+short add_fetch_s (short v) { return __atomic_add_fetch (&s, v, __ATOMIC_SEQ_CST); }
+char exchange_c (char v) { return __atomic_exchange_n (&c, v, __ATOMIC_SEQ_CST); }
+
+_Bool
+cas_s (short *e, short d)
+{
+  return __atomic_compare_exchange_n (&s, e, d, 0, __ATOMIC_SEQ_CST,
+				      __ATOMIC_RELAXED);
+}
+
+char sync_cas_c (char o, char n) { return __sync_val_compare_and_swap (&c, o, n); }
+
+/* { dg-final { scan-assembler-times "lr.w" 11 } } */
+/* { dg-final { scan-assembler-times "sc.w" 11 } } */
+/* { dg-final { scan-assembler-not "__sync_" } } */
+/* { dg-final { scan-assembler-not "__atomic_" } } */
@@ -0,0 +1,13 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64 -mno-inline-atomics" } */
+
+/* With -mno-inline-atomics, subword atomics use the out-of-line routines.  */
+
+char c;
+
+char fetch_add_c (char v) { return __sync_fetch_and_add (&c, v); }
+char sync_cas_c (char o, char n) { return __sync_val_compare_and_swap (&c, o, n); }
+
+/* { dg-final { scan-assembler "__sync_fetch_and_add_1" } } */
+/* { dg-final { scan-assembler "__sync_val_compare_and_swap_1" } } */
+/* { dg-final { scan-assembler-not "lr.w" } } */
@@ -0,0 +1,18 @@
+/* Verify that a handler only saves the registers its callee uses.  */
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d -fipa-ra" } */
+extern volatile int COUNTER;
+
+static void __attribute__ ((noinline))
+bump (void)
+{
+  COUNTER++;
+}
+
+void __attribute__ ((interrupt))
+foo (void)
+{
+  bump ();
+}
+/* { dg-final { scan-assembler-not "fs\[wd\]\t" } } */
+/* { dg-final { scan-assembler-not "s\[wd\]\ta\[1-7\]," } } */
@@ -0,0 +1,14 @@
+/* Verify that FPRs are only saved if mstatus.FS is not Off.  */
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d -minterrupt-lazy-fp" } */
+extern void bar (void);
+
+void __attribute__ ((interrupt))
+foo (void)
+{
+  bar ();
+}
+/* { dg-final { scan-assembler-times "csrr\tt0,mstatus" 2 } } */
+/* { dg-final { scan-assembler-times "beqz\tt0,1f" 2 } } */
+/* { dg-final { scan-assembler "fsd\tft0," } } */
+/* { dg-final { scan-assembler "fld\tft0," } } */
@@ -0,0 +1,31 @@
+/* { dg-do compile } */
+/* { dg-options "-Os -march=rv64gc -mabi=lp64d -mmachine-outline" } */
+
+/* The same stores are made before each call, and are outlined into
+   one copy that is called through T0.  */
+
+extern volatile int r0, r1, r2, r3;
+extern void report (int);
+
+void
+f (int x)
+{
+  switch (x)
+    {
+    case 0:
+      r0 = 1; r1 = 2; r2 = 3; r3 = 4;
+      report (10);
+      break;
+    case 1:
+      r0 = 1; r1 = 2; r2 = 3; r3 = 4;
+      report (20);
+      break;
+    case 2:
+      r0 = 1; r1 = 2; r2 = 3; r3 = 4;
+      report (30);
+      break;
+    }
+}
+
+/* { dg-final { scan-assembler-times "jal\tt0,\\.L" 3 } } */
+/* { dg-final { scan-assembler-times "jr\tt0" 1 } } */
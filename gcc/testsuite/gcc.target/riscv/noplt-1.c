@@ -0,0 +1,19 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fpic -fno-plt" } */
+
+/* Calls to preemptible functions load the target from the GOT and call
+   it with JALR, both for normal calls and for sibcalls.  */
+
+extern void foo (void);
+extern int bar (int);
+
+int
+baz (int x)
+{
+  foo ();
+  return bar (x);
+}
+
+/* { dg-final { scan-assembler-not "@plt" } } */
+/* { dg-final { scan-assembler "jalr\t" } } */
+/* { dg-final { scan-assembler "jr\t" } } */
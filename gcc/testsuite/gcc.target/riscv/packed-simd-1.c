@@ -0,0 +1,57 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv32gcp -mabi=ilp32d" } */
+
+typedef signed char v4qi __attribute__ ((vector_size (4)));
+typedef short v2hi __attribute__ ((vector_size (4)));
+
+v4qi
+add8 (v4qi a, v4qi b)
+{
+  return a + b;
+}
+
+v2hi
+sub16 (v2hi a, v2hi b)
+{
+  return a - b;
+}
+
+v2hi
+mul16 (v2hi a, v2hi b)
+{
+  return a * b;
+}
+
+v4qi
+sra8 (v4qi a)
+{
+  return a >> 3;
+}
+
+v2hi
+swap (v2hi a)
+{
+  return __builtin_shuffle (a, (v2hi) { 1, 0 });
+}
+
+v2hi
+pack (v2hi a, v2hi b)
+{
+  return __builtin_shuffle (a, b, (v2hi) { 0, 2 });
+}
+
+v4qi
+reverse (v4qi a)
+{
+  return __builtin_shuffle (a, (v4qi) { 3, 2, 1, 0 });
+}
+
+/* { dg-final { scan-assembler-times "\tadd8\t" 1 } } */
+/* { dg-final { scan-assembler-times "\tsub16\t" 1 } } */
+/* { dg-final { scan-assembler-times "\tsmbb16\t" 1 } } */
+/* { dg-final { scan-assembler-times "\tsmtt16\t" 1 } } */
+/* { dg-final { scan-assembler-times "\tsrai8\t" 1 } } */
+/* { dg-final { scan-assembler-times "\tswap8\t" 1 } } */
+/* { dg-final { scan-assembler-times "\tpkbt16\t" 2 } } */
+/* { dg-final { scan-assembler-times "\tpkbb16\t" 2 } } */
+/* { dg-final { scan-assembler-not "\tmul\t" } } */
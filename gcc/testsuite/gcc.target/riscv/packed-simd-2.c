@@ -0,0 +1,22 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -march=rv32gcp -mabi=ilp32d -fno-vect-cost-model" } */
+
+/* The vectorizer uses the packed-SIMD modes when V is not available.  */
+
+void
+add (short *restrict a, short *restrict b, short *restrict c)
+{
+  for (int i = 0; i < 64; i++)
+    a[i] = b[i] + c[i];
+}
+
+void
+max (unsigned char *restrict a, unsigned char *restrict b,
+     unsigned char *restrict c)
+{
+  for (int i = 0; i < 64; i++)
+    a[i] = b[i] > c[i] ? b[i] : c[i];
+}
+
+/* { dg-final { scan-assembler "\tadd16\t" } } */
+/* { dg-final { scan-assembler "\tumax8\t" } } */
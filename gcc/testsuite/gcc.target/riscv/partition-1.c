@@ -0,0 +1,28 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d" } */
+
+/* Hot/cold partitioning is on by default at -O2: the path that ends in
+   the cold call moves to .text.unlikely, and the jump to it is made
+   indirect since JAL may not reach another section.  */
+
+void fail (const char *) __attribute__ ((cold, noreturn));
+void use (int);
+
+void
+foo (int *p, int n)
+{
+  for (int i = 0; i < n; i++)
+    {
+      if (__builtin_expect (p[i] < 0, 0))
+	{
+	  use (p[i]);
+	  use (p[i] + 1);
+	  fail ("negative");
+	}
+      use (p[i] * 2);
+    }
+}
+
+/* { dg-final { scan-assembler "\\.section\\s+\\.text\\.unlikely" } } */
+/* { dg-final { scan-assembler "foo\\.cold" } } */
+/* { dg-final { scan-assembler "\\mjr\\s+\[a-z0-9\]+" } } */
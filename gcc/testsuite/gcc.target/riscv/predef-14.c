@@ -0,0 +1,23 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gcv -mabi=lp64d" } */
+
+int main () {
+
+#if !defined(__riscv_vector)
+#error "__riscv_vector"
+#endif
+
+#if !defined(__riscv_v) || (__riscv_v != (1 * 1000 * 1000))
+#error "__riscv_v"
+#endif
+
+#if __riscv_v_min_vlen != 128
+#error "__riscv_v_min_vlen"
+#endif
+
+#if !defined(__riscv_d)
+#error "__riscv_d"
+#endif
+
+  return 0;
+}
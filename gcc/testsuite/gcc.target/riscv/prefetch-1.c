@@ -0,0 +1,12 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zicbop -mabi=lp64" } */
+
+void
+foo (char *p)
+{
+  __builtin_prefetch (p, 0);
+  __builtin_prefetch (p + 256, 1);
+}
+
+/* { dg-final { scan-assembler-times "prefetch\\.r\t0\\(" 1 } } */
+/* { dg-final { scan-assembler-times "prefetch\\.w\t0\\(" 1 } } */
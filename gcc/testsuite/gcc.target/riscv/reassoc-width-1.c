@@ -0,0 +1,12 @@
+/* { dg-do compile } */
+/* { dg-options "-march=rv64gc -mabi=lp64d -O2 -mtune=generic-ooo -fdump-tree-reassoc2-details" } */
+
+/* An out-of-order core keeps four additions of the sum in flight.  */
+
+long
+foo (long a, long b, long c, long d, long e, long f, long g, long h)
+{
+  return a + b + c + d + e + f + g + h;
+}
+
+/* { dg-final { scan-tree-dump "Width = 4 was chosen for reassociation" "reassoc2" } } */
@@ -0,0 +1,10 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64 -fdump-rtl-related_consts" } */
+
+long
+test_related (long a, long b)
+{
+  return (a ^ 0x123456789abcdefL) + (b ^ 0x123456789abcdf7L);
+}
+
+/* { dg-final { scan-rtl-dump "derived" "related_consts" } } */
@@ -0,0 +1,16 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64 -fdump-rtl-mach -fdump-rtl-rnreg" } */
+
+long
+sum (long *a, long n)
+{
+  long s = 0;
+  for (long i = 0; i < n; i++)
+    s += a[i] * a[i + 1];
+  return s;
+}
+
+/* Register renaming runs by default for RVC and the machine-dependent
+   pass reports how many register references RVC can encode.  */
+/* { dg-final { scan-rtl-dump "Register " "rnreg" } } */
+/* { dg-final { scan-rtl-dump "RVC-encodable register references: \[0-9\]+ of \[0-9\]+" "mach" } } */
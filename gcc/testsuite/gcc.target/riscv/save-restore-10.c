@@ -0,0 +1,26 @@
+/* { dg-options "-O2 -msave-restore" } */
+
+/* Hot functions should save and restore registers inline even with
+   -msave-restore; other functions should still use the stubs.  */
+
+extern void fn3 (int *);
+
+__attribute__((hot)) int
+fn1 (void)
+{
+  int a[4];
+  fn3 (a);
+  return a[0];
+}
+
+int
+fn2 (void)
+{
+  int a[4];
+  fn3 (a);
+  return a[1];
+}
+
+/* { dg-final { scan-assembler-times "call\[ \t\]*t0,__riscv_save_0" 1 } } */
+/* { dg-final { scan-assembler-times "tail\[ \t\]*__riscv_restore_0" 1 } } */
+/* { dg-final { scan-assembler "fn1:\n\[^\n\]*addi\[ \t\]*sp,sp,-" } } */
@@ -0,0 +1,19 @@
+/* Verify that with -fipa-ra a value live across calls to a cheap local
+   function stays in a caller-saved register, so no millicode save is
+   needed.  */
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d -msave-restore -fipa-ra" } */
+
+static int __attribute__ ((noinline))
+add1 (int x)
+{
+  return x + 1;
+}
+
+int
+foo (int a, int b)
+{
+  return add1 (a) + add1 (b) + a;
+}
+/* { dg-final { scan-assembler-not "__riscv_save" } } */
+/* { dg-final { scan-assembler-not "s\[wd\]\ts\[0-9\]+," } } */
@@ -0,0 +1,17 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64 -mcmodel=medlow -mno-relax" } */
+
+int a, b, c;
+
+void
+foo (int x)
+{
+  a = x;
+  b = x + 1;
+  c = x + 2;
+}
+
+/* Without linker relaxation, small globals are not put in small data
+   and the three stores share one section anchor.  */
+/* { dg-final { scan-assembler-not "\\.sbss" } } */
+/* { dg-final { scan-assembler-times "%hi\\(" 1 } } */
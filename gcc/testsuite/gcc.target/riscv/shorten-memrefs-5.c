@@ -44,10 +44,6 @@ load2r (long long *array)
 }
 
 /* { dg-final { scan-assembler "store1a:\n\taddi" } } */
-/* The sd insns in store2a are not rewritten because shorten_memrefs currently
-   only optimizes lw and sw.
-/* { dg-final { scan-assembler "store2a:\n\taddi" { xfail riscv*-*-* } } } */
+/* { dg-final { scan-assembler "store2a:\n\taddi" } } */
 /* { dg-final { scan-assembler "load1r:\n\taddi" } } */
-/* The ld insns in load2r are not rewritten because shorten_memrefs currently
-   only optimizes lw and sw.
-/* { dg-final { scan-assembler "load2r:\n\taddi" { xfail riscv*-*-* } } } */
+/* { dg-final { scan-assembler "load2r:\n\taddi" } } */
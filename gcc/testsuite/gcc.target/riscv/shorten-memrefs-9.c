@@ -0,0 +1,16 @@
+/* { dg-options "-Os -march=rv64imafdc -mabi=lp64d -fdump-rtl-shorten_memrefs" } */
+
+/* Doubleword FP loads and stores have compressed forms too, so
+   shorten_memrefs should rewrite their addresses.  */
+
+void
+store3a (double *array, double a)
+{
+  array[200] = a;
+  array[201] = a;
+  array[202] = a;
+  array[203] = a;
+}
+
+/* { dg-final { scan-assembler "store3a:\n\taddi" } } */
+/* { dg-final { scan-rtl-dump "store3a: 4 of 4 loads/stores have compressible addresses" "shorten_memrefs" } } */
@@ -0,0 +1,22 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d -fshrink-wrap-separate" } */
+
+/* The fast path only needs the return address; s0 and s1 should be saved
+   only on the path that uses them.  */
+
+extern int work (int);
+
+int
+handler (int x)
+{
+  if (__builtin_expect (x == 0, 1))
+    return work (0) + 1;
+
+  int a = work (x);
+  int b = work (a);
+  int c = work (b);
+  return a + b + c;
+}
+
+/* { dg-final { scan-assembler "sd\tra,\[0-9\]+\\(sp\\)\n\tbne" } } */
+/* { dg-final { scan-assembler-times "sd\ts0," 1 } } */
@@ -0,0 +1,20 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fopenmp-simd -march=rv64gcv -mabi=lp64d" } */
+
+#pragma omp declare simd notinbranch
+double
+f (double x)
+{
+  return x * 2.0 + 1.0;
+}
+
+void
+g (double *a, int n)
+{
+#pragma omp simd
+  for (int i = 0; i < n; i++)
+    a[i] = f (a[i]);
+}
+
+/* { dg-final { scan-assembler "_ZGVrN2v_f:" } } */
+/* { dg-final { scan-assembler "call\t_ZGVrN2v_f" } } */
@@ -0,0 +1,13 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -g -gdwarf-5 -gsplit-dwarf -mrelax" } */
+
+/* With linker relaxation the size of a function is only known at link
+   time, so its DW_AT_high_pc in the .dwo must be an address index.  */
+
+int
+foo (int x)
+{
+  return x * 3 + 1;
+}
+
+/* { dg-final { scan-assembler-not {\.LFE0-\.LFB0} } } */
@@ -0,0 +1,10 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -g -gdwarf-5 -gsplit-dwarf -mno-relax" } */
+
+int
+foo (int x)
+{
+  return x * 3 + 1;
+}
+
+/* { dg-final { scan-assembler {\.LFE0-\.LFB0} } } */
@@ -0,0 +1,31 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zbb -mabi=lp64 -mtune=rocket" } */
+
+/* With Zbb, strlen, and strcmp and strncmp of word-aligned strings, are
+   expanded to scan a word at a time with orc.b.  */
+
+char a[32] __attribute__ ((aligned (8)));
+char b[32] __attribute__ ((aligned (8)));
+
+__SIZE_TYPE__
+length (const char *s)
+{
+  return __builtin_strlen (s);
+}
+
+int
+compare (void)
+{
+  return __builtin_strcmp (a, b);
+}
+
+int
+compare_n (void)
+{
+  return __builtin_strncmp (a, b, 12);
+}
+
+/* { dg-final { scan-assembler-times "orc.b\t" 6 } } */
+/* { dg-final { scan-assembler-not "call\tstrlen" } } */
+/* { dg-final { scan-assembler-not "call\tstrncmp" } } */
+/* { dg-final { scan-assembler-times "call\tstrcmp" 1 } } */
@@ -0,0 +1,18 @@
+/* { dg-do compile } */
+/* { dg-options "-O2" } */
+
+/* A jump table whose targets are all close to the dispatch is emitted
+   with byte offsets.  */
+extern int asdf (int);
+int foo (int x) {
+  switch (x) {
+  case 0: return asdf (10);
+  case 1: return asdf (11);
+  case 2: return asdf (12);
+  case 3: return asdf (13);
+  case 4: return asdf (14);
+  }
+  return 0;
+}
+/* { dg-final { scan-assembler "\\.byte\t\\.L\[0-9\]+-\\.Lrtx\[0-9\]+" } } */
+/* { dg-final { scan-assembler "lb\t" } } */
@@ -0,0 +1,26 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d" } */
+
+__attribute__ ((target ("arch=+zbb")))
+long
+popcount_zbb (long x)
+{
+  return __builtin_popcountl (x);
+}
+
+__attribute__ ((target ("arch=rv64gc_zbb;tune=sifive-7-series")))
+long
+popcount_full (long x)
+{
+  return __builtin_popcountl (x);
+}
+
+long
+popcount_base (long x)
+{
+  return __builtin_popcountl (x);
+}
+
+/* { dg-final { scan-assembler-times "cpop\t" 2 } } */
+/* { dg-final { scan-assembler-times "\\.option arch, rv64" 2 } } */
+/* { dg-final { scan-assembler-times "\\.option pop" 2 } } */
@@ -0,0 +1,14 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d" } */
+
+__attribute__ ((target ("arch=rv32gc")))
+void f1 (void) {} /* { dg-error "cannot change the XLEN" } */
+
+__attribute__ ((target ("arch=rv64imac")))
+void f2 (void) {} /* { dg-error "floating-point extension" } */
+
+__attribute__ ((target ("arch=zbb")))
+void f3 (void) {} /* { dg-error "" } */
+
+__attribute__ ((target ("cpu=rocket")))
+void f4 (void) {} /* { dg-error "is unknown" } */
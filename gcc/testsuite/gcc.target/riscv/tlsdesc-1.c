@@ -0,0 +1,17 @@
+/* { dg-do compile } */
+/* { dg-require-effective-target fpic } */
+/* { dg-options "-O2 -march=rv64gc -mabi=lp64d -fpic -mtls-dialect=desc" } */
+
+extern __thread int x;
+
+int
+foo (void)
+{
+  return x;
+}
+
+/* { dg-final { scan-assembler "auipc\ta0,%tlsdesc_hi\\(x\\)" } } */
+/* { dg-final { scan-assembler "ld\tt0,%tlsdesc_load_lo" } } */
+/* { dg-final { scan-assembler "addi\ta0,a0,%tlsdesc_add_lo" } } */
+/* { dg-final { scan-assembler "jalr\tt0,t0,%tlsdesc_call" } } */
+/* { dg-final { scan-assembler-not "__tls_get_addr" } } */
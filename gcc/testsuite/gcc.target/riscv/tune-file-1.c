@@ -0,0 +1,14 @@
+/* { dg-do compile } */
+/* { dg-options "-march=rv64gc -mabi=lp64d -O2 -mtune=rocket -mtune-file=$srcdir/gcc.target/riscv/tune-file-1.tune" } */
+
+/* With a single-cycle multiplier, multiplying by 10 should not be
+   expanded into shifts and adds.  */
+
+long
+foo (long x)
+{
+  return x * 10;
+}
+
+/* { dg-final { scan-assembler "mul\t" } } */
+/* { dg-final { scan-assembler-not "slli\t" } } */
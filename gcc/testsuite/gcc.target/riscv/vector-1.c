@@ -0,0 +1,23 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -march=rv64gcv -mabi=lp64d" } */
+
+void
+foo (int *restrict a, int *restrict b, int *restrict c, int n)
+{
+  for (int i = 0; i < n; i++)
+    a[i] = b[i] + c[i];
+}
+
+void
+bar (float *restrict a, float *restrict b, float x, int n)
+{
+  for (int i = 0; i < n; i++)
+    a[i] += b[i] * x;
+}
+
+/* { dg-final { scan-assembler "vadd\\.vv" } } */
+/* { dg-final { scan-assembler "vfmacc\\.vv" } } */
+/* { dg-final { scan-assembler "vfmv\\.v\\.f" } } */
+/* { dg-final { scan-assembler "vsetvli\tzero,\[a-z0-9\]+,e8,m1,ta,ma" } } */
+/* { dg-final { scan-assembler "vle8\\.v" } } */
+/* { dg-final { scan-assembler "vse8\\.v" } } */
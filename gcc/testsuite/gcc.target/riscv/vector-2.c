@@ -0,0 +1,24 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -march=rv64gcv -mabi=lp64d" } */
+
+int
+sum (int *a, int n)
+{
+  int s = 0;
+  for (int i = 0; i < n; i++)
+    s += a[i];
+  return s;
+}
+
+unsigned char
+umax (unsigned char *a, int n)
+{
+  unsigned char m = 0;
+  for (int i = 0; i < n; i++)
+    m = a[i] > m ? a[i] : m;
+  return m;
+}
+
+/* { dg-final { scan-assembler "vredsum\\.vs" } } */
+/* { dg-final { scan-assembler "vredmaxu\\.vs" } } */
+/* { dg-final { scan-assembler "vmv\\.x\\.s" } } */
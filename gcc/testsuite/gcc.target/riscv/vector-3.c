@@ -0,0 +1,34 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gcv -mabi=lp64d" } */
+
+#include <riscv_vector.h>
+
+void
+add (int8_t *d, const int8_t *a, const int8_t *b, size_t n)
+{
+  for (size_t vl; n > 0; n -= vl, d += vl, a += vl, b += vl)
+    {
+      vl = __riscv_vsetvl_e8m1 (n);
+      vint8m1_t va = __riscv_vle8_v_i8m1 (a, vl);
+      vint8m1_t vb = __riscv_vle8_v_i8m1 (b, vl);
+      __riscv_vse8_v_i8m1 (d, __riscv_vadd_vv_i8m1 (va, vb, vl), vl);
+    }
+}
+
+int32_t
+sum (const int32_t *a, size_t n)
+{
+  vint32m1_t s = __riscv_vmv_s_x_i32m1 (0, 1);
+  for (size_t vl; n > 0; n -= vl, a += vl)
+    {
+      vl = __riscv_vsetvl_e32m1 (n);
+      vint32m1_t va = __riscv_vle32_v_i32m1 (a, vl);
+      s = __riscv_vredsum_vs_i32m1_i32m1 (va, s, vl);
+    }
+  return __riscv_vmv_x_s_i32m1_i32 (s);
+}
+
+/* { dg-final { scan-assembler "vle8\\.v" } } */
+/* { dg-final { scan-assembler "vse8\\.v" } } */
+/* { dg-final { scan-assembler "vadd\\.vv" } } */
+/* { dg-final { scan-assembler "vredsum\\.vs" } } */
@@ -0,0 +1,28 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gcv -mabi=lp64d" } */
+
+typedef int v4si __attribute__ ((vector_size (16)));
+
+extern void g (void);
+
+/* One VSETIVLI, hoisted out of the loop.  */
+
+void
+f1 (v4si *a, v4si *b, int n)
+{
+  for (int i = 0; i < n; i++)
+    a[i] += b[i] * b[i];
+}
+
+/* The call leaves VL and VTYPE unknown, so the second addition needs a
+   VSETIVLI of its own.  */
+
+void
+f2 (v4si *a)
+{
+  a[0] += a[1];
+  g ();
+  a[2] += a[3];
+}
+
+/* { dg-final { scan-assembler-times "vsetivli\tzero,4,e32,m1,ta,ma" 3 } } */
@@ -0,0 +1,52 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zba -mabi=lp64" } */
+
+long
+test_sh1add (long *a, long i)
+{
+  return (long) ((short *) a + i);
+}
+
+long
+test_sh2add (int *a, long i)
+{
+  return a[i];
+}
+
+long
+test_sh3add (long *a, long i)
+{
+  return a[i];
+}
+
+long
+test_sh3adduw (long *a, unsigned int i)
+{
+  return a[i];
+}
+
+unsigned long
+test_adduw (unsigned long a, unsigned int b)
+{
+  return a + b;
+}
+
+unsigned long
+test_slliuw (unsigned int a)
+{
+  return (unsigned long) a << 5;
+}
+
+unsigned long
+test_zextw (unsigned int a)
+{
+  return a;
+}
+
+/* { dg-final { scan-assembler "sh1add\t" } } */
+/* { dg-final { scan-assembler "sh2add\t" } } */
+/* { dg-final { scan-assembler "sh3add\t" } } */
+/* { dg-final { scan-assembler "sh3add.uw\t" } } */
+/* { dg-final { scan-assembler "add.uw\t" } } */
+/* { dg-final { scan-assembler "slli.uw\t" } } */
+/* { dg-final { scan-assembler "zext.w\t" } } */
@@ -0,0 +1,53 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zbb -mabi=lp64" } */
+
+long test_andn (long a, long b) { return a & ~b; }
+long test_orn (long a, long b) { return a | ~b; }
+long test_xnor (long a, long b) { return ~(a ^ b); }
+
+long test_min (long a, long b) { return a < b ? a : b; }
+long test_max (long a, long b) { return a > b ? a : b; }
+unsigned long test_minu (unsigned long a, unsigned long b) { return a < b ? a : b; }
+unsigned long test_maxu (unsigned long a, unsigned long b) { return a > b ? a : b; }
+
+int test_clz (unsigned long a) { return __builtin_clzl (a); }
+int test_ctz (unsigned long a) { return __builtin_ctzl (a); }
+int test_cpop (unsigned long a) { return __builtin_popcountl (a); }
+int test_clzw (unsigned int a) { return __builtin_clz (a); }
+int test_ctzw (unsigned int a) { return __builtin_ctz (a); }
+int test_cpopw (unsigned int a) { return __builtin_popcount (a); }
+
+unsigned long test_rev8 (unsigned long a) { return __builtin_bswap64 (a); }
+
+long test_sextb (long a) { return (signed char) a; }
+long test_sexth (long a) { return (short) a; }
+unsigned long test_zexth (unsigned long a) { return (unsigned short) a; }
+
+unsigned long test_ror (unsigned long a, int s) { return (a >> s) | (a << (64 - s)); }
+unsigned long test_rol (unsigned long a, int s) { return (a << s) | (a >> (64 - s)); }
+unsigned long test_rori (unsigned long a) { return (a >> 13) | (a << 51); }
+unsigned int test_roriw (unsigned int a) { return (a >> 13) | (a << 19); }
+
+/* { dg-final { scan-assembler "andn\t" } } */
+/* { dg-final { scan-assembler "orn\t" } } */
+/* { dg-final { scan-assembler "xnor\t" } } */
+/* { dg-final { scan-assembler "min\t" } } */
+/* { dg-final { scan-assembler "max\t" } } */
+/* { dg-final { scan-assembler "minu\t" } } */
+/* { dg-final { scan-assembler "maxu\t" } } */
+/* { dg-final { scan-assembler "clz\t" } } */
+/* { dg-final { scan-assembler "ctz\t" } } */
+/* { dg-final { scan-assembler "cpop\t" } } */
+/* { dg-final { scan-assembler "clzw\t" } } */
+/* { dg-final { scan-assembler "ctzw\t" } } */
+/* { dg-final { scan-assembler "cpopw\t" } } */
+/* { dg-final { scan-assembler "rev8\t" } } */
+/* { dg-final { scan-assembler "sext.b\t" } } */
+/* { dg-final { scan-assembler "sext.h\t" } } */
+/* { dg-final { scan-assembler "zext.h\t" } } */
+/* { dg-final { scan-assembler "ror\t" } } */
+/* { dg-final { scan-assembler "rol\t" } } */
+/* { dg-final { scan-assembler "rori\t" } } */
+/* { dg-final { scan-assembler "roriw\t" } } */
+/* { dg-final { scan-assembler-not "__popcount" } } */
+/* { dg-final { scan-assembler-not "__clz" } } */
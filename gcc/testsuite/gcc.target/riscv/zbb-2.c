@@ -0,0 +1,7 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zbb -mabi=lp64" } */
+
+long test_rotated (void) { return 0xfff0ffffffffffffL; }
+
+/* { dg-final { scan-assembler "rori\t\[^\n\]*,16" } } */
+/* { dg-final { scan-assembler-not "slli\t" } } */
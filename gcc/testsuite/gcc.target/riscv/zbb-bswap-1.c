@@ -0,0 +1,31 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zbb -mabi=lp64d -mtune=generic-ooo" } */
+
+/* Byte-wise big-endian accesses on a core with fast misaligned access
+   become single word accesses and a byte reverse.  */
+
+unsigned int
+get32 (const unsigned char *p)
+{
+  return ((unsigned int) p[0] << 24) | ((unsigned int) p[1] << 16)
+	 | ((unsigned int) p[2] << 8) | p[3];
+}
+
+void
+put32 (unsigned char *p, unsigned int x)
+{
+  p[0] = x >> 24;
+  p[1] = x >> 16;
+  p[2] = x >> 8;
+  p[3] = x;
+}
+
+unsigned short
+get16 (const unsigned char *p)
+{
+  return (p[0] << 8) | p[1];
+}
+
+/* { dg-final { scan-assembler-times "rev8\t" 3 } } */
+/* { dg-final { scan-assembler-not "lbu\t" } } */
+/* { dg-final { scan-assembler-not "sb\t" } } */
@@ -0,0 +1,31 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zbkb -mabi=lp64" } */
+
+long test_andn (long a, long b) { return a & ~b; }
+long test_orn (long a, long b) { return a | ~b; }
+long test_xnor (long a, long b) { return ~(a ^ b); }
+
+unsigned long test_rev8 (unsigned long a) { return __builtin_bswap64 (a); }
+
+unsigned long test_ror (unsigned long a, int s) { return (a >> s) | (a << (64 - s)); }
+unsigned long test_rol (unsigned long a, int s) { return (a << s) | (a >> (64 - s)); }
+unsigned long test_rori (unsigned long a) { return (a >> 13) | (a << 51); }
+unsigned int test_roriw (unsigned int a) { return (a >> 13) | (a << 19); }
+
+unsigned long test_pack_idiom (unsigned int a, unsigned long b) { return a | (b << 32); }
+
+unsigned long test_pack (unsigned long a, unsigned long b) { return __builtin_riscv_pack (a, b); }
+unsigned long test_packh (unsigned long a, unsigned long b) { return __builtin_riscv_packh (a, b); }
+unsigned long test_brev8 (unsigned long a) { return __builtin_riscv_brev8 (a); }
+
+/* { dg-final { scan-assembler "andn\t" } } */
+/* { dg-final { scan-assembler "orn\t" } } */
+/* { dg-final { scan-assembler "xnor\t" } } */
+/* { dg-final { scan-assembler "rev8\t" } } */
+/* { dg-final { scan-assembler "ror\t" } } */
+/* { dg-final { scan-assembler "rol\t" } } */
+/* { dg-final { scan-assembler "rori\t" } } */
+/* { dg-final { scan-assembler "roriw\t" } } */
+/* { dg-final { scan-assembler-times "pack\t" 2 } } */
+/* { dg-final { scan-assembler "packh\t" } } */
+/* { dg-final { scan-assembler "brev8\t" } } */
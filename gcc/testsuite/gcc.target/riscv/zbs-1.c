@@ -0,0 +1,22 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zbs -mabi=lp64" } */
+
+long test_bset (long a, int b) { return a | (1L << b); }
+long test_bset_mask (long a, int b) { return a | (1L << (b & 63)); }
+long test_bset_1 (int b) { return 1L << b; }
+long test_bseti (long a) { return a | (1L << 40); }
+long test_bclr (long a, int b) { return a & ~(1L << b); }
+long test_bclri (long a) { return a & ~(1L << 40); }
+long test_binv (long a, int b) { return a ^ (1L << b); }
+long test_binvi (long a) { return a ^ (1L << 40); }
+long test_bext (long a, int b) { return (a >> b) & 1; }
+long test_bexti (long a) { return (a >> 40) & 1; }
+
+/* { dg-final { scan-assembler-times "bset\t" 3 } } */
+/* { dg-final { scan-assembler "bseti\t\[^\n\]*,40" } } */
+/* { dg-final { scan-assembler "bclr\t" } } */
+/* { dg-final { scan-assembler "bclri\t\[^\n\]*,40" } } */
+/* { dg-final { scan-assembler "binv\t" } } */
+/* { dg-final { scan-assembler "binvi\t\[^\n\]*,40" } } */
+/* { dg-final { scan-assembler "bext\t" } } */
+/* { dg-final { scan-assembler "bexti\t\[^\n\]*,40" } } */
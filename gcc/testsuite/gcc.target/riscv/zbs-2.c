@@ -0,0 +1,11 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zbs -mabi=lp64" } */
+
+long test_bit (void) { return 1L << 40; }
+long test_fnv_prime (void) { return 0x100000001b3L; }
+long test_mask (void) { return 0xfffffeff92345678L; }
+
+/* { dg-final { scan-assembler "bseti\t\[^\n\]*,zero,40" } } */
+/* { dg-final { scan-assembler-times "bseti\t" 2 } } */
+/* { dg-final { scan-assembler "bclri\t\[^\n\]*,40" } } */
+/* { dg-final { scan-assembler-not "slli\t" } } */
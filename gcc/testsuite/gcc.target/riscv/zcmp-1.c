@@ -0,0 +1,20 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv32imac_zcmp -mabi=ilp32 -fomit-frame-pointer" } */
+
+/* The callee-saved registers are saved with cm.push and restored with
+   cm.popret, which also allocate and free the rest of the small frame.  */
+
+extern int g (int);
+
+int
+f (int a, int b)
+{
+  int x = g (a);
+  int y = g (b);
+  return x + y + a;
+}
+
+/* { dg-final { scan-assembler "cm.push\t\{ra, s0(-s\[0-9\]+)?\}, -\[0-9\]+" } } */
+/* { dg-final { scan-assembler "cm.popret\t\{ra, s0(-s\[0-9\]+)?\}, \[0-9\]+" } } */
+/* { dg-final { scan-assembler-not "__riscv_save" } } */
+/* { dg-final { scan-assembler-not "addi\tsp" } } */
@@ -0,0 +1,6 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zcmp -mabi=lp64d" } */
+int foo()
+{
+}
+/* { dg-error ".'-march=rv64gc_zcmp': 'zcmp' and 'zcmt' cannot be combined with 'c' and 'd'" "" { target *-*-* } 0 } */
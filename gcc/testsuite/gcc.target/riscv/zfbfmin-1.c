@@ -0,0 +1,9 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zfbfmin -mabi=lp64d" } */
+
+float test_extend (__bf16 a) { return a; }
+__bf16 test_trunc (float a) { return a; }
+void test_copy (__bf16 *p, __bf16 *q) { *p = *q; }
+
+/* { dg-final { scan-assembler "fcvt.s.bf16" } } */
+/* { dg-final { scan-assembler "fcvt.bf16.s" } } */
@@ -0,0 +1,5 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zfbfmin -mabi=lp64d" } */
+
+__bf16 test_add (__bf16 a, __bf16 b) { return a + b; } /* { dg-error "operation not permitted" } */
+__bf16 test_int (int a) { return a; } /* { dg-error "invalid conversion" } */
@@ -0,0 +1,17 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zfh -mabi=lp64d" } */
+
+_Float16 test_add (_Float16 a, _Float16 b) { return a + b; }
+_Float16 test_mul (_Float16 a, _Float16 b) { return a * b; }
+_Float16 test_load (_Float16 *p) { return p[1]; }
+void test_store (_Float16 *p, _Float16 a) { p[1] = a; }
+int test_lt (_Float16 a, _Float16 b) { return a < b; }
+long test_fix (_Float16 a) { return a; }
+
+/* { dg-final { scan-assembler "fadd.h" } } */
+/* { dg-final { scan-assembler "fmul.h" } } */
+/* { dg-final { scan-assembler "flh" } } */
+/* { dg-final { scan-assembler "fsh" } } */
+/* { dg-final { scan-assembler "flt.h" } } */
+/* { dg-final { scan-assembler "fcvt.l.h" } } */
+/* { dg-final { scan-assembler-not "fcvt.s.h" } } */
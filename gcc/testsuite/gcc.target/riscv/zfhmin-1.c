@@ -0,0 +1,14 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zfhmin -mabi=lp64d" } */
+
+_Float16 test_add (_Float16 a, _Float16 b) { return a + b; }
+float test_extend (_Float16 a) { return a; }
+_Float16 test_trunc (double a) { return a; }
+void test_copy (_Float16 *p, _Float16 *q) { *p = *q; }
+
+/* { dg-final { scan-assembler "fcvt.s.h" } } */
+/* { dg-final { scan-assembler "fcvt.h.s" } } */
+/* { dg-final { scan-assembler "fcvt.h.d" } } */
+/* { dg-final { scan-assembler "flh" } } */
+/* { dg-final { scan-assembler "fsh" } } */
+/* { dg-final { scan-assembler-not "fadd.h" } } */
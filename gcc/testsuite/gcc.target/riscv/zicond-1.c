@@ -0,0 +1,11 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zicond -mabi=lp64" } */
+
+long test_eqz (long a, long b) { return a == 0 ? 0 : b; }
+long test_nez (long a, long b) { return a != 0 ? 0 : b; }
+long test_select (long a, long b, long c, long d) { return a < b ? c : d; }
+int test_select_si (int a, int b, int c, int d) { return a == b ? c : d; }
+
+/* { dg-final { scan-assembler "czero.eqz\t" } } */
+/* { dg-final { scan-assembler "czero.nez\t" } } */
+/* { dg-final { scan-assembler-not "\tb\[a-z\]+\t" } } */
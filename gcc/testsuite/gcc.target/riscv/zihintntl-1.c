@@ -0,0 +1,22 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zihintntl -mabi=lp64d" } */
+
+/* Copies of 256 KiB or more bypass the caches.  */
+
+long big_dst[32768], big_src[32768];
+long small_dst[64], small_src[64];
+
+void
+copy_big (void)
+{
+  __builtin_memcpy (big_dst, big_src, sizeof big_dst);
+}
+
+void
+copy_small (void)
+{
+  __builtin_memcpy (small_dst, small_src, sizeof small_dst);
+}
+
+/* { dg-final { scan-assembler-times "ntl\\.all\n\tld\t" 4 } } */
+/* { dg-final { scan-assembler-times "ntl\\.all\n\tsd\t" 4 } } */
@@ -0,0 +1,25 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gcv_zihintntl -mabi=lp64d" } */
+
+char big[1 << 20], small[1024];
+
+void
+copy_big (void)
+{
+  __builtin_memcpy (big, big + sizeof big / 2, sizeof big / 2);
+}
+
+void
+set_big (void)
+{
+  __builtin_memset (big, 1, sizeof big);
+}
+
+void
+set_small (void)
+{
+  __builtin_memset (small, 1, sizeof small);
+}
+
+/* { dg-final { scan-assembler-times "ntl\\.all; vle8\\.v" 1 } } */
+/* { dg-final { scan-assembler-times "ntl\\.all; vse8\\.v" 2 } } */
@@ -0,0 +1,22 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zkn -mabi=lp64" } */
+
+unsigned long test_aes64es (unsigned long a, unsigned long b) { return __builtin_riscv_aes64es (a, b); }
+unsigned long test_aes64esm (unsigned long a, unsigned long b) { return __builtin_riscv_aes64esm (a, b); }
+unsigned long test_aes64ds (unsigned long a, unsigned long b) { return __builtin_riscv_aes64ds (a, b); }
+unsigned long test_aes64dsm (unsigned long a, unsigned long b) { return __builtin_riscv_aes64dsm (a, b); }
+unsigned long test_aes64im (unsigned long a) { return __builtin_riscv_aes64im (a); }
+unsigned long test_aes64ks1i (unsigned long a) { return __builtin_riscv_aes64ks1i (a, 10); }
+unsigned long test_aes64ks2 (unsigned long a, unsigned long b) { return __builtin_riscv_aes64ks2 (a, b); }
+
+/* Zkn also provides Zbkb.  */
+unsigned long test_rev8 (unsigned long a) { return __builtin_bswap64 (a); }
+
+/* { dg-final { scan-assembler "aes64es\t" } } */
+/* { dg-final { scan-assembler "aes64esm\t" } } */
+/* { dg-final { scan-assembler "aes64ds\t" } } */
+/* { dg-final { scan-assembler "aes64dsm\t" } } */
+/* { dg-final { scan-assembler "aes64im\t" } } */
+/* { dg-final { scan-assembler "aes64ks1i\t\[a-z0-9\]+,\[a-z0-9\]+,10" } } */
+/* { dg-final { scan-assembler "aes64ks2\t" } } */
+/* { dg-final { scan-assembler "rev8\t" } } */
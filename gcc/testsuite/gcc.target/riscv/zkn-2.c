@@ -0,0 +1,12 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv32gc_zknd_zkne -mabi=ilp32" } */
+
+unsigned int test_aes32esi (unsigned int a, unsigned int b) { return __builtin_riscv_aes32esi (a, b, 1); }
+unsigned int test_aes32esmi (unsigned int a, unsigned int b) { return __builtin_riscv_aes32esmi (a, b, 2); }
+unsigned int test_aes32dsi (unsigned int a, unsigned int b) { return __builtin_riscv_aes32dsi (a, b, 3); }
+unsigned int test_aes32dsmi (unsigned int a, unsigned int b) { return __builtin_riscv_aes32dsmi (a, b, 0); }
+
+/* { dg-final { scan-assembler "aes32esi\t\[a-z0-9\]+,\[a-z0-9\]+,\[a-z0-9\]+,1" } } */
+/* { dg-final { scan-assembler "aes32esmi\t\[a-z0-9\]+,\[a-z0-9\]+,\[a-z0-9\]+,2" } } */
+/* { dg-final { scan-assembler "aes32dsi\t\[a-z0-9\]+,\[a-z0-9\]+,\[a-z0-9\]+,3" } } */
+/* { dg-final { scan-assembler "aes32dsmi\t\[a-z0-9\]+,\[a-z0-9\]+,\[a-z0-9\]+,0" } } */
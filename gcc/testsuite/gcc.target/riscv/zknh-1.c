@@ -0,0 +1,21 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_zknh -mabi=lp64" } */
+
+unsigned int test_sha256sig0 (unsigned int a) { return __builtin_riscv_sha256sig0 (a); }
+unsigned int test_sha256sig1 (unsigned int a) { return __builtin_riscv_sha256sig1 (a); }
+unsigned int test_sha256sum0 (unsigned int a) { return __builtin_riscv_sha256sum0 (a); }
+unsigned int test_sha256sum1 (unsigned int a) { return __builtin_riscv_sha256sum1 (a); }
+
+unsigned long test_sha512sig0 (unsigned long a) { return __builtin_riscv_sha512sig0 (a); }
+unsigned long test_sha512sig1 (unsigned long a) { return __builtin_riscv_sha512sig1 (a); }
+unsigned long test_sha512sum0 (unsigned long a) { return __builtin_riscv_sha512sum0 (a); }
+unsigned long test_sha512sum1 (unsigned long a) { return __builtin_riscv_sha512sum1 (a); }
+
+/* { dg-final { scan-assembler "sha256sig0\t" } } */
+/* { dg-final { scan-assembler "sha256sig1\t" } } */
+/* { dg-final { scan-assembler "sha256sum0\t" } } */
+/* { dg-final { scan-assembler "sha256sum1\t" } } */
+/* { dg-final { scan-assembler "sha512sig0\t" } } */
+/* { dg-final { scan-assembler "sha512sig1\t" } } */
+/* { dg-final { scan-assembler "sha512sum0\t" } } */
+/* { dg-final { scan-assembler "sha512sum1\t" } } */
@@ -0,0 +1,19 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv32gc_zknh -mabi=ilp32" } */
+
+unsigned int test_sha256sig0 (unsigned int a) { return __builtin_riscv_sha256sig0 (a); }
+
+unsigned int test_sha512sig0h (unsigned int a, unsigned int b) { return __builtin_riscv_sha512sig0h (a, b); }
+unsigned int test_sha512sig0l (unsigned int a, unsigned int b) { return __builtin_riscv_sha512sig0l (a, b); }
+unsigned int test_sha512sig1h (unsigned int a, unsigned int b) { return __builtin_riscv_sha512sig1h (a, b); }
+unsigned int test_sha512sig1l (unsigned int a, unsigned int b) { return __builtin_riscv_sha512sig1l (a, b); }
+unsigned int test_sha512sum0r (unsigned int a, unsigned int b) { return __builtin_riscv_sha512sum0r (a, b); }
+unsigned int test_sha512sum1r (unsigned int a, unsigned int b) { return __builtin_riscv_sha512sum1r (a, b); }
+
+/* { dg-final { scan-assembler "sha256sig0\t" } } */
+/* { dg-final { scan-assembler "sha512sig0h\t" } } */
+/* { dg-final { scan-assembler "sha512sig0l\t" } } */
+/* { dg-final { scan-assembler "sha512sig1h\t" } } */
+/* { dg-final { scan-assembler "sha512sig1l\t" } } */
+/* { dg-final { scan-assembler "sha512sum0r\t" } } */
+/* { dg-final { scan-assembler "sha512sum1r\t" } } */
@@ -0,0 +1,31 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -march=rv64gc_ztso -mabi=lp64" } */
+
+int
+load_acquire (int *p)
+{
+  return __atomic_load_n (p, __ATOMIC_ACQUIRE);
+}
+
+void
+store_release (int *p, int v)
+{
+  __atomic_store_n (p, v, __ATOMIC_RELEASE);
+}
+
+int
+add_seq_cst (int *p, int v)
+{
+  return __atomic_fetch_add (p, v, __ATOMIC_SEQ_CST);
+}
+
+void
+fence_acq_rel (void)
+{
+  __atomic_thread_fence (__ATOMIC_ACQ_REL);
+}
+
+/* Under Ztso only sequentially-consistent fences survive.  */
+/* { dg-final { scan-assembler-not "fence" } } */
+/* { dg-final { scan-assembler-not "\\.aq" } } */
+/* { dg-final { scan-assembler-not "\\.rl" } } */
@@ -0,0 +1,53 @@
+! { dg-do run }
+! Check the exact conversions used for formatted REAL(4) and REAL(8)
+! output and input against known results and by round trips.
+program fmt_real_fast
+  implicit none
+  character(len=40) :: s
+  real(8) :: x, y
+  real(4) :: a, b
+  integer :: i
+
+  write (s, '(ES25.17)') 0.1_8
+  if (s /= '  1.00000000000000006E-01') STOP 1
+  write (s, '(ES25.17)') -1.0e300_8
+  if (s /= ' -1.00000000000000005+300') STOP 2
+  write (s, '(E15.8)') 9.9999999e-5_8
+  if (s /= ' 0.99999999E-04') STOP 3
+  write (s, '(F5.2)') 0.125_8
+  if (s /= ' 0.12') STOP 4
+  write (s, '(F5.2)') 0.375_8
+  if (s /= ' 0.38') STOP 5
+  write (s, '(F3.0)') 2.5_8
+  if (s /= ' 2.') STOP 6
+  write (s, '(F12.5)') -1234.56789_4
+  if (s /= ' -1234.56787') STOP 7
+  write (s, '(ES12.5)') 0.0_8
+  if (s /= ' 0.00000E+00') STOP 8
+
+  s = '-0.000123456789012345'
+  read (s, *) x
+  if (x /= -0.000123456789012345_8) STOP 9
+  s = '1.5d22'
+  read (s, *) x
+  if (x /= 1.5e22_8) STOP 10
+  s = '  7.25E-3'
+  read (s, '(E10.3)') a
+  if (a /= 7.25e-3_4) STOP 11
+
+  x = 1.0_8
+  a = 1.0_4
+  do i = 1, 600
+    x = x * 1.37_8 + 1.0_8 / real (i, 8)
+    if (i <= 120) a = a * 1.37_4 - 1.0_4 / real (i, 4)
+    write (s, *) x
+    read (s, *) y
+    if (x /= y) STOP 12
+    write (s, *) 1.0_8 / x
+    read (s, *) y
+    if (1.0_8 / x /= y) STOP 13
+    write (s, *) a
+    read (s, *) b
+    if (a /= b) STOP 14
+  end do
+end program fmt_real_fast
@@ -0,0 +1,52 @@
+! { dg-do run }
+! { dg-options "-O2" }
+! Check array assignments whose operands may overlap, which are
+! versioned on a run-time overlap check.
+program main
+  implicit none
+  real, target :: a(10), b(10)
+  real, pointer :: p(:), q(:)
+  integer :: i, k
+
+  a = [(real(i), i = 1, 10)]
+  b = 0
+  p => a
+  q => b
+  q = p + 1
+  if (any (b /= [(real(i + 1), i = 1, 10)])) stop 1
+
+  ! Overlap, read ahead of the write.
+  p => a(2:10)
+  q => a(1:9)
+  q = p
+  if (any (a /= [(real(i + 1), i = 1, 9), 10.])) stop 2
+
+  ! Overlap, read behind the write.
+  a = [(real(i), i = 1, 10)]
+  p => a(1:9)
+  q => a(2:10)
+  q = p * 2
+  if (any (a /= [1., (real(2 * i), i = 1, 9)])) stop 3
+
+  ! Sections of the same array with bounds unknown at compile time.
+  a = [(real(i), i = 1, 10)]
+  k = 3
+  call shift (a, k)
+  if (any (a /= [1., 2., 3., 1., 2., 3., 4., 5., 6., 7.])) stop 4
+
+  ! Strided pointers that interleave without overlapping.
+  a = [(real(i), i = 1, 10)]
+  p => a(1:9:2)
+  q => a(2:10:2)
+  q = p + q
+  if (any (a /= [1., 3., 3., 7., 5., 11., 7., 15., 9., 19.])) stop 5
+
+contains
+
+  subroutine shift (x, n)
+    real, intent(inout) :: x(:)
+    integer, intent(in) :: n
+    x(n+1:) = x(1:size (x) - n)
+  end subroutine shift
+
+end program main
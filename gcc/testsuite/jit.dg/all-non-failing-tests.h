@@ -98,6 +98,13 @@
 #undef create_code
 #undef verify_code
 
+/* test-compile-in-subprocess.c: We don't use this one, since the use
+   of gcc_jit_context_set_bool_compile_in_subprocess affects the whole
+   context.  */
+
+/* test-compile-tiered.c: We don't use this one, since it recompiles
+   the context and changes its optimization level.  */
+
 /* test-compound-assignment.c */
 #define create_code create_code_compound_assignment
 #define verify_code verify_code_compound_assignment
@@ -286,6 +293,10 @@
 #undef create_code
 #undef verify_code
 
+/* test-use-inprocess-loader.c: We don't use this one, since the use
+   of gcc_jit_context_set_bool_use_inprocess_loader affects the whole
+   context.  */
+
 /* test-using-global.c */
 #define create_code create_code_using_global
 #define verify_code verify_code_using_global
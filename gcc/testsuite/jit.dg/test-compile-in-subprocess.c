@@ -0,0 +1,70 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "libgccjit.h"
+
+#include "harness.h"
+
+void
+create_code (gcc_jit_context *ctxt, void *user_data)
+{
+  /* Let's try to inject the equivalent of:
+
+     int exported_global;
+
+     int
+     test_fn (int i)
+     {
+	exported_global += i;
+	return i * i;
+     }
+
+     compiling it in a subprocess.  */
+  gcc_jit_context_set_bool_compile_in_subprocess (ctxt, 1);
+
+  gcc_jit_type *int_type =
+    gcc_jit_context_get_type (ctxt, GCC_JIT_TYPE_INT);
+
+  gcc_jit_lvalue *exported_global =
+    gcc_jit_context_new_global (ctxt, NULL, GCC_JIT_GLOBAL_EXPORTED,
+				int_type, "exported_global");
+
+  gcc_jit_param *param_i =
+    gcc_jit_context_new_param (ctxt, NULL, int_type, "i");
+  gcc_jit_function *test_fn =
+    gcc_jit_context_new_function (ctxt, NULL, GCC_JIT_FUNCTION_EXPORTED,
+				  int_type, "test_fn", 1, &param_i, 0);
+  gcc_jit_block *block = gcc_jit_function_new_block (test_fn, NULL);
+
+  gcc_jit_rvalue *i = gcc_jit_param_as_rvalue (param_i);
+  gcc_jit_block_add_assignment_op (
+    block, NULL,
+    exported_global,
+    GCC_JIT_BINARY_OP_PLUS,
+    i);
+  gcc_jit_block_end_with_return (
+    block, NULL,
+    gcc_jit_context_new_binary_op (ctxt, NULL, GCC_JIT_BINARY_OP_MULT,
+				   int_type, i, i));
+}
+
+void
+verify_code (gcc_jit_context *ctxt, gcc_jit_result *result)
+{
+  typedef int (*fn_type) (int);
+  CHECK_NON_NULL (result);
+
+  fn_type test_fn =
+    (fn_type)gcc_jit_result_get_code (result, "test_fn");
+  CHECK_NON_NULL (test_fn);
+
+  int *exported_global =
+    (int *)gcc_jit_result_get_global (result, "exported_global");
+  CHECK_NON_NULL (exported_global);
+  CHECK_VALUE (*exported_global, 0);
+
+  CHECK_VALUE (test_fn (5), 25);
+  CHECK_VALUE (*exported_global, 5);
+  CHECK_VALUE (test_fn (-3), 9);
+  CHECK_VALUE (*exported_global, 2);
+}
@@ -0,0 +1,71 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "libgccjit.h"
+
+#include "harness.h"
+
+void
+create_code (gcc_jit_context *ctxt, void *user_data)
+{
+  /* Let's try to inject the equivalent of:
+
+     int
+     test_fn (int i)
+     {
+	return i * i;
+     }
+  */
+  gcc_jit_type *int_type =
+    gcc_jit_context_get_type (ctxt, GCC_JIT_TYPE_INT);
+
+  gcc_jit_param *param_i =
+    gcc_jit_context_new_param (ctxt, NULL, int_type, "i");
+  gcc_jit_function *test_fn =
+    gcc_jit_context_new_function (ctxt, NULL, GCC_JIT_FUNCTION_EXPORTED,
+				  int_type, "test_fn", 1, &param_i, 0);
+  gcc_jit_block *block = gcc_jit_function_new_block (test_fn, NULL);
+
+  gcc_jit_rvalue *i = gcc_jit_param_as_rvalue (param_i);
+  gcc_jit_block_end_with_return (
+    block, NULL,
+    gcc_jit_context_new_binary_op (ctxt, NULL, GCC_JIT_BINARY_OP_MULT,
+				   int_type, i, i));
+}
+
+void
+verify_code (gcc_jit_context *ctxt, gcc_jit_result *result)
+{
+  typedef int (*fn_type) (int);
+  CHECK_NON_NULL (result);
+
+  /* Now compile the same context again, in tiers.  */
+  gcc_jit_context_set_int_option (ctxt,
+				  GCC_JIT_INT_OPTION_OPTIMIZATION_LEVEL,
+				  2);
+  gcc_jit_tiered_result *tiered = gcc_jit_context_compile_tiered (ctxt);
+  CHECK_NON_NULL (tiered);
+
+  void **slot = gcc_jit_tiered_result_get_code_slot (tiered, "test_fn");
+  CHECK_NON_NULL (slot);
+  CHECK_VALUE (gcc_jit_tiered_result_get_code_slot (tiered, "test_fn"),
+	       slot);
+  CHECK_VALUE (gcc_jit_tiered_result_get_code_slot (tiered, "not_a_fn"),
+	       NULL);
+
+  fn_type baseline_fn = (fn_type)__atomic_load_n (slot, __ATOMIC_ACQUIRE);
+  CHECK_NON_NULL (baseline_fn);
+  CHECK_VALUE (baseline_fn (5), 25);
+
+  CHECK_VALUE (gcc_jit_tiered_result_wait (tiered), 1);
+
+  /* The slot should now point at the optimized code, and the baseline
+     code should still be callable.  */
+  fn_type optimized_fn = (fn_type)__atomic_load_n (slot, __ATOMIC_ACQUIRE);
+  CHECK_NON_NULL (optimized_fn);
+  CHECK (optimized_fn != baseline_fn);
+  CHECK_VALUE (optimized_fn (-3), 9);
+  CHECK_VALUE (baseline_fn (-3), 9);
+
+  gcc_jit_tiered_result_release (tiered);
+}
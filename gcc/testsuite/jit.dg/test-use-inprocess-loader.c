@@ -0,0 +1,122 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libgccjit.h"
+
+#include "harness.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  extern int imported_global;
+
+#ifdef __cplusplus
+}
+#endif
+
+void
+create_code (gcc_jit_context *ctxt, void *user_data)
+{
+  /* Let's try to inject the equivalent of:
+
+     int exported_global;
+     extern int imported_global;
+     static int internal_global;
+
+     int
+     test_fn (const char *str)
+     {
+	exported_global += 1;
+	internal_global += 1;
+	return strlen (str) + imported_global + internal_global;
+     }
+
+     loading the result with the in-process loader.  */
+  gcc_jit_context_set_bool_use_inprocess_loader (ctxt, 1);
+
+  gcc_jit_type *int_type =
+    gcc_jit_context_get_type (ctxt, GCC_JIT_TYPE_INT);
+  gcc_jit_type *size_type =
+    gcc_jit_context_get_type (ctxt, GCC_JIT_TYPE_SIZE_T);
+  gcc_jit_type *const_char_ptr_type =
+    gcc_jit_context_get_type (ctxt, GCC_JIT_TYPE_CONST_CHAR_PTR);
+
+  gcc_jit_lvalue *exported_global =
+    gcc_jit_context_new_global (ctxt, NULL, GCC_JIT_GLOBAL_EXPORTED,
+				int_type, "exported_global");
+  gcc_jit_lvalue *imported_global =
+    gcc_jit_context_new_global (ctxt, NULL, GCC_JIT_GLOBAL_IMPORTED,
+				int_type, "imported_global");
+  gcc_jit_lvalue *internal_global =
+    gcc_jit_context_new_global (ctxt, NULL, GCC_JIT_GLOBAL_INTERNAL,
+				int_type, "internal_global");
+
+  gcc_jit_param *param_s =
+    gcc_jit_context_new_param (ctxt, NULL, const_char_ptr_type, "s");
+  gcc_jit_function *strlen_fn =
+    gcc_jit_context_new_function (ctxt, NULL, GCC_JIT_FUNCTION_IMPORTED,
+				  size_type, "strlen", 1, &param_s, 0);
+
+  gcc_jit_param *param_str =
+    gcc_jit_context_new_param (ctxt, NULL, const_char_ptr_type, "str");
+  gcc_jit_function *test_fn =
+    gcc_jit_context_new_function (ctxt, NULL, GCC_JIT_FUNCTION_EXPORTED,
+				  int_type, "test_fn", 1, &param_str, 0);
+  gcc_jit_block *block = gcc_jit_function_new_block (test_fn, NULL);
+
+  gcc_jit_block_add_assignment_op (
+    block, NULL,
+    exported_global,
+    GCC_JIT_BINARY_OP_PLUS,
+    gcc_jit_context_one (ctxt, int_type));
+  gcc_jit_block_add_assignment_op (
+    block, NULL,
+    internal_global,
+    GCC_JIT_BINARY_OP_PLUS,
+    gcc_jit_context_one (ctxt, int_type));
+
+  gcc_jit_rvalue *arg = gcc_jit_param_as_rvalue (param_str);
+  gcc_jit_rvalue *len =
+    gcc_jit_context_new_cast (
+      ctxt, NULL,
+      gcc_jit_context_new_call (ctxt, NULL, strlen_fn, 1, &arg),
+      int_type);
+  gcc_jit_block_end_with_return (
+    block, NULL,
+    gcc_jit_context_new_binary_op (
+      ctxt, NULL, GCC_JIT_BINARY_OP_PLUS, int_type,
+      len,
+      gcc_jit_context_new_binary_op (
+	ctxt, NULL, GCC_JIT_BINARY_OP_PLUS, int_type,
+	gcc_jit_lvalue_as_rvalue (imported_global),
+	gcc_jit_lvalue_as_rvalue (internal_global))));
+}
+
+int imported_global;
+
+void
+verify_code (gcc_jit_context *ctxt, gcc_jit_result *result)
+{
+  typedef int (*fn_type) (const char *);
+  CHECK_NON_NULL (result);
+
+  fn_type test_fn =
+    (fn_type)gcc_jit_result_get_code (result, "test_fn");
+  CHECK_NON_NULL (test_fn);
+
+  int *exported_global =
+    (int *)gcc_jit_result_get_global (result, "exported_global");
+  CHECK_NON_NULL (exported_global);
+  CHECK_VALUE (*exported_global, 0);
+
+  /* The internal global shouldn't be visible.  */
+  CHECK_VALUE (gcc_jit_result_get_global (result, "internal_global"), NULL);
+
+  imported_global = 100;
+  CHECK_VALUE (test_fn ("hello"), 106);
+  CHECK_VALUE (*exported_global, 1);
+  CHECK_VALUE (test_fn (""), 102);
+  CHECK_VALUE (*exported_global, 2);
+}
@@ -42,6 +42,18 @@ struct tms
 # define RUSAGE_SELF 0
 #endif
 
+/* Hardware event counters for -ftime-report-counters come from
+   perf_event_open on Linux hosts.  */
+#if defined (__linux__) && defined (__has_include)
+# if __has_include (<linux/perf_event.h>) && __has_include (<sys/syscall.h>)
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#  ifdef __NR_perf_event_open
+#   define HAVE_PERF_COUNTERS
+#  endif
+# endif
+#endif
+
 /* Calculation of scale factor to convert ticks to microseconds.
    We mustn't use CLOCKS_PER_SEC except with clock().  */
 #if HAVE_SYSCONF && defined _SC_CLK_TCK
@@ -115,6 +127,16 @@ size_t timevar_ggc_mem_total;
 
 #define GGC_MEM_BOUND (1 << 20)
 
+#ifdef HAVE_PERF_COUNTERS
+/* The perf event group leader, or -1 if no events are counted.  */
+static int perf_group_fd = -1;
+
+/* The number of events in the group, and which counter each of them
+   is, in the order in which they are read.  */
+static unsigned perf_n_counters;
+static timevar_counter perf_counters[TVC_LAST];
+#endif
+
 /* See timevar.h for an explanation of timing variables.  */
 
 static void get_time (struct timevar_time_def *);
@@ -178,6 +200,7 @@ timer::named_items::push (const char *item_name)
       def->elapsed.user = 0;
       def->elapsed.sys = 0;
       def->elapsed.wall = 0;
+      memset (def->elapsed.counters, 0, sizeof (def->elapsed.counters));
       def->name = item_name;
       def->standalone = 0;
       m_names.safe_push (item_name);
@@ -220,6 +243,20 @@ get_time (struct timevar_time_def *now)
   now->sys  = 0;
   now->wall = 0;
   now->ggc_mem = timevar_ggc_mem_total;
+  memset (now->counters, 0, sizeof (now->counters));
+
+#ifdef HAVE_PERF_COUNTERS
+  if (perf_group_fd >= 0)
+    {
+      /* With PERF_FORMAT_GROUP, the number of events followed by
+	 their values.  */
+      uint64_t buf[1 + TVC_LAST];
+      ssize_t len = (1 + perf_n_counters) * sizeof (uint64_t);
+      if (read (perf_group_fd, buf, len) == len && buf[0] == perf_n_counters)
+	for (unsigned i = 0; i < perf_n_counters; i++)
+	  now->counters[perf_counters[i]] = buf[1 + i];
+    }
+#endif
 
   {
 #ifdef USE_TIMES
@@ -251,6 +288,58 @@ timevar_accumulate (struct timevar_time_def *timer,
   timer->sys += stop_time->sys - start_time->sys;
   timer->wall += stop_time->wall - start_time->wall;
   timer->ggc_mem += stop_time->ggc_mem - start_time->ggc_mem;
+  for (unsigned i = 0; i < TVC_LAST; i++)
+    timer->counters[i] += stop_time->counters[i] - start_time->counters[i];
+}
+
+/* Start counting hardware events for -ftime-report-counters.  Events
+   the host cannot count are left out; if none can be counted, the
+   counters stay zero.  */
+
+static void
+open_counters (void)
+{
+#ifdef HAVE_PERF_COUNTERS
+  static const uint64_t configs[TVC_LAST] = {
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  if (perf_group_fd >= 0)
+    return;
+
+  for (unsigned i = 0; i < TVC_LAST; i++)
+    {
+      struct perf_event_attr attr;
+      memset (&attr, 0, sizeof (attr));
+      attr.size = sizeof (attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      int fd = syscall (__NR_perf_event_open, &attr, 0, -1, perf_group_fd, 0);
+      if (fd < 0)
+	continue;
+      if (perf_group_fd < 0)
+	perf_group_fd = fd;
+      perf_counters[perf_n_counters++] = (timevar_counter) i;
+    }
+#endif
+}
+
+/* Return true if some hardware events are being counted.  */
+
+static bool
+counters_p (void)
+{
+#ifdef HAVE_PERF_COUNTERS
+  return perf_group_fd >= 0;
+#else
+  return false;
+#endif
 }
 
 /* Class timer's constructor.  */
@@ -278,6 +367,9 @@ timer::timer () :
 #ifdef USE_CLOCK
   clocks_to_msec = CLOCKS_TO_MSEC;
 #endif
+
+  if (time_report_counters)
+    open_counters ();
 }
 
 /* Class timer's destructor.  */
@@ -667,6 +759,15 @@ timer::print_row (FILE *fp,
 	    ? 0
 	    : (float) elapsed.ggc_mem / total->ggc_mem) * 100);
 
+  /* Print the hardware event counts.  */
+  if (counters_p ())
+    for (unsigned i = 0; i < TVC_LAST; i++)
+      fprintf (fp, PRsa (6) " (%3.0f%%)",
+	       SIZE_AMOUNT (elapsed.counters[i]),
+	       (total->counters[i] == 0
+		? 0
+		: (double) elapsed.counters[i] / total->counters[i]) * 100);
+
   putc ('\n', fp);
 }
 
@@ -712,8 +813,12 @@ timer::print (FILE *fp)
      TIMEVAR.  */
   m_start_time = now;
 
-  fprintf (fp, "\n%-35s%16s%14s%14s%14s\n", "Time variable", "usr", "sys",
+  fprintf (fp, "\n%-35s%16s%14s%14s%14s", "Time variable", "usr", "sys",
 	   "wall", "GGC");
+  if (counters_p ())
+    fprintf (fp, "%14s%14s%14s%14s", "insns", "cycles", "cache-miss",
+	     "br-miss");
+  putc ('\n', fp);
   if (m_jit_client_items)
     fputs ("GCC items:\n", fp);
   for (id = 0; id < (unsigned int) TIMEVAR_LAST; ++id)
@@ -776,7 +881,11 @@ timer::print (FILE *fp)
 #ifdef HAVE_WALL_TIME
   fprintf (fp, "%8.2f      ", total->wall);
 #endif
-  fprintf (fp, PRsa (7) "\n", SIZE_AMOUNT (total->ggc_mem));
+  fprintf (fp, PRsa (7), SIZE_AMOUNT (total->ggc_mem));
+  if (counters_p ())
+    for (unsigned i = 0; i < TVC_LAST; i++)
+      fprintf (fp, "     " PRsa (8), SIZE_AMOUNT (total->counters[i]));
+  putc ('\n', fp);
 
   if (CHECKING_P || flag_checking)
     fprintf (fp, "Extra diagnostic checks enabled; compiler may run slowly.\n");
@@ -817,3 +926,150 @@ print_time (const char *str, long total)
 	   all_time == 0 ? 0
 	   : (long) (((100.0 * (double) total) / (double) all_time) + .5));
 }
+
+/* A span recorded for -ftime-trace.  START and DUR are in microseconds
+   since time_trace_init; DUR is negative while the span is open.  */
+
+struct time_trace_event
+{
+  const char *name;
+  char *detail;
+  double start;
+  double dur;
+};
+
+/* True if -ftime-trace spans are being recorded.  */
+bool time_trace_active;
+
+/* The recorded spans, in the order in which they were started, and the
+   indices of the ones that are still open.  */
+static vec<time_trace_event> time_trace_events;
+static vec<unsigned> time_trace_stack;
+
+/* The wall time at time_trace_init.  */
+static double time_trace_epoch;
+
+/* Return the current wall time in microseconds.  */
+
+static double
+time_trace_now (void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec * 1e6 + tv.tv_usec;
+#else
+  struct timevar_time_def now;
+  get_time (&now);
+  return now.wall * 1e6;
+#endif
+}
+
+/* Start recording spans for -ftime-trace.  */
+
+void
+time_trace_init (void)
+{
+  time_trace_active = true;
+  time_trace_epoch = time_trace_now ();
+  time_trace_begin ("Total", NULL);
+}
+
+/* Open a span called NAME, nested in the innermost open one.  DETAIL, if
+   non-NULL, describes what the span is about, e.g. the function a pass
+   runs on; it is copied.  */
+
+void
+time_trace_begin (const char *name, const char *detail)
+{
+  if (!time_trace_active)
+    return;
+
+  time_trace_event ev;
+  ev.name = name;
+  ev.detail = detail ? xstrdup (detail) : NULL;
+  ev.start = time_trace_now () - time_trace_epoch;
+  ev.dur = -1;
+  time_trace_stack.safe_push (time_trace_events.length ());
+  time_trace_events.safe_push (ev);
+}
+
+/* Close the innermost open span.  Spans shorter than
+   -ftime-trace-granularity are dropped; their children are at least as
+   short and have been dropped already, so such a span is always the last
+   one recorded.  */
+
+void
+time_trace_end (void)
+{
+  if (!time_trace_active)
+    return;
+
+  unsigned ix = time_trace_stack.pop ();
+  time_trace_event *ev = &time_trace_events[ix];
+  ev->dur = time_trace_now () - time_trace_epoch - ev->start;
+  if (ev->dur < time_trace_granularity && time_trace_stack.length ())
+    {
+      gcc_checking_assert (ix == time_trace_events.length () - 1);
+      free (ev->detail);
+      time_trace_events.pop ();
+    }
+}
+
+/* Write the string S to FP as a JSON string.  */
+
+static void
+time_trace_print_string (FILE *fp, const char *s)
+{
+  fputc ('"', fp);
+  for (; *s; s++)
+    {
+      unsigned char c = *s;
+      if (c == '"' || c == '\\')
+	fprintf (fp, "\\%c", c);
+      else if (c < 0x20)
+	fprintf (fp, "\\u%04x", c);
+      else
+	fputc (c, fp);
+    }
+  fputc ('"', fp);
+}
+
+/* Close all open spans, stop recording and write the spans to FP in the
+   Chrome trace event format, which chrome://tracing and similar viewers
+   can display.  */
+
+void
+time_trace_write (FILE *fp)
+{
+  if (!time_trace_active)
+    return;
+
+  while (time_trace_stack.length ())
+    time_trace_end ();
+  time_trace_active = false;
+
+  int pid = getpid ();
+  const char *sep = "";
+  fputs ("{\"traceEvents\":[", fp);
+  for (unsigned i = 0; i < time_trace_events.length (); i++)
+    {
+      time_trace_event *ev = &time_trace_events[i];
+      fprintf (fp, "%s\n{\"name\":", sep);
+      time_trace_print_string (fp, ev->name);
+      fprintf (fp, ",\"ph\":\"X\",\"ts\":%.0f,\"dur\":%.0f,"
+	       "\"pid\":%d,\"tid\":0", ev->start, ev->dur, pid);
+      if (ev->detail)
+	{
+	  fputs (",\"args\":{\"detail\":", fp);
+	  time_trace_print_string (fp, ev->detail);
+	  fputc ('}', fp);
+	}
+      fputc ('}', fp);
+      sep = ",";
+      free (ev->detail);
+    }
+  fputs ("\n],\"displayTimeUnit\":\"ms\"}\n", fp);
+  time_trace_events.release ();
+  time_trace_stack.release ();
+}
@@ -49,6 +49,17 @@
    base is undefined, except that the difference between two times
    produces a valid time difference.  */
 
+/* Hardware events counted with -ftime-report-counters.  */
+
+enum timevar_counter
+{
+  TVC_INSTRUCTIONS,
+  TVC_CYCLES,
+  TVC_CACHE_MISSES,
+  TVC_BRANCH_MISSES,
+  TVC_LAST
+};
+
 struct timevar_time_def
 {
   /* User time in this process.  */
@@ -63,6 +74,9 @@ struct timevar_time_def
 
   /* Garbage collector memory.  */
   size_t ggc_mem;
+
+  /* Hardware event counts, or zero if they are not being counted.  */
+  uint64_t counters[TVC_LAST];
 };
 
 /* An enumeration of timing variable identifiers.  Constructed from
@@ -258,4 +272,43 @@ class auto_timevar
 
 extern void print_time (const char *, long);
 
+/* Recording of nested spans of wall time for -ftime-trace.  Spans are
+   opened and closed in LIFO order and written out at the end of the
+   compilation in the Chrome trace event format.  */
+
+extern bool time_trace_active;
+
+extern void time_trace_init (void);
+extern void time_trace_begin (const char *, const char *);
+extern void time_trace_end (void);
+extern void time_trace_write (FILE *);
+
+/* Class for recording a span for the lifetime of a scope.  Callers
+   that have to compute the detail string should only do so when
+   time_trace_active is set.  */
+
+class auto_time_trace
+{
+ public:
+  explicit auto_time_trace (const char *name, const char *detail = NULL)
+    : m_active (time_trace_active)
+  {
+    if (m_active)
+      time_trace_begin (name, detail);
+  }
+
+  ~auto_time_trace ()
+  {
+    if (m_active)
+      time_trace_end ();
+  }
+
+ private:
+
+  // Private to disallow copies.
+  auto_time_trace (const auto_time_trace &);
+
+  bool m_active;
+};
+
 #endif /* ! GCC_TIMEVAR_H */
@@ -454,7 +454,9 @@ compile_file (void)
   timevar_push (TV_PARSE_GLOBAL);
 
   /* Parse entire file and generate initial debug information.  */
+  time_trace_begin ("Frontend", NULL);
   lang_hooks.parse_file ();
+  time_trace_end ();
 
   timevar_pop (TV_PARSE_GLOBAL);
   timevar_stop (TV_PHASE_PARSING);
@@ -479,7 +481,9 @@ compile_file (void)
   if (!in_lto_p)
     {
       timevar_start (TV_PHASE_OPT_GEN);
+      time_trace_begin ("Backend", NULL);
       symtab->finalize_compilation_unit ();
+      time_trace_end ();
       timevar_stop (TV_PHASE_OPT_GEN);
     }
 
@@ -2094,11 +2098,21 @@ finalize (bool no_backend)
   if (profile_report)
     dump_profile_report ();
 
+  if (mem_report_passes)
+    dump_pass_mem_report ();
+
   if (flag_dbg_cnt_list)
     dbg_cnt_list_all_counters ();
 
   /* Language-specific end of compilation actions.  */
   lang_hooks.finish ();
+
+  if (time_trace_active)
+    {
+      FILE *time_trace_file = open_auxiliary_file ("json");
+      time_trace_write (time_trace_file);
+      fclose (time_trace_file);
+    }
 }
 
 static bool
@@ -2129,6 +2143,9 @@ do_compile ()
 
       timevar_start (TV_PHASE_SETUP);
 
+      if (flag_time_trace)
+	time_trace_init ();
+
       if (flag_save_optimization_record)
 	{
 	  dump_context::get ().set_json_writer (new optrecord_json_writer ());
@@ -69,6 +69,7 @@ extern void global_decl_processing (void);
 extern void
 dump_memory_report (const char *);
 extern void dump_profile_report (void);
+extern void dump_pass_mem_report (void);
 
 extern void target_reinit (void);
 
@@ -58,6 +58,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree-dfa.h"
 #include "stringpool.h"
 #include "attribs.h"
+#include "tree-inline.h"
 
 /* This pass tries to distribute iterations of loops into several threads.
    The implementation is straightforward -- for each loop we test whether its
@@ -890,6 +891,23 @@ parloops_force_simple_reduction (loop_vec_info loop_info, stmt_vec_info phi_info
    thread.  */
 #define MIN_PER_THREAD param_parloops_min_per_thread
 
+/* Return the minimal number of iterations of LOOP that should be executed
+   in each thread.  For an innermost loop, that is enough iterations to
+   give each thread param_parloops_min_insns_per_thread instructions of
+   work, as estimated from the size of its body, but no more than
+   MIN_PER_THREAD.  */
+
+static unsigned
+loop_min_per_thread (class loop *loop)
+{
+  if (loop->inner)
+    return 2;
+
+  unsigned insns = MAX (tree_num_loop_insns (loop, &eni_time_weights), 1);
+  unsigned min_iters = CEIL (param_parloops_min_insns_per_thread, insns);
+  return MIN (MAX (min_iters, 2), (unsigned) MIN_PER_THREAD);
+}
+
 /* Element of the hashtable, representing a
    reduction in the current loop.  */
 struct reduction_info
@@ -3052,10 +3070,7 @@ gen_parallel_loop (class loop *loop,
 
   if (!oacc_kernels_p)
     {
-      if (loop->inner)
-	m_p_thread=2;
-      else
-	m_p_thread=MIN_PER_THREAD;
+      m_p_thread = loop_min_per_thread (loop);
 
       gcc_checking_assert (n_threads != 0);
       many_iterations_cond =
@@ -4090,7 +4105,7 @@ parallelize_loops (bool oacc_kernels_p)
 	  && ((estimated != -1
 	       && (estimated
 		   < ((HOST_WIDE_INT) n_threads
-		      * (loop->inner ? 2 : MIN_PER_THREAD) - 1)))
+		      * loop_min_per_thread (loop) - 1)))
 	      /* Do not bother with loops in cold areas.  */
 	      || optimize_loop_nest_for_size_p (loop)))
 	continue;
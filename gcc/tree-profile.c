@@ -73,6 +73,28 @@ static GTY(()) tree ic_tuple_var;
 static GTY(()) tree ic_tuple_counters_field;
 static GTY(()) tree ic_tuple_callee_field;
 
+/* The per-thread object whose address picks the copy of the edge
+   counters a thread updates with -fprofile-update=sharded.  */
+static GTY(()) tree shard_anchor_var;
+
+/* The start of the current thread's copy of the edge counters, and the
+   function it was computed for.  */
+static tree shard_base;
+static function *shard_base_fn;
+
+/* True if -fprofile-update=sharded updates counters atomically.  */
+static bool shard_update_atomic;
+
+/* Return true if counter updates use atomic operations.  */
+
+static inline bool
+profile_update_atomic_p (void)
+{
+  return (flag_profile_update == PROFILE_UPDATE_ATOMIC
+	  || (flag_profile_update == PROFILE_UPDATE_SHARDED
+	      && shard_update_atomic));
+}
+
 /* Do initialization work for the edge profiler.  */
 
 /* Add code:
@@ -128,7 +150,7 @@ gimple_init_gcov_profiler (void)
   if (!gcov_type_node)
     {
       const char *fn_suffix
-	= flag_profile_update == PROFILE_UPDATE_ATOMIC ? "_atomic" : "";
+	= profile_update_atomic_p () ? "_atomic" : "";
 
       gcov_type_node = get_gcov_type ();
       gcov_type_ptr = build_pointer_type (gcov_type_node);
@@ -232,9 +254,76 @@ gimple_init_gcov_profiler (void)
       DECL_ASSEMBLER_NAME (tree_indirect_call_profiler_fn);
       DECL_ASSEMBLER_NAME (tree_average_profiler_fn);
       DECL_ASSEMBLER_NAME (tree_ior_profiler_fn);
+
+      if (flag_profile_update == PROFILE_UPDATE_SHARDED)
+	{
+	  shard_anchor_var
+	    = build_decl (UNKNOWN_LOCATION, VAR_DECL,
+			  get_identifier ("__gcov_shard_anchor"),
+			  char_type_node);
+	  TREE_PUBLIC (shard_anchor_var) = 1;
+	  DECL_ARTIFICIAL (shard_anchor_var) = 1;
+	  DECL_EXTERNAL (shard_anchor_var) = 1;
+	  if (targetm.have_tls)
+	    set_decl_tls_model (shard_anchor_var,
+				decl_default_tls_model (shard_anchor_var));
+	}
     }
 }
 
+/* Return the start of the current thread's copy of the edge counters
+   of the current function, emitting the code that computes it on the
+   entry edge the first time.  Threads are spread over the copies by a
+   Fibonacci hash of the address of their __gcov_shard_anchor.  */
+
+static tree
+gimple_gen_shard_base (void)
+{
+  if (shard_base_fn == cfun)
+    return shard_base;
+
+  edge e = single_succ_edge (ENTRY_BLOCK_PTR_FOR_FN (cfun));
+  unsigned shards = coverage_counter_shards (GCOV_COUNTER_ARCS);
+  unsigned prec = TYPE_PRECISION (sizetype);
+  unsigned HOST_WIDE_INT stride
+    = (coverage_counter_count (GCOV_COUNTER_ARCS)
+       * tree_to_uhwi (TYPE_SIZE_UNIT (gcov_type_node)));
+  tree mult = build_int_cstu (sizetype,
+			      prec > 32
+			      ? HOST_WIDE_INT_UC (0x9e3779b97f4a7c15)
+			      : HOST_WIDE_INT_UC (0x9e3779b9));
+
+  tree anchor = build_fold_addr_expr (shard_anchor_var);
+  tree addr = make_temp_ssa_name (TREE_TYPE (anchor), NULL, "PROF_shard");
+  gassign *stmt1 = gimple_build_assign (addr, anchor);
+  tree hash = make_temp_ssa_name (sizetype, NULL, "PROF_shard");
+  gassign *stmt2 = gimple_build_assign (hash, NOP_EXPR, addr);
+  tree mixed = make_temp_ssa_name (sizetype, NULL, "PROF_shard");
+  gassign *stmt3 = gimple_build_assign (mixed, MULT_EXPR, hash, mult);
+  tree shard = make_temp_ssa_name (sizetype, NULL, "PROF_shard");
+  gassign *stmt4
+    = gimple_build_assign (shard, RSHIFT_EXPR, mixed,
+			   build_int_cst (integer_type_node,
+					  prec - floor_log2 (shards)));
+  tree offset = make_temp_ssa_name (sizetype, NULL, "PROF_shard");
+  gassign *stmt5 = gimple_build_assign (offset, MULT_EXPR, shard,
+					size_int (stride));
+  tree counters = tree_coverage_counter_addr (GCOV_COUNTER_ARCS, 0);
+  shard_base = make_temp_ssa_name (TREE_TYPE (counters), NULL,
+				   "PROF_shard_base");
+  gassign *stmt6 = gimple_build_assign (shard_base, POINTER_PLUS_EXPR,
+					counters, offset);
+  gsi_insert_on_edge (e, stmt1);
+  gsi_insert_on_edge (e, stmt2);
+  gsi_insert_on_edge (e, stmt3);
+  gsi_insert_on_edge (e, stmt4);
+  gsi_insert_on_edge (e, stmt5);
+  gsi_insert_on_edge (e, stmt6);
+
+  shard_base_fn = cfun;
+  return shard_base;
+}
+
 /* Output instructions as GIMPLE trees to increment the edge
    execution count, and insert them on E.  We rely on
    gsi_insert_on_edge to preserve the order.  */
@@ -246,7 +335,44 @@ gimple_gen_edge_profiler (int edgeno, edge e)
 
   one = build_int_cst (gcov_type_node, 1);
 
-  if (flag_profile_update == PROFILE_UPDATE_ATOMIC)
+  if (flag_profile_update == PROFILE_UPDATE_SHARDED)
+    {
+      /* counter = shard_base[edgeno], updated as below.  */
+      tree base = gimple_gen_shard_base ();
+      unsigned HOST_WIDE_INT offset
+	= edgeno * tree_to_uhwi (TYPE_SIZE_UNIT (gcov_type_node));
+      if (shard_update_atomic)
+	{
+	  tree addr = make_temp_ssa_name (TREE_TYPE (base), NULL,
+					  "PROF_edge_counter_ptr");
+	  gassign *stmt1 = gimple_build_assign (addr, POINTER_PLUS_EXPR, base,
+						size_int (offset));
+	  tree f = builtin_decl_explicit (LONG_LONG_TYPE_SIZE > 32
+					  ? BUILT_IN_ATOMIC_FETCH_ADD_8:
+					  BUILT_IN_ATOMIC_FETCH_ADD_4);
+	  gcall *stmt2 = gimple_build_call (f, 3, addr, one,
+					    build_int_cst (integer_type_node,
+							   MEMMODEL_RELAXED));
+	  gsi_insert_on_edge (e, stmt1);
+	  gsi_insert_on_edge (e, stmt2);
+	}
+      else
+	{
+	  tree ref = build2 (MEM_REF, gcov_type_node, base,
+			     build_int_cst (TREE_TYPE (base), offset));
+	  tree tmp1 = make_temp_ssa_name (gcov_type_node, NULL,
+					  "PROF_edge_counter");
+	  gassign *stmt1 = gimple_build_assign (tmp1, ref);
+	  tree tmp2 = make_temp_ssa_name (gcov_type_node, NULL,
+					  "PROF_edge_counter");
+	  gassign *stmt2 = gimple_build_assign (tmp2, PLUS_EXPR, tmp1, one);
+	  gassign *stmt3 = gimple_build_assign (unshare_expr (ref), tmp2);
+	  gsi_insert_on_edge (e, stmt1);
+	  gsi_insert_on_edge (e, stmt2);
+	  gsi_insert_on_edge (e, stmt3);
+	}
+    }
+  else if (flag_profile_update == PROFILE_UPDATE_ATOMIC)
     {
       /* __atomic_fetch_add (&counter, 1, MEMMODEL_RELAXED); */
       tree addr = tree_coverage_counter_addr (GCOV_COUNTER_ARCS, edgeno);
@@ -517,7 +643,7 @@ gimple_gen_time_profiler (unsigned tag)
   gsi = gsi_start_bb (update_bb);
 
   /* Emit: counters[0] = ++__gcov_time_profiler_counter.  */
-  if (flag_profile_update == PROFILE_UPDATE_ATOMIC)
+  if (profile_update_atomic_p ())
     {
       tree ptr = make_temp_ssa_name (build_pointer_type (type), NULL,
 				     "time_profiler_counter_ptr");
@@ -718,6 +844,8 @@ tree_profiling (void)
   else if (flag_profile_update == PROFILE_UPDATE_PREFER_ATOMIC)
     flag_profile_update = can_support_atomic
       ? PROFILE_UPDATE_ATOMIC : PROFILE_UPDATE_SINGLE;
+  else if (flag_profile_update == PROFILE_UPDATE_SHARDED)
+    shard_update_atomic = can_support_atomic;
 
   /* This is a small-ipa pass that gets called only once, from
      cgraphunit.c:ipa_passes().  */
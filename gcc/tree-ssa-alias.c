@@ -3215,6 +3215,69 @@ same_addr_size_stores_p (tree base1, poly_int64 offset1, poly_int64 size1,
 	  && known_eq (wi::to_poly_offset (DECL_SIZE (obj)), size1));
 }
 
+/* Return true if the call CALL to CALLEE always stores to all of REF,
+   as recorded in the kills of the ipa-modref summary of CALLEE.  */
+
+static bool
+call_kills_ref_p (gcall *call, tree callee, ao_ref *ref)
+{
+  struct cgraph_node *node = cgraph_node::get (callee);
+  /* The kills are relative to the parameters of the function body, so
+     they do not apply through thunks adjusting them.  */
+  if (!node
+      || !node->binds_to_current_def_p ()
+      || node->ultimate_alias_target ()->thunk)
+    return false;
+  modref_summary *summary = get_modref_function_summary (node);
+  if (!summary)
+    return false;
+
+  tree rbase = ref->base;
+  poly_offset_int roffset = ref->offset;
+  if (TREE_CODE (rbase) == MEM_REF)
+    {
+      roffset += mem_ref_offset (rbase) << LOG2_BITS_PER_UNIT;
+      rbase = TREE_OPERAND (rbase, 0);
+    }
+  for (unsigned int i = 0; i < summary->kills.length (); i++)
+    {
+      modref_access_node *kill = &summary->kills[i];
+      if ((unsigned) kill->parm_index >= gimple_call_num_args (call))
+	continue;
+      tree ptr = gimple_call_arg (call, kill->parm_index);
+      if (!POINTER_TYPE_P (TREE_TYPE (ptr)))
+	continue;
+      ao_ref dref;
+      ao_ref_init_from_ptr_and_size (&dref, ptr, NULL_TREE);
+      tree base = ao_ref_base (&dref);
+      if (!base)
+	continue;
+      poly_offset_int offset = dref.offset;
+      offset += poly_offset_int::from (kill->parm_offset, SIGNED)
+		<< LOG2_BITS_PER_UNIT;
+      offset += poly_offset_int::from (kill->offset, SIGNED);
+      if (TREE_CODE (base) == MEM_REF)
+	{
+	  offset += mem_ref_offset (base) << LOG2_BITS_PER_UNIT;
+	  base = TREE_OPERAND (base, 0);
+	}
+      if (base == rbase
+	  && known_subrange_p (roffset, ref->max_size, offset,
+			       poly_offset_int::from (kill->size, SIGNED)))
+	{
+	  if (dump_file && (dump_flags & TDF_DETAILS))
+	    {
+	      fprintf (dump_file, "ipa-modref: call stmt ");
+	      print_gimple_stmt (dump_file, call, 0);
+	      fprintf (dump_file, "ipa-modref: call to %s kills parm %i\n",
+		       node->dump_name (), kill->parm_index);
+	    }
+	  return true;
+	}
+    }
+  return false;
+}
+
 /* If STMT kills the memory reference REF return true, otherwise
    return false.  */
 
@@ -3440,6 +3503,10 @@ stmt_kills_ref_p (gimple *stmt, ao_ref *ref)
 
 	  default:;
 	  }
+      else if (callee != NULL_TREE
+	       && ref->max_size_known_p ()
+	       && call_kills_ref_p (as_a <gcall *> (stmt), callee, ref))
+	return true;
     }
   return false;
 }
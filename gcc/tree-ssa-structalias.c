@@ -2701,19 +2701,28 @@ eliminate_indirect_cycles (unsigned int node)
   return false;
 }
 
+/* The maximum number of nodes solve_graph may process, or 0 for no
+   limit.  */
+static unsigned HOST_WIDE_INT solve_graph_budget;
+
 /* Solve the constraint graph GRAPH using our worklist solver.
    This is based on the PW* family of solvers from the "Efficient Field
    Sensitive Pointer Analysis for C" paper.
    It works by iterating over all the graph nodes, processing the complex
    constraints and propagating the copy constraints, until everything stops
-   changed.  This corresponds to steps 6-8 in the solving list given above.  */
+   changed.  This corresponds to steps 6-8 in the solving list given above.
 
-static void
+   Returns false, leaving the solutions incomplete, if that would take
+   more than solve_graph_budget steps.  */
+
+static bool
 solve_graph (constraint_graph_t graph)
 {
   unsigned int size = graph->size;
   unsigned int i;
   bitmap pts;
+  unsigned HOST_WIDE_INT steps = 0;
+  bool completed = true;
 
   changed = BITMAP_ALLOC (NULL);
 
@@ -2730,7 +2739,7 @@ solve_graph (constraint_graph_t graph)
   /* Allocate a bitmap to be used to store the changed bits.  */
   pts = BITMAP_ALLOC (&pta_obstack);
 
-  while (!bitmap_empty_p (changed))
+  while (completed && !bitmap_empty_p (changed))
     {
       unsigned int i;
       struct topo_info *ti = init_topo_info ();
@@ -2761,6 +2770,13 @@ solve_graph (constraint_graph_t graph)
 	      unsigned int j;
 	      constraint_t c;
 	      bitmap solution;
+
+	      if (solve_graph_budget && ++steps > solve_graph_budget)
+		{
+		  completed = false;
+		  break;
+		}
+
 	      vec<constraint_t> complex = graph->complex[i];
 	      varinfo_t vi = get_varinfo (i);
 	      bool solution_empty;
@@ -2875,6 +2891,8 @@ solve_graph (constraint_graph_t graph)
   BITMAP_FREE (pts);
   BITMAP_FREE (changed);
   bitmap_obstack_release (&oldpta_obstack);
+
+  return completed;
 }
 
 /* Map from trees to variable infos.  */
@@ -7288,9 +7306,10 @@ remove_preds_and_fake_succs (constraint_graph_t graph)
   bitmap_obstack_release (&predbitmap_obstack);
 }
 
-/* Solve the constraint set.  */
+/* Solve the constraint set.  Returns false if the solver ran out of
+   budget (see solve_graph).  */
 
-static void
+static bool
 solve_constraints (void)
 {
   class scc_info *si;
@@ -7379,7 +7398,7 @@ solve_constraints (void)
   if (dump_file)
     fprintf (dump_file, "Solving graph\n");
 
-  solve_graph (graph);
+  bool completed = solve_graph (graph);
 
   if (dump_file && (dump_flags & TDF_GRAPH))
     {
@@ -7388,6 +7407,8 @@ solve_constraints (void)
       dump_constraint_graph (dump_file);
       fprintf (dump_file, "\n\n");
     }
+
+  return completed;
 }
 
 /* Create points-to sets for the current function.  See the comments
@@ -8309,8 +8330,22 @@ ipa_pta_execute (void)
 	}
     }
 
-  /* From the constraints compute the points-to sets.  */
-  solve_constraints ();
+  /* From the constraints compute the points-to sets.  If that is
+     too expensive, give up and leave the functions with the points-to
+     information computed for each of them separately.  */
+  solve_graph_budget = param_ipa_pta_max_solver_steps;
+  bool completed = solve_constraints ();
+  solve_graph_budget = 0;
+  if (!completed)
+    {
+      if (dump_file)
+	fprintf (dump_file, "\nSolver step limit of %d reached; "
+		 "not using IPA points-to information\n",
+		 param_ipa_pta_max_solver_steps);
+      delete_points_to_sets ();
+      in_ipa_mode = 0;
+      return 0;
+    }
 
   if (dump_file)
     dump_sa_points_to_info (dump_file);
@@ -40,6 +40,7 @@ along with GCC; see the file COPYING3.  If not see
 class thread_jumps
 {
  public:
+  thread_jumps ();
   void find_jump_threads_backwards (basic_block bb, bool speed_p);
  private:
   edge profitable_jump_thread_path (basic_block bbi, tree name, tree arg,
@@ -53,6 +54,7 @@ class thread_jumps
   bool check_subpath_and_update_thread_path (basic_block last_bb,
 					     basic_block new_bb,
 					     int *next_path_length);
+  bool name_may_be_constant_p (tree name, bool *incomplete);
 
   /* Maximum number of BBs we are allowed to thread.  */
   int m_max_threaded_paths;
@@ -65,8 +67,23 @@ class thread_jumps
   /* Indicate that we could increase code size to improve the
      code path.  */
   bool m_speed_p;
+  /* Number of SSA definitions the search may still visit in this
+     function.  */
+  int m_search_steps;
+  /* SSA_NAME_VERSIONs of names whose definition chain is known to
+     reach, or known not to reach, a constant.  */
+  auto_bitmap m_const_names;
+  auto_bitmap m_nonconst_names;
+  /* SSA_NAME_VERSIONs of names name_may_be_constant_p is looking at.  */
+  auto_bitmap m_active_names;
 };
 
+thread_jumps::thread_jumps ()
+  : m_max_threaded_paths (0), m_seen_loop_phi (false), m_speed_p (false),
+    m_search_steps (param_max_fsm_thread_search_steps)
+{
+}
+
 /* Simple helper to get the last statement from BB, which is assumed
    to be a control statement.   Return NULL if the last statement is
    not a control statement.  */
@@ -661,6 +678,69 @@ thread_jumps::handle_assignment (gimple *stmt, tree name, basic_block def_bb)
     }
 }
 
+/* Return false if no chain of PHIs and copies that
+   fsm_find_control_statement_thread_paths would follow from NAME ends
+   in a constant, whatever the path that leads to NAME.  The answer is
+   cached, so that a name reached from many control statements or
+   along many paths is only walked once.  Set *INCOMPLETE if the answer
+   depends on a name that is still being looked at, in which case a
+   negative answer is only final once the outermost call returns.  */
+
+bool
+thread_jumps::name_may_be_constant_p (tree name, bool *incomplete)
+{
+  unsigned int ver = SSA_NAME_VERSION (name);
+  if (bitmap_bit_p (m_const_names, ver))
+    return true;
+  if (bitmap_bit_p (m_nonconst_names, ver))
+    return false;
+  if (!bitmap_set_bit (m_active_names, ver))
+    {
+      *incomplete = true;
+      return false;
+    }
+
+  bool res = false;
+  bool my_incomplete = false;
+  gimple *def_stmt = SSA_NAME_DEF_STMT (name);
+  basic_block def_bb = gimple_bb (def_stmt);
+  if (SSA_NAME_OCCURS_IN_ABNORMAL_PHI (name) || def_bb == NULL)
+    ;
+  else if (gphi *phi = dyn_cast <gphi *> (def_stmt))
+    {
+      if (gimple_phi_num_args (phi)
+	  < (unsigned) param_fsm_maximum_phi_arguments)
+	for (unsigned int i = 0; !res && i < gimple_phi_num_args (phi); i++)
+	  {
+	    tree arg = gimple_phi_arg_def (phi, i);
+	    basic_block bbi = gimple_phi_arg_edge (phi, i)->src;
+	    if (!arg || def_bb->loop_father != bbi->loop_father)
+	      continue;
+	    if (TREE_CODE (arg) == SSA_NAME)
+	      res = name_may_be_constant_p (arg, &my_incomplete);
+	    else
+	      res = TREE_CODE_CLASS (TREE_CODE (arg)) == tcc_constant;
+	  }
+    }
+  else if (handle_assignment_p (def_stmt))
+    {
+      tree arg = gimple_assign_rhs1 (def_stmt);
+      if (TREE_CODE (arg) == SSA_NAME)
+	res = name_may_be_constant_p (arg, &my_incomplete);
+      else
+	res = true;
+    }
+
+  bitmap_clear_bit (m_active_names, ver);
+  if (res)
+    bitmap_set_bit (m_const_names, ver);
+  else if (!my_incomplete || bitmap_empty_p (m_active_names))
+    bitmap_set_bit (m_nonconst_names, ver);
+  else
+    *incomplete = true;
+  return res;
+}
+
 /* We trace the value of the SSA_NAME NAME back through any phi nodes
    looking for places where it gets a constant value and save the
    path.  */
@@ -679,6 +759,19 @@ thread_jumps::fsm_find_control_statement_thread_paths (tree name)
   if (def_bb == NULL)
     return;
 
+  /* Do not walk the definitions again if they cannot give NAME a
+     constant value.  */
+  bool incomplete = false;
+  if (!name_may_be_constant_p (name, &incomplete))
+    return;
+
+  /* Give up once the search has visited too many definitions in this
+     function.  The paths found so far are still registered.  */
+  if (m_search_steps <= 0)
+    return;
+  if (--m_search_steps == 0 && dump_file && (dump_flags & TDF_DETAILS))
+    fprintf (dump_file, "  Search budget for FSM threading exhausted\n");
+
   /* We allow the SSA chain to contains PHIs and simple copies and constant
      initializations.  */
   if (gimple_code (def_stmt) != GIMPLE_PHI
@@ -3457,12 +3457,58 @@ vectorizable_with_step_bound_p (dr_vec_info *dr_info_a, dr_vec_info *dr_info_b,
   return true;
 }
 
+/* Return true if the run-time alias check for segment D does not
+   change between iterations of loop OUTER.  */
+
+static bool
+vect_seg_invariant_in_loop_p (class loop *outer, const dr_with_seg_len &d)
+{
+  data_reference *dr = d.dr;
+  return (expr_invariant_in_loop_p (outer, DR_BASE_ADDRESS (dr))
+	  && expr_invariant_in_loop_p (outer, DR_OFFSET (dr))
+	  && expr_invariant_in_loop_p (outer, DR_INIT (dr))
+	  && expr_invariant_in_loop_p (outer, DR_STEP (dr))
+	  && expr_invariant_in_loop_p (outer, d.seg_len));
+}
+
+/* Return true if all the run-time alias checks of LOOP_VINFO are
+   invariant in the loop that contains the loop being vectorized.
+   vect_loop_versioning then moves the checks out of that loop, so
+   they are evaluated once for all its iterations rather than once
+   per execution of the vectorized loop.  */
+
+static bool
+vect_alias_checks_hoistable_p (loop_vec_info loop_vinfo)
+{
+  class loop *loop = LOOP_VINFO_LOOP (loop_vinfo);
+  class loop *outer = loop_outer (loop);
+  if (!outer || !loop_outer (outer))
+    return false;
+
+  unsigned int i;
+  dr_with_seg_len_pair_t *pair;
+  FOR_EACH_VEC_ELT (LOOP_VINFO_COMP_ALIAS_DDRS (loop_vinfo), i, pair)
+    if (!vect_seg_invariant_in_loop_p (outer, pair->first)
+	|| !vect_seg_invariant_in_loop_p (outer, pair->second))
+      return false;
+
+  vec_object_pair *objs;
+  FOR_EACH_VEC_ELT (LOOP_VINFO_CHECK_UNEQUAL_ADDRS (loop_vinfo), i, objs)
+    if (!expr_invariant_in_loop_p (outer, objs->first)
+	|| !expr_invariant_in_loop_p (outer, objs->second))
+      return false;
+
+  return true;
+}
+
 /* Function vect_prune_runtime_alias_test_list.
 
    Prune a list of ddrs to be tested at run-time by versioning for alias.
    Merge several alias checks into one if possible.
    Return FALSE if resulting list of ddrs is longer then allowed by
-   PARAM_VECT_MAX_VERSION_FOR_ALIAS_CHECKS, otherwise return TRUE.  */
+   PARAM_VECT_MAX_VERSION_FOR_ALIAS_CHECKS, or by
+   PARAM_VECT_MAX_VERSION_FOR_HOISTED_ALIAS_CHECKS if the checks can be
+   moved out of the enclosing loop, otherwise return TRUE.  */
 
 opt_result
 vect_prune_runtime_alias_test_list (loop_vec_info loop_vinfo)
@@ -3697,8 +3743,17 @@ vect_prune_runtime_alias_test_list (loop_vec_info loop_vinfo)
 		     "improved number of alias checks from %d to %d\n",
 		     may_alias_ddrs.length (), count);
   unsigned limit = param_vect_max_version_for_alias_checks;
+  if (count > limit
+      && param_vect_max_version_for_hoisted_alias_checks > limit
+      && vect_alias_checks_hoistable_p (loop_vinfo))
+    {
+      limit = param_vect_max_version_for_hoisted_alias_checks;
+      if (dump_enabled_p ())
+	dump_printf_loc (MSG_NOTE, vect_location,
+			 "alias checks are invariant in the outer loop\n");
+    }
   if (flag_simd_cost_model == VECT_COST_MODEL_CHEAP)
-    limit = param_vect_max_version_for_alias_checks * 6 / 10;
+    limit = limit * 6 / 10;
   if (count > limit)
     return opt_result::failure_at
       (vect_location,
@@ -62,6 +62,10 @@ along with GCC; see the file COPYING3.  If not see
       FIXME: This transformation was removed together with RTL based value
       profiling.
 
+   4) Call argument specialization.  If an integer argument of a direct
+      call usually has the same value, the call is versioned on that
+      value, so that IPA-CP can clone the callee for the constant.
+
 
    Value profiling internals
    ==========================
@@ -640,7 +644,8 @@ gimple_value_profile_transformations (void)
 	  if (gimple_mod_subtract_transform (&gsi)
 	      || gimple_divmod_fixed_value_transform (&gsi)
 	      || gimple_mod_pow2_value_transform (&gsi)
-	      || gimple_stringops_transform (&gsi))
+	      || gimple_stringops_transform (&gsi)
+	      || gimple_call_arg_transform (&gsi))
 	    {
 	      stmt = gsi_stmt (gsi);
 	      changed = true;
@@ -1526,17 +1531,19 @@ interesting_stringop_to_profile_p (gcall *call, int *size_arg)
     }
 }
 
-/* Convert stringop (..., vcall_size)
-   into
+/* Convert call (..., vcall_size, ...), where VCALL_SIZE is argument
+   SIZE_ARG, into
    if (vcall_size == icall_size)
-     stringop (..., icall_size);
+     call (..., icall_size, ...);
    else
-     stringop (..., vcall_size);
-   assuming we'll propagate a true constant into ICALL_SIZE later.  */
+     call (..., vcall_size, ...);
+   assuming we'll propagate a true constant into ICALL_SIZE later.
+   The call must not throw.  */
 
 static void
-gimple_stringop_fixed_value (gcall *vcall_stmt, tree icall_size, profile_probability prob,
-			     gcov_type count, gcov_type all)
+gimple_call_fixed_value (gcall *vcall_stmt, int size_arg, tree icall_size,
+			 profile_probability prob, gcov_type count,
+			 gcov_type all)
 {
   gassign *tmp_stmt;
   gcond *cond_stmt;
@@ -1545,10 +1552,6 @@ gimple_stringop_fixed_value (gcall *vcall_stmt, tree icall_size, profile_probabi
   basic_block cond_bb, icall_bb, vcall_bb, join_bb;
   edge e_ci, e_cv, e_iv, e_ij, e_vj;
   gimple_stmt_iterator gsi;
-  int size_arg;
-
-  if (!interesting_stringop_to_profile_p (vcall_stmt, &size_arg))
-    gcc_unreachable ();
 
   cond_bb = gimple_bb (vcall_stmt);
   gsi = gsi_for_stmt (vcall_stmt);
@@ -1567,7 +1570,8 @@ gimple_stringop_fixed_value (gcall *vcall_stmt, tree icall_size, profile_probabi
   cond_stmt = gimple_build_cond (EQ_EXPR, tmp1, tmp0, NULL_TREE, NULL_TREE);
   gsi_insert_before (&gsi, cond_stmt, GSI_SAME_STMT);
 
-  if (TREE_CODE (gimple_vdef (vcall_stmt)) == SSA_NAME)
+  if (gimple_vdef (vcall_stmt)
+      && TREE_CODE (gimple_vdef (vcall_stmt)) == SSA_NAME)
     {
       unlink_stmt_vdef (vcall_stmt);
       release_ssa_name (gimple_vdef (vcall_stmt));
@@ -1621,7 +1625,6 @@ gimple_stringop_fixed_value (gcall *vcall_stmt, tree icall_size, profile_probabi
       add_phi_arg (phi, gimple_call_lhs (icall_stmt), e_ij, UNKNOWN_LOCATION);
     }
 
-  /* Because these are all string op builtins, they're all nothrow.  */
   gcc_assert (!stmt_could_throw_p (cfun, vcall_stmt));
   gcc_assert (!stmt_could_throw_p (cfun, icall_stmt));
 }
@@ -1724,7 +1727,108 @@ gimple_stringops_transform (gimple_stmt_iterator *gsi)
 		     "Transformation done: single value %i stringop for %s\n",
 		     (int)val, built_in_names[(int)fcode]);
 
-  gimple_stringop_fixed_value (stmt, tree_val, prob, count, all);
+  /* Because these are all string op builtins, they're all nothrow.  */
+  gimple_call_fixed_value (stmt, size_arg, tree_val, prob, count, all);
+
+  return true;
+}
+
+/* Return true if the integer argument ARG of direct call CALL is worth
+   profiling for call argument specialization.  */
+
+static bool
+interesting_call_arg_to_profile_p (gcall *call, tree arg)
+{
+  tree fndecl = gimple_call_fndecl (call);
+
+  if (!fndecl
+      || fndecl_built_in_p (fndecl)
+      || gimple_call_internal_p (call)
+      || stmt_could_throw_p (cfun, call)
+      || stmt_can_make_abnormal_goto (call))
+    return false;
+
+  return TREE_CODE (arg) == SSA_NAME && INTEGRAL_TYPE_P (TREE_TYPE (arg));
+}
+
+/* Version the call at GSI on the dominant value of one of its integer
+   arguments.  The argument with the most common single value is
+   chosen, provided that value covers at least three quarters of the
+   calls; IPA-CP then sees a constant argument on the hot path and may
+   clone the callee for it.  */
+
+static bool
+gimple_call_arg_transform (gimple_stmt_iterator *gsi)
+{
+  gcall *stmt;
+  histogram_value hist, next;
+  tree best_arg = NULL_TREE;
+  int best_argno = -1;
+  gcov_type best_val = 0, best_count = 0, best_all = 0;
+  profile_probability prob;
+  tree tree_val;
+  cgraph_node *node;
+
+  stmt = dyn_cast <gcall *> (gsi_stmt (*gsi));
+  if (!stmt
+      || !gimple_call_fndecl (stmt)
+      || fndecl_built_in_p (gimple_call_fndecl (stmt)))
+    return false;
+
+  for (hist = gimple_histogram_value (cfun, stmt); hist; hist = next)
+    {
+      gcov_type val, count, all;
+
+      next = hist->hvalue.next;
+      if (hist->type != HIST_TYPE_TOPN_VALUES)
+	continue;
+
+      for (unsigned i = 0; i < gimple_call_num_args (stmt); i++)
+	if (gimple_call_arg (stmt, i) == hist->hvalue.value
+	    && get_nth_most_common_value (stmt, "call argument", hist,
+					  &val, &count, &all)
+	    && 4 * count >= 3 * all
+	    && count > best_count)
+	  {
+	    best_arg = hist->hvalue.value;
+	    best_argno = i;
+	    best_val = val;
+	    best_count = count;
+	    best_all = all;
+	    break;
+	  }
+
+      gimple_remove_histogram_value (cfun, stmt, hist);
+    }
+
+  if (!best_arg
+      || optimize_bb_for_size_p (gimple_bb (stmt))
+      || !interesting_call_arg_to_profile_p (stmt, best_arg))
+    return false;
+
+  /* Only a callee with a body can be specialized.  */
+  node = cgraph_node::get (gimple_call_fndecl (stmt));
+  if (!node || !node->definition)
+    return false;
+
+  tree_val = build_int_cst (get_gcov_type (), best_val);
+  if (!int_fits_type_p (tree_val, TREE_TYPE (best_arg)))
+    return false;
+
+  if (best_all > 0)
+    prob = profile_probability::probability_in_gcov_type (best_count,
+							  best_all);
+  else
+    prob = profile_probability::never ();
+
+  if (dump_enabled_p ())
+    dump_printf_loc (MSG_OPTIMIZED_LOCATIONS, stmt,
+		     "Transformation done: single value %i for argument %i "
+		     "of call to %s\n", (int) best_val, best_argno,
+		     node->dump_name ());
+
+  gimple_call_fixed_value (stmt, best_argno, tree_val, prob, best_count,
+			   best_all);
 
   return true;
 }
@@ -1897,6 +2001,28 @@ gimple_stringops_values_to_profile (gimple *gs, histogram_values *values)
 						     stmt, dest));
 }
 
+/* Find integer arguments of the direct call STMT for which we want to
+   measure histograms for call argument specialization.  */
+
+static void
+gimple_call_args_values_to_profile (gimple *gs, histogram_values *values)
+{
+  gcall *stmt = dyn_cast <gcall *> (gs);
+
+  if (!stmt || !flag_value_profile_call_args)
+    return;
+
+  for (unsigned i = 0; i < gimple_call_num_args (stmt); i++)
+    {
+      tree arg = gimple_call_arg (stmt, i);
+
+      if (interesting_call_arg_to_profile_p (stmt, arg))
+	values->safe_push (gimple_alloc_histogram_value (cfun,
+							 HIST_TYPE_TOPN_VALUES,
+							 stmt, arg));
+    }
+}
+
 /* Find values inside STMT for that we want to measure histograms and adds
    them to list VALUES.  */
 
@@ -1906,6 +2032,7 @@ gimple_values_to_profile (gimple *stmt, histogram_values *values)
   gimple_divmod_values_to_profile (stmt, values);
   gimple_stringops_values_to_profile (stmt, values);
   gimple_indirect_call_to_profile (stmt, values);
+  gimple_call_args_values_to_profile (stmt, values);
 }
 
 void
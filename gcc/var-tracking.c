@@ -7061,7 +7061,38 @@ compute_bb_dataflow (basic_block bb)
   return changed;
 }
 
-/* Find the locations of variables in the whole function.  */
+/* Give up on computing the locations of variables precisely in the
+   blocks RC_ORDER[START] ... RC_ORDER[END], whose dataflow hasn't
+   converged: assume nothing is known on entry to each of them, so that
+   only the locations established within each block are used.  HTABSZ
+   is the running total of the sizes of the dataflow sets, which is kept
+   up to date.  */
+
+static void
+vt_give_up_on_region (int *rc_order, int start, int end, int *htabsz)
+{
+  for (int i = start; i <= end; i++)
+    {
+      basic_block bb = BASIC_BLOCK_FOR_FN (cfun, rc_order[i]);
+
+      *htabsz -= (shared_hash_htab (VTI (bb)->in.vars)->size ()
+		  + shared_hash_htab (VTI (bb)->out.vars)->size ());
+      dataflow_set_clear (&VTI (bb)->in);
+      compute_bb_dataflow (bb);
+      VTI (bb)->flooded = true;
+      *htabsz += (shared_hash_htab (VTI (bb)->in.vars)->size ()
+		  + shared_hash_htab (VTI (bb)->out.vars)->size ());
+    }
+}
+
+/* Find the locations of variables in the whole function.
+
+   If param_max_vartrack_region_visits is non-zero, the dataflow of each
+   region (toplevel SCC, or the acyclic tail) that needs more than that
+   many visits per block on average to converge is abandoned, and so is
+   that of a region during which the sets grow past
+   param_max_vartrack_size, rather than giving up on the whole function:
+   only the locations known locally within each of its blocks are kept.  */
 
 static bool
 vt_find_locations (void)
@@ -7078,6 +7109,7 @@ vt_find_locations (void)
   int htabmax = param_max_vartrack_size;
   bool success = true;
   unsigned int n_blocks_processed = 0;
+  unsigned int n_regions_abandoned = 0;
 
   timevar_push (TV_VAR_TRACKING_DATAFLOW);
   /* Compute reverse completion order of depth first search of the CFG
@@ -7119,7 +7151,13 @@ vt_find_locations (void)
 	  bitmap_set_bit (in_pending, rc_order[i]);
 	}
 
-      while (success && !pending->empty ())
+      uint64_t region_visits = 0;
+      uint64_t region_budget
+	= ((uint64_t) param_max_vartrack_region_visits
+	   * (curr_end - curr_start + 1));
+      bool abandon_region = false;
+
+      while (success && !abandon_region && !pending->empty ())
 	{
 	  std::swap (worklist, pending);
 	  std::swap (in_worklist, in_pending);
@@ -7203,6 +7241,15 @@ vt_find_locations (void)
 	      htabsz += (shared_hash_htab (VTI (bb)->in.vars)->size ()
 			 + shared_hash_htab (VTI (bb)->out.vars)->size ());
 
+	      region_visits++;
+	      if (region_budget
+		  && (region_visits > region_budget
+		      || (htabmax && htabsz > htabmax)))
+		{
+		  abandon_region = true;
+		  break;
+		}
+
 	      if (htabmax && htabsz > htabmax)
 		{
 		  if (MAY_HAVE_DEBUG_BIND_INSNS)
@@ -7268,11 +7315,32 @@ vt_find_locations (void)
 		}
 	    }
 	}
+
+      if (abandon_region)
+	{
+	  if (dump_file)
+	    fprintf (dump_file,
+		     "Abandoning dataflow of blocks %i to %i of the RPO after "
+		     "%i visits, tsz %i\n",
+		     curr_start, curr_end, (int) region_visits, htabsz);
+
+	  while (!worklist->empty ())
+	    worklist->extract_min ();
+	  while (!pending->empty ())
+	    pending->extract_min ();
+	  bitmap_clear (in_worklist);
+	  bitmap_clear (in_pending);
+
+	  vt_give_up_on_region (rc_order, curr_start, curr_end, &htabsz);
+	  n_regions_abandoned++;
+	}
     }
   while (curr_end != n - 1);
 
   statistics_counter_event (cfun, "compute_bb_dataflow times",
 			    n_blocks_processed);
+  statistics_counter_event (cfun, "var-tracking regions abandoned",
+			    n_regions_abandoned);
 
   if (success && MAY_HAVE_DEBUG_BIND_INSNS)
     FOR_EACH_BB_FN (bb, cfun)
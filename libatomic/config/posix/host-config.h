@@ -33,6 +33,10 @@
 void libat_lock_1 (void *ptr);
 void libat_unlock_1 (void *ptr);
 
+/* Loads may copy the memory without the lock; see libat_read_n.  */
+# define HAVE_LIBAT_READ_N 1
+bool libat_read_n (void *ptr, void *dest, size_t n);
+
 static inline UWORD
 protect_start (void *ptr)
 {
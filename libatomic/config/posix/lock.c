@@ -45,11 +45,21 @@
 #define WATCH_SIZE	CACHLINE_SIZE
 #endif
 
+/* How many times libat_read_n tries to read without the lock.  */
+#ifndef READ_RETRIES
+#define READ_RETRIES	16
+#endif
+
+/* Besides the mutex, each lock has a sequence count, which is odd while
+   the holder of the mutex may be changing the memory it protects.  This
+   lets loads read the memory without taking the mutex and check
+   afterwards that nothing changed it meanwhile.  */
 struct lock
 {
   pthread_mutex_t mutex;
-  char pad[sizeof(pthread_mutex_t) < CACHLINE_SIZE
-	   ? CACHLINE_SIZE - sizeof(pthread_mutex_t)
+  UWORD seq;
+  char pad[sizeof(pthread_mutex_t) + sizeof(UWORD) < CACHLINE_SIZE
+	   ? CACHLINE_SIZE - sizeof(pthread_mutex_t) - sizeof(UWORD)
 	   : 0];
 };
 
@@ -64,16 +74,35 @@ addr_hash (void *ptr)
   return ((uintptr_t)ptr / WATCH_SIZE) % NLOCKS;
 }
 
+/* Take lock L and make its sequence count odd.  */
+
+static inline void
+lock_write (struct lock *l)
+{
+  pthread_mutex_lock (&l->mutex);
+  __atomic_store_n (&l->seq, l->seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+/* Make the sequence count of lock L even again and release it.  */
+
+static inline void
+unlock_write (struct lock *l)
+{
+  __atomic_store_n (&l->seq, l->seq + 1, __ATOMIC_RELEASE);
+  pthread_mutex_unlock (&l->mutex);
+}
+
 void
 libat_lock_1 (void *ptr)
 {
-  pthread_mutex_lock (&locks[addr_hash (ptr)].mutex);
+  lock_write (&locks[addr_hash (ptr)]);
 }
 
 void
 libat_unlock_1 (void *ptr)
 {
-  pthread_mutex_unlock (&locks[addr_hash (ptr)].mutex);
+  unlock_write (&locks[addr_hash (ptr)]);
 }
 
 void
@@ -88,7 +117,7 @@ libat_lock_n (void *ptr, size_t n)
 
   do
     {
-      pthread_mutex_lock (&locks[h].mutex);
+      lock_write (&locks[h]);
       if (++h == NLOCKS)
 	h = 0;
       i += WATCH_SIZE;
@@ -107,10 +136,41 @@ libat_unlock_n (void *ptr, size_t n)
 
   do
     {
-      pthread_mutex_unlock (&locks[h].mutex);
+      unlock_write (&locks[h]);
       if (++h == NLOCKS)
 	h = 0;
       i += WATCH_SIZE;
     }
   while (i < n);
 }
+
+/* Copy the N bytes at PTR to DEST without taking the lock, as a
+   seqlock reader.  Return false if that did not succeed, because the
+   object is protected by more than one lock or because writers kept
+   changing it; the caller must then take the lock.  */
+
+bool
+libat_read_n (void *ptr, void *dest, size_t n)
+{
+  struct lock *l = &locks[addr_hash (ptr)];
+  UWORD seq;
+  int i;
+
+  if ((uintptr_t)ptr % WATCH_SIZE + n > WATCH_SIZE)
+    return false;
+
+  for (i = 0; i < READ_RETRIES; i++)
+    {
+      seq = __atomic_load_n (&l->seq, __ATOMIC_ACQUIRE);
+      if (seq & 1)
+	continue;
+
+      memcpy (dest, ptr, n);
+
+      __atomic_thread_fence (__ATOMIC_ACQUIRE);
+      if (__atomic_load_n (&l->seq, __ATOMIC_RELAXED) == seq)
+	return true;
+    }
+
+  return false;
+}
@@ -89,6 +89,15 @@ libat_load (size_t n, void *mptr, void *rptr, int smodel)
     }
 
   pre_seq_barrier (smodel);
+
+#ifdef HAVE_LIBAT_READ_N
+  if (libat_read_n (mptr, rptr, n))
+    {
+      post_seq_barrier (smodel);
+      return;
+    }
+#endif
+
   libat_lock_n (mptr, n);
 
   memcpy (rptr, mptr, n);
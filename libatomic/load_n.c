@@ -101,6 +101,15 @@ SIZE(libat_load) (UTYPE *mptr, int smodel)
   UWORD magic;
 
   pre_seq_barrier (smodel);
+
+#ifdef HAVE_LIBAT_READ_N
+  if (libat_read_n (mptr, &ret, N))
+    {
+      post_seq_barrier (smodel);
+      return ret;
+    }
+#endif
+
   magic = protect_start (mptr);
 
   ret = *mptr;
@@ -33,9 +33,12 @@ POSSIBILITY OF SUCH DAMAGE.  */
 #include "config.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "dwarf2.h"
 #include "filenames.h"
@@ -43,6 +46,14 @@ POSSIBILITY OF SUCH DAMAGE.  */
 #include "backtrace.h"
 #include "internal.h"
 
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
 #if !defined(HAVE_DECL_STRNLEN) || !HAVE_DECL_STRNLEN
 
 /* If strnlen is not declared, provide our own version.  */
@@ -330,6 +341,8 @@ struct unit
   const char *abs_filename;
   /* The abbreviations for this unit.  */
   struct abbrevs abbrevs;
+  /* Index of this unit in the cache file, if it was read from one.  */
+  size_t cache_index;
 
   /* The fields above this point are read in during initialization and
      may be accessed freely.  The fields below this point are read in
@@ -380,6 +393,23 @@ struct unit_vector
   size_t count;
 };
 
+/* The arrays of a cache file, described with struct
+   dwarf_cache_header below.  */
+
+struct dwarf_cache
+{
+  const struct dwarf_cache_unit *units;
+  size_t units_count;
+  const struct dwarf_cache_line *lines;
+  size_t lines_count;
+  const struct dwarf_cache_function *functions;
+  size_t functions_count;
+  const struct dwarf_cache_function_addrs *function_addrs;
+  size_t function_addrs_count;
+  const char *strings;
+  size_t strings_size;
+};
+
 /* The information we need to map a PC to a file and line.  */
 
 struct dwarf_data
@@ -405,6 +435,9 @@ struct dwarf_data
   /* A vector used for function addresses.  We keep this here so that
      we can grow the vector as we read more functions.  */
   struct function_vector fvec;
+  /* If the data was read from a cache file, the contents of that
+     file.  CACHE.UNITS is NULL otherwise.  */
+  struct dwarf_cache cache;
 };
 
 /* Report an error for a DWARF buffer.  */
@@ -2080,6 +2113,259 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
   return 1;
 }
 
+/* Reading the units of a large program takes a while, and they can
+   be read independently.  If the state was created with THREADED
+   set, and the program is linked against the thread library, the
+   work is shared among several threads.  The pthread functions are
+   referenced weakly, so that libbacktrace does not pull in the thread
+   library itself.  */
+
+#if defined (__GNUC__) && defined (__ELF__) && defined (HAVE_SYNC_FUNCTIONS) \
+  && defined (_POSIX_THREADS) && _POSIX_THREADS > 0
+#define DWARF_USE_THREADS 1
+#endif
+
+#ifdef DWARF_USE_THREADS
+
+#include <pthread.h>
+
+static __typeof (pthread_create) backtrace_pthread_create
+  __attribute__ ((__weakref__ ("pthread_create")));
+static __typeof (pthread_join) backtrace_pthread_join
+  __attribute__ ((__weakref__ ("pthread_join")));
+
+#endif /* defined (DWARF_USE_THREADS) */
+
+/* The largest number of threads to use, and the smallest number of
+   units for each thread.  */
+
+#define DWARF_MAX_THREADS 16
+#define DWARF_UNITS_PER_THREAD 32
+
+/* A set of COUNT independent work items, numbered from 0, shared
+   among some number of workers.  FN is called to do item INDEX in
+   worker WORKER, and returns 0 on failure.  Structures that embed
+   this one as their first field pass additional data to FN.  */
+
+struct dwarf_work
+{
+  int (*fn) (struct dwarf_work *work, size_t index, size_t worker);
+  size_t count;
+  /* The next item to do.  */
+  size_t next;
+  /* Set if any item failed.  */
+  int failed;
+  /* Whether more than one worker is running.  */
+  int threaded;
+};
+
+/* A thread doing work items.  */
+
+struct dwarf_worker
+{
+  struct dwarf_work *work;
+  size_t index;
+#ifdef DWARF_USE_THREADS
+  pthread_t thread;
+#endif
+};
+
+/* Return how many workers to use for COUNT items.  */
+
+static size_t
+dwarf_work_workers (struct backtrace_state *state ATTRIBUTE_UNUSED,
+		    size_t count ATTRIBUTE_UNUSED)
+{
+#ifdef DWARF_USE_THREADS
+  long cpus;
+  size_t n;
+
+  if (!state->threaded
+      || backtrace_pthread_create == NULL
+      || backtrace_pthread_join == NULL)
+    return 1;
+
+  cpus = sysconf (_SC_NPROCESSORS_ONLN);
+  n = count / DWARF_UNITS_PER_THREAD;
+  if (cpus > 0 && n > (size_t) cpus)
+    n = (size_t) cpus;
+  if (n > DWARF_MAX_THREADS)
+    n = DWARF_MAX_THREADS;
+  return n > 0 ? n : 1;
+#else
+  return 1;
+#endif
+}
+
+/* Do work items until there are none left, or one has failed.  */
+
+static void
+dwarf_work_loop (struct dwarf_work *work, size_t worker)
+{
+  while (1)
+    {
+      size_t index;
+
+      if (!work->threaded)
+	{
+	  if (work->failed)
+	    return;
+	  index = work->next++;
+	}
+      else
+	{
+	  if (backtrace_atomic_load_int (&work->failed))
+	    return;
+	  index = __sync_fetch_and_add (&work->next, 1);
+	}
+
+      if (index >= work->count)
+	return;
+
+      if (!work->fn (work, index, worker))
+	{
+	  if (!work->threaded)
+	    work->failed = 1;
+	  else
+	    backtrace_atomic_store_int (&work->failed, 1);
+	  return;
+	}
+    }
+}
+
+#ifdef DWARF_USE_THREADS
+
+/* The start routine of a worker thread.  */
+
+static void *
+dwarf_work_thread (void *arg)
+{
+  struct dwarf_worker *w;
+
+  w = (struct dwarf_worker *) arg;
+  dwarf_work_loop (w->work, w->index);
+  return NULL;
+}
+
+#endif /* defined (DWARF_USE_THREADS) */
+
+/* Do all the items of WORK using up to WORKERS workers, one of which
+   is the calling thread.  Return 1 on success, 0 if any item
+   failed.  */
+
+static int
+dwarf_work_run (struct backtrace_state *state, struct dwarf_work *work,
+		size_t workers, backtrace_error_callback error_callback,
+		void *data)
+{
+  work->next = 0;
+  work->failed = 0;
+  work->threaded = 0;
+
+#ifdef DWARF_USE_THREADS
+  if (workers > 1)
+    {
+      struct dwarf_worker *threads;
+      size_t threads_size;
+      size_t started;
+      size_t i;
+
+      threads_size = (workers - 1) * sizeof (struct dwarf_worker);
+      threads = ((struct dwarf_worker *)
+		 backtrace_alloc (state, threads_size, error_callback, data));
+      if (threads != NULL)
+	{
+	  work->threaded = 1;
+
+	  /* If a thread can't be created, just do the work with fewer
+	     of them.  */
+	  started = 0;
+	  for (i = 1; i < workers; ++i)
+	    {
+	      threads[started].work = work;
+	      threads[started].index = i;
+	      if (backtrace_pthread_create (&threads[started].thread, NULL,
+					    dwarf_work_thread,
+					    &threads[started]) != 0)
+		break;
+	      ++started;
+	    }
+
+	  dwarf_work_loop (work, 0);
+
+	  for (i = 0; i < started; ++i)
+	    backtrace_pthread_join (threads[i].thread, NULL);
+
+	  backtrace_free (state, threads, threads_size, error_callback, data);
+	  return !work->failed;
+	}
+    }
+#endif
+
+  dwarf_work_loop (work, 0);
+  return !work->failed;
+}
+
+/* The work of reading the abbrevs and address ranges of each unit in
+   build_address_map.  */
+
+struct unit_map_work
+{
+  struct dwarf_work work;
+  struct backtrace_state *state;
+  uintptr_t base_address;
+  const struct dwarf_sections *dwarf_sections;
+  int is_bigendian;
+  struct dwarf_data *altlink;
+  backtrace_error_callback error_callback;
+  void *data;
+  /* The units, and the offset of the abbrevs of each one.  */
+  struct unit **units;
+  const uint64_t *abbrev_offsets;
+  /* The address ranges found by each worker.  */
+  struct unit_addrs_vector *addrs;
+};
+
+/* Read the abbrevs and address ranges of unit INDEX of VWORK, adding
+   the ranges to the vector of WORKER.  Returns 1 on success, 0 on
+   failure.  */
+
+static int
+read_unit_map (struct dwarf_work *vwork, size_t index, size_t worker)
+{
+  struct unit_map_work *work;
+  struct unit *u;
+  struct dwarf_buf unit_buf;
+  enum dwarf_tag unit_tag;
+
+  work = (struct unit_map_work *) vwork;
+  u = work->units[index];
+
+  if (!read_abbrevs (work->state, work->abbrev_offsets[index],
+		     work->dwarf_sections->data[DEBUG_ABBREV],
+		     work->dwarf_sections->size[DEBUG_ABBREV],
+		     work->is_bigendian, work->error_callback, work->data,
+		     &u->abbrevs))
+    return 0;
+
+  unit_buf.name = ".debug_info";
+  unit_buf.start = work->dwarf_sections->data[DEBUG_INFO];
+  unit_buf.buf = u->unit_data;
+  unit_buf.left = u->unit_data_len;
+  unit_buf.is_bigendian = work->is_bigendian;
+  unit_buf.error_callback = work->error_callback;
+  unit_buf.data = work->data;
+  unit_buf.reported_underflow = 0;
+
+  if (!find_address_ranges (work->state, work->base_address, &unit_buf,
+			    work->dwarf_sections, work->is_bigendian,
+			    work->altlink, work->error_callback, work->data,
+			    u, &work->addrs[worker], &unit_tag))
+    return 0;
+
+  return !unit_buf.reported_underflow;
+}
+
 /* Build a mapping from address ranges to the compilation units where
    the line number information for that range can be found.  Returns 1
    on success, 0 on failure.  */
@@ -2095,6 +2381,10 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
   struct dwarf_buf info;
   struct backtrace_vector units;
   size_t units_count;
+  struct backtrace_vector abbrev_offsets;
+  struct unit_map_work work;
+  size_t workers;
+  size_t addrs_size;
   size_t i;
   struct unit **pu;
   size_t unit_offset = 0;
@@ -2104,6 +2394,10 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
   memset (&unit_vec->vec, 0, sizeof unit_vec->vec);
   addrs->count = 0;
   unit_vec->count = 0;
+  memset (&abbrev_offsets, 0, sizeof abbrev_offsets);
+  work.addrs = addrs;
+  workers = 1;
+  addrs_size = 0;
 
   /* Read through the .debug_info section.  FIXME: Should we use the
      .debug_aranges section?  gdb and addr2line don't use it, but I'm
@@ -2132,7 +2426,7 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
       uint64_t abbrev_offset;
       int addrsize;
       struct unit *u;
-      enum dwarf_tag unit_tag;
+      uint64_t *pabbrev_offset;
 
       if (info.reported_underflow)
 	goto fail;
@@ -2184,13 +2478,16 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
       else
 	addrsize = read_byte (&unit_buf);
 
+      /* The abbrevs are read along with the address ranges below.  */
       memset (&u->abbrevs, 0, sizeof u->abbrevs);
       abbrev_offset = read_offset (&unit_buf, is_dwarf64);
-      if (!read_abbrevs (state, abbrev_offset,
-			 dwarf_sections->data[DEBUG_ABBREV],
-			 dwarf_sections->size[DEBUG_ABBREV],
-			 is_bigendian, error_callback, data, &u->abbrevs))
+      pabbrev_offset = ((uint64_t *)
+			backtrace_vector_grow (state, sizeof (uint64_t),
+					       error_callback, data,
+					       &abbrev_offsets));
+      if (pabbrev_offset == NULL)
 	goto fail;
+      *pabbrev_offset = abbrev_offset;
 
       if (version < 5)
 	addrsize = read_byte (&unit_buf);
@@ -2227,18 +2524,71 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
       u->lines_count = 0;
       u->function_addrs = NULL;
       u->function_addrs_count = 0;
-
-      if (!find_address_ranges (state, base_address, &unit_buf, dwarf_sections,
-				is_bigendian, altlink, error_callback, data,
-				u, addrs, &unit_tag))
-	goto fail;
-
-      if (unit_buf.reported_underflow)
-	goto fail;
     }
   if (info.reported_underflow)
     goto fail;
 
+  /* Read the abbrevs and address ranges of the units, possibly in
+     parallel.  Each worker collects its ranges in a separate vector;
+     they are sorted later anyway.  */
+
+  work.work.fn = read_unit_map;
+  work.work.count = units_count;
+  work.state = state;
+  work.base_address = base_address;
+  work.dwarf_sections = dwarf_sections;
+  work.is_bigendian = is_bigendian;
+  work.altlink = altlink;
+  work.error_callback = error_callback;
+  work.data = data;
+  work.units = (struct unit **) units.base;
+  work.abbrev_offsets = (const uint64_t *) abbrev_offsets.base;
+
+  workers = dwarf_work_workers (state, units_count);
+  if (workers > 1)
+    {
+      addrs_size = workers * sizeof (struct unit_addrs_vector);
+      work.addrs = ((struct unit_addrs_vector *)
+		    backtrace_alloc (state, addrs_size, error_callback, data));
+      if (work.addrs == NULL)
+	{
+	  work.addrs = addrs;
+	  workers = 1;
+	}
+      else
+	memset (work.addrs, 0, addrs_size);
+    }
+
+  if (!dwarf_work_run (state, &work.work, workers, error_callback, data))
+    goto fail;
+
+  if (work.addrs != addrs)
+    {
+      for (i = 0; i < workers; ++i)
+	{
+	  struct unit_addrs_vector *wa;
+
+	  wa = &work.addrs[i];
+	  if (wa->count == 0)
+	    continue;
+	  pa = ((struct unit_addrs *)
+		backtrace_vector_grow (state,
+				       wa->count * sizeof (struct unit_addrs),
+				       error_callback, data, &addrs->vec));
+	  if (pa == NULL)
+	    goto fail;
+	  memcpy (pa, wa->vec.base, wa->count * sizeof (struct unit_addrs));
+	  addrs->count += wa->count;
+	}
+      for (i = 0; i < workers; ++i)
+	backtrace_vector_free (state, &work.addrs[i].vec, error_callback,
+			       data);
+      backtrace_free (state, work.addrs, addrs_size, error_callback, data);
+      work.addrs = addrs;
+    }
+
+  backtrace_vector_free (state, &abbrev_offsets, error_callback, data);
+
   /* Add a trailing addrs entry, but don't include it in addrs->count.  */
   pa = ((struct unit_addrs *)
 	backtrace_vector_grow (state, sizeof (struct unit_addrs),
@@ -2255,6 +2605,14 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
   return 1;
 
  fail:
+  if (work.addrs != addrs)
+    {
+      for (i = 0; i < workers; ++i)
+	backtrace_vector_free (state, &work.addrs[i].vec, error_callback,
+			       data);
+      backtrace_free (state, work.addrs, addrs_size, error_callback, data);
+    }
+  backtrace_vector_free (state, &abbrev_offsets, error_callback, data);
   if (units_count > 0)
     {
       pu = (struct unit **) units.base;
@@ -3621,119 +3979,1264 @@ report_inlined_functions (uintptr_t pc, struct function *function,
   return 0;
 }
 
-/* Look for a PC in the DWARF mapping for one module.  On success,
-   call CALLBACK and return whatever it returns.  On error, call
-   ERROR_CALLBACK and return 0.  Sets *FOUND to 1 if the PC is found,
-   0 if not.  */
+/* Cache files.
+
+   Building the address map reads every DIE in .debug_info, and the
+   line program and function DIEs of a unit are read the first time a
+   PC in that unit is looked up.  For a large program this can take
+   seconds, and every process that symbolizes a backtrace repeats it.
+   If the environment variable BACKTRACE_CACHE_DIR names a directory,
+   the first process to load an object with a build ID reads the
+   information for all units and saves it there, in a file named after
+   the build ID.  Later processes map that file instead of reading the
+   DWARF sections.
+
+   A cache file is a struct dwarf_cache_header, then the build ID
+   padded to a multiple of 8 bytes, then arrays of struct
+   dwarf_cache_unit, struct dwarf_cache_addrs, struct dwarf_cache_line,
+   struct dwarf_cache_function and struct dwarf_cache_function_addrs,
+   then the string table.  All fields are 64 bits in the byte order of
+   the host that wrote the file.  Addresses are relative to the base
+   address of the object, strings are offsets into the string table,
+   and DWARF_CACHE_NONE stands for a NULL string.  The arrays have no
+   sentinel entries; those are added when the data is read.
+
+   The lines of a unit are contiguous, as are its functions and its
+   function ranges.  The ranges of a unit start with its top-level
+   ones, followed by the ranges inlined into each of its functions in
+   order.  Function indexes in a range are relative to the first
+   function of the unit.  */
+
+#define DWARF_CACHE_MAGIC "BTCACHE"
+#define DWARF_CACHE_VERSION 1
+#define DWARF_CACHE_BYTE_ORDER 0x01020304
+#define DWARF_CACHE_NONE ((uint64_t) -1)
+
+struct dwarf_cache_header
+{
+  /* DWARF_CACHE_MAGIC, including the trailing NUL.  */
+  char magic[8];
+  /* DWARF_CACHE_VERSION.  */
+  uint32_t version;
+  /* DWARF_CACHE_BYTE_ORDER.  */
+  uint32_t byte_order;
+  /* Length of the build ID.  */
+  uint64_t buildid_size;
+  /* Number of entries in each array.  */
+  uint64_t units_count;
+  uint64_t addrs_count;
+  uint64_t lines_count;
+  uint64_t functions_count;
+  uint64_t function_addrs_count;
+  /* Size of the string table.  */
+  uint64_t strings_size;
+};
 
-static int
-dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
-		 uintptr_t pc, backtrace_full_callback callback,
-		 backtrace_error_callback error_callback, void *data,
-		 int *found)
+/* A compilation unit in a cache file.  */
+
+struct dwarf_cache_unit
 {
-  struct unit_addrs *entry;
-  int found_entry;
-  struct unit *u;
-  int new_data;
-  struct line *lines;
-  struct line *ln;
-  struct function_addrs *p;
-  struct function_addrs *fmatch;
-  struct function *function;
-  const char *filename;
-  int lineno;
-  int ret;
+  /* Primary source file and compilation directory.  */
+  uint64_t filename;
+  uint64_t comp_dir;
+  /* Index of the first line of the unit, or DWARF_CACHE_NONE if there
+     was no useful line number information.  */
+  uint64_t lines;
+  uint64_t lines_count;
+  /* Index of the first function of the unit.  */
+  uint64_t functions;
+  uint64_t functions_count;
+  /* Index of the first function range of the unit, the total number
+     of its ranges, and the number of top-level ones.  */
+  uint64_t function_addrs;
+  uint64_t function_addrs_total;
+  uint64_t function_addrs_count;
+};
 
-  *found = 1;
+/* An address range for a compilation unit in a cache file.  */
 
-  /* Find an address range that includes PC.  Our search isn't safe if
-     PC == -1, as we use that as a sentinel value, so skip the search
-     in that case.  */
-  entry = (ddata->addrs_count == 0 || pc + 1 == 0
-	   ? NULL
-	   : bsearch (&pc, ddata->addrs, ddata->addrs_count,
-		      sizeof (struct unit_addrs), unit_addrs_search));
+struct dwarf_cache_addrs
+{
+  uint64_t low;
+  uint64_t high;
+  /* Index of the unit.  */
+  uint64_t unit;
+};
 
-  if (entry == NULL)
-    {
-      *found = 0;
-      return 0;
-    }
+/* A line mapping in a cache file.  */
 
-  /* Here pc >= entry->low && pc < (entry + 1)->low.  The unit_addrs
-     are sorted by low, so if pc > p->low we are at the end of a range
-     of unit_addrs with the same low value.  If pc == p->low walk
-     forward to the end of the range with that low value.  Then walk
-     backward and use the first range that includes pc.  */
-  while (pc == (entry + 1)->low)
-    ++entry;
-  found_entry = 0;
-  while (1)
-    {
-      if (pc < entry->high)
-	{
-	  found_entry = 1;
-	  break;
-	}
-      if (entry == ddata->addrs)
-	break;
-      if ((entry - 1)->low < entry->low)
-	break;
-      --entry;
-    }
-  if (!found_entry)
-    {
-      *found = 0;
-      return 0;
-    }
+struct dwarf_cache_line
+{
+  uint64_t pc;
+  uint64_t filename;
+  int64_t lineno;
+};
 
-  /* We need the lines, lines_count, function_addrs,
-     function_addrs_count fields of u.  If they are not set, we need
-     to set them.  When running in threaded mode, we need to allow for
-     the possibility that some other thread is setting them
-     simultaneously.  */
+/* A function in a cache file.  */
 
-  u = entry->u;
-  lines = u->lines;
+struct dwarf_cache_function
+{
+  uint64_t name;
+  uint64_t caller_filename;
+  int64_t caller_lineno;
+  /* Number of ranges inlined into this function.  */
+  uint64_t function_addrs_count;
+};
 
-  /* Skip units with no useful line number information by walking
-     backward.  Useless line number information is marked by setting
-     lines == -1.  */
-  while (entry > ddata->addrs
-	 && pc >= (entry - 1)->low
-	 && pc < (entry - 1)->high)
-    {
-      if (state->threaded)
-	lines = (struct line *) backtrace_atomic_load_pointer (&u->lines);
+/* An address range for a function in a cache file.  */
 
-      if (lines != (struct line *) (uintptr_t) -1)
-	break;
+struct dwarf_cache_function_addrs
+{
+  uint64_t low;
+  uint64_t high;
+  /* Index of the function, relative to the first one of the unit.  */
+  uint64_t function;
+};
 
-      --entry;
+/* Return the string at OFFSET in the string table of CACHE.  Set *OK
+   to 0 if OFFSET is out of range.  */
 
-      u = entry->u;
-      lines = u->lines;
+static const char *
+dwarf_cache_string (const struct dwarf_cache *cache, uint64_t offset,
+		    int *ok)
+{
+  if (offset == DWARF_CACHE_NONE)
+    return NULL;
+  if (offset >= cache->strings_size)
+    {
+      *ok = 0;
+      return NULL;
     }
+  return cache->strings + offset;
+}
 
-  if (state->threaded)
-    lines = backtrace_atomic_load_pointer (&u->lines);
+/* Return whether COUNT entries starting at INDEX fit in an array of
+   SIZE entries.  */
 
-  new_data = 0;
-  if (lines == NULL)
-    {
-      struct function_addrs *function_addrs;
-      size_t function_addrs_count;
-      struct line_header lhdr;
-      size_t count;
+static int
+dwarf_cache_range_ok (uint64_t index, uint64_t count, size_t size)
+{
+  return index <= size && count <= size - index;
+}
 
-      /* We have never read the line information for this unit.  Read
-	 it now.  */
+/* Fill in ADDRS from the COUNT function ranges of CU that start at
+   INDEX in the cache file of DDATA, and add a trailing entry.
+   FUNCTIONS are the functions of the unit.  Set *OK to 0 if the data
+   is invalid.  */
 
-      function_addrs = NULL;
+static void
+dwarf_cache_read_function_addrs (const struct dwarf_data *ddata,
+				 const struct dwarf_cache_unit *cu,
+				 uint64_t index, uint64_t count,
+				 struct function *functions,
+				 struct function_addrs *addrs, int *ok)
+{
+  uint64_t i;
+
+  for (i = 0; i < count; ++i)
+    {
+      const struct dwarf_cache_function_addrs *cfa;
+
+      cfa = &ddata->cache.function_addrs[index + i];
+      addrs[i].low = cfa->low + ddata->base_address;
+      addrs[i].high = cfa->high + ddata->base_address;
+      if (cfa->function >= cu->functions_count)
+	{
+	  *ok = 0;
+	  addrs[i].function = NULL;
+	}
+      else
+	addrs[i].function = &functions[cfa->function];
+    }
+
+  addrs[count].low = 0;
+  --addrs[count].low;
+  addrs[count].high = addrs[count].low;
+  addrs[count].function = NULL;
+}
+
+/* Read the line and function information of U from the cache file of
+   DDATA, returning it as read_line_info and read_function_info do.
+   Return 1 on success, 0 if there is no useful information or the
+   file is corrupt.  */
+
+static int
+dwarf_cache_read_unit (struct backtrace_state *state, struct dwarf_data *ddata,
+		       struct unit *u, backtrace_error_callback error_callback,
+		       void *data, struct line **ret_lines,
+		       size_t *ret_lines_count,
+		       struct function_addrs **ret_addrs,
+		       size_t *ret_addrs_count)
+{
+  const struct dwarf_cache *cache;
+  const struct dwarf_cache_unit *cu;
+  struct line *lines;
+  size_t lines_size;
+  struct function *functions;
+  size_t functions_size;
+  struct function_addrs *addrs;
+  size_t addrs_size;
+  uint64_t next;
+  uint64_t end;
+  size_t pos;
+  uint64_t i;
+  int ok;
+
+  cache = &ddata->cache;
+  cu = &cache->units[u->cache_index];
+  lines = NULL;
+  functions = NULL;
+  addrs = NULL;
+  lines_size = 0;
+  functions_size = 0;
+  addrs_size = 0;
+  ok = 1;
+
+  if (cu->lines == DWARF_CACHE_NONE
+      || cu->lines_count == 0
+      || !dwarf_cache_range_ok (cu->lines, cu->lines_count,
+				cache->lines_count)
+      || !dwarf_cache_range_ok (cu->functions, cu->functions_count,
+				cache->functions_count)
+      || !dwarf_cache_range_ok (cu->function_addrs, cu->function_addrs_total,
+				cache->function_addrs_count)
+      || cu->function_addrs_count > cu->function_addrs_total)
+    goto fail;
+
+  /* Allocate one extra entry at the end.  */
+  lines_size = (cu->lines_count + 1) * sizeof (struct line);
+  lines = (struct line *) backtrace_alloc (state, lines_size, error_callback,
+					   data);
+  if (lines == NULL)
+    goto fail;
+  for (i = 0; i < cu->lines_count; ++i)
+    {
+      const struct dwarf_cache_line *cl;
+
+      cl = &cache->lines[cu->lines + i];
+      lines[i].pc = (uintptr_t) (cl->pc + ddata->base_address);
+      lines[i].filename = dwarf_cache_string (cache, cl->filename, &ok);
+      lines[i].lineno = (int) cl->lineno;
+      lines[i].idx = (int) i;
+    }
+  lines[i].pc = (uintptr_t) -1;
+  lines[i].filename = NULL;
+  lines[i].lineno = 0;
+  lines[i].idx = 0;
+
+  if (cu->functions_count > 0)
+    {
+      functions_size = cu->functions_count * sizeof (struct function);
+      functions = ((struct function *)
+		   backtrace_alloc (state, functions_size, error_callback,
+				    data));
+      if (functions == NULL)
+	goto fail;
+    }
+
+  /* Each list of ranges gets a trailing entry: one for the top-level
+     list, and one per function.  */
+  addrs_size = ((cu->function_addrs_total + cu->functions_count + 1)
+		* sizeof (struct function_addrs));
+  addrs = ((struct function_addrs *)
+	   backtrace_alloc (state, addrs_size, error_callback, data));
+  if (addrs == NULL)
+    goto fail;
+
+  next = cu->function_addrs;
+  end = cu->function_addrs + cu->function_addrs_total;
+  dwarf_cache_read_function_addrs (ddata, cu, next, cu->function_addrs_count,
+				   functions, addrs, &ok);
+  next += cu->function_addrs_count;
+  pos = cu->function_addrs_count + 1;
+
+  for (i = 0; i < cu->functions_count; ++i)
+    {
+      const struct dwarf_cache_function *cf;
+      struct function *f;
+
+      cf = &cache->functions[cu->functions + i];
+      if (cf->function_addrs_count > end - next)
+	goto fail;
+
+      f = &functions[i];
+      f->name = dwarf_cache_string (cache, cf->name, &ok);
+      f->caller_filename = dwarf_cache_string (cache, cf->caller_filename,
+					       &ok);
+      f->caller_lineno = (int) cf->caller_lineno;
+      f->function_addrs = NULL;
+      f->function_addrs_count = cf->function_addrs_count;
+      if (cf->function_addrs_count > 0)
+	{
+	  f->function_addrs = &addrs[pos];
+	  dwarf_cache_read_function_addrs (ddata, cu, next,
+					   cf->function_addrs_count,
+					   functions, &addrs[pos], &ok);
+	  next += cf->function_addrs_count;
+	  pos += cf->function_addrs_count + 1;
+	}
+    }
+
+  if (!ok || next != end)
+    goto fail;
+
+  *ret_lines = lines;
+  *ret_lines_count = cu->lines_count;
+  *ret_addrs = addrs;
+  *ret_addrs_count = cu->function_addrs_count;
+  return 1;
+
+ fail:
+  if (lines != NULL)
+    backtrace_free (state, lines, lines_size, error_callback, data);
+  if (functions != NULL)
+    backtrace_free (state, functions, functions_size, error_callback, data);
+  if (addrs != NULL)
+    backtrace_free (state, addrs, addrs_size, error_callback, data);
+  *ret_lines = (struct line *) (uintptr_t) -1;
+  *ret_lines_count = 0;
+  *ret_addrs = NULL;
+  *ret_addrs_count = 0;
+  return 0;
+}
+
+/* Advance *OFFSET past an array of COUNT entries of ENTSIZE bytes in a
+   file of SIZE bytes.  Return 0 if the array does not fit.  */
+
+static int
+dwarf_cache_section (uint64_t *offset, uint64_t count, size_t entsize,
+		     uint64_t size)
+{
+  if (*offset > size || count > (size - *offset) / entsize)
+    return 0;
+  *offset += count * entsize;
+  return 1;
+}
+
+/* Build the DWARF data for an object from the cache file PATH, if it
+   exists and matches the build ID BUILDID_DATA.  Return NULL if
+   there is no usable cache file.  */
+
+static struct dwarf_data *
+dwarf_cache_load (struct backtrace_state *state, uintptr_t base_address,
+		  const struct dwarf_sections *dwarf_sections,
+		  int is_bigendian, const char *path,
+		  const char *buildid_data, size_t buildid_size,
+		  backtrace_error_callback error_callback, void *data)
+{
+  int descriptor;
+  struct stat st;
+  struct backtrace_view view;
+  const unsigned char *base;
+  const struct dwarf_cache_header *hdr;
+  const struct dwarf_cache_addrs *caddrs;
+  struct dwarf_cache cache;
+  uint64_t size;
+  uint64_t offset;
+  uint64_t units_offset;
+  uint64_t addrs_offset;
+  uint64_t lines_offset;
+  uint64_t functions_offset;
+  uint64_t function_addrs_offset;
+  uint64_t strings_offset;
+  struct unit *units;
+  struct unit **punits;
+  struct unit_addrs *addrs;
+  size_t addrs_count;
+  struct dwarf_data *fdata;
+  size_t i;
+  int ok;
+
+  descriptor = open (path, (int) (O_RDONLY | O_BINARY | O_CLOEXEC));
+  if (descriptor < 0)
+    return NULL;
+
+  if (fstat (descriptor, &st) < 0
+      || st.st_size < (off_t) sizeof (struct dwarf_cache_header))
+    {
+      backtrace_close (descriptor, error_callback, data);
+      return NULL;
+    }
+
+  if (!backtrace_get_view (state, descriptor, 0, st.st_size, error_callback,
+			   data, &view))
+    {
+      backtrace_close (descriptor, error_callback, data);
+      return NULL;
+    }
+  backtrace_close (descriptor, error_callback, data);
+
+  base = (const unsigned char *) view.data;
+  hdr = (const struct dwarf_cache_header *) view.data;
+  size = (uint64_t) st.st_size;
+  units = NULL;
+  punits = NULL;
+  addrs = NULL;
+
+  if (memcmp (hdr->magic, DWARF_CACHE_MAGIC, sizeof hdr->magic) != 0
+      || hdr->version != DWARF_CACHE_VERSION
+      || hdr->byte_order != DWARF_CACHE_BYTE_ORDER
+      || hdr->buildid_size != buildid_size
+      || hdr->units_count == 0)
+    goto fail;
+
+  offset = sizeof (struct dwarf_cache_header);
+  if (!dwarf_cache_section (&offset, (buildid_size + 7) & ~(uint64_t) 7, 1,
+			    size)
+      || memcmp (base + sizeof (struct dwarf_cache_header), buildid_data,
+		 buildid_size) != 0)
+    goto fail;
+
+  units_offset = offset;
+  if (!dwarf_cache_section (&offset, hdr->units_count,
+			    sizeof (struct dwarf_cache_unit), size))
+    goto fail;
+  addrs_offset = offset;
+  if (!dwarf_cache_section (&offset, hdr->addrs_count,
+			    sizeof (struct dwarf_cache_addrs), size))
+    goto fail;
+  lines_offset = offset;
+  if (!dwarf_cache_section (&offset, hdr->lines_count,
+			    sizeof (struct dwarf_cache_line), size))
+    goto fail;
+  functions_offset = offset;
+  if (!dwarf_cache_section (&offset, hdr->functions_count,
+			    sizeof (struct dwarf_cache_function), size))
+    goto fail;
+  function_addrs_offset = offset;
+  if (!dwarf_cache_section (&offset, hdr->function_addrs_count,
+			    sizeof (struct dwarf_cache_function_addrs), size))
+    goto fail;
+  strings_offset = offset;
+  if (!dwarf_cache_section (&offset, hdr->strings_size, 1, size)
+      || offset != size
+      || (hdr->strings_size > 0 && base[size - 1] != '\0'))
+    goto fail;
+
+  cache.units = (const struct dwarf_cache_unit *) (base + units_offset);
+  cache.units_count = hdr->units_count;
+  cache.lines = (const struct dwarf_cache_line *) (base + lines_offset);
+  cache.lines_count = hdr->lines_count;
+  cache.functions = ((const struct dwarf_cache_function *)
+		     (base + functions_offset));
+  cache.functions_count = hdr->functions_count;
+  cache.function_addrs = ((const struct dwarf_cache_function_addrs *)
+			  (base + function_addrs_offset));
+  cache.function_addrs_count = hdr->function_addrs_count;
+  cache.strings = (const char *) (base + strings_offset);
+  cache.strings_size = hdr->strings_size;
+  caddrs = (const struct dwarf_cache_addrs *) (base + addrs_offset);
+  addrs_count = hdr->addrs_count;
+
+  units = ((struct unit *)
+	   backtrace_alloc (state, cache.units_count * sizeof (struct unit),
+			    error_callback, data));
+  if (units == NULL)
+    goto fail;
+  punits = ((struct unit **)
+	    backtrace_alloc (state, cache.units_count * sizeof (struct unit *),
+			     error_callback, data));
+  if (punits == NULL)
+    goto fail;
+  /* Allocate a trailing entry, but don't include it in
+     ADDRS_COUNT.  */
+  addrs = ((struct unit_addrs *)
+	   backtrace_alloc (state, (addrs_count + 1) * sizeof (struct unit_addrs),
+			    error_callback, data));
+  if (addrs == NULL)
+    goto fail;
+
+  /* Only the fields that dwarf_lookup_pc uses are set; the lines and
+     functions of each unit are read from the cache file as needed.  */
+  ok = 1;
+  for (i = 0; i < cache.units_count; ++i)
+    {
+      struct unit *u;
+
+      u = &units[i];
+      memset (u, 0, sizeof *u);
+      u->filename = dwarf_cache_string (&cache, cache.units[i].filename, &ok);
+      u->comp_dir = dwarf_cache_string (&cache, cache.units[i].comp_dir, &ok);
+      u->cache_index = i;
+      punits[i] = u;
+    }
+
+  for (i = 0; i < addrs_count; ++i)
+    {
+      if (caddrs[i].unit >= cache.units_count)
+	{
+	  ok = 0;
+	  break;
+	}
+      addrs[i].low = caddrs[i].low + base_address;
+      addrs[i].high = caddrs[i].high + base_address;
+      addrs[i].u = &units[caddrs[i].unit];
+    }
+  addrs[addrs_count].low = 0;
+  --addrs[addrs_count].low;
+  addrs[addrs_count].high = addrs[addrs_count].low;
+  addrs[addrs_count].u = NULL;
+
+  if (!ok)
+    goto fail;
+
+  fdata = ((struct dwarf_data *)
+	   backtrace_alloc (state, sizeof (struct dwarf_data),
+			    error_callback, data));
+  if (fdata == NULL)
+    goto fail;
+
+  fdata->next = NULL;
+  fdata->altlink = NULL;
+  fdata->base_address = base_address;
+  fdata->addrs = addrs;
+  fdata->addrs_count = addrs_count;
+  fdata->units = punits;
+  fdata->units_count = cache.units_count;
+  fdata->dwarf_sections = *dwarf_sections;
+  fdata->is_bigendian = is_bigendian;
+  memset (&fdata->fvec, 0, sizeof fdata->fvec);
+  fdata->cache = cache;
+
+  /* The view is never released, since the strings point into it.  */
+  return fdata;
+
+ fail:
+  if (units != NULL)
+    backtrace_free (state, units, hdr->units_count * sizeof (struct unit),
+		    error_callback, data);
+  if (punits != NULL)
+    backtrace_free (state, punits,
+		    hdr->units_count * sizeof (struct unit *),
+		    error_callback, data);
+  if (addrs != NULL)
+    backtrace_free (state, addrs,
+		    (hdr->addrs_count + 1) * sizeof (struct unit_addrs),
+		    error_callback, data);
+  backtrace_release_view (state, &view, error_callback, data);
+  return NULL;
+}
+
+/* Recently added strings of a cache file being written, indexed by a
+   hash of their address.  The lines of a unit mostly share a few file
+   names, so this catches most duplicates.  */
+
+#define DWARF_CACHE_RECENT 256
+
+struct dwarf_cache_recent
+{
+  const char *str;
+  uint64_t offset;
+};
+
+/* A cache file being written.  Each vector holds one of the arrays of
+   the file.  */
+
+struct dwarf_cache_writer
+{
+  struct backtrace_vector units;
+  struct backtrace_vector addrs;
+  struct backtrace_vector lines;
+  struct backtrace_vector functions;
+  struct backtrace_vector function_addrs;
+  struct backtrace_vector strings;
+  struct dwarf_cache_recent recent[DWARF_CACHE_RECENT];
+};
+
+/* The index of a function in a cache file being written, used to map
+   struct function pointers to indexes.  */
+
+struct dwarf_cache_findex
+{
+  struct function *function;
+  uint64_t index;
+};
+
+/* Compare struct function pointers for qsort.  */
+
+static int
+dwarf_cache_function_compare (const void *v1, const void *v2)
+{
+  uintptr_t f1 = (uintptr_t) *(struct function * const *) v1;
+  uintptr_t f2 = (uintptr_t) *(struct function * const *) v2;
+
+  if (f1 < f2)
+    return -1;
+  if (f1 > f2)
+    return 1;
+  return 0;
+}
+
+/* Compare struct dwarf_cache_findex for qsort.  */
+
+static int
+dwarf_cache_findex_compare (const void *v1, const void *v2)
+{
+  uintptr_t f1 = (uintptr_t) ((const struct dwarf_cache_findex *)
+			      v1)->function;
+  uintptr_t f2 = (uintptr_t) ((const struct dwarf_cache_findex *)
+			      v2)->function;
+
+  if (f1 < f2)
+    return -1;
+  if (f1 > f2)
+    return 1;
+  return 0;
+}
+
+/* Compare a struct function pointer to a struct dwarf_cache_findex
+   for bsearch.  */
+
+static int
+dwarf_cache_findex_search (const void *vkey, const void *ventry)
+{
+  uintptr_t key = (uintptr_t) *(struct function * const *) vkey;
+  uintptr_t f = (uintptr_t) ((const struct dwarf_cache_findex *)
+			     ventry)->function;
+
+  if (key < f)
+    return -1;
+  if (key > f)
+    return 1;
+  return 0;
+}
+
+/* Append SIZE bytes at P to VEC.  Return 1 on success, 0 on
+   failure.  */
+
+static int
+dwarf_cache_append (struct backtrace_state *state,
+		    struct backtrace_vector *vec, const void *p, size_t size,
+		    backtrace_error_callback error_callback, void *data)
+{
+  void *q;
+
+  q = backtrace_vector_grow (state, size, error_callback, data, vec);
+  if (q == NULL)
+    return 0;
+  memcpy (q, p, size);
+  return 1;
+}
+
+/* Add STR to the string table of W and set *OFFSET to its offset.
+   Return 1 on success, 0 on failure.  */
+
+static int
+dwarf_cache_add_string (struct backtrace_state *state,
+			struct dwarf_cache_writer *w, const char *str,
+			backtrace_error_callback error_callback, void *data,
+			uint64_t *offset)
+{
+  struct dwarf_cache_recent *r;
+
+  if (str == NULL)
+    {
+      *offset = DWARF_CACHE_NONE;
+      return 1;
+    }
+
+  r = &w->recent[((uintptr_t) str >> 3) % DWARF_CACHE_RECENT];
+  if (r->str == str)
+    {
+      *offset = r->offset;
+      return 1;
+    }
+
+  *offset = w->strings.size;
+  if (!dwarf_cache_append (state, &w->strings, str, strlen (str) + 1,
+			   error_callback, data))
+    return 0;
+  r->str = str;
+  r->offset = *offset;
+  return 1;
+}
+
+/* Append the functions of the COUNT ranges at ADDRS to FVEC, a vector
+   of struct function pointers.  Return 1 on success, 0 on failure.  */
+
+static int
+dwarf_cache_collect_functions (struct backtrace_state *state,
+			       struct backtrace_vector *fvec,
+			       const struct function_addrs *addrs,
+			       size_t count,
+			       backtrace_error_callback error_callback,
+			       void *data)
+{
+  size_t i;
+
+  for (i = 0; i < count; ++i)
+    {
+      if (!dwarf_cache_append (state, fvec, &addrs[i].function,
+			       sizeof (struct function *), error_callback,
+			       data))
+	return 0;
+    }
+  return 1;
+}
+
+/* Add the COUNT ranges at ADDRS to W.  FINDEX maps the FINDEX_COUNT
+   functions of the unit to their indexes.  Return 1 on success, 0 on
+   failure.  */
+
+static int
+dwarf_cache_add_function_addrs (struct backtrace_state *state,
+				struct dwarf_data *ddata,
+				struct dwarf_cache_writer *w,
+				const struct function_addrs *addrs,
+				size_t count,
+				const struct dwarf_cache_findex *findex,
+				size_t findex_count,
+				backtrace_error_callback error_callback,
+				void *data)
+{
+  size_t i;
+
+  for (i = 0; i < count; ++i)
+    {
+      const struct dwarf_cache_findex *fi;
+      struct dwarf_cache_function_addrs cfa;
+
+      fi = ((const struct dwarf_cache_findex *)
+	    bsearch (&addrs[i].function, findex, findex_count,
+		     sizeof (struct dwarf_cache_findex),
+		     dwarf_cache_findex_search));
+      if (fi == NULL)
+	return 0;
+
+      cfa.low = addrs[i].low - ddata->base_address;
+      cfa.high = addrs[i].high - ddata->base_address;
+      cfa.function = fi->index;
+      if (!dwarf_cache_append (state, &w->function_addrs, &cfa, sizeof cfa,
+			       error_callback, data))
+	return 0;
+    }
+  return 1;
+}
+
+/* Add the unit U of DDATA, whose line and function information has
+   been read, to W.  Return 1 on success, 0 on failure.  */
+
+static int
+dwarf_cache_add_unit (struct backtrace_state *state, struct dwarf_data *ddata,
+		      struct dwarf_cache_writer *w, struct unit *u,
+		      backtrace_error_callback error_callback, void *data)
+{
+  struct dwarf_cache_unit cu;
+  struct backtrace_vector fvec;
+  struct function **functions;
+  size_t functions_count;
+  struct dwarf_cache_findex *findex;
+  size_t findex_size;
+  size_t level;
+  size_t end;
+  size_t i;
+  size_t j;
+  int ret;
+
+  memset (&fvec, 0, sizeof fvec);
+  findex = NULL;
+  findex_size = 0;
+  ret = 0;
+
+  if (!dwarf_cache_add_string (state, w, u->filename, error_callback, data,
+			       &cu.filename)
+      || !dwarf_cache_add_string (state, w, u->comp_dir, error_callback,
+				  data, &cu.comp_dir))
+    goto out;
+
+  cu.lines = DWARF_CACHE_NONE;
+  cu.lines_count = 0;
+  cu.functions = w->functions.size / sizeof (struct dwarf_cache_function);
+  cu.functions_count = 0;
+  cu.function_addrs = (w->function_addrs.size
+		       / sizeof (struct dwarf_cache_function_addrs));
+  cu.function_addrs_total = 0;
+  cu.function_addrs_count = 0;
+
+  if (u->lines == (struct line *) (uintptr_t) -1)
+    {
+      ret = dwarf_cache_append (state, &w->units, &cu, sizeof cu,
+				error_callback, data);
+      goto out;
+    }
+
+  cu.lines = w->lines.size / sizeof (struct dwarf_cache_line);
+  cu.lines_count = u->lines_count;
+  for (i = 0; i < u->lines_count; ++i)
+    {
+      struct dwarf_cache_line cl;
+
+      cl.pc = (uint64_t) (u->lines[i].pc - ddata->base_address);
+      if (!dwarf_cache_add_string (state, w, u->lines[i].filename,
+				   error_callback, data, &cl.filename))
+	goto out;
+      cl.lineno = u->lines[i].lineno;
+      if (!dwarf_cache_append (state, &w->lines, &cl, sizeof cl,
+			       error_callback, data))
+	goto out;
+    }
+
+  /* Collect the functions of the unit one level of inlining at a
+     time.  A function with several ranges appears once per range, so
+     sort each level and drop the duplicates.  */
+  if (!dwarf_cache_collect_functions (state, &fvec, u->function_addrs,
+				      u->function_addrs_count,
+				      error_callback, data))
+    goto out;
+  level = 0;
+  while (level < (end = fvec.size / sizeof (struct function *)))
+    {
+      functions = (struct function **) fvec.base;
+      backtrace_qsort (functions + level, end - level,
+		       sizeof (struct function *),
+		       dwarf_cache_function_compare);
+      for (i = j = level; i < end; ++i)
+	if (j == level || functions[i] != functions[j - 1])
+	  functions[j++] = functions[i];
+      fvec.size = j * sizeof (struct function *);
+      fvec.alc += (end - j) * sizeof (struct function *);
+
+      for (i = level; i < j; ++i)
+	{
+	  struct function *f;
+
+	  f = ((struct function **) fvec.base)[i];
+	  if (!dwarf_cache_collect_functions (state, &fvec, f->function_addrs,
+					      f->function_addrs_count,
+					      error_callback, data))
+	    goto out;
+	}
+      level = j;
+    }
+  functions = (struct function **) fvec.base;
+  functions_count = fvec.size / sizeof (struct function *);
+
+  if (functions_count > 0)
+    {
+      findex_size = functions_count * sizeof (struct dwarf_cache_findex);
+      findex = ((struct dwarf_cache_findex *)
+		backtrace_alloc (state, findex_size, error_callback, data));
+      if (findex == NULL)
+	goto out;
+      for (i = 0; i < functions_count; ++i)
+	{
+	  findex[i].function = functions[i];
+	  findex[i].index = i;
+	}
+      backtrace_qsort (findex, functions_count,
+		       sizeof (struct dwarf_cache_findex),
+		       dwarf_cache_findex_compare);
+    }
+
+  if (!dwarf_cache_add_function_addrs (state, ddata, w, u->function_addrs,
+				       u->function_addrs_count, findex,
+				       functions_count, error_callback, data))
+    goto out;
+
+  for (i = 0; i < functions_count; ++i)
+    {
+      struct function *f;
+      struct dwarf_cache_function cf;
+
+      f = functions[i];
+      if (!dwarf_cache_add_string (state, w, f->name, error_callback, data,
+				   &cf.name)
+	  || !dwarf_cache_add_string (state, w, f->caller_filename,
+				      error_callback, data,
+				      &cf.caller_filename))
+	goto out;
+      cf.caller_lineno = f->caller_lineno;
+      cf.function_addrs_count = f->function_addrs_count;
+      if (!dwarf_cache_append (state, &w->functions, &cf, sizeof cf,
+			       error_callback, data)
+	  || !dwarf_cache_add_function_addrs (state, ddata, w,
+					      f->function_addrs,
+					      f->function_addrs_count,
+					      findex, functions_count,
+					      error_callback, data))
+	goto out;
+    }
+
+  cu.functions_count = functions_count;
+  cu.function_addrs_total = ((w->function_addrs.size
+			      / sizeof (struct dwarf_cache_function_addrs))
+			     - cu.function_addrs);
+  cu.function_addrs_count = u->function_addrs_count;
+  ret = dwarf_cache_append (state, &w->units, &cu, sizeof cu,
+			    error_callback, data);
+
+ out:
+  if (findex != NULL)
+    backtrace_free (state, findex, findex_size, error_callback, data);
+  backtrace_vector_free (state, &fvec, error_callback, data);
+  return ret;
+}
+
+/* Write LEN bytes at P to DESCRIPTOR.  Return 1 on success, 0 on
+   failure.  */
+
+static int
+dwarf_cache_write (int descriptor, const void *p, size_t len)
+{
+  const char *s;
+
+  s = (const char *) p;
+  while (len > 0)
+    {
+      ssize_t c;
+
+      c = write (descriptor, s, len);
+      if (c < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return 0;
+	}
+      s += c;
+      len -= (size_t) c;
+    }
+  return 1;
+}
+
+/* The work of reading the line and function information of every
+   unit in dwarf_cache_save.  */
+
+struct unit_info_work
+{
+  struct dwarf_work work;
+  struct backtrace_state *state;
+  struct dwarf_data *ddata;
+  backtrace_error_callback error_callback;
+  void *data;
+};
+
+/* Read the line and function information of unit INDEX of VWORK, if
+   that has not been done yet.  A unit without useful information is
+   not an error.  Returns 1.  */
+
+static int
+read_unit_info (struct dwarf_work *vwork, size_t index,
+		size_t worker ATTRIBUTE_UNUSED)
+{
+  struct unit_info_work *work;
+  struct dwarf_data *ddata;
+  struct unit *u;
+  struct line_header lhdr;
+  struct line *lines;
+  size_t count;
+  struct function_addrs *function_addrs;
+  size_t function_addrs_count;
+  struct function_vector *pfvec;
+
+  work = (struct unit_info_work *) vwork;
+  ddata = work->ddata;
+  u = ddata->units[index];
+  if (u->lines != NULL)
+    return 1;
+
+  /* DDATA->FVEC can only be shared by a single thread.  */
+  if (work->state->threaded)
+    pfvec = NULL;
+  else
+    pfvec = &ddata->fvec;
+
+  function_addrs = NULL;
+  function_addrs_count = 0;
+  if (read_line_info (work->state, ddata, work->error_callback, work->data,
+		      u, &lhdr, &lines, &count))
+    {
+      read_function_info (work->state, ddata, &lhdr, work->error_callback,
+			  work->data, u, pfvec, &function_addrs,
+			  &function_addrs_count);
+      free_line_header (work->state, &lhdr, work->error_callback,
+			work->data);
+    }
+  u->lines_count = count;
+  u->function_addrs = function_addrs;
+  u->function_addrs_count = function_addrs_count;
+  u->lines = lines;
+  return 1;
+}
+
+/* Read the line and function information of every unit of DDATA, and
+   save it all in the cache file PATH for the object with build ID
+   BUILDID_DATA.  DDATA has not been published yet, so no other
+   thread can be looking at it.  The cache is only an optimization,
+   so failing to write it is not an error.  */
+
+static void
+dwarf_cache_save (struct backtrace_state *state, struct dwarf_data *ddata,
+		  const char *path, const char *buildid_data,
+		  size_t buildid_size,
+		  backtrace_error_callback error_callback, void *data)
+{
+  static const char zeroes[8];
+  struct unit_info_work work;
+  struct dwarf_cache_writer w;
+  struct dwarf_cache_header hdr;
+  char *tmp;
+  size_t tmp_size;
+  int descriptor;
+  size_t i;
+  int ok;
+
+  if (ddata->units_count == 0)
+    return;
+
+  memset (&w, 0, sizeof w);
+  tmp = NULL;
+  tmp_size = 0;
+  ok = 1;
+
+  work.work.fn = read_unit_info;
+  work.work.count = ddata->units_count;
+  work.state = state;
+  work.ddata = ddata;
+  work.error_callback = error_callback;
+  work.data = data;
+  dwarf_work_run (state, &work.work,
+		  dwarf_work_workers (state, ddata->units_count),
+		  error_callback, data);
+
+  for (i = 0; ok && i < ddata->units_count; ++i)
+    ok = dwarf_cache_add_unit (state, ddata, &w, ddata->units[i],
+			       error_callback, data);
+
+  for (i = 0; ok && i < ddata->addrs_count; ++i)
+    {
+      struct unit **pu;
+      struct dwarf_cache_addrs ca;
+
+      pu = ((struct unit **)
+	    bsearch (&ddata->addrs[i].u->low_offset, ddata->units,
+		     ddata->units_count, sizeof (struct unit *),
+		     units_search));
+      if (pu == NULL)
+	ok = 0;
+      else
+	{
+	  ca.low = ddata->addrs[i].low - ddata->base_address;
+	  ca.high = ddata->addrs[i].high - ddata->base_address;
+	  ca.unit = pu - ddata->units;
+	  ok = dwarf_cache_append (state, &w.addrs, &ca, sizeof ca,
+				   error_callback, data);
+	}
+    }
+
+  if (!ok)
+    goto out;
+
+  /* Write to a temporary file and rename it, so that other processes
+     never see a partial file.  */
+  tmp_size = strlen (path) + 32;
+  tmp = (char *) backtrace_alloc (state, tmp_size, error_callback, data);
+  if (tmp == NULL)
+    goto out;
+  snprintf (tmp, tmp_size, "%s.%ld.tmp", path, (long) getpid ());
+
+  descriptor = open (tmp, (int) (O_WRONLY | O_CREAT | O_TRUNC | O_BINARY
+				 | O_CLOEXEC), 0644);
+  if (descriptor < 0)
+    goto out;
+
+  memset (&hdr, 0, sizeof hdr);
+  memcpy (hdr.magic, DWARF_CACHE_MAGIC, sizeof hdr.magic);
+  hdr.version = DWARF_CACHE_VERSION;
+  hdr.byte_order = DWARF_CACHE_BYTE_ORDER;
+  hdr.buildid_size = buildid_size;
+  hdr.units_count = w.units.size / sizeof (struct dwarf_cache_unit);
+  hdr.addrs_count = w.addrs.size / sizeof (struct dwarf_cache_addrs);
+  hdr.lines_count = w.lines.size / sizeof (struct dwarf_cache_line);
+  hdr.functions_count = (w.functions.size
+			 / sizeof (struct dwarf_cache_function));
+  hdr.function_addrs_count = (w.function_addrs.size
+			      / sizeof (struct dwarf_cache_function_addrs));
+  hdr.strings_size = w.strings.size;
+
+  ok = (dwarf_cache_write (descriptor, &hdr, sizeof hdr)
+	&& dwarf_cache_write (descriptor, buildid_data, buildid_size)
+	&& dwarf_cache_write (descriptor, zeroes,
+			      ((buildid_size + 7) & ~(size_t) 7) - buildid_size)
+	&& dwarf_cache_write (descriptor, w.units.base, w.units.size)
+	&& dwarf_cache_write (descriptor, w.addrs.base, w.addrs.size)
+	&& dwarf_cache_write (descriptor, w.lines.base, w.lines.size)
+	&& dwarf_cache_write (descriptor, w.functions.base, w.functions.size)
+	&& dwarf_cache_write (descriptor, w.function_addrs.base,
+			      w.function_addrs.size)
+	&& dwarf_cache_write (descriptor, w.strings.base, w.strings.size));
+  if (close (descriptor) < 0)
+    ok = 0;
+  if (!ok || rename (tmp, path) < 0)
+    unlink (tmp);
+
+ out:
+  if (tmp != NULL)
+    backtrace_free (state, tmp, tmp_size, error_callback, data);
+  backtrace_vector_free (state, &w.units, error_callback, data);
+  backtrace_vector_free (state, &w.addrs, error_callback, data);
+  backtrace_vector_free (state, &w.lines, error_callback, data);
+  backtrace_vector_free (state, &w.functions, error_callback, data);
+  backtrace_vector_free (state, &w.function_addrs, error_callback, data);
+  backtrace_vector_free (state, &w.strings, error_callback, data);
+}
+
+/* Return the name of the cache file for the object with build ID
+   BUILDID_DATA in the directory DIR, allocated with backtrace_alloc,
+   and set *SIZE to its allocated size.  Return NULL on failure.  */
+
+static char *
+dwarf_cache_path (struct backtrace_state *state, const char *dir,
+		  const char *buildid_data, size_t buildid_size,
+		  backtrace_error_callback error_callback, void *data,
+		  size_t *size)
+{
+  static const char hex[] = "0123456789abcdef";
+  static const char suffix[] = ".btcache";
+  size_t dir_len;
+  char *path;
+  char *t;
+  size_t i;
+
+  dir_len = strlen (dir);
+  *size = dir_len + 1 + buildid_size * 2 + sizeof suffix;
+  path = (char *) backtrace_alloc (state, *size, error_callback, data);
+  if (path == NULL)
+    return NULL;
+
+  memcpy (path, dir, dir_len);
+  t = path + dir_len;
+  *t++ = '/';
+  for (i = 0; i < buildid_size; ++i)
+    {
+      unsigned char b;
+
+      b = (unsigned char) buildid_data[i];
+      *t++ = hex[(b & 0xf0) >> 4];
+      *t++ = hex[b & 0x0f];
+    }
+  memcpy (t, suffix, sizeof suffix);
+
+  return path;
+}
+
+/* Look for a PC in the DWARF mapping for one module.  On success,
+   call CALLBACK and return whatever it returns.  On error, call
+   ERROR_CALLBACK and return 0.  Sets *FOUND to 1 if the PC is found,
+   0 if not.  */
+
+static int
+dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
+		 uintptr_t pc, backtrace_full_callback callback,
+		 backtrace_error_callback error_callback, void *data,
+		 int *found)
+{
+  struct unit_addrs *entry;
+  int found_entry;
+  struct unit *u;
+  int new_data;
+  struct line *lines;
+  struct line *ln;
+  struct function_addrs *p;
+  struct function_addrs *fmatch;
+  struct function *function;
+  const char *filename;
+  int lineno;
+  int ret;
+
+  *found = 1;
+
+  /* Find an address range that includes PC.  Our search isn't safe if
+     PC == -1, as we use that as a sentinel value, so skip the search
+     in that case.  */
+  entry = (ddata->addrs_count == 0 || pc + 1 == 0
+	   ? NULL
+	   : bsearch (&pc, ddata->addrs, ddata->addrs_count,
+		      sizeof (struct unit_addrs), unit_addrs_search));
+
+  if (entry == NULL)
+    {
+      *found = 0;
+      return 0;
+    }
+
+  /* Here pc >= entry->low && pc < (entry + 1)->low.  The unit_addrs
+     are sorted by low, so if pc > p->low we are at the end of a range
+     of unit_addrs with the same low value.  If pc == p->low walk
+     forward to the end of the range with that low value.  Then walk
+     backward and use the first range that includes pc.  */
+  while (pc == (entry + 1)->low)
+    ++entry;
+  found_entry = 0;
+  while (1)
+    {
+      if (pc < entry->high)
+	{
+	  found_entry = 1;
+	  break;
+	}
+      if (entry == ddata->addrs)
+	break;
+      if ((entry - 1)->low < entry->low)
+	break;
+      --entry;
+    }
+  if (!found_entry)
+    {
+      *found = 0;
+      return 0;
+    }
+
+  /* We need the lines, lines_count, function_addrs,
+     function_addrs_count fields of u.  If they are not set, we need
+     to set them.  When running in threaded mode, we need to allow for
+     the possibility that some other thread is setting them
+     simultaneously.  */
+
+  u = entry->u;
+  lines = u->lines;
+
+  /* Skip units with no useful line number information by walking
+     backward.  Useless line number information is marked by setting
+     lines == -1.  */
+  while (entry > ddata->addrs
+	 && pc >= (entry - 1)->low
+	 && pc < (entry - 1)->high)
+    {
+      if (state->threaded)
+	lines = (struct line *) backtrace_atomic_load_pointer (&u->lines);
+
+      if (lines != (struct line *) (uintptr_t) -1)
+	break;
+
+      --entry;
+
+      u = entry->u;
+      lines = u->lines;
+    }
+
+  if (state->threaded)
+    lines = backtrace_atomic_load_pointer (&u->lines);
+
+  new_data = 0;
+  if (lines == NULL)
+    {
+      struct function_addrs *function_addrs;
+      size_t function_addrs_count;
+      struct line_header lhdr;
+      size_t count;
+
+      /* We have never read the line information for this unit.  Read
+	 it now.  */
+
+      function_addrs = NULL;
       function_addrs_count = 0;
-      if (read_line_info (state, ddata, error_callback, data, entry->u, &lhdr,
-			  &lines, &count))
+      if (ddata->cache.units != NULL)
+	new_data = dwarf_cache_read_unit (state, ddata, entry->u,
+					  error_callback, data, &lines, &count,
+					  &function_addrs,
+					  &function_addrs_count);
+      else if (read_line_info (state, ddata, error_callback, data, entry->u,
+			       &lhdr, &lines, &count))
 	{
 	  struct function_vector *pfvec;
 
@@ -3987,13 +5490,15 @@ build_dwarf_data (struct backtrace_state *state,
   fdata->dwarf_sections = *dwarf_sections;
   fdata->is_bigendian = is_bigendian;
   memset (&fdata->fvec, 0, sizeof fdata->fvec);
+  memset (&fdata->cache, 0, sizeof fdata->cache);
 
   return fdata;
 }
 
 /* Build our data structures from the DWARF sections for a module.
-   Set FILELINE_FN and STATE->FILELINE_DATA.  Return 1 on success, 0
-   on failure.  */
+   BUILDID_DATA and BUILDID_SIZE are the build ID of the module, if
+   known, used to name its cache file.  Set FILELINE_FN and
+   STATE->FILELINE_DATA.  Return 1 on success, 0 on failure.  */
 
 int
 backtrace_dwarf_add (struct backtrace_state *state,
@@ -4001,14 +5506,49 @@ backtrace_dwarf_add (struct backtrace_state *state,
 		     const struct dwarf_sections *dwarf_sections,
 		     int is_bigendian,
 		     struct dwarf_data *fileline_altlink,
+		     const char *buildid_data, size_t buildid_size,
 		     backtrace_error_callback error_callback,
 		     void *data, fileline *fileline_fn,
 		     struct dwarf_data **fileline_entry)
 {
   struct dwarf_data *fdata;
+  char *cache_path;
+  size_t cache_path_size;
+
+  /* A module with FILELINE_ENTRY set is the .gnu_debugaltlink file of
+     another one, whose units refer into its DWARF data, so it is not
+     cached on its own.  */
+  cache_path = NULL;
+  cache_path_size = 0;
+  if (buildid_size > 0 && fileline_entry == NULL)
+    {
+      const char *dir;
+
+      dir = getenv ("BACKTRACE_CACHE_DIR");
+      if (dir != NULL && *dir != '\0')
+	cache_path = dwarf_cache_path (state, dir, buildid_data, buildid_size,
+				       error_callback, data,
+				       &cache_path_size);
+    }
+
+  fdata = NULL;
+  if (cache_path != NULL)
+    fdata = dwarf_cache_load (state, base_address, dwarf_sections,
+			      is_bigendian, cache_path, buildid_data,
+			      buildid_size, error_callback, data);
+  if (fdata == NULL)
+    {
+      fdata = build_dwarf_data (state, base_address, dwarf_sections,
+				is_bigendian, fileline_altlink,
+				error_callback, data);
+      if (fdata != NULL && cache_path != NULL)
+	dwarf_cache_save (state, fdata, cache_path, buildid_data,
+			  buildid_size, error_callback, data);
+    }
+
+  if (cache_path != NULL)
+    backtrace_free (state, cache_path, cache_path_size, error_callback, data);
 
-  fdata = build_dwarf_data (state, base_address, dwarf_sections, is_bigendian,
-			    fileline_altlink, error_callback, data);
   if (fdata == NULL)
     return 0;
 
@@ -4414,9 +4414,10 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
   elf_release_view (state, &names_view, error_callback, data);
   names_view_valid = 0;
 
-  /* If the debug info is in a separate file, read that one instead.  */
+  /* If the debug info is in a separate file, read that one instead.
+     A file that is itself debug info is never split further.  */
 
-  if (buildid_data != NULL)
+  if (buildid_data != NULL && !debuginfo)
     {
       int d;
 
@@ -4426,14 +4427,16 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
 	{
 	  int ret;
 
-	  elf_release_view (state, &buildid_view, error_callback, data);
 	  if (debuglink_view_valid)
 	    elf_release_view (state, &debuglink_view, error_callback, data);
 	  if (debugaltlink_view_valid)
 	    elf_release_view (state, &debugaltlink_view, error_callback, data);
+	  /* Pass the build ID on, so that the debug file reads its own
+	     and can use it to name its cache file.  */
 	  ret = elf_add (state, "", d, NULL, 0, base_address, error_callback,
 			 data, fileline_fn, found_sym, found_dwarf, NULL, 0,
-			 1, NULL, 0);
+			 1, buildid_data, buildid_size);
+	  elf_release_view (state, &buildid_view, error_callback, data);
 	  if (ret < 0)
 	    backtrace_close (d, error_callback, data);
 	  else if (descriptor >= 0)
@@ -4442,12 +4445,6 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
 	}
     }
 
-  if (buildid_view_valid)
-    {
-      elf_release_view (state, &buildid_view, error_callback, data);
-      buildid_view_valid = 0;
-    }
-
   if (opd)
     {
       elf_release_view (state, &opd->view, error_callback, data);
@@ -4471,6 +4468,8 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
 	  ret = elf_add (state, "", d, NULL, 0, base_address, error_callback,
 			 data, fileline_fn, found_sym, found_dwarf, NULL, 0,
 			 1, NULL, 0);
+	  if (buildid_view_valid)
+	    elf_release_view (state, &buildid_view, error_callback, data);
 	  if (ret < 0)
 	    backtrace_close (d, error_callback, data);
 	  else if (descriptor >= 0)
@@ -4504,6 +4503,8 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
 	  debugaltlink_view_valid = 0;
 	  if (ret < 0)
 	    {
+	      if (buildid_view_valid)
+		elf_release_view (state, &buildid_view, error_callback, data);
 	      backtrace_close (d, error_callback, data);
 	      return ret;
 	    }
@@ -4536,6 +4537,8 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
 			 gnu_debugdata_uncompressed_size, base_address,
 			 error_callback, data, fileline_fn, found_sym,
 			 found_dwarf, NULL, 0, 0, NULL, 0);
+	  if (buildid_view_valid)
+	    elf_release_view (state, &buildid_view, error_callback, data);
 	  if (ret >= 0 && descriptor >= 0)
 	    backtrace_close(descriptor, error_callback, data);
 	  return ret;
@@ -4574,6 +4577,11 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
     }
   if (min_offset == 0 || max_offset == 0)
     {
+      if (buildid_view_valid)
+	{
+	  elf_release_view (state, &buildid_view, error_callback, data);
+	  buildid_view_valid = 0;
+	}
       if (descriptor >= 0)
 	{
 	  if (!backtrace_close (descriptor, error_callback, data))
@@ -4748,11 +4756,17 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
 
   if (!backtrace_dwarf_add (state, base_address, &dwarf_sections,
 			    ehdr.e_ident[EI_DATA] == ELFDATA2MSB,
-			    fileline_altlink,
+			    fileline_altlink, buildid_data, buildid_size,
 			    error_callback, data, fileline_fn,
 			    fileline_entry))
     goto fail;
 
+  if (buildid_view_valid)
+    {
+      elf_release_view (state, &buildid_view, error_callback, data);
+      buildid_view_valid = 0;
+    }
+
   *found_dwarf = 1;
 
   return 1;
@@ -330,6 +330,8 @@ extern int backtrace_dwarf_add (struct backtrace_state *state,
 				const struct dwarf_sections *dwarf_sections,
 				int is_bigendian,
 				struct dwarf_data *fileline_altlink,
+				const char *buildid_data,
+				size_t buildid_size,
 				backtrace_error_callback error_callback,
 				void *data, fileline *fileline_fn,
 				struct dwarf_data **fileline_entry);
@@ -1194,8 +1194,8 @@ macho_add (struct backtrace_state *state, const char *filename, int descriptor,
 #endif
 
       if (!backtrace_dwarf_add (state, base_address, &dwarf_sections,
-				is_big_endian, NULL, error_callback, data,
-				fileline_fn, NULL))
+				is_big_endian, NULL, NULL, 0, error_callback,
+				data, fileline_fn, NULL))
 	goto fail;
     }
 
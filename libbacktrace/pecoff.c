@@ -859,6 +859,7 @@ coff_add (struct backtrace_state *state, int descriptor,
   if (!backtrace_dwarf_add (state, /* base_address */ 0, &dwarf_sections,
 			    0, /* FIXME: is_bigendian */
 			    NULL, /* altlink */
+			    NULL, 0, /* buildid */
 			    error_callback, data, fileline_fn,
 			    NULL /* returned fileline_entry */))
     goto fail;
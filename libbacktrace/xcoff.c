@@ -1308,6 +1308,7 @@ xcoff_add (struct backtrace_state *state, int descriptor, off_t offset,
       if (!backtrace_dwarf_add (state, 0, &dwarf_sections,
 				1, /* big endian */
 				NULL, /* altlink */
+				NULL, 0, /* buildid */
 				error_callback, data, fileline_fn,
 				NULL /* returned fileline_entry */))
 	goto fail;
@@ -2614,7 +2614,9 @@ cpp_get_wide_charset_name (cpp_reader *pfile)
 class mkdeps *
 cpp_get_deps (cpp_reader *pfile)
 {
-  if (!pfile->deps && CPP_OPTION (pfile, deps.style) != DEPS_NONE)
+  if (!pfile->deps
+      && (CPP_OPTION (pfile, deps.style) != DEPS_NONE
+	  || CPP_OPTION (pfile, deps.fdeps_format) != FDEPS_FMT_NONE))
     pfile->deps = deps_init ();
   return pfile->deps;
 }
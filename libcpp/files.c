@@ -199,6 +199,7 @@ static bool validate_pch (cpp_reader *, _cpp_file *file, const char *pchname);
 static int pchf_save_compare (const void *e1, const void *e2);
 static int pchf_compare (const void *d_p, const void *e_p);
 static bool check_file_against_entries (cpp_reader *, _cpp_file *, bool);
+static bool dir_may_contain_file (cpp_reader *, _cpp_file *);
 
 /* Given a filename in FILE->PATH, with the empty string interpreted
    as <stdin>, open it.
@@ -420,17 +421,22 @@ find_file_in_dir (cpp_reader *pfile, _cpp_file *file, bool *invalid_pch,
 	}
 
       file->path = path;
-      if (pch_open_file (pfile, file, invalid_pch))
-	return true;
+      if (dir_may_contain_file (pfile, file))
+	{
+	  if (pch_open_file (pfile, file, invalid_pch))
+	    return true;
 
-      if (open_file (file))
-	return true;
+	  if (open_file (file))
+	    return true;
 
-      if (file->err_no != ENOENT)
-	{
-	  open_file_failed (pfile, file, 0, loc);
-	  return true;
+	  if (file->err_no != ENOENT)
+	    {
+	      open_file_failed (pfile, file, 0, loc);
+	      return true;
+	    }
 	}
+      else
+	file->err_no = ENOENT;
 
       /* We copy the path name onto an obstack partly so that we don't
 	 leak the memory, but mostly so that we don't fragment the
@@ -1455,6 +1461,7 @@ _cpp_cleanup_files (cpp_reader *pfile)
   obstack_free (&pfile->nonexistent_file_ob, 0);
   free_file_hash_entries (pfile);
   destroy_all_cpp_files (pfile);
+  _cpp_save_include_cache (pfile);
 }
 
 /* Make the parser forget about files it has seen.  This can be useful
@@ -2145,3 +2152,416 @@ _cpp_has_header (cpp_reader *pfile, const char *fname, int angle_brackets,
   return file->err_no != ENOENT;
 }
 
+
+/* The persistent include directory cache, enabled by the include_cache
+   option.  Each search directory is listed once with readdir, and a
+   lookup of a file whose first path component is not in the listing
+   fails without touching the file system.  The listings are written to
+   the cache file at the end of the compilation and reused by later
+   compilations for as long as the directory's modification time and
+   inode number are unchanged, so that a compilation with many -I
+   directories does only one stat per directory instead of one failed
+   open per directory and header.
+
+   The cache file is a text file starting with INCLUDE_CACHE_MAGIC, and
+   then for each directory a line "MTIME INO COUNT NAME" followed by
+   COUNT lines holding the entries of the directory in the order of
+   dir_entry_compare.  */
+
+#define INCLUDE_CACHE_MAGIC "GCC include cache 1\n"
+
+/* The listing of a single directory.  */
+
+struct dir_listing
+{
+  /* The name of the directory, as in cpp_dir.  */
+  const char *name;
+
+  /* The modification time and inode number of the directory when it
+     was listed.  */
+  unsigned long mtime;
+  unsigned long ino;
+
+  /* The entries of the directory, sorted by dir_entry_compare.  NULL
+     if the listing was read from the cache file and has not been used
+     yet; then RECORD and RECORD_END delimit it in the file contents and
+     ENTRIES_TEXT points to its first entry.  */
+  unsigned int count;
+  const char **entries;
+  char *entries_text;
+  const char *record;
+  const char *record_end;
+
+  /* True if the listing was validated against the file system in this
+     compilation.  */
+  bool checked;
+
+  /* True if the listing should be written out to the cache file.  */
+  bool persist;
+};
+
+struct include_cache
+{
+  /* The contents of the cache file, or NULL.  */
+  char *buffer;
+
+  /* All listings, hashed by directory name.  */
+  struct htab *listings;
+
+  /* Storage for the listings and the entries read with readdir.  */
+  struct obstack ob;
+
+  /* True if the cache file needs to be rewritten.  */
+  bool dirty;
+};
+
+static hashval_t
+dir_listing_hash (const void *p)
+{
+  return htab_hash_string (((const struct dir_listing *) p)->name);
+}
+
+static int
+dir_listing_eq (const void *p, const void *q)
+{
+  return !strcmp (((const struct dir_listing *) p)->name, (const char *) q);
+}
+
+/* Compare two directory entries ignoring case, so that a lookup on a
+   case-insensitive file system errs on the side of going to the
+   disk.  */
+
+static int
+dir_entry_compare (const void *p, const void *q)
+{
+  const unsigned char *a = *(const unsigned char *const *) p;
+  const unsigned char *b = *(const unsigned char *const *) q;
+
+  while (*a && TOLOWER (*a) == TOLOWER (*b))
+    a++, b++;
+  return TOLOWER (*a) - TOLOWER (*b);
+}
+
+/* Parse the cache file contents in CACHE->buffer, which are LEN bytes
+   long and NUL-terminated, into listings.  Stop at the first malformed
+   record; the listings before it are still usable.  */
+
+static void
+parse_include_cache (struct include_cache *cache, size_t len)
+{
+  char *p = cache->buffer, *end = cache->buffer + len;
+
+  if (len < sizeof (INCLUDE_CACHE_MAGIC) - 1
+      || memcmp (p, INCLUDE_CACHE_MAGIC, sizeof (INCLUDE_CACHE_MAGIC) - 1))
+    return;
+  p += sizeof (INCLUDE_CACHE_MAGIC) - 1;
+
+  while (p < end)
+    {
+      const char *record = p;
+      unsigned long mtime, ino, count;
+      char *name, *eol;
+
+      mtime = strtoul (p, &p, 10);
+      ino = strtoul (p, &p, 10);
+      count = strtoul (p, &p, 10);
+      if (*p != ' ' || (eol = (char *) memchr (p, '\n', end - p)) == NULL)
+	return;
+      name = p + 1;
+      *eol = '\0';
+
+      /* Skip the entries.  */
+      p = eol + 1;
+      char *entries_text = p;
+      for (unsigned long i = 0; i < count; i++)
+	{
+	  char *nl = (char *) memchr (p, '\n', end - p);
+	  if (nl == NULL)
+	    return;
+	  p = nl + 1;
+	}
+
+      void **slot = htab_find_slot_with_hash (cache->listings, name,
+					      htab_hash_string (name), INSERT);
+      if (*slot)
+	continue;
+
+      struct dir_listing *l = XOBNEW (&cache->ob, struct dir_listing);
+      memset (l, 0, sizeof (*l));
+      l->name = name;
+      l->mtime = mtime;
+      l->ino = ino;
+      l->count = count;
+      l->entries_text = entries_text;
+      l->record = record;
+      l->record_end = p;
+      *slot = l;
+    }
+}
+
+/* Return the include cache for PFILE, reading the cache file the first
+   time, or NULL if the cache is not enabled.  */
+
+static struct include_cache *
+get_include_cache (cpp_reader *pfile)
+{
+  const char *fname = CPP_OPTION (pfile, include_cache);
+  struct include_cache *cache = pfile->include_cache;
+
+  if (cache || !fname)
+    return cache;
+
+  cache = XCNEW (struct include_cache);
+  cache->listings = htab_create_alloc (127, dir_listing_hash, dir_listing_eq,
+				       NULL, xcalloc, free);
+  obstack_specify_allocation (&cache->ob, 0, 0, xmalloc, free);
+  pfile->include_cache = cache;
+
+  int fd = open (fname, O_RDONLY | O_BINARY);
+  struct stat st;
+  if (fd == -1)
+    return cache;
+  if (fstat (fd, &st) == 0 && S_ISREG (st.st_mode) && st.st_size > 0)
+    {
+      size_t len = st.st_size;
+      cache->buffer = XNEWVEC (char, len + 1);
+      if (read (fd, cache->buffer, len) == (ssize_t) len)
+	{
+	  cache->buffer[len] = '\0';
+	  parse_include_cache (cache, len);
+	}
+    }
+  close (fd);
+  return cache;
+}
+
+/* Make the entries of L read from the cache file usable.  Return false
+   if they are not in order, i.e. the file was tampered with.  */
+
+static bool
+activate_dir_listing (struct include_cache *cache, struct dir_listing *l)
+{
+  char *p = l->entries_text;
+
+  l->entries = XOBNEWVEC (&cache->ob, const char *, l->count);
+  for (unsigned int i = 0; i < l->count; i++)
+    {
+      char *nl = strchr (p, '\n');
+      *nl = '\0';
+      l->entries[i] = p;
+      p = nl + 1;
+      if (i && dir_entry_compare (&l->entries[i - 1], &l->entries[i]) > 0)
+	return false;
+    }
+  return true;
+}
+
+/* Read the directory NAME, whose stat information is ST, into L.  */
+
+static void
+read_dir_listing (struct include_cache *cache, struct dir_listing *l,
+		  const char *name, const struct stat *st)
+{
+  DIR *dir = opendir (name);
+  struct dirent *d;
+  unsigned int count = 0, alloc = 0;
+  const char **entries = NULL;
+
+  l->mtime = st->st_mtime;
+  l->ino = st->st_ino;
+  l->record = NULL;
+  /* A directory modified in the last couple of seconds might be
+     modified again without its modification time changing.  */
+  l->persist = (dir != NULL
+		&& (time_t) st->st_mtime + 2 < time (NULL)
+		&& !strchr (name, '\n'));
+
+  if (dir)
+    {
+      while ((d = readdir (dir)) != NULL)
+	{
+	  if (!strcmp (d->d_name, ".") || !strcmp (d->d_name, ".."))
+	    continue;
+	  if (strchr (d->d_name, '\n'))
+	    l->persist = false;
+	  if (count == alloc)
+	    {
+	      alloc = alloc * 2 + 16;
+	      entries = XRESIZEVEC (const char *, entries, alloc);
+	    }
+	  entries[count++] = (const char *)
+	    obstack_copy0 (&cache->ob, d->d_name, strlen (d->d_name));
+	}
+      closedir (dir);
+    }
+
+  qsort (entries, count, sizeof (const char *), dir_entry_compare);
+  l->count = count;
+  l->entries = (const char **)
+    obstack_copy (&cache->ob, entries, count * sizeof (const char *));
+  free (entries);
+
+  if (l->persist)
+    cache->dirty = true;
+}
+
+/* Return the listing of DIR, or NULL if it is not known.  */
+
+static struct dir_listing *
+get_dir_listing (cpp_reader *pfile, cpp_dir *dir)
+{
+  struct include_cache *cache = get_include_cache (pfile);
+  const char *name = dir->name[0] ? dir->name : ".";
+  struct stat st;
+
+  if (!cache)
+    return NULL;
+
+  void **slot = htab_find_slot_with_hash (cache->listings, name,
+					  htab_hash_string (name), INSERT);
+  struct dir_listing *l = (struct dir_listing *) *slot;
+  if (l && l->checked)
+    return l;
+
+  if (!l)
+    {
+      l = XOBNEW (&cache->ob, struct dir_listing);
+      memset (l, 0, sizeof (*l));
+      l->name = (const char *) obstack_copy0 (&cache->ob, name,
+					      strlen (name));
+      *slot = l;
+    }
+  l->checked = true;
+
+  if (stat (name, &st) != 0 || !S_ISDIR (st.st_mode))
+    {
+      /* Nothing can be found in a directory that does not exist.  */
+      cache->dirty |= l->record != NULL;
+      l->count = 0;
+      l->entries = NULL;
+      l->record = NULL;
+      l->persist = false;
+      return l;
+    }
+
+  if (l->record
+      && l->mtime == (unsigned long) st.st_mtime
+      && l->ino == (unsigned long) st.st_ino
+      && activate_dir_listing (cache, l))
+    {
+      l->persist = true;
+      return l;
+    }
+
+  if (l->record)
+    cache->dirty = true;
+  read_dir_listing (cache, l, name, &st);
+  return l;
+}
+
+/* Return false if FILE->name certainly does not exist in FILE->dir,
+   according to the include cache.  */
+
+static bool
+dir_may_contain_file (cpp_reader *pfile, _cpp_file *file)
+{
+  const char *fname = file->name;
+
+  if (CPP_OPTION (pfile, remap)
+      || file->dir->construct
+      || file->dir == &pfile->no_search_path
+      || IS_ABSOLUTE_PATH (fname))
+    return true;
+
+  /* Only the first component of the name is looked up.  */
+  size_t len = 0;
+  while (fname[len] && !IS_DIR_SEPARATOR (fname[len]))
+    len++;
+  if ((len == 1 && fname[0] == '.')
+      || (len == 2 && fname[0] == '.' && fname[1] == '.'))
+    return true;
+
+  struct dir_listing *l = get_dir_listing (pfile, file->dir);
+  if (!l)
+    return true;
+
+  char *component = XALLOCAVEC (char, len + sizeof (".gch"));
+  memcpy (component, fname, len);
+  component[len] = '\0';
+  if (bsearch (&component, l->entries, l->count, sizeof (const char *),
+	       dir_entry_compare))
+    return true;
+
+  /* pch_open_file looks for FNAME.gch next to FNAME.  */
+  if (fname[len] == '\0')
+    {
+      memcpy (component + len, ".gch", sizeof (".gch"));
+      if (bsearch (&component, l->entries, l->count, sizeof (const char *),
+		   dir_entry_compare))
+	return true;
+    }
+
+  return false;
+}
+
+/* Callback function for htab_traverse.  Write the listing in *SLOT to
+   the FILE pointed to by F if it is to be kept.  */
+
+static int
+write_dir_listing (void **slot, void *f)
+{
+  struct dir_listing *l = (struct dir_listing *) *slot;
+  FILE *out = *(FILE **) f;
+
+  if (!l->checked && l->record)
+    fwrite (l->record, l->record_end - l->record, 1, out);
+  else if (l->checked && l->persist)
+    {
+      fprintf (out, "%lu %lu %u %s\n", l->mtime, l->ino, l->count, l->name);
+      for (unsigned int i = 0; i < l->count; i++)
+	fprintf (out, "%s\n", l->entries[i]);
+    }
+  return 1;
+}
+
+/* Write out the include cache if anything changed, and free it.  */
+
+void
+_cpp_save_include_cache (cpp_reader *pfile)
+{
+  struct include_cache *cache = pfile->include_cache;
+  const char *fname = CPP_OPTION (pfile, include_cache);
+
+  if (!cache)
+    return;
+
+  if (cache->dirty)
+    {
+      /* Write to a temporary file and rename it, so that concurrent
+	 compilations never see a partially written cache.  */
+      char *tmpname = XNEWVEC (char, strlen (fname) + 32);
+      sprintf (tmpname, "%s.%ld.tmp", fname, (long) getpid ());
+
+      FILE *f = fopen (tmpname, "wb");
+      bool ok = f != NULL;
+      if (ok)
+	{
+	  fputs (INCLUDE_CACHE_MAGIC, f);
+	  htab_traverse (cache->listings, write_dir_listing, &f);
+	}
+      if (f && (ferror (f) | fclose (f)) != 0)
+	ok = false;
+      if (!ok || rename (tmpname, fname) != 0)
+	{
+	  cpp_errno_filename (pfile, CPP_DL_WARNING, fname, 0);
+	  unlink (tmpname);
+	}
+      free (tmpname);
+    }
+
+  htab_delete (cache->listings);
+  obstack_free (&cache->ob, 0);
+  free (cache->buffer);
+  free (cache);
+  pfile->include_cache = NULL;
+}
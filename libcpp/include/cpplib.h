@@ -296,6 +296,9 @@ typedef CPPCHAR_SIGNED_T cppchar_signed_t;
 /* Style of header dependencies to generate.  */
 enum cpp_deps_style { DEPS_NONE = 0, DEPS_USER, DEPS_SYSTEM };
 
+/* Format of module dependencies to generate.  */
+enum cpp_fdeps_format { FDEPS_FMT_NONE = 0, FDEPS_FMT_P1689R5 };
+
 /* The possible normalization levels, from most restrictive to least.  */
 enum cpp_normalize_level {
   /* In NFKC.  */
@@ -553,6 +556,10 @@ struct cpp_options
     /* If true, intend to use the preprocessor output (e.g., for compilation)
        in addition to the dependency info.  */
     bool need_preprocessor_output;
+
+    /* Format of module dependencies to generate, for a build system
+       scanning sources before compiling them.  */
+    enum cpp_fdeps_format fdeps_format;
   } deps;
 
   /* Target-specific features set by the front end or client.  */
@@ -580,6 +587,10 @@ struct cpp_options
   /* The maximum depth of the nested #include.  */
   unsigned int max_include_depth;
 
+  /* If non-NULL, the file in which to cache the contents of include
+     directories across invocations.  */
+  const char *include_cache;
+
   cpp_main_search main_search : 8;
 };
 
@@ -836,6 +847,11 @@ struct GTY(()) cpp_macro {
 
   /* 0 bits spare (32-bit). 32 on 64-bit target.  */
 
+  /* For an object-like macro expanded with -ftrack-macro-expansion,
+     the MACRO_MAP_LOCATIONS of the macro map of its first expansion,
+     which later expansions share.  */
+  location_t * GTY((atomic)) expansion_locs;
+
   union cpp_exp_u
   {
     /* Trailing array of replacement tokens (ISO), or assertion body value.  */
@@ -1048,8 +1064,11 @@ extern void cpp_init_iconv (cpp_reader *);
 
 /* Call this to finish preprocessing.  If you requested dependency
    generation, pass an open stream to write the information to,
-   otherwise NULL.  It is your responsibility to close the stream.  */
-extern void cpp_finish (cpp_reader *, FILE *deps_stream);
+   otherwise NULL.  Likewise for module dependencies in the
+   deps.fdeps_format format.  It is your responsibility to close the
+   streams.  */
+extern void cpp_finish (cpp_reader *, FILE *deps_stream,
+			FILE *fdeps_stream = NULL);
 
 /* Call this to release the handle at the end of preprocessing.  Any
    use of the handle after this function returns is invalid.  */
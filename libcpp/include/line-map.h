@@ -1123,6 +1123,14 @@ extern const line_map *linemap_add
 const line_map_macro *linemap_enter_macro (line_maps *, cpp_hashnode *,
 					   location_t, unsigned int);
 
+/* Like linemap_enter_macro, but make the new map use LOCATIONS, the
+   MACRO_MAP_LOCATIONS of an earlier map for an expansion of the same
+   object-like macro definition, instead of a copy of its own.  */
+const line_map_macro *linemap_enter_macro_shared (line_maps *,
+						  cpp_hashnode *,
+						  location_t, unsigned int,
+						  location_t *);
+
 /* Create a source location for a module.  The creator must either do
    this after the TU is tokenized, or deal with saving and restoring
    map state.  */
@@ -838,7 +838,7 @@ read_original_directory (cpp_reader *pfile)
    Maybe it should also reset state, such that you could call
    cpp_start_read with a new filename to restart processing.  */
 void
-cpp_finish (cpp_reader *pfile, FILE *deps_stream)
+cpp_finish (cpp_reader *pfile, FILE *deps_stream, FILE *fdeps_stream)
 {
   /* Warn about unused macros before popping the final buffer.  */
   if (CPP_OPTION (pfile, warn_unused_macros))
@@ -855,6 +855,11 @@ cpp_finish (cpp_reader *pfile, FILE *deps_stream)
   if (deps_stream)
     deps_write (pfile, deps_stream, 72);
 
+  if (fdeps_stream)
+    fdeps_write (pfile, fdeps_stream);
+
+  _cpp_save_include_cache (pfile);
+
   /* Report on headers that could use multiple include guards.  */
   if (CPP_OPTION (pfile, print_include_names))
     _cpp_report_missing_guards (pfile);
@@ -910,6 +910,136 @@ search_line_fast (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
   return (const uchar *)p + found;
 }
 
+#elif defined (__riscv) && defined (__GNUC__) \
+      && (defined (__riscv_zbb) || defined (__riscv_vector))
+
+#if defined (__riscv_vector) && defined (__linux__)
+#include <sys/auxv.h>
+#endif
+
+#ifdef __riscv_zbb
+/* Return VAL with each nonzero byte set to 0xff, using the Zbb ORC.B
+   instruction.  */
+
+static inline word_type
+riscv_orc_b (word_type val)
+{
+  word_type ret;
+  __asm__ ("orc.b\t%0,%1" : "=r" (ret) : "r" (val));
+  return ret;
+}
+
+/* A version of the word-at-a-time scanner that uses ORC.B to find the
+   matching bytes exactly, saving the false-positive check and the
+   byte-by-byte search of search_line_acc_char.  */
+
+static const uchar *
+search_line_zbb (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
+{
+  const word_type repl_nl = acc_char_replicate ('\n');
+  const word_type repl_cr = acc_char_replicate ('\r');
+  const word_type repl_bs = acc_char_replicate ('\\');
+  const word_type repl_qm = acc_char_replicate ('?');
+
+  unsigned int misalign;
+  const word_type *p;
+  word_type val, t;
+
+  /* Align the buffer.  Mask out any bytes from before the beginning.  */
+  p = (word_type *)((uintptr_t)s & -sizeof(word_type));
+  val = *p;
+  misalign = (uintptr_t)s & (sizeof(word_type) - 1);
+  if (misalign)
+    val = acc_char_mask_misalign (val, misalign);
+
+  /* Main loop.  A byte of T is zero iff the byte of VAL is one of the
+     interesting characters.  */
+  while (1)
+    {
+      t  = riscv_orc_b (val ^ repl_nl);
+      t &= riscv_orc_b (val ^ repl_cr);
+      t &= riscv_orc_b (val ^ repl_bs);
+      t &= riscv_orc_b (val ^ repl_qm);
+
+      if (__builtin_expect (t != (word_type) -1, 0))
+	{
+	  unsigned long long found = ~t;
+	  if (sizeof(word_type) == 4)
+	    found &= 0xffffffffU;
+
+	  if (WORDS_BIGENDIAN)
+	    return ((const uchar *)p
+		    + (__builtin_clzll (found)
+		       - (64 - sizeof(word_type) * 8)) / 8);
+	  return (const uchar *)p + __builtin_ctzll (found) / 8;
+	}
+
+      val = *++p;
+    }
+}
+#endif
+
+#ifdef __riscv_vector
+/* A version of the fast scanner using the RISC-V vector extension.  Each
+   iteration compares as many bytes as the vector unit can handle, never
+   reading beyond END, which is the terminating newline.  */
+
+static const uchar *
+search_line_rvv (const uchar *s, const uchar *end)
+{
+  while (1)
+    {
+      unsigned long vl;
+      long found;
+
+      __asm__ ("vsetvli\t%0,%2,e8,m1,ta,ma\n\t"
+	       "vle8.v\tv8,(%3)\n\t"
+	       "vmseq.vx\tv0,v8,%4\n\t"
+	       "vmseq.vx\tv9,v8,%5\n\t"
+	       "vmor.mm\tv0,v0,v9\n\t"
+	       "vmseq.vx\tv9,v8,%6\n\t"
+	       "vmor.mm\tv0,v0,v9\n\t"
+	       "vmseq.vx\tv9,v8,%7\n\t"
+	       "vmor.mm\tv0,v0,v9\n\t"
+	       "vfirst.m\t%1,v0"
+	       : "=&r" (vl), "=r" (found)
+	       : "r" (end - s + 1), "r" (s),
+		 "r" ('\n'), "r" ('\r'), "r" ('\\'), "r" ('?'),
+		 "m" (*(const uchar (*)[]) s)
+	       : "v0", "v8", "v9");
+
+      if (found >= 0)
+	return s + found;
+      s += vl;
+    }
+}
+#endif
+
+typedef const uchar * (*search_line_fast_type) (const uchar *, const uchar *);
+static search_line_fast_type search_line_fast;
+
+#define HAVE_init_vectorized_lexer 1
+static inline void
+init_vectorized_lexer (void)
+{
+  search_line_fast_type impl = search_line_acc_char;
+
+#ifdef __riscv_zbb
+  impl = search_line_zbb;
+#endif
+
+#ifdef __riscv_vector
+  /* The kernel reports in AT_HWCAP whether it lets user code use the
+     vector unit.  */
+#ifdef __linux__
+  if (getauxval (AT_HWCAP) & (1UL << ('V' - 'A')))
+#endif
+    impl = search_line_rvv;
+#endif
+
+  search_line_fast = impl;
+}
+
 #else
 
 /* We only have one accelerated alternative.  Use a direct call so that
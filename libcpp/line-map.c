@@ -684,6 +684,25 @@ linemap_tracks_macro_expansion_locs_p (line_maps *set)
 const line_map_macro *
 linemap_enter_macro (class line_maps *set, struct cpp_hashnode *macro_node,
 		     location_t expansion, unsigned int num_tokens)
+{
+  return linemap_enter_macro_shared (set, macro_node, expansion, num_tokens,
+				     NULL);
+}
+
+/* Like linemap_enter_macro, but if LOCATIONS is non-NULL, use it as
+   the MACRO_MAP_LOCATIONS of the new map.  LOCATIONS must come from an
+   earlier map created for an expansion of the same definition of an
+   object-like macro: the locations of the tokens of such a macro do
+   not depend on the expansion point, so every expansion can share one
+   array instead of allocating 2 * NUM_TOKENS locations of its own.
+   The caller still has to call linemap_add_macro_token for each token,
+   which stores the same values again.  */
+
+const line_map_macro *
+linemap_enter_macro_shared (class line_maps *set,
+			    struct cpp_hashnode *macro_node,
+			    location_t expansion, unsigned int num_tokens,
+			    location_t *locations)
 {
   location_t start_location
     = LINEMAPS_MACRO_LOWEST_LOCATION (set) - num_tokens;
@@ -696,13 +715,18 @@ linemap_enter_macro (class line_maps *set, struct cpp_hashnode *macro_node,
 
   map->macro = macro_node;
   map->n_tokens = num_tokens;
-  map->macro_locations
-    = (location_t*) set->reallocator (NULL,
-					   2 * num_tokens
-					   * sizeof (location_t));
   map->expansion = expansion;
-  memset (MACRO_MAP_LOCATIONS (map), 0,
-	  2 * num_tokens * sizeof (location_t));
+  if (locations)
+    map->macro_locations = locations;
+  else
+    {
+      map->macro_locations
+	= (location_t*) set->reallocator (NULL,
+					  2 * num_tokens
+					  * sizeof (location_t));
+      memset (MACRO_MAP_LOCATIONS (map), 0,
+	      2 * num_tokens * sizeof (location_t));
+    }
 
   LINEMAPS_MACRO_CACHE (set) = LINEMAPS_MACRO_USED (set) - 1;
 
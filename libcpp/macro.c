@@ -1484,9 +1484,14 @@ enter_macro_context (cpp_reader *pfile, cpp_hashnode *node,
 
 	      /* Create a macro map to record the locations of the
 		 tokens that are involved in the expansion. LOCATION
-		 is the location of the macro expansion point.  */
-	      map = linemap_enter_macro (pfile->line_table,
-					 node, location, tokens_count);
+		 is the location of the macro expansion point.  The
+		 locations of the tokens are the same for every
+		 expansion of this definition, so share them.  */
+	      map = linemap_enter_macro_shared (pfile->line_table,
+						node, location, tokens_count,
+						macro->expansion_locs);
+	      if (map && tokens_count)
+		macro->expansion_locs = MACRO_MAP_LOCATIONS (map);
 	      for (i = 0; i < tokens_count; ++i)
 		{
 		  tokens_buff_add_token (macro_tokens, virt_locs,
@@ -81,7 +81,8 @@ public:
   };
 
   mkdeps ()
-    : module_name (NULL), cmi_name (NULL), is_header_unit (false), quote_lwm (0)
+    : module_name (NULL), cmi_name (NULL), is_header_unit (false),
+      is_interface (false), quote_lwm (0)
   {
   }
   ~mkdeps ()
@@ -110,6 +111,7 @@ public:
   const char *module_name;
   const char *cmi_name;
   bool is_header_unit;
+  bool is_interface;
   unsigned short quote_lwm;
 };
 
@@ -325,12 +327,14 @@ deps_add_vpath (class mkdeps *d, const char *vpath)
 
 void
 deps_add_module_target (struct mkdeps *d, const char *m,
-			const char *cmi, bool is_header_unit)
+			const char *cmi, bool is_header_unit,
+			bool is_interface)
 {
   gcc_assert (!d->module_name);
   
   d->module_name = xstrdup (m);
   d->is_header_unit = is_header_unit;
+  d->is_interface = is_interface;
   d->cmi_name = xstrdup (cmi);
 }
 
@@ -473,6 +477,81 @@ deps_write (const cpp_reader *pfile, FILE *fp, unsigned int colmax)
   make_write (pfile, fp, colmax);
 }
 
+/* Write STR to FP as a JSON string.  */
+
+static void
+p1689r5_write_string (const char *str, FILE *fp)
+{
+  fputc ('"', fp);
+  for (const unsigned char *c = (const unsigned char *) str; *c; c++)
+    {
+      if (*c == '"' || *c == '\\')
+	fprintf (fp, "\\%c", *c);
+      else if (*c < 0x20)
+	fprintf (fp, "\\u%04x", *c);
+      else
+	fputc (*c, fp);
+    }
+  fputc ('"', fp);
+}
+
+/* Write the module dependencies as a P1689R5 rule, the format build
+   systems use to order the compilation of C++ modules.  */
+
+static void
+p1689r5_write (const mkdeps *d, FILE *fp)
+{
+  fputs ("{\n\"rules\": [\n{\n", fp);
+  if (d->targets.size ())
+    {
+      fputs ("\"primary-output\": ", fp);
+      p1689r5_write_string (d->targets[0], fp);
+      fputs (",\n", fp);
+    }
+
+  if (d->module_name)
+    {
+      fputs ("\"provides\": [\n{\n\"logical-name\": ", fp);
+      p1689r5_write_string (d->module_name, fp);
+      fputs (",\n", fp);
+      if (d->cmi_name)
+	{
+	  fputs ("\"compiled-module-path\": ", fp);
+	  p1689r5_write_string (d->cmi_name, fp);
+	  fputs (",\n", fp);
+	}
+      fprintf (fp, "\"is-interface\": %s\n}\n],\n",
+	       d->is_interface ? "true" : "false");
+    }
+
+  fputs ("\"requires\": [", fp);
+  for (unsigned ix = 0; ix != d->modules.size (); ix++)
+    {
+      fputs (ix ? ",\n{\n\"logical-name\": " : "\n{\n\"logical-name\": ",
+	     fp);
+      p1689r5_write_string (d->modules[ix], fp);
+      fputs ("\n}", fp);
+    }
+  fputs ("\n]\n}\n],\n\"version\": 0,\n\"revision\": 0\n}\n", fp);
+}
+
+/* Write out the module dependencies in the format selected by
+   -fdeps-format.  */
+
+void
+fdeps_write (const cpp_reader *pfile, FILE *fp)
+{
+  switch (CPP_OPTION (pfile, deps.fdeps_format))
+    {
+    case FDEPS_FMT_P1689R5:
+      p1689r5_write (pfile->deps, fp);
+      break;
+
+    case FDEPS_FMT_NONE:
+      break;
+    }
+}
+
 /* Write out a deps buffer to a file, in a form that can be read back
    with deps_restore.  Returns nonzero on error, in which case the
    error number will be in errno.  */
@@ -169,7 +169,10 @@ ht_lookup_with_hash (cpp_hash_table *table, const unsigned char *str,
     HT_STR (node) = (const unsigned char *) obstack_copy0 (&table->stack,
 							   str, len);
 
-  if (++table->nelements * 4 >= table->nslots * 3)
+  /* Keep the table at most half full.  Each probe past the first
+     slot loads another node to compare its hash, so collisions are
+     much more expensive than the slots themselves.  */
+  if (++table->nelements * 2 >= table->nslots)
     /* Must expand the string table.  */
     ht_expand (table);
 
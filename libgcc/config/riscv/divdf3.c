@@ -0,0 +1,48 @@
+/* Double-precision division for RISC-V without a double-precision FPU.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+#ifdef __riscv_flen
+/* The FPU's rounding mode and exception flags apply; just use the
+   generic code.  */
+#include "soft-fp/divdf3.c"
+#else
+#pragma GCC visibility push(hidden)
+#define __divdf3 __divdf3_generic
+#include "soft-fp/divdf3.c"
+#undef __divdf3
+#pragma GCC visibility pop
+
+#include "soft-df.h"
+
+DFtype
+__divdf3 (DFtype a, DFtype b)
+{
+  fast_df x = { a }, y = { b }, r;
+
+  if (__builtin_expect (fast_divdf3 (x.i, y.i, &r.i), 1))
+    return r.f;
+  return __divdf3_generic (a, b);
+}
+#endif
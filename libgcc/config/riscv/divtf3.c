@@ -0,0 +1,47 @@
+/* Quad-precision division for RV64.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+#pragma GCC visibility push(hidden)
+#define __divtf3 __divtf3_generic
+#include "soft-fp/divtf3.c"
+#undef __divtf3
+#pragma GCC visibility pop
+
+#include "soft-tf.h"
+
+TFtype
+__divtf3 (TFtype a, TFtype b)
+{
+  fast_tf x = { a }, y = { b }, r;
+  int res;
+
+  if (fast_tf_nearest ()
+      && __builtin_expect ((res = fast_divtf3 (x.i, y.i, &r.i)) != 0, 1))
+    {
+      fast_tf_raise (res);
+      return r.f;
+    }
+  return __divtf3_generic (a, b);
+}
@@ -0,0 +1,52 @@
+/* Double-precision comparison for RISC-V without a double-precision FPU.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+#ifdef __riscv_flen
+/* The FPU's exception flags apply; just use the generic code.  */
+#include "soft-fp/gedf2.c"
+#else
+#pragma GCC visibility push(hidden)
+#define __gedf2 __gedf2_generic
+#define __gtdf2 __gtdf2_generic
+#include "soft-fp/gedf2.c"
+#undef __gedf2
+#undef __gtdf2
+#pragma GCC visibility pop
+
+#include "soft-df.h"
+
+CMPtype
+__gedf2 (DFtype a, DFtype b)
+{
+  fast_df x = { a }, y = { b };
+  CMPtype r;
+
+  if (__builtin_expect (fast_cmpdf2 (x.i, y.i, &r), 1))
+    return r;
+  return __gedf2_generic (a, b);
+}
+
+strong_alias (__gedf2, __gtdf2);
+#endif
@@ -0,0 +1,281 @@
+/* Fast paths for double-precision soft-float on RISC-V.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+/* Without an FPU the soft-fp routines always round to nearest, ties
+   to even, and have nowhere to record exceptions.  When the operands
+   are normal numbers and so is the result, none of their operand
+   classification, NaN and infinity handling or denormalization is
+   needed, and the rounded result can be computed directly on the
+   significands.  Each function below does that and returns nonzero,
+   or returns zero without storing anything if the operands or the
+   result need the general code.  The results are bit-for-bit those
+   of soft-fp.
+
+   This file is included after one of the soft-fp sources, which
+   provides DFtype, the integer types and udiv_qrnnd.  */
+
+typedef union
+{
+  DFtype f;
+  UDItype i;
+} fast_df;
+
+#define FAST_DF_SIGN		((UDItype) 1 << 63)
+#define FAST_DF_IMPLICIT	((UDItype) 1 << 52)
+#define FAST_DF_FRAC		(FAST_DF_IMPLICIT - 1)
+#define FAST_DF_EXP_MAX		0x7ff
+#define FAST_DF_EXP_BIAS	1023
+#define FAST_DF_INF		((UDItype) FAST_DF_EXP_MAX << 52)
+
+/* The biased exponent of X.  */
+#define FAST_DF_EXP(x)		((int) ((x) >> 52) & FAST_DF_EXP_MAX)
+
+/* Nonzero if the biased exponent E is that of a normal number.  */
+#define FAST_DF_NORMAL_EXP(e)	((unsigned int) (e) - 1 < FAST_DF_EXP_MAX - 1)
+
+/* Round the significand M, which has its implicit bit at bit 55 and
+   two guard bits and a sticky bit below the 53 bits of the result,
+   and pack it with SIGN and the biased exponent E into *R.  */
+
+static inline int
+fast_df_round_pack (UDItype sign, int e, UDItype m, UDItype *r)
+{
+  unsigned int low = m & 7;
+
+  m >>= 3;
+  if (low > 4 || (low == 4 && (m & 1)))
+    if (++m == FAST_DF_IMPLICIT << 1)
+      {
+	m >>= 1;
+	e++;
+      }
+  if (e >= FAST_DF_EXP_MAX)
+    return 0;
+  *r = sign | ((UDItype) e << 52) | (m & FAST_DF_FRAC);
+  return 1;
+}
+
+/* A + B.  */
+
+static inline int
+fast_adddf3 (UDItype a, UDItype b, UDItype *r)
+{
+  int ea = FAST_DF_EXP (a), eb = FAST_DF_EXP (b), d;
+  UDItype ma, mb, m;
+
+  if (!FAST_DF_NORMAL_EXP (ea) || !FAST_DF_NORMAL_EXP (eb))
+    return 0;
+
+  /* Make A the operand with the larger magnitude.  */
+  if ((a & ~FAST_DF_SIGN) < (b & ~FAST_DF_SIGN))
+    {
+      m = a, a = b, b = m;
+      d = ea, ea = eb, eb = d;
+    }
+
+  ma = ((a & FAST_DF_FRAC) | FAST_DF_IMPLICIT) << 3;
+  mb = ((b & FAST_DF_FRAC) | FAST_DF_IMPLICIT) << 3;
+
+  /* Align B, folding the bits shifted out into the sticky bit.  Once
+     B is entirely below the sticky bit it cannot affect rounding.  */
+  d = ea - eb;
+  if (d > 56)
+    mb = 1;
+  else if (d != 0)
+    mb = (mb >> d) | ((mb << (64 - d)) != 0);
+
+  if (((a ^ b) & FAST_DF_SIGN) == 0)
+    {
+      m = ma + mb;
+      if (m >> 56)
+	{
+	  m = (m >> 1) | (m & 1);
+	  ea++;
+	}
+    }
+  else
+    {
+      m = ma - mb;
+      if (m == 0)
+	{
+	  *r = 0;
+	  return 1;
+	}
+      /* The subtraction can only cancel more than one bit when B was
+	 not shifted by more than one, and so lost no bits.  */
+      if (m < FAST_DF_IMPLICIT << 3)
+	{
+	  int shift = __builtin_clzll (m) - 8;
+
+	  m <<= shift;
+	  ea -= shift;
+	  if (ea <= 0)
+	    return 0;
+	}
+    }
+
+  return fast_df_round_pack (a & FAST_DF_SIGN, ea, m, r);
+}
+
+/* A * B.  */
+
+static inline int
+fast_muldf3 (UDItype a, UDItype b, UDItype *r)
+{
+  int ea = FAST_DF_EXP (a), eb = FAST_DF_EXP (b), e;
+  UDItype ma, mb, ll, mid, hi, lo, m;
+  USItype al, ah, bl, bh;
+
+  if (!FAST_DF_NORMAL_EXP (ea) || !FAST_DF_NORMAL_EXP (eb))
+    return 0;
+
+  ma = (a & FAST_DF_FRAC) | FAST_DF_IMPLICIT;
+  mb = (b & FAST_DF_FRAC) | FAST_DF_IMPLICIT;
+
+  /* The 106-bit product, from four 32x32->64 multiplications.  */
+  al = ma, ah = ma >> 32;
+  bl = mb, bh = mb >> 32;
+  ll = (UDItype) al * bl;
+  mid = (UDItype) al * bh + (UDItype) ah * bl + (ll >> 32);
+  hi = (UDItype) ah * bh + (mid >> 32);
+  lo = (mid << 32) | (USItype) ll;
+
+  /* Keep the top 56 bits, with everything below in the sticky bit.  */
+  e = ea + eb - FAST_DF_EXP_BIAS;
+  if (hi >> 41)
+    {
+      m = (hi << 14) | (lo >> 50) | ((lo << 14) != 0);
+      e++;
+    }
+  else
+    m = (hi << 15) | (lo >> 49) | ((lo << 15) != 0);
+
+  if (!FAST_DF_NORMAL_EXP (e))
+    return 0;
+  return fast_df_round_pack ((a ^ b) & FAST_DF_SIGN, e, m, r);
+}
+
+/* Divide the remainder *REM by the normalized divisor D and return
+   the next 32 bits of the quotient, leaving the new remainder in *REM.
+   *REM must be less than D.  The quotient digit is estimated from the
+   high word of D with a single hardware division and is then at most
+   two too large.  */
+
+static inline USItype
+fast_df_div_step (UDItype *rem, UDItype d)
+{
+  USItype d1 = d >> 32, d0 = d, r1 = *rem >> 32, r0 = *rem;
+  USItype q, rh;
+  UDItype p, t;
+
+  if (r1 == d1)
+    {
+      q = 0xffffffff;
+      p = (UDItype) q * d0;
+      t = (UDItype) r0 + d1;
+      if (t >> 32)
+	{
+	  *rem = (t << 32) - p;
+	  return q;
+	}
+      t <<= 32;
+    }
+  else
+    {
+#if _FP_W_TYPE_SIZE == 32
+      udiv_qrnnd (q, rh, r1, r0, d1);
+#else
+      t = ((UDItype) r1 << 32) | r0;
+      q = t / d1;
+      rh = t % d1;
+#endif
+      p = (UDItype) q * d0;
+      t = (UDItype) rh << 32;
+    }
+
+  if (t < p)
+    {
+      p -= t;
+      q--;
+      if (p > d)
+	{
+	  p -= d;
+	  q--;
+	}
+      *rem = d - p;
+    }
+  else
+    *rem = t - p;
+  return q;
+}
+
+/* A / B.  */
+
+static inline int
+fast_divdf3 (UDItype a, UDItype b, UDItype *r)
+{
+  int ea = FAST_DF_EXP (a), eb = FAST_DF_EXP (b), e;
+  UDItype ma, mb, rem, q;
+
+  if (!FAST_DF_NORMAL_EXP (ea) || !FAST_DF_NORMAL_EXP (eb))
+    return 0;
+
+  ma = (a & FAST_DF_FRAC) | FAST_DF_IMPLICIT;
+  mb = (b & FAST_DF_FRAC) | FAST_DF_IMPLICIT;
+  e = ea - eb + FAST_DF_EXP_BIAS;
+  if (ma < mb)
+    {
+      ma <<= 1;
+      e--;
+    }
+  if (!FAST_DF_NORMAL_EXP (e))
+    return 0;
+
+  /* With MA in [MB, 2 * MB), MA * 2**64 / (MB << 11) has 54 bits:
+     the result and one guard bit.  */
+  rem = ma;
+  q = (UDItype) fast_df_div_step (&rem, mb << 11) << 32;
+  q |= fast_df_div_step (&rem, mb << 11);
+
+  return fast_df_round_pack ((a ^ b) & FAST_DF_SIGN, e,
+			     (q << 2) | (rem != 0), r);
+}
+
+/* Compare A and B, storing -1, 0 or 1 in *R.  */
+
+static inline int
+fast_cmpdf2 (UDItype a, UDItype b, CMPtype *r)
+{
+  if ((a & ~FAST_DF_SIGN) > FAST_DF_INF || (b & ~FAST_DF_SIGN) > FAST_DF_INF)
+    return 0;
+
+  if (a == b || ((a | b) << 1) == 0)
+    *r = 0;
+  else if ((a ^ b) & FAST_DF_SIGN)
+    *r = (a & FAST_DF_SIGN) ? -1 : 1;
+  else
+    *r = ((a < b) ^ ((a & FAST_DF_SIGN) != 0)) ? -1 : 1;
+  return 1;
+}
@@ -0,0 +1,311 @@
+/* Fast paths for quad-precision soft-float on RV64.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+/* As for DFmode in soft-df.h: when the operands and the result are
+   normal numbers and the rounding mode is to nearest, the rounded
+   result can be computed directly on the 113-bit significands, held
+   in a UTItype.  The only exception such a result can raise is
+   inexact, which the FPU, if there is one, is told about here.
+
+   Each function below returns FAST_TF_EXACT or FAST_TF_INEXACT after
+   storing the result, or zero without storing anything if the
+   operands or the result need the general code.  The results are
+   bit-for-bit those of soft-fp.
+
+   This file is included after one of the soft-fp sources, which
+   provides TFtype and the integer types.  */
+
+typedef union
+{
+  TFtype f;
+  UTItype i;
+} fast_tf;
+
+#define FAST_TF_EXACT		1
+#define FAST_TF_INEXACT		2
+
+#define FAST_TF_SIGN		((UTItype) 1 << 127)
+#define FAST_TF_IMPLICIT	((UTItype) 1 << 112)
+#define FAST_TF_FRAC		(FAST_TF_IMPLICIT - 1)
+#define FAST_TF_EXP_MAX		0x7fff
+#define FAST_TF_EXP_BIAS	16383
+
+/* The biased exponent of X.  */
+#define FAST_TF_EXP(x)		((int) ((x) >> 112) & FAST_TF_EXP_MAX)
+
+/* Nonzero if the biased exponent E is that of a normal number.  */
+#define FAST_TF_NORMAL_EXP(e)	((unsigned int) (e) - 1 < FAST_TF_EXP_MAX - 1)
+
+#ifdef __riscv_flen
+/* Nonzero if the dynamic rounding mode is to nearest.  */
+
+static inline int
+fast_tf_nearest (void)
+{
+  int frm;
+
+  __asm__ volatile ("frrm %0" : "=r" (frm));
+  return frm == FP_RND_NEAREST;
+}
+
+/* Record the exception raised by a fast path that returned RES.  */
+
+static inline void
+fast_tf_raise (int res)
+{
+  if (res == FAST_TF_INEXACT)
+    __asm__ volatile ("csrs fflags, %0" : : "rK" (FP_EX_INEXACT));
+}
+#else
+#define fast_tf_nearest()	1
+#define fast_tf_raise(res)	((void) (res))
+#endif
+
+/* The high 128 bits of the product of A and B.  */
+
+static inline UTItype
+fast_tf_mulh (UTItype a, UTItype b)
+{
+  UDItype a0 = a, a1 = a >> 64, b0 = b, b1 = b >> 64;
+  UTItype p00 = (UTItype) a0 * b0, p01 = (UTItype) a0 * b1;
+  UTItype p10 = (UTItype) a1 * b0, p11 = (UTItype) a1 * b1;
+  UTItype mid = (p00 >> 64) + (UDItype) p01 + (UDItype) p10;
+
+  return p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+}
+
+/* Round the significand M, which has its implicit bit at bit 115 and
+   two guard bits and a sticky bit below the 113 bits of the result,
+   and pack it with SIGN and the biased exponent E into *R.  */
+
+static inline int
+fast_tf_round_pack (UTItype sign, int e, UTItype m, UTItype *r)
+{
+  unsigned int low = m & 7;
+
+  m >>= 3;
+  if (low > 4 || (low == 4 && (m & 1)))
+    if (++m == FAST_TF_IMPLICIT << 1)
+      {
+	m >>= 1;
+	e++;
+      }
+  if (e >= FAST_TF_EXP_MAX)
+    return 0;
+  *r = sign | ((UTItype) e << 112) | (m & FAST_TF_FRAC);
+  return low ? FAST_TF_INEXACT : FAST_TF_EXACT;
+}
+
+/* A + B.  */
+
+static inline int
+fast_addtf3 (UTItype a, UTItype b, UTItype *r)
+{
+  int ea = FAST_TF_EXP (a), eb = FAST_TF_EXP (b), d;
+  UTItype ma, mb, m;
+
+  if (!FAST_TF_NORMAL_EXP (ea) || !FAST_TF_NORMAL_EXP (eb))
+    return 0;
+
+  /* Make A the operand with the larger magnitude.  */
+  if ((a & ~FAST_TF_SIGN) < (b & ~FAST_TF_SIGN))
+    {
+      m = a, a = b, b = m;
+      d = ea, ea = eb, eb = d;
+    }
+
+  ma = ((a & FAST_TF_FRAC) | FAST_TF_IMPLICIT) << 3;
+  mb = ((b & FAST_TF_FRAC) | FAST_TF_IMPLICIT) << 3;
+
+  /* Align B, folding the bits shifted out into the sticky bit.  */
+  d = ea - eb;
+  if (d > 116)
+    mb = 1;
+  else if (d != 0)
+    mb = (mb >> d) | ((mb << (128 - d)) != 0);
+
+  if (((a ^ b) & FAST_TF_SIGN) == 0)
+    {
+      m = ma + mb;
+      if (m >> 116)
+	{
+	  m = (m >> 1) | (m & 1);
+	  ea++;
+	}
+    }
+  else
+    {
+      m = ma - mb;
+      if (m == 0)
+	{
+	  *r = 0;
+	  return FAST_TF_EXACT;
+	}
+      /* Only a subtraction that lost no bits of B can cancel more
+	 than one bit.  */
+      if (m < FAST_TF_IMPLICIT << 3)
+	{
+	  UDItype hi = m >> 64;
+	  int shift = (hi ? __builtin_clzll (hi)
+		       : 64 + __builtin_clzll ((UDItype) m)) - 12;
+
+	  m <<= shift;
+	  ea -= shift;
+	  if (ea <= 0)
+	    return 0;
+	}
+    }
+
+  return fast_tf_round_pack (a & FAST_TF_SIGN, ea, m, r);
+}
+
+/* A * B.  */
+
+static inline int
+fast_multf3 (UTItype a, UTItype b, UTItype *r)
+{
+  int ea = FAST_TF_EXP (a), eb = FAST_TF_EXP (b), e;
+  UTItype ma, mb, p00, p01, p10, mid, hi, lo, m;
+
+  if (!FAST_TF_NORMAL_EXP (ea) || !FAST_TF_NORMAL_EXP (eb))
+    return 0;
+
+  ma = (a & FAST_TF_FRAC) | FAST_TF_IMPLICIT;
+  mb = (b & FAST_TF_FRAC) | FAST_TF_IMPLICIT;
+
+  /* The 226-bit product, from four 64x64->128 multiplications.  */
+  p00 = (UTItype) (UDItype) ma * (UDItype) mb;
+  p01 = (UTItype) (UDItype) ma * (UDItype) (mb >> 64);
+  p10 = (UTItype) (UDItype) (ma >> 64) * (UDItype) mb;
+  mid = (p00 >> 64) + (UDItype) p01 + (UDItype) p10;
+  lo = (mid << 64) | (UDItype) p00;
+  hi = ((UTItype) (UDItype) (ma >> 64) * (UDItype) (mb >> 64)
+	+ (p01 >> 64) + (p10 >> 64) + (mid >> 64));
+
+  /* Keep the top 116 bits, with everything below in the sticky bit.  */
+  e = ea + eb - FAST_TF_EXP_BIAS;
+  if (hi >> 97)
+    {
+      m = (hi << 18) | (lo >> 110) | ((lo << 18) != 0);
+      e++;
+    }
+  else
+    m = (hi << 19) | (lo >> 109) | ((lo << 19) != 0);
+
+  if (!FAST_TF_NORMAL_EXP (e))
+    return 0;
+  return fast_tf_round_pack ((a ^ b) & FAST_TF_SIGN, e, m, r);
+}
+
+/* The high 128 bits of the product of A and B << 64.  */
+
+static inline UTItype
+fast_tf_mulh_64 (UTItype a, UDItype b)
+{
+  return ((UTItype) (UDItype) (a >> 64) * b
+	  + (((UTItype) (UDItype) a * b) >> 64));
+}
+
+/* Return an approximation to 2**254 / BN, which is 1 / BN as a
+   fraction scaled by 2**126.  BN has its top bit set, so the result
+   is at most 2**127.  Newton-Raphson iteration, X * (2 - BN * X), is
+   started from a seed of about 51 bits from the FPU, or about 31 bits
+   from a 64/32-bit division, and carried out on the high 64 bits of
+   BN until the last step.  The result is within a few units of the
+   last place.  */
+
+static inline UTItype
+fast_tf_recip (UTItype bn)
+{
+  UDItype b = bn >> 64, x, t;
+  int steps;
+
+#if defined (__riscv_flen) && __riscv_flen >= 64
+  /* The seed is almost always inexact, which must not show in the
+     flags.  Tie B and X to the saves so that the computation stays
+     between them.  */
+  unsigned long fflags;
+
+  __asm__ volatile ("frflags %0" : "=r" (fflags), "+r" (b));
+  x = 0x1p53 / (double) (b >> 11) * 0x1p62;
+  __asm__ volatile ("fsflags %0" : : "r" (fflags), "r" (x));
+  steps = 1;
+#else
+  x = (~(UDItype) 0 / (b >> 32)) << 30;
+  steps = 2;
+#endif
+
+  /* 2 is 2**63 at this scale, and 2**127 at the next.  */
+  while (steps-- > 0)
+    {
+      t = ((UTItype) b * x) >> 64;
+      x = ((UTItype) x * (((UDItype) 1 << 63) - t)) >> 62;
+    }
+  return fast_tf_mulh_64 (((UTItype) 1 << 127) - fast_tf_mulh_64 (bn, x),
+			  x) << 2;
+}
+
+/* A / B.  */
+
+static inline int
+fast_divtf3 (UTItype a, UTItype b, UTItype *r)
+{
+  int ea = FAST_TF_EXP (a), eb = FAST_TF_EXP (b), e;
+  UTItype ma, mb, q, rem;
+
+  if (!FAST_TF_NORMAL_EXP (ea) || !FAST_TF_NORMAL_EXP (eb))
+    return 0;
+
+  ma = (a & FAST_TF_FRAC) | FAST_TF_IMPLICIT;
+  mb = (b & FAST_TF_FRAC) | FAST_TF_IMPLICIT;
+  e = ea - eb + FAST_TF_EXP_BIAS;
+  if (ma < mb)
+    {
+      ma <<= 1;
+      e--;
+    }
+  if (!FAST_TF_NORMAL_EXP (e))
+    return 0;
+
+  /* With MA in [MB, 2 * MB), the quotient MA * 2**113 / MB has 114
+     bits: the result and one guard bit.  Estimate it from the
+     reciprocal and then correct it using the remainder, of which the
+     low 128 bits are enough while the estimate is close.  */
+  q = fast_tf_mulh (ma << 14, fast_tf_recip (mb << 15)) >> 12;
+  rem = (ma << 113) - q * mb;
+  while ((TItype) rem < 0)
+    {
+      q--;
+      rem += mb;
+    }
+  while (rem >= mb)
+    {
+      q++;
+      rem -= mb;
+    }
+
+  return fast_tf_round_pack ((a ^ b) & FAST_TF_SIGN, e,
+			     (q << 2) | (rem != 0), r);
+}
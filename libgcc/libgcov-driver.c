@@ -59,6 +59,15 @@ static void gcov_error_exit (void);
 
 #define GCOV_PROF_PREFIX "libgcov profiling error:%s:"
 
+/* Continuous mode keeps the edge counters of units compiled with
+   -fprofile-continuous in a file-backed shared mapping, so their totals
+   survive crashes and need no merging at exit.  */
+#if !IN_GCOV_TOOL && GCOV_LOCKED && HAVE_SYS_MMAN_H && defined (__ELF__)
+#define GCOV_CONTINUOUS 1
+#else
+#define GCOV_CONTINUOUS 0
+#endif
+
 struct gcov_fn_buffer
 {
   struct gcov_fn_buffer *next;
@@ -340,6 +349,189 @@ read_error:
 
 #define MAX(X,Y) ((X) > (Y) ? (X) : (Y))
 
+#if GCOV_CONTINUOUS
+
+/* The section the compiler puts continuous-mode edge counters in.  */
+#define GCOV_CONTINUOUS_SECTION "__gcov_cnts"
+
+/* The magic number of a continuous-mode counter file, "gcdc".  */
+#define GCOV_CONTINUOUS_MAGIC ((gcov_unsigned_t)0x67636463)
+
+/* The largest page size the counter section is aligned for.  */
+#define GCOV_CONTINUOUS_ALIGN 65536
+
+/* The first page of a counter file.  An image of the counter section
+   follows from the second page on.  */
+
+struct gcov_continuous_header
+{
+  gcov_unsigned_t magic;
+  gcov_unsigned_t version;
+  gcov_unsigned_t stamp;
+  gcov_unsigned_t pad;
+  gcov_type size;
+  gcov_type runs;
+};
+
+/* libgcov is linked after the instrumented objects, so this ends the
+   counter section.  Its alignment also makes the section start on a
+   page boundary.  */
+static char gcov_continuous_end
+  __attribute__ ((used, section (GCOV_CONTINUOUS_SECTION),
+		  aligned (GCOV_CONTINUOUS_ALIGN)));
+
+/* Provided by the linker when the section exists.  */
+extern char __start___gcov_cnts[]
+  __attribute__ ((weak, visibility ("hidden")));
+
+/* The header of the mapped counter file, or NULL if continuous mode is
+   not in use.  */
+static struct gcov_continuous_header *gcov_continuous_hdr;
+
+/* Map the counter section onto its file, named by GCOV_CONTINUOUS_FILE
+   or else after the gcda file of INFO, the first unit to register.
+   Counts from earlier runs of the same binary are kept; anything
+   counted before the call is added to them.  */
+
+static void
+gcov_continuous_init (const struct gcov_info *info)
+{
+  char *start = __start___gcov_cnts;
+  char *end = &gcov_continuous_end;
+  struct gcov_continuous_header hdr;
+  struct flock s_flock;
+  gcov_type *saved, *counters;
+  const char *env;
+  char *filename;
+  size_t size, n, i;
+  long page;
+  void *map;
+  int fd;
+
+  if (!start || end <= start)
+    return;
+
+  size = end - start;
+  page = sysconf (_SC_PAGESIZE);
+  if (page <= 0 || (uintptr_t)start % page || size % page)
+    {
+      gcov_error ("libgcov profiling error:counter section is not "
+		  "page-aligned, continuous mode disabled\n");
+      return;
+    }
+
+  env = getenv ("GCOV_CONTINUOUS_FILE");
+  if (env && *env)
+    {
+      filename = (char *)xmalloc (strlen (env) + 1);
+      strcpy (filename, env);
+    }
+  else
+    {
+      filename = (char *)xmalloc (strlen (info->filename) + 5);
+      strcpy (filename, info->filename);
+      strcat (filename, ".cnt");
+    }
+
+  fd = open (filename, O_RDWR | O_CREAT, 0666);
+  if (fd < 0)
+    {
+      gcov_error (GCOV_PROF_PREFIX "Cannot open counter file\n", filename);
+      free (filename);
+      return;
+    }
+
+  s_flock.l_whence = SEEK_SET;
+  s_flock.l_start = 0;
+  s_flock.l_len = 0;
+  s_flock.l_pid = getpid ();
+  s_flock.l_type = F_WRLCK;
+  while (fcntl (fd, F_SETLKW, &s_flock) && errno == EINTR)
+    continue;
+
+  /* Start afresh unless the file holds counters of this very binary.  */
+  if (read (fd, &hdr, sizeof (hdr)) != sizeof (hdr)
+      || hdr.magic != GCOV_CONTINUOUS_MAGIC
+      || hdr.version != GCOV_VERSION
+      || hdr.stamp != info->stamp
+      || hdr.size != (gcov_type)size)
+    {
+      if (ftruncate (fd, 0))
+	goto fail;
+      hdr.magic = GCOV_CONTINUOUS_MAGIC;
+      hdr.version = GCOV_VERSION;
+      hdr.stamp = info->stamp;
+      hdr.pad = 0;
+      hdr.size = size;
+      hdr.runs = 0;
+    }
+  if (ftruncate (fd, page + size))
+    goto fail;
+
+  map = mmap (NULL, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED)
+    goto fail;
+  gcov_continuous_hdr = (struct gcov_continuous_header *)map;
+
+  /* Other constructors may already have run instrumented code.  */
+  saved = (gcov_type *)xmalloc (size);
+  memcpy (saved, start, size);
+
+  map = mmap (start, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+	      fd, page);
+  if (map == MAP_FAILED)
+    {
+      munmap (gcov_continuous_hdr, page);
+      gcov_continuous_hdr = NULL;
+      free (saved);
+      goto fail;
+    }
+
+  counters = (gcov_type *)start;
+  n = size / sizeof (gcov_type);
+  for (i = 0; i != n; i++)
+    counters[i] += saved[i];
+  free (saved);
+
+  hdr.runs++;
+  memcpy (gcov_continuous_hdr, &hdr, sizeof (hdr));
+
+  close (fd);
+  free (filename);
+  return;
+
+fail:
+  gcov_error (GCOV_PROF_PREFIX "Cannot map counter file, continuous mode "
+	      "disabled\n", filename);
+  close (fd);
+  free (filename);
+}
+
+/* Return true if the edge counters of GI_PTR live in the mapped
+   counter section.  */
+
+static int
+gcov_continuous_p (const struct gcov_info *gi_ptr)
+{
+  if (!gcov_continuous_hdr || !gi_ptr->merge[GCOV_COUNTER_ARCS])
+    return 0;
+
+  for (unsigned f_ix = 0; f_ix != gi_ptr->n_functions; f_ix++)
+    {
+      const struct gcov_fn_info *gfi_ptr = gi_ptr->functions[f_ix];
+
+      if (gfi_ptr && gfi_ptr->key == gi_ptr && gfi_ptr->ctrs[0].num)
+	{
+	  char *values = (char *)gfi_ptr->ctrs[0].values;
+	  return values >= __start___gcov_cnts && values < &gcov_continuous_end;
+	}
+    }
+
+  return 0;
+}
+
+#endif /* GCOV_CONTINUOUS */
+
 /* Store all TOP N counters where each has a dynamic length.  */
 
 static void
@@ -518,6 +710,19 @@ dump_one_gcov (struct gcov_info *gi_ptr, struct gcov_filename *gf,
   if (error == -1)
     return;
 
+#if GCOV_CONTINUOUS
+  /* The mapped counters already hold the totals of all runs, so just
+     write them out.  */
+  if (gcov_continuous_p (gi_ptr))
+    {
+      gcov_rewrite ();
+      summary.runs = gcov_continuous_hdr->runs;
+      summary.sum_max = run_max;
+      write_one_data (gi_ptr, &summary);
+      goto read_fatal;
+    }
+#endif
+
   tag = gcov_read_unsigned ();
   if (tag)
     {
@@ -560,6 +765,43 @@ read_fatal:;
 }
 
 
+#if !IN_GCOV_TOOL
+/* Fold the per-thread copies of the edge counters of each object in
+   LIST into the first one, which is the copy that gets dumped.  */
+
+static void
+gcov_fold_shards (struct gcov_info *list)
+{
+  struct gcov_info *gi_ptr;
+
+  for (gi_ptr = list; gi_ptr; gi_ptr = gi_ptr->next)
+    {
+      if (gi_ptr->n_shards <= 1 || !gi_ptr->merge[GCOV_COUNTER_ARCS])
+	continue;
+
+      for (unsigned f_ix = 0; f_ix != gi_ptr->n_functions; f_ix++)
+	{
+	  const struct gcov_fn_info *gfi_ptr = gi_ptr->functions[f_ix];
+
+	  if (!gfi_ptr || gfi_ptr->key != gi_ptr)
+	    continue;
+
+	  const struct gcov_ctr_info *ci_ptr
+	    = &gfi_ptr->ctrs[GCOV_COUNTER_ARCS];
+	  for (unsigned s = 1; s != gi_ptr->n_shards; s++)
+	    {
+	      gcov_type *shard = ci_ptr->values + s * ci_ptr->num;
+	      for (unsigned i = 0; i != ci_ptr->num; i++)
+		{
+		  ci_ptr->values[i] += shard[i];
+		  shard[i] = 0;
+		}
+	    }
+	}
+    }
+}
+#endif
+
 /* Dump all the coverage counts for the program. It first computes program
    summary and then traverses gcov_list list and dumps the gcov_info
    objects one by one.  */
@@ -573,6 +815,10 @@ gcov_do_dump (struct gcov_info *list, int run_counted)
   struct gcov_info *gi_ptr;
   struct gcov_filename gf;
 
+#if !IN_GCOV_TOOL
+  gcov_fold_shards (list);
+#endif
+
   /* Compute run_max of this program run.  */
   gcov_type run_max = 0;
   for (gi_ptr = list; gi_ptr; gi_ptr = gi_ptr->next)
@@ -627,6 +873,14 @@ struct gcov_root __gcov_root;
 struct gcov_master __gcov_master = 
   {GCOV_VERSION, 0};
 
+/* Code compiled with -fprofile-update=sharded picks the copy of the
+   edge counters it updates from the address of this variable, so it
+   must be thread-local.  The declaration must match tree-profile.c.  */
+#if defined(HAVE_CC_TLS) && !defined (USE_EMUTLS)
+__thread
+#endif
+char __gcov_shard_anchor;
+
 /* Dynamic pool for gcov_kvp structures.  */
 struct gcov_kvp *__gcov_kvp_dynamic_pool;
 
@@ -670,6 +924,9 @@ __gcov_init (struct gcov_info *info)
 		__gcov_master.root->prev = &__gcov_root;
 	      __gcov_master.root = &__gcov_root;
 	    }
+#if GCOV_CONTINUOUS
+	  gcov_continuous_init (info);
+#endif
 	}
 
       info->next = __gcov_root.list;
@@ -105,7 +105,10 @@ gcov_clear (const struct gcov_info *list)
               if (!gi_ptr->merge[t_ix])
                 continue;
 
-              memset (ci_ptr->values, 0, sizeof (gcov_type) * ci_ptr->num);
+              unsigned n_counts = ci_ptr->num;
+              if (t_ix == GCOV_COUNTER_ARCS && gi_ptr->n_shards > 1)
+                n_counts *= gi_ptr->n_shards;
+              memset (ci_ptr->values, 0, sizeof (gcov_type) * n_counts);
               ci_ptr++;
             }
         }
@@ -49,6 +49,33 @@ void gcov_set_verbose (void)
   verbose = 1;
 }
 
+/* When the files of a profile directory are split between several
+   jobs, the number of jobs and the index of this one.  */
+static unsigned partition_count = 1;
+static unsigned partition_index;
+
+/* Only read the gcda files that belong to job INDEX of COUNT.  */
+void gcov_set_partition (unsigned index, unsigned count)
+{
+  partition_index = index;
+  partition_count = count;
+}
+
+/* Return true if FILENAME belongs to this job.  */
+
+static bool
+in_partition_p (const char *filename)
+{
+  unsigned hash = 0;
+
+  if (partition_count <= 1)
+    return true;
+
+  for (; *filename; filename++)
+    hash = hash * 31 + (unsigned char) *filename;
+  return hash % partition_count == partition_index;
+}
+
 /* The following part is to read Gcda and reconstruct GCOV_INFO.  */
 
 #include "obstack.h"
@@ -409,6 +436,9 @@ ftw_read_file (const char *filename,
   if (strcmp(filename + filename_len - suffix_len, GCOV_DATA_SUFFIX))
     return 0;
 
+  if (!in_partition_p (filename))
+    return 0;
+
   if (verbose)
     fnotice (stderr, "reading file: %s\n", filename);
 
@@ -225,6 +225,8 @@ struct gcov_info
 					  unused) */
   
   unsigned n_functions;		/* number of functions */
+  unsigned n_shards;		/* number of per-thread copies of the edge
+				   counters, zero or one if not sharded */
 
 #ifndef IN_GCOV_TOOL
   const struct gcov_fn_info *const *functions; /* pointer to pointers
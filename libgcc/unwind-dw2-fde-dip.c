@@ -86,6 +86,9 @@
 #if defined(USE_PT_GNU_EH_FRAME)
 
 #include <link.h>
+#ifdef __GLIBC__
+#include <dlfcn.h>		/* Get _dl_find_object.  */
+#endif
 
 #ifndef __RELOC_POINTER
 # define __RELOC_POINTER(ptr, base) ((ptr) + (base))
@@ -101,16 +104,6 @@ static const fde * _Unwind_Find_registered_FDE (void *pc, struct dwarf_eh_bases
 #define PT_GNU_EH_FRAME (PT_LOOS + 0x474e550)
 #endif
 
-struct unw_eh_callback_data
-{
-  _Unwind_Ptr pc;
-  void *tbase;
-  void *dbase;
-  void *func;
-  const fde *ret;
-  int check_cache;
-};
-
 struct unw_eh_frame_hdr
 {
   unsigned char version;
@@ -119,6 +112,14 @@ struct unw_eh_frame_hdr
   unsigned char table_enc;
 };
 
+struct unw_eh_callback_data
+{
+  _Unwind_Ptr pc;
+  void *dbase;
+  const struct unw_eh_frame_hdr *hdr;
+  int check_cache;
+};
+
 #define FRAME_HDR_CACHE_SIZE 8
 
 static struct frame_hdr_cache_element
@@ -137,11 +138,12 @@ static struct frame_hdr_cache_element
 
 static struct frame_hdr_cache_element *frame_hdr_cache_head;
 
-/* Like base_of_encoded_value, but take the base from a struct
-   unw_eh_callback_data instead of an _Unwind_Context.  */
+/* Like base_of_encoded_value, but take the DW_EH_PE_datarel base from
+   DBASE instead of an _Unwind_Context.  There is no DW_EH_PE_textrel
+   base.  */
 
 static _Unwind_Ptr
-base_from_cb_data (unsigned char encoding, struct unw_eh_callback_data *data)
+base_from_cb_data (unsigned char encoding, _Unwind_Ptr dbase)
 {
   if (encoding == DW_EH_PE_omit)
     return 0;
@@ -154,9 +156,9 @@ base_from_cb_data (unsigned char encoding, struct unw_eh_callback_data *data)
       return 0;
 
     case DW_EH_PE_textrel:
-      return (_Unwind_Ptr) data->tbase;
+      return 0;
     case DW_EH_PE_datarel:
-      return (_Unwind_Ptr) data->dbase;
+      return dbase;
     default:
       gcc_unreachable ();
     }
@@ -173,10 +175,6 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 #else
   _Unwind_Ptr load_base;
 #endif
-  const unsigned char *p;
-  const struct unw_eh_frame_hdr *hdr;
-  _Unwind_Ptr eh_frame;
-  struct object ob;
   _Unwind_Ptr pc_low = 0, pc_high = 0;
 
   struct ext_dl_phdr_info
@@ -323,11 +321,10 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
   if (!p_eh_frame_hdr)
     return 0;
 
-  /* Read .eh_frame_hdr header.  */
-  hdr = (const struct unw_eh_frame_hdr *)
+  /* The .eh_frame_hdr is searched by find_fde_tail once the loader
+     lock has been released.  */
+  data->hdr = (const struct unw_eh_frame_hdr *)
     __RELOC_POINTER (p_eh_frame_hdr->p_vaddr, load_base);
-  if (hdr->version != 1)
-    return 1;
 
 #ifdef CRT_GET_RFIB_DATA
 # if defined __i386__ || defined __nios2__
@@ -358,10 +355,28 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 #  error What is DW_EH_PE_datarel base on this platform?
 # endif
 #endif
+  return 1;
+}
+
+/* Find the FDE for PC in the object whose .eh_frame_hdr is HDR, and
+   whose DW_EH_PE_datarel base is DBASE.  Fill in *BASES and return the
+   FDE, or return NULL if there is none.  */
+
+static const fde *
+find_fde_tail (_Unwind_Ptr pc, const struct unw_eh_frame_hdr *hdr,
+	       _Unwind_Ptr dbase, struct dwarf_eh_bases *bases)
+{
+  const unsigned char *p;
+  _Unwind_Ptr eh_frame;
+  struct object ob;
+  const fde *ret;
+
+  if (hdr->version != 1)
+    return NULL;
 
   p = read_encoded_value_with_base (hdr->eh_frame_ptr_enc,
 				    base_from_cb_data (hdr->eh_frame_ptr_enc,
-						       data),
+						       dbase),
 				    (const unsigned char *) (hdr + 1),
 				    &eh_frame);
 
@@ -375,11 +390,11 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 
       p = read_encoded_value_with_base (hdr->fde_count_enc,
 					base_from_cb_data (hdr->fde_count_enc,
-							   data),
+							   dbase),
 					p, &fde_count);
       /* Shouldn't happen.  */
       if (fde_count == 0)
-	return 1;
+	return NULL;
       if ((((_Unwind_Ptr) p) & 3) == 0)
 	{
 	  struct fde_table {
@@ -394,9 +409,9 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 	  _Unwind_Ptr range;
 
 	  mid = fde_count - 1;
-	  if (data->pc < table[0].initial_loc + data_base)
-	    return 1;
-	  else if (data->pc < table[mid].initial_loc + data_base)
+	  if (pc < table[0].initial_loc + data_base)
+	    return NULL;
+	  else if (pc < table[mid].initial_loc + data_base)
 	    {
 	      lo = 0;
 	      hi = mid;
@@ -404,9 +419,9 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 	      while (lo < hi)
 		{
 		  mid = (lo + hi) / 2;
-		  if (data->pc < table[mid].initial_loc + data_base)
+		  if (pc < table[mid].initial_loc + data_base)
 		    hi = mid;
-		  else if (data->pc >= table[mid + 1].initial_loc + data_base)
+		  else if (pc >= table[mid + 1].initial_loc + data_base)
 		    lo = mid + 1;
 		  else
 		    break;
@@ -420,10 +435,12 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 	  f_enc_size = size_of_encoded_value (f_enc);
 	  read_encoded_value_with_base (f_enc & 0x0f, 0,
 					&f->pc_begin[f_enc_size], &range);
-	  if (data->pc < table[mid].initial_loc + data_base + range)
-	    data->ret = f;
-	  data->func = (void *) (table[mid].initial_loc + data_base);
-	  return 1;
+	  if (pc >= table[mid].initial_loc + data_base + range)
+	    return NULL;
+	  bases->tbase = NULL;
+	  bases->dbase = (void *) dbase;
+	  bases->func = (void *) (table[mid].initial_loc + data_base);
+	  return f;
 	}
     }
 
@@ -431,23 +448,25 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
      As soon as GLIBC will provide API so to notify that a library has been
      removed, we could cache this (and thus use search_object).  */
   ob.pc_begin = NULL;
-  ob.tbase = data->tbase;
-  ob.dbase = data->dbase;
+  ob.tbase = NULL;
+  ob.dbase = (void *) dbase;
   ob.u.single = (fde *) eh_frame;
   ob.s.i = 0;
   ob.s.b.mixed_encoding = 1;  /* Need to assume worst case.  */
-  data->ret = linear_search_fdes (&ob, (fde *) eh_frame, (void *) data->pc);
-  if (data->ret != NULL)
+  ret = linear_search_fdes (&ob, (fde *) eh_frame, (void *) pc);
+  if (ret != NULL)
     {
       _Unwind_Ptr func;
-      unsigned int encoding = get_fde_encoding (data->ret);
+      unsigned int encoding = get_fde_encoding (ret);
 
       read_encoded_value_with_base (encoding,
-				    base_from_cb_data (encoding, data),
-				    data->ret->pc_begin, &func);
-      data->func = (void *) func;
+				    base_from_cb_data (encoding, dbase),
+				    ret->pc_begin, &func);
+      bases->tbase = NULL;
+      bases->dbase = (void *) dbase;
+      bases->func = (void *) func;
     }
-  return 1;
+  return ret;
 }
 
 const fde *
@@ -460,23 +479,34 @@ _Unwind_Find_FDE (void *pc, struct dwarf_eh_bases *bases)
   if (ret != NULL)
     return ret;
 
+#ifdef DLFO_STRUCT_HAS_EH_DBASE
+  /* glibc 2.35 and later can find the object containing PC without
+     taking the loader lock, which dl_iterate_phdr holds throughout.  */
+  {
+    struct dl_find_object dlfo;
+
+    if (_dl_find_object (pc, &dlfo) != 0 || dlfo.dlfo_eh_frame == NULL)
+      return NULL;
+    return find_fde_tail ((_Unwind_Ptr) pc, dlfo.dlfo_eh_frame,
+# if DLFO_STRUCT_HAS_EH_DBASE
+			  (_Unwind_Ptr) dlfo.dlfo_eh_dbase,
+# else
+			  0,
+# endif
+			  bases);
+  }
+#endif
+
   data.pc = (_Unwind_Ptr) pc;
-  data.tbase = NULL;
   data.dbase = NULL;
-  data.func = NULL;
-  data.ret = NULL;
+  data.hdr = NULL;
   data.check_cache = 1;
 
-  if (dl_iterate_phdr (_Unwind_IteratePhdrCallback, &data) < 0)
+  if (dl_iterate_phdr (_Unwind_IteratePhdrCallback, &data) < 0
+      || data.hdr == NULL)
     return NULL;
 
-  if (data.ret)
-    {
-      bases->tbase = data.tbase;
-      bases->dbase = data.dbase;
-      bases->func = data.func;
-    }
-  return data.ret;
+  return find_fde_tail (data.pc, data.hdr, (_Unwind_Ptr) data.dbase, bases);
 }
 
 #else
@@ -510,3 +510,39 @@ AC_DEFUN([LIBGFOR_CHECK_AVX128], [
 	[AM_CONDITIONAL([HAVE_AVX128],false)])
   CFLAGS="$ac_save_CFLAGS"
 ])
+
+dnl Check for the RISC-V vector extension, as a target attribute, and
+dnl for getauxval to detect it at run time.
+AC_DEFUN([LIBGFOR_CHECK_RVV], [
+  ac_save_CFLAGS="$CFLAGS"
+  CFLAGS="-O2"
+  AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[
+  #include <sys/auxv.h>
+  void foo (void) __attribute__((__target__("arch=+v")));
+  void foo (void)
+        {
+           __asm__ ("vsetvli t0, zero, e64, m1, ta, ma" : : : "t0");
+        }]], [[return getauxval (AT_HWCAP) == 0;]])],
+	AC_DEFINE(HAVE_RVV, 1,
+	[Define if RISC-V vector instructions can be compiled.]),
+	[])
+  CFLAGS="$ac_save_CFLAGS"
+])
+
+dnl Check for SVE, as a target attribute, and for getauxval to detect
+dnl it at run time.
+AC_DEFUN([LIBGFOR_CHECK_SVE], [
+  ac_save_CFLAGS="$CFLAGS"
+  CFLAGS="-O2"
+  AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[
+  #include <sys/auxv.h>
+  void foo (void) __attribute__((__target__("+sve")));
+  void foo (void)
+        {
+           __asm__ ("ptrue p0.d" : : : "p0");
+        }]], [[return getauxval (AT_HWCAP) == 0;]])],
+	AC_DEFINE(HAVE_SVE, 1,
+	[Define if SVE instructions can be compiled.]),
+	[])
+  CFLAGS="$ac_save_CFLAGS"
+])
@@ -0,0 +1,1553 @@
+/* Shared-memory implementation of GNU Fortran Coarray Library
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+This file is part of the GNU Fortran Coarray Runtime Library (libcaf).
+
+Libcaf is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+Libcaf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+/* The images are processes on one host, forked by _gfortran_caf_init,
+   which share one anonymous memory mapping made before the fork, so
+   that it is at the same address in all of them.  The mapping holds a
+   control block and then the same amount of memory for each image.
+
+   The coarrays of an image are allocated from the bottom of its memory,
+   in the same order in all images, so that a coarray is at the same
+   offset in the memory of every image and the address of its data on
+   image J is the local address plus (J - THIS_IMAGE) times the size of
+   the memory of an image.  Everything else that other images read,
+   such as the tokens of allocatable components and the memory they
+   point to, is allocated from the top of the memory of the image and
+   found through pointers, which are valid in all images.  With that,
+   the data movement of single.c, which this file includes, works for
+   any image.
+
+   The process that started the program does not run an image: it waits
+   for the images and ends the program as soon as one of them ends it
+   with an error.  */
+
+#include "libcaf.h"
+
+#if defined (HAVE_FORK) && defined (HAVE_WAITPID) \
+    && defined (HAVE_SYS_WAIT_H) && __has_include (<sys/mman.h>)
+# include <sys/mman.h>
+# if !defined (MAP_ANONYMOUS) && defined (MAP_ANON)
+#  define MAP_ANONYMOUS MAP_ANON
+# endif
+# ifdef MAP_ANONYMOUS
+#  define CAF_SHMEM 1
+# endif
+#endif
+
+/* Without CAF_SHMEM, libcaf_shmem is libcaf_single.  */
+#include "single.c"
+
+#ifdef CAF_SHMEM
+
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#ifndef MAP_NORESERVE
+# define MAP_NORESERVE 0
+#endif
+
+/* The number of rounds a wait for another image spins before it starts
+   to give up the CPU on each round.  There may be more images than
+   CPUs.  */
+#define CAF_SPIN_COUNT 1000
+
+/* The default size of the memory of an image, if
+   GFORTRAN_SHARED_MEMORY_SIZE is not set.  The mapping is made with
+   MAP_NORESERVE, so only the memory that is touched is used.  */
+#define CAF_DEFAULT_IMAGE_SIZE \
+  (sizeof (void *) >= 8 ? (size_t) 256 << 20 : (size_t) 16 << 20)
+
+/* The state of an image that other images look at.  Each image has a
+   cache line of its own.  */
+typedef struct __attribute__ ((aligned (64)))
+{
+  /* Zero while the image runs, then CAF_STAT_STOPPED_IMAGE or
+     CAF_STAT_FAILED_IMAGE.  */
+  int status;
+  /* The number of barriers, SYNC ALL and those of the collectives,
+     the image has arrived at.  */
+  unsigned int barrier;
+  /* The data of the image for the collective in progress.  */
+  char *collective;
+} caf_image_state;
+
+/* The start of the shared mapping.  It is followed by the counters of
+   SYNC IMAGES, and then by the memory of the images.  */
+typedef struct
+{
+  /* Set by ERROR STOP, with its code.  */
+  int error_stop;
+  int error_code;
+  caf_image_state image[];
+} caf_control;
+
+/* A block of the memory of this image.  SIZE includes the header.  */
+typedef struct caf_block
+{
+  size_t size;
+  /* The next free block, by address.  */
+  struct caf_block *next;
+} caf_block;
+
+#define CAF_ALIGN 16
+#define CAF_HEADER \
+  ((sizeof (caf_block) + CAF_ALIGN - 1) & ~(size_t) (CAF_ALIGN - 1))
+
+enum { CAF_SYMMETRIC, CAF_ASYMMETRIC };
+
+static caf_control *caf_ctl;
+static int caf_this_image, caf_num_images;
+static size_t caf_image_size;
+/* The memory of image 1 and of this image.  */
+static char *caf_images_mem, *caf_mem;
+/* CAF_SYNC_IMAGES[I * CAF_NUM_IMAGES + J] counts the SYNC IMAGES of
+   image I + 1 with image J + 1.  */
+static unsigned int *caf_sync_images;
+/* The symmetric allocations take memory from the bottom, up to
+   CAF_SYM_TOP, and the others from the top, down to CAF_ASYM_BOTTOM.  */
+static char *caf_sym_top, *caf_asym_bottom;
+static caf_block *caf_free[2];
+/* The images, in the process that waits for them.  */
+static pid_t *caf_pids;
+
+
+/* Called on round N of a wait for another image.  */
+
+static inline void
+caf_relax (unsigned int n)
+{
+  if (n >= CAF_SPIN_COUNT)
+    sched_yield ();
+}
+
+
+/* Allocate SIZE bytes, from the symmetric or the asymmetric part of the
+   memory of this image as WHICH says.  The symmetric part is first fit,
+   so that the same sequence of allocations gives the same addresses in
+   every image.  */
+
+static void *
+caf_heap_alloc (int which, size_t size)
+{
+  caf_block **link, *b;
+
+  if (size > caf_image_size)
+    return NULL;
+  size = (size + CAF_HEADER + CAF_ALIGN - 1) & ~(size_t) (CAF_ALIGN - 1);
+
+  for (link = &caf_free[which]; (b = *link) != NULL; link = &b->next)
+    if (b->size >= size)
+      {
+	if (b->size - size >= CAF_HEADER + CAF_ALIGN)
+	  {
+	    caf_block *rest = (caf_block *) ((char *) b + size);
+	    rest->size = b->size - size;
+	    rest->next = b->next;
+	    *link = rest;
+	    b->size = size;
+	  }
+	else
+	  *link = b->next;
+	return (char *) b + CAF_HEADER;
+      }
+
+  if ((size_t) (caf_asym_bottom - caf_sym_top) < size)
+    return NULL;
+  if (which == CAF_SYMMETRIC)
+    {
+      b = (caf_block *) caf_sym_top;
+      caf_sym_top += size;
+    }
+  else
+    {
+      caf_asym_bottom -= size;
+      b = (caf_block *) caf_asym_bottom;
+    }
+  b->size = size;
+  return (char *) b + CAF_HEADER;
+}
+
+
+/* Free PTR, allocated from the part WHICH of the memory.  Blocks next
+   to the unused middle of the memory are given back to it.  */
+
+static void
+caf_heap_free (int which, void *ptr)
+{
+  caf_block *b = (caf_block *) ((char *) ptr - CAF_HEADER);
+  caf_block **link = &caf_free[which], **prev_link = NULL;
+
+  while (*link != NULL && *link < b)
+    {
+      prev_link = link;
+      link = &(*link)->next;
+    }
+
+  if (which == CAF_SYMMETRIC && (char *) b + b->size == caf_sym_top)
+    {
+      caf_sym_top = (char *) b;
+      if (prev_link
+	  && (char *) *prev_link + (*prev_link)->size == caf_sym_top)
+	{
+	  caf_sym_top = (char *) *prev_link;
+	  *prev_link = NULL;
+	}
+      return;
+    }
+  if (which == CAF_ASYMMETRIC && (char *) b == caf_asym_bottom)
+    {
+      caf_asym_bottom += b->size;
+      if (*link && (char *) *link == caf_asym_bottom)
+	{
+	  caf_asym_bottom += (*link)->size;
+	  *link = (*link)->next;
+	}
+      return;
+    }
+
+  b->next = *link;
+  *link = b;
+  if (b->next && (char *) b + b->size == (char *) b->next)
+    {
+      b->size += b->next->size;
+      b->next = b->next->next;
+    }
+  if (prev_link && (char *) *prev_link + (*prev_link)->size == (char *) b)
+    {
+      (*prev_link)->size += b->size;
+      (*prev_link)->next = b->next;
+    }
+}
+
+
+static bool
+caf_symmetric_p (void *ptr)
+{
+  return (char *) ptr >= caf_mem && (char *) ptr < caf_sym_top;
+}
+
+
+/* See SET_IMAGE_TOKEN in single.c.  */
+
+static caf_token_t
+caf_shmem_image_token (caf_token_t token, int image_index,
+		       caf_image_token_t *image_token)
+{
+  caf_single_token_t local = TOKEN (token);
+  ptrdiff_t delta;
+
+  /* Zero is this image too, for a reference without a coindex.  */
+  if (image_index == 0 || image_index == caf_this_image)
+    return token;
+  if (unlikely (image_index < 1 || image_index > caf_num_images))
+    caf_runtime_error ("Image index %d is not in the range 1 to %d",
+		       image_index, caf_num_images);
+
+  delta = (ptrdiff_t) (image_index - caf_this_image)
+	  * (ptrdiff_t) caf_image_size;
+  image_token->token.memptr
+    = local->memptr ? (char *) local->memptr + delta : NULL;
+  image_token->token.owning_memory = false;
+  image_token->token.desc = NULL;
+  if (local->desc)
+    {
+      gfc_descriptor_t *desc = (gfc_descriptor_t *) &image_token->desc;
+
+      memcpy (desc, local->desc,
+	      sizeof (gfc_descriptor_t) + GFC_DESCRIPTOR_RANK (local->desc)
+					  * sizeof (descriptor_dimension));
+      if (GFC_DESCRIPTOR_DATA (desc))
+	GFC_DESCRIPTOR_DATA (desc) = (char *) GFC_DESCRIPTOR_DATA (desc)
+				     + delta;
+      image_token->token.desc = desc;
+    }
+  return &image_token->token;
+}
+
+
+/* Report STATUS of an image control statement or a collective, with
+   message MSG, in STAT and ERRMSG, or end the program with an error if
+   there is no STAT and STATUS is not zero.  */
+
+static void
+caf_report (int status, const char *msg, int *stat, char *errmsg,
+	    size_t errmsg_len)
+{
+  size_t len;
+
+  if (stat)
+    *stat = status;
+  if (status == 0)
+    return;
+  if (!stat)
+    caf_runtime_error ("%s", msg);
+
+  len = strlen (msg);
+  if (len > errmsg_len)
+    len = errmsg_len;
+  if (errmsg_len > 0)
+    {
+      memcpy (errmsg, msg, len);
+      memset (errmsg + len, ' ', errmsg_len - len);
+    }
+}
+
+
+static const char *
+caf_status_msg (int status)
+{
+  return (status == CAF_STAT_FAILED_IMAGE ? "An image has failed"
+	  : "An image has stopped");
+}
+
+
+/* Wait until all images have arrived at as many barriers as this one
+   has with this one.  Return zero, or the status of an image that
+   never will.  */
+
+static int
+caf_barrier (void)
+{
+  caf_image_state *me = &caf_ctl->image[caf_this_image - 1];
+  unsigned int count = __atomic_add_fetch (&me->barrier, 1, __ATOMIC_ACQ_REL);
+  int i, status = 0;
+
+  for (i = 0; i < caf_num_images; i++)
+    {
+      caf_image_state *other = &caf_ctl->image[i];
+      unsigned int n;
+
+      for (n = 0;
+	   (int) (__atomic_load_n (&other->barrier, __ATOMIC_ACQUIRE)
+		  - count) < 0;
+	   n++)
+	{
+	  int st = __atomic_load_n (&other->status, __ATOMIC_ACQUIRE);
+	  if (st != 0)
+	    {
+	      if (status != CAF_STAT_FAILED_IMAGE)
+		status = st;
+	      break;
+	    }
+	  caf_relax (n);
+	}
+    }
+  return status;
+}
+
+
+/* Set the status of this image, which then ends.  */
+
+static void
+caf_set_status (int status)
+{
+  if (caf_ctl)
+    __atomic_store_n (&caf_ctl->image[caf_this_image - 1].status, status,
+		      __ATOMIC_RELEASE);
+}
+
+
+static void __attribute__ ((noreturn))
+caf_error_stop (int code)
+{
+  if (caf_ctl && !__atomic_exchange_n (&caf_ctl->error_stop, 1,
+				       __ATOMIC_ACQ_REL))
+    caf_ctl->error_code = code;
+  exit (code);
+}
+
+
+/* Parse the size in environment variable NAME, a number of bytes with
+   an optional suffix K, M or G.  */
+
+static size_t
+caf_env_size (const char *name, size_t dflt)
+{
+  const char *s = getenv (name);
+  unsigned long long v;
+  char *end;
+  int shift = 0;
+
+  if (s == NULL || *s == '\0')
+    return dflt;
+
+  errno = 0;
+  v = strtoull (s, &end, 10);
+  switch (*end)
+    {
+    case 'k': case 'K': shift = 10; end++; break;
+    case 'm': case 'M': shift = 20; end++; break;
+    case 'g': case 'G': shift = 30; end++; break;
+    }
+  if (errno || *end != '\0' || v == 0 || v > (SIZE_MAX >> shift))
+    caf_runtime_error ("Invalid value '%s' of %s", s, name);
+  return (size_t) v << shift;
+}
+
+
+static void
+caf_forward_signal (int sig)
+{
+  int i;
+
+  for (i = 0; i < caf_num_images; i++)
+    if (caf_pids[i] > 0)
+      kill (caf_pids[i], sig);
+}
+
+
+/* Wait for the images and end the program.  It ends with the first
+   error of an image, after killing the others.  */
+
+static void __attribute__ ((noreturn))
+caf_supervise (void)
+{
+  int remaining = caf_num_images, code = 0, i;
+  bool error = false;
+
+  signal (SIGTERM, caf_forward_signal);
+  signal (SIGHUP, caf_forward_signal);
+
+  while (remaining > 0)
+    {
+      int wstatus;
+      pid_t pid = waitpid (-1, &wstatus, 0);
+
+      if (pid < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  break;
+	}
+      for (i = 0; i < caf_num_images; i++)
+	if (caf_pids[i] == pid)
+	  break;
+      if (i == caf_num_images
+	  || (!WIFEXITED (wstatus) && !WIFSIGNALED (wstatus)))
+	continue;
+      caf_pids[i] = 0;
+      remaining--;
+      if (error)
+	continue;
+
+      if (WIFSIGNALED (wstatus))
+	{
+	  fprintf (stderr, "Fortran runtime error: Image %d was killed by "
+		   "signal %d\n", i + 1, WTERMSIG (wstatus));
+	  error = true;
+	  code = 128 + WTERMSIG (wstatus);
+	}
+      else if (__atomic_load_n (&caf_ctl->error_stop, __ATOMIC_ACQUIRE))
+	{
+	  error = true;
+	  code = caf_ctl->error_code;
+	}
+      else if (WEXITSTATUS (wstatus) != 0
+	       && __atomic_load_n (&caf_ctl->image[i].status,
+				   __ATOMIC_ACQUIRE) == 0)
+	{
+	  error = true;
+	  code = WEXITSTATUS (wstatus);
+	}
+      else
+	{
+	  /* An image that just exited has stopped, as far as the others
+	     waiting for it are concerned.  */
+	  int running = 0;
+	  __atomic_compare_exchange_n (&caf_ctl->image[i].status, &running,
+				       CAF_STAT_STOPPED_IMAGE, false,
+				       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+	  if (WEXITSTATUS (wstatus) > code)
+	    code = WEXITSTATUS (wstatus);
+	}
+
+      if (error)
+	caf_forward_signal (SIGKILL);
+    }
+  _exit (code);
+}
+
+
+/* Map the memory and start the images.  */
+
+static void
+caf_shmem_init (void)
+{
+  size_t page = sysconf (_SC_PAGESIZE), ctl_size, size;
+  unsigned long n;
+  const char *s;
+  char *mem, *end;
+  int i;
+
+  s = getenv ("GFORTRAN_NUM_IMAGES");
+  if (s != NULL && *s != '\0')
+    {
+      errno = 0;
+      n = strtoul (s, &end, 10);
+      if (errno || *end != '\0' || n == 0 || n > INT_MAX)
+	caf_runtime_error ("Invalid value '%s' of GFORTRAN_NUM_IMAGES", s);
+    }
+  else
+    {
+      long cpus = -1;
+#ifdef _SC_NPROCESSORS_ONLN
+      cpus = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+      n = cpus > 0 ? cpus : 1;
+    }
+  caf_num_images = n;
+
+  caf_image_size = caf_env_size ("GFORTRAN_SHARED_MEMORY_SIZE",
+				 CAF_DEFAULT_IMAGE_SIZE);
+  caf_image_size = (caf_image_size + page - 1) & ~(page - 1);
+  ctl_size = (sizeof (caf_control) + n * sizeof (caf_image_state)
+	      + n * n * sizeof (unsigned int) + page - 1) & ~(page - 1);
+  if (caf_image_size > (SIZE_MAX - ctl_size) / n)
+    caf_runtime_error ("Cannot map the memory of %d images", caf_num_images);
+  size = ctl_size + n * caf_image_size;
+
+  mem = mmap (NULL, size, PROT_READ | PROT_WRITE,
+	      MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mem == MAP_FAILED)
+    caf_runtime_error ("Cannot map %lu bytes of shared memory for %d images: "
+		       "%s", (unsigned long) size, caf_num_images,
+		       strerror (errno));
+  caf_ctl = (caf_control *) mem;
+  caf_sync_images = (unsigned int *) &caf_ctl->image[n];
+  caf_images_mem = mem + ctl_size;
+
+  /* With one image, this process is the image.  */
+  caf_this_image = 1;
+  if (n > 1)
+    {
+      caf_pids = calloc (n, sizeof (pid_t));
+      if (caf_pids == NULL)
+	caf_runtime_error ("Cannot start %d images", caf_num_images);
+      /* Output buffered now would otherwise be written by every
+	 image.  */
+      fflush (NULL);
+      for (i = 0; i < caf_num_images; i++)
+	{
+	  pid_t pid = fork ();
+	  if (pid == 0)
+	    {
+	      caf_this_image = i + 1;
+	      free (caf_pids);
+	      caf_pids = NULL;
+	      break;
+	    }
+	  if (pid < 0)
+	    {
+	      fprintf (stderr, "Fortran runtime error: Cannot start image "
+		       "%d: %s\n", i + 1, strerror (errno));
+	      caf_forward_signal (SIGKILL);
+	      _exit (EXIT_FAILURE);
+	    }
+	  caf_pids[i] = pid;
+	}
+      if (i == caf_num_images)
+	caf_supervise ();
+    }
+
+  caf_mem = caf_images_mem + (size_t) (caf_this_image - 1) * caf_image_size;
+  caf_sym_top = caf_mem;
+  caf_asym_bottom = caf_mem + caf_image_size;
+}
+
+
+void
+_gfortran_caf_init (int *argc __attribute__ ((unused)),
+		    char ***argv __attribute__ ((unused)))
+{
+  if (!caf_ctl)
+    caf_shmem_init ();
+}
+
+
+void
+_gfortran_caf_finalize (void)
+{
+  caf_set_status (CAF_STAT_STOPPED_IMAGE);
+}
+
+
+int
+_gfortran_caf_this_image (int distance __attribute__ ((unused)))
+{
+  return caf_this_image;
+}
+
+
+int
+_gfortran_caf_num_images (int distance __attribute__ ((unused)),
+			  int failed)
+{
+  int i, n = 0;
+
+  if (failed < 0)
+    return caf_num_images;
+
+  for (i = 0; i < caf_num_images; i++)
+    if (__atomic_load_n (&caf_ctl->image[i].status, __ATOMIC_ACQUIRE)
+	== CAF_STAT_FAILED_IMAGE)
+      n++;
+  return failed ? n : caf_num_images - n;
+}
+
+
+void
+_gfortran_caf_register (size_t size, caf_register_t type, caf_token_t *token,
+			gfc_descriptor_t *data, int *stat, char *errmsg,
+			size_t errmsg_len)
+{
+  const char alloc_fail_msg[] = "Failed to allocate coarray";
+  void *local = NULL;
+  caf_single_token_t shmem_token;
+  bool alloc = (type == CAF_REGTYPE_COARRAY_ALLOC
+		|| type == CAF_REGTYPE_LOCK_ALLOC
+		|| type == CAF_REGTYPE_EVENT_ALLOC);
+  int status = 0;
+
+  /* Static coarrays are registered by constructors, before main calls
+     _gfortran_caf_init.  */
+  if (!caf_ctl)
+    caf_shmem_init ();
+
+  if (type == CAF_REGTYPE_LOCK_STATIC || type == CAF_REGTYPE_LOCK_ALLOC
+      || type == CAF_REGTYPE_CRITICAL)
+    /* A lock holds the index of the image that holds it.  */
+    size *= sizeof (int);
+  else if (type == CAF_REGTYPE_EVENT_STATIC || type == CAF_REGTYPE_EVENT_ALLOC)
+    size *= sizeof (uint32_t);
+
+  if (type == CAF_REGTYPE_COARRAY_ALLOC_ALLOCATE_ONLY)
+    local = caf_heap_alloc (CAF_ASYMMETRIC, size);
+  else if (type != CAF_REGTYPE_COARRAY_ALLOC_REGISTER_ONLY)
+    local = caf_heap_alloc (CAF_SYMMETRIC, size);
+
+  /* The memory of the static coarrays has not been used before, and
+     other images may already lock and post to it.  */
+  if (local && (type == CAF_REGTYPE_LOCK_ALLOC
+		|| type == CAF_REGTYPE_EVENT_ALLOC))
+    memset (local, 0, size);
+
+  if (type != CAF_REGTYPE_COARRAY_ALLOC_ALLOCATE_ONLY)
+    *token = caf_heap_alloc (CAF_ASYMMETRIC, sizeof (struct caf_single_token));
+
+  if (unlikely (*token == NULL
+		|| (local == NULL
+		    && type != CAF_REGTYPE_COARRAY_ALLOC_REGISTER_ONLY)))
+    {
+      if (local)
+	caf_heap_free (type == CAF_REGTYPE_COARRAY_ALLOC_ALLOCATE_ONLY
+		       ? CAF_ASYMMETRIC : CAF_SYMMETRIC, local);
+      if (*token && type != CAF_REGTYPE_COARRAY_ALLOC_ALLOCATE_ONLY)
+	{
+	  caf_heap_free (CAF_ASYMMETRIC, *token);
+	  *token = NULL;
+	}
+      /* The other images are in the barrier.  */
+      if (alloc)
+	caf_barrier ();
+      caf_report (1, alloc_fail_msg, stat, errmsg, errmsg_len);
+      return;
+    }
+
+  shmem_token = TOKEN (*token);
+  shmem_token->memptr = local;
+  shmem_token->owning_memory = type != CAF_REGTYPE_COARRAY_ALLOC_REGISTER_ONLY;
+  shmem_token->desc = GFC_DESCRIPTOR_RANK (data) > 0 ? data : NULL;
+  GFC_DESCRIPTOR_DATA (data) = local;
+
+  /* ALLOCATE of a coarray synchronizes all images.  */
+  if (alloc)
+    status = caf_barrier ();
+  caf_report (status, caf_status_msg (status), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_deregister (caf_token_t *token, caf_deregister_t type, int *stat,
+			  char *errmsg, size_t errmsg_len)
+{
+  caf_single_token_t shmem_token = TOKEN (*token);
+  int status = 0;
+
+  if (shmem_token->owning_memory && shmem_token->memptr)
+    {
+      if (caf_symmetric_p (shmem_token->memptr))
+	{
+	  /* DEALLOCATE of a coarray synchronizes all images, and the
+	     others may use the memory until then.  */
+	  status = caf_barrier ();
+	  caf_heap_free (CAF_SYMMETRIC, shmem_token->memptr);
+	}
+      else
+	caf_heap_free (CAF_ASYMMETRIC, shmem_token->memptr);
+    }
+
+  if (type != CAF_DEREGTYPE_COARRAY_DEALLOCATE_ONLY)
+    {
+      caf_heap_free (CAF_ASYMMETRIC, *token);
+      *token = NULL;
+    }
+  else
+    {
+      shmem_token->memptr = NULL;
+      shmem_token->owning_memory = false;
+    }
+
+  caf_report (status, caf_status_msg (status), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_sync_all (int *stat, char *errmsg, size_t errmsg_len)
+{
+  int status = caf_barrier ();
+
+  caf_report (status, caf_status_msg (status), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_sync_memory (int *stat,
+			   char *errmsg __attribute__ ((unused)),
+			   size_t errmsg_len __attribute__ ((unused)))
+{
+  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+  if (stat)
+    *stat = 0;
+}
+
+
+void
+_gfortran_caf_sync_images (int count, int images[], int *stat, char *errmsg,
+			   size_t errmsg_len)
+{
+  unsigned int *mine = &caf_sync_images[(caf_this_image - 1) * caf_num_images];
+  int i, status = 0;
+
+  if (count < 0)
+    count = caf_num_images;
+
+  for (i = 0; i < count; i++)
+    {
+      int j = images ? images[i] : i + 1;
+
+      if (unlikely (j < 1 || j > caf_num_images))
+	caf_runtime_error ("Invalid image index %d to SYNC IMAGES", j);
+      if (j != caf_this_image)
+	__atomic_add_fetch (&mine[j - 1], 1, __ATOMIC_RELEASE);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      int j = images ? images[i] : i + 1;
+      unsigned int *theirs, wanted, n;
+
+      if (j == caf_this_image)
+	continue;
+      theirs = &caf_sync_images[(j - 1) * caf_num_images
+				+ caf_this_image - 1];
+      wanted = mine[j - 1];
+      for (n = 0;
+	   (int) (__atomic_load_n (theirs, __ATOMIC_ACQUIRE) - wanted) < 0;
+	   n++)
+	{
+	  int st = __atomic_load_n (&caf_ctl->image[j - 1].status,
+				    __ATOMIC_ACQUIRE);
+	  if (st != 0)
+	    {
+	      if (status != CAF_STAT_FAILED_IMAGE)
+		status = st;
+	      break;
+	    }
+	  caf_relax (n);
+	}
+    }
+
+  caf_report (status, caf_status_msg (status), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_stop_numeric (int stop_code, bool quiet)
+{
+  if (!quiet)
+    fprintf (stderr, "STOP %d\n", stop_code);
+  caf_set_status (CAF_STAT_STOPPED_IMAGE);
+  exit (0);
+}
+
+
+void
+_gfortran_caf_stop_str (const char *string, size_t len, bool quiet)
+{
+  if (!quiet)
+    {
+      fputs ("STOP ", stderr);
+      while (len--)
+	fputc (*(string++), stderr);
+      fputs ("\n", stderr);
+    }
+  caf_set_status (CAF_STAT_STOPPED_IMAGE);
+  exit (0);
+}
+
+
+void
+_gfortran_caf_error_stop_str (const char *string, size_t len, bool quiet)
+{
+  if (!quiet)
+    {
+      fputs ("ERROR STOP ", stderr);
+      while (len--)
+	fputc (*(string++), stderr);
+      fputs ("\n", stderr);
+    }
+  caf_error_stop (1);
+}
+
+
+void
+_gfortran_caf_error_stop (int error, bool quiet)
+{
+  if (!quiet)
+    fprintf (stderr, "ERROR STOP %d\n", error);
+  caf_error_stop (error);
+}
+
+
+void
+_gfortran_caf_fail_image (void)
+{
+  fputs ("IMAGE FAILED!\n", stderr);
+  caf_set_status (CAF_STAT_FAILED_IMAGE);
+  exit (0);
+}
+
+
+int
+_gfortran_caf_image_status (int image,
+			    caf_team_t * team __attribute__ ((unused)))
+{
+  if (unlikely (image < 1 || image > caf_num_images))
+    caf_runtime_error ("Image index %d is not in the range 1 to %d", image,
+		       caf_num_images);
+  return __atomic_load_n (&caf_ctl->image[image - 1].status,
+			  __ATOMIC_ACQUIRE);
+}
+
+
+/* Set ARRAY to the indices of the images with STATUS, as integers of
+   kind *KIND.  */
+
+static void
+caf_images_with_status (gfc_descriptor_t *array, int status, int *kind)
+{
+  int local_kind = kind != NULL ? *kind : 4;
+  int i, n = 0;
+  char *p;
+
+  array->base_addr = NULL;
+  array->dtype.type = BT_INTEGER;
+  array->dtype.elem_len = local_kind;
+  array->dim[0].lower_bound = 0;
+  array->dim[0]._stride = 1;
+  array->offset = 0;
+
+  for (i = 0; i < caf_num_images; i++)
+    if (__atomic_load_n (&caf_ctl->image[i].status, __ATOMIC_ACQUIRE)
+	== status)
+      n++;
+  /* Setting lower_bound higher then upper_bound is what the compiler does
+     to indicate an empty array.  */
+  array->dim[0]._ubound = n - 1;
+  if (n == 0)
+    return;
+
+  p = array->base_addr = malloc ((size_t) n * local_kind);
+  if (p == NULL)
+    caf_runtime_error ("Cannot allocate memory");
+  for (i = 0; i < caf_num_images && n > 0; i++)
+    if (__atomic_load_n (&caf_ctl->image[i].status, __ATOMIC_ACQUIRE)
+	== status)
+      {
+	switch (local_kind)
+	  {
+	  case 1: *(int8_t *) p = i + 1; break;
+	  case 2: *(int16_t *) p = i + 1; break;
+	  case 4: *(int32_t *) p = i + 1; break;
+	  case 8: *(int64_t *) p = i + 1; break;
+#ifdef HAVE_GFC_INTEGER_16
+	  case 16: *(GFC_INTEGER_16 *) p = i + 1; break;
+#endif
+	  default:
+	    caf_runtime_error ("Unsupported integer kind %d", local_kind);
+	  }
+	p += local_kind;
+	n--;
+      }
+}
+
+
+void
+_gfortran_caf_failed_images (gfc_descriptor_t *array,
+			     caf_team_t * team __attribute__ ((unused)),
+			     int * kind)
+{
+  caf_images_with_status (array, CAF_STAT_FAILED_IMAGE, kind);
+}
+
+
+void
+_gfortran_caf_stopped_images (gfc_descriptor_t *array,
+			      caf_team_t * team __attribute__ ((unused)),
+			      int * kind)
+{
+  caf_images_with_status (array, CAF_STAT_STOPPED_IMAGE, kind);
+}
+
+
+/* Collectives.  Every image copies its A to a buffer in its memory,
+   which the others read.  */
+
+typedef struct caf_reduction caf_reduction;
+
+struct caf_reduction
+{
+  /* Combine the N elements at X with those at Y, into X.  */
+  void (*combine) (const caf_reduction *, char *x, const char *y, size_t n);
+  /* The size of an element, and the length of a character.  */
+  size_t size, len;
+  /* The OPERATION of CO_REDUCE, and GFC_CAF_* flags saying how to call
+     it.  */
+  void (*opr) (void);
+  int opr_flags;
+};
+
+enum { CAF_SUM, CAF_MIN, CAF_MAX };
+
+
+static size_t
+caf_desc_count (gfc_descriptor_t *desc)
+{
+  size_t n = 1;
+  int d;
+
+  for (d = 0; d < GFC_DESCRIPTOR_RANK (desc); d++)
+    {
+      index_type extent = GFC_DESCRIPTOR_EXTENT (desc, d);
+      if (extent <= 0)
+	return 0;
+      n *= extent;
+    }
+  return n;
+}
+
+
+/* Copy the elements of DESC, in array element order, to BUF, or from it
+   if UNPACK.  */
+
+static void
+caf_desc_copy (gfc_descriptor_t *desc, char *buf, bool unpack)
+{
+  size_t size = GFC_DESCRIPTOR_SIZE (desc), count = caf_desc_count (desc);
+  int rank = GFC_DESCRIPTOR_RANK (desc), d;
+  index_type stride = 1;
+  size_t i;
+
+  for (d = 0; d < rank; d++)
+    {
+      if (GFC_DESCRIPTOR_STRIDE (desc, d) != stride)
+	break;
+      stride *= GFC_DESCRIPTOR_EXTENT (desc, d);
+    }
+  if (d == rank)
+    {
+      if (unpack)
+	memcpy (GFC_DESCRIPTOR_DATA (desc), buf, count * size);
+      else
+	memcpy (buf, GFC_DESCRIPTOR_DATA (desc), count * size);
+      return;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      ptrdiff_t offset = 0;
+      size_t k = i;
+      char *elem;
+
+      for (d = 0; d < rank; d++)
+	{
+	  index_type extent = GFC_DESCRIPTOR_EXTENT (desc, d);
+	  offset += (k % extent) * GFC_DESCRIPTOR_STRIDE (desc, d);
+	  k /= extent;
+	}
+      elem = (char *) GFC_DESCRIPTOR_DATA (desc) + offset * size;
+      if (unpack)
+	memcpy (elem, buf + i * size, size);
+      else
+	memcpy (buf + i * size, elem, size);
+    }
+}
+
+
+static void *
+caf_collective_buffer (size_t size)
+{
+  void *buf = caf_heap_alloc (CAF_ASYMMETRIC, size);
+
+  if (buf == NULL)
+    caf_runtime_error ("Not enough shared memory for a collective of %lu "
+		       "bytes; see GFORTRAN_SHARED_MEMORY_SIZE",
+		       (unsigned long) size);
+  return buf;
+}
+
+
+/* Combine A over all images with R, leaving the result in A on image
+   RESULT_IMAGE, or on all images if that is zero.  Each image combines
+   the elements of its share of A into the buffer of image 1, in the
+   order of the images, and the result is then copied from there.  */
+
+static void
+caf_reduce (gfc_descriptor_t *a, const caf_reduction *r, int result_image,
+	    int *stat, char *errmsg, size_t errmsg_len)
+{
+  size_t count = caf_desc_count (a), size = GFC_DESCRIPTOR_SIZE (a);
+  size_t share = count / caf_num_images, rest = count % caf_num_images;
+  size_t me = caf_this_image - 1, lo, hi;
+  caf_image_state *image = caf_ctl->image;
+  char *buf;
+  int status, st, i;
+
+  if (unlikely (result_image < 0 || result_image > caf_num_images))
+    caf_runtime_error ("Invalid result image %d", result_image);
+
+  buf = caf_collective_buffer (count * size);
+  caf_desc_copy (a, buf, false);
+  image[me].collective = buf;
+
+  lo = me * share + (me < rest ? me : rest);
+  hi = lo + share + (me < rest);
+  status = caf_barrier ();
+  if (status == 0 && lo < hi)
+    for (i = 1; i < caf_num_images; i++)
+      r->combine (r, image[0].collective + lo * size,
+		  image[i].collective + lo * size, hi - lo);
+
+  st = caf_barrier ();
+  if (status == 0)
+    status = st;
+  if (status == 0 && (result_image == 0 || result_image == caf_this_image))
+    caf_desc_copy (a, image[0].collective, true);
+
+  /* Image 1 keeps its buffer until the others have copied the result.  */
+  st = caf_barrier ();
+  if (status == 0)
+    status = st;
+  image[me].collective = NULL;
+  caf_heap_free (CAF_ASYMMETRIC, buf);
+  caf_report (status, caf_status_msg (status), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_co_broadcast (gfc_descriptor_t *a, int source_image, int *stat,
+			    char *errmsg, size_t errmsg_len)
+{
+  size_t size = caf_desc_count (a) * GFC_DESCRIPTOR_SIZE (a);
+  char *buf = NULL;
+  int status, st;
+
+  if (unlikely (source_image < 1 || source_image > caf_num_images))
+    caf_runtime_error ("Invalid source image %d", source_image);
+
+  if (source_image == caf_this_image)
+    {
+      buf = caf_collective_buffer (size);
+      caf_desc_copy (a, buf, false);
+      caf_ctl->image[caf_this_image - 1].collective = buf;
+    }
+
+  status = caf_barrier ();
+  if (status == 0 && source_image != caf_this_image)
+    caf_desc_copy (a, caf_ctl->image[source_image - 1].collective, true);
+
+  /* The source keeps its buffer until the others have copied it.  */
+  st = caf_barrier ();
+  if (status == 0)
+    status = st;
+  if (buf)
+    {
+      caf_ctl->image[caf_this_image - 1].collective = NULL;
+      caf_heap_free (CAF_ASYMMETRIC, buf);
+    }
+  caf_report (status, caf_status_msg (status), stat, errmsg, errmsg_len);
+}
+
+
+#define CAF_ARITH(suffix, type) \
+static void \
+caf_sum_##suffix (const caf_reduction *r __attribute__ ((unused)), \
+		  char *x, const char *y, size_t n) \
+{ \
+  type *a = (type *) x; \
+  const type *b = (const type *) y; \
+  size_t i; \
+  for (i = 0; i < n; i++) \
+    a[i] += b[i]; \
+} \
+ \
+static void \
+caf_min_##suffix (const caf_reduction *r __attribute__ ((unused)), \
+		  char *x, const char *y, size_t n) \
+{ \
+  type *a = (type *) x; \
+  const type *b = (const type *) y; \
+  size_t i; \
+  for (i = 0; i < n; i++) \
+    if (b[i] < a[i]) \
+      a[i] = b[i]; \
+} \
+ \
+static void \
+caf_max_##suffix (const caf_reduction *r __attribute__ ((unused)), \
+		  char *x, const char *y, size_t n) \
+{ \
+  type *a = (type *) x; \
+  const type *b = (const type *) y; \
+  size_t i; \
+  for (i = 0; i < n; i++) \
+    if (b[i] > a[i]) \
+      a[i] = b[i]; \
+}
+
+#define CAF_COMPLEX_SUM(suffix, type) \
+static void \
+caf_sum_##suffix (const caf_reduction *r __attribute__ ((unused)), \
+		  char *x, const char *y, size_t n) \
+{ \
+  type *a = (type *) x; \
+  const type *b = (const type *) y; \
+  size_t i; \
+  for (i = 0; i < n; i++) \
+    a[i] += b[i]; \
+}
+
+/* Call the OPERATION of CO_REDUCE, for a function result of TYPE.  */
+#define CAF_USER_OP(suffix, type) \
+static void \
+caf_user_##suffix (const caf_reduction *r, char *x, const char *y, \
+		   size_t n) \
+{ \
+  type *a = (type *) x; \
+  type *b = (type *) y; \
+  size_t i; \
+  if (r->opr_flags & GFC_CAF_ARG_VALUE) \
+    for (i = 0; i < n; i++) \
+      a[i] = ((type (*) (type, type)) r->opr) (a[i], b[i]); \
+  else \
+    for (i = 0; i < n; i++) \
+      a[i] = ((type (*) (type *, type *)) r->opr) (&a[i], &b[i]); \
+}
+
+CAF_ARITH (i1, GFC_INTEGER_1)
+CAF_ARITH (i2, GFC_INTEGER_2)
+CAF_ARITH (i4, GFC_INTEGER_4)
+CAF_ARITH (i8, GFC_INTEGER_8)
+CAF_ARITH (r4, GFC_REAL_4)
+CAF_ARITH (r8, GFC_REAL_8)
+CAF_COMPLEX_SUM (c4, GFC_COMPLEX_4)
+CAF_COMPLEX_SUM (c8, GFC_COMPLEX_8)
+CAF_USER_OP (i1, GFC_INTEGER_1)
+CAF_USER_OP (i2, GFC_INTEGER_2)
+CAF_USER_OP (i4, GFC_INTEGER_4)
+CAF_USER_OP (i8, GFC_INTEGER_8)
+CAF_USER_OP (r4, GFC_REAL_4)
+CAF_USER_OP (r8, GFC_REAL_8)
+CAF_USER_OP (c4, GFC_COMPLEX_4)
+CAF_USER_OP (c8, GFC_COMPLEX_8)
+#ifdef HAVE_GFC_INTEGER_16
+CAF_ARITH (i16, GFC_INTEGER_16)
+CAF_USER_OP (i16, GFC_INTEGER_16)
+#endif
+#ifdef HAVE_GFC_REAL_10
+CAF_ARITH (r10, GFC_REAL_10)
+CAF_COMPLEX_SUM (c10, GFC_COMPLEX_10)
+CAF_USER_OP (r10, GFC_REAL_10)
+CAF_USER_OP (c10, GFC_COMPLEX_10)
+#endif
+#ifdef HAVE_GFC_REAL_16
+CAF_ARITH (r16, GFC_REAL_16)
+CAF_COMPLEX_SUM (c16, GFC_COMPLEX_16)
+CAF_USER_OP (r16, GFC_REAL_16)
+CAF_USER_OP (c16, GFC_COMPLEX_16)
+#endif
+
+
+/* The kind of REAL or COMPLEX elements of SIZE bytes, or zero if there is
+   none.  The descriptor only gives the size, and on some targets
+   REAL(10) and REAL(16) have the same one, so that neither can be
+   handled.  */
+
+static int
+caf_real_kind (int type, size_t size)
+{
+  if (type == BT_COMPLEX)
+    size /= 2;
+  if (size == sizeof (GFC_REAL_4))
+    return 4;
+  if (size == sizeof (GFC_REAL_8))
+    return 8;
+#if defined (HAVE_GFC_REAL_10) && defined (HAVE_GFC_REAL_16)
+  if (sizeof (GFC_REAL_10) == sizeof (GFC_REAL_16))
+    return 0;
+#endif
+#ifdef HAVE_GFC_REAL_10
+  if (size == sizeof (GFC_REAL_10))
+    return 10;
+#endif
+#ifdef HAVE_GFC_REAL_16
+  if (size == sizeof (GFC_REAL_16))
+    return 16;
+#endif
+  return 0;
+}
+
+
+#define CAF_PICK(suffix) \
+  (op == CAF_SUM ? caf_sum_##suffix \
+   : op == CAF_MIN ? caf_min_##suffix : caf_max_##suffix)
+
+/* The function doing OP on elements of TYPE and SIZE, or NULL.  */
+
+static void (*
+caf_arith_combine (int op, int type, size_t size))
+  (const caf_reduction *, char *, const char *, size_t)
+{
+  switch (type)
+    {
+    case BT_INTEGER:
+      switch (size)
+	{
+	case 1: return CAF_PICK (i1);
+	case 2: return CAF_PICK (i2);
+	case 4: return CAF_PICK (i4);
+	case 8: return CAF_PICK (i8);
+#ifdef HAVE_GFC_INTEGER_16
+	case 16: return CAF_PICK (i16);
+#endif
+	}
+      break;
+    case BT_REAL:
+      switch (caf_real_kind (type, size))
+	{
+	case 4: return CAF_PICK (r4);
+	case 8: return CAF_PICK (r8);
+#ifdef HAVE_GFC_REAL_10
+	case 10: return CAF_PICK (r10);
+#endif
+#ifdef HAVE_GFC_REAL_16
+	case 16: return CAF_PICK (r16);
+#endif
+	}
+      break;
+    case BT_COMPLEX:
+      if (op != CAF_SUM)
+	break;
+      switch (caf_real_kind (type, size))
+	{
+	case 4: return caf_sum_c4;
+	case 8: return caf_sum_c8;
+#ifdef HAVE_GFC_REAL_10
+	case 10: return caf_sum_c10;
+#endif
+#ifdef HAVE_GFC_REAL_16
+	case 16: return caf_sum_c16;
+#endif
+	}
+      break;
+    }
+  return NULL;
+}
+
+#undef CAF_PICK
+
+
+/* MIN and MAX of characters of length R->len, of kind 1 or 4.  */
+
+static void
+caf_minmax_char (const caf_reduction *r, char *x, const char *y, size_t n,
+		 bool max)
+{
+  size_t i, j;
+
+  for (i = 0; i < n; i++, x += r->size, y += r->size)
+    {
+      int cmp = 0;
+
+      if (r->size == r->len)
+	cmp = memcmp (y, x, r->size);
+      else
+	{
+	  const uint32_t *a = (const uint32_t *) x, *b = (const uint32_t *) y;
+	  for (j = 0; j < r->len && cmp == 0; j++)
+	    cmp = b[j] < a[j] ? -1 : b[j] > a[j];
+	}
+      if (max ? cmp > 0 : cmp < 0)
+	memcpy (x, y, r->size);
+    }
+}
+
+
+static void
+caf_min_char (const caf_reduction *r, char *x, const char *y, size_t n)
+{
+  caf_minmax_char (r, x, y, n, false);
+}
+
+
+static void
+caf_max_char (const caf_reduction *r, char *x, const char *y, size_t n)
+{
+  caf_minmax_char (r, x, y, n, true);
+}
+
+
+/* Call the OPERATION of CO_REDUCE for a function that returns its
+   result by reference.  */
+
+static void
+caf_user_byref (const caf_reduction *r, char *x, const char *y, size_t n)
+{
+  char *res = __builtin_alloca (r->size);
+  size_t i;
+
+  for (i = 0; i < n; i++, x += r->size, y += r->size)
+    {
+      if (r->opr_flags & GFC_CAF_HIDDENLEN)
+	((void (*) (void *, size_t, void *, void *, size_t, size_t)) r->opr)
+	  (res, r->len, x, (void *) y, r->len, r->len);
+      else
+	((void (*) (void *, void *, void *)) r->opr) (res, x, (void *) y);
+      memcpy (x, res, r->size);
+    }
+}
+
+
+static void
+caf_co_arith (gfc_descriptor_t *a, int op, const char *name,
+	      int result_image, int *stat, char *errmsg, int a_len,
+	      size_t errmsg_len)
+{
+  caf_reduction r = { NULL, GFC_DESCRIPTOR_SIZE (a), 0, NULL, 0 };
+
+  if (GFC_DESCRIPTOR_TYPE (a) == BT_CHARACTER && op != CAF_SUM)
+    {
+      r.len = a_len;
+      if (a_len > 0 && (r.size == r.len || r.size == 4 * r.len))
+	r.combine = op == CAF_MIN ? caf_min_char : caf_max_char;
+    }
+  else
+    r.combine = caf_arith_combine (op, GFC_DESCRIPTOR_TYPE (a), r.size);
+
+  if (r.combine == NULL)
+    caf_runtime_error ("%s of type %d and size %lu is not supported", name,
+		       GFC_DESCRIPTOR_TYPE (a), (unsigned long) r.size);
+  caf_reduce (a, &r, result_image, stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_co_sum (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, size_t errmsg_len)
+{
+  caf_co_arith (a, CAF_SUM, "CO_SUM", result_image, stat, errmsg, 0,
+		errmsg_len);
+}
+
+
+void
+_gfortran_caf_co_min (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, int a_len, size_t errmsg_len)
+{
+  caf_co_arith (a, CAF_MIN, "CO_MIN", result_image, stat, errmsg, a_len,
+		errmsg_len);
+}
+
+
+void
+_gfortran_caf_co_max (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, int a_len, size_t errmsg_len)
+{
+  caf_co_arith (a, CAF_MAX, "CO_MAX", result_image, stat, errmsg, a_len,
+		errmsg_len);
+}
+
+
+void
+_gfortran_caf_co_reduce (gfc_descriptor_t *a, void * (*opr) (void *, void *),
+			 int opr_flags, int result_image, int *stat,
+			 char *errmsg, int a_len, size_t errmsg_len)
+{
+  caf_reduction r = { NULL, GFC_DESCRIPTOR_SIZE (a), a_len,
+		      (void (*) (void)) opr, opr_flags };
+  int type = GFC_DESCRIPTOR_TYPE (a);
+
+  /* The front end does not always set GFC_CAF_HIDDENLEN, but a character
+     function that returns its result by reference takes the lengths.  */
+  if ((opr_flags & GFC_CAF_BYREF) && type == BT_CHARACTER)
+    r.opr_flags |= GFC_CAF_HIDDENLEN;
+
+  if (opr_flags & GFC_CAF_BYREF)
+    r.combine = caf_user_byref;
+  else if (type == BT_INTEGER || type == BT_LOGICAL)
+    switch (r.size)
+      {
+      case 1: r.combine = caf_user_i1; break;
+      case 2: r.combine = caf_user_i2; break;
+      case 4: r.combine = caf_user_i4; break;
+      case 8: r.combine = caf_user_i8; break;
+#ifdef HAVE_GFC_INTEGER_16
+      case 16: r.combine = caf_user_i16; break;
+#endif
+      }
+  else if (type == BT_REAL || type == BT_COMPLEX)
+    switch (caf_real_kind (type, r.size))
+      {
+      case 4: r.combine = type == BT_REAL ? caf_user_r4 : caf_user_c4; break;
+      case 8: r.combine = type == BT_REAL ? caf_user_r8 : caf_user_c8; break;
+#ifdef HAVE_GFC_REAL_10
+      case 10:
+	r.combine = type == BT_REAL ? caf_user_r10 : caf_user_c10;
+	break;
+#endif
+#ifdef HAVE_GFC_REAL_16
+      case 16:
+	r.combine = type == BT_REAL ? caf_user_r16 : caf_user_c16;
+	break;
+#endif
+      }
+
+  /* Derived types returned by value cannot be handled here.  */
+  if (r.combine == NULL || (opr_flags & GFC_CAF_ARG_DESC))
+    caf_runtime_error ("CO_REDUCE of type %d and size %lu is not supported",
+		       type, (unsigned long) r.size);
+  caf_reduce (a, &r, result_image, stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_event_wait (caf_token_t token, size_t index, int until_count,
+			  int *stat, char *errmsg __attribute__ ((unused)),
+			  size_t errmsg_len __attribute__ ((unused)))
+{
+  uint32_t *event = (uint32_t *) ((char *) MEMTOK (token) + index
+				  * sizeof (uint32_t));
+  uint32_t wanted = until_count > 1 ? until_count : 1;
+  unsigned int n;
+
+  /* Only this image takes from the count, others only add to it.  */
+  for (n = 0; __atomic_load_n (event, __ATOMIC_ACQUIRE) < wanted; n++)
+    caf_relax (n);
+  __atomic_fetch_sub (event, wanted, __ATOMIC_RELAXED);
+
+  if (stat)
+    *stat = 0;
+}
+
+
+void
+_gfortran_caf_lock (caf_token_t token, size_t index, int image_index,
+		    int *acquired_lock, int *stat, char *errmsg,
+		    size_t errmsg_len)
+{
+  SET_IMAGE_TOKEN (token, image_index);
+
+  int *lock = &((int *) MEMTOK (token))[index];
+  unsigned int n;
+
+  for (n = 0;; n++)
+    {
+      int holder = 0;
+
+      if (__atomic_compare_exchange_n (lock, &holder, caf_this_image, false,
+				       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	break;
+      if (holder == caf_this_image)
+	{
+	  caf_report (CAF_STAT_LOCKED, "Already locked by this image", stat,
+		      errmsg, errmsg_len);
+	  return;
+	}
+      if (acquired_lock)
+	{
+	  *acquired_lock = (int) false;
+	  if (stat)
+	    *stat = 0;
+	  return;
+	}
+      caf_relax (n);
+    }
+
+  if (acquired_lock)
+    *acquired_lock = (int) true;
+  if (stat)
+    *stat = 0;
+}
+
+
+void
+_gfortran_caf_unlock (caf_token_t token, size_t index, int image_index,
+		      int *stat, char *errmsg, size_t errmsg_len)
+{
+  SET_IMAGE_TOKEN (token, image_index);
+
+  int *lock = &((int *) MEMTOK (token))[index];
+  int holder = caf_this_image;
+
+  if (__atomic_compare_exchange_n (lock, &holder, 0, false, __ATOMIC_RELEASE,
+				   __ATOMIC_RELAXED))
+    {
+      if (stat)
+	*stat = 0;
+      return;
+    }
+
+  if (holder == 0)
+    caf_report (1, "Variable is not locked", stat, errmsg, errmsg_len);
+  else
+    caf_report (CAF_STAT_LOCKED_OTHER_IMAGE,
+		"Variable is locked by another image", stat, errmsg,
+		errmsg_len);
+}
+
+#endif /* CAF_SHMEM  */
@@ -50,6 +50,28 @@ typedef struct caf_single_token *caf_single_token_t;
 #define TOKEN(X) ((caf_single_token_t) (X))
 #define MEMTOK(X) ((caf_single_token_t) (X))->memptr
 
+#ifdef CAF_SHMEM
+/* libcaf_shmem (shmem.c) includes this file for everything that only
+   moves data.  All images see the memory of all images, at the same
+   address in every image, so a token of another image is a token of
+   this one with the addresses moved.  SET_IMAGE_TOKEN makes TOKEN the
+   token of image IMAGE_INDEX for the rest of the function.  */
+typedef struct
+{
+  struct caf_single_token token;
+  GFC_FULL_ARRAY_DESCRIPTOR (GFC_MAX_DIMENSIONS, void) desc;
+} caf_image_token_t;
+
+static caf_token_t caf_shmem_image_token (caf_token_t, int,
+					  caf_image_token_t *);
+
+#define SET_IMAGE_TOKEN(token, image_index) \
+  caf_image_token_t token##_image; \
+  token = caf_shmem_image_token (token, image_index, &token##_image)
+#else
+#define SET_IMAGE_TOKEN(token, image_index) do { } while (0)
+#endif
+
 /* Single-image implementation of the CAF library.
    Note: For performance reasons -fcoarry=single should be used
    rather than this library.  */
@@ -97,6 +119,7 @@ caf_internal_error (const char *msg, int *stat, char *errmsg,
 }
 
 
+#ifndef CAF_SHMEM
 void
 _gfortran_caf_init (int *argc __attribute__ ((unused)),
 		    char ***argv __attribute__ ((unused)))
@@ -437,6 +460,7 @@ _gfortran_caf_co_reduce (gfc_descriptor_t *a __attribute__ ((unused)),
      *stat = 0;
  }
 
+#endif /* !CAF_SHMEM  */
 
 static void
 assign_char4_from_char1 (size_t dst_size, size_t src_size, uint32_t *dst,
@@ -741,6 +765,8 @@ _gfortran_caf_get (caf_token_t token, size_t offset,
   size_t src_size = GFC_DESCRIPTOR_SIZE (src);
   size_t dst_size = GFC_DESCRIPTOR_SIZE (dest);
 
+  SET_IMAGE_TOKEN (token, image_index);
+
   if (stat)
     *stat = 0;
 
@@ -934,6 +960,8 @@ _gfortran_caf_send (caf_token_t token, size_t offset,
   size_t src_size = GFC_DESCRIPTOR_SIZE (src);
   size_t dst_size = GFC_DESCRIPTOR_SIZE (dest);
 
+  SET_IMAGE_TOKEN (token, image_index);
+
   if (stat)
     *stat = 0;
 
@@ -1141,6 +1169,7 @@ _gfortran_caf_sendget (caf_token_t dst_token, size_t dst_offset,
   /* FIXME: Handle vector subscript of 'src_vector'.  */
   /* For a single image, src->base_addr should be the same as src_token + offset
      but to play save, we do it properly.  */
+  SET_IMAGE_TOKEN (src_token, src_image_index);
   void *src_base = GFC_DESCRIPTOR_DATA (src);
   GFC_DESCRIPTOR_DATA (src) = (void *) ((char *) MEMTOK (src_token)
 					+ src_offset);
@@ -1547,6 +1576,8 @@ _gfortran_caf_get_by_ref (caf_token_t token,
 			  bool dst_reallocatable, int *stat,
 			  int src_type)
 {
+  SET_IMAGE_TOKEN (token, image_index);
+
   const char vecrefunknownkind[] = "libcaf_single::caf_get_by_ref(): "
 				   "unknown kind in vector-ref.\n";
   const char unknownreftype[] = "libcaf_single::caf_get_by_ref(): "
@@ -2436,6 +2467,8 @@ _gfortran_caf_send_by_ref (caf_token_t token,
 			   bool may_require_tmp __attribute__ ((unused)),
 			   bool dst_reallocatable, int *stat, int dst_type)
 {
+  SET_IMAGE_TOKEN (token, image_index);
+
   const char vecrefunknownkind[] = "libcaf_single::caf_get_by_ref(): "
 				   "unknown kind in vector-ref.\n";
   const char unknownreftype[] = "libcaf_single::caf_send_by_ref(): "
@@ -2833,6 +2866,7 @@ _gfortran_caf_atomic_define (caf_token_t token, size_t offset,
 			     void *value, int *stat,
 			     int type __attribute__ ((unused)), int kind)
 {
+  SET_IMAGE_TOKEN (token, image_index);
   assert(kind == 4);
 
   uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
@@ -2849,6 +2883,7 @@ _gfortran_caf_atomic_ref (caf_token_t token, size_t offset,
 			  void *value, int *stat,
 			  int type __attribute__ ((unused)), int kind)
 {
+  SET_IMAGE_TOKEN (token, image_index);
   assert(kind == 4);
 
   uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
@@ -2866,6 +2901,7 @@ _gfortran_caf_atomic_cas (caf_token_t token, size_t offset,
 			  void *old, void *compare, void *new_val, int *stat,
 			  int type __attribute__ ((unused)), int kind)
 {
+  SET_IMAGE_TOKEN (token, image_index);
   assert(kind == 4);
 
   uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
@@ -2885,6 +2921,7 @@ _gfortran_caf_atomic_op (int op, caf_token_t token, size_t offset,
 			 void *value, void *old, int *stat,
 			 int type __attribute__ ((unused)), int kind)
 {
+  SET_IMAGE_TOKEN (token, image_index);
   assert(kind == 4);
 
   uint32_t res;
@@ -2921,15 +2958,18 @@ _gfortran_caf_event_post (caf_token_t token, size_t index,
 			  int *stat, char *errmsg __attribute__ ((unused)), 
 			  size_t errmsg_len __attribute__ ((unused)))
 {
+  SET_IMAGE_TOKEN (token, image_index);
+
   uint32_t value = 1;
   uint32_t *event = (uint32_t *) ((char *) MEMTOK (token) + index
 				  * sizeof (uint32_t));
-  __atomic_fetch_add (event, (uint32_t) value, __ATOMIC_RELAXED);
+  __atomic_fetch_add (event, (uint32_t) value, __ATOMIC_RELEASE);
   
   if(stat)
     *stat = 0;
 }
 
+#ifndef CAF_SHMEM
 void
 _gfortran_caf_event_wait (caf_token_t token, size_t index, 
 			  int until_count, int *stat,
@@ -2944,12 +2984,15 @@ _gfortran_caf_event_wait (caf_token_t token, size_t index,
    if(stat)
     *stat = 0;    
 }
+#endif /* !CAF_SHMEM  */
 
 void
 _gfortran_caf_event_query (caf_token_t token, size_t index, 
 			   int image_index __attribute__ ((unused)), 
 			   int *count, int *stat)
 {
+  SET_IMAGE_TOKEN (token, image_index);
+
   uint32_t *event = (uint32_t *) ((char *) MEMTOK (token) + index
 				  * sizeof (uint32_t));
   __atomic_load (event, (uint32_t *) count, __ATOMIC_RELAXED);
@@ -2958,6 +3001,7 @@ _gfortran_caf_event_query (caf_token_t token, size_t index,
     *stat = 0;
 }
 
+#ifndef CAF_SHMEM
 void
 _gfortran_caf_lock (caf_token_t token, size_t index,
 		    int image_index __attribute__ ((unused)),
@@ -3034,12 +3078,15 @@ _gfortran_caf_unlock (caf_token_t token, size_t index,
     }
   _gfortran_caf_error_stop_str (msg, strlen (msg), false);
 }
+#endif /* !CAF_SHMEM  */
 
 int
 _gfortran_caf_is_present (caf_token_t token,
 			  int image_index __attribute__ ((unused)),
 			  caf_reference_t *refs)
 {
+  SET_IMAGE_TOKEN (token, image_index);
+
   const char arraddressingnotallowed[] = "libcaf_single::caf_is_present(): "
 				   "only scalar indexes allowed.\n";
   const char unknownreftype[] = "libcaf_single::caf_get_by_ref(): "
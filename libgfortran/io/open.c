@@ -663,7 +663,11 @@ new_unit (st_parameter_open *opp, gfc_unit *u, unit_flags *flags)
 
   /* Check if asynchrounous.  */
   if (flags->async == ASYNC_YES)
-    init_async_unit (u);
+    {
+      init_async_unit (u);
+      if (u->au)
+	stream_set_async (u->s);
+    }
   else
     u->au = NULL;
 
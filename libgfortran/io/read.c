@@ -119,6 +119,125 @@ si_max (int length)
 }
 
 
+/* convert_real_fast()-- Convert BUFFER, a decimal number without
+   blanks as built by read_f and the list-directed readers, to a REAL(4)
+   or REAL(8) in DEST.  When the significand is exact in the target type
+   and the power of ten is too, a single multiplication or division
+   gives the correctly rounded result in the current rounding mode
+   (Clinger's fast path) and strtod is not needed.  Returns nonzero if
+   the value was converted.  */
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+
+static int
+convert_real_fast (void *dest, const char *buffer, int length)
+{
+  static const double pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const char *p = buffer;
+  GFC_UINTEGER_8 mant = 0;
+  int ndigits = 0, exponent = 0, exp10 = 0;
+  int negative = 0, exp_negative = 0, seen_digit = 0;
+
+  if (*p == '+' || *p == '-')
+    negative = *p++ == '-';
+
+  for (; isdigit (*p); p++)
+    {
+      seen_digit = 1;
+      if (mant == 0 && *p == '0')
+	continue;
+      if (++ndigits > 19)
+	return 0;
+      mant = mant * 10 + (*p - '0');
+    }
+
+  if (*p == '.')
+    for (p++; isdigit (*p); p++)
+      {
+	seen_digit = 1;
+	exponent--;
+	if (mant == 0 && *p == '0')
+	  continue;
+	if (++ndigits > 19)
+	  return 0;
+	mant = mant * 10 + (*p - '0');
+      }
+
+  if (!seen_digit)
+    return 0;
+
+  switch (*p)
+    {
+    case 'e':
+    case 'E':
+    case 'd':
+    case 'D':
+    case 'q':
+    case 'Q':
+      p++;
+      if (*p == '+' || *p == '-')
+	exp_negative = *p++ == '-';
+      if (!isdigit (*p))
+	return 0;
+      for (; isdigit (*p); p++)
+	if (exp10 < 10000)
+	  exp10 = exp10 * 10 + (*p - '0');
+      exponent += exp_negative ? -exp10 : exp10;
+      break;
+    default:
+      break;
+    }
+
+  if (*p != '\0')
+    return 0;
+
+  switch (length)
+    {
+    case 4:
+      {
+	GFC_REAL_4 r;
+
+	if (mant > ((GFC_UINTEGER_8) 1 << 24)
+	    || exponent < -10 || exponent > 10)
+	  return 0;
+	/* Apply the sign first, so that directed rounding goes the
+	   right way.  */
+	r = negative ? -(GFC_REAL_4) mant : (GFC_REAL_4) mant;
+	if (exponent < 0)
+	  r /= (GFC_REAL_4) pow10[-exponent];
+	else
+	  r *= (GFC_REAL_4) pow10[exponent];
+	*((GFC_REAL_4 *) dest) = r;
+	return 1;
+      }
+
+    case 8:
+      {
+	GFC_REAL_8 r;
+
+	if (mant > ((GFC_UINTEGER_8) 1 << 53)
+	    || exponent < -22 || exponent > 22)
+	  return 0;
+	r = negative ? -(GFC_REAL_8) mant : (GFC_REAL_8) mant;
+	if (exponent < 0)
+	  r /= pow10[-exponent];
+	else
+	  r *= pow10[exponent];
+	*((GFC_REAL_8 *) dest) = r;
+	return 1;
+      }
+
+    default:
+      return 0;
+    }
+}
+
+#endif
+
+
 /* convert_real()-- Convert a character representation of a floating
    point number to the machine number.  Returns nonzero if there is an
    invalid input.  Note: many architectures (e.g. IA-64, HP-PA)
@@ -146,7 +265,17 @@ convert_real (st_parameter_dt *dtp, void *dest, const char *buffer, int length)
     }
 
   old_round_mode = get_fpu_rounding_mode();
-  set_fpu_rounding_mode (round_mode);
+  if (round_mode != old_round_mode)
+    set_fpu_rounding_mode (round_mode);
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  if (convert_real_fast (dest, buffer, length))
+    {
+      if (round_mode != old_round_mode)
+	set_fpu_rounding_mode (old_round_mode);
+      return 0;
+    }
+#endif
 
   switch (length)
     {
@@ -185,7 +314,8 @@ convert_real (st_parameter_dt *dtp, void *dest, const char *buffer, int length)
       internal_error (&dtp->common, "Unsupported real kind during IO");
     }
 
-  set_fpu_rounding_mode (old_round_mode);
+  if (round_mode != old_round_mode)
+    set_fpu_rounding_mode (old_round_mode);
 
   if (buffer == endptr)
     {
@@ -218,6 +218,8 @@ typedef struct
   ino_t st_ino;
 
   bool unbuffered;  /* Buffer should be flushed after each I/O statement.  */
+
+  int nrequests;    /* Concurrent requests for large transfers, or 0.  */
 }
 unix_stream;
 
@@ -308,9 +310,152 @@ raw_flush (unix_stream *s  __attribute__ ((unused)))
    larger than 2 GB as well.  */
 #define MAX_CHUNK 2147479552
 
+/* Large transfers on streams of units opened with ASYNCHRONOUS='YES'
+   are split into up to S->NREQUESTS pieces of at least
+   PARALLEL_MIN_CHUNK bytes that are transferred concurrently with
+   pread or pwrite, directly from or to the user's array.  This keeps
+   several requests outstanding, which matters on file systems that
+   stripe a file over many servers.  The asynchronous unit's thread
+   issues one of the requests itself and helper threads the rest.  */
+
+#if ASYNC_IO && defined(HAVE_PREAD) && defined(HAVE_PWRITE)
+
+#define PARALLEL_IO 1
+#define PARALLEL_MAX_REQUESTS 16
+#define PARALLEL_MIN_CHUNK (4 << 20)
+
+typedef struct
+{
+  int fd;
+  bool is_write;
+  char *buf;
+  ssize_t nbyte;
+  gfc_offset offset;
+  ssize_t done;
+  int err;
+}
+parallel_request;
+
+static void *
+parallel_transfer (void *arg)
+{
+  parallel_request *r = (parallel_request *) arg;
+
+  while (r->done < r->nbyte)
+    {
+      ssize_t left = r->nbyte - r->done;
+      ssize_t to_do = left < MAX_CHUNK ? left : MAX_CHUNK;
+      ssize_t trans;
+
+      if (r->is_write)
+	trans = pwrite (r->fd, r->buf + r->done, to_do, r->offset + r->done);
+      else
+	trans = pread (r->fd, r->buf + r->done, to_do, r->offset + r->done);
+      if (trans == -1)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  r->err = errno;
+	  break;
+	}
+      if (trans == 0)
+	break;
+      r->done += trans;
+    }
+
+  return NULL;
+}
+
+/* Transfer NBYTE bytes between BUF and the current position of S with
+   concurrent requests, and leave the position after the data, like
+   raw_read or raw_write.  Return -2 without doing anything if the
+   transfer is too small to split.  */
+
+static ssize_t
+raw_parallel (unix_stream *s, char *buf, ssize_t nbyte, bool is_write)
+{
+  parallel_request req[PARALLEL_MAX_REQUESTS];
+  __gthread_t thread[PARALLEL_MAX_REQUESTS];
+  bool started[PARALLEL_MAX_REQUESTS];
+  ssize_t chunk, total;
+  gfc_offset offset;
+  int n, i, err;
+
+  n = s->nrequests;
+  if (nbyte / PARALLEL_MIN_CHUNK < n)
+    n = nbyte / PARALLEL_MIN_CHUNK;
+  if (n < 2)
+    return -2;
+
+  offset = lseek (s->fd, 0, SEEK_CUR);
+  if (offset < 0)
+    return -2;
+
+  /* Split into whole pages.  */
+  chunk = ((nbyte + n - 1) / n + 4095) & ~(ssize_t) 4095;
+  n = (nbyte + chunk - 1) / chunk;
+  for (i = 0; i < n; i++)
+    {
+      req[i].fd = s->fd;
+      req[i].is_write = is_write;
+      req[i].buf = buf + i * chunk;
+      req[i].nbyte = nbyte - i * chunk < chunk ? nbyte - i * chunk : chunk;
+      req[i].offset = offset + i * chunk;
+      req[i].done = 0;
+      req[i].err = 0;
+    }
+
+  for (i = 1; i < n; i++)
+    started[i] = __gthread_create (&thread[i], parallel_transfer,
+				   &req[i]) == 0;
+  parallel_transfer (&req[0]);
+  for (i = 1; i < n; i++)
+    {
+      if (started[i])
+	__gthread_join (thread[i], NULL);
+      else
+	parallel_transfer (&req[i]);
+    }
+
+  /* As for a short read or write, only the data up to the first piece
+     that was not transferred completely counts.  */
+  total = 0;
+  err = 0;
+  for (i = 0; i < n; i++)
+    {
+      total += req[i].done;
+      if (req[i].done < req[i].nbyte)
+	{
+	  err = req[i].err;
+	  break;
+	}
+    }
+
+  if (err != 0 && (is_write || total == 0))
+    {
+      errno = err;
+      return -1;
+    }
+
+  if (lseek (s->fd, offset + total, SEEK_SET) < 0)
+    return -1;
+  return total;
+}
+
+#endif
+
 static ssize_t
 raw_read (unix_stream *s, void *buf, ssize_t nbyte)
 {
+#ifdef PARALLEL_IO
+  if (s->nrequests > 1)
+    {
+      ssize_t trans = raw_parallel (s, (char *) buf, nbyte, false);
+      if (trans != -2)
+	return trans;
+    }
+#endif
+
   /* For read we can't do I/O in a loop like raw_write does, because
      that will break applications that wait for interactive I/O.  We
      still can loop around EINTR, though.  This however causes a
@@ -355,6 +500,15 @@ raw_write (unix_stream *s, const void *buf, ssize_t nbyte)
   ssize_t trans, bytes_left;
   char *buf_st;
 
+#ifdef PARALLEL_IO
+  if (s->nrequests > 1)
+    {
+      trans = raw_parallel (s, (char *) buf, nbyte, true);
+      if (trans != -2)
+	return trans;
+    }
+#endif
+
   bytes_left = nbyte;
   buf_st = (char *) buf;
 
@@ -1159,6 +1313,28 @@ fd_to_stream (int fd, bool unformatted)
 }
 
 
+/* stream_set_async()-- Let large transfers on S, the stream of a unit
+   opened with ASYNCHRONOUS='YES', use concurrent requests if it is a
+   regular file.  */
+
+void
+stream_set_async (stream *st)
+{
+#ifdef PARALLEL_IO
+  unix_stream *s = (unix_stream *) st;
+  struct stat statbuf;
+
+  if (options.async_requests > 1
+      && TEMP_FAILURE_RETRY (fstat (s->fd, &statbuf)) == 0
+      && S_ISREG (statbuf.st_mode))
+    s->nrequests = (options.async_requests < PARALLEL_MAX_REQUESTS
+		    ? options.async_requests : PARALLEL_MAX_REQUESTS);
+#else
+  (void) st;
+#endif
+}
+
+
 /* Given the Fortran unit number, convert it to a C file descriptor.  */
 
 int
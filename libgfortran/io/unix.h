@@ -174,6 +174,9 @@ internal_proto(inquire_readwrite);
 extern void flush_if_preconnected (stream *);
 internal_proto(flush_if_preconnected);
 
+extern void stream_set_async (stream *);
+internal_proto(stream_set_async);
+
 extern int stream_isatty (stream *);
 internal_proto(stream_isatty);
 
@@ -541,6 +541,7 @@ typedef struct
   int all_unbuffered, unbuffered_preconnected;
   int fpe, backtrace;
   int unformatted_buffer_size, formatted_buffer_size;
+  int async_requests;
 }
 options_t;
 
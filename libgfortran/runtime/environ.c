@@ -206,6 +206,9 @@ static variable variable_table[] = {
   { "GFORTRAN_FORMATTED_BUFFER_SIZE", 0, &options.formatted_buffer_size,
     init_integer },
 
+  /* Number of concurrent requests for large asynchronous transfers.  */
+  { "GFORTRAN_ASYNC_REQUESTS", 4, &options.async_requests, init_integer },
+
   { NULL, 0, NULL, NULL }
 };
 
@@ -491,10 +491,19 @@ bool probestackmaps(void)
 extern uint32 __go_runtime_in_callers;
 
 // Cheaper context switch functions.  Currently only defined on
-// Linux/AMD64.
+// Linux/AMD64, Linux/RISCV64 and Linux/ARM64.
 #if defined(__x86_64__) && defined(__linux__) && !defined(__CET__)
+#define __GO_CONTEXT_REGS 8
+#elif defined(__riscv) && __riscv_xlen == 64 && defined(__linux__)
+#define __GO_CONTEXT_REGS 26
+#elif defined(__aarch64__) && defined(__linux__) \
+    && !defined(__ARM_FEATURE_BTI_DEFAULT) && !defined(__ARM_FEATURE_PAC_DEFAULT)
+#define __GO_CONTEXT_REGS 21
+#endif
+
+#ifdef __GO_CONTEXT_REGS
 typedef struct {
-	uint64 regs[8];
+	uint64 regs[__GO_CONTEXT_REGS];
 } __go_context_t;
 int __go_getcontext(__go_context_t*);
 int __go_setcontext(__go_context_t*);
@@ -33,6 +33,20 @@
 
 #define omp_max_predefined_alloc omp_thread_mem_alloc
 
+/* Configurations can override these to implement memory spaces and the
+   pinned and partition traits.  MEMSPACE_ALLOC must return memory that
+   MEMSPACE_FREE with the same arguments can release.  */
+#ifndef MEMSPACE_ALLOC
+#define MEMSPACE_ALLOC(MEMSPACE, SIZE, PIN, PARTITION) malloc (SIZE)
+#endif
+#ifndef MEMSPACE_FREE
+#define MEMSPACE_FREE(MEMSPACE, ADDR, SIZE, PIN, PARTITION) free (ADDR)
+#endif
+/* Nonzero if MEMSPACE_ALLOC supports the pinned trait.  */
+#ifndef MEMSPACE_PINNED_SUPPORTED
+#define MEMSPACE_PINNED_SUPPORTED 0
+#endif
+
 struct omp_allocator_data
 {
   omp_memspace_handle_t memspace;
@@ -58,6 +72,23 @@ struct omp_mem_header
   void *pad;
 };
 
+static inline void *
+omp_memspace_alloc (struct omp_allocator_data *data, size_t size)
+{
+  if (data == NULL)
+    return malloc (size);
+  return MEMSPACE_ALLOC (data->memspace, size, data->pinned, data->partition);
+}
+
+static inline void
+omp_memspace_free (struct omp_allocator_data *data, void *ptr, size_t size)
+{
+  if (data == NULL)
+    free (ptr);
+  else
+    MEMSPACE_FREE (data->memspace, ptr, size, data->pinned, data->partition);
+}
+
 omp_allocator_handle_t
 omp_init_allocator (omp_memspace_handle_t memspace, int ntraits,
 		    const omp_alloctrait_t traits[])
@@ -179,7 +210,8 @@ omp_init_allocator (omp_memspace_handle_t memspace, int ntraits,
     data.alignment = sizeof (void *);
 
   /* No support for these so far (for hbw will use memkind).  */
-  if (data.pinned || data.memspace == omp_high_bw_mem_space)
+  if ((data.pinned && !MEMSPACE_PINNED_SUPPORTED)
+      || data.memspace == omp_high_bw_mem_space)
     return omp_null_allocator;
 
   ret = gomp_malloc (sizeof (struct omp_allocator_data));
@@ -279,7 +311,7 @@ retry:
       allocator_data->used_pool_size = used_pool_size;
       gomp_mutex_unlock (&allocator_data->lock);
 #endif
-      ptr = malloc (new_size);
+      ptr = omp_memspace_alloc (allocator_data, new_size);
       if (ptr == NULL)
 	{
 #ifdef HAVE_SYNC_BUILTINS
@@ -295,7 +327,7 @@ retry:
     }
   else
     {
-      ptr = malloc (new_size);
+      ptr = omp_memspace_alloc (allocator_data, new_size);
       if (ptr == NULL)
 	goto fail;
     }
@@ -367,6 +399,7 @@ void
 omp_free (void *ptr, omp_allocator_handle_t allocator)
 {
   struct omp_mem_header *data;
+  struct omp_allocator_data *allocator_data = NULL;
 
   if (ptr == NULL)
     return;
@@ -374,8 +407,7 @@ omp_free (void *ptr, omp_allocator_handle_t allocator)
   data = &((struct omp_mem_header *) ptr)[-1];
   if (data->allocator > omp_max_predefined_alloc)
     {
-      struct omp_allocator_data *allocator_data
-	= (struct omp_allocator_data *) (data->allocator);
+      allocator_data = (struct omp_allocator_data *) (data->allocator);
       if (allocator_data->pool_size < ~(uintptr_t) 0)
 	{
 #ifdef HAVE_SYNC_BUILTINS
@@ -388,7 +420,7 @@ omp_free (void *ptr, omp_allocator_handle_t allocator)
 #endif
 	}
     }
-  free (data->ptr);
+  omp_memspace_free (allocator_data, data->ptr, data->size);
 }
 
 ialias (omp_free)
@@ -38,7 +38,9 @@ GOMP_barrier (void)
   if (team == NULL)
     return;
 
+  gomp_trace (GOMP_TRACE_BARRIER, 'B', NULL);
   gomp_team_barrier_wait (&team->barrier);
+  gomp_trace (GOMP_TRACE_BARRIER, 'E', NULL);
 }
 
 bool
@@ -50,5 +52,9 @@ GOMP_barrier_cancel (void)
   /* The compiler transforms to barrier_cancel when it sees that the
      barrier is within a construct that can cancel.  Thus we should
      never have an orphaned cancellable barrier.  */
-  return gomp_team_barrier_wait_cancel (&team->barrier);
+  bool ret;
+  gomp_trace (GOMP_TRACE_BARRIER, 'B', NULL);
+  ret = gomp_team_barrier_wait_cancel (&team->barrier);
+  gomp_trace (GOMP_TRACE_BARRIER, 'E', NULL);
+  return ret;
 }
@@ -55,4 +55,8 @@ static inline void doacross_spin (unsigned long *addr, unsigned long expected,
   while (cur <= expected);
 }
 
+static inline void doacross_wake (unsigned long *addr __attribute__((unused)))
+{
+}
+
 #endif /* GOMP_DOACROSS_H */
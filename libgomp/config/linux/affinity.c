@@ -297,11 +297,171 @@ gomp_affinity_init_level_1 (int level, int this_level, unsigned long count,
   free (line);
 }
 
+/* Add to the place PL the CPUs still in COPY that are listed, like
+   "0-3,8-11", in the file NAME, and remove them from COPY.  Return the
+   number of CPUs added, or -1 if NAME cannot be read.  */
+
+static long
+gomp_affinity_add_cpu_list (void *pl, const char *name, cpu_set_t *copy,
+			    char **line, size_t *linelen)
+{
+  FILE *f = fopen (name, "r");
+  long added = 0;
+
+  if (f == NULL)
+    return -1;
+  if (getline (line, linelen, f) > 0)
+    {
+      char *p = *line;
+      while (*p && *p != '\n')
+	{
+	  unsigned long first, last;
+	  char *start = p;
+	  errno = 0;
+	  first = strtoul (p, &p, 10);
+	  if (errno || p == start)
+	    break;
+	  last = first;
+	  if (*p == '-')
+	    {
+	      errno = 0;
+	      last = strtoul (p + 1, &p, 10);
+	      if (errno || last < first)
+		break;
+	    }
+	  for (; first <= last && first < 8 * gomp_cpuset_size; first++)
+	    if (CPU_ISSET_S (first, gomp_cpuset_size, copy)
+		&& gomp_affinity_add_cpus (pl, first, 1, 0, true))
+	      {
+		CPU_CLR_S (first, gomp_cpuset_size, copy);
+		added++;
+	      }
+	  if (*p == ',')
+	    ++p;
+	}
+    }
+  fclose (f);
+  return added;
+}
+
+/* Return the number of the sysfs cache index of the last level cache
+   of CPU, or -1 if there is none.  NAME holds the CPU directory prefix
+   of PREFIX_LEN characters.  */
+
+static int
+gomp_affinity_find_last_cache_level (char *name, size_t prefix_len,
+				     unsigned long cpu)
+{
+  int ret = -1, max_level = 0;
+
+  for (int i = 0; ; i++)
+    {
+      FILE *f;
+      int level;
+
+      sprintf (name + prefix_len, "%lu/cache/index%d/level", cpu, i);
+      f = fopen (name, "r");
+      if (f == NULL)
+	break;
+      if (fscanf (f, "%d", &level) == 1 && level > max_level)
+	{
+	  max_level = level;
+	  ret = i;
+	}
+      fclose (f);
+    }
+  return ret;
+}
+
+/* Create up to COUNT places, one for each group of the CPUs in COPY
+   that share a last level cache (LEVEL 4) or a NUMA node (LEVEL 5).  */
+
+static void
+gomp_affinity_init_shared_level (int level, unsigned long count,
+				 cpu_set_t *copy, char *name)
+{
+  size_t prefix_len = sizeof ("/sys/devices/system/cpu/cpu") - 1;
+  char *line = NULL;
+  size_t linelen = 0;
+  unsigned long i, max = 8 * gomp_cpuset_size;
+
+  if (level == 4)
+    {
+      for (i = 0; i < max && gomp_places_list_len < count; i++)
+	if (CPU_ISSET_S (i, gomp_cpuset_size, copy))
+	  {
+	    void *pl = gomp_places_list[gomp_places_list_len];
+	    int index = gomp_affinity_find_last_cache_level (name, prefix_len,
+							     i);
+	    if (index >= 0)
+	      {
+		sprintf (name + prefix_len,
+			 "%lu/cache/index%d/shared_cpu_list", i, index);
+		gomp_affinity_init_place (pl);
+		if (gomp_affinity_add_cpu_list (pl, name, copy, &line,
+						&linelen) > 0)
+		  gomp_places_list_len++;
+	      }
+	    CPU_CLR_S (i, gomp_cpuset_size, copy);
+	  }
+    }
+  else
+    {
+      /* The online nodes are listed like the CPUs of each node.  */
+      FILE *f = fopen ("/sys/devices/system/node/online", "r");
+      char *nodes = NULL, *p;
+      size_t nodeslen = 0;
+
+      if (f == NULL)
+	return;
+      if (getline (&nodes, &nodeslen, f) <= 0)
+	{
+	  fclose (f);
+	  free (nodes);
+	  return;
+	}
+      fclose (f);
+      p = nodes;
+      while (*p && *p != '\n' && gomp_places_list_len < count)
+	{
+	  unsigned long first, last;
+	  char *start = p;
+	  errno = 0;
+	  first = strtoul (p, &p, 10);
+	  if (errno || p == start)
+	    break;
+	  last = first;
+	  if (*p == '-')
+	    {
+	      errno = 0;
+	      last = strtoul (p + 1, &p, 10);
+	      if (errno || last < first)
+		break;
+	    }
+	  for (; first <= last && gomp_places_list_len < count; first++)
+	    {
+	      void *pl = gomp_places_list[gomp_places_list_len];
+	      sprintf (name, "/sys/devices/system/node/node%lu/cpulist",
+		       first);
+	      gomp_affinity_init_place (pl);
+	      if (gomp_affinity_add_cpu_list (pl, name, copy, &line,
+					      &linelen) > 0)
+		gomp_places_list_len++;
+	    }
+	  if (*p == ',')
+	    ++p;
+	}
+      free (nodes);
+    }
+  free (line);
+}
+
 bool
 gomp_affinity_init_level (int level, unsigned long count, bool quiet)
 {
-  char name[sizeof ("/sys/devices/system/cpu/cpu/topology/"
-		    "thread_siblings_list") + 3 * sizeof (unsigned long)];
+  char name[sizeof ("/sys/devices/system/cpu/cpu/cache/index/"
+		    "shared_cpu_list") + 3 * sizeof (unsigned long)
+	    + 3 * sizeof (int)];
   cpu_set_t *copy;
 
   if (gomp_cpusetp)
@@ -319,7 +479,19 @@ gomp_affinity_init_level (int level, unsigned long count, bool quiet)
   copy = gomp_alloca (gomp_cpuset_size);
   strcpy (name, "/sys/devices/system/cpu/cpu");
   memcpy (copy, gomp_cpusetp, gomp_cpuset_size);
-  gomp_affinity_init_level_1 (level, 3, count, copy, name, quiet);
+  if (level >= 4)
+    {
+      gomp_affinity_init_shared_level (level, count, copy, name);
+      /* Without cache or NUMA information, fall back to cores or
+	 sockets respectively.  */
+      if (gomp_places_list_len == 0)
+	{
+	  level -= 2;
+	  memcpy (copy, gomp_cpusetp, gomp_cpuset_size);
+	}
+    }
+  if (level <= 3)
+    gomp_affinity_init_level_1 (level, 3, count, copy, name, quiet);
   if (gomp_places_list_len == 0)
     {
       if (!quiet)
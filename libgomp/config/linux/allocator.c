@@ -0,0 +1,196 @@
+/* Copyright (C) 2021 Free Software Foundation, Inc.
+
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This is a Linux specific implementation of the memory placement
+   traits of the OpenMP memory allocators.  Pinned memory is locked
+   with mlock, and the partition trait places the memory on the NUMA
+   nodes with mbind.  Both need memory of its own, so such allocations
+   are mmapped rather than malloced.  */
+
+#define _GNU_SOURCE
+#include "libgomp.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/* <numaif.h> comes with libnuma rather than with the C library, so
+   invoke the system calls directly.  */
+#define GOMP_MPOL_PREFERRED	1
+#define GOMP_MPOL_INTERLEAVE	3
+#define GOMP_MPOL_F_MEMS_ALLOWED	(1 << 2)
+
+/* Largest number of NUMA nodes handled.  */
+#define GOMP_MAX_NUMNODES	1024
+#define GOMP_NODEMASK_BITS	(8 * sizeof (unsigned long))
+
+typedef unsigned long gomp_nodemask_t[GOMP_MAX_NUMNODES / GOMP_NODEMASK_BITS];
+
+static gomp_nodemask_t linux_nodes_allowed;
+static int linux_nodes_count = -1;
+
+/* Return the number of NUMA nodes this process may allocate memory on,
+   and record them in linux_nodes_allowed.  */
+
+static int
+linux_get_nodes_allowed (void)
+{
+  int count = __atomic_load_n (&linux_nodes_count, MEMMODEL_ACQUIRE);
+  gomp_nodemask_t mask;
+  size_t i;
+
+  if (count >= 0)
+    return count;
+
+  count = 0;
+#ifdef SYS_get_mempolicy
+  if (syscall (SYS_get_mempolicy, NULL, mask, GOMP_MAX_NUMNODES, NULL,
+	       GOMP_MPOL_F_MEMS_ALLOWED) == 0)
+    for (i = 0; i < sizeof (mask) / sizeof (mask[0]); i++)
+      {
+	__atomic_store_n (&linux_nodes_allowed[i], mask[i], MEMMODEL_RELAXED);
+	count += __builtin_popcountl (mask[i]);
+      }
+#endif
+  __atomic_store_n (&linux_nodes_count, count, MEMMODEL_RELEASE);
+  return count;
+}
+
+/* Apply memory policy MODE for the nodes in MASK to [ADDR, ADDR+SIZE).
+   Placement is only a hint, so errors are ignored.  */
+
+static void
+linux_mbind (void *addr, size_t size, int mode, const unsigned long *mask)
+{
+#ifdef SYS_mbind
+  /* The kernel only looks at MAXNODE - 1 bits.  */
+  syscall (SYS_mbind, addr, size, mode, mask, GOMP_MAX_NUMNODES + 1, 0);
+#endif
+}
+
+/* Place [ADDR, ADDR+SIZE) according to partition trait PARTITION.  */
+
+static void
+linux_memspace_place (void *addr, size_t size, int partition)
+{
+  gomp_nodemask_t mask;
+  int count;
+
+  if (partition == omp_atv_environment
+      || (count = linux_get_nodes_allowed ()) <= 1)
+    return;
+
+  switch (partition)
+    {
+    case omp_atv_nearest:
+      {
+	unsigned cpu, node;
+	/* Prefer the node of the allocating thread, even if another
+	   thread touches the memory first.  */
+#ifdef SYS_getcpu
+	if (syscall (SYS_getcpu, &cpu, &node, NULL) == 0
+	    && node < GOMP_MAX_NUMNODES)
+	  {
+	    memset (mask, 0, sizeof (mask));
+	    mask[node / GOMP_NODEMASK_BITS]
+	      |= 1UL << (node % GOMP_NODEMASK_BITS);
+	    linux_mbind (addr, size, GOMP_MPOL_PREFERRED, mask);
+	  }
+#endif
+	break;
+      }
+    case omp_atv_blocked:
+      {
+	/* Split the pages into one contiguous block per node.  */
+	size_t page = sysconf (_SC_PAGESIZE);
+	size_t pages = (size + page - 1) / page;
+	size_t block = (pages + count - 1) / count * page;
+	char *p = (char *) addr, *end = p + pages * page;
+	unsigned node;
+
+	for (node = 0; node < GOMP_MAX_NUMNODES && p < end; node++)
+	  if (linux_nodes_allowed[node / GOMP_NODEMASK_BITS]
+	      & (1UL << (node % GOMP_NODEMASK_BITS)))
+	    {
+	      size_t len = (size_t) (end - p) < block ? end - p : block;
+	      memset (mask, 0, sizeof (mask));
+	      mask[node / GOMP_NODEMASK_BITS]
+		|= 1UL << (node % GOMP_NODEMASK_BITS);
+	      linux_mbind (p, len, GOMP_MPOL_PREFERRED, mask);
+	      p += len;
+	    }
+	break;
+      }
+    case omp_atv_interleaved:
+      linux_mbind (addr, size, GOMP_MPOL_INTERLEAVE, linux_nodes_allowed);
+      break;
+    }
+}
+
+static void *
+linux_memspace_alloc (omp_memspace_handle_t memspace, size_t size, int pin,
+		      int partition)
+{
+  void *addr;
+
+  (void) memspace;
+  if (!pin && partition == omp_atv_environment)
+    return malloc (size);
+
+  addr = mmap (NULL, size, PROT_READ | PROT_WRITE,
+	       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED)
+    return NULL;
+  /* The pages must be placed before mlock faults them in.  */
+  linux_memspace_place (addr, size, partition);
+  if (pin && mlock (addr, size) != 0)
+    {
+      gomp_debug (0, "libgomp: failed to pin %lu bytes of memory"
+		  " (RLIMIT_MEMLOCK too low?)\n", (unsigned long) size);
+      munmap (addr, size);
+      return NULL;
+    }
+  return addr;
+}
+
+static void
+linux_memspace_free (omp_memspace_handle_t memspace, void *addr, size_t size,
+		     int pin, int partition)
+{
+  (void) memspace;
+  if (!pin && partition == omp_atv_environment)
+    free (addr);
+  else
+    munmap (addr, size);
+}
+
+#define MEMSPACE_ALLOC(MEMSPACE, SIZE, PIN, PARTITION) \
+  linux_memspace_alloc (MEMSPACE, SIZE, PIN, PARTITION)
+#define MEMSPACE_FREE(MEMSPACE, ADDR, SIZE, PIN, PARTITION) \
+  linux_memspace_free (MEMSPACE, ADDR, SIZE, PIN, PARTITION)
+#define MEMSPACE_PINNED_SUPPORTED 1
+
+#include "../../allocator.c"
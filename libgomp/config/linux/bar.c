@@ -71,6 +71,45 @@ gomp_barrier_wait_last (gomp_barrier_t *bar)
     gomp_barrier_wait_end (bar, state);
 }
 
+/* Team size from which team barriers use group counters by default.
+   Below it a single contended counter is cheaper than the extra atomic
+   operation of the last thread of each group.  */
+#define BAR_GROUP_THRESHOLD	32
+
+/* Initialize the barrier of a team of COUNT threads.  Large teams get a
+   two-level arrival: consecutive team members, which with OMP_PROC_BIND
+   typically share a core complex or socket, first count down a group
+   counter in a cacheline of its own, so that only one thread per group
+   writes the cacheline holding awaited.  GOMP_BARRIER_TREE forces or
+   disables this regardless of the team size.  */
+
+void
+gomp_team_barrier_init (gomp_barrier_t *bar, unsigned count)
+{
+  unsigned ngroups, i;
+
+  gomp_barrier_init (bar, count);
+  if (count <= BAR_GROUP_SIZE
+      || gomp_barrier_tree_var == 0
+      || (gomp_barrier_tree_var < 0 && count < BAR_GROUP_THRESHOLD))
+    return;
+
+  ngroups = (count + BAR_GROUP_SIZE - 1) / BAR_GROUP_SIZE;
+  bar->groups
+    = gomp_aligned_alloc (__alignof__ (struct gomp_barrier_group),
+			  ngroups * sizeof (struct gomp_barrier_group));
+  for (i = 0; i < ngroups; i++)
+    bar->groups[i].awaited = gomp_barrier_group_count (count, i);
+}
+
+void
+gomp_team_barrier_destroy (gomp_barrier_t *bar)
+{
+  if (bar->groups)
+    gomp_aligned_free (bar->groups);
+  gomp_barrier_destroy (bar);
+}
+
 void
 gomp_team_barrier_wake (gomp_barrier_t *bar, int count)
 {
@@ -124,13 +163,20 @@ gomp_team_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
 void
 gomp_team_barrier_wait (gomp_barrier_t *bar)
 {
-  gomp_team_barrier_wait_end (bar, gomp_barrier_wait_start (bar));
+  unsigned id = gomp_thread ()->ts.team_id;
+  gomp_team_barrier_wait_end (bar, gomp_team_barrier_wait_start (bar, id));
 }
 
 void
 gomp_team_barrier_wait_final (gomp_barrier_t *bar)
 {
-  gomp_barrier_state_t state = gomp_barrier_wait_final_start (bar);
+  gomp_barrier_state_t state;
+
+  if (bar->groups)
+    state = gomp_barrier_group_wait_start (bar, &bar->awaited_final,
+					   gomp_thread ()->ts.team_id);
+  else
+    state = gomp_barrier_wait_final_start (bar);
   if (__builtin_expect (state & BAR_WAS_LAST, 0))
     bar->awaited_final = bar->total;
   gomp_team_barrier_wait_end (bar, state);
@@ -38,10 +38,23 @@ typedef struct
      awaited in a separate cacheline.  */
   unsigned total __attribute__((aligned (64)));
   unsigned generation;
+  /* For team barriers of large teams, the threads first arrive at
+     one of these per-group counters, and only the last thread of each
+     group decrements awaited (see gomp_team_barrier_init).  */
+  struct gomp_barrier_group *groups;
   unsigned awaited __attribute__((aligned (64)));
   unsigned awaited_final;
 } gomp_barrier_t;
 
+/* Each group counter lives in its own cacheline.  */
+struct gomp_barrier_group
+{
+  unsigned awaited __attribute__((aligned (64)));
+};
+
+/* Number of consecutive team members sharing one group counter.  */
+#define BAR_GROUP_SIZE		8
+
 typedef unsigned int gomp_barrier_state_t;
 
 /* The generation field contains a counter in the high bits, with a few
@@ -59,6 +72,7 @@ static inline void gomp_barrier_init (gomp_barrier_t *bar, unsigned count)
   bar->awaited = count;
   bar->awaited_final = count;
   bar->generation = 0;
+  bar->groups = NULL;
 }
 
 static inline void gomp_barrier_reinit (gomp_barrier_t *bar, unsigned count)
@@ -74,6 +88,8 @@ static inline void gomp_barrier_destroy (gomp_barrier_t *bar)
 extern void gomp_barrier_wait (gomp_barrier_t *);
 extern void gomp_barrier_wait_last (gomp_barrier_t *);
 extern void gomp_barrier_wait_end (gomp_barrier_t *, gomp_barrier_state_t);
+extern void gomp_team_barrier_init (gomp_barrier_t *, unsigned);
+extern void gomp_team_barrier_destroy (gomp_barrier_t *);
 extern void gomp_team_barrier_wait (gomp_barrier_t *);
 extern void gomp_team_barrier_wait_final (gomp_barrier_t *);
 extern void gomp_team_barrier_wait_end (gomp_barrier_t *,
@@ -120,6 +136,52 @@ gomp_barrier_wait_final_start (gomp_barrier_t *bar)
   return ret;
 }
 
+/* Number of team members arriving at group GROUP of a team of TOTAL
+   threads.  */
+static inline unsigned
+gomp_barrier_group_count (unsigned total, unsigned group)
+{
+  unsigned first = group * BAR_GROUP_SIZE;
+  return total - first < BAR_GROUP_SIZE ? total - first : BAR_GROUP_SIZE;
+}
+
+/* Arrival at a team barrier with group counters on behalf of team member
+   ID.  The last thread of each group rearms the group counter and then
+   subtracts the size of the whole group from *AWAITED, so that only
+   one thread per group touches the shared cacheline.  */
+static inline gomp_barrier_state_t
+gomp_barrier_group_wait_start (gomp_barrier_t *bar, unsigned *awaited,
+			       unsigned id)
+{
+  struct gomp_barrier_group *group = &bar->groups[id / BAR_GROUP_SIZE];
+  unsigned int count, ret;
+
+  ret = __atomic_load_n (&bar->generation, MEMMODEL_ACQUIRE);
+  ret &= -BAR_INCR | BAR_CANCELLED;
+  /* See above gomp_barrier_wait_start comment.  */
+  if (__atomic_add_fetch (&group->awaited, -1, MEMMODEL_ACQ_REL) != 0)
+    return ret;
+  /* No member of this group can arrive at the next barrier before
+     this one completes, so the counter can be rearmed right away.  */
+  count = gomp_barrier_group_count (bar->total, id / BAR_GROUP_SIZE);
+  group->awaited = count;
+  if (__atomic_add_fetch (awaited, -count, MEMMODEL_ACQ_REL) == 0)
+    ret |= BAR_WAS_LAST;
+  return ret;
+}
+
+/* Like gomp_barrier_wait_start, but for a team barrier that ID, the
+   team_id of the encountering thread, waits on.  Cancellable barriers
+   never use the group counters, as a cancelled barrier leaves them
+   partially decremented.  */
+static inline gomp_barrier_state_t
+gomp_team_barrier_wait_start (gomp_barrier_t *bar, unsigned id)
+{
+  if (bar->groups == NULL)
+    return gomp_barrier_wait_start (bar);
+  return gomp_barrier_group_wait_start (bar, &bar->awaited, id);
+}
+
 static inline bool
 gomp_barrier_last_thread (gomp_barrier_state_t state)
 {
@@ -23,33 +23,76 @@
    see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
    <http://www.gnu.org/licenses/>.  */
 
-/* This is a Linux specific implementation of doacross spinning.  */
+/* This is a Linux specific implementation of doacross spinning, which
+   falls back to sleeping on a futex.  */
 
 #ifndef GOMP_DOACROSS_H
 #define GOMP_DOACROSS_H 1
 
 #include "libgomp.h"
 #include <errno.h>
+#include <limits.h>
 #include "wait.h"
 
 #ifdef HAVE_ATTRIBUTE_VISIBILITY
 # pragma GCC visibility push(hidden)
 #endif
 
+/* The futex word waiters sleep on.  It is in the padding after the
+   flattened counter ADDR, in the same cache line, and is nonzero while
+   there may be sleeping waiters.  */
+
+static inline int *doacross_futex (unsigned long *addr)
+{
+  return (int *) (addr + 1);
+}
+
 static inline void doacross_spin (unsigned long *addr, unsigned long expected,
 				  unsigned long cur)
 {
-  /* FIXME: back off depending on how large expected - cur is.  */
-  do
+  unsigned long long i, count = gomp_spin_count_var;
+  int *futex = doacross_futex (addr);
+
+  if (__builtin_expect (__atomic_load_n (&gomp_managed_threads,
+					 MEMMODEL_RELAXED)
+			> gomp_available_cpus, 0))
+    count = gomp_throttled_spin_count_var;
+  for (i = 0; i < count; i++)
     {
       cpu_relax ();
       cur = __atomic_load_n (addr, MEMMODEL_RELAXED);
       if (expected < cur)
 	return;
     }
+
+  /* Announce the waiter before checking the counter for the last time;
+     doacross_wake stores the counter before checking FUTEX.  */
+  do
+    {
+      __atomic_store_n (futex, 1, MEMMODEL_SEQ_CST);
+      cur = __atomic_load_n (addr, MEMMODEL_SEQ_CST);
+      if (expected < cur)
+	return;
+      futex_wait (futex, 1);
+    }
   while (1);
 }
 
+/* Wake the threads sleeping in doacross_spin after the counter ADDR
+   has been updated.  */
+
+static inline void doacross_wake (unsigned long *addr)
+{
+  int *futex = doacross_futex (addr);
+
+  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+  if (__builtin_expect (__atomic_load_n (futex, MEMMODEL_RELAXED) != 0, 0))
+    {
+      __atomic_store_n (futex, 0, MEMMODEL_RELAXED);
+      futex_wake (futex, INT_MAX);
+    }
+}
+
 #ifdef HAVE_ATTRIBUTE_VISIBILITY
 # pragma GCC visibility pop
 #endif
@@ -0,0 +1,77 @@
+/* Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* Provide target-specific access to the futex system call.  */
+
+#include <sys/syscall.h>
+
+static inline long
+sys_futex0 (int *addr, int op, int val)
+{
+  register long a0 __asm__ ("a0") = (long) addr;
+  register long a1 __asm__ ("a1") = op;
+  register long a2 __asm__ ("a2") = val;
+  register long a3 __asm__ ("a3") = 0;
+  register long a7 __asm__ ("a7") = SYS_futex;
+
+  __asm volatile ("ecall"
+		  : "+r" (a0)
+		  : "r" (a1), "r" (a2), "r" (a3), "r" (a7)
+		  : "memory");
+  return a0;
+}
+
+static inline void
+futex_wait (int *addr, int val)
+{
+  long err = sys_futex0 (addr, gomp_futex_wait, val);
+  if (__builtin_expect (err == -ENOSYS, 0))
+    {
+      gomp_futex_wait &= ~FUTEX_PRIVATE_FLAG;
+      gomp_futex_wake &= ~FUTEX_PRIVATE_FLAG;
+      sys_futex0 (addr, gomp_futex_wait, val);
+    }
+}
+
+static inline void
+futex_wake (int *addr, int count)
+{
+  long err = sys_futex0 (addr, gomp_futex_wake, count);
+  if (__builtin_expect (err == -ENOSYS, 0))
+    {
+      gomp_futex_wait &= ~FUTEX_PRIVATE_FLAG;
+      gomp_futex_wake &= ~FUTEX_PRIVATE_FLAG;
+      sys_futex0 (addr, gomp_futex_wake, count);
+    }
+}
+
+/* Zihintpause PAUSE, encoded as FENCE W,0 so that it assembles with any
+   toolchain and executes as a harmless fence on cores without the
+   extension.  */
+
+static inline void
+cpu_relax (void)
+{
+  __asm volatile (".4byte 0x0100000f" : : : "memory");
+}
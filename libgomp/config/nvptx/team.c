@@ -143,6 +143,7 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   thr->ts.work_share = &team->work_shares[0];
   thr->ts.last_work_share = NULL;
   thr->ts.single_count = 0;
+  thr->ts.dynamic_next = thr->ts.dynamic_end = 0;
   thr->ts.static_trip = 0;
   thr->task = &team->implicit_task[0];
   nthreads_var = icv->nthreads_var;
@@ -164,6 +165,7 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
       nthr->ts.level = team->prev_ts.level + 1;
       nthr->ts.active_level = thr->ts.active_level;
       nthr->ts.single_count = 0;
+      nthr->ts.dynamic_next = nthr->ts.dynamic_end = 0;
       nthr->ts.static_trip = 0;
       nthr->task = &team->implicit_task[i];
       gomp_init_task (nthr->task, task, icv);
@@ -98,6 +98,26 @@ gomp_barrier_wait_cancel_start (gomp_barrier_t *bar)
   return ret;
 }
 
+/* Team barriers have no separate arrival scheme here.  */
+static inline void
+gomp_team_barrier_init (gomp_barrier_t *bar, unsigned count)
+{
+  gomp_barrier_init (bar, count);
+}
+
+static inline void
+gomp_team_barrier_destroy (gomp_barrier_t *bar)
+{
+  gomp_barrier_destroy (bar);
+}
+
+static inline gomp_barrier_state_t
+gomp_team_barrier_wait_start (gomp_barrier_t *bar,
+			      unsigned id __attribute__((unused)))
+{
+  return gomp_barrier_wait_start (bar);
+}
+
 static inline void
 gomp_team_barrier_wait_final (gomp_barrier_t *bar)
 {
@@ -55,6 +55,10 @@ static inline void doacross_spin (unsigned long *addr, unsigned long expected,
   while (1);
 }
 
+static inline void doacross_wake (unsigned long *addr __attribute__((unused)))
+{
+}
+
 #ifdef HAVE_ATTRIBUTE_VISIBILITY
 # pragma GCC visibility pop
 #endif
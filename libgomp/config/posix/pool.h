@@ -45,6 +45,8 @@ gomp_get_thread_pool (struct gomp_thread *thr, unsigned nthreads)
       pool->threads_used = 0;
       pool->last_team = NULL;
       pool->threads_busy = nthreads;
+      pool->nested_idle = NULL;
+      gomp_mutex_init (&pool->nested_idle_lock);
       thr->thread_pool = pool;
       pthread_setspecific (gomp_thread_destructor, thr);
     }
@@ -53,6 +53,7 @@
 #endif
 #include <errno.h>
 #include "thread-stacksize.h"
+#include "spin-count.h"
 
 #ifndef HAVE_STRTOULL
 # define strtoull(ptr, eptr, base) strtoul (ptr, eptr, base)
@@ -82,6 +83,8 @@ gomp_mutex_t gomp_managed_threads_lock;
 #endif
 unsigned long gomp_available_cpus = 1, gomp_managed_threads = 1;
 unsigned long long gomp_spin_count_var, gomp_throttled_spin_count_var;
+int gomp_barrier_tree_var = -1;
+bool gomp_taskloop_adaptive_var;
 unsigned long *gomp_nthreads_var_list, gomp_nthreads_var_list_len;
 char *gomp_bind_var_list;
 unsigned long gomp_bind_var_list_len;
@@ -690,6 +693,16 @@ parse_places_var (const char *name, bool ignore)
       env += 7;
       level = 3;
     }
+  else if (strncasecmp (env, "ll_caches", 9) == 0)
+    {
+      env += 9;
+      level = 4;
+    }
+  else if (strncasecmp (env, "numa_domains", 12) == 0)
+    {
+      env += 12;
+      level = 5;
+    }
   if (level)
     {
       count = ULONG_MAX;
@@ -1499,26 +1512,39 @@ initialize_env (void)
   wait_policy = parse_wait_policy ();
   if (!parse_spincount ("GOMP_SPINCOUNT", &gomp_spin_count_var))
     {
-      /* Using a rough estimation of 100000 spins per msec,
+      /* Using a rough estimation of GOMP_SPINS_PER_MSEC spins per msec,
 	 use 5 min blocking for OMP_WAIT_POLICY=active,
 	 3 msec blocking when OMP_WAIT_POLICY is not specificed
 	 and 0 when OMP_WAIT_POLICY=passive.
 	 Depending on the CPU speed, this can be e.g. 5 times longer
 	 or 5 times shorter.  */
       if (wait_policy > 0)
-	gomp_spin_count_var = 30000000000LL;
+	gomp_spin_count_var = 300000LL * GOMP_SPINS_PER_MSEC;
       else if (wait_policy < 0)
-	gomp_spin_count_var = 300000LL;
+	gomp_spin_count_var = 3LL * GOMP_SPINS_PER_MSEC;
     }
   /* gomp_throttled_spin_count_var is used when there are more libgomp
      managed threads than available CPUs.  Use very short spinning.  */
   if (wait_policy > 0)
-    gomp_throttled_spin_count_var = 1000LL;
+    gomp_throttled_spin_count_var = GOMP_SPINS_PER_MSEC / 100;
   else if (wait_policy < 0)
-    gomp_throttled_spin_count_var = 100LL;
+    gomp_throttled_spin_count_var = GOMP_SPINS_PER_MSEC / 1000;
   if (gomp_throttled_spin_count_var > gomp_spin_count_var)
     gomp_throttled_spin_count_var = gomp_spin_count_var;
 
+  {
+    bool barrier_tree;
+    if (parse_boolean ("GOMP_BARRIER_TREE", &barrier_tree))
+      gomp_barrier_tree_var = barrier_tree;
+  }
+  parse_boolean ("GOMP_TASKLOOP_ADAPTIVE", &gomp_taskloop_adaptive_var);
+
+  {
+    const char *trace = secure_getenv ("GOMP_TRACE");
+    if (trace != NULL)
+      gomp_trace_init (trace);
+  }
+
   /* Not strictly environment related, but ordering constructors is tricky.  */
   pthread_attr_init (&gomp_thread_attr);
 
@@ -193,29 +193,62 @@ gomp_iter_dynamic_next (long *pstart, long *pend)
 
   if (__builtin_expect (ws->mode, 1))
     {
-      long tmp = __sync_fetch_and_add (&ws->next, chunk);
-      if (incr > 0)
+      long tmp, batch = 1;
+
+      /* Hand out the next chunk of iterations claimed earlier.  */
+      if (thr->ts.dynamic_next != thr->ts.dynamic_end)
 	{
-	  if (tmp >= end)
-	    return false;
+	  tmp = thr->ts.dynamic_next;
+	  end = thr->ts.dynamic_end;
 	  nend = tmp + chunk;
-	  if (nend > end)
+	  if (incr > 0 ? nend > end : nend < end)
 	    nend = end;
+	  thr->ts.dynamic_next = nend;
 	  *pstart = tmp;
 	  *pend = nend;
 	  return true;
 	}
+
+      /* With many chunks left, claim several of them with a single
+	 atomic operation on the contended ws->next.  */
+      if (ws->mode & 4)
+	{
+	  struct gomp_team *team = thr->ts.team;
+	  long nthreads = team ? team->nthreads : 1;
+	  batch = ((end - __atomic_load_n (&ws->next, MEMMODEL_RELAXED))
+		   / chunk / (nthreads * GOMP_DYNAMIC_BATCH_SPLIT));
+	  if (batch > GOMP_DYNAMIC_BATCH_MAX)
+	    batch = GOMP_DYNAMIC_BATCH_MAX;
+	  else if (batch < 1)
+	    batch = 1;
+	}
+
+      tmp = __sync_fetch_and_add (&ws->next, chunk * batch);
+      if (incr > 0)
+	{
+	  if (tmp >= end)
+	    return false;
+	  nend = tmp + chunk * batch;
+	  if (nend > end)
+	    nend = end;
+	}
       else
 	{
 	  if (tmp <= end)
 	    return false;
-	  nend = tmp + chunk;
+	  nend = tmp + chunk * batch;
 	  if (nend < end)
 	    nend = end;
-	  *pstart = tmp;
-	  *pend = nend;
-	  return true;
 	}
+      if (batch > 1 && (incr > 0 ? tmp + chunk < nend : tmp + chunk > nend))
+	{
+	  thr->ts.dynamic_next = tmp + chunk;
+	  thr->ts.dynamic_end = nend;
+	  nend = tmp + chunk;
+	}
+      *pstart = tmp;
+      *pend = nend;
+      return true;
     }
 
   start = __atomic_load_n (&ws->next, MEMMODEL_RELAXED);
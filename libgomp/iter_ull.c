@@ -194,29 +194,69 @@ gomp_iter_ull_dynamic_next (gomp_ull *pstart, gomp_ull *pend)
 
   if (__builtin_expect (ws->mode & 1, 1))
     {
-      gomp_ull tmp = __sync_fetch_and_add (&ws->next_ull, chunk);
-      if (__builtin_expect (ws->mode & 2, 0) == 0)
+      bool down = __builtin_expect (ws->mode & 2, 0) != 0;
+      gomp_ull tmp, batch = 1;
+
+      /* Hand out the next chunk of iterations claimed earlier, see
+	 gomp_iter_dynamic_next.  */
+      if (thr->ts.dynamic_next != thr->ts.dynamic_end)
 	{
-	  if (tmp >= end)
-	    return false;
+	  tmp = thr->ts.dynamic_next;
+	  end = thr->ts.dynamic_end;
 	  nend = tmp + chunk;
-	  if (nend > end)
+	  if (down ? nend < end : nend > end)
 	    nend = end;
+	  thr->ts.dynamic_next = nend;
 	  *pstart = tmp;
 	  *pend = nend;
 	  return true;
 	}
+
+      if (ws->mode & 4)
+	{
+	  struct gomp_team *team = thr->ts.team;
+	  gomp_ull nthreads = team ? team->nthreads : 1;
+	  gomp_ull next = __atomic_load_n (&ws->next_ull, MEMMODEL_RELAXED);
+	  if (down ? next > end : next < end)
+	    {
+	      if (down)
+		batch = (next - end) / -chunk;
+	      else
+		batch = (end - next) / chunk;
+	      batch /= nthreads * GOMP_DYNAMIC_BATCH_SPLIT;
+	      if (batch > GOMP_DYNAMIC_BATCH_MAX)
+		batch = GOMP_DYNAMIC_BATCH_MAX;
+	      else if (batch < 1)
+		batch = 1;
+	    }
+	}
+
+      tmp = __sync_fetch_and_add (&ws->next_ull, chunk * batch);
+      if (!down)
+	{
+	  if (tmp >= end)
+	    return false;
+	  nend = tmp + chunk * batch;
+	  if (nend > end)
+	    nend = end;
+	}
       else
 	{
 	  if (tmp <= end)
 	    return false;
-	  nend = tmp + chunk;
+	  nend = tmp + chunk * batch;
 	  if (nend < end)
 	    nend = end;
-	  *pstart = tmp;
-	  *pend = nend;
-	  return true;
 	}
+      if (batch > 1 && (down ? tmp + chunk > nend : tmp + chunk < nend))
+	{
+	  thr->ts.dynamic_next = tmp + chunk;
+	  thr->ts.dynamic_end = nend;
+	  nend = tmp + chunk;
+	}
+      *pstart = tmp;
+      *pend = nend;
+      return true;
     }
 
   start = __atomic_load_n (&ws->next_ull, MEMMODEL_RELAXED);
@@ -411,6 +411,13 @@ struct gomp_team_state
      is 1, etc.  This is unused when the compiler knows in advance that
      the loop is statically scheduled.  */
   unsigned long static_trip;
+
+#ifdef HAVE_SYNC_BUILTINS
+  /* Iterations of a GFS_DYNAMIC loop that this thread has claimed from
+     the work share in one go but not handed out yet, or an empty range.
+     See gomp_iter_dynamic_next.  */
+  unsigned long long dynamic_next, dynamic_end;
+#endif
 };
 
 struct target_mem_desc;
@@ -451,6 +458,8 @@ extern bool gomp_cancel_var;
 extern enum gomp_target_offload_t gomp_target_offload_var;
 extern int gomp_max_task_priority_var;
 extern unsigned long long gomp_spin_count_var, gomp_throttled_spin_count_var;
+extern int gomp_barrier_tree_var;
+extern bool gomp_taskloop_adaptive_var;
 extern unsigned long gomp_available_cpus, gomp_managed_threads;
 extern unsigned long *gomp_nthreads_var_list, gomp_nthreads_var_list_len;
 extern char *gomp_bind_var_list;
@@ -569,6 +578,9 @@ struct gomp_task
      block further execution of their parent until the dependencies
      are satisfied.  */
   bool parent_depends_on;
+  /* Set if gomp_task_alloc allocated this task with the size of the
+     per-thread task cache entries.  */
+  bool cacheable;
   /* Dependencies provided and/or needed for this task.  DEPEND_COUNT
      is the number of items available.  */
   struct gomp_task_depend_entry depend[];
@@ -731,6 +743,22 @@ struct gomp_thread
   /* User pthread thread pool */
   struct gomp_thread_pool *thread_pool;
 
+  /* Freed task descriptors kept for reuse by gomp_task_alloc, linked
+     through their parent field, and their number.  */
+  struct gomp_task *task_cache;
+  unsigned int task_cache_count;
+
+  /* A freed taskgroup kept for reuse by gomp_taskgroup_init.  */
+  struct gomp_taskgroup *taskgroup_cache;
+
+  /* GOMP_TRACE event buffer of this thread, allocated on first use.  */
+  struct gomp_trace_buffer *trace_buffer;
+
+  /* Threads of nested teams sleep on this semaphore in between teams,
+     linked through nested_next into their pool's nested_idle list.  */
+  gomp_sem_t nested_release;
+  struct gomp_thread *nested_next;
+
 #if defined(LIBGOMP_USE_PTHREADS) \
     && (!defined(HAVE_TLS) \
 	|| !defined(__GLIBC__) \
@@ -762,6 +790,11 @@ struct gomp_thread_pool
 
   /* This barrier holds and releases threads waiting in thread pools.  */
   gomp_simple_barrier_t threads_dock;
+
+  /* Threads that ran in nested teams of this contention group and now
+     wait to be handed a new nested team, protected by nested_idle_lock.  */
+  struct gomp_thread *nested_idle;
+  gomp_mutex_t nested_idle_lock;
 };
 
 enum gomp_cancel_kind
@@ -888,6 +921,14 @@ extern bool gomp_iter_dynamic_next (long *, long *);
 extern bool gomp_iter_guided_next (long *, long *);
 #endif
 
+/* If bit 4 of the work share mode is set, gomp_iter_dynamic_next and
+   gomp_iter_ull_dynamic_next may claim up to GOMP_DYNAMIC_BATCH_MAX
+   chunks of a GFS_DYNAMIC loop at once, but never more than
+   1/GOMP_DYNAMIC_BATCH_SPLIT of the claiming thread's share of the
+   chunks left.  */
+#define GOMP_DYNAMIC_BATCH_MAX		16
+#define GOMP_DYNAMIC_BATCH_SPLIT	8
+
 /* iter_ull.c */
 
 extern int gomp_iter_ull_static_next (unsigned long long *,
@@ -930,6 +971,10 @@ extern unsigned gomp_dynamic_max_threads (void);
 extern void gomp_init_task (struct gomp_task *, struct gomp_task *,
 			    struct gomp_task_icv *);
 extern void gomp_end_task (void);
+extern struct gomp_task *gomp_task_alloc (struct gomp_thread *, size_t)
+  __attribute__((malloc));
+extern void gomp_task_free (struct gomp_thread *, struct gomp_task *);
+extern void gomp_task_cache_free (struct gomp_thread *);
 extern void gomp_barrier_handle_tasks (gomp_barrier_state_t);
 extern void gomp_task_maybe_wait_for_dependencies (void **);
 extern bool gomp_create_target_task (struct gomp_device_descr *,
@@ -959,6 +1004,36 @@ extern void gomp_team_end (void);
 extern void gomp_free_thread (void *);
 extern int gomp_pause_host (void);
 
+/* trace.c */
+
+enum gomp_trace_kind
+{
+  GOMP_TRACE_PARALLEL,
+  GOMP_TRACE_BARRIER,
+  GOMP_TRACE_TASK
+};
+
+#ifdef LIBGOMP_USE_PTHREADS
+extern bool gomp_trace_var;
+extern void gomp_trace_init (const char *);
+extern void gomp_trace_record (enum gomp_trace_kind, char, void *);
+#endif
+
+/* Record a GOMP_TRACE event if tracing is enabled.  */
+
+static inline void
+gomp_trace (enum gomp_trace_kind kind, char phase, void *data)
+{
+#ifdef LIBGOMP_USE_PTHREADS
+  if (__builtin_expect (gomp_trace_var, 0))
+    gomp_trace_record (kind, phase, data);
+#else
+  (void) kind;
+  (void) phase;
+  (void) data;
+#endif
+}
+
 /* target.c */
 
 extern void gomp_init_targets_once (void);
@@ -67,8 +67,16 @@ gomp_loop_init (struct gomp_work_share *ws, long start, long end, long incr,
 					     * __CHAR_BIT__ / 2 - 1), 0))
 	      ws->mode = 0;
 	    else
-	      ws->mode = ws->end < (LONG_MAX
-				    - (nthreads + 1) * ws->chunk_size);
+	      {
+		ws->mode = ws->end < (LONG_MAX
+				      - (nthreads + 1) * ws->chunk_size);
+		/* Claiming several chunks at once needs more room.  */
+		if ((nthreads | ws->chunk_size)
+		    < 1UL << (sizeof (long) * __CHAR_BIT__ / 2 - 5)
+		    && ws->end < (LONG_MAX - (nthreads + 1) * ws->chunk_size
+				  * GOMP_DYNAMIC_BATCH_MAX))
+		  ws->mode |= 4;
+	      }
 	  }
 	/* Cheap overflow protection.  */
 	else if (__builtin_expect ((nthreads | -ws->chunk_size)
@@ -76,7 +84,14 @@ gomp_loop_init (struct gomp_work_share *ws, long start, long end, long incr,
 					      * __CHAR_BIT__ / 2 - 1), 0))
 	  ws->mode = 0;
 	else
-	  ws->mode = ws->end > (nthreads + 1) * -ws->chunk_size - LONG_MAX;
+	  {
+	    ws->mode = ws->end > (nthreads + 1) * -ws->chunk_size - LONG_MAX;
+	    if ((nthreads | -ws->chunk_size)
+		< 1UL << (sizeof (long) * __CHAR_BIT__ / 2 - 5)
+		&& ws->end > ((nthreads + 1) * -ws->chunk_size
+			      * GOMP_DYNAMIC_BATCH_MAX - LONG_MAX))
+	      ws->mode |= 4;
+	  }
       }
 #endif
     }
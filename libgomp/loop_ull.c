@@ -70,13 +70,28 @@ gomp_loop_ull_init (struct gomp_work_share *ws, bool up, gomp_ull start,
 					     * __CHAR_BIT__ / 2 - 1), 1))
 	      ws->mode = ws->end_ull < (__LONG_LONG_MAX__ * 2ULL + 1
 					- (nthreads + 1) * ws->chunk_size_ull);
+	    /* Claiming several chunks at once needs more room.  */
+	    if ((nthreads | ws->chunk_size_ull)
+		< 1ULL << (sizeof (gomp_ull) * __CHAR_BIT__ / 2 - 5)
+		&& ws->end_ull < (__LONG_LONG_MAX__ * 2ULL + 1
+				  - (nthreads + 1) * ws->chunk_size_ull
+				    * GOMP_DYNAMIC_BATCH_MAX))
+	      ws->mode |= 4;
 	  }
 	/* Cheap overflow protection.  */
 	else if (__builtin_expect ((nthreads | -ws->chunk_size_ull)
 				   < 1ULL << (sizeof (gomp_ull)
 					      * __CHAR_BIT__ / 2 - 1), 1))
-	  ws->mode = ws->end_ull > ((nthreads + 1) * -ws->chunk_size_ull
-				    - (__LONG_LONG_MAX__ * 2ULL + 1));
+	  {
+	    ws->mode = ws->end_ull > ((nthreads + 1) * -ws->chunk_size_ull
+				      - (__LONG_LONG_MAX__ * 2ULL + 1));
+	    if ((nthreads | -ws->chunk_size_ull)
+		< 1ULL << (sizeof (gomp_ull) * __CHAR_BIT__ / 2 - 5)
+		&& ws->end_ull > ((nthreads + 1) * -ws->chunk_size_ull
+				  * GOMP_DYNAMIC_BATCH_MAX
+				  - (__LONG_LONG_MAX__ * 2ULL + 1)))
+	      ws->mode |= 4;
+	  }
       }
 #endif
     }
@@ -350,8 +350,9 @@ gomp_doacross_init (unsigned ncounts, long *counts, long chunk_size,
 	  doacross->shift_counts[i - 1] = shift_count;
 	  shift_count += bits[i - 1];
 	}
-      for (ent = 0; ent < num_ents; ent++)
-	*(unsigned long *) (doacross->array + ent * elt_sz) = 0;
+      /* Clear the padding too, for the benefit of doacross_spin
+	 implementations that keep state there.  */
+      memset (doacross->array, '\0', num_ents * elt_sz);
     }
   else
     for (ent = 0; ent < num_ents; ent++)
@@ -407,7 +408,10 @@ GOMP_doacross_post (long *counts)
       if (flattened == __atomic_load_n (array, MEMMODEL_ACQUIRE))
 	__atomic_thread_fence (MEMMODEL_RELEASE);
       else
-	__atomic_store_n (array, flattened, MEMMODEL_RELEASE);
+	{
+	  __atomic_store_n (array, flattened, MEMMODEL_RELEASE);
+	  doacross_wake (array);
+	}
       return;
     }
 
@@ -606,8 +610,9 @@ gomp_doacross_ull_init (unsigned ncounts, gomp_ull *counts,
 	  doacross->shift_counts[i - 1] = shift_count;
 	  shift_count += bits[i - 1];
 	}
-      for (ent = 0; ent < num_ents; ent++)
-	*(unsigned long *) (doacross->array + ent * elt_sz) = 0;
+      /* Clear the padding too, for the benefit of doacross_spin
+	 implementations that keep state there.  */
+      memset (doacross->array, '\0', num_ents * elt_sz);
     }
   else
     for (ent = 0; ent < num_ents; ent++)
@@ -662,7 +667,10 @@ GOMP_doacross_ull_post (gomp_ull *counts)
       if (flattened == __atomic_load_n (array, MEMMODEL_ACQUIRE))
 	__atomic_thread_fence (MEMMODEL_RELEASE);
       else
-	__atomic_store_n (array, flattened, MEMMODEL_RELEASE);
+	{
+	  __atomic_store_n (array, flattened, MEMMODEL_RELEASE);
+	  doacross_wake (array);
+	}
       return;
     }
 
@@ -2200,6 +2200,7 @@ GOMP_target_ext (int device, void (*fn) (void *), size_t mapnum,
 	  thr->ts.last_work_share = NULL;
 #ifdef HAVE_SYNC_BUILTINS
 	  thr->ts.single_count = 0;
+	  thr->ts.dynamic_next = thr->ts.dynamic_end = 0;
 #endif
 	  thr->ts.static_trip = 0;
 	  thr->task = &team->implicit_task[0];
@@ -103,6 +103,76 @@ gomp_end_task (void)
   thr->task = task->parent;
 }
 
+/* Task descriptors whose argument block and dependencies fit into
+   GOMP_TASK_CACHE_SIZE bytes are allocated with that size, so that the
+   threads can recycle them through a small per-thread cache instead of
+   going through malloc and free for every task.  A task is usually
+   freed by a different thread than the one that created it, which is
+   fine as long as every thread both creates and runs tasks.  */
+#define GOMP_TASK_CACHE_SIZE (sizeof (struct gomp_task) + 128)
+#define GOMP_TASK_CACHE_MAX 64
+
+/* Allocate a task descriptor of SIZE bytes for thread THR.  */
+
+struct gomp_task *
+gomp_task_alloc (struct gomp_thread *thr, size_t size)
+{
+  struct gomp_task *task;
+
+  if (size > GOMP_TASK_CACHE_SIZE)
+    {
+      task = gomp_malloc (size);
+      task->cacheable = false;
+      return task;
+    }
+
+  task = thr->task_cache;
+  if (task != NULL)
+    {
+      thr->task_cache = task->parent;
+      thr->task_cache_count--;
+    }
+  else
+    task = gomp_malloc (GOMP_TASK_CACHE_SIZE);
+  task->cacheable = true;
+  return task;
+}
+
+/* Free TASK, which thread THR has finished running.  */
+
+void
+gomp_task_free (struct gomp_thread *thr, struct gomp_task *task)
+{
+#ifdef LIBGOMP_USE_PTHREADS
+  if (task->cacheable && thr->task_cache_count < GOMP_TASK_CACHE_MAX)
+    {
+      task->parent = thr->task_cache;
+      thr->task_cache = task;
+      thr->task_cache_count++;
+      return;
+    }
+#endif
+  free (task);
+}
+
+/* Release the task descriptors and taskgroup cached by THR, which is
+   about to exit.  */
+
+void
+gomp_task_cache_free (struct gomp_thread *thr)
+{
+  struct gomp_task *task;
+
+  while ((task = thr->task_cache) != NULL)
+    {
+      thr->task_cache = task->parent;
+      free (task);
+    }
+  thr->task_cache_count = 0;
+  free (thr->taskgroup_cache);
+  thr->taskgroup_cache = NULL;
+}
+
 /* Clear the parent field of every task in LIST.  */
 
 static inline void
@@ -329,6 +399,51 @@ gomp_task_handle_depend (struct gomp_task *task, struct gomp_task *parent,
     }
 }
 
+/* Number of queued tasks per team member above which GOMP_task runs
+   plain deferrable tasks immediately.  */
+#define GOMP_TASK_QUEUED_PER_THREAD 8
+
+/* Return true if a deferrable task with FLAGS encountered in TEAM should
+   rather be executed immediately by the encountering thread.  Once the
+   team queue holds enough tasks to keep every idle thread busy, queueing
+   more of them only makes all threads contend on team->task_lock, which
+   is what limits recursive divide-and-conquer code with many threads.
+   Tasks with depend, priority or detach clauses are always queued, as
+   their ordering or completion relies on the scheduler.  */
+
+static inline bool
+gomp_task_run_immediately_p (struct gomp_team *team, unsigned flags)
+{
+  if (team->task_count > 64 * team->nthreads)
+    return true;
+  if ((flags & (GOMP_TASK_FLAG_DEPEND | GOMP_TASK_FLAG_PRIORITY
+		| GOMP_TASK_FLAG_DETACH)) != 0)
+    return false;
+  /* This is a racy read, but a stale value only changes where the task
+     runs.  */
+  return (__atomic_load_n (&team->task_queued_count, MEMMODEL_RELAXED)
+	  > GOMP_TASK_QUEUED_PER_THREAD * team->nthreads);
+}
+
+/* In the adaptive taskloop mode (GOMP_TASKLOOP_ADAPTIVE), the number of
+   pieces per team member that a taskloop without grainsize and num_tasks
+   clauses is executed in.  A task only splits off part of its iterations
+   between pieces, so this also bounds the size of the smallest task.  */
+#define GOMP_TASKLOOP_PIECES_PER_THREAD 16
+
+/* Return true if some member of TEAM is neither running a task nor has a
+   queued one to pick up, so that a task splitting its work would keep it
+   busy.  Like gomp_task_run_immediately_p, this reads the counters without
+   taking team->task_lock.  */
+
+static inline bool
+gomp_team_idle_p (struct gomp_team *team)
+{
+  return (__atomic_load_n (&team->task_queued_count, MEMMODEL_RELAXED) == 0
+	  && (__atomic_load_n (&team->task_running_count, MEMMODEL_RELAXED)
+	      < team->nthreads));
+}
+
 /* Called when encountering an explicit task directive.  If IF_CLAUSE is
    false, then we must not delay in executing the task.  If UNTIED is true,
    then the task may be executed by any member of the team.
@@ -391,7 +506,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 
   if (!if_clause || team == NULL
       || (thr->task && thr->task->final_task)
-      || team->task_count > 64 * team->nthreads)
+      || gomp_task_run_immediately_p (team, flags))
     {
       struct gomp_task task;
       gomp_sem_t completion_sem;
@@ -476,8 +591,8 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
       if (flags & GOMP_TASK_FLAG_DEPEND)
 	depend_size = ((uintptr_t) (depend[0] ? depend[0] : depend[1])
 		       * sizeof (struct gomp_task_depend_entry));
-      task = gomp_malloc (sizeof (*task) + depend_size
-			  + arg_size + arg_align - 1);
+      task = gomp_task_alloc (thr, sizeof (*task) + depend_size
+				    + arg_size + arg_align - 1);
       arg = (char *) (((uintptr_t) (task + 1) + depend_size + arg_align - 1)
 		      & ~(uintptr_t) (arg_align - 1));
       gomp_init_task (task, parent, gomp_icv (false));
@@ -509,6 +624,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
       task->fn = fn;
       task->fn_data = arg;
       task->final_task = (flags & GOMP_TASK_FLAG_FINAL) >> 1;
+      gomp_trace (GOMP_TRACE_TASK, 's', task);
       gomp_mutex_lock (&team->task_lock);
       /* If parallel or taskgroup has been cancelled, don't start new
 	 tasks.  */
@@ -581,6 +697,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
     }
 }
 
+ialias (GOMP_task)
 ialias (GOMP_taskgroup_start)
 ialias (GOMP_taskgroup_end)
 ialias (GOMP_taskgroup_reduction_register)
@@ -596,10 +713,14 @@ ialias (GOMP_taskgroup_reduction_register)
 #define TYPE unsigned long long
 #define UTYPE TYPE
 #define GOMP_taskloop GOMP_taskloop_ull
+#define gomp_taskloop_piece gomp_taskloop_piece_ull
+#define gomp_taskloop_split gomp_taskloop_split_ull
 #include "taskloop.c"
 #undef TYPE
 #undef UTYPE
 #undef GOMP_taskloop
+#undef gomp_taskloop_piece
+#undef gomp_taskloop_split
 
 static void inline
 priority_queue_move_task_first (enum priority_queue_type type,
@@ -771,11 +892,11 @@ gomp_create_target_task (struct gomp_device_descr *devicep,
 	tgt_size = 0;
     }
 
-  task = gomp_malloc (sizeof (*task) + depend_size
-		      + sizeof (*ttask)
-		      + mapnum * (sizeof (void *) + sizeof (size_t)
-				  + sizeof (unsigned short))
-		      + tgt_size);
+  task = gomp_task_alloc (thr, sizeof (*task) + depend_size
+			  + sizeof (*ttask)
+			  + mapnum * (sizeof (void *) + sizeof (size_t)
+				      + sizeof (unsigned short))
+			  + tgt_size);
   gomp_init_task (task, parent, gomp_icv (false));
   task->priority = 0;
   task->kind = GOMP_TASK_WAITING;
@@ -1378,7 +1499,7 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 	      if (to_free)
 		{
 		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (thr, to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -1395,7 +1516,7 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 	  if (to_free)
 	    {
 	      gomp_finish_task (to_free);
-	      free (to_free);
+	      gomp_task_free (thr, to_free);
 	    }
 	  return;
 	}
@@ -1408,7 +1529,7 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
       if (to_free)
 	{
 	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_free (thr, to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -1436,7 +1557,11 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    {
+	      gomp_trace (GOMP_TRACE_TASK, 'B', child_task);
+	      child_task->fn (child_task->fn_data);
+	      gomp_trace (GOMP_TRACE_TASK, 'E', child_task);
+	    }
 	  thr->task = task;
 	}
       else
@@ -1518,7 +1643,7 @@ GOMP_taskwait (void)
 	  if (to_free)
 	    {
 	      gomp_finish_task (to_free);
-	      free (to_free);
+	      gomp_task_free (thr, to_free);
 	    }
 	  if (destroy_taskwait)
 	    gomp_sem_destroy (&taskwait.taskwait_sem);
@@ -1537,7 +1662,7 @@ GOMP_taskwait (void)
 	      if (to_free)
 		{
 		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (thr, to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -1567,7 +1692,7 @@ GOMP_taskwait (void)
       if (to_free)
 	{
 	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_free (thr, to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -1594,7 +1719,11 @@ GOMP_taskwait (void)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    {
+	      gomp_trace (GOMP_TRACE_TASK, 'B', child_task);
+	      child_task->fn (child_task->fn_data);
+	      gomp_trace (GOMP_TRACE_TASK, 'E', child_task);
+	    }
 	  thr->task = task;
 	}
       else
@@ -1776,7 +1905,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	  if (to_free)
 	    {
 	      gomp_finish_task (to_free);
-	      free (to_free);
+	      gomp_task_free (thr, to_free);
 	    }
 	  gomp_sem_destroy (&taskwait.taskwait_sem);
 	  return;
@@ -1810,7 +1939,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	      if (to_free)
 		{
 		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (thr, to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -1831,7 +1960,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
       if (to_free)
 	{
 	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_free (thr, to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -1858,7 +1987,11 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    {
+	      gomp_trace (GOMP_TRACE_TASK, 'B', child_task);
+	      child_task->fn (child_task->fn_data);
+	      gomp_trace (GOMP_TRACE_TASK, 'E', child_task);
+	    }
 	  thr->task = task;
 	}
       else
@@ -1904,8 +2037,12 @@ GOMP_taskyield (void)
 static inline struct gomp_taskgroup *
 gomp_taskgroup_init (struct gomp_taskgroup *prev)
 {
-  struct gomp_taskgroup *taskgroup
-    = gomp_malloc (sizeof (struct gomp_taskgroup));
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_taskgroup *taskgroup = thr->taskgroup_cache;
+  if (taskgroup != NULL)
+    thr->taskgroup_cache = NULL;
+  else
+    taskgroup = gomp_malloc (sizeof (struct gomp_taskgroup));
   taskgroup->prev = prev;
   priority_queue_init (&taskgroup->taskgroup_queue);
   taskgroup->reductions = prev ? prev->reductions : NULL;
@@ -1992,7 +2129,7 @@ GOMP_taskgroup_end (void)
 	      if (to_free)
 		{
 		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (thr, to_free);
 		}
 	      goto finish;
 	    }
@@ -2010,7 +2147,7 @@ GOMP_taskgroup_end (void)
 	      if (to_free)
 		{
 		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (thr, to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -2035,7 +2172,7 @@ GOMP_taskgroup_end (void)
       if (to_free)
 	{
 	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_free (thr, to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -2062,7 +2199,11 @@ GOMP_taskgroup_end (void)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    {
+	      gomp_trace (GOMP_TRACE_TASK, 'B', child_task);
+	      child_task->fn (child_task->fn_data);
+	      gomp_trace (GOMP_TRACE_TASK, 'E', child_task);
+	    }
 	  thr->task = task;
 	}
       else
@@ -2105,7 +2246,12 @@ GOMP_taskgroup_end (void)
  finish:
   task->taskgroup = taskgroup->prev;
   gomp_sem_destroy (&taskgroup->taskgroup_sem);
-  free (taskgroup);
+#ifdef LIBGOMP_USE_PTHREADS
+  if (thr->taskgroup_cache == NULL)
+    thr->taskgroup_cache = taskgroup;
+  else
+#endif
+    free (taskgroup);
 }
 
 static inline __attribute__((always_inline)) void
@@ -2208,6 +2354,7 @@ gomp_create_artificial_team (void)
   thr->ts.last_work_share = NULL;
 #ifdef HAVE_SYNC_BUILTINS
   thr->ts.single_count = 0;
+  thr->ts.dynamic_next = thr->ts.dynamic_end = 0;
 #endif
   thr->ts.static_trip = 0;
   thr->task = &team->implicit_task[0];
@@ -26,6 +26,63 @@
 /* This file handles the taskloop construct.  It is included twice, once
    for the long and once for unsigned long long variant.  */
 
+/* The data of a task of an adaptive taskloop: the iterations it has yet to
+   run and how to run them.  The task data to pass to FN, as it was when
+   the taskloop was encountered, follows at DATA_OFFSET.  */
+
+struct gomp_taskloop_piece
+{
+  void (*fn) (void *);
+  long arg_size, arg_align;
+  long data_offset, size, align;
+  unsigned flags;
+  int priority;
+  TYPE start, step;
+  UTYPE n, grain;
+};
+
+/* The task function of an adaptive taskloop.  Run the iterations of the
+   task GRAIN at a time, and whenever some thread of the team is idle in
+   between, hand the upper half of the remaining ones to a new task.  This
+   way the loop is only split as finely as the available parallelism and
+   the imbalance of the iterations require.  */
+
+static void
+gomp_taskloop_split (void *data)
+{
+  struct gomp_taskloop_piece *piece = (struct gomp_taskloop_piece *) data;
+  struct gomp_team *team = gomp_thread ()->ts.team;
+  char *orig_arg = (char *) piece + piece->data_offset;
+  char buf[piece->arg_size + piece->arg_align - 1];
+  char *arg = (char *) (((uintptr_t) buf + piece->arg_align - 1)
+			& ~(uintptr_t) (piece->arg_align - 1));
+
+  while (piece->n)
+    {
+      UTYPE n = piece->n;
+      if (n >= 2 * piece->grain && gomp_team_idle_p (team))
+	{
+	  TYPE start = piece->start;
+	  piece->start = start + (TYPE) (n - n / 2) * piece->step;
+	  piece->n = n / 2;
+	  ialias_call (GOMP_task) (gomp_taskloop_split, piece, NULL,
+				   piece->size, piece->align, true,
+				   piece->flags, NULL, piece->priority, NULL);
+	  piece->start = start;
+	  piece->n = n - n / 2;
+	  continue;
+	}
+      if (n > piece->grain)
+	n = piece->grain;
+      memcpy (arg, orig_arg, piece->arg_size);
+      ((TYPE *)arg)[0] = piece->start;
+      piece->start += (TYPE) n * piece->step;
+      ((TYPE *)arg)[1] = piece->start;
+      piece->n -= n;
+      piece->fn (arg);
+    }
+}
+
 /* Called when encountering an explicit task directive.  If IF_CLAUSE is
    false, then we must not delay in executing the task.  If UNTIED is true,
    then the task may be executed by any member of the team.  */
@@ -84,6 +141,17 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
     }
 #endif
 
+  /* Without grainsize and num_tasks clauses, the number of tasks is up to
+     the implementation, so in the adaptive mode the tasks split their
+     iterations further while running.  Splitting copies the task data, so
+     it is not done if that needs copy constructors.  The new tasks are not
+     children of the encountering task, so it is also not done for nogroup,
+     where the encountering task could wait for its children only.  */
+  bool adaptive = (gomp_taskloop_adaptive_var
+		   && num_tasks == 0
+		   && cpyfn == NULL
+		   && (flags & (GOMP_TASK_FLAG_GRAINSIZE | GOMP_TASK_FLAG_FINAL
+				| GOMP_TASK_FLAG_NOGROUP)) == 0);
   TYPE task_step = step;
   unsigned long nfirst = n;
   if (flags & GOMP_TASK_FLAG_GRAINSIZE)
@@ -258,6 +326,44 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	    gomp_end_task ();
 	  }
     }
+  else if (adaptive)
+    {
+      struct gomp_taskloop_piece *piece;
+      long data_offset = ((sizeof (*piece) + arg_align - 1)
+			  & ~(arg_align - 1));
+      long align = arg_align > __alignof__ (*piece)
+		   ? arg_align : __alignof__ (*piece);
+      char buf[data_offset + arg_size + align - 1];
+      UTYPE div = n / num_tasks;
+      UTYPE mod = n % num_tasks;
+      UTYPE grain = n / (num_tasks * GOMP_TASKLOOP_PIECES_PER_THREAD);
+      unsigned long i;
+
+      piece = (struct gomp_taskloop_piece *)
+	      (((uintptr_t) buf + align - 1) & ~(uintptr_t) (align - 1));
+      piece->fn = fn;
+      piece->arg_size = arg_size;
+      piece->arg_align = arg_align;
+      piece->data_offset = data_offset;
+      piece->size = data_offset + arg_size;
+      piece->align = align;
+      piece->flags = flags & GOMP_TASK_FLAG_UNTIED;
+      if (priority)
+	piece->flags |= GOMP_TASK_FLAG_PRIORITY;
+      piece->priority = priority;
+      piece->start = start;
+      piece->step = step;
+      piece->grain = grain ? grain : 1;
+      memcpy ((char *) piece + data_offset, data, arg_size);
+      for (i = 0; i < num_tasks; i++)
+	{
+	  piece->n = div + (i < mod);
+	  ialias_call (GOMP_task) (gomp_taskloop_split, piece, NULL,
+				   piece->size, piece->align, true,
+				   piece->flags, NULL, priority, NULL);
+	  piece->start += (TYPE) piece->n * step;
+	}
+    }
   else
     {
       struct gomp_task *tasks[num_tasks];
@@ -270,7 +376,7 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
       for (i = 0; i < num_tasks; i++)
 	{
 	  struct gomp_task *task
-	    = gomp_malloc (sizeof (*task) + arg_size + arg_align - 1);
+	    = gomp_task_alloc (thr, sizeof (*task) + arg_size + arg_align - 1);
 	  tasks[i] = task;
 	  arg = (char *) (((uintptr_t) (task + 1) + arg_align - 1)
 			  & ~(uintptr_t) (arg_align - 1));
@@ -297,6 +403,7 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	  task->fn = fn;
 	  task->fn_data = arg;
 	  task->final_task = (flags & GOMP_TASK_FLAG_FINAL) >> 1;
+	  gomp_trace (GOMP_TRACE_TASK, 's', task);
 	}
       gomp_mutex_lock (&team->task_lock);
       /* If parallel or taskgroup has been cancelled, don't start new
@@ -61,6 +61,53 @@ struct gomp_thread_start_data
 };
 
 
+/* Install the team state handed over in DATA into THR.  */
+
+static inline void
+gomp_thread_start_init (struct gomp_thread *thr,
+			struct gomp_thread_start_data *data)
+{
+  thr->thread_pool = data->thread_pool;
+  thr->ts = data->ts;
+  thr->task = data->task;
+  thr->place = data->place;
+#ifdef GOMP_NEEDS_THREAD_HANDLE
+  thr->handle = data->handle;
+#endif
+}
+
+/* Queue THR, which has finished its part of a nested team, on the idle
+   list of POOL so that a later nested team can take it over.  */
+
+static inline void
+gomp_nested_thread_dock (struct gomp_thread_pool *pool,
+			 struct gomp_thread *thr)
+{
+  gomp_mutex_lock (&pool->nested_idle_lock);
+  thr->nested_next = pool->nested_idle;
+  pool->nested_idle = thr;
+  gomp_mutex_unlock (&pool->nested_idle_lock);
+}
+
+/* Detach up to N idle nested threads from POOL and return them as a
+   list linked through nested_next.  */
+
+static struct gomp_thread *
+gomp_nested_threads_take (struct gomp_thread_pool *pool, unsigned n)
+{
+  struct gomp_thread *list, **tail;
+
+  gomp_mutex_lock (&pool->nested_idle_lock);
+  list = pool->nested_idle;
+  tail = &list;
+  while (n-- > 0 && *tail != NULL)
+    tail = &(*tail)->nested_next;
+  pool->nested_idle = *tail;
+  *tail = NULL;
+  gomp_mutex_unlock (&pool->nested_idle_lock);
+  return list;
+}
+
 /* This function is a pthread_create entry point.  This contains the idle
    loop in which a thread waits to be called up to become part of a team.  */
 
@@ -80,17 +127,15 @@ gomp_thread_start (void *xdata)
   thr = &local_thr;
 #endif
   gomp_sem_init (&thr->release, 0);
+  thr->task_cache = NULL;
+  thr->task_cache_count = 0;
+  thr->taskgroup_cache = NULL;
+  thr->trace_buffer = NULL;
 
   /* Extract what we need from data.  */
   local_fn = data->fn;
   local_data = data->fn_data;
-  thr->thread_pool = data->thread_pool;
-  thr->ts = data->ts;
-  thr->task = data->task;
-  thr->place = data->place;
-#ifdef GOMP_NEEDS_THREAD_HANDLE
-  thr->handle = data->handle;
-#endif
+  gomp_thread_start_init (thr, data);
 #if !(defined HAVE_TLS || defined USE_EMUTLS)
   pthread_setspecific (gomp_tls_key, thr);
 #endif
@@ -102,15 +147,41 @@ gomp_thread_start (void *xdata)
 
   if (data->nested)
     {
-      struct gomp_team *team = thr->ts.team;
-      struct gomp_task *task = thr->task;
+      gomp_sem_init (&thr->nested_release, 0);
+      while (1)
+	{
+	  struct gomp_team *team = thr->ts.team;
+	  struct gomp_task *task = thr->task;
 
-      gomp_barrier_wait (&team->barrier);
+	  gomp_barrier_wait (&team->barrier);
 
-      local_fn (local_data);
-      gomp_team_barrier_wait_final (&team->barrier);
-      gomp_finish_task (task);
-      gomp_barrier_wait_last (&team->barrier);
+	  gomp_trace (GOMP_TRACE_PARALLEL, 'B', NULL);
+	  local_fn (local_data);
+	  gomp_trace (GOMP_TRACE_PARALLEL, 'E', NULL);
+	  gomp_trace (GOMP_TRACE_BARRIER, 'B', NULL);
+	  gomp_team_barrier_wait_final (&team->barrier);
+	  gomp_trace (GOMP_TRACE_BARRIER, 'E', NULL);
+	  gomp_finish_task (task);
+
+	  /* Dock before the final barrier, so that the pool can't be
+	     freed while this thread is still on its way to the idle list.
+	     Nothing but the local TEAM is used after this point, and
+	     whoever takes the thread over only writes its state and then
+	     posts nested_release.  */
+	  gomp_nested_thread_dock (pool, thr);
+	  gomp_barrier_wait_last (&team->barrier);
+
+	  gomp_sem_wait (&thr->nested_release);
+	  data = thr->data;
+	  if (data == NULL)
+	    break;
+	  local_fn = data->fn;
+	  local_data = data->fn_data;
+	  gomp_thread_start_init (thr, data);
+	  thr->ts.team->ordered_release[thr->ts.team_id] = &thr->release;
+	  pool = thr->thread_pool;
+	}
+      gomp_sem_destroy (&thr->nested_release);
     }
   else
     {
@@ -122,8 +193,12 @@ gomp_thread_start (void *xdata)
 	  struct gomp_team *team = thr->ts.team;
 	  struct gomp_task *task = thr->task;
 
+	  gomp_trace (GOMP_TRACE_PARALLEL, 'B', NULL);
 	  local_fn (local_data);
+	  gomp_trace (GOMP_TRACE_PARALLEL, 'E', NULL);
+	  gomp_trace (GOMP_TRACE_BARRIER, 'B', NULL);
 	  gomp_team_barrier_wait_final (&team->barrier);
+	  gomp_trace (GOMP_TRACE_BARRIER, 'E', NULL);
 	  gomp_finish_task (task);
 
 	  gomp_simple_barrier_wait (&pool->threads_dock);
@@ -136,6 +211,7 @@ gomp_thread_start (void *xdata)
     }
 
   gomp_sem_destroy (&thr->release);
+  gomp_task_cache_free (thr);
   pthread_detach (pthread_self ());
   thr->thread_pool = NULL;
   thr->task = NULL;
@@ -178,7 +254,7 @@ gomp_new_team (unsigned nthreads)
 #ifndef HAVE_SYNC_BUILTINS
       gomp_mutex_init (&team->work_share_list_free_lock);
 #endif
-      gomp_barrier_init (&team->barrier, nthreads);
+      gomp_team_barrier_init (&team->barrier, nthreads);
       gomp_mutex_init (&team->task_lock);
 
       team->nthreads = nthreads;
@@ -222,7 +298,7 @@ free_team (struct gomp_team *team)
 #ifndef HAVE_SYNC_BUILTINS
   gomp_mutex_destroy (&team->work_share_list_free_lock);
 #endif
-  gomp_barrier_destroy (&team->barrier);
+  gomp_team_barrier_destroy (&team->barrier);
   gomp_mutex_destroy (&team->task_lock);
   priority_queue_free (&team->task_queue);
   team_free (team);
@@ -236,6 +312,7 @@ gomp_free_pool_helper (void *thread_pool)
     = (struct gomp_thread_pool *) thread_pool;
   gomp_simple_barrier_wait_last (&pool->threads_dock);
   gomp_sem_destroy (&thr->release);
+  gomp_task_cache_free (thr);
   thr->thread_pool = NULL;
   thr->task = NULL;
 #ifdef LIBGOMP_USE_PTHREADS
@@ -251,6 +328,26 @@ gomp_free_pool_helper (void *thread_pool)
 #endif
 }
 
+#ifdef LIBGOMP_USE_PTHREADS
+/* Wake up the threads idling after nested teams of POOL and let them
+   exit.  */
+
+static void
+gomp_free_nested_threads (struct gomp_thread_pool *pool)
+{
+  struct gomp_thread *nthr, *next;
+
+  for (nthr = pool->nested_idle; nthr != NULL; nthr = next)
+    {
+      next = nthr->nested_next;
+      nthr->data = NULL;
+      gomp_sem_post (&nthr->nested_release);
+    }
+  pool->nested_idle = NULL;
+  gomp_mutex_destroy (&pool->nested_idle_lock);
+}
+#endif
+
 /* Free a thread pool and release its threads. */
 
 void
@@ -286,6 +383,9 @@ gomp_free_thread (void *arg __attribute__((unused)))
 	  gomp_mutex_unlock (&gomp_managed_threads_lock);
 #endif
 	}
+#ifdef LIBGOMP_USE_PTHREADS
+      gomp_free_nested_threads (pool);
+#endif
       if (pool->last_team)
 	free_team (pool->last_team);
 #ifndef __nvptx__
@@ -302,6 +402,7 @@ gomp_free_thread (void *arg __attribute__((unused)))
       gomp_end_task ();
       free (task);
     }
+  gomp_task_cache_free (thr);
 }
 
 /* Launch a team.  */
@@ -325,6 +426,7 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   unsigned int s = 0, rest = 0, p = 0, k = 0;
   unsigned int affinity_count = 0;
   struct gomp_thread **affinity_thr = NULL;
+  struct gomp_thread *idle_thr = NULL;
   bool force_display = false;
 
   thr = gomp_thread ();
@@ -354,6 +456,7 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   thr->ts.last_work_share = NULL;
 #ifdef HAVE_SYNC_BUILTINS
   thr->ts.single_count = 0;
+  thr->ts.dynamic_next = thr->ts.dynamic_end = 0;
 #endif
   thr->ts.static_trip = 0;
   thr->task = &team->implicit_task[0];
@@ -375,6 +478,7 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   thr->task->taskgroup = taskgroup;
   team->implicit_task[0].icv.nthreads_var = nthreads_var;
   team->implicit_task[0].icv.bind_var = bind_var;
+  gomp_trace (GOMP_TRACE_PARALLEL, 'B', NULL);
 
   if (nthreads == 1)
     return;
@@ -449,11 +553,12 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   else
     bind = omp_proc_bind_false;
 
-  /* We only allow the reuse of idle threads for non-nested PARALLEL
-     regions.  This appears to be implied by the semantics of
+  /* We only allow the reuse of the pool's threads for non-nested
+     PARALLEL regions.  This appears to be implied by the semantics of
      threadprivate variables, but perhaps that's reading too much into
      things.  Certainly it does prevent any locking problems, since
-     only the initial program thread will modify gomp_threads.  */
+     only the initial program thread will modify gomp_threads.  Nested
+     teams draw on the separate nested_idle list below.  */
   if (!nested)
     {
       old_threads_used = pool->threads_used;
@@ -643,6 +748,7 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
 	  nthr->ts.def_allocator = thr->ts.def_allocator;
 #ifdef HAVE_SYNC_BUILTINS
 	  nthr->ts.single_count = 0;
+	  nthr->ts.dynamic_next = nthr->ts.dynamic_end = 0;
 #endif
 	  nthr->ts.static_trip = 0;
 	  nthr->task = &team->implicit_task[i];
@@ -748,6 +854,13 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   start_data = gomp_alloca (sizeof (struct gomp_thread_start_data)
 			    * (nthreads - i));
 
+  /* Threads left over from earlier nested teams are put to work before
+     any new ones are created.  Without places their binding doesn't
+     matter, and OpenMP makes no promises about threadprivate data in
+     nested regions.  */
+  if (nested && __builtin_expect (gomp_places_list == NULL, 1))
+    idle_thr = gomp_nested_threads_take (pool, nthreads - i);
+
   /* Launch new threads.  */
   for (; i < nthreads; ++i)
     {
@@ -831,6 +944,7 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
       start_data->ts.def_allocator = thr->ts.def_allocator;
 #ifdef HAVE_SYNC_BUILTINS
       start_data->ts.single_count = 0;
+      start_data->ts.dynamic_next = start_data->ts.dynamic_end = 0;
 #endif
       start_data->ts.static_trip = 0;
       start_data->task = &team->implicit_task[i];
@@ -841,6 +955,16 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
       start_data->thread_pool = pool;
       start_data->nested = nested;
 
+      if (idle_thr != NULL)
+	{
+	  struct gomp_thread *nthr = idle_thr;
+	  idle_thr = nthr->nested_next;
+	  start_data->handle = gomp_thread_to_pthread_t (nthr);
+	  nthr->data = start_data++;
+	  gomp_sem_post (&nthr->nested_release);
+	  continue;
+	}
+
       attr = gomp_adjust_thread_attr (attr, &thread_attr);
       err = pthread_create (&start_data->handle, attr, gomp_thread_start,
 			    start_data);
@@ -940,7 +1064,10 @@ gomp_team_end (void)
      As #pragma omp cancel parallel might get awaited count in
      team->barrier in a inconsistent state, we need to use a different
      counter here.  */
+  gomp_trace (GOMP_TRACE_PARALLEL, 'E', NULL);
+  gomp_trace (GOMP_TRACE_BARRIER, 'B', NULL);
   gomp_team_barrier_wait_final (&team->barrier);
+  gomp_trace (GOMP_TRACE_BARRIER, 'E', NULL);
   if (__builtin_expect (team->team_cancelled, 0))
     {
       struct gomp_work_share *ws = team->work_shares_to_free;
@@ -1085,6 +1212,7 @@ gomp_pause_host (void)
 	  for (i = 1; i < pool->threads_used; i++)
 	    pthread_join (thrs[i], NULL);
 	}
+      gomp_free_nested_threads (pool);
       if (pool->last_team)
 	free_team (pool->last_team);
 #ifndef __nvptx__
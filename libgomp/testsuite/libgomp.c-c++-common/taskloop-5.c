@@ -0,0 +1,50 @@
+/* { dg-do run } */
+/* { dg-options "-O2" } */
+/* { dg-set-target-env-var GOMP_TASKLOOP_ADAPTIVE "true" } */
+
+#include <omp.h>
+#include <stdlib.h>
+
+int a[4096];
+unsigned long long b[4096];
+
+__attribute__((noinline, noclone)) void
+work (int i)
+{
+  /* The last iterations take much longer than the others.  */
+  volatile int j, k = i > 3584 ? 20000 : 10;
+  for (j = 0; j < k; j++)
+    ;
+}
+
+int
+main ()
+{
+  int i, l = -1, f = 5, s = 0;
+  unsigned long long u;
+
+  #pragma omp parallel num_threads (8)
+  #pragma omp single
+  {
+    #pragma omp taskloop firstprivate (f) lastprivate (l) reduction (+:s)
+    for (i = 0; i < 4096; i++)
+      {
+	work (i);
+	if (f != 5)
+	  abort ();
+	a[i]++;
+	l = i;
+	s += i;
+      }
+    #pragma omp taskloop
+    for (u = 0; u < 4096ULL * 3; u += 3)
+      b[u / 3] += u;
+  }
+
+  for (i = 0; i < 4096; i++)
+    if (a[i] != 1 || b[i] != 3ULL * i)
+      abort ();
+  if (l != 4095 || s != 4095 * 4096 / 2)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,39 @@
+/* { dg-do run } */
+/* { dg-set-target-env-var OMP_PLACES "ll_caches" } */
+
+#include <omp.h>
+#include <stdlib.h>
+
+int
+main ()
+{
+  int n = omp_get_num_places (), i, j, k, l;
+  if (n == 0)
+    return 0;
+  if (omp_get_proc_bind () == omp_proc_bind_false)
+    abort ();
+  for (i = 0; i < n; i++)
+    {
+      int cnt = omp_get_place_num_procs (i);
+      int *ids = malloc (cnt * sizeof (int));
+      if (cnt <= 0 || ids == NULL)
+	abort ();
+      omp_get_place_proc_ids (i, ids);
+      /* The places must not overlap.  */
+      for (j = i + 1; j < n; j++)
+	{
+	  int cnt2 = omp_get_place_num_procs (j);
+	  int *ids2 = malloc (cnt2 * sizeof (int));
+	  if (ids2 == NULL)
+	    abort ();
+	  omp_get_place_proc_ids (j, ids2);
+	  for (k = 0; k < cnt; k++)
+	    for (l = 0; l < cnt2; l++)
+	      if (ids[k] == ids2[l])
+		abort ();
+	  free (ids2);
+	}
+      free (ids);
+    }
+  return 0;
+}
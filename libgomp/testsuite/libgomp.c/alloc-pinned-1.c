@@ -0,0 +1,57 @@
+/* { dg-do run { target *-*-linux* } } */
+
+/* Test the pinned and partition allocator traits.  */
+
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void
+check (omp_allocator_handle_t a, size_t size)
+{
+  char *p;
+
+  if (a == omp_null_allocator)
+    abort ();
+  p = (char *) omp_alloc (size, a);
+  if (p == NULL)
+    abort ();
+  memset (p, 0x55, size);
+  if (p[0] != 0x55 || p[size - 1] != 0x55)
+    abort ();
+  omp_free (p, a);
+}
+
+int
+main ()
+{
+  static const omp_uintptr_t partitions[]
+    = { omp_atv_environment, omp_atv_nearest, omp_atv_blocked,
+	omp_atv_interleaved };
+  omp_alloctrait_t traits[2]
+    = { { omp_atk_pinned, omp_atv_true },
+	{ omp_atk_partition, omp_atv_environment } };
+  omp_allocator_handle_t a;
+  unsigned i;
+
+  /* Pinning can fail with a low RLIMIT_MEMLOCK, in which case the
+     default fallback allocates unpinned memory.  */
+  a = omp_init_allocator (omp_default_mem_space, 1, traits);
+  check (a, 10000);
+  omp_destroy_allocator (a);
+
+  for (i = 0; i < sizeof (partitions) / sizeof (partitions[0]); i++)
+    {
+      traits[1].value = partitions[i];
+      a = omp_init_allocator (omp_default_mem_space, 1, &traits[1]);
+      check (a, 1);
+      check (a, 1 << 20);
+      omp_destroy_allocator (a);
+
+      a = omp_init_allocator (omp_default_mem_space, 2, traits);
+      check (a, 3 * 4096 + 5);
+      omp_destroy_allocator (a);
+    }
+
+  return 0;
+}
@@ -0,0 +1,45 @@
+/* { dg-do run } */
+/* { dg-set-target-env-var GOMP_BARRIER_TREE "true" } */
+
+#include <omp.h>
+#include <stdlib.h>
+
+int a[1024];
+int count;
+
+int
+main ()
+{
+  int i, it;
+
+  omp_set_dynamic (0);
+  /* 20 threads use two full groups and a partial one.  */
+  #pragma omp parallel num_threads (20) private (i, it)
+  {
+    for (it = 0; it < 200; it++)
+      {
+	#pragma omp for
+	for (i = 0; i < 1024; i++)
+	  a[i] = it;
+	#pragma omp for nowait
+	for (i = 0; i < 1024; i++)
+	  if (a[1023 - i] != it)
+	    abort ();
+	#pragma omp barrier
+	#pragma omp single
+	count++;
+	if ((it & 15) == 0)
+	  {
+	    #pragma omp task
+	    {
+	      #pragma omp atomic
+	      count += 2;
+	    }
+	  }
+      }
+  }
+
+  if (count != 200 + 2 * 20 * 13)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,68 @@
+/* { dg-do run } */
+/* { dg-set-target-env-var OMP_CANCELLATION "true" } */
+
+/* Dynamically scheduled loops with many chunks are handed out several
+   chunks at a time.  Check that every iteration still runs exactly
+   once, and that a cancelled loop leaves no iterations behind.  */
+
+#include <omp.h>
+#include <stdlib.h>
+
+#define N 100003
+
+unsigned char seen[N];
+
+int
+main ()
+{
+  int chunk, cnt = 0;
+  long i;
+
+  for (chunk = 1; chunk <= 7; chunk += 3)
+    {
+      #pragma omp parallel num_threads (8)
+      {
+	unsigned long long u;
+
+	#pragma omp for schedule (dynamic, chunk) nowait
+	for (i = 0; i < N; i++)
+	  __atomic_fetch_add (&seen[i], 1, __ATOMIC_RELAXED);
+	#pragma omp for schedule (dynamic, chunk)
+	for (i = N - 1; i >= 0; i--)
+	  __atomic_fetch_add (&seen[i], 1, __ATOMIC_RELAXED);
+	#pragma omp for schedule (dynamic, chunk)
+	for (u = 0; u < N; u++)
+	  __atomic_fetch_add (&seen[u], 1, __ATOMIC_RELAXED);
+	#pragma omp for schedule (dynamic, chunk)
+	for (u = N; u > 0; u--)
+	  __atomic_fetch_add (&seen[u - 1], 1, __ATOMIC_RELAXED);
+	#pragma omp for schedule (monotonic: dynamic, chunk)
+	for (i = 0; i < N; i += 3)
+	  __atomic_fetch_add (&seen[i], 1, __ATOMIC_RELAXED);
+      }
+      for (i = 0; i < N; i++)
+	if (seen[i] != 4 + (i % 3 == 0))
+	  abort ();
+	else
+	  seen[i] = 0;
+    }
+
+  #pragma omp parallel num_threads (4) reduction (+:cnt)
+  {
+    #pragma omp for schedule (dynamic, 1)
+    for (i = 0; i < N; i++)
+      {
+	if (i == 10)
+	  {
+	    #pragma omp cancel for
+	  }
+	#pragma omp cancellation point for
+      }
+    #pragma omp for schedule (dynamic, 1)
+    for (i = 0; i < 1000; i++)
+      cnt++;
+  }
+  if (cnt != 1000)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,52 @@
+/* Nested teams of varying sizes, entered many times so that their
+   threads are handed from one nested team to the next.  */
+
+#include <omp.h>
+#include <stdlib.h>
+
+int
+main (void)
+{
+  int i, err = 0;
+
+  omp_set_max_active_levels (3);
+  omp_set_dynamic (0);
+  for (i = 0; i < 200; i++)
+    {
+      #pragma omp parallel num_threads (2) reduction (+:err)
+      {
+	int outer = omp_get_thread_num ();
+	int n = 2 + (i + outer) % 4, cnt = 0, last = -1;
+	#pragma omp parallel num_threads (n) reduction (+:cnt, err)
+	{
+	  int j;
+	  if (omp_get_num_threads () != n
+	      || omp_get_level () != 2
+	      || omp_get_ancestor_thread_num (1) != outer)
+	    err++;
+	  #pragma omp for ordered schedule (static, 1)
+	  for (j = 0; j < 4 * n; j++)
+	    {
+	      #pragma omp ordered
+	      {
+		if (last != j - 1)
+		  err++;
+		last = j;
+	      }
+	    }
+	  if ((i & 15) == 0)
+	    {
+	      #pragma omp parallel num_threads (2) reduction (+:err)
+	      if (omp_get_level () != 3 || omp_get_num_threads () != 2)
+		err++;
+	    }
+	  cnt++;
+	}
+	if (cnt != n || last != 4 * n - 1)
+	  err++;
+      }
+    }
+  if (err)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,30 @@
+/* { dg-set-target-env-var GOMP_TRACE "trace-1.json" } */
+
+#include <stdlib.h>
+
+int
+main ()
+{
+  int i, s = 0, t = 0;
+  #pragma omp parallel num_threads (4)
+  {
+    #pragma omp for schedule (dynamic) reduction (+:s)
+    for (i = 0; i < 1000; i++)
+      s += i;
+    #pragma omp single
+    for (i = 0; i < 64; i++)
+      #pragma omp task
+      {
+	#pragma omp atomic
+	t++;
+      }
+    #pragma omp barrier
+    #pragma omp parallel num_threads (2)
+    {
+      #pragma omp barrier
+    }
+  }
+  if (s != 499500 || t != 64)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,33 @@
+! { dg-do run }
+! Check that large asynchronous unformatted transfers, which are split
+! into concurrent requests, keep the data and the file position right.
+program main
+  implicit none
+  integer, parameter :: n = 3 * 1024 * 1024 + 17
+  real(8), allocatable :: a(:), b(:)
+  integer :: i, id1, id2, head, tail
+  allocate (a(n), b(n))
+  do i = 1, n
+    a(i) = real (i, 8) * 0.5_8
+  end do
+  open (10, file='async_io_10.dat', form='unformatted', &
+       & access='stream', asynchronous='yes')
+  write (10) 1234
+  write (10, asynchronous='yes', id=id1) a
+  write (10, asynchronous='yes', id=id2) a(n:1:-1)
+  write (10, asynchronous='yes') 5678
+  wait (10, id=id1)
+  wait (10, id=id2)
+  rewind (10)
+  read (10) head
+  if (head /= 1234) stop 1
+  read (10, asynchronous='yes') b
+  wait (10)
+  if (any (b /= a)) stop 2
+  read (10, asynchronous='yes') b
+  read (10, asynchronous='yes') tail
+  wait (10)
+  if (any (b /= a(n:1:-1))) stop 3
+  if (tail /= 5678) stop 4
+  close (10, status='delete')
+end program main
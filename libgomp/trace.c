@@ -0,0 +1,190 @@
+/* Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This file handles the GOMP_TRACE event recording.  Each thread appends
+   events to its own ring buffer without any synchronization; the buffers
+   are written out in the Chrome trace event format when the program
+   exits.  */
+
+#include "libgomp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef LIBGOMP_USE_PTHREADS
+
+ialias_redirect (omp_get_wtime)
+
+/* Number of events kept per thread; must be a power of two.  Older events
+   are overwritten once a thread has recorded more.  */
+#define GOMP_TRACE_EVENTS (1 << 16)
+
+struct gomp_trace_event
+{
+  double time;
+  void *data;
+  unsigned char kind;
+  unsigned char phase;
+};
+
+struct gomp_trace_buffer
+{
+  struct gomp_trace_buffer *next;
+  unsigned int tid;
+  unsigned long long count;
+  struct gomp_trace_event events[GOMP_TRACE_EVENTS];
+};
+
+bool gomp_trace_var;
+
+static char *gomp_trace_file;
+static struct gomp_trace_buffer *gomp_trace_buffers;
+static unsigned int gomp_trace_tids;
+
+static const char *const gomp_trace_names[] = {
+  [GOMP_TRACE_PARALLEL] = "parallel",
+  [GOMP_TRACE_BARRIER] = "barrier",
+  [GOMP_TRACE_TASK] = "task"
+};
+
+/* Allocate the buffer of the current thread.  Buffers are never freed, so
+   that the events of threads that have already exited are still written
+   out at the end.  */
+
+static struct gomp_trace_buffer *
+gomp_trace_new_buffer (struct gomp_thread *thr)
+{
+  struct gomp_trace_buffer *buf = gomp_malloc (sizeof (*buf));
+
+  buf->count = 0;
+  buf->tid = __atomic_add_fetch (&gomp_trace_tids, 1, MEMMODEL_RELAXED);
+  buf->next = __atomic_load_n (&gomp_trace_buffers, MEMMODEL_RELAXED);
+  while (!__atomic_compare_exchange_n (&gomp_trace_buffers, &buf->next, buf,
+				       true, MEMMODEL_RELEASE,
+				       MEMMODEL_RELAXED))
+    continue;
+  thr->trace_buffer = buf;
+  return buf;
+}
+
+/* Record an event of KIND in the current thread's buffer.  PHASE is one of
+   the Chrome trace phases 'B' (begin), 'E' (end) or 's' (the creation of
+   the task DATA, which the matching 'B' event of the task connects to).  */
+
+void
+gomp_trace_record (enum gomp_trace_kind kind, char phase, void *data)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_trace_buffer *buf = thr->trace_buffer;
+  struct gomp_trace_event *ev;
+
+  if (__builtin_expect (buf == NULL, 0))
+    buf = gomp_trace_new_buffer (thr);
+  ev = &buf->events[buf->count++ & (GOMP_TRACE_EVENTS - 1)];
+  ev->time = omp_get_wtime ();
+  ev->data = data;
+  ev->kind = kind;
+  ev->phase = phase;
+}
+
+/* Write out all recorded events.  Runs at exit, when the threads of the
+   pools are idle.  */
+
+static void
+gomp_trace_dump (void)
+{
+  struct gomp_trace_buffer *buf;
+  const char *sep = "";
+  int pid = getpid ();
+  FILE *f;
+
+  gomp_trace_var = false;
+  f = fopen (gomp_trace_file, "w");
+  if (f == NULL)
+    {
+      gomp_error ("Unable to open GOMP_TRACE file %s", gomp_trace_file);
+      return;
+    }
+
+  fputs ("{\"traceEvents\":[", f);
+  for (buf = __atomic_load_n (&gomp_trace_buffers, MEMMODEL_ACQUIRE);
+       buf != NULL; buf = buf->next)
+    {
+      unsigned long long i = 0;
+
+      if (buf->count > GOMP_TRACE_EVENTS)
+	i = buf->count - GOMP_TRACE_EVENTS;
+      for (; i < buf->count; i++)
+	{
+	  struct gomp_trace_event *ev
+	    = &buf->events[i & (GOMP_TRACE_EVENTS - 1)];
+	  const char *name = gomp_trace_names[ev->kind];
+	  double ts = ev->time * 1e6;
+
+	  if (ev->kind == GOMP_TRACE_TASK && ev->phase != 'E')
+	    {
+	      /* Task creation and start are connected by a flow event,
+		 which also shows tasks run by other threads than the one
+		 that created them.  */
+	      fprintf (f, "%s\n{\"name\":\"task\",\"cat\":\"task\","
+			  "\"ph\":\"%c\",%s\"id\":\"%p\",\"ts\":%.3f,"
+			  "\"pid\":%d,\"tid\":%u}",
+		       sep, ev->phase == 's' ? 's' : 'f',
+		       ev->phase == 's' ? "" : "\"bp\":\"e\",",
+		       ev->data, ts, pid, buf->tid);
+	      sep = ",";
+	      if (ev->phase == 's')
+		continue;
+	    }
+	  fprintf (f, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,"
+		      "\"pid\":%d,\"tid\":%u}",
+		   sep, name, ev->phase, ts, pid, buf->tid);
+	  sep = ",";
+	}
+      if (buf->count > GOMP_TRACE_EVENTS)
+	gomp_error ("GOMP_TRACE: thread %u lost %llu events", buf->tid,
+		    buf->count - GOMP_TRACE_EVENTS);
+    }
+  fputs ("\n]}\n", f);
+  fclose (f);
+}
+
+/* Enable tracing to the file NAME.  Called from initialize_env.  */
+
+void
+gomp_trace_init (const char *name)
+{
+  if (*name == '\0')
+    return;
+  gomp_trace_file = strdup (name);
+  if (gomp_trace_file == NULL || atexit (gomp_trace_dump) != 0)
+    {
+      gomp_error ("Unable to enable GOMP_TRACE");
+      return;
+    }
+  gomp_trace_var = true;
+}
+
+#endif /* LIBGOMP_USE_PTHREADS */
@@ -215,6 +215,19 @@ gomp_work_share_start (size_t ordered)
     }
 }
 
+/* Forget the iterations of a dynamic loop that THR has claimed but not
+   run, which a cancelled loop can leave behind.  */
+
+static inline void
+gomp_work_share_drop_claimed (struct gomp_thread *thr)
+{
+#ifdef HAVE_SYNC_BUILTINS
+  thr->ts.dynamic_next = thr->ts.dynamic_end = 0;
+#else
+  (void) thr;
+#endif
+}
+
 /* The current thread is done with its current work sharing construct.
    This version does imply a barrier at the end of the work-share.  */
 
@@ -225,6 +238,8 @@ gomp_work_share_end (void)
   struct gomp_team *team = thr->ts.team;
   gomp_barrier_state_t bstate;
 
+  gomp_work_share_drop_claimed (thr);
+
   /* Work sharing constructs can be orphaned.  */
   if (team == NULL)
     {
@@ -233,7 +248,8 @@ gomp_work_share_end (void)
       return;
     }
 
-  bstate = gomp_barrier_wait_start (&team->barrier);
+  gomp_trace (GOMP_TRACE_BARRIER, 'B', NULL);
+  bstate = gomp_team_barrier_wait_start (&team->barrier, thr->ts.team_id);
 
   if (gomp_barrier_last_thread (bstate))
     {
@@ -245,6 +261,7 @@ gomp_work_share_end (void)
     }
 
   gomp_team_barrier_wait_end (&team->barrier, bstate);
+  gomp_trace (GOMP_TRACE_BARRIER, 'E', NULL);
   thr->ts.last_work_share = NULL;
 }
 
@@ -258,7 +275,10 @@ gomp_work_share_end_cancel (void)
   struct gomp_team *team = thr->ts.team;
   gomp_barrier_state_t bstate;
 
+  gomp_work_share_drop_claimed (thr);
+
   /* Cancellable work sharing constructs cannot be orphaned.  */
+  gomp_trace (GOMP_TRACE_BARRIER, 'B', NULL);
   bstate = gomp_barrier_wait_cancel_start (&team->barrier);
 
   if (gomp_barrier_last_thread (bstate))
@@ -271,7 +291,9 @@ gomp_work_share_end_cancel (void)
     }
   thr->ts.last_work_share = NULL;
 
-  return gomp_team_barrier_wait_cancel_end (&team->barrier, bstate);
+  bool ret = gomp_team_barrier_wait_cancel_end (&team->barrier, bstate);
+  gomp_trace (GOMP_TRACE_BARRIER, 'E', NULL);
+  return ret;
 }
 
 /* The current thread is done with its current work sharing construct.
@@ -285,6 +307,8 @@ gomp_work_share_end_nowait (void)
   struct gomp_work_share *ws = thr->ts.work_share;
   unsigned completed;
 
+  gomp_work_share_drop_claimed (thr);
+
   /* Work sharing constructs can be orphaned.  */
   if (team == NULL)
     {
@@ -0,0 +1,50 @@
+/* Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of the GNU Transactional Memory Library (libitm).
+
+   Libitm is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   Libitm is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+namespace GTM HIDDEN {
+
+typedef struct gtm_jmpbuf
+{
+  long gr[12];			/* s0-s11 */
+  void *cfa;
+  unsigned long pc;
+#if __riscv_flen == 64
+  double fr[12];		/* fs0-fs11 */
+#elif __riscv_flen == 32
+  float fr[12];			/* fs0-fs11 */
+#endif
+} gtm_jmpbuf;
+
+/* The size of one line in hardware caches (in bytes). */
+#define HW_CACHELINE_SIZE 64
+
+static inline void
+cpu_relax (void)
+{
+  /* PAUSE from Zihintpause.  It is encoded as a FENCE hint with no
+     predecessor or successor set, so it executes as a no-op on cores
+     without Zihintpause and assemblers that do not know it.  */
+  __asm volatile (".insn i 0x0f, 0, x0, x0, 0x010" : : : "memory");
+}
+
+} // namespace GTM
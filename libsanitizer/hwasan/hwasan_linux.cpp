@@ -118,6 +118,15 @@ void InitPrctl() {
 #define PR_SET_TAGGED_ADDR_CTRL 55
 #define PR_GET_TAGGED_ADDR_CTRL 56
 #define PR_TAGGED_ADDR_ENABLE (1UL << 0)
+#if SANITIZER_RISCV64
+  // Pointer masking only ignores as many top bits as requested in PMLEN,
+  // rounded up to a length the hardware supports.
+#define PR_PMLEN_SHIFT 24
+  const uptr tagged_addr_ctrl = PR_TAGGED_ADDR_ENABLE | (8UL << PR_PMLEN_SHIFT);
+#undef PR_PMLEN_SHIFT
+#else
+  const uptr tagged_addr_ctrl = PR_TAGGED_ADDR_ENABLE;
+#endif
   // Check we're running on a kernel that can use the tagged address ABI.
   if (internal_prctl(PR_GET_TAGGED_ADDR_CTRL, 0, 0, 0, 0) == (uptr)-1 &&
       errno == EINVAL) {
@@ -137,7 +146,7 @@ void InitPrctl() {
   }
 
   // Turn on the tagged address ABI.
-  if (internal_prctl(PR_SET_TAGGED_ADDR_CTRL, PR_TAGGED_ADDR_ENABLE, 0, 0, 0) ==
+  if (internal_prctl(PR_SET_TAGGED_ADDR_CTRL, tagged_addr_ctrl, 0, 0, 0) ==
           (uptr)-1 ||
       !internal_prctl(PR_GET_TAGGED_ADDR_CTRL, 0, 0, 0, 0)) {
     Printf(
@@ -325,6 +334,18 @@ struct AccessInfo {
   bool recover;
 };
 
+#if SANITIZER_RISCV64
+// Return the size of the EBREAK or C.EBREAK instruction at PC, or 0 if there
+// is none.
+static uptr GetEbreakSize(uptr pc) {
+  if (*(u16 *)pc == 0x9002)
+    return 2;
+  if (*(u16 *)pc == 0x0073 && *(u16 *)(pc + 2) == 0x0010)
+    return 4;
+  return 0;
+}
+#endif
+
 static AccessInfo GetAccessInfo(siginfo_t *info, ucontext_t *uc) {
   // Access type is passed in a platform dependent way (see below) and encoded
   // as 0xXY, where X&1 is 1 for store, 0 for load, and X&2 is 1 if the error is
@@ -368,6 +389,30 @@ static AccessInfo GetAccessInfo(siginfo_t *info, ucontext_t *uc) {
   const uptr size =
       size_log == 0xf ? uc->uc_mcontext.gregs[REG_RSI] : 1U << size_log;
 
+#elif SANITIZER_RISCV64
+  // Access type is encoded in the instruction following EBREAK (or C.EBREAK)
+  // as ADDIW X0, X0, 0x40 + 0xXY. For Y == 0xF, access size is stored in X11
+  // register. Access address is always in X10 register.
+  uptr pc = (uptr)uc->uc_mcontext.__gregs[REG_PC];
+  uptr ebreak_size = GetEbreakSize(pc);
+  if (!ebreak_size)
+    return AccessInfo{}; // Not ours.
+  // The ADDIW is only 2-byte aligned after a C.EBREAK.
+  u32 addiw = *(u16 *)(pc + ebreak_size)
+              | ((u32)*(u16 *)(pc + ebreak_size + 2) << 16);
+  const unsigned code = addiw >> 20;
+  if ((addiw & 0xfffff) != 0x1b || (code & 0xfc0) != 0x40)
+    return AccessInfo{}; // Not ours.
+
+  const bool is_store = code & 0x10;
+  const bool recover = code & 0x20;
+  const uptr addr = uc->uc_mcontext.__gregs[10];
+  const unsigned size_log = code & 0xf;
+  if (size_log > 4 && size_log != 0xf)
+    return AccessInfo{}; // Not ours.
+  const uptr size =
+      size_log == 0xf ? uc->uc_mcontext.__gregs[11] : 1U << size_log;
+
 #else
 # error Unsupported architecture
 #endif
@@ -408,6 +453,10 @@ static bool HwasanOnSIGTRAP(int signo, siginfo_t *info, ucontext_t *uc) {
 #if defined(__aarch64__)
   uc->uc_mcontext.pc += 4;
 #elif defined(__x86_64__)
+#elif SANITIZER_RISCV64
+  // Resume at the ADDIW, which is a no-op.
+  uc->uc_mcontext.__gregs[REG_PC] +=
+      GetEbreakSize(uc->uc_mcontext.__gregs[REG_PC]);
 #else
 # error Unsupported architecture
 #endif
@@ -206,13 +206,12 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 #ifdef _GLIBCXX_HAVE_PLATFORM_TIMED_WAIT
 	  return __platform_wait_until(__addr, __old, __atime);
 #else
+	  lock_guard<mutex> __l(_M_mtx);
 	  __platform_wait_t __val;
 	  __atomic_load(__addr, &__val, __ATOMIC_RELAXED);
 	  if (__val == __old)
-	    {
-	      lock_guard<mutex> __l(_M_mtx);
-	      return __cond_wait_until(_M_cv, _M_mtx, __atime);
-	    }
+	    return __cond_wait_until(_M_cv, _M_mtx, __atime);
+	  return true;
 #endif // _GLIBCXX_HAVE_PLATFORM_TIMED_WAIT
 	}
     };
@@ -407,7 +406,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 				const chrono::time_point<_Clock, _Dur>&
 							      __atime) noexcept
     {
-      __detail::__bare_timed_wait __w{__addr};
+      // __atomic_notify_address_bare only wakes counted waiters.
+      __detail::__enters_timed_wait __w{__addr};
       return __w._M_do_wait_until(__pred, __atime);
     }
 
@@ -439,7 +439,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 			_Pred __pred,
 			const chrono::duration<_Rep, _Period>& __rtime) noexcept
     {
-      __detail::__bare_timed_wait __w{__addr};
+      __detail::__enters_timed_wait __w{__addr};
       return __w._M_do_wait_for(__pred, __rtime);
     }
 _GLIBCXX_END_NAMESPACE_VERSION
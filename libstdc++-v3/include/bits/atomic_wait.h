@@ -138,6 +138,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     {
 #if defined __i386__ || defined __x86_64__
       __builtin_ia32_pause();
+#elif defined __aarch64__
+      __asm__ __volatile__ ("isb" ::: "memory");
+#elif defined __riscv
+      // The Zihintpause PAUSE hint, which other implementations ignore.
+      __asm__ __volatile__ (".insn i 0x0f, 0, x0, x0, 0x010" ::: "memory");
 #else
       __thread_yield();
 #endif
@@ -146,6 +151,16 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     constexpr auto __atomic_spin_count_1 = 12;
     constexpr auto __atomic_spin_count_2 = 4;
 
+    // Where __thread_relax is a cheap pause instruction rather than a
+    // yield, the relaxing spins back off exponentially up to this many
+    // pauses per check of the predicate.
+#if defined __i386__ || defined __x86_64__ || defined __aarch64__ \
+    || defined __riscv
+    constexpr auto __atomic_spin_relax_max = 16;
+#else
+    constexpr auto __atomic_spin_relax_max = 1;
+#endif
+
     struct __default_spin_policy
     {
       bool
@@ -158,11 +173,14 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       bool
       __atomic_spin(_Pred& __pred, _Spin __spin = _Spin{ }) noexcept
       {
-	for (auto __i = 0; __i < __atomic_spin_count_1; ++__i)
+	for (auto __i = 0, __n = 1; __i < __atomic_spin_count_1; ++__i)
 	  {
 	    if (__pred())
 	      return true;
-	    __detail::__thread_relax();
+	    for (auto __j = 0; __j < __n; ++__j)
+	      __detail::__thread_relax();
+	    if (__n < __atomic_spin_relax_max)
+	      __n *= 2;
 	  }
 
 	for (auto __i = 0; __i < __atomic_spin_count_2; ++__i)
@@ -209,19 +227,24 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 #endif
       __waiter_pool_base() = default;
 
+      // A waiter increments _M_wait before it last checks the value it
+      // waits on, and a notifier checks _M_wait after it has changed that
+      // value, so that the notification can be skipped when nobody waits.
+      // Both sides need a full barrier between their store and their load.
       void
       _M_enter_wait() noexcept
-      { __atomic_fetch_add(&_M_wait, 1, __ATOMIC_ACQ_REL); }
+      { __atomic_fetch_add(&_M_wait, 1, __ATOMIC_SEQ_CST); }
 
       void
       _M_leave_wait() noexcept
-      { __atomic_fetch_sub(&_M_wait, 1, __ATOMIC_ACQ_REL); }
+      { __atomic_fetch_sub(&_M_wait, 1, __ATOMIC_RELEASE); }
 
       bool
       _M_waiting() const noexcept
       {
 	__platform_wait_t __res;
-	__atomic_load(&_M_wait, &__res, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	__atomic_load(&_M_wait, &__res, __ATOMIC_RELAXED);
 	return __res > 0;
       }
 
@@ -234,6 +257,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 #ifdef _GLIBCXX_HAVE_PLATFORM_WAIT
 	__platform_notify(__addr, __all);
 #else
+	lock_guard<mutex> __l(_M_mtx);
 	if (__all)
 	  _M_cv.notify_all();
 	else
@@ -241,13 +265,20 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 #endif
       }
 
+      // Unrelated atomics that hash to the same entry share its waiter
+      // count and, unless they can be waited on directly, its _M_ver, so
+      // the table must be large enough to keep collisions rare.
+      static constexpr uintptr_t _S_table_size = 256;
+
       static __waiter_pool_base&
       _S_for(const void* __addr) noexcept
       {
-	constexpr uintptr_t __ct = 16;
-	static __waiter_pool_base __w[__ct];
-	auto __key = (uintptr_t(__addr) >> 2) % __ct;
-	return __w[__key];
+	static __waiter_pool_base __w[_S_table_size];
+	// Fold in the higher bits, so that atomics a cache line or a page
+	// apart don't all share an entry.
+	auto __key = uintptr_t(__addr) >> 2;
+	__key ^= (__key >> 8) ^ (__key >> 16);
+	return __w[__key % _S_table_size];
       }
     };
 
@@ -259,13 +290,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 #ifdef _GLIBCXX_HAVE_PLATFORM_WAIT
 	__platform_wait(__addr, __old);
 #else
+	lock_guard<mutex> __l(_M_mtx);
 	__platform_wait_t __val;
 	__atomic_load(__addr, &__val, __ATOMIC_RELAXED);
 	if (__val == __old)
-	  {
-	    lock_guard<mutex> __l(_M_mtx);
-	    _M_cv.wait(_M_mtx);
-	  }
+	  _M_cv.wait(_M_mtx);
 #endif // __GLIBCXX_HAVE_PLATFORM_WAIT
       }
     };
@@ -307,7 +336,12 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	_M_notify(bool __all, bool __bare = false)
 	{
 	  if (_M_addr == &_M_w._M_ver)
-	    __atomic_fetch_add(_M_addr, 1, __ATOMIC_ACQ_REL);
+	    {
+	      // Waiters on other atomics may be blocked on the same _M_ver,
+	      // so waking just one of them could miss the intended one.
+	      __atomic_fetch_add(_M_addr, 1, __ATOMIC_ACQ_REL);
+	      __all = true;
+	    }
 	  _M_w._M_notify(_M_addr, __all, __bare);
 	}
 
@@ -324,7 +358,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 
 	    if constexpr (__platform_wait_uses_type<_Up>)
 	      {
-		__val == __old;
+		__builtin_memcpy(&__val, &__old, sizeof(__val));
 	      }
 	    else
 	      {
@@ -427,6 +461,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     }
 
   // This call is to be used by atomic types which track contention externally
+  // The waiter is only counted while it is blocked, so that the uncontended
+  // case does not touch the shared waiter pool at all.
   template<typename _Pred>
     void
     __atomic_wait_address_bare(const __detail::__platform_wait_t* __addr,
@@ -438,7 +474,10 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	  __detail::__platform_wait_t __val;
 	  if (__detail::__bare_wait::_S_do_spin(__addr, __pred, __val))
 	    return;
+	  auto& __w = __detail::__waiter_pool_base::_S_for(__addr);
+	  __w._M_enter_wait();
 	  __detail::__platform_wait(__addr, __val);
+	  __w._M_leave_wait();
 	}
       while (!__pred());
 #else // !_GLIBCXX_HAVE_PLATFORM_WAIT
@@ -452,7 +491,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __atomic_notify_address(const _Tp* __addr, bool __all) noexcept
     {
       __detail::__bare_wait __w(__addr);
-      __w._M_notify(__all, true);
+      __w._M_notify(__all);
     }
 
   // This call is to be used by atomic types which track contention externally
@@ -461,7 +500,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 			       bool __all) noexcept
   {
 #ifdef _GLIBCXX_HAVE_PLATFORM_WAIT
-    __detail::__platform_notify(__addr, __all);
+    if (__detail::__waiter_pool_base::_S_for(__addr)._M_waiting())
+      __detail::__platform_notify(__addr, __all);
 #else
     __detail::__bare_wait __w(__addr);
     __w._M_notify(__all, true);
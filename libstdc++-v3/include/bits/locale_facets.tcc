@@ -692,7 +692,9 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
 	   ios_base::iostate& __err, float& __v) const
     {
       string __xtrc;
+#if ! _GLIBCXX_USE_CXX11_ABI
       __xtrc.reserve(32);
+#endif
       __beg = _M_extract_float(__beg, __end, __io, __err, __xtrc);
       std::__convert_to_v(__xtrc.c_str(), __v, __err, _S_get_c_locale());
       if (__beg == __end)
@@ -707,7 +709,9 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
            ios_base::iostate& __err, double& __v) const
     {
       string __xtrc;
+#if ! _GLIBCXX_USE_CXX11_ABI
       __xtrc.reserve(32);
+#endif
       __beg = _M_extract_float(__beg, __end, __io, __err, __xtrc);
       std::__convert_to_v(__xtrc.c_str(), __v, __err, _S_get_c_locale());
       if (__beg == __end)
@@ -723,7 +727,9 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
 	     ios_base::iostate& __err, double& __v) const
     {
       string __xtrc;
+#if ! _GLIBCXX_USE_CXX11_ABI
       __xtrc.reserve(32);
+#endif
       __beg = _M_extract_float(__beg, __end, __io, __err, __xtrc);
       std::__convert_to_v(__xtrc.c_str(), __v, __err, _S_get_c_locale());
       if (__beg == __end)
@@ -739,7 +745,9 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
            ios_base::iostate& __err, long double& __v) const
     {
       string __xtrc;
+#if ! _GLIBCXX_USE_CXX11_ABI
       __xtrc.reserve(32);
+#endif
       __beg = _M_extract_float(__beg, __end, __io, __err, __xtrc);
       std::__convert_to_v(__xtrc.c_str(), __v, __err, _S_get_c_locale());
       if (__beg == __end)
@@ -781,7 +789,9 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
 	     ios_base::iostate& __err, __ibm128& __v) const
     {
       string __xtrc;
+#if ! _GLIBCXX_USE_CXX11_ABI
       __xtrc.reserve(32);
+#endif
       __beg = _M_extract_float(__beg, __end, __io, __err, __xtrc);
       std::__convert_to_v(__xtrc.c_str(), __v, __err, _S_get_c_locale());
       if (__beg == __end)
@@ -849,6 +859,83 @@ _GLIBCXX_END_NAMESPACE_LDBL
       return __bufend - __buf;
     }
 
+  // Decimal conversion for the "C" locale, whose digits are those of
+  // the basic character set, two digits at a time.
+  template<typename _CharT, typename _ValueT>
+    int
+    __int_to_char_c(_CharT* __bufend, _ValueT __v)
+    {
+      static const char __digits[201] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+      _CharT* __buf = __bufend;
+      while (__v >= 100)
+	{
+	  const unsigned __i = (__v % 100) * 2;
+	  __v /= 100;
+	  *--__buf = __digits[__i + 1];
+	  *--__buf = __digits[__i];
+	}
+      if (__v >= 10)
+	{
+	  const unsigned __i = __v * 2;
+	  *--__buf = __digits[__i + 1];
+	  *--__buf = __digits[__i];
+	}
+      else
+	*--__buf = '0' + __v;
+      return __bufend - __buf;
+    }
+
+  // Stage 1 of num_put::_M_insert_float without printf, for the
+  // conversions that std::to_chars does: %.*g, %.*e and %.*f of a
+  // double.  Return the end of the output, or null if printf must be
+  // used instead.
+  template<typename _ValueT>
+    inline char*
+    __float_to_char(char*, char*, ios_base::fmtflags, streamsize, _ValueT)
+    { return 0; }
+
+#if _GLIBCXX_FLOAT_IS_IEEE_BINARY32 && _GLIBCXX_DOUBLE_IS_IEEE_BINARY64
+  namespace __detail
+  {
+    // std::to_chars(__first, __last, __v, chars_format(__fmt), __prec),
+    // returning the end of the output, or null if it does not fit.
+    // Defined in src/c++17/floating_to_chars.cc.
+    char*
+    __to_chars_fmt(char* __first, char* __last, double __v, int __fmt,
+		   int __prec) _GLIBCXX_USE_NOEXCEPT;
+  }
+
+  inline char*
+  __float_to_char(char* __first, char* __last, ios_base::fmtflags __flags,
+		  streamsize __prec, double __v)
+  {
+    // The values of std::chars_format.
+    enum { __scientific = 1, __fixed = 2, __general = 3 };
+
+    if ((__flags & (ios_base::showpos | ios_base::showpoint
+		    | ios_base::uppercase))
+	|| __prec > __gnu_cxx::__numeric_traits<int>::__max)
+      return 0;
+
+    const ios_base::fmtflags __fltfield = __flags & ios_base::floatfield;
+    int __fmt;
+    if (__fltfield == ios_base::fixed)
+      __fmt = __fixed;
+    else if (__fltfield == ios_base::scientific)
+      __fmt = __scientific;
+    else if (__fltfield == ios_base::fmtflags(0))
+      __fmt = __general;
+    else
+      return 0;
+    return __detail::__to_chars_fmt(__first, __last, __v, __fmt, __prec);
+  }
+#endif
+
 _GLIBCXX_BEGIN_NAMESPACE_LDBL
 
   template<typename _CharT, typename _OutIter>
@@ -891,7 +978,12 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
 	const __unsigned_type __u = ((__v > 0 || !__dec)
 				     ? __unsigned_type(__v)
 				     : -__unsigned_type(__v));
- 	int __len = __int_to_char(__cs + __ilen, __u, __lit, __flags, __dec);
+	int __len;
+	if (!__lc->_M_allocated && __dec)
+	  // "C" locale
+	  __len = std::__int_to_char_c(__cs + __ilen, __u);
+	else
+	  __len = __int_to_char(__cs + __ilen, __u, __lit, __flags, __dec);
 	__cs += __ilen - __len;
 
 	// Add grouping, if necessary.
@@ -1019,7 +1111,10 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
 	// for non-ios_base::fixed outputs)
 	int __cs_size = __max_digits * 3;
 	char* __cs = static_cast<char*>(__builtin_alloca(__cs_size));
-	if (__use_prec)
+	if (char* __end = std::__float_to_char(__cs, __cs + __cs_size,
+					       __io.flags(), __prec, __v))
+	  __len = __end - __cs;
+	else if (__use_prec)
 	  __len = std::__convert_from_v(_S_get_c_locale(), __cs, __cs_size,
 					__fbuf, __prec, __v);
 	else
@@ -1059,47 +1154,58 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
 
 	// [22.2.2.2.2] Stage 2, convert to char_type, using correct
 	// numpunct.decimal_point() values for '.' and adding grouping.
-	const ctype<_CharT>& __ctype = use_facet<ctype<_CharT> >(__loc);
-	
 	_CharT* __ws = static_cast<_CharT*>(__builtin_alloca(sizeof(_CharT)
 							     * __len));
-	__ctype.widen(__cs, __cs + __len, __ws);
-	
-	// Replace decimal point.
-	_CharT* __wp = 0;
-	const char* __p = char_traits<char>::find(__cs, __len, '.');
-	if (__p)
+	if (__loc == locale::classic())
 	  {
-	    __wp = __ws + (__p - __cs);
-	    *__wp = __lc->_M_decimal_point;
+	    // "C" locale: the decimal point is '.', there is no grouping,
+	    // and widening leaves the basic character set unchanged, so
+	    // the ctype facet need not be looked up.
+	    for (int __i = 0; __i < __len; ++__i)
+	      __ws[__i] = __cs[__i];
 	  }
-	
-	// Add grouping, if necessary.
-	// N.B. Make sure to not group things like 2e20, i.e., no decimal
-	// point, scientific notation.
-	if (__lc->_M_use_grouping
-	    && (__wp || __len < 3 || (__cs[1] <= '9' && __cs[2] <= '9'
-				      && __cs[1] >= '0' && __cs[2] >= '0')))
+	else
 	  {
-	    // Grouping can add (almost) as many separators as the
-	    // number of digits, but no more.
-	    _CharT* __ws2 = static_cast<_CharT*>(__builtin_alloca(sizeof(_CharT)
-								  * __len * 2));
-	    
-	    streamsize __off = 0;
-	    if (__cs[0] == '-' || __cs[0] == '+')
+	    const ctype<_CharT>& __ctype = use_facet<ctype<_CharT> >(__loc);
+	    __ctype.widen(__cs, __cs + __len, __ws);
+
+	    // Replace decimal point.
+	    _CharT* __wp = 0;
+	    const char* __p = char_traits<char>::find(__cs, __len, '.');
+	    if (__p)
 	      {
-		__off = 1;
-		__ws2[0] = __ws[0];
-		__len -= 1;
+		__wp = __ws + (__p - __cs);
+		*__wp = __lc->_M_decimal_point;
+	      }
+
+	    // Add grouping, if necessary.
+	    // N.B. Make sure to not group things like 2e20, i.e., no decimal
+	    // point, scientific notation.
+	    if (__lc->_M_use_grouping
+		&& (__wp || __len < 3 || (__cs[1] <= '9' && __cs[2] <= '9'
+					  && __cs[1] >= '0' && __cs[2] >= '0')))
+	      {
+		// Grouping can add (almost) as many separators as the
+		// number of digits, but no more.
+		_CharT* __ws2 =
+		  static_cast<_CharT*>(__builtin_alloca(sizeof(_CharT)
+							* __len * 2));
+
+		streamsize __off = 0;
+		if (__cs[0] == '-' || __cs[0] == '+')
+		  {
+		    __off = 1;
+		    __ws2[0] = __ws[0];
+		    __len -= 1;
+		  }
+
+		_M_group_float(__lc->_M_grouping, __lc->_M_grouping_size,
+			       __lc->_M_thousands_sep, __wp, __ws2 + __off,
+			       __ws + __off, __len);
+		__len += __off;
+
+		__ws = __ws2;
 	      }
-	    
-	    _M_group_float(__lc->_M_grouping, __lc->_M_grouping_size,
-			   __lc->_M_thousands_sep, __wp, __ws2 + __off,
-			   __ws + __off, __len);
-	    __len += __off;
-	    
-	    __ws = __ws2;
 	  }
 
 	// Pad.
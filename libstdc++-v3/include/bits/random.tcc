@@ -398,12 +398,15 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       const _UIntType __upper_mask = (~_UIntType()) << __r;
       const _UIntType __lower_mask = ~__upper_mask;
 
+      // Select __a with a mask rather than a branch, which is taken at
+      // random and which would keep the loops from being vectorized.
+
       for (size_t __k = 0; __k < (__n - __m); ++__k)
         {
 	  _UIntType __y = ((_M_x[__k] & __upper_mask)
 			   | (_M_x[__k + 1] & __lower_mask));
 	  _M_x[__k] = (_M_x[__k + __m] ^ (__y >> 1)
-		       ^ ((__y & 0x01) ? __a : 0));
+		       ^ ((_UIntType(0) - (__y & 0x01)) & __a));
         }
 
       for (size_t __k = (__n - __m); __k < (__n - 1); ++__k)
@@ -411,13 +414,13 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	  _UIntType __y = ((_M_x[__k] & __upper_mask)
 			   | (_M_x[__k + 1] & __lower_mask));
 	  _M_x[__k] = (_M_x[__k + (__m - __n)] ^ (__y >> 1)
-		       ^ ((__y & 0x01) ? __a : 0));
+		       ^ ((_UIntType(0) - (__y & 0x01)) & __a));
 	}
 
       _UIntType __y = ((_M_x[__n - 1] & __upper_mask)
 		       | (_M_x[0] & __lower_mask));
       _M_x[__n - 1] = (_M_x[__m - 1] ^ (__y >> 1)
-		       ^ ((__y & 0x01) ? __a : 0));
+		       ^ ((_UIntType(0) - (__y & 0x01)) & __a));
       _M_p = 0;
     }
 
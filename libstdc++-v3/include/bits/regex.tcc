@@ -113,6 +113,37 @@ namespace __detail
 	}
       return __ret;
     }
+
+  // Like __regex_algo_impl, for the overloads that don't report where the
+  // match is.  Patterns that _Dfa_executor supports are run on it, since it
+  // needs neither recursion nor submatch bookkeeping.
+  template<typename _BiIter, typename _CharT, typename _TraitsT,
+	   bool __match_mode>
+    bool
+    __regex_algo_test(_BiIter                              __s,
+		      _BiIter                              __e,
+		      const basic_regex<_CharT, _TraitsT>& __re,
+		      regex_constants::match_flag_type     __flags)
+    {
+      if (__re._M_automaton == nullptr)
+	return false;
+
+      typedef _Dfa_executor<_BiIter, _TraitsT> _DfaT;
+      if (_DfaT::_S_supported(*__re._M_automaton, __flags))
+	{
+	  _DfaT __executor(*__re._M_automaton, __flags);
+	  if (__match_mode)
+	    return __executor._M_match(__s, __e);
+	  else
+	    return __executor._M_search(__s, __e);
+	}
+
+      match_results<_BiIter> __m;
+      return __regex_algo_impl<_BiIter,
+			       typename match_results<_BiIter>::allocator_type,
+			       _CharT, _TraitsT, _RegexExecutorPolicy::_S_auto,
+			       __match_mode>(__s, __e, __m, __re, __flags);
+    }
   /// @endcond
 } // namespace __detail
 
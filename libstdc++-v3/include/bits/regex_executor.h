@@ -250,6 +250,95 @@ namespace __detail
       bool                                                  _M_has_sol;
     };
 
+  /**
+   * @brief Decides whether a regex matches, without finding submatches.
+   *
+   * %_Dfa_executor simulates the NFA on sets of states, and caches each set
+   * it meets, together with its transitions, as a state of a DFA that is
+   * built lazily while the input is scanned.  The time taken is linear in
+   * the length of the input, and there is no recursion, but back-references,
+   * lookahead and word boundaries are not supported.
+   */
+  template<typename _BiIter, typename _TraitsT>
+    class _Dfa_executor
+    {
+    public:
+      typedef typename iterator_traits<_BiIter>::value_type _CharT;
+      typedef regex_constants::match_flag_type              _FlagT;
+      typedef _NFA<_TraitsT>                                _NFAT;
+
+      _Dfa_executor(const _NFAT& __nfa, _FlagT __flags)
+      : _M_nfa(__nfa), _M_flags(__flags), _M_search_mode(false),
+      _M_visited(__nfa.size()), _M_buckets(2 * _S_max_states),
+      _M_generation(0)
+      { }
+
+      // Whether this executor can handle __nfa and __flags.
+      static bool
+      _S_supported(const _NFAT& __nfa, _FlagT __flags);
+
+      // Whether the whole of [__begin, __end) matches.
+      bool
+      _M_match(_BiIter __begin, _BiIter __end)
+      { return _M_run(__begin, __end, false); }
+
+      // Whether some subsequence of [__begin, __end) matches.
+      bool
+      _M_search(_BiIter __begin, _BiIter __end)
+      { return _M_run(__begin, __end, true); }
+
+    private:
+      // The cache is flushed when it holds this many states.
+      static constexpr size_t _S_max_states = 512;
+      // Transitions are cached for characters below this value.
+      static constexpr size_t _S_table_size = 256;
+      static constexpr int _S_unknown = -1;
+
+      struct _Dfa_state
+      {
+	// The sorted NFA states reached right after reading a character.
+	vector<_StateIdT>	_M_kernel;
+	// The _S_opcode_match states of their closure.
+	vector<_StateIdT>	_M_matchers;
+	// Whether the closure contains the accepting state.
+	bool			_M_accept;
+	// The cached successors, or _S_unknown.
+	unique_ptr<int[]>	_M_next;
+      };
+
+      bool
+      _M_run(_BiIter __begin, _BiIter __end, bool __search);
+
+      bool
+      _M_closure(const vector<_StateIdT>& __kernel, bool __at_begin,
+		 bool __at_end, vector<_StateIdT>& __matchers);
+
+      void
+      _M_advance(const vector<_StateIdT>& __matchers, _CharT __c,
+		 vector<_StateIdT>& __kernel) const;
+
+      size_t
+      _M_find_state(vector<_StateIdT>&& __kernel);
+
+      size_t
+      _M_step(size_t __state, _CharT __c);
+
+      static size_t
+      _S_hash(const vector<_StateIdT>& __kernel);
+
+      const _NFAT&				_M_nfa;
+      _FlagT					_M_flags;
+      // Whether a match may start after the first position.
+      bool					_M_search_mode;
+      vector<char>				_M_visited;
+      vector<_StateIdT>				_M_stack;
+      vector<_Dfa_state>			_M_states;
+      // Open-addressed hash table of state indices plus one, or zero.
+      vector<size_t>				_M_buckets;
+      // Incremented whenever the cache is flushed.
+      size_t					_M_generation;
+    };
+
  ///@} regex-detail
 } // namespace __detail
 _GLIBCXX_END_NAMESPACE_VERSION
@@ -562,6 +562,191 @@ namespace __detail
 
       return __left_is_word != __right_is_word;
     }
+
+  template<typename _BiIter, typename _TraitsT>
+    bool _Dfa_executor<_BiIter, _TraitsT>::
+    _S_supported(const _NFAT& __nfa, _FlagT __flags)
+    {
+      if (__flags & regex_constants::match_not_null)
+	return false;
+      for (const auto& __state : __nfa)
+	switch (__state._M_opcode())
+	  {
+	  case _S_opcode_backref:
+	  case _S_opcode_word_boundary:
+	  case _S_opcode_subexpr_lookahead:
+	    return false;
+	  default:
+	    break;
+	  }
+      return true;
+    }
+
+  // Only the first position can be at the beginning, where the start state
+  // is closed over in a context of its own; every later position reuses the
+  // cached DFA states.  When searching, a match may end anywhere, and unless
+  // match_continuous is set the start state is added back after each
+  // character, which runs all the searches of _Executor::_M_search at once.  The end of the input is handled by closing over the last kernel
+  // again, with line end assertions enabled.
+  template<typename _BiIter, typename _TraitsT>
+    bool _Dfa_executor<_BiIter, _TraitsT>::
+    _M_run(_BiIter __begin, _BiIter __end, bool __search)
+    {
+      const bool __at_begin = !(_M_flags & (regex_constants::match_not_bol
+					    | regex_constants::match_prev_avail));
+      const bool __at_end = !(_M_flags & regex_constants::match_not_eol);
+      vector<_StateIdT> __kernel(1, _M_nfa._M_start());
+      vector<_StateIdT> __matchers;
+
+      _M_search_mode
+	= __search && !(_M_flags & regex_constants::match_continuous);
+      if (__begin == __end)
+	return _M_closure(__kernel, __at_begin, __at_end, __matchers);
+      if (_M_closure(__kernel, __at_begin, false, __matchers) && __search)
+	return true;
+      _M_advance(__matchers, *__begin, __kernel);
+      size_t __state = _M_find_state(std::move(__kernel));
+      for (++__begin; __begin != __end; ++__begin)
+	{
+	  const _Dfa_state& __cur = _M_states[__state];
+	  if (__search && __cur._M_accept)
+	    return true;
+	  if (!__search && __cur._M_matchers.empty())
+	    return false;
+	  __state = _M_step(__state, *__begin);
+	}
+      if (!__at_end)
+	return _M_states[__state]._M_accept;
+      return _M_closure(_M_states[__state]._M_kernel, false, true, __matchers);
+    }
+
+  // Collect the _S_opcode_match states reachable from __kernel without
+  // reading a character, and return whether the accepting state is.
+  template<typename _BiIter, typename _TraitsT>
+    bool _Dfa_executor<_BiIter, _TraitsT>::
+    _M_closure(const vector<_StateIdT>& __kernel, bool __at_begin,
+	       bool __at_end, vector<_StateIdT>& __matchers)
+    {
+      bool __accept = false;
+
+      __matchers.clear();
+      std::fill(_M_visited.begin(), _M_visited.end(), 0);
+      _M_stack.assign(__kernel.begin(), __kernel.end());
+      while (!_M_stack.empty())
+	{
+	  const _StateIdT __i = _M_stack.back();
+	  _M_stack.pop_back();
+	  if (_M_visited[__i])
+	    continue;
+	  _M_visited[__i] = 1;
+	  const auto& __state = _M_nfa[__i];
+	  switch (__state._M_opcode())
+	    {
+	    case _S_opcode_alternative:
+	    case _S_opcode_repeat:
+	      _M_stack.push_back(__state._M_alt);
+	      _M_stack.push_back(__state._M_next);
+	      break;
+	    case _S_opcode_line_begin_assertion:
+	      if (__at_begin)
+		_M_stack.push_back(__state._M_next);
+	      break;
+	    case _S_opcode_line_end_assertion:
+	      if (__at_end)
+		_M_stack.push_back(__state._M_next);
+	      break;
+	    case _S_opcode_match:
+	      __matchers.push_back(__i);
+	      break;
+	    case _S_opcode_accept:
+	      __accept = true;
+	      break;
+	    default:
+	      _M_stack.push_back(__state._M_next);
+	      break;
+	    }
+	}
+      return __accept;
+    }
+
+  template<typename _BiIter, typename _TraitsT>
+    void _Dfa_executor<_BiIter, _TraitsT>::
+    _M_advance(const vector<_StateIdT>& __matchers, _CharT __c,
+	       vector<_StateIdT>& __kernel) const
+    {
+      __kernel.clear();
+      for (auto __i : __matchers)
+	if (_M_nfa[__i]._M_matches(__c))
+	  __kernel.push_back(_M_nfa[__i]._M_next);
+      if (_M_search_mode)
+	__kernel.push_back(_M_nfa._M_start());
+      std::sort(__kernel.begin(), __kernel.end());
+      __kernel.erase(std::unique(__kernel.begin(), __kernel.end()),
+		     __kernel.end());
+    }
+
+  template<typename _BiIter, typename _TraitsT>
+    size_t _Dfa_executor<_BiIter, _TraitsT>::
+    _S_hash(const vector<_StateIdT>& __kernel)
+    {
+      size_t __h = 0;
+      for (auto __i : __kernel)
+	__h = __h * 31 + static_cast<size_t>(__i);
+      return __h ^ (__h >> 7);
+    }
+
+  // Return the index of the DFA state for __kernel, creating it if needed.
+  template<typename _BiIter, typename _TraitsT>
+    size_t _Dfa_executor<_BiIter, _TraitsT>::
+    _M_find_state(vector<_StateIdT>&& __kernel)
+    {
+      const size_t __mask = _M_buckets.size() - 1;
+      size_t __h = _S_hash(__kernel) & __mask;
+      for (; _M_buckets[__h] != 0; __h = (__h + 1) & __mask)
+	if (_M_states[_M_buckets[__h] - 1]._M_kernel == __kernel)
+	  return _M_buckets[__h] - 1;
+
+      if (_M_states.size() == _S_max_states)
+	{
+	  _M_states.clear();
+	  std::fill(_M_buckets.begin(), _M_buckets.end(), 0);
+	  ++_M_generation;
+	  __h = _S_hash(__kernel) & __mask;
+	}
+
+      _Dfa_state __state;
+      __state._M_accept = _M_closure(__kernel, false, false,
+				     __state._M_matchers);
+      __state._M_next.reset(new int[_S_table_size]);
+      std::fill_n(__state._M_next.get(), _S_table_size, int(_S_unknown));
+      __state._M_kernel = std::move(__kernel);
+      _M_buckets[__h] = _M_states.size() + 1;
+      _M_states.push_back(std::move(__state));
+      return _M_states.size() - 1;
+    }
+
+  template<typename _BiIter, typename _TraitsT>
+    size_t _Dfa_executor<_BiIter, _TraitsT>::
+    _M_step(size_t __state, _CharT __c)
+    {
+      const auto __u
+	= static_cast<typename make_unsigned<_CharT>::type>(__c);
+      if (__u < _S_table_size)
+	{
+	  const int __next = _M_states[__state]._M_next[__u];
+	  if (__next != _S_unknown)
+	    return __next;
+	}
+
+      vector<_StateIdT> __kernel;
+      _M_advance(_M_states[__state]._M_matchers, __c, __kernel);
+      const size_t __generation = _M_generation;
+      const size_t __next = _M_find_state(std::move(__kernel));
+      // The table of __state is gone if the cache was flushed.
+      if (__u < _S_table_size && __generation == _M_generation)
+	_M_states[__state]._M_next[__u] = __next;
+      return __next;
+    }
 } // namespace __detail
 
 _GLIBCXX_END_NAMESPACE_VERSION
@@ -1893,6 +1893,96 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	}
     }
 
+  template<typename _RandomAccessIterator, typename _Compare>
+    _GLIBCXX20_CONSTEXPR
+    inline _RandomAccessIterator
+    __unguarded_partition(_RandomAccessIterator __first,
+			  _RandomAccessIterator __last,
+			  _RandomAccessIterator __pivot, _Compare __comp,
+			  __false_type)
+    { return std::__unguarded_partition(__first, __last, __pivot, __comp); }
+
+  /// This is a helper function for the sort routine.  Like
+  /// __unguarded_partition, but for scalars, whose comparisons are
+  /// cheap and whose outcome the branch predictor cannot guess.  The
+  /// elements are classified a block at a time from each end, without
+  /// branching on the comparisons, into lists of the offsets of those
+  /// on the wrong side, and those are then swapped pairwise.
+  template<typename _RandomAccessIterator, typename _Compare>
+    _GLIBCXX20_CONSTEXPR
+    _RandomAccessIterator
+    __unguarded_partition(_RandomAccessIterator __first,
+			  _RandomAccessIterator __last,
+			  _RandomAccessIterator __pivot, _Compare __comp,
+			  __true_type)
+    {
+      enum { _S_block = 64 };
+      typename iterator_traits<_RandomAccessIterator>::value_type
+	__val = *__pivot;
+      __decltype(__gnu_cxx::__ops::__iter_comp_val(__comp)) __less_val
+	= __gnu_cxx::__ops::__iter_comp_val(__comp);
+      __decltype(__gnu_cxx::__ops::__val_comp_iter(__comp)) __val_less
+	= __gnu_cxx::__ops::__val_comp_iter(__comp);
+      unsigned char __offsets_l[_S_block], __offsets_r[_S_block];
+      int __num_l = 0, __num_r = 0, __start_l = 0, __start_r = 0;
+
+      // As in __unguarded_partition, elements equal to the pivot count
+      // as being on the wrong side from either end, so that they end up
+      // spread over both parts.
+      while (__last - __first >= 2 * int(_S_block))
+	{
+	  if (__num_l == 0)
+	    {
+	      __start_l = 0;
+	      for (int __i = 0; __i < int(_S_block); ++__i)
+		{
+		  __offsets_l[__num_l] = __i;
+		  __num_l += !__less_val(__first + __i, __val);
+		}
+	    }
+	  if (__num_r == 0)
+	    {
+	      __start_r = 0;
+	      for (int __i = 0; __i < int(_S_block); ++__i)
+		{
+		  __offsets_r[__num_r] = __i;
+		  __num_r += !__val_less(__val, __last - 1 - __i);
+		}
+	    }
+
+	  const int __num = std::min(__num_l, __num_r);
+	  for (int __i = 0; __i < __num; ++__i)
+	    std::iter_swap(__first + __offsets_l[__start_l + __i],
+			   __last - 1 - __offsets_r[__start_r + __i]);
+	  __num_l -= __num;
+	  __num_r -= __num;
+	  __start_l += __num;
+	  __start_r += __num;
+	  if (__num_l == 0)
+	    __first += int(_S_block);
+	  if (__num_r == 0)
+	    __last -= int(_S_block);
+	}
+
+      // Finish off what is left, including any block only partly dealt
+      // with, an element at a time.  The elements that would stop each
+      // scan may have been moved out of the range, so check the bounds.
+      while (true)
+	{
+	  while (__first != __last && __less_val(__first, __val))
+	    ++__first;
+	  if (__first == __last)
+	    return __first;
+	  --__last;
+	  while (__first != __last && __val_less(__val, __last))
+	    --__last;
+	  if (__first == __last)
+	    return __first;
+	  std::iter_swap(__first, __last);
+	  ++__first;
+	}
+    }
+
   /// This is a helper function...
   template<typename _RandomAccessIterator, typename _Compare>
     _GLIBCXX20_CONSTEXPR
@@ -1900,10 +1990,14 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __unguarded_partition_pivot(_RandomAccessIterator __first,
 				_RandomAccessIterator __last, _Compare __comp)
     {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+
       _RandomAccessIterator __mid = __first + (__last - __first) / 2;
       std::__move_median_to_first(__first, __first + 1, __mid, __last - 1,
 				  __comp);
-      return std::__unguarded_partition(__first + 1, __last, __first, __comp);
+      return std::__unguarded_partition(__first + 1, __last, __first, __comp,
+				typename __is_scalar<_ValueType>::__type());
     }
 
   template<typename _RandomAccessIterator, typename _Compare>
@@ -439,6 +439,7 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
     struct _Deque_iterator;
 
   struct _Bit_iterator;
+  struct _Bit_const_iterator;
 
 _GLIBCXX_END_NAMESPACE_CONTAINER
 
@@ -515,6 +516,18 @@ _GLIBCXX_END_NAMESPACE_CONTAINER
       _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*> >::__type
     __copy_move_a1(_II, _II, _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*>);
 
+  template<bool _IsMove>
+    _GLIBCXX_STD_C::_Bit_iterator
+    __copy_move_a1(_GLIBCXX_STD_C::_Bit_iterator,
+		   _GLIBCXX_STD_C::_Bit_iterator,
+		   _GLIBCXX_STD_C::_Bit_iterator);
+
+  template<bool _IsMove>
+    _GLIBCXX_STD_C::_Bit_iterator
+    __copy_move_a1(_GLIBCXX_STD_C::_Bit_const_iterator,
+		   _GLIBCXX_STD_C::_Bit_const_iterator,
+		   _GLIBCXX_STD_C::_Bit_iterator);
+
   template<bool _IsMove, typename _II, typename _OI>
     _GLIBCXX20_CONSTEXPR
     inline _OI
@@ -1199,6 +1212,24 @@ _GLIBCXX_END_NAMESPACE_CONTAINER
     __equal_aux1(_II, _II,
 		_GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr>);
 
+  bool
+  __equal_aux1(_GLIBCXX_STD_C::_Bit_iterator, _GLIBCXX_STD_C::_Bit_iterator,
+	       _GLIBCXX_STD_C::_Bit_iterator);
+
+  bool
+  __equal_aux1(_GLIBCXX_STD_C::_Bit_iterator, _GLIBCXX_STD_C::_Bit_iterator,
+	       _GLIBCXX_STD_C::_Bit_const_iterator);
+
+  bool
+  __equal_aux1(_GLIBCXX_STD_C::_Bit_const_iterator,
+	       _GLIBCXX_STD_C::_Bit_const_iterator,
+	       _GLIBCXX_STD_C::_Bit_iterator);
+
+  bool
+  __equal_aux1(_GLIBCXX_STD_C::_Bit_const_iterator,
+	       _GLIBCXX_STD_C::_Bit_const_iterator,
+	       _GLIBCXX_STD_C::_Bit_const_iterator);
+
   template<typename _II1, typename _II2>
     _GLIBCXX20_CONSTEXPR
     inline bool
@@ -2115,6 +2146,17 @@ _GLIBCXX_END_NAMESPACE_ALGO
 		       std::__iterator_category(__first));
     }
 
+  template<typename _Tp>
+    _GLIBCXX_STD_C::_Bit_iterator
+    __find_if(_GLIBCXX_STD_C::_Bit_iterator, _GLIBCXX_STD_C::_Bit_iterator,
+	      __gnu_cxx::__ops::_Iter_equals_val<_Tp>);
+
+  template<typename _Tp>
+    _GLIBCXX_STD_C::_Bit_const_iterator
+    __find_if(_GLIBCXX_STD_C::_Bit_const_iterator,
+	      _GLIBCXX_STD_C::_Bit_const_iterator,
+	      __gnu_cxx::__ops::_Iter_equals_val<_Tp>);
+
   template<typename _InputIterator, typename _Predicate>
     _GLIBCXX20_CONSTEXPR
     typename iterator_traits<_InputIterator>::difference_type
@@ -2127,6 +2169,17 @@ _GLIBCXX_END_NAMESPACE_ALGO
       return __n;
     }
 
+  template<typename _Tp>
+    ptrdiff_t
+    __count_if(_GLIBCXX_STD_C::_Bit_iterator, _GLIBCXX_STD_C::_Bit_iterator,
+	       __gnu_cxx::__ops::_Iter_equals_val<_Tp>);
+
+  template<typename _Tp>
+    ptrdiff_t
+    __count_if(_GLIBCXX_STD_C::_Bit_const_iterator,
+	       _GLIBCXX_STD_C::_Bit_const_iterator,
+	       __gnu_cxx::__ops::_Iter_equals_val<_Tp>);
+
 #if __cplusplus >= 201103L
   template<typename _ForwardIterator1, typename _ForwardIterator2,
 	   typename _BinaryPredicate>
@@ -1364,6 +1364,236 @@ _GLIBCXX_END_NAMESPACE_CONTAINER
       __fill_bvector(__first._M_p, __first._M_offset, __last._M_offset, __x);
   }
 
+  // The __n bits starting at bit __off of *__p, in the low bits of the
+  // result.  __n is at most _S_word_bit and can reach into __p[1].
+  inline _GLIBCXX_STD_C::_Bit_type
+  __bvector_bits(const _GLIBCXX_STD_C::_Bit_type* __p, unsigned int __off,
+		 unsigned int __n)
+  {
+    using _GLIBCXX_STD_C::_Bit_type;
+    using _GLIBCXX_STD_C::_S_word_bit;
+    _Bit_type __w = *__p >> __off;
+    if (__off + __n > _S_word_bit)
+      __w |= __p[1] << (_S_word_bit - __off);
+    if (__n < _S_word_bit)
+      __w &= ~(~_Bit_type(0) << __n);
+    return __w;
+  }
+
+  // Advance (__p, __off) to the first bit equal to __x before
+  // (__lp, __loff).  Return false if there is none.
+  inline bool
+  __find_bvector(_GLIBCXX_STD_C::_Bit_type*& __p, unsigned int& __off,
+		 const _GLIBCXX_STD_C::_Bit_type* __lp, unsigned int __loff,
+		 bool __x)
+  {
+    using _GLIBCXX_STD_C::_Bit_type;
+    using _GLIBCXX_STD_C::_S_word_bit;
+    const _Bit_type __flip = __x ? _Bit_type(0) : ~_Bit_type(0);
+    _Bit_type __w;
+    if (__p != __lp)
+      {
+	__w = (*__p ^ __flip) & (~_Bit_type(0) << __off);
+	while (__w == 0 && ++__p != __lp)
+	  __w = *__p ^ __flip;
+	if (__w != 0)
+	  {
+	    __off = __builtin_ctzl(__w);
+	    return true;
+	  }
+	__off = 0;
+      }
+    if (__off >= __loff)
+      return false;
+    __w = ((*__p ^ __flip) & (~_Bit_type(0) << __off)
+	   & (~_Bit_type(0) >> (_S_word_bit - __loff)));
+    if (__w == 0)
+      return false;
+    __off = __builtin_ctzl(__w);
+    return true;
+  }
+
+  // The number of set bits from (__p, __off) to (__lp, __loff).
+  inline ptrdiff_t
+  __count_bvector(const _GLIBCXX_STD_C::_Bit_type* __p, unsigned int __off,
+		  const _GLIBCXX_STD_C::_Bit_type* __lp, unsigned int __loff)
+  {
+    using _GLIBCXX_STD_C::_Bit_type;
+    using _GLIBCXX_STD_C::_S_word_bit;
+    if (__p == __lp)
+      return (__off == __loff ? 0
+	      : __builtin_popcountl(std::__bvector_bits(__p, __off,
+							__loff - __off)));
+    ptrdiff_t __n = __builtin_popcountl(*__p >> __off);
+    for (++__p; __p != __lp; ++__p)
+      __n += __builtin_popcountl(*__p);
+    if (__loff != 0)
+      __n += __builtin_popcountl(*__lp
+				 & (~_Bit_type(0) >> (_S_word_bit - __loff)));
+    return __n;
+  }
+
+  template<typename _Tp>
+    inline _GLIBCXX_STD_C::_Bit_iterator
+    __find_if(_GLIBCXX_STD_C::_Bit_iterator __first,
+	      _GLIBCXX_STD_C::_Bit_iterator __last,
+	      __gnu_cxx::__ops::_Iter_equals_val<_Tp> __pred)
+    {
+      const bool __t = (true == __pred._M_value);
+      if (__t == (false == __pred._M_value))
+	return __t ? __first : __last;
+      if (std::__find_bvector(__first._M_p, __first._M_offset,
+			      __last._M_p, __last._M_offset, __t))
+	return __first;
+      return __last;
+    }
+
+  template<typename _Tp>
+    inline _GLIBCXX_STD_C::_Bit_const_iterator
+    __find_if(_GLIBCXX_STD_C::_Bit_const_iterator __first,
+	      _GLIBCXX_STD_C::_Bit_const_iterator __last,
+	      __gnu_cxx::__ops::_Iter_equals_val<_Tp> __pred)
+    {
+      const bool __t = (true == __pred._M_value);
+      if (__t == (false == __pred._M_value))
+	return __t ? __first : __last;
+      if (std::__find_bvector(__first._M_p, __first._M_offset,
+			      __last._M_p, __last._M_offset, __t))
+	return __first;
+      return __last;
+    }
+
+  template<typename _Tp>
+    inline ptrdiff_t
+    __count_if(_GLIBCXX_STD_C::_Bit_iterator __first,
+	       _GLIBCXX_STD_C::_Bit_iterator __last,
+	       __gnu_cxx::__ops::_Iter_equals_val<_Tp> __pred)
+    {
+      return std::__count_if(_GLIBCXX_STD_C::_Bit_const_iterator(__first),
+			     _GLIBCXX_STD_C::_Bit_const_iterator(__last),
+			     __pred);
+    }
+
+  template<typename _Tp>
+    inline ptrdiff_t
+    __count_if(_GLIBCXX_STD_C::_Bit_const_iterator __first,
+	       _GLIBCXX_STD_C::_Bit_const_iterator __last,
+	       __gnu_cxx::__ops::_Iter_equals_val<_Tp> __pred)
+    {
+      const bool __t = (true == __pred._M_value);
+      const bool __f = (false == __pred._M_value);
+      if (__t && __f)
+	return __last - __first;
+      if (!__t && !__f)
+	return 0;
+      const ptrdiff_t __n = std::__count_bvector(__first._M_p,
+						 __first._M_offset,
+						 __last._M_p,
+						 __last._M_offset);
+      return __t ? __n : (__last - __first) - __n;
+    }
+
+  inline bool
+  __equal_bvector(const _GLIBCXX_STD_C::_Bit_type* __p1, unsigned int __off1,
+		  const _GLIBCXX_STD_C::_Bit_type* __p2, unsigned int __off2,
+		  size_t __n)
+  {
+    using _GLIBCXX_STD_C::_S_word_bit;
+    for (; __n >= _S_word_bit; __n -= _S_word_bit, ++__p1, ++__p2)
+      if (std::__bvector_bits(__p1, __off1, _S_word_bit)
+	  != std::__bvector_bits(__p2, __off2, _S_word_bit))
+	return false;
+    return (__n == 0
+	    || (std::__bvector_bits(__p1, __off1, __n)
+		== std::__bvector_bits(__p2, __off2, __n)));
+  }
+
+  inline bool
+  __equal_aux1(_GLIBCXX_STD_C::_Bit_const_iterator __first1,
+	       _GLIBCXX_STD_C::_Bit_const_iterator __last1,
+	       _GLIBCXX_STD_C::_Bit_const_iterator __first2)
+  {
+    return std::__equal_bvector(__first1._M_p, __first1._M_offset,
+				__first2._M_p, __first2._M_offset,
+				__last1 - __first1);
+  }
+
+  inline bool
+  __equal_aux1(_GLIBCXX_STD_C::_Bit_const_iterator __first1,
+	       _GLIBCXX_STD_C::_Bit_const_iterator __last1,
+	       _GLIBCXX_STD_C::_Bit_iterator __first2)
+  {
+    return std::__equal_bvector(__first1._M_p, __first1._M_offset,
+				__first2._M_p, __first2._M_offset,
+				__last1 - __first1);
+  }
+
+  inline bool
+  __equal_aux1(_GLIBCXX_STD_C::_Bit_iterator __first1,
+	       _GLIBCXX_STD_C::_Bit_iterator __last1,
+	       _GLIBCXX_STD_C::_Bit_const_iterator __first2)
+  {
+    return std::__equal_bvector(__first1._M_p, __first1._M_offset,
+				__first2._M_p, __first2._M_offset,
+				__last1 - __first1);
+  }
+
+  inline bool
+  __equal_aux1(_GLIBCXX_STD_C::_Bit_iterator __first1,
+	       _GLIBCXX_STD_C::_Bit_iterator __last1,
+	       _GLIBCXX_STD_C::_Bit_iterator __first2)
+  {
+    return std::__equal_bvector(__first1._M_p, __first1._M_offset,
+				__first2._M_p, __first2._M_offset,
+				__last1 - __first1);
+  }
+
+  // Copy whole words at a time, merging each into the destination
+  // word it lands on.  Bits not yet read always lie after the bits
+  // just written, so this also works for overlapping ranges that
+  // std::copy allows.
+  template<bool _IsMove>
+    _GLIBCXX_STD_C::_Bit_iterator
+    __copy_move_a1(_GLIBCXX_STD_C::_Bit_const_iterator __first,
+		   _GLIBCXX_STD_C::_Bit_const_iterator __last,
+		   _GLIBCXX_STD_C::_Bit_iterator __result)
+    {
+      using _GLIBCXX_STD_C::_Bit_type;
+      using _GLIBCXX_STD_C::_S_word_bit;
+      ptrdiff_t __n = __last - __first;
+      const _Bit_type* __p = __first._M_p;
+      unsigned int __off = __first._M_offset;
+      _GLIBCXX_STD_C::_Bit_iterator __end = __result + __n;
+      while (__n > 0)
+	{
+	  const unsigned int __roff = __result._M_offset;
+	  const unsigned int __k
+	    = std::min(ptrdiff_t(_S_word_bit - __roff), __n);
+	  const _Bit_type __mask
+	    = (~_Bit_type(0) >> (_S_word_bit - __k)) << __roff;
+	  const _Bit_type __w = std::__bvector_bits(__p, __off, __k);
+	  *__result._M_p = (*__result._M_p & ~__mask) | (__w << __roff);
+	  __off += __k;
+	  __p += __off / _S_word_bit;
+	  __off %= _S_word_bit;
+	  ++__result._M_p;
+	  __result._M_offset = 0;
+	  __n -= __k;
+	}
+      return __end;
+    }
+
+  template<bool _IsMove>
+    inline _GLIBCXX_STD_C::_Bit_iterator
+    __copy_move_a1(_GLIBCXX_STD_C::_Bit_iterator __first,
+		   _GLIBCXX_STD_C::_Bit_iterator __last,
+		   _GLIBCXX_STD_C::_Bit_iterator __result)
+    {
+      return std::__copy_move_a1<_IsMove>(
+	  _GLIBCXX_STD_C::_Bit_const_iterator(__first),
+	  _GLIBCXX_STD_C::_Bit_const_iterator(__last), __result);
+    }
+
 #if __cplusplus >= 201103L
   // DR 1182.
   /// std::hash specialization for vector<bool>.
@@ -0,0 +1,289 @@
+// Slab allocator for node-based containers -*- C++ -*-
+
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/slab_allocator.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _SLAB_ALLOCATOR_H
+#define _SLAB_ALLOCATOR_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus < 201103L
+# include <bits/c++0x_warning.h>
+#else
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <ext/new_allocator.h>
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  /**
+   *  The memory shared by copies of a slab_allocator.  Objects of a
+   *  single size, fixed by the first allocation, are handed out
+   *  consecutively from slabs obtained from operator new, and freed
+   *  objects are kept on a list for reuse.  Each slab is twice the size
+   *  of the one before, up to _S_max_slab bytes.  The slabs are only
+   *  given back when the last allocator using the arena goes away.
+   */
+  class __slab_arena
+  {
+    struct _Block
+    {
+      _Block* _M_next;
+    };
+
+    struct _Slab
+    {
+      _Slab* _M_next;
+    };
+
+    static constexpr std::size_t _S_header
+      = ((sizeof(_Slab) + alignof(std::max_align_t) - 1)
+	 & ~(alignof(std::max_align_t) - 1));
+    static constexpr std::size_t _S_first_count = 16;
+    static constexpr std::size_t _S_max_slab = 64 * 1024;
+
+  public:
+    __slab_arena() noexcept
+    : _M_free(), _M_cur(), _M_end(), _M_slabs(), _M_size(),
+      _M_count(_S_first_count), _M_refs(1)
+    { }
+
+    __slab_arena(const __slab_arena&) = delete;
+    __slab_arena& operator=(const __slab_arena&) = delete;
+
+    ~__slab_arena()
+    {
+      while (_M_slabs)
+	{
+	  _Slab* __s = _M_slabs;
+	  _M_slabs = __s->_M_next;
+	  ::operator delete(__s);
+	}
+    }
+
+    // Whether objects of __bytes bytes come from the slabs.  Free
+    // objects hold a _Block, so sizes are rounded up to suit one.
+    bool
+    _M_serves(std::size_t __bytes) noexcept
+    {
+      if (__bytes < sizeof(_Block))
+	__bytes = sizeof(_Block);
+      __bytes = (__bytes + alignof(_Block) - 1) & ~(alignof(_Block) - 1);
+      if (__builtin_expect(_M_size == 0, false))
+	_M_size = __bytes;
+      return __bytes == _M_size;
+    }
+
+    void*
+    _M_allocate()
+    {
+      if (_Block* __b = _M_free)
+	{
+	  _M_free = __b->_M_next;
+	  return __b;
+	}
+      if (_M_cur == _M_end)
+	_M_refill();
+      void* __p = _M_cur;
+      _M_cur += _M_size;
+      return __p;
+    }
+
+    void
+    _M_deallocate(void* __p) noexcept
+    {
+      _Block* __b = static_cast<_Block*>(__p);
+      __b->_M_next = _M_free;
+      _M_free = __b;
+    }
+
+    void
+    _M_add_ref() noexcept
+    { ++_M_refs; }
+
+    void
+    _M_release() noexcept
+    {
+      if (--_M_refs == 0)
+	delete this;
+    }
+
+  private:
+    void
+    _M_refill()
+    {
+      void* __p = ::operator new(_S_header + _M_count * _M_size);
+      _Slab* __s = static_cast<_Slab*>(__p);
+      __s->_M_next = _M_slabs;
+      _M_slabs = __s;
+      _M_cur = static_cast<char*>(__p) + _S_header;
+      _M_end = _M_cur + _M_count * _M_size;
+      if (_M_count * _M_size < _S_max_slab)
+	_M_count *= 2;
+    }
+
+    _Block*		_M_free;
+    char*		_M_cur;
+    char*		_M_end;
+    _Slab*		_M_slabs;
+    std::size_t		_M_size;
+    std::size_t		_M_count;
+    std::size_t		_M_refs;
+  };
+
+  /**
+   *  @brief  An allocator that carves single objects out of slabs.
+   *  @ingroup allocators
+   *
+   *  Meant for the nodes of std::map, std::set, std::list and the
+   *  unordered containers, which are otherwise allocated one call to
+   *  operator new at a time and end up scattered over the heap.
+   *
+   *    - a default-constructed allocator creates a new arena, which
+   *      copies and rebound copies share
+   *    - single objects come from the arena, and neighbouring
+   *      allocations are adjacent in memory
+   *    - arrays and over-aligned objects use operator new
+   *    - the arena's memory is freed all at once when the last
+   *      allocator that shares it is destroyed
+   *
+   *  Copying a container gives the copy an arena of its own.  Two
+   *  containers only compare equal allocators if one was constructed
+   *  with the allocator of the other, which std::list::splice and
+   *  std::map::merge require.  An arena is not thread-safe: only
+   *  containers used by the same thread may share one.
+   */
+  template<typename _Tp>
+    class slab_allocator
+    {
+      template<typename _Tp1>
+	friend class slab_allocator;
+
+    public:
+      typedef _Tp        value_type;
+      typedef std::size_t     size_type;
+      typedef std::ptrdiff_t  difference_type;
+#if __cplusplus <= 201703L
+      typedef _Tp*       pointer;
+      typedef const _Tp* const_pointer;
+      typedef _Tp&       reference;
+      typedef const _Tp& const_reference;
+
+      template<typename _Tp1>
+        struct rebind
+        { typedef slab_allocator<_Tp1> other; };
+#endif
+
+      typedef std::false_type propagate_on_container_copy_assignment;
+      typedef std::true_type propagate_on_container_move_assignment;
+      typedef std::true_type propagate_on_container_swap;
+      typedef std::false_type is_always_equal;
+
+      slab_allocator()
+      : _M_arena(new __slab_arena)
+      { }
+
+      slab_allocator(const slab_allocator& __a) noexcept
+      : _M_arena(__a._M_arena)
+      { _M_arena->_M_add_ref(); }
+
+      template<typename _Tp1>
+        slab_allocator(const slab_allocator<_Tp1>& __a) noexcept
+	: _M_arena(__a._M_arena)
+	{ _M_arena->_M_add_ref(); }
+
+      slab_allocator&
+      operator=(const slab_allocator& __a) noexcept
+      {
+	__a._M_arena->_M_add_ref();
+	_M_arena->_M_release();
+	_M_arena = __a._M_arena;
+	return *this;
+      }
+
+      ~slab_allocator() noexcept
+      { _M_arena->_M_release(); }
+
+      slab_allocator
+      select_on_container_copy_construction() const
+      { return slab_allocator(); }
+
+      _Tp*
+      allocate(size_type __n, const void* = 0)
+      {
+	if (__n == 1 && _S_slab_p() && _M_arena->_M_serves(sizeof(_Tp)))
+	  return static_cast<_Tp*>(_M_arena->_M_allocate());
+	return new_allocator<_Tp>().allocate(__n);
+      }
+
+      void
+      deallocate(_Tp* __p, size_type __n)
+      {
+	if (__n == 1 && _S_slab_p() && _M_arena->_M_serves(sizeof(_Tp)))
+	  _M_arena->_M_deallocate(__p);
+	else
+	  new_allocator<_Tp>().deallocate(__p, __n);
+      }
+
+#if __cplusplus <= 201703L
+      size_type
+      max_size() const noexcept
+      { return new_allocator<_Tp>().max_size(); }
+#endif
+
+      template<typename _Up>
+	friend bool
+	operator==(const slab_allocator& __a, const slab_allocator<_Up>& __b)
+	noexcept
+	{ return __a._M_arena == __b._M_arena; }
+
+#if __cpp_impl_three_way_comparison < 201907L
+      template<typename _Up>
+	friend bool
+	operator!=(const slab_allocator& __a, const slab_allocator<_Up>& __b)
+	noexcept
+	{ return __a._M_arena != __b._M_arena; }
+#endif
+
+    private:
+      static constexpr bool
+      _S_slab_p() noexcept
+      { return alignof(_Tp) <= alignof(std::max_align_t); }
+
+      __slab_arena* _M_arena;
+    };
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace
+
+#endif // C++11
+
+#endif
@@ -57,6 +57,35 @@ namespace
     return result;
   }
 
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  inline std::size_t
+  unaligned_load4(const char* p)
+  {
+    __UINT32_TYPE__ result;
+    __builtin_memcpy(&result, p, sizeof(result));
+    return result;
+  }
+
+  // Same as load_bytes(p, n), but without a loop over the bytes.
+  // If AFTER_WORDS is true, the 8 bytes before p + n are part of the
+  // buffer and can be loaded as one word.
+  inline std::size_t
+  load_tail_bytes(const char* p, int n, bool after_words)
+  {
+    if (after_words)
+      return unaligned_load(p + n - 8) >> (64 - 8 * n);
+    if (n >= 4)
+      return (unaligned_load4(p)
+	      | (unaligned_load4(p + n - 4) >> (64 - 8 * n)) << 32);
+    // For n < 4, these three bytes cover p[0] to p[n - 1].
+    return (static_cast<std::size_t>(static_cast<unsigned char>(p[0]))
+	    | (static_cast<std::size_t>(static_cast<unsigned char>(p[n / 2]))
+	       << (8 * (n / 2)))
+	    | (static_cast<std::size_t>(static_cast<unsigned char>(p[n - 1]))
+	       << (8 * (n - 1))));
+  }
+#endif
+
   inline std::size_t
   shift_mix(std::size_t v)
   { return v ^ (v >> 47);}
@@ -150,7 +179,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       }
     if ((len & 0x7) != 0)
       {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	const size_t data = load_tail_bytes(end, len & 0x7, end != buf);
+#else
 	const size_t data = load_bytes(end, len & 0x7);
+#endif
 	hash ^= data;
 	hash *= mul;
       }
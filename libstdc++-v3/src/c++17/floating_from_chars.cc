@@ -380,6 +380,200 @@ namespace
     return result;
   }
 
+#if defined __SIZEOF_INT128__
+  using uint128_t = unsigned __int128;
+#else
+# include "uint128_t.h"
+#endif
+
+#include "floating_from_chars_pow5.h"
+
+  // The parameters of the IEEE binary formats handled by from_chars_fast.
+  template<typename T>
+    struct fast_float_traits;
+
+  template<>
+    struct fast_float_traits<float>
+    {
+      using bits_type = uint32_t;
+      static constexpr int mantissa_bits = 23;
+      static constexpr int min_exponent = -127;
+      static constexpr int infinite_power = 0xff;
+      static constexpr int smallest_power_of_ten = -65;
+      static constexpr int largest_power_of_ten = 38;
+      static constexpr int min_exponent_round_to_even = -17;
+      static constexpr int max_exponent_round_to_even = 10;
+    };
+
+  template<>
+    struct fast_float_traits<double>
+    {
+      using bits_type = uint64_t;
+      static constexpr int mantissa_bits = 52;
+      static constexpr int min_exponent = -1023;
+      static constexpr int infinite_power = 0x7ff;
+      static constexpr int smallest_power_of_ten = -342;
+      static constexpr int largest_power_of_ten = 308;
+      static constexpr int min_exponent_round_to_even = -4;
+      static constexpr int max_exponent_round_to_even = 23;
+    };
+
+  // Compute the correctly rounded binary value of W * 10^Q, W != 0, using
+  // the algorithm of Eisel and Lemire ("Number Parsing at a Gigabyte per
+  // Second", Software: Practice and Experience 51(8), 2021).  The result
+  // only depends on integer arithmetic, so it is correct whatever the
+  // current rounding mode.  Returns false if the algorithm can't decide
+  // the rounding or if the result would be subnormal, zero or infinite;
+  // those cases are left to strtod so that they set ERANGE as before.
+  template<typename T>
+    bool
+    eisel_lemire(uint64_t w, int q, T& value) noexcept
+    {
+      using traits = fast_float_traits<T>;
+      constexpr int mbits = traits::mantissa_bits;
+
+      if (q < traits::smallest_power_of_ten
+	  || q > traits::largest_power_of_ten)
+	return false;
+
+      const int lz = __builtin_clzll(w);
+      w <<= lz;
+
+      // The product of W and the first 64 bits of 5^Q is enough unless
+      // the bits below the ones we need are all ones, in which case the
+      // next 64 bits of 5^Q could carry into them.
+      const int index = 2 * (q - pow5_min_exponent);
+      uint128_t prod = uint128_t(w) * pow5_128[index];
+      uint64_t hi = uint64_t(prod >> 64);
+      uint64_t lo = uint64_t(prod);
+      constexpr uint64_t precision_mask = ~uint64_t(0) >> (mbits + 3);
+      if ((hi & precision_mask) == precision_mask)
+	{
+	  const uint128_t prod2 = uint128_t(w) * pow5_128[index + 1];
+	  const uint64_t hi2 = uint64_t(prod2 >> 64);
+	  lo += hi2;
+	  if (hi2 > lo)
+	    ++hi;
+	  if (lo == ~uint64_t(0) && (q < -27 || q > 55))
+	    return false;
+	}
+
+      const int upperbit = hi >> 63;
+      const int shift = upperbit + 64 - mbits - 3;
+      uint64_t mantissa = hi >> shift;
+      // floor(log2(10^Q)) + 63, the binary exponent of the product.
+      int power2 = (((152170 + 65536) * q) >> 16) + 63
+		   + upperbit - lz - traits::min_exponent;
+      if (power2 <= 0)
+	return false;
+
+      // A product that is exactly halfway between two representable
+      // values must round to even; this can only happen for small Q.
+      if (lo <= 1
+	  && q >= traits::min_exponent_round_to_even
+	  && q <= traits::max_exponent_round_to_even
+	  && (mantissa & 3) == 1
+	  && (mantissa << shift) == hi)
+	mantissa &= ~uint64_t(1);
+
+      mantissa += mantissa & 1;
+      mantissa >>= 1;
+      if (mantissa >= (uint64_t(2) << mbits))
+	{
+	  mantissa = uint64_t(1) << mbits;
+	  ++power2;
+	}
+      mantissa &= ~(uint64_t(1) << mbits);
+      if (power2 >= traits::infinite_power)
+	return false;
+
+      const typename traits::bits_type bits
+	= mantissa | (uint64_t(power2) << mbits);
+      static_assert(sizeof(bits) == sizeof(T));
+      std::memcpy(&value, &bits, sizeof(T));
+      return true;
+    }
+
+  // Try to convert the decimal number at the start of [first, last)
+  // without going through strtod.  Returns the end of the number on
+  // success, or nullptr if the slow path has to handle it (including
+  // all invalid input, infinities, NaNs and numbers with more than 19
+  // significant digits).
+  template<typename T>
+    const char*
+    from_chars_fast(const char* first, const char* last, T& value,
+		    chars_format fmt) noexcept
+    {
+      const char* p = first;
+      const bool neg = p != last && *p == '-';
+      p += neg;
+
+      uint64_t mant = 0;
+      int ndigits = 0;
+      int exp10 = 0;
+      const char* const digits_start = p;
+      for (; p != last && unsigned(*p - '0') < 10; ++p)
+	if (mant != 0 || *p != '0')
+	  {
+	    if (++ndigits > 19)
+	      return nullptr;
+	    mant = mant * 10 + (*p - '0');
+	  }
+      const bool int_digits = p != digits_start;
+      bool frac_digits = false;
+      if (p != last && *p == '.')
+	{
+	  const char* const frac_start = ++p;
+	  for (; p != last && unsigned(*p - '0') < 10; ++p)
+	    if (mant != 0 || *p != '0')
+	      {
+		if (++ndigits > 19)
+		  return nullptr;
+		mant = mant * 10 + (*p - '0');
+	      }
+	  if (p - frac_start > 100000)
+	    return nullptr;
+	  exp10 = frac_start - p;
+	  frac_digits = exp10 != 0;
+	}
+      if (!int_digits && !frac_digits)
+	return nullptr;
+
+      if (fmt != chars_format::fixed && p != last && (*p == 'e' || *p == 'E'))
+	{
+	  const char* q = p + 1;
+	  const bool eneg = q != last && *q == '-';
+	  q += (q != last && (*q == '-' || *q == '+'));
+	  if (q != last && unsigned(*q - '0') < 10)
+	    {
+	      int e = 0;
+	      for (; q != last && unsigned(*q - '0') < 10; ++q)
+		{
+		  if (e > 100000)
+		    return nullptr;
+		  e = e * 10 + (*q - '0');
+		}
+	      exp10 += eneg ? -e : e;
+	      p = q;
+	    }
+	  else if (fmt == chars_format::scientific)
+	    return nullptr;
+	}
+      else if (fmt == chars_format::scientific)
+	return nullptr;
+
+      if (mant == 0)
+	value = neg ? -T(0) : T(0);
+      else if (eisel_lemire(mant, exp10, value))
+	{
+	  if (neg)
+	    value = -value;
+	}
+      else
+	return nullptr;
+      return p;
+    }
+
 #if ! _GLIBCXX_USE_CXX11_ABI
   inline bool
   reserve_string(std::string& s) noexcept
@@ -398,14 +592,18 @@ namespace
 
 } // namespace
 
-// FIXME: This should be reimplemented so it doesn't use strtod and newlocale.
-// That will avoid the need for any memory allocation, meaning that the
-// non-conforming errc::not_enough_memory result cannot happen.
+// FIXME: The slow path should be reimplemented so it doesn't use strtod and
+// newlocale.  That will avoid the need for any memory allocation, meaning
+// that the non-conforming errc::not_enough_memory result cannot happen.
 
 from_chars_result
 from_chars(const char* first, const char* last, float& value,
 	   chars_format fmt) noexcept
 {
+  if (valid_fmt(fmt) && fmt != chars_format::hex)
+    if (const char* end = from_chars_fast(first, last, value, fmt)) [[likely]]
+      return { end, errc() };
+
   errc ec = errc::invalid_argument;
 #if _GLIBCXX_USE_CXX11_ABI
   buffer_resource mr;
@@ -432,6 +630,10 @@ from_chars_result
 from_chars(const char* first, const char* last, double& value,
 	   chars_format fmt) noexcept
 {
+  if (valid_fmt(fmt) && fmt != chars_format::hex)
+    if (const char* end = from_chars_fast(first, last, value, fmt)) [[likely]]
+      return { end, errc() };
+
   errc ec = errc::invalid_argument;
 #if _GLIBCXX_USE_CXX11_ABI
   buffer_resource mr;
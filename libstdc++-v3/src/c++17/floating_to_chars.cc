@@ -1582,6 +1582,21 @@ to_chars(char* first, char* last, double value, chars_format fmt,
 	 int precision) noexcept
 { return __floating_to_chars_precision(first, last, value, fmt, precision); }
 
+namespace __detail
+{
+  // Used by num_put::_M_insert_float, see <bits/locale_facets.tcc>.
+  char*
+  __to_chars_fmt(char* first, char* last, double value, int fmt,
+		 int precision) noexcept
+  {
+    const auto result
+      = __floating_to_chars_precision(first, last, value,
+				      static_cast<chars_format>(fmt),
+				      precision);
+    return result.ec == errc{} ? result.ptr : nullptr;
+  }
+} // namespace __detail
+
 // Define the overloads for long double.
 to_chars_result
 to_chars(char* first, char* last, long double value) noexcept
@@ -51,6 +51,16 @@ struct fs::_Dir : _Dir_base
       path = p;
   }
 
+#ifdef _GLIBCXX_FILESYSTEM_OPENDIRAT
+  _Dir(posix::DIR* parent, const char* name, const fs::path& p,
+       bool skip_permission_denied, error_code& ec)
+  : _Dir_base(parent, name, skip_permission_denied, ec)
+  {
+    if (!ec)
+      path = p;
+  }
+#endif
+
   _Dir(posix::DIR* dirp, const path& p) : _Dir_base(dirp), path(p) { }
 
   _Dir(_Dir&&) = default;
@@ -61,15 +71,17 @@ struct fs::_Dir : _Dir_base
   {
     if (const auto entp = _Dir_base::advance(skip_permission_denied, ec))
       {
-	auto name = path;
-	name /= entp->d_name;
+	// Build the new path in the storage of the previous one, which
+	// has the same components apart from the last.
+	entry._M_path = path;
+	entry._M_path /= entp->d_name;
 	file_type type = file_type::none;
 #ifdef _GLIBCXX_HAVE_STRUCT_DIRENT_D_TYPE
 	// Even if the OS supports dirent::d_type the filesystem might not:
 	if (entp->d_type != DT_UNKNOWN)
 	  type = get_file_type(*entp);
 #endif
-	entry = fs::directory_entry{std::move(name), type};
+	entry._M_type = type;
 	return true;
       }
     else if (!ec)
@@ -111,6 +123,19 @@ struct fs::_Dir : _Dir_base
     return false;
   }
 
+  // Open the directory that entry refers to.
+  _Dir open_subdir(bool skip_permission_denied, error_code& ec) const
+  {
+#ifdef _GLIBCXX_FILESYSTEM_OPENDIRAT
+    // The entry's path ends with its name in this directory.
+    const auto& p = entry.path().native();
+    const auto name = p.c_str() + (p.rfind(fs::path::preferred_separator) + 1);
+    return _Dir(dirp, name, entry.path(), skip_permission_denied, ec);
+#else
+    return _Dir(entry.path(), skip_permission_denied, ec);
+#endif
+  }
+
   fs::path		path;
   directory_entry	entry;
 };
@@ -287,7 +312,7 @@ fs::recursive_directory_iterator::increment(error_code& ec)
 
   if (std::exchange(_M_dirs->pending, true) && top.should_recurse(follow, ec))
     {
-      _Dir dir(top.entry.path(), skip_permission_denied, ec);
+      _Dir dir = top.open_subdir(skip_permission_denied, ec);
       if (ec)
 	{
 	  _M_dirs.reset();
@@ -1092,12 +1092,38 @@ namespace pmr
    * In a single-threaded program (i.e. __gthread_active_p() == false)
    * the pool resource only needs one set of pools and never has orphaned
    * chunks, so just uses _M_tpools[0] directly, and _M_tpools->next is null.
+   *
+   * With TLS, each thread also caches a pointer to its _M_tpools[_M_key]
+   * for the pool resource it used last, and can then use its own pools
+   * without taking the shared lock.  It sets its cache's busy flag while
+   * doing so.  Before accessing another thread's pools, or destroying
+   * them, a thread holding the exclusive lock clears that thread's cached
+   * pointer and waits until its busy flag is clear.  The cached pointer is
+   * only ever set by the thread that owns it, while holding a lock.
+   *
+   * A block that is not in a thread's own pools is not returned to the
+   * pool it came from straight away.  It is added to the thread's list of
+   * deferred blocks, and the whole list is returned the next time the
+   * thread holds the exclusive lock anyway, or when the list is full.
    */
 
   extern "C" {
     static void destroy_TPools(void*);
   }
 
+#ifdef _GLIBCXX_HAVE_TLS
+  namespace {
+  struct tpools_cache
+  {
+    const synchronized_pool_resource* owner;
+    synchronized_pool_resource::_TPools* tpools;
+    bool busy;
+  };
+
+  __thread tpools_cache tls_tpools;
+  } // namespace
+#endif
+
   struct synchronized_pool_resource::_TPools
   {
     // Exclusive lock must be held in the thread where this constructor runs.
@@ -1144,15 +1170,126 @@ namespace pmr
 	    shared[i]._M_chunks.insert(std::move(c), r);
     }
 
+    // Add a block from another thread's pools to the deferred blocks.
+    // Only the thread that owns this object can call this function.
+    bool defer(void* p, ptrdiff_t index) noexcept
+    {
+      if (num_deferred == max_deferred)
+	return false;
+      deferred[num_deferred++] = { p, int(index) };
+      return true;
+    }
+
+    // Return the deferred blocks to the pools they came from.
+    // Exclusive lock must be held in the thread where this function runs,
+    // and revoke_caches must have been called.
+    void return_deferred() noexcept
+    {
+      memory_resource* const r = owner.upstream_resource();
+      for (int i = 0; i < num_deferred; ++i)
+	for (_TPools* t = owner._M_tpools; t != nullptr; t = t->next)
+	  if (t != this && t->pools)
+	    if (t->pools[deferred[i].index].deallocate(r, deferred[i].p))
+	      break;
+      num_deferred = 0;
+    }
+
+#ifdef _GLIBCXX_HAVE_TLS
+    // Let the calling thread use this object without locking.
+    // Shared or exclusive lock must be held in the thread where this
+    // function runs, which must be the thread that owns this object.
+    void cache() noexcept
+    {
+      tpools_cache& c = tls_tpools;
+      c.owner = &owner;
+      __atomic_store_n(&c.tpools, this, __ATOMIC_RELAXED);
+      cached_by = &c;
+    }
+
+    // Stop the owning thread from using this object without locking, and
+    // wait until it is done with it.
+    // Exclusive lock must be held in the thread where this function runs.
+    void revoke_cache() noexcept
+    {
+      if (tpools_cache* c = cached_by)
+	{
+	  _TPools* expected = this;
+	  if (__atomic_compare_exchange_n(&c->tpools, &expected, nullptr,
+					  false, __ATOMIC_SEQ_CST,
+					  __ATOMIC_RELAXED))
+	    while (__atomic_load_n(&c->busy, __ATOMIC_SEQ_CST))
+	      __gthread_yield();
+	  cached_by = nullptr;
+	}
+    }
+
+    // Gives the calling thread its cached object for resource r, if any,
+    // for as long as it exists.
+    struct unlocked_access
+    {
+      explicit
+      unlocked_access(const synchronized_pool_resource* r) noexcept
+      {
+	tpools_cache& c = tls_tpools;
+	if (c.owner == r)
+	  {
+	    __atomic_store_n(&c.busy, true, __ATOMIC_SEQ_CST);
+	    tpools = __atomic_load_n(&c.tpools, __ATOMIC_SEQ_CST);
+	    if (!tpools)
+	      __atomic_store_n(&c.busy, false, __ATOMIC_RELEASE);
+	  }
+      }
+
+      ~unlocked_access()
+      {
+	if (tpools)
+	  __atomic_store_n(&tls_tpools.busy, false, __ATOMIC_RELEASE);
+      }
+
+      unlocked_access(const unlocked_access&) = delete;
+      unlocked_access& operator=(const unlocked_access&) = delete;
+
+      _TPools* tpools = nullptr;
+    };
+#else
+    void cache() noexcept { }
+    void revoke_cache() noexcept { }
+#endif
+
+    // Exclusive lock must be held in the thread where this function runs.
+    static void revoke_caches(_TPools* head) noexcept
+    {
+      for (_TPools* t = head; t != nullptr; t = t->next)
+	t->revoke_cache();
+    }
+
+    // Caller must hold shared or exclusive lock.
+    static _TPools* of_current_thread(synchronized_pool_resource& r) noexcept
+    { return static_cast<_TPools*>(__gthread_getspecific(r._M_key)); }
+
     synchronized_pool_resource& owner;
     __pool_resource::_Pool* pools = nullptr;
     _TPools* prev = nullptr;
     _TPools* next = nullptr;
+#ifdef _GLIBCXX_HAVE_TLS
+    // The cache of the owning thread, if it refers to this object.
+    tpools_cache* cached_by = nullptr;
+#endif
+    // Blocks from other threads' pools, see defer.
+    static constexpr int max_deferred = 32;
+    struct { void* p; int index; } deferred[max_deferred];
+    int num_deferred = 0;
 
     static void destroy(_TPools* p)
     {
       exclusive_lock l(p->owner._M_mx);
       // __glibcxx_assert(p != p->owner._M_tpools);
+      p->revoke_cache();
+      if (p->num_deferred)
+	{
+	  revoke_caches(p->owner._M_tpools);
+	  p->return_deferred();
+	}
       p->move_nonempty_chunks();
       polymorphic_allocator<_TPools> a(p->owner.upstream_resource());
       p->~_TPools();
@@ -1201,6 +1338,7 @@ namespace pmr
 	    __gthread_key_delete(_M_key); // does not run destroy_TPools
 	    __gthread_key_create(&_M_key, destroy_TPools);
 	  }
+	_TPools::revoke_caches(_M_tpools);
 	polymorphic_allocator<_TPools> a(upstream_resource());
 	// destroy+deallocate each _TPools
 	do
@@ -1243,12 +1381,22 @@ namespace pmr
 	const ptrdiff_t index = pool_index(block_size, _M_impl._M_npools);
 	if (__gthread_active_p())
 	  {
+#ifdef _GLIBCXX_HAVE_TLS
+	    // Try to allocate from the cached thread-specific pool.
+	    {
+	      _TPools::unlocked_access u(this);
+	      if (u.tpools) // [[likely]]
+		if (void* p = u.tpools->pools[index].try_allocate())
+		  return p;
+	    }
+#endif
 	    // Try to allocate from the thread-specific pool.
 	    shared_lock l(_M_mx);
-	    if (auto pools = _M_thread_specific_pools()) // [[likely]]
+	    if (auto tp = _TPools::of_current_thread(*this)) // [[likely]]
 	      {
+		tp->cache();
 		// Need exclusive lock to replenish so use try_allocate:
-		if (void* p = pools[index].try_allocate())
+		if (void* p = tp->pools[index].try_allocate())
 		  return p;
 		// Need to take exclusive lock and replenish pool.
 	      }
@@ -1269,10 +1417,16 @@ namespace pmr
 	exclusive_lock excl(_M_mx);
 	if (!_M_tpools) // [[unlikely]]
 	  _M_tpools = _M_alloc_shared_tpools(excl);
-	auto pools = _M_thread_specific_pools();
-	if (!pools)
-	  pools = _M_alloc_tpools(excl)->pools;
-	return pools[index].allocate(upstream_resource(), opts);
+	auto tp = _TPools::of_current_thread(*this);
+	if (!tp)
+	  tp = _M_alloc_tpools(excl);
+	else if (tp->num_deferred)
+	  {
+	    _TPools::revoke_caches(_M_tpools);
+	    tp->return_deferred();
+	  }
+	tp->cache();
+	return tp->pools[index].allocate(upstream_resource(), opts);
       }
     exclusive_lock l(_M_mx);
     return _M_impl.allocate(bytes, alignment); // unpooled allocation
@@ -1290,11 +1444,27 @@ namespace pmr
 	__glibcxx_assert(index != -1);
 	if (__gthread_active_p())
 	  {
+#ifdef _GLIBCXX_HAVE_TLS
+	    {
+	      _TPools::unlocked_access u(this);
+	      if (u.tpools) // [[likely]]
+		{
+		  if (u.tpools->pools[index].deallocate(upstream_resource(), p))
+		    return;
+		  if (u.tpools->defer(p, index))
+		    return;
+		}
+	    }
+#endif
 	    shared_lock l(_M_mx);
-	    if (auto pools = _M_thread_specific_pools())
+	    if (auto tp = _TPools::of_current_thread(*this))
 	      {
+		tp->cache();
 		// No need to lock here, no other thread is accessing this pool.
-		if (pools[index].deallocate(upstream_resource(), p))
+		if (tp->pools[index].deallocate(upstream_resource(), p))
+		  return;
+		// Block came from a different thread's pool, return it later.
+		if (tp->defer(p, index))
 		  return;
 	      }
 	    // Block might have come from a different thread's pool,
@@ -1308,12 +1478,11 @@ namespace pmr
 	    return;
 	  }
 
-	// TODO store {p, bytes, alignment} somewhere and defer returning
-	// the block to the correct thread-specific pool until we next
-	// take the exclusive lock.
-
 	exclusive_lock excl(_M_mx);
+	_TPools::revoke_caches(_M_tpools);
 	auto my_pools = _M_thread_specific_pools();
+	if (auto tp = _TPools::of_current_thread(*this))
+	  tp->return_deferred();
 	for (_TPools* t = _M_tpools; t != nullptr; t = t->next)
 	  {
 	    if (t->pools != my_pools)
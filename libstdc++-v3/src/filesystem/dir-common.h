@@ -36,6 +36,15 @@
 # endif
 # include <dirent.h>
 #endif
+#if defined _GLIBCXX_HAVE_OPENAT && defined _GLIBCXX_HAVE_FDOPENDIR \
+  && defined _GLIBCXX_HAVE_DIRFD && defined _GLIBCXX_HAVE_FCNTL_H \
+  && defined _GLIBCXX_HAVE_UNISTD_H
+# include <fcntl.h>
+# include <unistd.h>
+# if defined O_DIRECTORY && defined O_CLOEXEC
+#  define _GLIBCXX_FILESYSTEM_OPENDIRAT 1
+# endif
+#endif
 
 namespace std _GLIBCXX_VISIBILITY(default)
 {
@@ -59,6 +68,21 @@ typedef struct ::dirent dirent;
 using ::opendir;
 using ::readdir;
 using ::closedir;
+#ifdef _GLIBCXX_FILESYSTEM_OPENDIRAT
+// Open the directory called name in the directory open as dir.
+inline DIR* opendirat(DIR* dir, const char* name)
+{
+  int fd = ::openat(::dirfd(dir), name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd == -1)
+    return nullptr;
+  if (DIR* d = ::fdopendir(fd))
+    return d;
+  const int err = errno;
+  ::close(fd);
+  errno = err;
+  return nullptr;
+}
+#endif
 #else
 using char_type = char;
 struct dirent { const char* d_name; };
@@ -80,18 +104,16 @@ struct _Dir_base
   _Dir_base(const posix::char_type* pathname, bool skip_permission_denied,
 	    error_code& ec) noexcept
   : dirp(posix::opendir(pathname))
-  {
-    if (dirp)
-      ec.clear();
-    else
-    {
-      const int err = errno;
-      if (err == EACCES && skip_permission_denied)
-	ec.clear();
-      else
-	ec.assign(err, std::generic_category());
-    }
-  }
+  { check_open(skip_permission_denied, ec); }
+
+#ifdef _GLIBCXX_FILESYSTEM_OPENDIRAT
+  // As above, for the directory called name in the directory open as
+  // parent, which saves the kernel looking up the whole path again.
+  _Dir_base(posix::DIR* parent, const char* name,
+	    bool skip_permission_denied, error_code& ec) noexcept
+  : dirp(posix::opendirat(parent, name))
+  { check_open(skip_permission_denied, ec); }
+#endif
 
   _Dir_base(_Dir_base&& d) : dirp(std::exchange(d.dirp, nullptr)) { }
 
@@ -130,6 +152,21 @@ struct _Dir_base
       }
   }
 
+  void
+  check_open(bool skip_permission_denied, error_code& ec) noexcept
+  {
+    if (dirp)
+      ec.clear();
+    else
+    {
+      const int err = errno;
+      if (err == EACCES && skip_permission_denied)
+	ec.clear();
+      else
+	ec.assign(err, std::generic_category());
+    }
+  }
+
   static bool is_dot_or_dotdot(const char* s) noexcept
   { return !strcmp(s, ".") || !strcmp(s, ".."); }
 
@@ -0,0 +1,153 @@
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// <charconv> is supported in C++14 as a GNU extension
+// { dg-do run { target c++14 } }
+// { dg-add-options ieee }
+
+#include <charconv>
+#include <string>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <testsuite_hooks.h>
+
+// Test std::from_chars for decimal strings of up to 19 significant digits,
+// which don't need strtod.
+
+#if __cpp_lib_to_chars >= 201611L
+template<typename T>
+void
+check(const char* s, T expected, std::size_t len = std::string::npos,
+      std::chars_format fmt = std::chars_format::general)
+{
+  const std::size_t n = std::strlen(s);
+  if (len == std::string::npos)
+    len = n;
+  T val;
+  auto res = std::from_chars(s, s + n, val, fmt);
+  VERIFY( res.ec == std::errc{} );
+  VERIFY( res.ptr == s + len );
+  VERIFY( val == expected );
+  VERIFY( std::signbit(val) == std::signbit(expected) );
+}
+
+void
+test01()
+{
+  // Halfway between two doubles, round to even.
+  check("9007199254740993", 9007199254740992.0);
+  check("9007199254740995", 9007199254740996.0);
+  check("9007199254740993.0000001", 9007199254740994.0);
+  check("16777217", 16777216.0f);
+  check("16777219", 16777220.0f);
+
+  check("0.1", 0.1);
+  check("0.1", 0.1f);
+  check("-.5", -0.5);
+  check("5.", 5.0);
+  check("1e23", 1e23);
+  check("8.589973e9", 8.589973e9f);
+  check("1234567890123456789", 1234567890123456789.0);
+  check("00000.000", 0.0);
+  check("-0", -0.0);
+  check("-0e-999", -0.0f);
+
+  // Largest and smallest normal values.
+  check("1.7976931348623157e308", std::numeric_limits<double>::max());
+  check("3.4028235e38", std::numeric_limits<float>::max());
+  check("2.2250738585072014e-308", std::numeric_limits<double>::min());
+  check("1.17549435e-38", std::numeric_limits<float>::min());
+
+  // The exponent is only consumed if it is complete.
+  check("1e", 1.0, 1);
+  check("1e+", 1.0, 1);
+  check("1.5E-3", 1.5e-3);
+  check("1.5e3", 1.5, 3, std::chars_format::fixed);
+  check("1.5e3", 1500.0, 5, std::chars_format::scientific);
+  check("2.5x", 2.5, 3);
+}
+
+void
+test02()
+{
+  // Out of range values are still reported.
+  double d = 1.0;
+  std::string s = "1e400";
+  auto res = std::from_chars(s.data(), s.data() + s.length(), d);
+  VERIFY( res.ec == std::errc::result_out_of_range );
+  VERIFY( res.ptr == s.data() + s.length() );
+  VERIFY( d == 1.0 );
+
+  float f = 1.0f;
+  s = "3.5e38";
+  res = std::from_chars(s.data(), s.data() + s.length(), f);
+  VERIFY( res.ec == std::errc::result_out_of_range );
+  VERIFY( f == 1.0f );
+
+  // The exponent is required for scientific.
+  s = "1.5";
+  res = std::from_chars(s.data(), s.data() + s.length(), d,
+			std::chars_format::scientific);
+  VERIFY( res.ec == std::errc::invalid_argument );
+  VERIFY( res.ptr == s.data() );
+}
+
+void
+test03()
+{
+  // Shortest representations round-trip.
+  char buf[64];
+  unsigned long long bits = 0x0123456789abcdefULL;
+  for (int i = 0; i < 10000; i++)
+    {
+      bits = bits * 6364136223846793005ULL + 1442695040888963407ULL;
+      double d, d2;
+      std::memcpy(&d, &bits, sizeof(d));
+      if (std::isnormal(d))
+	{
+	  auto r = std::to_chars(buf, buf + sizeof(buf), d);
+	  auto res = std::from_chars(buf, r.ptr, d2);
+	  VERIFY( res.ec == std::errc{} );
+	  VERIFY( res.ptr == r.ptr );
+	  VERIFY( std::memcmp(&d, &d2, sizeof(d)) == 0 );
+	}
+
+      float f, f2;
+      unsigned int fbits = bits >> 32;
+      std::memcpy(&f, &fbits, sizeof(f));
+      if (std::isnormal(f))
+	{
+	  auto r = std::to_chars(buf, buf + sizeof(buf), f);
+	  auto res = std::from_chars(buf, r.ptr, f2);
+	  VERIFY( res.ec == std::errc{} );
+	  VERIFY( res.ptr == r.ptr );
+	  VERIFY( std::memcmp(&f, &f2, sizeof(f)) == 0 );
+	}
+    }
+}
+#endif
+
+int
+main()
+{
+#if __cpp_lib_to_chars >= 201611L
+  test01();
+  test02();
+  test03();
+#endif
+}
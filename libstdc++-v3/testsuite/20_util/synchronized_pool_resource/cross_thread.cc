@@ -0,0 +1,108 @@
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run }
+// { dg-options "-std=gnu++17 -pthread" }
+// { dg-require-effective-target c++17 }
+// { dg-require-effective-target pthread }
+// { dg-require-gthreads "" }
+
+#include <memory_resource>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <testsuite_allocator.h>
+#include <testsuite_hooks.h>
+
+// Blocks freed by a thread other than the one which allocated them.
+void
+test01()
+{
+  __gnu_test::memory_resource test_mr;
+  {
+    std::pmr::synchronized_pool_resource smr(&test_mr);
+    std::vector<void*> blocks(1000);
+
+    std::thread t1([&] {
+      for (auto& p : blocks)
+	{
+	  p = smr.allocate(48);
+	  std::memset(p, 1, 48);
+	}
+    });
+    t1.join();
+
+    // The blocks of t1 are now in orphaned chunks.
+    std::thread t2([&] {
+      void* mine = smr.allocate(48);
+      for (auto p : blocks)
+	smr.deallocate(p, 48);
+      smr.deallocate(mine, 48);
+      // Blocks allocated after the deferred ones were returned are usable.
+      for (auto& p : blocks)
+	p = smr.allocate(48);
+    });
+    t2.join();
+    for (auto p : blocks)
+      smr.deallocate(p, 48);
+  }
+  VERIFY( test_mr.number_of_active_allocations() == 0 );
+}
+
+// Concurrent allocation and cross-thread deallocation.
+void
+test02()
+{
+  __gnu_test::memory_resource test_mr;
+  std::pmr::synchronized_pool_resource smr(&test_mr);
+  std::atomic<void*> handoff{nullptr};
+
+  auto work = [&] {
+    for (unsigned n = 0; n < 20000; ++n)
+      {
+	const std::size_t size = 8 << (n % 6);
+	void* p = smr.allocate(size);
+	std::memset(p, 0, size);
+	if (size == 16)
+	  {
+	    // Pass the block to whichever thread gets here next.
+	    if (void* q = handoff.exchange(p))
+	      smr.deallocate(q, 16);
+	  }
+	else
+	  smr.deallocate(p, size);
+      }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back(work);
+  for (auto& t : threads)
+    t.join();
+  if (void* q = handoff.exchange(nullptr))
+    smr.deallocate(q, 16);
+  smr.release();
+  VERIFY( test_mr.number_of_active_allocations() == 0 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// 22.2.2.2.1  num_put members
+
+#include <locale>
+#include <sstream>
+#include <cstdio>
+#include <climits>
+#include <testsuite_hooks.h>
+
+// The "C" locale conversions, which do not go through printf, give
+// the same results as printf.
+
+const double values[] = {
+  0.0, -0.0, 1.0, -2.5, 0.1, 1.0 / 3, 0.0001, 0.00001, 123456.0,
+  1234567.0, 999999.5, 9.9999995, 1e15, 1e-320, 1e300, -1.5e-300,
+  1.7976931348623157e308, 5e-324
+};
+
+void test01()
+{
+  using namespace std;
+
+  const ios_base::fmtflags fields[] = {
+    ios_base::fmtflags(), ios_base::fixed, ios_base::scientific
+  };
+  const char* formats[] = { "%.*g", "%.*f", "%.*e" };
+  const int precisions[] = { 0, 1, 6, 17, 40 };
+  char buf[1024];
+
+  for (unsigned i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    for (unsigned f = 0; f < 3; ++f)
+      for (unsigned p = 0; p < sizeof(precisions) / sizeof(int); ++p)
+	{
+	  ostringstream oss;
+	  oss.flags(fields[f]);
+	  oss.precision(precisions[p]);
+	  oss << values[i];
+	  snprintf(buf, sizeof(buf), formats[f], precisions[p], values[i]);
+	  VERIFY( oss.str() == buf );
+	}
+}
+
+void test02()
+{
+  using namespace std;
+
+  const long values[] = { 0, 7, -7, 10, 99, -100, 12345, LONG_MAX, LONG_MIN };
+  char buf[64];
+
+  for (unsigned i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    {
+      ostringstream oss;
+      oss << values[i];
+      snprintf(buf, sizeof(buf), "%ld", values[i]);
+      VERIFY( oss.str() == buf );
+
+      oss.str("");
+      oss << static_cast<unsigned long>(values[i]);
+      snprintf(buf, sizeof(buf), "%lu", static_cast<unsigned long>(values[i]));
+      VERIFY( oss.str() == buf );
+    }
+}
+
+struct Punct : std::numpunct<char>
+{
+  char do_decimal_point() const { return ','; }
+  char do_thousands_sep() const { return '.'; }
+  std::string do_grouping() const { return "\3"; }
+};
+
+// Other locales still get their decimal point and grouping.
+void test03()
+{
+  using namespace std;
+
+  ostringstream oss;
+  oss.imbue(locale(locale::classic(), new Punct));
+  oss << 1234567L << ' ' << 1234.5;
+  VERIFY( oss.str() == "1.234.567 1.234,5" );
+
+  oss.str("");
+  oss.setf(ios_base::fixed, ios_base::floatfield);
+  oss.precision(2);
+  oss.width(16);
+  oss << -1234567.25;
+  VERIFY( oss.str() == "   -1.234.567,25" );
+}
+
+int main()
+{
+  test01();
+  test02();
+  test03();
+  return 0;
+}
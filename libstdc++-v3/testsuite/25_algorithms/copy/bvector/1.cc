@@ -0,0 +1,52 @@
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <vector>
+
+#include <testsuite_hooks.h>
+
+void test01()
+{
+  using namespace std;
+
+  vector<bool> v1(300), v2(400, true);
+  for (int i = 0; i < 300; ++i)
+    v1[i] = (i % 5 == 0) || (i % 13 == 0);
+
+  vector<bool>::iterator it = copy(v1.begin() + 3, v1.end(), v2.begin() + 70);
+  VERIFY( it == v2.begin() + 367 );
+  for (int i = 0; i < 400; ++i)
+    VERIFY( v2[i] == (i < 70 || i >= 367 ? true : bool(v1[i - 67])) );
+
+  // Overlapping ranges are allowed when copying to the left.
+  vector<bool> v3(v1);
+  copy(v3.begin() + 100, v3.end(), v3.begin() + 33);
+  for (int i = 0; i < 300; ++i)
+    VERIFY( v3[i] == (i < 33 || i >= 233 ? bool(v1[i]) : bool(v1[i + 67])) );
+
+  const vector<bool>& cv1 = v1;
+  vector<bool> v4(300);
+  copy(cv1.begin(), cv1.end(), v4.begin());
+  VERIFY( v4 == v1 );
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <vector>
+
+#include <testsuite_hooks.h>
+
+void test01()
+{
+  using namespace std;
+
+  vector<bool> v(300, false);
+  for (int i = 0; i < 300; i += 7)
+    v[i] = true;
+
+  VERIFY( count(v.begin(), v.end(), true) == 43 );
+  VERIFY( count(v.begin(), v.end(), false) == 257 );
+  VERIFY( count(v.begin() + 1, v.begin() + 7, true) == 0 );
+  VERIFY( count(v.begin() + 1, v.begin() + 8, true) == 1 );
+  VERIFY( count(v.begin() + 63, v.begin() + 130, 1) == 10 );
+  VERIFY( count(v.begin() + 4, v.begin() + 4, false) == 0 );
+  VERIFY( count(v.begin(), v.end(), 2) == 0 );
+
+  const vector<bool>& cv = v;
+  VERIFY( count(cv.begin() + 3, cv.end(), true) == 42 );
+
+  vector<bool> e;
+  VERIFY( count(e.begin(), e.end(), false) == 0 );
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
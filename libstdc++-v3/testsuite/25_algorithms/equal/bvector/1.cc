@@ -0,0 +1,47 @@
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <vector>
+
+#include <testsuite_hooks.h>
+
+void test01()
+{
+  using namespace std;
+
+  vector<bool> v1(300), v2(310);
+  for (int i = 0; i < 300; ++i)
+    v1[i] = v2[i + 7] = (i % 3 == 0) || (i % 11 == 0);
+
+  VERIFY( equal(v1.begin(), v1.end(), v2.begin() + 7) );
+  VERIFY( !equal(v1.begin(), v1.end(), v2.begin() + 6) );
+  VERIFY( equal(v1.begin() + 5, v1.begin() + 5, v2.begin()) );
+
+  v2[250].flip();
+  VERIFY( equal(v1.begin(), v1.begin() + 243, v2.begin() + 7) );
+  VERIFY( !equal(v1.begin(), v1.begin() + 244, v2.begin() + 7) );
+
+  const vector<bool>& cv1 = v1;
+  VERIFY( !equal(cv1.begin(), cv1.end(), v2.begin() + 7) );
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
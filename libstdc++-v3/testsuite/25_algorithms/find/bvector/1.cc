@@ -0,0 +1,48 @@
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <vector>
+
+#include <testsuite_hooks.h>
+
+void test01()
+{
+  using namespace std;
+
+  vector<bool> v(300, false);
+  v[5] = v[70] = v[200] = true;
+
+  VERIFY( find(v.begin(), v.end(), true) - v.begin() == 5 );
+  VERIFY( find(v.begin() + 6, v.end(), true) - v.begin() == 70 );
+  VERIFY( find(v.begin() + 71, v.begin() + 200, true) == v.begin() + 200 );
+  VERIFY( find(v.begin() + 201, v.end(), true) == v.end() );
+  VERIFY( find(v.begin() + 3, v.begin() + 3, false) == v.begin() + 3 );
+  VERIFY( find(v.begin(), v.end(), 2) == v.end() );
+
+  const vector<bool>& cv = v;
+  VERIFY( find(cv.begin() + 70, cv.end(), false) - cv.begin() == 71 );
+
+  vector<bool> e;
+  VERIFY( find(e.begin(), e.end(), true) == e.end() );
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
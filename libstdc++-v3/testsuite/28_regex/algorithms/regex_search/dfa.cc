@@ -0,0 +1,101 @@
+// { dg-do run { target c++11 } }
+
+//
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// regex_match and regex_search without match_results must agree with the
+// overloads that compute the submatches.
+
+#include <regex>
+#include <string>
+#include <testsuite_hooks.h>
+
+using namespace std;
+
+void
+check(const char* pat, const char* s, regex_constants::match_flag_type f,
+      regex_constants::syntax_option_type o = regex_constants::ECMAScript)
+{
+  regex re(pat, o);
+  cmatch m;
+  VERIFY( regex_match(s, re, f) == regex_match(s, m, re, f) );
+  VERIFY( regex_search(s, re, f) == regex_search(s, m, re, f) );
+}
+
+void
+test01()
+{
+  const char* pats[] = {
+    "a(b|c)*d", "^ab", "ab$", "^$", "(a*)*b", "x?", "(?:ab)+c",
+    "[a-c]{2,3}d", ".*c", "a|^b|c$", "(a)\\1", "\\bab", "a(?=b)"
+  };
+  const char* strs[] = { "", "a", "ab", "abd", "acbd", "xabdx", "bab",
+			 "abab", "ababc", "aaab", "aabbd", "a ab", "abcd" };
+  regex_constants::match_flag_type flags[] = {
+    regex_constants::match_default,
+    regex_constants::match_not_bol,
+    regex_constants::match_not_eol,
+    regex_constants::match_continuous,
+    regex_constants::match_prev_avail,
+    regex_constants::match_not_null,
+    regex_constants::match_not_bol | regex_constants::match_not_eol
+  };
+  for (auto p : pats)
+    for (auto s : strs)
+      for (auto f : flags)
+	check(p, s, f);
+
+  check("a(b|c)*d", "xabcd", regex_constants::match_default,
+	regex_constants::extended);
+  check("A+B", "aab", regex_constants::match_default,
+	regex_constants::ECMAScript | regex_constants::icase);
+}
+
+void
+test02()
+{
+  // Long inputs don't need deep recursion.
+  string s(200000, 'a');
+  VERIFY( regex_match(s, regex("(a|b)*")) );
+  VERIFY( !regex_match(s, regex("(a|aa)*b")) );
+  s += "xyz";
+  VERIFY( regex_search(s, regex("a(x|y)z?y")) );
+  VERIFY( !regex_search(s, regex("^x")) );
+
+  // More DFA states than are cached at once.
+  string t;
+  unsigned x = 1;
+  for (int i = 0; i < 4096; i++)
+    {
+      x = x * 1103515245 + 12345;
+      t += "ab"[(x >> 16) & 1];
+    }
+  regex re("a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)c$");
+  VERIFY( !regex_search(t, re) );
+  t += "aaaaaaaaaaac";
+  VERIFY( regex_search(t, re) );
+  t += "c";
+  VERIFY( !regex_search(t, re) );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
@@ -0,0 +1,69 @@
+// { dg-options "-std=gnu++2a" }
+// { dg-do run { target c++2a } }
+// { dg-require-gthreads "" }
+// { dg-additional-options "-pthread" { target pthread } }
+// { dg-add-options libatomic }
+
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <thread>
+
+#include <testsuite_hooks.h>
+
+// Adjacent atomics share an entry of the waiter pool, so notify_one on one
+// of them must still wake its own waiter.
+
+constexpr int N = 4;
+constexpr int iterations = 1000;
+
+alignas(4) std::atomic<unsigned char> c[N];
+
+int
+main ()
+{
+  std::thread t[N];
+  for (int i = 0; i < N; ++i)
+    t[i] = std::thread([i]
+      {
+	for (int k = 0; k < iterations; ++k)
+	  {
+	    const unsigned char even = 2 * k;
+	    c[i].wait(even);
+	    VERIFY( c[i].load() == (unsigned char)(even + 1) );
+	    c[i].store(even + 2);
+	    c[i].notify_one();
+	  }
+      });
+
+  for (int k = 0; k < iterations; ++k)
+    {
+      const unsigned char even = 2 * k;
+      for (int i = 0; i < N; ++i)
+	{
+	  c[i].store(even + 1);
+	  c[i].notify_one();
+	}
+      for (int i = 0; i < N; ++i)
+	c[i].wait(even + 1);
+    }
+
+  for (auto& th : t)
+    th.join();
+  return 0;
+}
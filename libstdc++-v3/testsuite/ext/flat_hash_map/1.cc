@@ -0,0 +1,140 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <ext/flat_hash_map>
+#include <unordered_map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <testsuite_hooks.h>
+
+typedef __gnu_cxx::flat_hash_map<long, long> map_type;
+
+// Random insertions and erasures must behave like std::unordered_map.
+void
+test01()
+{
+  unsigned long x = 1;
+  for (long range : { 10, 100, 3000 })
+    {
+      map_type m;
+      std::unordered_map<long, long> u;
+      for (long i = 0; i < 50000; i++)
+	{
+	  x = x * 6364136223846793005UL + 1442695040888963407UL;
+	  const long k = (x >> 33) % range;
+	  switch ((x >> 20) % 4)
+	    {
+	    case 0:
+	      VERIFY( m.insert({k, i}).second == u.insert({k, i}).second );
+	      break;
+	    case 1:
+	      VERIFY( m.erase(k) == u.erase(k) );
+	      break;
+	    case 2:
+	      VERIFY( m.count(k) == u.count(k) );
+	      break;
+	    default:
+	      m[k] += i;
+	      u[k] += i;
+	      break;
+	    }
+	  VERIFY( m.size() == u.size() );
+	}
+      long n = 0;
+      for (auto& v : m)
+	{
+	  VERIFY( u.at(v.first) == v.second );
+	  n++;
+	}
+      VERIFY( n == long(u.size()) );
+      VERIFY( m.load_factor() <= m.max_load_factor() );
+    }
+}
+
+void
+test02()
+{
+  map_type m{ {1, 10}, {2, 20}, {3, 30} };
+  VERIFY( m.size() == 3 );
+  VERIFY( m.at(2) == 20 );
+  VERIFY( m.find(4) == m.end() );
+
+  bool caught = false;
+  try
+    {
+      m.at(4);
+    }
+  catch (const std::out_of_range&)
+    {
+      caught = true;
+    }
+  VERIFY( caught );
+
+  map_type c = m;
+  VERIFY( c == m );
+  c[4] = 40;
+  VERIFY( c != m );
+  map_type d = std::move(c);
+  VERIFY( c.empty() );
+  VERIFY( d.size() == 4 );
+  d.swap(c);
+  VERIFY( d.empty() && c.size() == 4 );
+
+  for (auto it = c.begin(); it != c.end(); )
+    if (it->first % 2)
+      it = c.erase(it);
+    else
+      ++it;
+  VERIFY( c.size() == 2 && c.count(2) && c.count(4) );
+
+  c.clear();
+  VERIFY( c.empty() && c.begin() == c.end() );
+  c.reserve(1000);
+  const auto n = c.bucket_count();
+  for (int i = 0; i < 1000; i++)
+    c[i] = i;
+  VERIFY( c.bucket_count() == n );
+}
+
+// Move-only and non-trivial elements.
+void
+test03()
+{
+  __gnu_cxx::flat_hash_map<std::string, std::unique_ptr<int>> m;
+  for (int i = 0; i < 1000; i++)
+    VERIFY( m.try_emplace(std::to_string(i), new int(i)).second );
+  VERIFY( !m.try_emplace("7", nullptr).second );
+  for (int i = 0; i < 1000; i++)
+    VERIFY( *m.at(std::to_string(i)) == i );
+
+  VERIFY( m.emplace("x", nullptr).second );
+  VERIFY( !m.insert_or_assign("x", std::unique_ptr<int>(new int(5))).second );
+  VERIFY( *m["x"] == 5 );
+  VERIFY( m.erase("x") == 1 );
+  VERIFY( m.size() == 1000 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,186 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <ext/slab_allocator.h>
+#include <map>
+#include <set>
+#include <list>
+#include <unordered_map>
+#include <string>
+#include <cstdlib>
+#include <new>
+#include <testsuite_hooks.h>
+
+static unsigned long news;
+
+void*
+operator new(std::size_t n)
+{
+  ++news;
+  if (void* p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{ std::free(p); }
+
+void
+operator delete(void* p, std::size_t) noexcept
+{ std::free(p); }
+
+template<typename T>
+  using alloc = __gnu_cxx::slab_allocator<T>;
+
+typedef std::map<int, std::string, std::less<int>,
+		 alloc<std::pair<const int, std::string>>> map_type;
+
+// Nodes come from a few slabs, and behave like any others.
+void
+test01()
+{
+  {
+    std::map<int, int, std::less<int>, alloc<std::pair<const int, int>>> m;
+    news = 0;
+    for (int i = 0; i < 10000; i++)
+      m[i * 7 % 10000] = i;
+    VERIFY( news < 100 );
+    VERIFY( m.size() == 10000 );
+    int k = 0;
+    for (auto& v : m)
+      VERIFY( v.first == k++ && v.second * 7 % 10000 == v.first );
+
+    // Freed nodes are reused.
+    for (int i = 0; i < 5000; i++)
+      m.erase(i * 2);
+    news = 0;
+    for (int i = 0; i < 5000; i++)
+      m[-i - 1] = i;
+    VERIFY( news == 0 );
+    VERIFY( m.size() == 10000 );
+  }
+
+  map_type m;
+  for (int i = 0; i < 1000; i++)
+    m.emplace(i, std::to_string(i));
+  for (int i = 0; i < 1000; i++)
+    VERIFY( m.at(i) == std::to_string(i) );
+  m.clear();
+  VERIFY( m.empty() );
+  m[1] = "one";
+  VERIFY( m.size() == 1 && m[1] == "one" );
+}
+
+// Copies get arenas of their own, moves and swaps take the arena along.
+void
+test02()
+{
+  map_type m;
+  for (int i = 0; i < 100; i++)
+    m[i] = std::to_string(i);
+
+  map_type c = m;
+  VERIFY( c == m );
+  VERIFY( c.get_allocator() != m.get_allocator() );
+  c[100] = "100";
+  VERIFY( m.size() == 100 && c.size() == 101 );
+
+  const auto a = c.get_allocator();
+  map_type d = std::move(c);
+  VERIFY( d.get_allocator() == a );
+  VERIFY( d.size() == 101 );
+  c[1] = "1";
+  VERIFY( c.size() == 1 );
+
+  d.swap(m);
+  VERIFY( m.get_allocator() == a && m.size() == 101 );
+  VERIFY( d.size() == 100 );
+
+  m = d;
+  VERIFY( m == d && m.get_allocator() == a );
+  d = std::move(m);
+  VERIFY( d.get_allocator() == a && d.size() == 100 );
+}
+
+// Containers constructed with the same allocator can exchange nodes.
+void
+test03()
+{
+  typedef std::list<int, alloc<int>> list_type;
+  list_type l1;
+  list_type l2(l1.get_allocator());
+  VERIFY( l1.get_allocator() == l2.get_allocator() );
+  for (int i = 0; i < 100; i++)
+    (i % 2 ? l1 : l2).push_back(i);
+  l1.splice(l1.end(), l2);
+  VERIFY( l1.size() == 100 && l2.empty() );
+  l1.sort();
+  int k = 0;
+  for (int i : l1)
+    VERIFY( i == k++ );
+
+  typedef std::set<int, std::less<int>, alloc<int>> set_type;
+  set_type s1;
+  set_type s2(s1.key_comp(), s1.get_allocator());
+  s1.insert({1, 3, 5});
+  s2.insert({2, 4, 5});
+#if __cplusplus > 201402L
+  s1.merge(s2);
+  VERIFY( s1.size() == 5 && s2.size() == 1 );
+#endif
+}
+
+// Arrays, such as the buckets of an unordered container, and objects of
+// other sizes do not come from the slabs.
+void
+test04()
+{
+  std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+		     alloc<std::pair<const int, int>>> u;
+  for (int i = 0; i < 10000; i++)
+    u[i] = i;
+  for (int i = 0; i < 10000; i++)
+    VERIFY( u.at(i) == i );
+
+  alloc<char> a;
+  alloc<long double> b(a);
+  char* p = a.allocate(1);
+  long double* q = b.allocate(1);
+  char* r = a.allocate(1);
+  VERIFY( reinterpret_cast<unsigned long>(q) % alignof(long double) == 0 );
+  *p = 'x';
+  *q = 1.5;
+  *r = 'y';
+  VERIFY( *p == 'x' && *q == 1.5 && *r == 'y' );
+  a.deallocate(p, 1);
+  b.deallocate(q, 1);
+  a.deallocate(r, 1);
+  char* s = a.allocate(100);
+  a.deallocate(s, 100);
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  test04();
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2021 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <string>
+#include <vector>
+#include <random>
+#include <sstream>
+#include <testsuite_performance.h>
+
+// Hashing of short strings, of random lengths, as typically used as
+// unordered_map keys.
+
+std::vector<std::string>
+random_strings(int n, int max_len)
+{
+  std::mt19937 gen;
+  std::uniform_int_distribution<int> len_dist(1, max_len);
+  std::uniform_int_distribution<int> char_dist(0, 255);
+  std::vector<std::string> result;
+  for (int i = 0; i < n; ++i)
+    {
+      std::string s(len_dist(gen), '\0');
+      for (auto& c : s)
+	c = char_dist(gen);
+      result.push_back(s);
+    }
+  return result;
+}
+
+void
+test_lengths(int max_len, int num_strings, int iterations)
+{
+  using namespace __gnu_test;
+  time_counter time;
+  resource_counter resource;
+
+  std::vector<std::string> v = random_strings(num_strings, max_len);
+
+  std::size_t tmp = 0;
+  start_counters(time, resource);
+  for (int j = 0; j < iterations; ++j)
+    for (int i = 0; i < num_strings; ++i)
+      tmp += std::hash<std::string>()(v[i]);
+  stop_counters(time, resource);
+
+  std::ostringstream desc;
+  desc << "lengths 1 to " << max_len;
+  if (tmp != 0) // use tmp to prevent compiler optimization
+    report_performance(__FILE__, desc.str(), time, resource);
+  clear_counters(time, resource);
+}
+
+int
+main()
+{
+  test_lengths(8, 100000, 200);
+  test_lengths(16, 100000, 200);
+  test_lengths(32, 100000, 200);
+  return 0;
+}
@@ -60,6 +60,19 @@ int main()
   stop_counters(time, resource);
 
   report_performance(__FILE__, "random", time, resource);
+  clear_counters(time, resource);
+
+  std::vector<unsigned long long> w(max_size);
+
+  w[0] = 0;
+  for (int i = 1; i < max_size; ++i)
+    w[i] = (w[i-1] + 110211473) * 6364136223846793005ULL;
+
+  start_counters(time, resource);
+  std::sort(w.begin(), w.end());
+  stop_counters(time, resource);
+
+  report_performance(__FILE__, "random 64-bit", time, resource);
 
   return 0;
 }
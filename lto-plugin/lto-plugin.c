@@ -121,6 +121,13 @@ struct plugin_symtab
   unsigned long long id;
 };
 
+/* The position of a section in an object file.  */
+struct plugin_section
+{
+  off_t offset;
+  off_t length;
+};
+
 /* Encapsulates object file data during symbol scan.  */
 struct plugin_objfile
 {
@@ -129,6 +136,9 @@ struct plugin_objfile
   simple_object_read *objfile;
   struct plugin_symtab *out;
   const struct ld_plugin_input_file *file;
+  /* The symbol table extensions, which are parsed after the scan.  */
+  struct plugin_section *ext;
+  int num_ext;
 };
 
 /* All that we have to remember about a file. */
@@ -171,6 +181,7 @@ static ld_plugin_add_symbols add_symbols, add_symbols_v2;
 
 static struct plugin_file_info *claimed_files = NULL;
 static unsigned int num_claimed_files = 0;
+static unsigned int max_claimed_files = 0;
 static unsigned int non_claimed_files = 0;
 
 /* List of files with offloading.  */
@@ -453,6 +464,7 @@ free_2 (void)
   free (claimed_files);
   claimed_files = NULL;
   num_claimed_files = 0;
+  max_claimed_files = 0;
 
   while (offload_files)
     {
@@ -1013,21 +1025,14 @@ resolve_conflicts (struct plugin_symtab *t, struct plugin_symtab *conflicts)
   htab_delete (symtab);
 }
 
-/* Process one section of an object file.  */
+/* Read the LENGTH bytes at OFFSET in the object file of OBJ into a new
+   buffer.  Return NULL and report the file as corrupt if that fails.  */
 
-static int 
-process_symtab (void *data, const char *name, off_t offset, off_t length)
+static char *
+read_section (struct plugin_objfile *obj, off_t offset, off_t length)
 {
-  struct plugin_objfile *obj = (struct plugin_objfile *)data;
-  char *s;
   char *secdatastart, *secdata;
 
-  if (strncmp (name, LTO_SYMTAB_PREFIX, LTO_SYMTAB_PREFIX_LEN) != 0)
-    return 1;
-
-  s = strrchr (name, '.');
-  if (s)
-    sscanf (s, ".%" PRI_LL "x", &obj->out->id);
   secdata = secdatastart = xmalloc (length);
   offset += obj->file->offset;
   if (offset != lseek (obj->file->fd, offset, SEEK_SET))
@@ -1050,10 +1055,7 @@ process_symtab (void *data, const char *name, off_t offset, off_t length)
   if (length > 0)
     goto err;
 
-  translate (secdatastart, secdata, obj->out);
-  obj->found++;
-  free (secdatastart);
-  return 1;
+  return secdatastart;
 
 err:
   if (message)
@@ -1061,75 +1063,75 @@ err:
   /* Force claim_file_handler to abandon this file.  */
   obj->found = 0;
   free (secdatastart);
-  return 0;
+  return NULL;
 }
 
-/* Process one section of an object file.  */
+/* Process one section of an object file.  The symbol tables are read
+   straight away, the positions of their extensions are recorded, and
+   an offload section marks the file as containing offload code.  Doing
+   all this in one scan saves reading the section headers of every
+   archive member several times.  */
 
 static int
-process_symtab_extension (void *data, const char *name, off_t offset,
-			  off_t length)
+process_section (void *data, const char *name, off_t offset, off_t length)
 {
   struct plugin_objfile *obj = (struct plugin_objfile *)data;
   char *s;
-  char *secdatastart, *secdata;
-
-  if (strncmp (name, LTO_SYMTAB_EXT_PREFIX, LTO_SYMTAB_EXT_PREFIX_LEN) != 0)
-    return 1;
+  char *secdata;
 
-  s = strrchr (name, '.');
-  if (s)
-    sscanf (s, ".%" PRI_LL "x", &obj->out->id);
-  secdata = secdatastart = xmalloc (length);
-  offset += obj->file->offset;
-  if (offset != lseek (obj->file->fd, offset, SEEK_SET))
-    goto err;
-
-  do
+  if (strncmp (name, LTO_SYMTAB_PREFIX, LTO_SYMTAB_PREFIX_LEN) == 0)
     {
-      ssize_t got = read (obj->file->fd, secdata, length);
-      if (got == 0)
-	break;
-      else if (got > 0)
+      s = strrchr (name, '.');
+      if (s)
+	sscanf (s, ".%" PRI_LL "x", &obj->out->id);
+      secdata = read_section (obj, offset, length);
+      if (!secdata)
+	return 0;
+      translate (secdata, secdata + length, obj->out);
+      obj->found++;
+      free (secdata);
+    }
+  /*  Parsing symtab extension should be done only for add_symbols_v2 and
+      later versions.  */
+  else if (strncmp (name, LTO_SYMTAB_EXT_PREFIX,
+		    LTO_SYMTAB_EXT_PREFIX_LEN) == 0)
+    {
+      if (add_symbols_v2 != NULL)
 	{
-	  secdata += got;
-	  length -= got;
+	  obj->ext = xrealloc (obj->ext, (obj->num_ext + 1)
+					 * sizeof (struct plugin_section));
+	  obj->ext[obj->num_ext].offset = offset;
+	  obj->ext[obj->num_ext].length = length;
+	  obj->num_ext++;
 	}
-      else if (errno != EINTR)
-	goto err;
     }
-  while (length > 0);
-  if (length > 0)
-    goto err;
+  else if (strncmp (name, OFFLOAD_SECTION, OFFLOAD_SECTION_LEN) == 0)
+    obj->offload = 1;
 
-  parse_symtab_extension (secdatastart, secdata, obj->out);
-  obj->found++;
-  free (secdatastart);
   return 1;
-
-err:
-  if (message)
-    message (LDPL_FATAL, "%s: corrupt object file", obj->file->name);
-  /* Force claim_file_handler to abandon this file.  */
-  obj->found = 0;
-  free (secdatastart);
-  return 0;
 }
 
+/* Parse the symbol table extensions recorded by process_section.  They
+   apply to the symbols read from the symbol tables, in order.  Return
+   false if one cannot be read.  */
 
-/* Find an offload section of an object file.  */
-
-static int
-process_offload_section (void *data, const char *name, off_t offset, off_t len)
+static bool
+process_symtab_extensions (struct plugin_objfile *obj)
 {
-  if (!strncmp (name, OFFLOAD_SECTION, OFFLOAD_SECTION_LEN))
+  char *secdata;
+  int i;
+
+  obj->out->last_sym = 0;
+  for (i = 0; i < obj->num_ext; i++)
     {
-      struct plugin_objfile *obj = (struct plugin_objfile *) data;
-      obj->offload = 1;
-      return 0;
+      secdata = read_section (obj, obj->ext[i].offset, obj->ext[i].length);
+      if (!secdata)
+	return false;
+      parse_symtab_extension (secdata, secdata + obj->ext[i].length,
+			      obj->out);
+      free (secdata);
     }
-
-  return 1;
+  return true;
 }
 
 /* Callback used by gold to check if the plugin will claim FILE. Writes
@@ -1170,6 +1172,8 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
   obj.found = 0;
   obj.offload = 0;
   obj.out = &lto_file.symtab;
+  obj.ext = NULL;
+  obj.num_ext = 0;
   errmsg = NULL;
   obj.objfile = simple_object_start_read (file->fd, file->offset, LTO_SEGMENT_NAME,
 			&errmsg, &err);
@@ -1178,19 +1182,8 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
     goto err;
 
    if (obj.objfile)
-    {
-      errmsg = simple_object_find_sections (obj.objfile, process_symtab, &obj,
-					    &err);
-      /*  Parsing symtab extension should be done only for add_symbols_v2 and
-	  later versions.  */
-      if (!errmsg && add_symbols_v2 != NULL)
-	{
-	  obj.out->last_sym = 0;
-	  errmsg = simple_object_find_sections (obj.objfile,
-						process_symtab_extension,
-						&obj, &err);
-	}
-    }
+    errmsg = simple_object_find_sections (obj.objfile, process_section, &obj,
+					  &err);
 
   if (!obj.objfile || errmsg)
     {
@@ -1202,9 +1195,8 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
       goto err;
     }
 
-  if (obj.objfile)
-    simple_object_find_sections (obj.objfile, process_offload_section,
-				 &obj, &err);
+  if (obj.found > 0 && !process_symtab_extensions (&obj))
+    goto err;
 
   if (obj.found == 0 && obj.offload == 0)
     goto err;
@@ -1222,11 +1214,16 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
 			      lto_file.symtab.syms);
       check (status == LDPS_OK, LDPL_FATAL, "could not add symbols");
 
-      num_claimed_files++;
-      claimed_files =
-	xrealloc (claimed_files,
-		  num_claimed_files * sizeof (struct plugin_file_info));
-      claimed_files[num_claimed_files - 1] = lto_file;
+      /* Grow the array geometrically, as archives may have very many
+	 members.  */
+      if (num_claimed_files == max_claimed_files)
+	{
+	  max_claimed_files = max_claimed_files ? 2 * max_claimed_files : 16;
+	  claimed_files =
+	    xrealloc (claimed_files,
+		      max_claimed_files * sizeof (struct plugin_file_info));
+	}
+      claimed_files[num_claimed_files++] = lto_file;
 
       *claimed = 1;
     }
@@ -1301,6 +1298,7 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
   free (lto_file.name);
 
  cleanup:
+  free (obj.ext);
   if (obj.objfile)
     simple_object_release_read (obj.objfile);
 